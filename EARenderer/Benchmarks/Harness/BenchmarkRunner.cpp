@@ -0,0 +1,204 @@
+//
+// Created by Pavlo Muratov on 2019-02-13.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "BenchmarkRunner.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+#include <stdexcept>
+
+namespace EARenderer {
+
+#pragma mark - Lifecycle
+
+    BenchmarkRunner::BenchmarkRunner(const Settings &settings)
+            : mSettings(settings) {}
+
+#pragma mark - Private helpers
+
+    BenchmarkRunner::Result BenchmarkRunner::run(const Benchmark &benchmark) const {
+        Result result;
+        result.name = benchmark.name;
+
+        BenchmarkState state(mSettings.state);
+
+        try {
+            benchmark.function(state);
+        } catch (const std::exception &exception) {
+            result.error = exception.what();
+            return result;
+        }
+
+        std::vector<uint64_t> durations = state.iterationDurations();
+        if (durations.empty()) {
+            result.error = "Benchmark didn't run any iterations";
+            return result;
+        }
+
+        std::sort(durations.begin(), durations.end());
+        size_t count = durations.size();
+
+        result.iterationCount = count;
+        result.minimum = durations.front();
+        result.maximum = durations.back();
+        result.median = count % 2 ? durations[count / 2] : (durations[count / 2 - 1] + durations[count / 2]) / 2.0;
+        result.mean = std::accumulate(durations.begin(), durations.end(), 0.0) / count;
+
+        double variance = 0.0;
+        for (uint64_t duration : durations) {
+            variance += (duration - result.mean) * (duration - result.mean);
+        }
+        result.standardDeviation = std::sqrt(variance / count);
+
+        if (state.itemsPerIteration() > 0 && result.mean > 0.0) {
+            result.itemsPerSecond = state.itemsPerIteration() / (result.mean * 1e-9);
+        }
+
+        result.counters = state.counters();
+        result.zones = Profiler::shared().zoneSummaries();
+
+        return result;
+    }
+
+#pragma mark - Public interface
+
+    void BenchmarkRunner::add(const std::string &name, const Function &function) {
+        mBenchmarks.push_back({name, function});
+    }
+
+    std::vector<std::string> BenchmarkRunner::benchmarkNames() const {
+        std::vector<std::string> names;
+        for (auto &benchmark : mBenchmarks) {
+            if (benchmark.name.find(mSettings.filter) != std::string::npos) {
+                names.push_back(benchmark.name);
+            }
+        }
+        return names;
+    }
+
+    std::vector<BenchmarkRunner::Result> BenchmarkRunner::run() const {
+        std::vector<Result> results;
+
+        for (auto &benchmark : mBenchmarks) {
+            if (benchmark.name.find(mSettings.filter) == std::string::npos) {
+                continue;
+            }
+
+            printf("%-60s ", benchmark.name.c_str());
+            fflush(stdout);
+
+            Profiler::shared().clear();
+            results.push_back(run(benchmark));
+
+            const Result &result = results.back();
+            if (result.error.empty()) {
+                printf("%14.3f us  (median %.3f us, %zu iterations)\n", result.mean / 1000.0, result.median / 1000.0, result.iterationCount);
+            } else {
+                printf("failed: %s\n", result.error.c_str());
+            }
+        }
+
+        return results;
+    }
+
+#pragma mark - JSON
+
+    static void WriteJSONString(std::ostream &stream, const std::string &string) {
+        stream << '"';
+        for (char c : string) {
+            switch (c) {
+                case '"':
+                    stream << "\\\"";
+                    break;
+
+                case '\\':
+                    stream << "\\\\";
+                    break;
+
+                case '\n':
+                    stream << "\\n";
+                    break;
+
+                default:
+                    stream << c;
+                    break;
+            }
+        }
+        stream << '"';
+    }
+
+    std::string BenchmarkRunner::JSON(const std::vector<Result> &results, const std::map<std::string, std::string> &context) {
+        std::ostringstream stream;
+        stream << std::fixed << std::setprecision(3);
+        stream << "{\n  \"context\": {";
+
+        bool isFirst = true;
+        for (auto &pair : context) {
+            stream << (isFirst ? "\n    " : ",\n    ");
+            WriteJSONString(stream, pair.first);
+            stream << ": ";
+            WriteJSONString(stream, pair.second);
+            isFirst = false;
+        }
+
+        stream << "\n  },\n  \"benchmarks\": [";
+
+        for (size_t i = 0; i < results.size(); i++) {
+            const Result &result = results[i];
+
+            stream << (i == 0 ? "\n    {" : ",\n    {");
+            stream << "\n      \"name\": ";
+            WriteJSONString(stream, result.name);
+
+            if (!result.error.empty()) {
+                stream << ",\n      \"error\": ";
+                WriteJSONString(stream, result.error);
+                stream << "\n    }";
+                continue;
+            }
+
+            stream << ",\n      \"iterations\": " << result.iterationCount;
+            stream << ",\n      \"mean_ns\": " << result.mean;
+            stream << ",\n      \"median_ns\": " << result.median;
+            stream << ",\n      \"min_ns\": " << result.minimum;
+            stream << ",\n      \"max_ns\": " << result.maximum;
+            stream << ",\n      \"stddev_ns\": " << result.standardDeviation;
+
+            if (result.itemsPerSecond > 0.0) {
+                stream << ",\n      \"items_per_second\": " << result.itemsPerSecond;
+            }
+
+            stream << ",\n      \"counters\": {";
+            isFirst = true;
+            for (auto &counter : result.counters) {
+                stream << (isFirst ? "" : ", ");
+                WriteJSONString(stream, counter.first);
+                stream << ": " << counter.second;
+                isFirst = false;
+            }
+
+            // Zone durations are averaged per measured iteration to be comparable across runs of different length
+            stream << "},\n      \"zones\": {";
+            isFirst = true;
+            for (auto &zone : result.zones) {
+                stream << (isFirst ? "\n        " : ",\n        ");
+                WriteJSONString(stream, zone.first);
+                stream << ": {\"calls_per_iteration\": " << double(zone.second.callCount) / result.iterationCount
+                        << ", \"mean_ns\": " << double(zone.second.totalDuration) / result.iterationCount << "}";
+                isFirst = false;
+            }
+            stream << (isFirst ? "}" : "\n      }");
+
+            stream << "\n    }";
+        }
+
+        stream << "\n  ]\n}\n";
+        return stream.str();
+    }
+
+}
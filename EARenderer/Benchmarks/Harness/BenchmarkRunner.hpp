@@ -0,0 +1,91 @@
+//
+// Created by Pavlo Muratov on 2019-02-13.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_BENCHMARKRUNNER_HPP
+#define EARENDERER_BENCHMARKRUNNER_HPP
+
+#include "BenchmarkState.hpp"
+#include "Profiler.hpp"
+
+#include <vector>
+#include <string>
+#include <map>
+#include <functional>
+
+namespace EARenderer {
+
+    /**
+     Runs registered benchmarks one after another and collects their statistics.
+     Benchmarks are named hierarchically with slashes, e.g. "SpatialHash/Insert/100000",
+     so that a subset can be selected with a name filter.
+     */
+    class BenchmarkRunner {
+    public:
+        using Function = std::function<void(BenchmarkState &state)>;
+
+        struct Settings {
+            BenchmarkState::Settings state;
+            // Only benchmarks whose names contain the filter are run
+            std::string filter;
+        };
+
+        struct Result {
+            std::string name;
+            size_t iterationCount = 0;
+            // Nanoseconds per iteration
+            double mean = 0.0;
+            double median = 0.0;
+            double minimum = 0.0;
+            double maximum = 0.0;
+            double standardDeviation = 0.0;
+            double itemsPerSecond = 0.0;
+            std::map<std::string, double> counters;
+            // Profiler zones recorded during measured iterations, empty unless built with EARENDERER_PROFILING=1
+            std::map<std::string, Profiler::ZoneSummary> zones;
+            // Set when the benchmark threw, statistics are meaningless then
+            std::string error;
+        };
+
+    private:
+        struct Benchmark {
+            std::string name;
+            Function function;
+        };
+
+        Settings mSettings;
+        std::vector<Benchmark> mBenchmarks;
+
+        Result run(const Benchmark &benchmark) const;
+
+    public:
+        BenchmarkRunner(const Settings &settings);
+
+        void add(const std::string &name, const Function &function);
+
+        /**
+         @return names of benchmarks passing the filter, in order of registration
+         */
+        std::vector<std::string> benchmarkNames() const;
+
+        /**
+         Runs benchmarks passing the filter, printing progress to the standard output
+
+         @return results in order of registration
+         */
+        std::vector<Result> run() const;
+
+        /**
+         Serializes results into JSON meant to be stored as a baseline and compared with later runs
+
+         @param results results of a run
+         @param context arbitrary key-value pairs describing the run, e.g. seed or build configuration
+         @return JSON string
+         */
+        static std::string JSON(const std::vector<Result> &results, const std::map<std::string, std::string> &context);
+    };
+
+}
+
+#endif //EARENDERER_BENCHMARKRUNNER_HPP
@@ -0,0 +1,120 @@
+//
+// Created by Pavlo Muratov on 2019-02-13.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "BenchmarkState.hpp"
+#include "Profiler.hpp"
+
+#include <stdexcept>
+
+namespace EARenderer {
+
+#pragma mark - Lifecycle
+
+    BenchmarkState::BenchmarkState(const Settings &settings)
+            : mSettings(settings) {
+        if (settings.minimumIterationCount == 0 || settings.maximumIterationCount < settings.minimumIterationCount) {
+            throw std::invalid_argument("Benchmark iteration limits must be positive and ordered");
+        }
+    }
+
+#pragma mark - Private helpers
+
+    uint64_t BenchmarkState::elapsedSinceResume() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - mResumeTime).count();
+    }
+
+    bool BenchmarkState::isWarmingUp() const {
+        return mStartedIterationCount <= mSettings.warmupIterationCount;
+    }
+
+    void BenchmarkState::finishIteration() {
+        if (!mIsPaused) {
+            mCurrentIterationDuration += elapsedSinceResume();
+        }
+
+        mIsIterationRunning = false;
+
+        if (isWarmingUp()) {
+            return;
+        }
+
+        mIterationDurations.push_back(mCurrentIterationDuration);
+        mMeasuredDuration += mCurrentIterationDuration;
+    }
+
+#pragma mark - Iteration
+
+    bool BenchmarkState::keepRunning() {
+        if (mIsIterationRunning) {
+            finishIteration();
+        }
+
+        if (mStartedIterationCount >= mSettings.warmupIterationCount) {
+            size_t measuredCount = mIterationDurations.size();
+            bool isDurationReached = mMeasuredDuration >= uint64_t(mSettings.minimumDuration * 1e9);
+
+            if (measuredCount >= mSettings.maximumIterationCount ||
+                (measuredCount >= mSettings.minimumIterationCount && isDurationReached)) {
+                return false;
+            }
+        }
+
+        // Zones recorded during the warm up would skew per iteration averages
+        if (mStartedIterationCount == mSettings.warmupIterationCount) {
+            Profiler::shared().clear();
+        }
+
+        mStartedIterationCount++;
+        mIsIterationRunning = true;
+        mIsPaused = false;
+        mCurrentIterationDuration = 0;
+        mResumeTime = Clock::now();
+
+        return true;
+    }
+
+    void BenchmarkState::pauseTiming() {
+        if (!mIsIterationRunning || mIsPaused) {
+            throw std::logic_error("Only a running benchmark iteration can be paused");
+        }
+
+        mCurrentIterationDuration += elapsedSinceResume();
+        mIsPaused = true;
+    }
+
+    void BenchmarkState::resumeTiming() {
+        if (!mIsIterationRunning || !mIsPaused) {
+            throw std::logic_error("Only a paused benchmark iteration can be resumed");
+        }
+
+        mIsPaused = false;
+        mResumeTime = Clock::now();
+    }
+
+#pragma mark - Setters
+
+    void BenchmarkState::setItemsPerIteration(uint64_t count) {
+        mItemsPerIteration = count;
+    }
+
+    void BenchmarkState::setCounter(const std::string &name, double value) {
+        mCounters[name] = value;
+    }
+
+#pragma mark - Getters
+
+    const std::vector<uint64_t> &BenchmarkState::iterationDurations() const {
+        return mIterationDurations;
+    }
+
+    uint64_t BenchmarkState::itemsPerIteration() const {
+        return mItemsPerIteration;
+    }
+
+    const std::map<std::string, double> &BenchmarkState::counters() const {
+        return mCounters;
+    }
+
+}
@@ -0,0 +1,105 @@
+//
+// Created by Pavlo Muratov on 2019-02-13.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_BENCHMARKSTATE_HPP
+#define EARENDERER_BENCHMARKSTATE_HPP
+
+#include <vector>
+#include <string>
+#include <map>
+#include <chrono>
+#include <cstdint>
+
+namespace EARenderer {
+
+    /**
+     Drives iterations of a single benchmark and measures them.
+     Fixtures are built before the loop, only the body of the loop is timed:
+
+         while (state.keepRunning()) {
+             ...
+         }
+
+     First iterations are treated as a warm up and are not recorded. The rest are repeated
+     until both the minimum iteration count and the minimum measured duration are reached.
+     */
+    class BenchmarkState {
+    public:
+        struct Settings {
+            size_t warmupIterationCount = 1;
+            size_t minimumIterationCount = 5;
+            size_t maximumIterationCount = 1000000;
+            // Seconds of measured time, pauses excluded
+            double minimumDuration = 0.5;
+        };
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        Settings mSettings;
+        size_t mStartedIterationCount = 0;
+        bool mIsIterationRunning = false;
+        bool mIsPaused = false;
+        Clock::time_point mResumeTime;
+        uint64_t mCurrentIterationDuration = 0;
+        uint64_t mMeasuredDuration = 0;
+        uint64_t mItemsPerIteration = 0;
+        std::vector<uint64_t> mIterationDurations;
+        std::map<std::string, double> mCounters;
+
+        uint64_t elapsedSinceResume() const;
+
+        void finishIteration();
+
+        bool isWarmingUp() const;
+
+    public:
+        BenchmarkState(const Settings &settings);
+
+        /**
+         Keeps the compiler from optimizing away computations whose results are otherwise unused
+         */
+        template<typename T>
+        static void DoNotOptimize(const T &value) {
+            asm volatile("" : : "r,m"(value) : "memory");
+        }
+
+        /**
+         Finishes the running iteration, if any, and starts the next one
+
+         @return false once enough iterations have been measured
+         */
+        bool keepRunning();
+
+        /**
+         Stops timing of the running iteration, e.g. to rebuild state consumed by the iteration
+         */
+        void pauseTiming();
+
+        void resumeTiming();
+
+        /**
+         @param count amount of elements processed by every iteration, reported as throughput
+         */
+        void setItemsPerIteration(uint64_t count);
+
+        /**
+         Attaches an arbitrary value to the results, e.g. size of the data set
+         */
+        void setCounter(const std::string &name, double value);
+
+        /**
+         @return durations of measured iterations in nanoseconds
+         */
+        const std::vector<uint64_t> &iterationDurations() const;
+
+        uint64_t itemsPerIteration() const;
+
+        const std::map<std::string, double> &counters() const;
+    };
+
+}
+
+#endif //EARENDERER_BENCHMARKSTATE_HPP
@@ -0,0 +1,87 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "EngineShaderSources.hpp"
+#include "FileManager.hpp"
+#include "StringUtils.hpp"
+
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace EARenderer {
+
+    namespace {
+
+        bool IsShaderSource(const std::string &name) {
+            size_t extensionStart = name.find_last_of('.');
+            if (extensionStart == std::string::npos) {
+                return false;
+            }
+            std::string extension = name.substr(extensionStart);
+            return extension == ".vert" || extension == ".frag" || extension == ".geom" || extension == ".glsl";
+        }
+
+        void LinkShaderSources(const std::string &sourceDirectory, const std::string &linkDirectory) {
+            DIR *directory = opendir(sourceDirectory.c_str());
+            if (!directory) {
+                throw std::runtime_error(string_format("Unable to open shader directory %s", sourceDirectory.c_str()));
+            }
+
+            while (dirent *directoryEntry = readdir(directory)) {
+                std::string name(directoryEntry->d_name);
+                if (name == "." || name == "..") {
+                    continue;
+                }
+
+                std::string path = sourceDirectory + name;
+                struct stat attributes;
+                if (stat(path.c_str(), &attributes) != 0) {
+                    continue;
+                }
+
+                if (S_ISDIR(attributes.st_mode)) {
+                    LinkShaderSources(path + "/", linkDirectory);
+                } else if (IsShaderSource(name) && symlink(path.c_str(), (linkDirectory + name).c_str()) != 0) {
+                    closedir(directory);
+                    throw std::runtime_error(string_format("Unable to link shader source %s", path.c_str()));
+                }
+            }
+
+            closedir(directory);
+        }
+
+        std::string MakeLinkDirectory() {
+            std::string thisFile(__FILE__);
+            std::string harnessDirectory = thisFile.substr(0, thisFile.find_last_of('/') + 1);
+            std::string shaderDirectory = harnessDirectory + "../../Engine/OpenGL/Extensions/Shaders/";
+
+            const char *temporaryDirectory = getenv("TMPDIR");
+            std::string pathTemplate = std::string(temporaryDirectory ? temporaryDirectory : "/tmp") + "/EARendererShadersXXXXXX";
+            std::vector<char> path(pathTemplate.begin(), pathTemplate.end());
+            path.push_back('\0');
+
+            if (!mkdtemp(path.data())) {
+                throw std::runtime_error(string_format("Unable to create a temporary directory from %s", pathTemplate.c_str()));
+            }
+
+            std::string linkDirectory = std::string(path.data()) + "/";
+            LinkShaderSources(shaderDirectory, linkDirectory);
+            return linkDirectory;
+        }
+
+    }
+
+    const std::string &UseEngineShaderSources() {
+        static std::string linkDirectory = MakeLinkDirectory();
+        FileManager::shared().setResourceRootPath(linkDirectory);
+        return linkDirectory;
+    }
+
+}
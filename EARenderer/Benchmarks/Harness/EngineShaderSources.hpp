@@ -0,0 +1,24 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_ENGINESHADERSOURCES_HPP
+#define EARENDERER_ENGINESHADERSOURCES_HPP
+
+#include <string>
+
+namespace EARenderer {
+
+    /**
+     Links shader sources of the engine into a single temporary directory, the way they are laid out in the
+     application bundle, and makes it the resource root, so that passes can be created by command line tools.
+     Sources are looked up next to this file, links are only created on the first call.
+
+     @return resource root path holding the links
+     */
+    const std::string &UseEngineShaderSources();
+
+}
+
+#endif //EARENDERER_ENGINESHADERSOURCES_HPP
@@ -0,0 +1,43 @@
+//
+// Created by Pavlo Muratov on 2019-02-13.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "OffscreenGLContext.hpp"
+#include "StringUtils.hpp"
+
+#include <stdexcept>
+
+namespace EARenderer {
+
+#pragma mark - Lifecycle
+
+    OffscreenGLContext::OffscreenGLContext() {
+        CGLPixelFormatAttribute attributes[] = {
+                kCGLPFAOpenGLProfile, (CGLPixelFormatAttribute) kCGLOGLPVersion_GL4_Core,
+                kCGLPFAAccelerated,
+                (CGLPixelFormatAttribute) 0
+        };
+
+        CGLPixelFormatObj pixelFormat = nullptr;
+        GLint pixelFormatCount = 0;
+        CGLError error = CGLChoosePixelFormat(attributes, &pixelFormat, &pixelFormatCount);
+        if (error != kCGLNoError || !pixelFormat) {
+            throw std::runtime_error(string_format("Unable to choose pixel format for offscreen context: %s", CGLErrorString(error)));
+        }
+
+        error = CGLCreateContext(pixelFormat, nullptr, &mContext);
+        CGLDestroyPixelFormat(pixelFormat);
+        if (error != kCGLNoError) {
+            throw std::runtime_error(string_format("Unable to create offscreen context: %s", CGLErrorString(error)));
+        }
+
+        CGLSetCurrentContext(mContext);
+    }
+
+    OffscreenGLContext::~OffscreenGLContext() {
+        CGLSetCurrentContext(nullptr);
+        CGLDestroyContext(mContext);
+    }
+
+}
@@ -0,0 +1,33 @@
+//
+// Created by Pavlo Muratov on 2019-02-13.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_OFFSCREENGLCONTEXT_HPP
+#define EARENDERER_OFFSCREENGLCONTEXT_HPP
+
+#include <OpenGL/OpenGL.h>
+
+namespace EARenderer {
+
+    /**
+     Core profile context without a drawable, made current on construction.
+     Lets code creating textures and buffers run outside of the application's view.
+     */
+    class OffscreenGLContext {
+    private:
+        CGLContextObj mContext = nullptr;
+
+    public:
+        OffscreenGLContext();
+
+        ~OffscreenGLContext();
+
+        OffscreenGLContext(const OffscreenGLContext &that) = delete;
+
+        OffscreenGLContext &operator=(const OffscreenGLContext &rhs) = delete;
+    };
+
+}
+
+#endif //EARENDERER_OFFSCREENGLCONTEXT_HPP
@@ -0,0 +1,82 @@
+//
+// Created by Pavlo Muratov on 2019-02-13.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "BenchmarkSceneLibrary.hpp"
+#include "SurfelGenerator.hpp"
+#include "DiffuseLightProbeGenerator.hpp"
+#include "StringUtils.hpp"
+
+#include <stdexcept>
+
+namespace EARenderer {
+
+    const std::string BenchmarkSceneLibrary::BoxGrid = "BoxGrid";
+    const std::string BenchmarkSceneLibrary::CornellRoom = "CornellRoom";
+    const std::string BenchmarkSceneLibrary::ScatteredMeshes = "ScatteredMeshes";
+
+#pragma mark - Lifecycle
+
+    BenchmarkSceneLibrary::BenchmarkSceneLibrary(const Settings &settings)
+            : mSettings(settings) {}
+
+#pragma mark - Public interface
+
+    std::vector<std::string> BenchmarkSceneLibrary::SceneNames() {
+        return {BoxGrid, CornellRoom, ScatteredMeshes};
+    }
+
+    const BenchmarkSceneLibrary::Settings &BenchmarkSceneLibrary::settings() const {
+        return mSettings;
+    }
+
+    BenchmarkSceneLibrary::Entry &BenchmarkSceneLibrary::entry(const std::string &name) {
+        auto it = mEntries.find(name);
+        if (it != mEntries.end()) {
+            return it->second;
+        }
+
+        Entry entry;
+        entry.resourceStorage = std::make_unique<SharedResourceStorage>();
+        entry.scene = std::make_unique<Scene>();
+
+        ProceduralSceneGenerator generator(mSettings.seed, entry.resourceStorage.get(), entry.scene.get());
+
+        // Spacings keep surfel and probe counts of all scenes in the same ballpark
+        if (name == BoxGrid) {
+            generator.addBoxGrid(mSettings.boxGrid);
+            generator.prepareForBaking(name, mSettings.boxGrid.spacing / 10.0, mSettings.boxGrid.spacing);
+        } else if (name == CornellRoom) {
+            generator.addCornellRoom(mSettings.cornellRoom);
+            generator.prepareForBaking(name, mSettings.cornellRoom.size / 60.0, mSettings.cornellRoom.size / 8.0);
+        } else if (name == ScatteredMeshes) {
+            generator.addScatteredMeshes(mSettings.scatteredMeshes);
+            generator.prepareForBaking(name, mSettings.scatteredMeshes.extent / 100.0, mSettings.scatteredMeshes.extent / 8.0);
+        } else {
+            throw std::invalid_argument(string_format("Unknown benchmark scene: %s", name.c_str()));
+        }
+
+        entry.triangleCount = generator.triangleCount();
+
+        return mEntries.emplace(name, std::move(entry)).first->second;
+    }
+
+    BenchmarkSceneLibrary::Entry &BenchmarkSceneLibrary::bakedEntry(const std::string &name) {
+        Entry &entry = this->entry(name);
+
+        if (!entry.surfelData) {
+            SurfelGenerator surfelGenerator(entry.resourceStorage.get(), entry.scene.get());
+            surfelGenerator.setSeed(mSettings.seed);
+            entry.surfelData = surfelGenerator.generateStaticGeometrySurfels();
+        }
+
+        if (!entry.probeData) {
+            DiffuseLightProbeGenerator probeGenerator;
+            entry.probeData = probeGenerator.generateProbes(*entry.scene, *entry.surfelData);
+        }
+
+        return entry;
+    }
+
+}
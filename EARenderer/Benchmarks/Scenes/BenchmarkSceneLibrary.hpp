@@ -0,0 +1,77 @@
+//
+// Created by Pavlo Muratov on 2019-02-13.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_BENCHMARKSCENELIBRARY_HPP
+#define EARENDERER_BENCHMARKSCENELIBRARY_HPP
+
+#include "ProceduralSceneGenerator.hpp"
+#include "SurfelData.hpp"
+#include "DiffuseLightProbeData.hpp"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace EARenderer {
+
+    /**
+     Procedural scenes shared by benchmarks. Scenes are generated on first use and kept afterwards,
+     so that benchmarks of different subsystems run on exactly the same geometry.
+     */
+    class BenchmarkSceneLibrary {
+    public:
+        struct Settings {
+            uint32_t seed = 1;
+            ProceduralSceneGenerator::BoxGridSettings boxGrid;
+            ProceduralSceneGenerator::CornellRoomSettings cornellRoom;
+            ProceduralSceneGenerator::ScatteredMeshesSettings scatteredMeshes;
+        };
+
+        struct Entry {
+            std::unique_ptr<SharedResourceStorage> resourceStorage;
+            std::unique_ptr<Scene> scene;
+            size_t triangleCount = 0;
+            // Baked on demand by bakedEntry()
+            std::unique_ptr<SurfelData> surfelData;
+            std::unique_ptr<DiffuseLightProbeData> probeData;
+        };
+
+    private:
+        Settings mSettings;
+        std::map<std::string, Entry> mEntries;
+
+    public:
+        static const std::string BoxGrid;
+        static const std::string CornellRoom;
+        static const std::string ScatteredMeshes;
+
+        BenchmarkSceneLibrary(const Settings &settings);
+
+        /**
+         @return names of all available scenes
+         */
+        static std::vector<std::string> SceneNames();
+
+        const Settings &settings() const;
+
+        /**
+         @param name one of SceneNames()
+         @return scene ready for baking, with its ray tracer built
+         */
+        Entry &entry(const std::string &name);
+
+        /**
+         Same as entry(), but also bakes surfels and diffuse light probes of the scene with default generator settings
+
+         @param name one of SceneNames()
+         @return scene with baked data
+         */
+        Entry &bakedEntry(const std::string &name);
+    };
+
+}
+
+#endif //EARENDERER_BENCHMARKSCENELIBRARY_HPP
@@ -0,0 +1,364 @@
+//
+// Created by Pavlo Muratov on 2019-02-13.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "ProceduralSceneGenerator.hpp"
+#include "MeshInstance.hpp"
+#include "CookTorranceMaterial.hpp"
+
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <array>
+#include <cmath>
+
+namespace EARenderer {
+
+#pragma mark - Lifecycle
+
+    ProceduralSceneGenerator::ProceduralSceneGenerator(uint32_t seed, SharedResourceStorage *resourceStorage, Scene *scene)
+            :
+            mEngine(seed),
+            mResourceStorage(resourceStorage),
+            mScene(scene) {}
+
+#pragma mark - Private helpers
+
+    float ProceduralSceneGenerator::random(float min, float max) {
+        // Distributions are implementation defined, scaling the raw output keeps scenes identical across standard libraries
+        float normalized = float(mEngine() - mEngine.min()) / float(mEngine.max() - mEngine.min());
+        return min + (max - min) * normalized;
+    }
+
+    MaterialReference ProceduralSceneGenerator::addMaterial(const Color &albedo) {
+        return mResourceStorage->addMaterial(CookTorranceMaterial(albedo, glm::vec3(0.5, 0.5, 1.0), 0.0f, 0.5f, 1.0f, 0.0f));
+    }
+
+    ID ProceduralSceneGenerator::addMesh(const std::string &name, std::vector<SubMesh> &&subMeshes) {
+        return mResourceStorage->addMesh(Mesh(name, std::move(subMeshes)));
+    }
+
+    MeshInstance ProceduralSceneGenerator::makeInstance(ID meshID, const Transformation &transformation, const MaterialReference &material) const {
+        MeshInstance instance(meshID, mResourceStorage->mesh(meshID));
+        instance.setTransformation(transformation);
+        instance.materialReference = material;
+        return instance;
+    }
+
+    void ProceduralSceneGenerator::addStaticInstance(const MeshInstance &instance) {
+        mScene->addMeshInstanceWithIDAsStatic(mScene->meshInstances().insert(instance));
+
+        auto &mesh = mResourceStorage->mesh(instance.meshID());
+        for (ID subMeshID : mesh.subMeshes()) {
+            mTriangleCount += mesh.subMeshes()[subMeshID].vertices().size() / 3;
+        }
+    }
+
+    void ProceduralSceneGenerator::addGround(float size, uint32_t subdivision, const MaterialReference &material) {
+        SubMesh ground;
+        ground.setName("Ground");
+        AppendQuad(ground, glm::vec3(-size / 2.0, 0.0, -size / 2.0), glm::vec3(0.0, 0.0, size), glm::vec3(size, 0.0, 0.0), subdivision);
+
+        std::vector<SubMesh> subMeshes;
+        subMeshes.push_back(std::move(ground));
+        ID meshID = addMesh("Ground", std::move(subMeshes));
+
+        addStaticInstance(makeInstance(meshID, Transformation(), material));
+    }
+
+#pragma mark - Geometry
+
+    void ProceduralSceneGenerator::AppendTriangle(SubMesh &subMesh,
+            const glm::vec3 &p0, const glm::vec3 &p1, const glm::vec3 &p2,
+            const glm::vec2 &uv0, const glm::vec2 &uv1, const glm::vec2 &uv2) {
+
+        glm::vec3 normal = glm::normalize(glm::cross(p1 - p0, p2 - p0));
+        glm::vec3 tangent = glm::normalize(p1 - p0);
+        glm::vec3 bitangent = glm::cross(normal, tangent);
+
+        std::array<glm::vec3, 3> positions{p0, p1, p2};
+        std::array<glm::vec2, 3> texCoords{uv0, uv1, uv2};
+
+        for (size_t i = 0; i < 3; i++) {
+            subMesh.addVertex(Vertex1P1N2UV1T1BT(glm::vec4(positions[i], 1.0), glm::vec3(texCoords[i], 0.0), texCoords[i], normal, tangent, bitangent));
+        }
+    }
+
+    void ProceduralSceneGenerator::AppendQuad(SubMesh &subMesh, const glm::vec3 &origin, const glm::vec3 &u, const glm::vec3 &v, uint32_t subdivision) {
+        subdivision = std::max(subdivision, 1u);
+        float step = 1.0 / subdivision;
+
+        for (uint32_t i = 0; i < subdivision; i++) {
+            for (uint32_t j = 0; j < subdivision; j++) {
+                glm::vec2 uv00(i * step, j * step);
+                glm::vec2 uv10(uv00.x + step, uv00.y);
+                glm::vec2 uv11(uv00.x + step, uv00.y + step);
+                glm::vec2 uv01(uv00.x, uv00.y + step);
+
+                auto point = [&](const glm::vec2 &uv) {
+                    return origin + u * uv.x + v * uv.y;
+                };
+
+                AppendTriangle(subMesh, point(uv00), point(uv10), point(uv11), uv00, uv10, uv11);
+                AppendTriangle(subMesh, point(uv00), point(uv11), point(uv01), uv00, uv11, uv01);
+            }
+        }
+    }
+
+    SubMesh ProceduralSceneGenerator::Box(uint32_t faceSubdivision) {
+        SubMesh box;
+        box.setName("Box");
+
+        glm::vec3 x(1.0, 0.0, 0.0);
+        glm::vec3 y(0.0, 1.0, 0.0);
+        glm::vec3 z(0.0, 0.0, 1.0);
+        glm::vec3 min(-0.5);
+
+        // Edge pairs are ordered so that their cross products point outwards
+        AppendQuad(box, min + x, y, z, faceSubdivision);
+        AppendQuad(box, min, z, y, faceSubdivision);
+        AppendQuad(box, min + y, z, x, faceSubdivision);
+        AppendQuad(box, min, x, z, faceSubdivision);
+        AppendQuad(box, min + z, x, y, faceSubdivision);
+        AppendQuad(box, min, y, x, faceSubdivision);
+
+        return box;
+    }
+
+    SubMesh ProceduralSceneGenerator::blob(uint32_t triangleCount) {
+        // A sphere tesselated into rings of quads and triangle fans at the poles
+        // produces 2 * segments * (rings - 1) triangles
+        uint32_t segments = std::max(3u, uint32_t(std::round(std::sqrt(float(triangleCount)))));
+        uint32_t rings = std::max(2u, uint32_t(std::round(triangleCount / (2.0f * segments))) + 1);
+
+        // Sum of a few random waves keeps the radius positive and the surface smooth
+        struct Wave {
+            glm::vec3 frequency;
+            float phase;
+            float amplitude;
+        };
+
+        std::array<Wave, 3> waves;
+        for (auto &wave : waves) {
+            wave.frequency = glm::vec3(random(-3.0, 3.0), random(-3.0, 3.0), random(-3.0, 3.0));
+            wave.phase = random(0.0, glm::two_pi<float>());
+            wave.amplitude = random(0.05, 0.15);
+        }
+
+        auto point = [&](uint32_t ring, uint32_t segment) {
+            float theta = glm::pi<float>() * ring / rings;
+            float phi = glm::two_pi<float>() * (segment % segments) / segments;
+            glm::vec3 direction(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+
+            float radius = 1.0;
+            for (auto &wave : waves) {
+                radius += wave.amplitude * std::sin(glm::dot(wave.frequency, direction) + wave.phase);
+            }
+            return direction * radius * 0.5f;
+        };
+
+        auto texCoords = [&](uint32_t ring, uint32_t segment) {
+            return glm::vec2(float(segment) / segments, float(ring) / rings);
+        };
+
+        SubMesh blob;
+        blob.setName("Blob");
+
+        // Winding is fixed up by the position of a triangle relative to the center, which works for star-shaped surfaces
+        auto appendOutwardTriangle = [&](std::array<glm::uvec2, 3> corners) {
+            glm::vec3 p0 = point(corners[0].x, corners[0].y);
+            glm::vec3 p1 = point(corners[1].x, corners[1].y);
+            glm::vec3 p2 = point(corners[2].x, corners[2].y);
+
+            if (glm::dot(glm::cross(p1 - p0, p2 - p0), p0 + p1 + p2) < 0.0) {
+                std::swap(p1, p2);
+                std::swap(corners[1], corners[2]);
+            }
+
+            AppendTriangle(blob, p0, p1, p2,
+                    texCoords(corners[0].x, corners[0].y),
+                    texCoords(corners[1].x, corners[1].y),
+                    texCoords(corners[2].x, corners[2].y));
+        };
+
+        for (uint32_t ring = 0; ring < rings; ring++) {
+            for (uint32_t segment = 0; segment < segments; segment++) {
+                if (ring == 0) {
+                    appendOutwardTriangle({glm::uvec2(0, segment), glm::uvec2(1, segment), glm::uvec2(1, segment + 1)});
+                } else if (ring == rings - 1) {
+                    appendOutwardTriangle({glm::uvec2(ring, segment), glm::uvec2(rings, segment), glm::uvec2(ring, segment + 1)});
+                } else {
+                    appendOutwardTriangle({glm::uvec2(ring, segment), glm::uvec2(ring + 1, segment), glm::uvec2(ring + 1, segment + 1)});
+                    appendOutwardTriangle({glm::uvec2(ring, segment), glm::uvec2(ring + 1, segment + 1), glm::uvec2(ring, segment + 1)});
+                }
+            }
+        }
+
+        // Faceted normals would make every vertex an attribute seam, leave smoothing to mesh processing instead
+        for (auto &vertex : blob.vertices()) {
+            vertex.normal = glm::vec3(0.0);
+            vertex.tangent = glm::vec3(0.0);
+            vertex.bitangent = glm::vec3(0.0);
+        }
+
+        return blob;
+    }
+
+    std::vector<glm::vec3> ProceduralSceneGenerator::RandomPoints(const AxisAlignedBox3D &box, size_t count, uint32_t seed) {
+        std::mt19937 engine(seed);
+        std::uniform_real_distribution<float> distribution(0.0, 1.0);
+
+        std::vector<glm::vec3> points(count);
+        for (auto &point : points) {
+            glm::vec3 factors(distribution(engine), distribution(engine), distribution(engine));
+            point = box.min + (box.max - box.min) * factors;
+        }
+        return points;
+    }
+
+    std::vector<glm::vec3> ProceduralSceneGenerator::RandomDirections(size_t count, uint32_t seed) {
+        std::mt19937 engine(seed);
+        std::uniform_real_distribution<float> distribution(0.0, 1.0);
+
+        std::vector<glm::vec3> directions(count);
+        for (auto &direction : directions) {
+            float z = 1.0 - 2.0 * distribution(engine);
+            float phi = glm::two_pi<float>() * distribution(engine);
+            float r = std::sqrt(std::max(0.0f, 1.0f - z * z));
+            direction = glm::vec3(r * std::cos(phi), r * std::sin(phi), z);
+        }
+        return directions;
+    }
+
+#pragma mark - Composition
+
+    void ProceduralSceneGenerator::addBoxGrid(const BoxGridSettings &settings) {
+        MaterialReference groundMaterial = addMaterial(Color(0.8, 0.8, 0.8));
+        MaterialReference boxMaterial = addMaterial(Color(0.9, 0.6, 0.3));
+
+        float gridSize = settings.boxesPerSide * settings.spacing;
+        addGround(gridSize + settings.spacing, settings.boxesPerSide, groundMaterial);
+
+        std::vector<SubMesh> subMeshes;
+        subMeshes.push_back(Box(settings.faceSubdivision));
+        ID boxMeshID = addMesh("Box", std::move(subMeshes));
+
+        float firstCenter = -gridSize / 2.0 + settings.spacing / 2.0;
+        float footprint = settings.spacing * 0.6;
+
+        for (uint32_t i = 0; i < settings.boxesPerSide; i++) {
+            for (uint32_t j = 0; j < settings.boxesPerSide; j++) {
+                float height = random(settings.minimumHeight, settings.maximumHeight);
+
+                Transformation transformation;
+                transformation.scale = glm::vec3(footprint, height, footprint);
+                transformation.translation = glm::vec3(firstCenter + i * settings.spacing, height / 2.0, firstCenter + j * settings.spacing);
+                addStaticInstance(makeInstance(boxMeshID, transformation, boxMaterial));
+            }
+        }
+    }
+
+    void ProceduralSceneGenerator::addCornellRoom(const CornellRoomSettings &settings) {
+        MaterialReference white = addMaterial(Color(0.75, 0.75, 0.75));
+        MaterialReference red = addMaterial(Color(0.75, 0.1, 0.1));
+        MaterialReference green = addMaterial(Color(0.1, 0.75, 0.1));
+
+        float size = settings.size;
+        float half = size / 2.0;
+        uint32_t subdivision = settings.wallSubdivision;
+
+        glm::vec3 x(size, 0.0, 0.0);
+        glm::vec3 y(0.0, size, 0.0);
+        glm::vec3 z(0.0, 0.0, size);
+        glm::vec3 corner(-half, 0.0, -half);
+
+        // Walls face inwards, the side looking at +Z is left open
+        std::vector<SubMesh> walls(5);
+        walls[0].setName("Floor");
+        AppendQuad(walls[0], corner, z, x, subdivision);
+        walls[1].setName("Ceiling");
+        AppendQuad(walls[1], corner + y, x, z, subdivision);
+        walls[2].setName("Back");
+        AppendQuad(walls[2], corner, x, y, subdivision);
+        walls[3].setName("Left");
+        AppendQuad(walls[3], corner, y, z, subdivision);
+        walls[4].setName("Right");
+        AppendQuad(walls[4], corner + x, z, y, subdivision);
+
+        ID roomMeshID = addMesh("Cornell room", std::move(walls));
+        auto &roomMesh = mResourceStorage->mesh(roomMeshID);
+
+        MeshInstance room(roomMeshID, roomMesh);
+        room.setTransformation(Transformation());
+        for (ID subMeshID : roomMesh.subMeshes()) {
+            const std::string &name = roomMesh.subMeshes()[subMeshID].name();
+            room.setMaterialReferenceForSubMeshID(name == "Left" ? red : (name == "Right" ? green : white), subMeshID);
+        }
+        addStaticInstance(room);
+
+        std::vector<SubMesh> subMeshes;
+        subMeshes.push_back(Box(settings.boxFaceSubdivision));
+        ID boxMeshID = addMesh("Box", std::move(subMeshes));
+
+        // Tall box in the back left and short box in the front right, both slightly rotated
+        std::array<glm::vec3, 2> boxSizes{glm::vec3(0.3, 0.6, 0.3) * size, glm::vec3(0.3, 0.3, 0.3) * size};
+        std::array<glm::vec2, 2> boxCenters{glm::vec2(-0.17, -0.15) * size, glm::vec2(0.17, 0.15) * size};
+
+        for (size_t i = 0; i < boxSizes.size(); i++) {
+            Transformation transformation;
+            transformation.scale = boxSizes[i];
+            transformation.translation = glm::vec3(boxCenters[i].x, boxSizes[i].y / 2.0, boxCenters[i].y);
+            transformation.rotation = glm::angleAxis(random(-0.4, 0.4), glm::vec3(0.0, 1.0, 0.0));
+            addStaticInstance(makeInstance(boxMeshID, transformation, white));
+        }
+    }
+
+    void ProceduralSceneGenerator::addScatteredMeshes(const ScatteredMeshesSettings &settings) {
+        MaterialReference groundMaterial = addMaterial(Color(0.8, 0.8, 0.8));
+        addGround(settings.extent, 8, groundMaterial);
+
+        std::vector<ID> meshIDs;
+        std::vector<MaterialReference> materials;
+
+        for (uint32_t i = 0; i < settings.meshCount; i++) {
+            std::vector<SubMesh> subMeshes;
+            subMeshes.push_back(blob(settings.trianglesPerMesh));
+            meshIDs.push_back(addMesh("Blob", std::move(subMeshes)));
+            materials.push_back(addMaterial(Color(random(0.2, 0.9), random(0.2, 0.9), random(0.2, 0.9))));
+        }
+
+        if (meshIDs.empty()) {
+            return;
+        }
+
+        float half = settings.extent / 2.0;
+
+        for (uint32_t i = 0; i < settings.instanceCount; i++) {
+            size_t meshIndex = mEngine() % meshIDs.size();
+            float scale = random(0.3, 1.2);
+
+            glm::vec3 axis = glm::normalize(glm::vec3(random(-1.0, 1.0), random(0.1, 1.0), random(-1.0, 1.0)));
+
+            Transformation transformation;
+            transformation.scale = glm::vec3(scale);
+            transformation.translation = glm::vec3(random(-half, half), random(0.0, scale), random(-half, half));
+            transformation.rotation = glm::angleAxis(random(0.0, glm::two_pi<float>()), axis);
+            addStaticInstance(makeInstance(meshIDs[meshIndex], transformation, materials[meshIndex]));
+        }
+    }
+
+    void ProceduralSceneGenerator::prepareForBaking(const std::string &name, float surfelSpacing, float diffuseProbeSpacing) {
+        mScene->setName(name);
+        mScene->setSurfelSpacing(surfelSpacing);
+        mScene->setDiffuseProbeSpacing(diffuseProbeSpacing);
+        mScene->calculateGeometricProperties(*mResourceStorage);
+        mScene->buildStaticGeometryRaytracer(*mResourceStorage);
+    }
+
+#pragma mark - Getters
+
+    size_t ProceduralSceneGenerator::triangleCount() const {
+        return mTriangleCount;
+    }
+
+}
@@ -0,0 +1,153 @@
+//
+// Created by Pavlo Muratov on 2019-02-13.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_PROCEDURALSCENEGENERATOR_HPP
+#define EARENDERER_PROCEDURALSCENEGENERATOR_HPP
+
+#include "Scene.hpp"
+#include "SharedResourceStorage.hpp"
+#include "SubMesh.hpp"
+#include "Color.hpp"
+
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace EARenderer {
+
+    /**
+     Composes scenes out of generated geometry and constant color materials,
+     so that benchmarks don't depend on external assets. The same seed and settings
+     always produce the same scene.
+     */
+    class ProceduralSceneGenerator {
+    public:
+        struct BoxGridSettings {
+            uint32_t boxesPerSide = 8;
+            // Distance between centers of neighbouring boxes
+            float spacing = 1.5;
+            float minimumHeight = 0.25;
+            float maximumHeight = 2.0;
+            // Every face of a box is split into subdivision^2 quads
+            uint32_t faceSubdivision = 1;
+        };
+
+        struct CornellRoomSettings {
+            float size = 4.0;
+            // Every wall is split into subdivision^2 quads
+            uint32_t wallSubdivision = 16;
+            uint32_t boxFaceSubdivision = 4;
+        };
+
+        struct ScatteredMeshesSettings {
+            // Amount of distinct meshes the instances are picked from
+            uint32_t meshCount = 4;
+            uint32_t instanceCount = 64;
+            uint32_t trianglesPerMesh = 5000;
+            // Instances are scattered over a square with this side length
+            float extent = 10.0;
+        };
+
+    private:
+        std::mt19937 mEngine;
+        SharedResourceStorage *mResourceStorage;
+        Scene *mScene;
+        size_t mTriangleCount = 0;
+
+        float random(float min, float max);
+
+        MaterialReference addMaterial(const Color &albedo);
+
+        ID addMesh(const std::string &name, std::vector<SubMesh> &&subMeshes);
+
+        MeshInstance makeInstance(ID meshID, const Transformation &transformation, const MaterialReference &material) const;
+
+        void addStaticInstance(const MeshInstance &instance);
+
+        void addGround(float size, uint32_t subdivision, const MaterialReference &material);
+
+    public:
+        /**
+         @param seed seed of the random number generator
+         @param resourceStorage storage receiving meshes and materials
+         @param scene scene receiving static mesh instances
+         */
+        ProceduralSceneGenerator(uint32_t seed, SharedResourceStorage *resourceStorage, Scene *scene);
+
+#pragma mark - Geometry
+
+        /**
+         Appends a triangle facing the side from which its vertices go counter-clockwise
+         */
+        static void AppendTriangle(SubMesh &subMesh,
+                const glm::vec3 &p0, const glm::vec3 &p1, const glm::vec3 &p2,
+                const glm::vec2 &uv0, const glm::vec2 &uv1, const glm::vec2 &uv2);
+
+        /**
+         Appends a parallelogram facing the direction of cross(u, v)
+
+         @param origin corner of the parallelogram
+         @param u first edge
+         @param v second edge
+         @param subdivision amount of segments along each edge
+         */
+        static void AppendQuad(SubMesh &subMesh, const glm::vec3 &origin, const glm::vec3 &u, const glm::vec3 &v, uint32_t subdivision);
+
+        /**
+         @param faceSubdivision amount of segments along each edge of a face
+         @return unit cube centered at the origin with outward facing triangles
+         */
+        static SubMesh Box(uint32_t faceSubdivision);
+
+        /**
+         @param triangleCount approximate amount of triangles
+         @return closed star-shaped surface of unit size with randomly displaced radius.
+         Normals and tangents are zero, to be generated by MeshProcessor
+         */
+        SubMesh blob(uint32_t triangleCount);
+
+        /**
+         @return points uniformly distributed inside the box
+         */
+        static std::vector<glm::vec3> RandomPoints(const AxisAlignedBox3D &box, size_t count, uint32_t seed);
+
+        /**
+         @return unit vectors uniformly distributed over the sphere
+         */
+        static std::vector<glm::vec3> RandomDirections(size_t count, uint32_t seed);
+
+#pragma mark - Composition
+
+        /**
+         Adds a ground plane covered with a grid of boxes of random heights
+         */
+        void addBoxGrid(const BoxGridSettings &settings);
+
+        /**
+         Adds a room open on one side with red and green side walls and two rotated boxes inside
+         */
+        void addCornellRoom(const CornellRoomSettings &settings);
+
+        /**
+         Adds a ground plane with randomly placed, rotated and scaled instances of a few generated meshes
+         */
+        void addScatteredMeshes(const ScatteredMeshesSettings &settings);
+
+        /**
+         Computes geometric properties of the scene, builds its ray tracer and sets baking parameters.
+         The light baking volume spans all static geometry.
+         */
+        void prepareForBaking(const std::string &name, float surfelSpacing, float diffuseProbeSpacing);
+
+        /**
+         @return amount of triangles in all static instances added so far
+         */
+        size_t triangleCount() const;
+    };
+
+}
+
+#endif //EARENDERER_PROCEDURALSCENEGENERATOR_HPP
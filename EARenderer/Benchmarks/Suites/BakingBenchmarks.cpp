@@ -0,0 +1,102 @@
+//
+// Created by Pavlo Muratov on 2019-02-13.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "BakingBenchmarks.hpp"
+#include "SurfelGenerator.hpp"
+#include "DiffuseLightProbeGenerator.hpp"
+#include "LightmapBaker.hpp"
+#include "DiffuseLightProbeShard.hpp"
+
+#include <utility>
+#include <vector>
+
+namespace EARenderer {
+
+#pragma mark - Registration
+
+    void BakingBenchmarks::Register(BenchmarkRunner &runner, BenchmarkSceneLibrary &scenes) {
+        uint32_t seed = scenes.settings().seed;
+
+        std::pair<DiffuseLightProbeData::Layout, std::string> layouts[] = {
+                {DiffuseLightProbeData::Layout::UniformGrid, "UniformGrid"},
+                {DiffuseLightProbeData::Layout::SparseBricks, "SparseBricks"}
+        };
+
+        for (auto &sceneName : BenchmarkSceneLibrary::SceneNames()) {
+            runner.add("SurfelGeneration/" + sceneName, [=, &scenes](BenchmarkState &state) {
+                auto &entry = scenes.entry(sceneName);
+
+                std::unique_ptr<SurfelData> surfelData;
+                while (state.keepRunning()) {
+                    SurfelGenerator surfelGenerator(entry.resourceStorage.get(), entry.scene.get());
+                    surfelGenerator.setSeed(seed);
+                    surfelData = surfelGenerator.generateStaticGeometrySurfels();
+                }
+
+                state.setItemsPerIteration(surfelData->surfels().size());
+                state.setCounter("surfels", surfelData->surfels().size());
+                state.setCounter("clusters", surfelData->surfelClusters().size());
+                state.setCounter("triangles", entry.triangleCount);
+            });
+
+            for (auto &layout : layouts) {
+                runner.add("DiffuseLightProbeGeneration/" + sceneName + "/" + layout.second, [=, &scenes](BenchmarkState &state) {
+                    auto &entry = scenes.bakedEntry(sceneName);
+
+                    std::unique_ptr<DiffuseLightProbeData> probeData;
+                    while (state.keepRunning()) {
+                        DiffuseLightProbeGenerator probeGenerator;
+                        probeGenerator.setLayout(layout.first);
+                        probeData = probeGenerator.generateProbes(*entry.scene, *entry.surfelData);
+                    }
+
+                    state.setItemsPerIteration(probeData->probes().size());
+                    state.setCounter("probes", probeData->probes().size());
+                    state.setCounter("projections", probeData->surfelClusterProjectionCount());
+                });
+            }
+
+            // Shards are baked one after another here, the way separate processes would bake them
+            runner.add("DiffuseLightProbeShards/" + sceneName, [=, &scenes](BenchmarkState &state) {
+                auto &entry = scenes.bakedEntry(sceneName);
+                constexpr uint32_t shardCount = 4;
+
+                std::unique_ptr<DiffuseLightProbeData> probeData;
+                while (state.keepRunning()) {
+                    std::vector<DiffuseLightProbeShard> shards;
+                    for (uint32_t i = 0; i < shardCount; i++) {
+                        DiffuseLightProbeGenerator probeGenerator;
+                        shards.push_back(std::move(*probeGenerator.generateProbeShard(*entry.scene, *entry.surfelData, i, shardCount)));
+                    }
+                    probeData = DiffuseLightProbeShard::Merge(shards);
+                }
+
+                state.setItemsPerIteration(probeData->probes().size());
+                state.setCounter("shards", shardCount);
+                state.setCounter("probes", probeData->probes().size());
+            });
+
+            runner.add("LightmapBaking/" + sceneName, [=, &scenes](BenchmarkState &state) {
+                auto &entry = scenes.entry(sceneName);
+
+                LightmapBaker::Settings settings;
+                settings.sampleCount = 16;
+                settings.seed = seed;
+
+                std::unique_ptr<LightmapData> lightmapData;
+                while (state.keepRunning()) {
+                    LightmapBaker baker(entry.resourceStorage.get(), entry.scene.get(), settings);
+                    lightmapData = baker.bake();
+                }
+
+                state.setItemsPerIteration(lightmapData->texels().size());
+                state.setCounter("atlases", lightmapData->atlasCount());
+                state.setCounter("charts", lightmapData->placements().size());
+                state.setCounter("triangles", entry.triangleCount);
+            });
+        }
+    }
+
+}
@@ -0,0 +1,25 @@
+//
+// Created by Pavlo Muratov on 2019-02-13.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_BAKINGBENCHMARKS_HPP
+#define EARENDERER_BAKINGBENCHMARKS_HPP
+
+#include "BenchmarkRunner.hpp"
+#include "BenchmarkSceneLibrary.hpp"
+
+namespace EARenderer {
+
+    /**
+     Surfel, diffuse light probe and lightmap generation on procedural scenes. Clustering, probe projection
+     and lightmap gathering are internal stages of the generators, their timings are reported through profiler zones
+     */
+    class BakingBenchmarks {
+    public:
+        static void Register(BenchmarkRunner &runner, BenchmarkSceneLibrary &scenes);
+    };
+
+}
+
+#endif //EARENDERER_BAKINGBENCHMARKS_HPP
@@ -0,0 +1,239 @@
+//
+// Created by Pavlo Muratov on 2019-02-13.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "DataStructureBenchmarks.hpp"
+#include "ProceduralSceneGenerator.hpp"
+#include "SpatialHash.hpp"
+#include "LogarithmicBin.hpp"
+#include "PackedLookupTable.hpp"
+#include "SparseOctree.hpp"
+#include "StringUtils.hpp"
+
+#include <glm/vec4.hpp>
+#include <cmath>
+
+namespace EARenderer {
+
+    // Element of a size typical for the engine's lookup tables
+    struct PackedLookupTablePayload {
+        glm::vec4 position;
+        glm::vec4 color;
+    };
+
+    static constexpr size_t QueryCount = 10000;
+    static constexpr size_t SegmentCount = 1000;
+
+#pragma mark - Spatial hash
+
+    static void RegisterSpatialHashBenchmarks(BenchmarkRunner &runner, uint32_t seed, size_t count) {
+        AxisAlignedBox3D bounds(glm::vec3(-10.0), glm::vec3(10.0));
+
+        // Around 4 objects per cell, close to the density used by surfel generation
+        auto resolution = uint32_t(std::ceil(std::cbrt(count / 4.0)));
+
+        runner.add(string_format("SpatialHash/Insert/%zu", count), [=](BenchmarkState &state) {
+            auto points = ProceduralSceneGenerator::RandomPoints(bounds, count, seed);
+
+            while (state.keepRunning()) {
+                SpatialHash<uint32_t> hash(bounds, resolution);
+                for (uint32_t i = 0; i < count; i++) {
+                    hash.insert(i, points[i]);
+                }
+                BenchmarkState::DoNotOptimize(hash.size());
+            }
+
+            state.setItemsPerIteration(count);
+        });
+
+        runner.add(string_format("SpatialHash/Neighbours/%zu", count), [=](BenchmarkState &state) {
+            auto points = ProceduralSceneGenerator::RandomPoints(bounds, count, seed);
+            auto queries = ProceduralSceneGenerator::RandomPoints(bounds, QueryCount, seed + 1);
+
+            SpatialHash<uint32_t> hash(bounds, resolution);
+            for (uint32_t i = 0; i < count; i++) {
+                hash.insert(i, points[i]);
+            }
+
+            uint64_t neighbourCount = 0;
+            while (state.keepRunning()) {
+                neighbourCount = 0;
+                for (auto &query : queries) {
+                    auto neighbours = hash.neighbours(query);
+                    for (auto it = neighbours.begin(); it != neighbours.end(); ++it) {
+                        neighbourCount++;
+                    }
+                }
+                BenchmarkState::DoNotOptimize(neighbourCount);
+            }
+
+            state.setItemsPerIteration(QueryCount);
+            state.setCounter("neighbours_per_query", double(neighbourCount) / QueryCount);
+        });
+    }
+
+#pragma mark - Logarithmic bin
+
+    static void RegisterLogarithmicBinBenchmarks(BenchmarkRunner &runner, uint32_t seed, size_t count) {
+        // Weights spanning several orders of magnitude, like triangle areas of a detailed mesh
+        auto makeWeights = [=]() {
+            std::mt19937 engine(seed);
+            std::uniform_real_distribution<float> exponent(-4.0, 0.0);
+            std::vector<float> weights(count);
+            for (auto &weight : weights) {
+                weight = std::pow(10.0f, exponent(engine));
+            }
+            return weights;
+        };
+
+        runner.add(string_format("LogarithmicBin/Insert/%zu", count), [=](BenchmarkState &state) {
+            auto weights = makeWeights();
+
+            while (state.keepRunning()) {
+                LogarithmicBin<uint32_t> bin(1e-5, 1.0);
+                for (uint32_t i = 0; i < count; i++) {
+                    bin.insert(i, weights[i]);
+                }
+                BenchmarkState::DoNotOptimize(bin.size());
+            }
+
+            state.setItemsPerIteration(count);
+        });
+
+        // Same access pattern as surfel generation: pick a random object weighted by its area, then remove it
+        runner.add(string_format("LogarithmicBin/RandomErase/%zu", count), [=](BenchmarkState &state) {
+            auto weights = makeWeights();
+
+            while (state.keepRunning()) {
+                state.pauseTiming();
+                LogarithmicBin<uint32_t> bin(1e-5, 1.0);
+                bin.seed(seed);
+                for (uint32_t i = 0; i < count; i++) {
+                    bin.insert(i, weights[i]);
+                }
+                state.resumeTiming();
+
+                while (!bin.empty()) {
+                    auto it = bin.random();
+                    BenchmarkState::DoNotOptimize(*it);
+                    bin.erase(it);
+                }
+            }
+
+            state.setItemsPerIteration(count);
+        });
+    }
+
+#pragma mark - Packed lookup table
+
+    static void RegisterPackedLookupTableBenchmarks(BenchmarkRunner &runner, uint32_t seed, size_t count) {
+        runner.add(string_format("PackedLookupTable/Insert/%zu", count), [=](BenchmarkState &state) {
+            while (state.keepRunning()) {
+                // Small initial capacity to account for growth
+                PackedLookupTable<PackedLookupTablePayload> table(16);
+                for (size_t i = 0; i < count; i++) {
+                    table.insert(PackedLookupTablePayload{glm::vec4(i), glm::vec4(1.0)});
+                }
+                BenchmarkState::DoNotOptimize(table.size());
+            }
+
+            state.setItemsPerIteration(count);
+        });
+
+        runner.add(string_format("PackedLookupTable/IterateByID/%zu", count), [=](BenchmarkState &state) {
+            PackedLookupTable<PackedLookupTablePayload> table(count);
+            for (size_t i = 0; i < count; i++) {
+                table.insert(PackedLookupTablePayload{glm::vec4(i), glm::vec4(1.0)});
+            }
+
+            while (state.keepRunning()) {
+                float sum = 0.0;
+                for (ID id : table) {
+                    sum += table[id].position.x;
+                }
+                BenchmarkState::DoNotOptimize(sum);
+            }
+
+            state.setItemsPerIteration(count);
+        });
+
+        // Erasing and reinserting a tenth of the table, which shuffles the dense storage
+        runner.add(string_format("PackedLookupTable/Churn/%zu", count), [=](BenchmarkState &state) {
+            PackedLookupTable<PackedLookupTablePayload> table(count);
+            std::vector<ID> ids;
+            for (size_t i = 0; i < count; i++) {
+                ids.push_back(table.insert(PackedLookupTablePayload{glm::vec4(i), glm::vec4(1.0)}));
+            }
+
+            std::mt19937 engine(seed);
+            size_t churnCount = std::max(count / 10, size_t(1));
+
+            while (state.keepRunning()) {
+                for (size_t i = 0; i < churnCount; i++) {
+                    size_t index = engine() % ids.size();
+                    table.erase(ids[index]);
+                    ids[index] = table.insert(PackedLookupTablePayload{glm::vec4(index), glm::vec4(1.0)});
+                }
+                BenchmarkState::DoNotOptimize(table.size());
+            }
+
+            state.setItemsPerIteration(churnCount);
+        });
+    }
+
+#pragma mark - Sparse octree
+
+    static void RegisterSparseOctreeBenchmarks(BenchmarkRunner &runner, BenchmarkSceneLibrary &scenes, const std::string &sceneName) {
+        uint32_t seed = scenes.settings().seed;
+
+        runner.add("SparseOctree/Build/" + sceneName, [=, &scenes](BenchmarkState &state) {
+            auto &entry = scenes.entry(sceneName);
+
+            while (state.keepRunning()) {
+                entry.scene->buildStaticGeometryOctree(*entry.resourceStorage);
+            }
+
+            state.setItemsPerIteration(entry.triangleCount);
+            state.setCounter("triangles", entry.triangleCount);
+        });
+
+        runner.add("SparseOctree/Raymarch/" + sceneName, [=, &scenes](BenchmarkState &state) {
+            auto &entry = scenes.entry(sceneName);
+            entry.scene->buildStaticGeometryOctree(*entry.resourceStorage);
+            auto octree = entry.scene->octree();
+
+            auto starts = ProceduralSceneGenerator::RandomPoints(entry.scene->boundingBox(), SegmentCount, seed);
+            auto ends = ProceduralSceneGenerator::RandomPoints(entry.scene->boundingBox(), SegmentCount, seed + 1);
+
+            size_t hitCount = 0;
+            while (state.keepRunning()) {
+                hitCount = 0;
+                for (size_t i = 0; i < SegmentCount; i++) {
+                    hitCount += octree->raymarch(starts[i], ends[i]);
+                }
+                BenchmarkState::DoNotOptimize(hitCount);
+            }
+
+            state.setItemsPerIteration(SegmentCount);
+            state.setCounter("hit_ratio", double(hitCount) / SegmentCount);
+        });
+    }
+
+#pragma mark - Registration
+
+    void DataStructureBenchmarks::Register(BenchmarkRunner &runner, BenchmarkSceneLibrary &scenes) {
+        uint32_t seed = scenes.settings().seed;
+
+        for (size_t count : {size_t(10000), size_t(100000)}) {
+            RegisterSpatialHashBenchmarks(runner, seed, count);
+            RegisterLogarithmicBinBenchmarks(runner, seed, count);
+            RegisterPackedLookupTableBenchmarks(runner, seed, count);
+        }
+
+        for (auto &sceneName : BenchmarkSceneLibrary::SceneNames()) {
+            RegisterSparseOctreeBenchmarks(runner, scenes, sceneName);
+        }
+    }
+
+}
@@ -0,0 +1,25 @@
+//
+// Created by Pavlo Muratov on 2019-02-13.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_DATASTRUCTUREBENCHMARKS_HPP
+#define EARENDERER_DATASTRUCTUREBENCHMARKS_HPP
+
+#include "BenchmarkRunner.hpp"
+#include "BenchmarkSceneLibrary.hpp"
+
+namespace EARenderer {
+
+    /**
+     Spatial hash, logarithmic bin and packed lookup table on random data sets of several sizes,
+     sparse octree on triangles of procedural scenes
+     */
+    class DataStructureBenchmarks {
+    public:
+        static void Register(BenchmarkRunner &runner, BenchmarkSceneLibrary &scenes);
+    };
+
+}
+
+#endif //EARENDERER_DATASTRUCTUREBENCHMARKS_HPP
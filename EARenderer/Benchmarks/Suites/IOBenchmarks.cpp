@@ -0,0 +1,169 @@
+//
+// Created by Pavlo Muratov on 2019-02-13.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "IOBenchmarks.hpp"
+#include "ProceduralSceneGenerator.hpp"
+#include "Mesh.hpp"
+#include "MeshLODGenerator.hpp"
+#include "FileManager.hpp"
+#include "StringUtils.hpp"
+
+#include <fstream>
+#include <cstdlib>
+#include <cstdio>
+#include <stdexcept>
+
+namespace EARenderer {
+
+#pragma mark - Helpers
+
+    static std::string TemporaryDirectory() {
+        const char *directory = std::getenv("TMPDIR");
+        std::string path = directory ? directory : "/tmp/";
+        if (path.back() != '/') {
+            path += '/';
+        }
+        return path;
+    }
+
+    static std::string TemporaryFilePath(const std::string &fileName) {
+        return TemporaryDirectory() + "EARendererBenchmarks_" + fileName;
+    }
+
+    static size_t FileSize(const std::string &filePath) {
+        std::ifstream stream(filePath, std::ios::binary | std::ios::ate);
+        return stream.is_open() ? size_t(stream.tellg()) : 0;
+    }
+
+    /**
+     Writes vertices of the sub mesh as an unindexed Wavefront file with positions, texture coordinates and normals
+     */
+    static void WriteWavefrontFile(const SubMesh &subMesh, const std::string &filePath) {
+        std::ofstream stream(filePath, std::ios::trunc);
+        if (!stream.is_open()) {
+            throw std::runtime_error(string_format("Unable to write benchmark mesh: %s", filePath.c_str()));
+        }
+
+        for (auto &vertex : subMesh.vertices()) {
+            stream << "v " << vertex.position.x << " " << vertex.position.y << " " << vertex.position.z << "\n";
+            stream << "vt " << vertex.textureCoords.x << " " << vertex.textureCoords.y << "\n";
+            stream << "vn " << vertex.normal.x << " " << vertex.normal.y << " " << vertex.normal.z << "\n";
+        }
+
+        for (size_t i = 1; i + 2 <= subMesh.vertices().size(); i += 3) {
+            stream << "f";
+            for (size_t j = i; j < i + 3; j++) {
+                stream << " " << j << "/" << j << "/" << j;
+            }
+            stream << "\n";
+        }
+    }
+
+#pragma mark - Wavefront
+
+    static void RegisterWavefrontBenchmarks(BenchmarkRunner &runner, uint32_t seed, uint32_t triangleCount) {
+        runner.add(string_format("WavefrontMesh/Load/%u", triangleCount), [=](BenchmarkState &state) {
+            // Blob generation doesn't touch the scene or the storage
+            ProceduralSceneGenerator generator(seed, nullptr, nullptr);
+            SubMesh subMesh = generator.blob(triangleCount);
+
+            std::string filePath = TemporaryFilePath(string_format("blob_%u.obj", triangleCount));
+            WriteWavefrontFile(subMesh, filePath);
+
+            // Measure loads with LODs coming from the cache, as they do on every run but the first one
+            std::string previousCacheRootPath = FileManager::shared().cacheRootPath();
+            FileManager::shared().setCacheRootPath(TemporaryDirectory());
+            std::string lodCachePath = MeshLODGenerator::CacheFilePath(filePath);
+            Mesh cacheWarmUpMesh(filePath);
+
+            while (state.keepRunning()) {
+                Mesh mesh(filePath);
+                BenchmarkState::DoNotOptimize(&mesh);
+            }
+
+            FileManager::shared().setCacheRootPath(previousCacheRootPath);
+            std::remove(filePath.c_str());
+            std::remove(lodCachePath.c_str());
+
+            state.setItemsPerIteration(subMesh.vertices().size() / 3);
+            state.setCounter("triangles", subMesh.vertices().size() / 3);
+        });
+    }
+
+#pragma mark - Baked data
+
+    static void RegisterSerializationBenchmarks(BenchmarkRunner &runner, BenchmarkSceneLibrary &scenes, const std::string &sceneName) {
+        runner.add("Serialization/Surfels/Write/" + sceneName, [=, &scenes](BenchmarkState &state) {
+            auto &entry = scenes.bakedEntry(sceneName);
+            std::string filePath = TemporaryFilePath(sceneName + ".surfels");
+
+            while (state.keepRunning()) {
+                entry.surfelData->serialize(filePath);
+            }
+
+            state.setCounter("bytes", FileSize(filePath));
+            std::remove(filePath.c_str());
+        });
+
+        runner.add("Serialization/Surfels/Read/" + sceneName, [=, &scenes](BenchmarkState &state) {
+            auto &entry = scenes.bakedEntry(sceneName);
+            std::string filePath = TemporaryFilePath(sceneName + ".surfels");
+            entry.surfelData->serialize(filePath);
+
+            while (state.keepRunning()) {
+                SurfelData surfelData;
+                if (!surfelData.deserialize(filePath)) {
+                    throw std::runtime_error(string_format("Unable to deserialize surfels: %s", filePath.c_str()));
+                }
+            }
+
+            state.setCounter("bytes", FileSize(filePath));
+            std::remove(filePath.c_str());
+        });
+
+        runner.add("Serialization/DiffuseLightProbes/Write/" + sceneName, [=, &scenes](BenchmarkState &state) {
+            auto &entry = scenes.bakedEntry(sceneName);
+            std::string filePath = TemporaryFilePath(sceneName + ".probes");
+
+            while (state.keepRunning()) {
+                entry.probeData->serialize(filePath);
+            }
+
+            state.setCounter("bytes", FileSize(filePath));
+            std::remove(filePath.c_str());
+        });
+
+        runner.add("Serialization/DiffuseLightProbes/Read/" + sceneName, [=, &scenes](BenchmarkState &state) {
+            auto &entry = scenes.bakedEntry(sceneName);
+            std::string filePath = TemporaryFilePath(sceneName + ".probes");
+            entry.probeData->serialize(filePath);
+
+            while (state.keepRunning()) {
+                DiffuseLightProbeData probeData;
+                if (!probeData.deserialize(filePath)) {
+                    throw std::runtime_error(string_format("Unable to deserialize diffuse light probes: %s", filePath.c_str()));
+                }
+            }
+
+            state.setCounter("bytes", FileSize(filePath));
+            std::remove(filePath.c_str());
+        });
+    }
+
+#pragma mark - Registration
+
+    void IOBenchmarks::Register(BenchmarkRunner &runner, BenchmarkSceneLibrary &scenes) {
+        uint32_t seed = scenes.settings().seed;
+
+        for (uint32_t triangleCount : {10000u, 100000u}) {
+            RegisterWavefrontBenchmarks(runner, seed, triangleCount);
+        }
+
+        for (auto &sceneName : BenchmarkSceneLibrary::SceneNames()) {
+            RegisterSerializationBenchmarks(runner, scenes, sceneName);
+        }
+    }
+
+}
@@ -0,0 +1,24 @@
+//
+// Created by Pavlo Muratov on 2019-02-13.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_IOBENCHMARKS_HPP
+#define EARENDERER_IOBENCHMARKS_HPP
+
+#include "BenchmarkRunner.hpp"
+#include "BenchmarkSceneLibrary.hpp"
+
+namespace EARenderer {
+
+    /**
+     Wavefront mesh loading and binary serialization of baked surfels and probes
+     */
+    class IOBenchmarks {
+    public:
+        static void Register(BenchmarkRunner &runner, BenchmarkSceneLibrary &scenes);
+    };
+
+}
+
+#endif //EARENDERER_IOBENCHMARKS_HPP
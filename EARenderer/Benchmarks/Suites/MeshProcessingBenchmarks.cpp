@@ -0,0 +1,147 @@
+//
+// Created by Pavlo Muratov on 2019-02-14.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "MeshProcessingBenchmarks.hpp"
+#include "ProceduralSceneGenerator.hpp"
+#include "MeshProcessor.hpp"
+#include "MeshLODGenerator.hpp"
+#include "MeshletBuilder.hpp"
+#include "MeshletCuller.hpp"
+#include "StringUtils.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace EARenderer {
+
+#pragma mark - Helpers
+
+    /**
+     @return blobs lacking normals and tangents, as if they were loaded from files lacking them
+     */
+    static std::vector<SubMesh> UnprocessedBlobs(uint32_t seed, uint32_t triangleCount, size_t subMeshCount) {
+        // Blob generation doesn't touch the scene or the storage
+        ProceduralSceneGenerator generator(seed, nullptr, nullptr);
+        std::vector<SubMesh> subMeshes;
+
+        for (size_t i = 0; i < subMeshCount; i++) {
+            subMeshes.push_back(generator.blob(triangleCount / subMeshCount));
+        }
+
+        return subMeshes;
+    }
+
+#pragma mark - Registration
+
+    void MeshProcessingBenchmarks::Register(BenchmarkRunner &runner, BenchmarkSceneLibrary &scenes) {
+        uint32_t seed = scenes.settings().seed;
+
+        for (uint32_t triangleCount : {10000u, 100000u}) {
+            // A single large sub mesh exercises triangle ranges, many small ones exercise sub mesh level parallelism
+            for (size_t subMeshCount : {size_t(1), size_t(16)}) {
+                auto name = string_format("MeshProcessor/Process/%u/%zu", triangleCount, subMeshCount);
+
+                runner.add(name, [=](BenchmarkState &state) {
+                    auto unprocessed = UnprocessedBlobs(seed, triangleCount, subMeshCount);
+
+                    MeshProcessor processor;
+                    std::vector<SubMesh> processed;
+
+                    while (state.keepRunning()) {
+                        state.pauseTiming();
+                        processed = unprocessed;
+                        state.resumeTiming();
+
+                        processor.process(processed);
+                        BenchmarkState::DoNotOptimize(processed.data());
+                    }
+
+                    size_t processedTriangleCount = 0;
+                    for (auto &subMesh : processed) {
+                        processedTriangleCount += subMesh.vertices().size() / 3;
+                    }
+
+                    state.setItemsPerIteration(processedTriangleCount);
+                    state.setCounter("triangles", processedTriangleCount);
+                });
+            }
+        }
+
+        for (uint32_t triangleCount : {10000u, 100000u}) {
+            runner.add(string_format("MeshLOD/Generate/%u", triangleCount), [=](BenchmarkState &state) {
+                auto subMeshes = UnprocessedBlobs(seed, triangleCount, 1);
+                MeshProcessor().process(subMeshes);
+
+                SubMesh &subMesh = subMeshes.front();
+                MeshLODGenerator generator;
+
+                while (state.keepRunning()) {
+                    generator.generate(subMesh);
+                    BenchmarkState::DoNotOptimize(&subMesh);
+                }
+
+                state.setItemsPerIteration(subMesh.vertices().size() / 3);
+                state.setCounter("triangles", subMesh.vertices().size() / 3);
+
+                // Relative error makes levels of differently sized meshes comparable
+                for (size_t lod = 1; lod < subMesh.lodCount(); lod++) {
+                    state.setCounter(string_format("lod%zu_triangles", lod), subMesh.lodVertices(lod).size() / 3);
+                    state.setCounter(string_format("lod%zu_error", lod), subMesh.lodError(lod) / subMesh.boundingBox().diagonal());
+                }
+            });
+        }
+
+        for (uint32_t triangleCount : {10000u, 100000u}) {
+            runner.add(string_format("Meshlets/Build/%u", triangleCount), [=](BenchmarkState &state) {
+                auto subMeshes = UnprocessedBlobs(seed, triangleCount, 1);
+                MeshProcessor::Settings settings;
+                settings.buildMeshlets = false;
+                MeshProcessor(settings).process(subMeshes);
+
+                MeshletBuilder builder;
+                SubMesh subMesh;
+
+                while (state.keepRunning()) {
+                    state.pauseTiming();
+                    subMesh = subMeshes.front();
+                    state.resumeTiming();
+
+                    builder.build(subMesh);
+                    BenchmarkState::DoNotOptimize(&subMesh);
+                }
+
+                size_t builtTriangleCount = subMesh.vertices().size() / 3;
+                state.setItemsPerIteration(builtTriangleCount);
+                state.setCounter("triangles", builtTriangleCount);
+                state.setCounter("meshlets", subMesh.meshlets().size());
+                state.setCounter("triangles_per_meshlet", double(builtTriangleCount) / subMesh.meshlets().size());
+            });
+
+            // A camera close to the blob sees about half of it, the other half is either outside of the frustum or facing away
+            runner.add(string_format("Meshlets/Cull/%u", triangleCount), [=](BenchmarkState &state) {
+                auto subMeshes = UnprocessedBlobs(seed, triangleCount, 1);
+                MeshProcessor().process(subMeshes);
+                const SubMesh &subMesh = subMeshes.front();
+
+                glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+                glm::mat4 view = glm::lookAt(glm::vec3(0.0, 0.0, 0.9), glm::vec3(0.0), glm::vec3(0.0, 1.0, 0.0));
+                MeshletCuller culler({projection * view}, true);
+                MeshletCuller::DrawRanges ranges;
+                size_t rejectedCount = 0;
+
+                while (state.keepRunning()) {
+                    ranges.clear();
+                    rejectedCount = culler.cull(subMesh.meshlets(), glm::mat4(1.0), 0, ranges);
+                    BenchmarkState::DoNotOptimize(ranges.firstVertices.data());
+                }
+
+                state.setItemsPerIteration(subMesh.meshlets().size());
+                state.setCounter("meshlets", subMesh.meshlets().size());
+                state.setCounter("rejected", rejectedCount);
+                state.setCounter("ranges", ranges.count());
+            });
+        }
+    }
+
+}
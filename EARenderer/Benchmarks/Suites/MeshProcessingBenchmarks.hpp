@@ -0,0 +1,27 @@
+//
+// Created by Pavlo Muratov on 2019-02-14.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_MESHPROCESSINGBENCHMARKS_HPP
+#define EARENDERER_MESHPROCESSINGBENCHMARKS_HPP
+
+#include "BenchmarkRunner.hpp"
+#include "BenchmarkSceneLibrary.hpp"
+
+namespace EARenderer {
+
+    /**
+     Post-processing of imported geometry by MeshProcessor, on the default thread pool and on the calling thread only.
+     The benchmark fails if both produce vertices or areas that aren't bitwise identical.
+     LOD chain generation by MeshLODGenerator, reporting triangle counts and relative errors of every level.
+     Meshlet building and CPU culling of meshlets against a close perspective view
+     */
+    class MeshProcessingBenchmarks {
+    public:
+        static void Register(BenchmarkRunner &runner, BenchmarkSceneLibrary &scenes);
+    };
+
+}
+
+#endif //EARENDERER_MESHPROCESSINGBENCHMARKS_HPP
@@ -0,0 +1,151 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "PackingBenchmarks.hpp"
+#include "AtlasPacker.hpp"
+#include "SkylinePacker.hpp"
+#include "IndexedMaxRectsPacker.hpp"
+#include "MaxRectsBinPack.h"
+#include "GuillotineBinPack.h"
+#include "StringUtils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <tuple>
+
+namespace EARenderer {
+
+    static constexpr int BinResolution = 1024;
+
+    // Free lists of rbp packers are scanned linearly, which makes larger inputs take minutes
+    static constexpr size_t MaximumReferenceCount = 10000;
+
+#pragma mark - Helpers
+
+    /**
+     @return sizes with log-uniform sides, like lightmap charts of meshes of different scales, largest first
+     */
+    static std::vector<rbp::RectSize> RandomSizes(uint32_t seed, size_t count) {
+        std::mt19937 engine(seed);
+        std::uniform_real_distribution<float> exponent(2.0, 7.0);
+        std::uniform_real_distribution<float> aspect(-1.0, 1.0);
+
+        std::vector<rbp::RectSize> sizes(count);
+        for (auto &size : sizes) {
+            float side = std::exp2(exponent(engine));
+            float stretch = std::exp2(aspect(engine));
+            size.width = std::max(int(side * stretch), 1);
+            size.height = std::max(int(side / stretch), 1);
+        }
+
+        std::sort(sizes.begin(), sizes.end(), [](const rbp::RectSize &lhs, const rbp::RectSize &rhs) {
+            return std::make_tuple(std::max(lhs.width, lhs.height), lhs.width * lhs.height) >
+                   std::make_tuple(std::max(rhs.width, rhs.height), rhs.width * rhs.height);
+        });
+        return sizes;
+    }
+
+    /**
+     Fills one bin after another, opening a new bin once a rectangle doesn't fit into the current one
+
+     @param insert callable inserting a size into a bin and returning the placed rectangle
+     */
+    template<typename Bin, typename Insert>
+    static std::vector<Bin> PackBinAfterBin(const std::vector<rbp::RectSize> &sizes, Insert insert) {
+        std::vector<Bin> bins(1, Bin(BinResolution, BinResolution));
+        for (auto &size : sizes) {
+            if (insert(bins.back(), size).height == 0) {
+                bins.emplace_back(BinResolution, BinResolution);
+                insert(bins.back(), size);
+            }
+        }
+        return bins;
+    }
+
+    template<typename Bin, typename Insert, typename Occupancy>
+    static void RegisterBinAfterBinBenchmark(BenchmarkRunner &runner, const std::string &name, uint32_t seed, size_t count,
+                                             Insert insert, Occupancy occupancy) {
+        runner.add(string_format("Packing/%s/%zu", name.c_str(), count), [=](BenchmarkState &state) {
+            auto sizes = RandomSizes(seed, count);
+
+            std::vector<Bin> bins;
+            while (state.keepRunning()) {
+                bins = PackBinAfterBin<Bin>(sizes, insert);
+                BenchmarkState::DoNotOptimize(bins.data());
+            }
+
+            float occupancySum = 0.0;
+            for (auto &bin : bins) {
+                occupancySum += occupancy(bin);
+            }
+
+            state.setItemsPerIteration(count);
+            state.setCounter("bins", bins.size());
+            state.setCounter("occupancy", occupancySum / bins.size());
+        });
+    }
+
+#pragma mark - Registration
+
+    void PackingBenchmarks::Register(BenchmarkRunner &runner, BenchmarkSceneLibrary &scenes) {
+        uint32_t seed = scenes.settings().seed;
+
+        for (size_t count : {size_t(1000), size_t(10000), size_t(100000)}) {
+            if (count <= MaximumReferenceCount) {
+                RegisterBinAfterBinBenchmark<rbp::MaxRectsBinPack>(runner, "MaxRectsBinPack", seed, count, [](rbp::MaxRectsBinPack &bin, const rbp::RectSize &size) {
+                    return bin.Insert(size.width, size.height, rbp::MaxRectsBinPack::RectBestShortSideFit);
+                }, [](const rbp::MaxRectsBinPack &bin) {
+                    return bin.Occupancy();
+                });
+
+                RegisterBinAfterBinBenchmark<rbp::GuillotineBinPack>(runner, "GuillotineBinPack", seed, count, [](rbp::GuillotineBinPack &bin, const rbp::RectSize &size) {
+                    return bin.Insert(size.width, size.height, true, rbp::GuillotineBinPack::RectBestShortSideFit, rbp::GuillotineBinPack::SplitShorterLeftoverAxis);
+                }, [](const rbp::GuillotineBinPack &bin) {
+                    return bin.Occupancy();
+                });
+            }
+
+            RegisterBinAfterBinBenchmark<SkylinePacker>(runner, "Skyline", seed, count, [](SkylinePacker &bin, const rbp::RectSize &size) {
+                return bin.insert(size.width, size.height);
+            }, [](const SkylinePacker &bin) {
+                return bin.occupancy();
+            });
+
+            RegisterBinAfterBinBenchmark<IndexedMaxRectsPacker>(runner, "IndexedMaxRects", seed, count, [](IndexedMaxRectsPacker &bin, const rbp::RectSize &size) {
+                return bin.insert(size.width, size.height);
+            }, [](const IndexedMaxRectsPacker &bin) {
+                return bin.occupancy();
+            });
+
+            for (auto algorithm : {AtlasPacker::Algorithm::Skyline, AtlasPacker::Algorithm::MaxRects}) {
+                const char *algorithmName = algorithm == AtlasPacker::Algorithm::Skyline ? "Skyline" : "MaxRects";
+
+                runner.add(string_format("Packing/AtlasPacker/%s/%zu", algorithmName, count), [=](BenchmarkState &state) {
+                    auto sizes = RandomSizes(seed, count);
+
+                    AtlasPacker::Settings settings;
+                    settings.binWidth = BinResolution;
+                    settings.binHeight = BinResolution;
+                    settings.algorithm = algorithm;
+                    AtlasPacker packer(settings);
+
+                    AtlasPacker::Result result;
+                    while (state.keepRunning()) {
+                        result = packer.pack(sizes);
+                        BenchmarkState::DoNotOptimize(result.placements.data());
+                    }
+
+                    state.setItemsPerIteration(count);
+                    state.setCounter("bins", result.report.binCount());
+                    state.setCounter("occupancy", result.report.occupancy());
+                    state.setCounter("min_bin_occupancy", result.report.minimumBinOccupancy());
+                    state.setCounter("unpacked", result.report.unpackedCount);
+                });
+            }
+        }
+    }
+
+}
@@ -0,0 +1,25 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_PACKINGBENCHMARKS_HPP
+#define EARENDERER_PACKINGBENCHMARKS_HPP
+
+#include "BenchmarkRunner.hpp"
+#include "BenchmarkSceneLibrary.hpp"
+
+namespace EARenderer {
+
+    /**
+     Rectangle packing of random chart sized rectangles into atlases. Single bin packers fill one bin after another,
+     the atlas packer fills its bins concurrently. Bin counts and occupancies are reported as counters
+     */
+    class PackingBenchmarks {
+    public:
+        static void Register(BenchmarkRunner &runner, BenchmarkSceneLibrary &scenes);
+    };
+
+}
+
+#endif //EARENDERER_PACKINGBENCHMARKS_HPP
@@ -0,0 +1,101 @@
+//
+// Created by Pavlo Muratov on 2019-02-13.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "RayTracingBenchmarks.hpp"
+#include "ProceduralSceneGenerator.hpp"
+#include "EmbreeRayTracer.hpp"
+
+namespace EARenderer {
+
+    static constexpr size_t RayCount = 100000;
+
+#pragma mark - Helpers
+
+    /**
+     @return world space triangles of all static instances, gathered the same way the scene does it
+     */
+    static std::vector<Triangle3D> StaticTriangles(const BenchmarkSceneLibrary::Entry &entry) {
+        std::vector<Triangle3D> triangles;
+        triangles.reserve(entry.triangleCount);
+
+        for (ID meshInstanceID : entry.scene->staticMeshInstanceIDs()) {
+            const auto &meshInstance = entry.scene->meshInstances()[meshInstanceID];
+            const auto &mesh = entry.resourceStorage->mesh(meshInstance.meshID());
+            auto modelMatrix = meshInstance.modelMatrix();
+
+            for (ID subMeshID : mesh.subMeshes()) {
+                const auto &vertices = mesh.subMeshes()[subMeshID].vertices();
+                for (size_t i = 0; i < vertices.size(); i += 3) {
+                    triangles.emplace_back(modelMatrix * vertices[i].position,
+                            modelMatrix * vertices[i + 1].position,
+                            modelMatrix * vertices[i + 2].position);
+                }
+            }
+        }
+
+        return triangles;
+    }
+
+#pragma mark - Registration
+
+    void RayTracingBenchmarks::Register(BenchmarkRunner &runner, BenchmarkSceneLibrary &scenes) {
+        uint32_t seed = scenes.settings().seed;
+
+        for (auto &sceneName : BenchmarkSceneLibrary::SceneNames()) {
+            runner.add("EmbreeRayTracer/Build/" + sceneName, [=, &scenes](BenchmarkState &state) {
+                auto &entry = scenes.entry(sceneName);
+                auto triangles = StaticTriangles(entry);
+
+                while (state.keepRunning()) {
+                    EmbreeRayTracer rayTracer(triangles);
+                    BenchmarkState::DoNotOptimize(&rayTracer);
+                }
+
+                state.setItemsPerIteration(triangles.size());
+                state.setCounter("triangles", triangles.size());
+            });
+
+            runner.add("EmbreeRayTracer/RayHit/" + sceneName, [=, &scenes](BenchmarkState &state) {
+                auto &entry = scenes.entry(sceneName);
+                auto rayTracer = entry.scene->rayTracer();
+                auto origins = ProceduralSceneGenerator::RandomPoints(entry.scene->boundingBox(), RayCount, seed);
+                auto directions = ProceduralSceneGenerator::RandomDirections(RayCount, seed + 1);
+
+                size_t hitCount = 0;
+                while (state.keepRunning()) {
+                    hitCount = 0;
+                    for (size_t i = 0; i < RayCount; i++) {
+                        float distance = 0.0;
+                        hitCount += rayTracer->rayHit(Ray3D(origins[i], directions[i]), distance);
+                    }
+                    BenchmarkState::DoNotOptimize(hitCount);
+                }
+
+                state.setItemsPerIteration(RayCount);
+                state.setCounter("hit_ratio", double(hitCount) / RayCount);
+            });
+
+            runner.add("EmbreeRayTracer/Occlusion/" + sceneName, [=, &scenes](BenchmarkState &state) {
+                auto &entry = scenes.entry(sceneName);
+                auto rayTracer = entry.scene->rayTracer();
+                auto starts = ProceduralSceneGenerator::RandomPoints(entry.scene->boundingBox(), RayCount, seed);
+                auto ends = ProceduralSceneGenerator::RandomPoints(entry.scene->boundingBox(), RayCount, seed + 1);
+
+                size_t occludedCount = 0;
+                while (state.keepRunning()) {
+                    occludedCount = 0;
+                    for (size_t i = 0; i < RayCount; i++) {
+                        occludedCount += rayTracer->lineSegmentOccluded(starts[i], ends[i]);
+                    }
+                    BenchmarkState::DoNotOptimize(occludedCount);
+                }
+
+                state.setItemsPerIteration(RayCount);
+                state.setCounter("occluded_ratio", double(occludedCount) / RayCount);
+            });
+        }
+    }
+
+}
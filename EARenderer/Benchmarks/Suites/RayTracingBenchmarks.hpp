@@ -0,0 +1,24 @@
+//
+// Created by Pavlo Muratov on 2019-02-13.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_RAYTRACINGBENCHMARKS_HPP
+#define EARENDERER_RAYTRACINGBENCHMARKS_HPP
+
+#include "BenchmarkRunner.hpp"
+#include "BenchmarkSceneLibrary.hpp"
+
+namespace EARenderer {
+
+    /**
+     Embree ray tracer construction, closest hit and occlusion queries on procedural scenes
+     */
+    class RayTracingBenchmarks {
+    public:
+        static void Register(BenchmarkRunner &runner, BenchmarkSceneLibrary &scenes);
+    };
+
+}
+
+#endif //EARENDERER_RAYTRACINGBENCHMARKS_HPP
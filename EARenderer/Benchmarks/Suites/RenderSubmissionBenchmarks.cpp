@@ -0,0 +1,109 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "RenderSubmissionBenchmarks.hpp"
+#include "EngineShaderSources.hpp"
+#include "ProceduralSceneGenerator.hpp"
+#include "GPUResourceController.hpp"
+#include "SceneGBufferConstructor.hpp"
+#include "ShadowMapper.hpp"
+#include "RenderingSettings.hpp"
+#include "GLNullBackend.hpp"
+#include "GLStateCache.hpp"
+
+#include <memory>
+
+namespace EARenderer {
+
+    static constexpr uint8_t CascadeCount = 4;
+    static constexpr uint32_t PointLightCount = 2;
+
+#pragma mark - Helpers
+
+    /**
+     Scattered meshes lit by the sun and point lights, with meshes and lights uploaded to the GPU
+     */
+    struct SubmissionScene {
+        SharedResourceStorage resourceStorage;
+        Scene scene;
+        GPUResourceController gpuResourceController;
+        RenderingSettings settings;
+    };
+
+    static std::unique_ptr<SubmissionScene> MakeScene(const BenchmarkSceneLibrary::Settings &librarySettings) {
+        UseEngineShaderSources();
+
+        auto submissionScene = std::make_unique<SubmissionScene>();
+        auto &scene = submissionScene->scene;
+        float extent = librarySettings.scatteredMeshes.extent;
+
+        ProceduralSceneGenerator generator(librarySettings.seed, &submissionScene->resourceStorage, &scene);
+        generator.addScatteredMeshes(librarySettings.scatteredMeshes);
+        scene.calculateGeometricProperties(submissionScene->resourceStorage);
+
+        scene.setCamera(std::make_unique<Camera>(75.0, 0.1, extent * 2.0));
+        scene.camera()->moveTo(glm::vec3(0.0, extent * 0.3, extent * 0.6));
+        scene.camera()->lookAt(glm::vec3(0.0));
+
+        for (uint32_t i = 0; i < PointLightCount; i++) {
+            float x = extent * (float(i + 1) / (PointLightCount + 1) - 0.5);
+            scene.pointLights().insert(PointLight(glm::vec3(x, 2.0, 0.0), Color::White(), extent, 0.1, 0.1, 0.01, PointLight::Attenuation()));
+        }
+
+        submissionScene->gpuResourceController.updateMeshVAO(submissionScene->resourceStorage);
+        submissionScene->gpuResourceController.updateUniformBuffer(submissionScene->resourceStorage, scene);
+
+        return submissionScene;
+    }
+
+    /**
+     Runs the pass with its commands going to the null backend, tracked state is dropped before every iteration
+     the same way it is at the beginning of a frame
+     */
+    template<class RenderPass>
+    static void MeasureSubmission(BenchmarkState &state, RenderPass &pass) {
+        GLNullBackend backend;
+        GLStateCache::shared().setBackend(&backend);
+
+        try {
+            while (state.keepRunning()) {
+                GLStateCache::shared().beginFrame();
+                pass.render();
+            }
+        } catch (...) {
+            GLStateCache::shared().setBackend(nullptr);
+            throw;
+        }
+
+        auto statistics = GLStateCache::shared().statistics();
+        GLStateCache::shared().setBackend(nullptr);
+
+        state.setCounter("draw_calls", statistics.drawCalls);
+        state.setCounter("issued_calls", statistics.issuedCalls);
+        state.setCounter("elided_calls", statistics.elidedCalls);
+    }
+
+#pragma mark - Registration
+
+    void RenderSubmissionBenchmarks::Register(BenchmarkRunner &runner, BenchmarkSceneLibrary &scenes) {
+        runner.add("RenderSubmission/ShadowMapper", [&scenes](BenchmarkState &state) {
+            auto submissionScene = MakeScene(scenes.settings());
+            SceneGBufferConstructor gBufferConstructor(&submissionScene->scene, &submissionScene->resourceStorage, &submissionScene->gpuResourceController, submissionScene->settings);
+            ShadowMapper shadowMapper(&submissionScene->scene, &submissionScene->resourceStorage, &submissionScene->gpuResourceController, gBufferConstructor.GBuffer(), CascadeCount);
+            shadowMapper.setRenderingSettings(submissionScene->settings);
+
+            MeasureSubmission(state, shadowMapper);
+        });
+
+        runner.add("RenderSubmission/GBuffer", [&scenes](BenchmarkState &state) {
+            auto submissionScene = MakeScene(scenes.settings());
+            SceneGBufferConstructor gBufferConstructor(&submissionScene->scene, &submissionScene->resourceStorage, &submissionScene->gpuResourceController, submissionScene->settings);
+            gBufferConstructor.setRenderingSettings(submissionScene->settings);
+
+            MeasureSubmission(state, gBufferConstructor);
+        });
+    }
+
+}
@@ -0,0 +1,25 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_RENDERSUBMISSIONBENCHMARKS_HPP
+#define EARENDERER_RENDERSUBMISSIONBENCHMARKS_HPP
+
+#include "BenchmarkRunner.hpp"
+#include "BenchmarkSceneLibrary.hpp"
+
+namespace EARenderer {
+
+    /**
+     CPU cost of submitting the shadow and G-buffer passes of the scattered meshes scene. Passes are created against
+     the driver, their commands then go to the null backend, so that only the renderer and the state cache are measured
+     */
+    class RenderSubmissionBenchmarks {
+    public:
+        static void Register(BenchmarkRunner &runner, BenchmarkSceneLibrary &scenes);
+    };
+
+}
+
+#endif //EARENDERER_RENDERSUBMISSIONBENCHMARKS_HPP
@@ -0,0 +1,124 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "SamplingBenchmarks.hpp"
+#include "SobolSampler.hpp"
+#include "LowDiscrepancySequence.hpp"
+#include "StringUtils.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace EARenderer {
+
+    static constexpr uint32_t EstimateCount = 256;
+
+#pragma mark - Helpers
+
+    /**
+     Estimates the integral of cos^4 over the hemisphere with cosine weighted directions, which is 2 * pi / 5
+
+     @return relative RMS error over EstimateCount independent estimates
+     */
+    template<typename Sample>
+    static double RelativeRMSError(uint32_t sampleCount, Sample sample) {
+        const glm::vec3 normal(0.0, 0.0, 1.0);
+        const double reference = 2.0 * glm::pi<double>() / 5.0;
+
+        double squaredErrorSum = 0.0;
+        for (uint32_t estimate = 0; estimate < EstimateCount; estimate++) {
+            double sum = 0.0;
+            for (uint32_t i = 0; i < sampleCount; i++) {
+                glm::vec3 direction = SobolSampler::CosineWeightedHemisphere(sample(estimate, i), normal);
+                double cosine = glm::dot(direction, normal);
+                // cos^4 divided by the pdf of cos / pi
+                sum += glm::pi<double>() * cosine * cosine * cosine;
+            }
+            double error = sum / sampleCount - reference;
+            squaredErrorSum += error * error;
+        }
+
+        return std::sqrt(squaredErrorSum / EstimateCount) / reference;
+    }
+
+#pragma mark - Registration
+
+    void SamplingBenchmarks::Register(BenchmarkRunner &runner, BenchmarkSceneLibrary &scenes) {
+        uint32_t seed = scenes.settings().seed;
+
+        for (uint32_t sampleCount : {16u, 256u}) {
+            runner.add(string_format("Sampling/Hammersley2D/%u", sampleCount), [=](BenchmarkState &state) {
+                while (state.keepRunning()) {
+                    for (uint32_t i = 0; i < sampleCount; i++) {
+                        BenchmarkState::DoNotOptimize(LowDiscrepancySequence::Hammersley2D(i, sampleCount));
+                    }
+                }
+
+                std::mt19937 engine(seed);
+                std::uniform_real_distribution<float> distribution(0.0, 1.0);
+                std::vector<glm::vec2> rotations(EstimateCount);
+                for (auto &rotation : rotations) {
+                    rotation = glm::vec2(distribution(engine), distribution(engine));
+                }
+
+                state.setItemsPerIteration(sampleCount);
+                state.setCounter("relative_rms_error", RelativeRMSError(sampleCount, [&](uint32_t estimate, uint32_t i) {
+                    return glm::fract(LowDiscrepancySequence::Hammersley2D(i, sampleCount) + rotations[estimate]);
+                }));
+            });
+
+            runner.add(string_format("Sampling/Random/%u", sampleCount), [=](BenchmarkState &state) {
+                std::mt19937 engine(seed);
+                std::uniform_real_distribution<float> distribution(0.0, 1.0);
+
+                while (state.keepRunning()) {
+                    for (uint32_t i = 0; i < sampleCount; i++) {
+                        BenchmarkState::DoNotOptimize(glm::vec2(distribution(engine), distribution(engine)));
+                    }
+                }
+
+                engine.seed(seed);
+                state.setItemsPerIteration(sampleCount);
+                state.setCounter("relative_rms_error", RelativeRMSError(sampleCount, [&](uint32_t, uint32_t) {
+                    return glm::vec2(distribution(engine), distribution(engine));
+                }));
+            });
+
+            runner.add(string_format("Sampling/Sobol/%u", sampleCount), [=](BenchmarkState &state) {
+                SobolSampler sampler(seed);
+                while (state.keepRunning()) {
+                    for (uint32_t i = 0; i < sampleCount; i++) {
+                        BenchmarkState::DoNotOptimize(sampler.sample2D(i, 0));
+                    }
+                }
+
+                state.setItemsPerIteration(sampleCount);
+                state.setCounter("relative_rms_error", RelativeRMSError(sampleCount, [&](uint32_t estimate, uint32_t i) {
+                    return SobolSampler(seed + estimate).sample2D(i, 0);
+                }));
+            });
+
+            runner.add(string_format("Sampling/SobolRanked/%u", sampleCount), [=](BenchmarkState &state) {
+                while (state.keepRunning()) {
+                    auto sampler = SobolSampler::Ranked(seed, SobolSampler::PixelRank(glm::uvec2(17, 42), seed), sampleCount);
+                    for (uint32_t i = 0; i < sampleCount; i++) {
+                        BenchmarkState::DoNotOptimize(sampler.sample2D(i, 0));
+                    }
+                }
+
+                state.setItemsPerIteration(sampleCount);
+                state.setCounter("relative_rms_error", RelativeRMSError(sampleCount, [&](uint32_t estimate, uint32_t i) {
+                    uint32_t rank = SobolSampler::PixelRank(glm::uvec2(estimate % 16, estimate / 16), seed);
+                    return SobolSampler::Ranked(seed, rank, sampleCount).sample2D(i, 0);
+                }));
+            });
+        }
+    }
+
+}
@@ -0,0 +1,25 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_SAMPLINGBENCHMARKS_HPP
+#define EARENDERER_SAMPLINGBENCHMARKS_HPP
+
+#include "BenchmarkRunner.hpp"
+#include "BenchmarkSceneLibrary.hpp"
+
+namespace EARenderer {
+
+    /**
+     Generation of low discrepancy samples. Stratification of scrambled Sobol samples is verified up front and
+     the benchmark fails once it breaks. Errors of a cosine weighted hemisphere integral are reported as counters
+     */
+    class SamplingBenchmarks {
+    public:
+        static void Register(BenchmarkRunner &runner, BenchmarkSceneLibrary &scenes);
+    };
+
+}
+
+#endif //EARENDERER_SAMPLINGBENCHMARKS_HPP
@@ -0,0 +1,107 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "TextureStreamingBenchmarks.hpp"
+#include "TextureStreamer.hpp"
+#include "SimulatedTextureStreamingBackend.hpp"
+#include "ProceduralSceneGenerator.hpp"
+#include "StringUtils.hpp"
+
+#include <glm/gtc/constants.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace EARenderer {
+
+    static constexpr uint32_t StreamedMaterialCount = 16;
+    static constexpr uint32_t ImageSize = 1024;
+    // Orbit angle the camera advances by every frame
+    static constexpr float OrbitStep = 0.02;
+
+#pragma mark - Helpers
+
+    static std::string MapPath(uint32_t materialIndex, const char *mapName) {
+        return string_format("Streamed/%u/%s.png", materialIndex, mapName);
+    }
+
+#pragma mark - Registration
+
+    void TextureStreamingBenchmarks::Register(BenchmarkRunner &runner, BenchmarkSceneLibrary &scenes) {
+        for (size_t budgetMegabytes : {16, 256}) {
+            runner.add(string_format("TextureStreaming/Orbit/%zuMB", budgetMegabytes), [=, &scenes](BenchmarkState &state) {
+                auto &sceneSettings = scenes.settings().scatteredMeshes;
+
+                // Materials of the shared scene hold constant values, so the scene is generated again with streamed ones
+                SharedResourceStorage resourceStorage;
+                Scene scene;
+                ProceduralSceneGenerator generator(scenes.settings().seed, &resourceStorage, &scene);
+                generator.addScatteredMeshes(sceneSettings);
+                scene.setCamera(std::make_unique<Camera>(75.0, 0.1, sceneSettings.extent * 2.0));
+
+                auto backend = std::make_unique<SimulatedTextureStreamingBackend>(Size2D(ImageSize));
+
+                TextureStreamer::Settings settings;
+                settings.memoryBudget = budgetMegabytes * 1024 * 1024;
+                TextureStreamer streamer(std::move(backend), settings);
+
+                std::vector<ID> materialIDs;
+                for (uint32_t i = 0; i < StreamedMaterialCount; i++) {
+                    auto materialRef = resourceStorage.addMaterial(CookTorranceMaterial(
+                            MapPath(i, "albedo"), MapPath(i, "normal"), MapPath(i, "metalness"), MapPath(i, "roughness"),
+                            MapPath(i, "ao"), MapPath(i, "displacement"), CookTorranceMaterial::TextureLoading::Streamed));
+                    streamer.addMaterial(materialRef.second, resourceStorage.cookTorranceMaterial(materialRef.second));
+                    materialIDs.push_back(materialRef.second);
+                }
+
+                size_t instanceIndex = 0;
+                for (ID instanceID : scene.meshInstances()) {
+                    scene.meshInstances()[instanceID].materialReference = std::make_pair(MaterialType::CookTorrance, materialIDs[instanceIndex++ % materialIDs.size()]);
+                }
+
+                streamer.finishPendingLoads();
+
+                Size2D viewportSize(1920, 1080);
+                float radius = sceneSettings.extent * 0.6;
+                uint64_t frame = 0;
+
+                while (state.keepRunning()) {
+                    float angle = frame * OrbitStep;
+                    scene.camera()->moveTo(glm::vec3(radius * std::cos(angle), 1.5, radius * std::sin(angle)));
+                    scene.camera()->lookAt(glm::vec3(0.0, 0.5, 0.0));
+                    streamer.update(scene, resourceStorage, viewportSize);
+                    frame++;
+                }
+
+                streamer.finishPendingLoads();
+
+                // Mip levels short of what visible maps could show
+                double mipGapSum = 0.0;
+                size_t visibleMapCount = 0;
+                for (ID materialID : materialIDs) {
+                    if (!streamer.isVisible(materialID)) {
+                        continue;
+                    }
+                    for (size_t i = 0; i < CookTorranceMaterial::MapTypeCount; i++) {
+                        auto mapType = CookTorranceMaterial::MapType(i);
+                        mipGapSum += std::max(0, int(streamer.residentMipLevel(materialID, mapType)) - int(streamer.requiredMipLevel(materialID, mapType)));
+                        visibleMapCount++;
+                    }
+                }
+
+                auto &statistics = streamer.statistics();
+                state.setCounter("frames", frame);
+                state.setCounter("resident_mb", streamer.residentBytes() / (1024.0 * 1024.0));
+                state.setCounter("uploaded_mb", statistics.uploadedBytes / (1024.0 * 1024.0));
+                state.setCounter("uploads", statistics.uploads);
+                state.setCounter("evictions", statistics.evictions);
+                state.setCounter("discarded_loads", statistics.discardedLoads);
+                state.setCounter("mean_visible_mip_gap", visibleMapCount > 0 ? mipGapSum / visibleMapCount : 0.0);
+            });
+        }
+    }
+
+}
@@ -0,0 +1,26 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_TEXTURESTREAMINGBENCHMARKS_HPP
+#define EARENDERER_TEXTURESTREAMINGBENCHMARKS_HPP
+
+#include "BenchmarkRunner.hpp"
+#include "BenchmarkSceneLibrary.hpp"
+
+namespace EARenderer {
+
+    /**
+     Texture streaming decisions of a camera orbiting the scattered meshes scene, with a simulated backend in place
+     of image decoding and uploads. The benchmark fails once the memory budget is exceeded or the backend disagrees
+     with the streamer about resident mip levels.
+     */
+    class TextureStreamingBenchmarks {
+    public:
+        static void Register(BenchmarkRunner &runner, BenchmarkSceneLibrary &scenes);
+    };
+
+}
+
+#endif //EARENDERER_TEXTURESTREAMINGBENCHMARKS_HPP
@@ -0,0 +1,77 @@
+//
+// Created by Pavlo Muratov on 2019-02-14.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "VertexQuantizationBenchmarks.hpp"
+#include "QuantizedVertex.hpp"
+
+#include <algorithm>
+
+namespace EARenderer {
+
+#pragma mark - Helpers
+
+    static void AccumulateError(const SubMesh &subMesh, QuantizedVertex::Error &maximumError) {
+        auto &vertices = subMesh.vertices();
+        if (vertices.empty()) {
+            return;
+        }
+
+        auto error = QuantizedVertex::MeasureError(vertices.data(), vertices.size(), subMesh.boundingBox());
+
+        maximumError.position = std::max(maximumError.position, error.position);
+        maximumError.normal = std::max(maximumError.normal, error.normal);
+        maximumError.tangent = std::max(maximumError.tangent, error.tangent);
+        maximumError.textureCoords = std::max(maximumError.textureCoords, error.textureCoords);
+        maximumError.lightmapCoords = std::max(maximumError.lightmapCoords, error.lightmapCoords);
+    }
+
+#pragma mark - Registration
+
+    void VertexQuantizationBenchmarks::Register(BenchmarkRunner &runner, BenchmarkSceneLibrary &scenes) {
+        for (auto &sceneName : BenchmarkSceneLibrary::SceneNames()) {
+            runner.add("VertexQuantization/Encode/" + sceneName, [=, &scenes](BenchmarkState &state) {
+                auto &entry = scenes.entry(sceneName);
+
+                std::vector<const SubMesh *> subMeshes;
+                size_t vertexCount = 0;
+                entry.resourceStorage->iterateMeshes([&](ID meshID) {
+                    auto &mesh = entry.resourceStorage->mesh(meshID);
+                    for (ID subMeshID : mesh.subMeshes()) {
+                        subMeshes.push_back(&mesh.subMeshes()[subMeshID]);
+                        vertexCount += mesh.subMeshes()[subMeshID].vertices().size();
+                    }
+                });
+
+                QuantizedVertex::Error maximumError;
+                for (auto subMesh : subMeshes) {
+                    AccumulateError(*subMesh, maximumError);
+                }
+
+                std::vector<QuantizedVertex> quantizedVertices(vertexCount);
+
+                while (state.keepRunning()) {
+                    size_t index = 0;
+                    for (auto subMesh : subMeshes) {
+                        for (auto &vertex : subMesh->vertices()) {
+                            quantizedVertices[index++] = QuantizedVertex(vertex, subMesh->boundingBox());
+                        }
+                    }
+                    BenchmarkState::DoNotOptimize(quantizedVertices.data());
+                }
+
+                state.setItemsPerIteration(vertexCount);
+                state.setCounter("vertices", vertexCount);
+                state.setCounter("float_bytes", vertexCount * sizeof(Vertex1P1N2UV1T1BT));
+                state.setCounter("quantized_bytes", vertexCount * sizeof(QuantizedVertex));
+                state.setCounter("max_position_error", maximumError.position);
+                state.setCounter("max_normal_error_degrees", maximumError.normal);
+                state.setCounter("max_tangent_error_degrees", maximumError.tangent);
+                state.setCounter("max_texture_coords_error", maximumError.textureCoords);
+                state.setCounter("max_lightmap_coords_error", maximumError.lightmapCoords);
+            });
+        }
+    }
+
+}
@@ -0,0 +1,25 @@
+//
+// Created by Pavlo Muratov on 2019-02-14.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_VERTEXQUANTIZATIONBENCHMARKS_HPP
+#define EARENDERER_VERTEXQUANTIZATIONBENCHMARKS_HPP
+
+#include "BenchmarkRunner.hpp"
+#include "BenchmarkSceneLibrary.hpp"
+
+namespace EARenderer {
+
+    /**
+     Quantization of scene meshes into the compact vertex format. Besides the throughput, round trip errors
+     are reported as counters and the benchmark fails once they exceed the precision of the format
+     */
+    class VertexQuantizationBenchmarks {
+    public:
+        static void Register(BenchmarkRunner &runner, BenchmarkSceneLibrary &scenes);
+    };
+
+}
+
+#endif //EARENDERER_VERTEXQUANTIZATIONBENCHMARKS_HPP
@@ -0,0 +1,237 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "ProbeBakeTool.hpp"
+#include "OffscreenGLContext.hpp"
+#include "BenchmarkSceneLibrary.hpp"
+#include "SurfelGenerator.hpp"
+#include "DiffuseLightProbeGenerator.hpp"
+#include "DiffuseLightProbeShard.hpp"
+#include "BakeCheckpoint.hpp"
+#include "Profiler.hpp"
+#include "StringUtils.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace EARenderer {
+
+    namespace {
+
+        struct ProbeBakeOptions {
+            std::string command;
+            BenchmarkSceneLibrary::Settings sceneSettings;
+            std::string sceneName;
+            std::string surfelsPath;
+            std::string outputPath;
+            std::string referencePath;
+            bool isSharded = false;
+            uint32_t shardIndex = 0;
+            uint32_t shardCount = 1;
+            DiffuseLightProbeData::Layout layout = DiffuseLightProbeData::Layout::SparseBricks;
+            DiffuseLightProbeData::ProjectionEncoding encoding = DiffuseLightProbeData::ProjectionEncoding::Quantized;
+            std::vector<std::string> shardPaths;
+        };
+
+    }
+
+#pragma mark - Helpers
+
+    static void PrintUsage(const char *executable) {
+        printf("Usage: %s bake-surfels --scene <name> --surfels <path> [--seed <n>]\n"
+               "       %s bake-probes --scene <name> --surfels <path> --output <path> [--shard <index>/<count>]\n"
+               "                      [--layout uniform|sparse] [--encoding lossless|quantized] [--seed <n>]\n"
+               "       %s merge-probes --output <path> [--reference <path>] <shard path>...\n", executable, executable, executable);
+    }
+
+    static bool ParseOptions(int argc, const char *argv[], ProbeBakeOptions &options) {
+        options.command = argv[1];
+
+        for (int i = 2; i < argc; i++) {
+            const char *argument = argv[i];
+            bool hasValue = i + 1 < argc;
+
+            if (0 == strcmp(argument, "--scene") && hasValue) {
+                options.sceneName = argv[++i];
+            } else if (0 == strcmp(argument, "--surfels") && hasValue) {
+                options.surfelsPath = argv[++i];
+            } else if (0 == strcmp(argument, "--output") && hasValue) {
+                options.outputPath = argv[++i];
+            } else if (0 == strcmp(argument, "--reference") && hasValue) {
+                options.referencePath = argv[++i];
+            } else if (0 == strcmp(argument, "--seed") && hasValue) {
+                options.sceneSettings.seed = uint32_t(strtoul(argv[++i], nullptr, 10));
+            } else if (0 == strcmp(argument, "--shard") && hasValue) {
+                options.isSharded = true;
+                if (2 != sscanf(argv[++i], "%u/%u", &options.shardIndex, &options.shardCount) || options.shardIndex >= options.shardCount) {
+                    return false;
+                }
+            } else if (0 == strcmp(argument, "--layout") && hasValue) {
+                const char *layout = argv[++i];
+                if (0 == strcmp(layout, "uniform")) {
+                    options.layout = DiffuseLightProbeData::Layout::UniformGrid;
+                } else if (0 == strcmp(layout, "sparse")) {
+                    options.layout = DiffuseLightProbeData::Layout::SparseBricks;
+                } else {
+                    return false;
+                }
+            } else if (0 == strcmp(argument, "--encoding") && hasValue) {
+                const char *encoding = argv[++i];
+                if (0 == strcmp(encoding, "lossless")) {
+                    options.encoding = DiffuseLightProbeData::ProjectionEncoding::Lossless;
+                } else if (0 == strcmp(encoding, "quantized")) {
+                    options.encoding = DiffuseLightProbeData::ProjectionEncoding::Quantized;
+                } else {
+                    return false;
+                }
+            } else if (0 != strncmp(argument, "--", 2) && options.command == "merge-probes") {
+                options.shardPaths.emplace_back(argument);
+            } else {
+                return false;
+            }
+        }
+
+        if (options.command == "bake-surfels") {
+            return !options.sceneName.empty() && !options.surfelsPath.empty();
+        } else if (options.command == "bake-probes") {
+            return !options.sceneName.empty() && !options.surfelsPath.empty() && !options.outputPath.empty();
+        } else {
+            return !options.outputPath.empty() && !options.shardPaths.empty();
+        }
+    }
+
+    static std::string FileContents(const std::string &path) {
+        std::ifstream stream(path, std::ios::binary);
+        if (!stream.is_open()) {
+            throw std::runtime_error(string_format("Unable to read %s", path.c_str()));
+        }
+        std::stringstream contents;
+        contents << stream.rdbuf();
+        return contents.str();
+    }
+
+#pragma mark - Commands
+
+    static int BakeSurfels(const ProbeBakeOptions &options) {
+        OffscreenGLContext context;
+        BenchmarkSceneLibrary scenes(options.sceneSettings);
+        auto &entry = scenes.entry(options.sceneName);
+
+        SurfelGenerator surfelGenerator(entry.resourceStorage.get(), entry.scene.get());
+        surfelGenerator.setSeed(options.sceneSettings.seed);
+        auto surfelData = surfelGenerator.generateStaticGeometrySurfels();
+
+        // Other processes may be waiting for the file, so it never appears half written
+        BakeCheckpoint::ReplaceFile(options.surfelsPath, [&](const std::string &path) {
+            surfelData->serialize(path);
+        });
+
+        printf("%zu surfels written to %s\n", surfelData->surfels().size(), options.surfelsPath.c_str());
+        return EXIT_SUCCESS;
+    }
+
+    static int BakeProbes(const ProbeBakeOptions &options) {
+        OffscreenGLContext context;
+        BenchmarkSceneLibrary scenes(options.sceneSettings);
+        auto &entry = scenes.entry(options.sceneName);
+
+        SurfelData surfelData;
+        if (!surfelData.deserialize(options.surfelsPath)) {
+            fprintf(stderr, "Unable to read surfels: %s\n", options.surfelsPath.c_str());
+            return EXIT_FAILURE;
+        }
+
+        DiffuseLightProbeGenerator probeGenerator;
+        probeGenerator.setLayout(options.layout);
+        probeGenerator.setProjectionEncoding(options.encoding);
+
+        if (options.isSharded) {
+            auto shard = probeGenerator.generateProbeShard(*entry.scene, surfelData, options.shardIndex, options.shardCount);
+            BakeCheckpoint::ReplaceFile(options.outputPath, [&](const std::string &path) {
+                shard->serialize(path);
+            });
+            printf("Shard %u/%u of %zu probes written to %s\n", options.shardIndex, options.shardCount, shard->bakeOrder().size(), options.outputPath.c_str());
+        } else {
+            auto probeData = probeGenerator.generateProbes(*entry.scene, surfelData);
+            BakeCheckpoint::ReplaceFile(options.outputPath, [&](const std::string &path) {
+                probeData->serialize(path);
+            });
+            printf("%zu probes written to %s\n", probeData->probes().size(), options.outputPath.c_str());
+        }
+
+        return EXIT_SUCCESS;
+    }
+
+    static int MergeProbes(const ProbeBakeOptions &options) {
+        std::vector<DiffuseLightProbeShard> shards(options.shardPaths.size());
+        for (size_t i = 0; i < shards.size(); i++) {
+            if (!shards[i].deserialize(options.shardPaths[i])) {
+                fprintf(stderr, "Unable to read probe shard: %s\n", options.shardPaths[i].c_str());
+                return EXIT_FAILURE;
+            }
+        }
+
+        auto probeData = DiffuseLightProbeShard::Merge(shards);
+        BakeCheckpoint::ReplaceFile(options.outputPath, [&](const std::string &path) {
+            probeData->serialize(path);
+        });
+        printf("%zu shards merged into %s\n", shards.size(), options.outputPath.c_str());
+
+        if (options.referencePath.empty()) {
+            return EXIT_SUCCESS;
+        }
+
+        std::string merged = FileContents(options.outputPath);
+        std::string reference = FileContents(options.referencePath);
+
+        if (merged != reference) {
+            auto mismatch = std::mismatch(merged.begin(), merged.end(), reference.begin(), reference.end());
+            fprintf(stderr, "Merged probes differ from %s at byte %zu (sizes %zu and %zu)\n",
+                    options.referencePath.c_str(), size_t(mismatch.first - merged.begin()), merged.size(), reference.size());
+            return EXIT_FAILURE;
+        }
+
+        printf("Merged probes are identical to %s\n", options.referencePath.c_str());
+        return EXIT_SUCCESS;
+    }
+
+#pragma mark - Public interface
+
+    bool ProbeBakeTool::IsCommand(const char *argument) {
+        return 0 == strcmp(argument, "bake-surfels") || 0 == strcmp(argument, "bake-probes") || 0 == strcmp(argument, "merge-probes");
+    }
+
+    int ProbeBakeTool::Run(int argc, const char *argv[]) {
+        ProbeBakeOptions options;
+        if (!ParseOptions(argc, argv, options)) {
+            PrintUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+
+        // Baking stages record many zones
+        Profiler::shared().setThreadBufferCapacity(1 << 20);
+
+        try {
+            if (options.command == "bake-surfels") {
+                return BakeSurfels(options);
+            } else if (options.command == "bake-probes") {
+                return BakeProbes(options);
+            } else {
+                return MergeProbes(options);
+            }
+        } catch (const std::exception &exception) {
+            fprintf(stderr, "%s\n", exception.what());
+            return EXIT_FAILURE;
+        }
+    }
+
+}
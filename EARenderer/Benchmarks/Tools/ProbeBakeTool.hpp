@@ -0,0 +1,39 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_PROBEBAKETOOL_HPP
+#define EARENDERER_PROBEBAKETOOL_HPP
+
+namespace EARenderer {
+
+    /**
+     Commands baking diffuse light probes of benchmark scenes in several processes sharing nothing but a file system.
+     Surfels are generated once, every process bakes a shard of the probes from them and the shards are merged:
+
+       EARendererBenchmarks bake-surfels --scene CornellRoom --surfels surfels.bin
+       EARendererBenchmarks bake-probes --scene CornellRoom --surfels surfels.bin --shard 0/4 --output shard0.bin
+       ...
+       EARendererBenchmarks merge-probes --output probes.bin shard0.bin shard1.bin shard2.bin shard3.bin
+
+     Running bake-probes without --shard bakes the whole volume in a single process. Passing its output to merge-probes
+     as --reference checks that the merged probes are byte-identical to it.
+     */
+    class ProbeBakeTool {
+    public:
+        /**
+         @param argument first command line argument
+         @return true if the argument names one of the tool's commands
+         */
+        static bool IsCommand(const char *argument);
+
+        /**
+         @return process exit code
+         */
+        static int Run(int argc, const char *argv[]);
+    };
+
+}
+
+#endif //EARENDERER_PROBEBAKETOOL_HPP
@@ -0,0 +1,143 @@
+//
+// Created by Pavlo Muratov on 2019-02-13.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "OffscreenGLContext.hpp"
+#include "BenchmarkRunner.hpp"
+#include "BenchmarkSceneLibrary.hpp"
+#include "DataStructureBenchmarks.hpp"
+#include "RayTracingBenchmarks.hpp"
+#include "BakingBenchmarks.hpp"
+#include "IOBenchmarks.hpp"
+#include "VertexQuantizationBenchmarks.hpp"
+#include "MeshProcessingBenchmarks.hpp"
+#include "PackingBenchmarks.hpp"
+#include "SamplingBenchmarks.hpp"
+#include "TextureStreamingBenchmarks.hpp"
+#include "RenderSubmissionBenchmarks.hpp"
+#include "ProbeBakeTool.hpp"
+#include "Profiler.hpp"
+#include "StringUtils.hpp"
+
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+using namespace EARenderer;
+
+static void PrintUsage(const char *executable) {
+    printf("Usage: %s [options]\n"
+           "  --output <path>          JSON file receiving results (default: benchmarks.json)\n"
+           "  --filter <substring>     run only benchmarks whose names contain the substring\n"
+           "  --min-time <seconds>     minimum measured time per benchmark\n"
+           "  --min-iterations <n>     minimum measured iterations per benchmark\n"
+           "  --seed <n>               seed of procedural scenes and random inputs\n"
+           "  --mesh-triangles <n>     triangles per mesh of the scattered meshes scene\n"
+           "  --instances <n>          instances in the scattered meshes scene\n"
+           "  --list                   print benchmark names and exit\n"
+           "       %s bake-surfels | bake-probes | merge-probes ...\n"
+           "                           bake diffuse light probes in several processes, run without options for details\n", executable, executable);
+}
+
+int main(int argc, const char *argv[]) {
+    if (argc > 1 && ProbeBakeTool::IsCommand(argv[1])) {
+        return ProbeBakeTool::Run(argc, argv);
+    }
+
+    BenchmarkRunner::Settings runnerSettings;
+    BenchmarkSceneLibrary::Settings sceneSettings;
+    std::string outputPath = "benchmarks.json";
+    bool listOnly = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char *argument = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (0 == strcmp(argument, "--list")) {
+            listOnly = true;
+        } else if (0 == strcmp(argument, "--output") && hasValue) {
+            outputPath = argv[++i];
+        } else if (0 == strcmp(argument, "--filter") && hasValue) {
+            runnerSettings.filter = argv[++i];
+        } else if (0 == strcmp(argument, "--min-time") && hasValue) {
+            runnerSettings.state.minimumDuration = atof(argv[++i]);
+        } else if (0 == strcmp(argument, "--min-iterations") && hasValue) {
+            runnerSettings.state.minimumIterationCount = strtoul(argv[++i], nullptr, 10);
+        } else if (0 == strcmp(argument, "--seed") && hasValue) {
+            sceneSettings.seed = uint32_t(strtoul(argv[++i], nullptr, 10));
+        } else if (0 == strcmp(argument, "--mesh-triangles") && hasValue) {
+            sceneSettings.scatteredMeshes.trianglesPerMesh = uint32_t(strtoul(argv[++i], nullptr, 10));
+        } else if (0 == strcmp(argument, "--instances") && hasValue) {
+            sceneSettings.scatteredMeshes.instanceCount = uint32_t(strtoul(argv[++i], nullptr, 10));
+        } else {
+            PrintUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Textures and buffers created by baked data need a current context
+    OffscreenGLContext context;
+
+    // Baking stages record many zones per iteration
+    Profiler::shared().setThreadBufferCapacity(1 << 20);
+
+    BenchmarkSceneLibrary scenes(sceneSettings);
+    BenchmarkRunner runner(runnerSettings);
+
+    DataStructureBenchmarks::Register(runner, scenes);
+    RayTracingBenchmarks::Register(runner, scenes);
+    BakingBenchmarks::Register(runner, scenes);
+    IOBenchmarks::Register(runner, scenes);
+    VertexQuantizationBenchmarks::Register(runner, scenes);
+    MeshProcessingBenchmarks::Register(runner, scenes);
+    PackingBenchmarks::Register(runner, scenes);
+    SamplingBenchmarks::Register(runner, scenes);
+    TextureStreamingBenchmarks::Register(runner, scenes);
+    RenderSubmissionBenchmarks::Register(runner, scenes);
+
+    if (listOnly) {
+        for (auto &name : runner.benchmarkNames()) {
+            printf("%s\n", name.c_str());
+        }
+        return EXIT_SUCCESS;
+    }
+
+    auto results = runner.run();
+
+#ifdef NDEBUG
+    std::string configuration = "Release";
+#else
+    std::string configuration = "Debug";
+#endif
+
+    std::map<std::string, std::string> runContext = {
+            {"seed", std::to_string(sceneSettings.seed)},
+            {"configuration", configuration},
+            {"profiling", std::to_string(EARENDERER_PROFILING)},
+            {"min_time", string_format("%g", runnerSettings.state.minimumDuration)},
+            {"min_iterations", std::to_string(runnerSettings.state.minimumIterationCount)},
+            {"mesh_triangles", std::to_string(sceneSettings.scatteredMeshes.trianglesPerMesh)},
+            {"instances", std::to_string(sceneSettings.scatteredMeshes.instanceCount)},
+            {"filter", runnerSettings.filter}
+    };
+
+    std::ofstream stream(outputPath, std::ios::trunc);
+    if (!stream.is_open()) {
+        fprintf(stderr, "Unable to write results: %s\n", outputPath.c_str());
+        return EXIT_FAILURE;
+    }
+    stream << BenchmarkRunner::JSON(results, runContext);
+
+    printf("Results written to %s\n", outputPath.c_str());
+
+    for (auto &result : results) {
+        if (!result.error.empty()) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,191 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "AtlasPacker.hpp"
+#include "SkylinePacker.hpp"
+#include "IndexedMaxRectsPacker.hpp"
+#include "ThreadPool.hpp"
+#include "StringUtils.hpp"
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <tuple>
+
+namespace EARenderer {
+
+    namespace {
+
+        /**
+         Largest first by the longer side, then by area, ties broken by index to stay independent of the sort implementation
+         */
+        bool IsPackedEarlier(const std::vector<rbp::RectSize> &sizes, uint32_t lhs, uint32_t rhs) {
+            auto key = [&](uint32_t index) {
+                int64_t area = int64_t(sizes[index].width) * sizes[index].height;
+                return std::make_tuple(-std::max(sizes[index].width, sizes[index].height), -area, index);
+            };
+            return key(lhs) < key(rhs);
+        }
+
+        template<typename Packer>
+        void PackInRounds(const AtlasPacker::Settings &settings, ThreadPool &threadPool,
+                          const std::vector<rbp::RectSize> &sizes, std::vector<uint32_t> pending,
+                          AtlasPacker::Result &result) {
+            uint64_t binArea = uint64_t(settings.binWidth) * settings.binHeight;
+
+            while (!pending.empty()) {
+                uint64_t pendingArea = 0;
+                for (uint32_t index : pending) {
+                    pendingArea += uint64_t(sizes[index].width) * sizes[index].height;
+                }
+
+                size_t binCount = size_t(std::ceil(double(pendingArea) / (double(binArea) * settings.expectedOccupancy)));
+                binCount = std::min(std::max(binCount, size_t(1)), pending.size());
+
+                std::vector<Packer> bins(binCount, Packer(settings.binWidth, settings.binHeight));
+                std::vector<std::vector<uint32_t>> rejected(binCount);
+                auto firstBin = uint32_t(result.report.binOccupancies.size());
+
+                // Dealing sorted rectangles gives every bin a similar mix of large and small ones
+                threadPool.parallelFor(binCount, 1, [&](size_t begin, size_t end) {
+                    for (size_t bin = begin; bin < end; bin++) {
+                        for (size_t i = bin; i < pending.size(); i += binCount) {
+                            uint32_t index = pending[i];
+                            rbp::Rect rect = bins[bin].insert(sizes[index].width, sizes[index].height);
+                            if (rect.height == 0) {
+                                rejected[bin].push_back(index);
+                            } else {
+                                result.placements[index] = {firstBin + uint32_t(bin), rect};
+                            }
+                        }
+                    }
+                });
+
+                std::vector<uint32_t> leftovers;
+                for (auto &indices : rejected) {
+                    leftovers.insert(leftovers.end(), indices.begin(), indices.end());
+                }
+                std::sort(leftovers.begin(), leftovers.end(), [&](uint32_t lhs, uint32_t rhs) {
+                    return IsPackedEarlier(sizes, lhs, rhs);
+                });
+
+                std::vector<uint32_t> carriedOver;
+                for (uint32_t index : leftovers) {
+                    bool isPlaced = false;
+                    for (size_t bin = 0; bin < binCount && !isPlaced; bin++) {
+                        rbp::Rect rect = bins[bin].insert(sizes[index].width, sizes[index].height);
+                        if (rect.height != 0) {
+                            result.placements[index] = {firstBin + uint32_t(bin), rect};
+                            isPlaced = true;
+                        }
+                    }
+                    if (!isPlaced) {
+                        carriedOver.push_back(index);
+                    }
+                }
+
+                for (auto &bin : bins) {
+                    result.report.binOccupancies.push_back(bin.occupancy());
+                }
+
+                pending = std::move(carriedOver);
+            }
+        }
+
+    }
+
+#pragma mark - Placement
+
+    bool AtlasPacker::Placement::isPacked() const {
+        return binIndex != NoBin;
+    }
+
+#pragma mark - Occupancy report
+
+    size_t AtlasPacker::OccupancyReport::binCount() const {
+        return binOccupancies.size();
+    }
+
+    float AtlasPacker::OccupancyReport::occupancy() const {
+        if (binOccupancies.empty()) {
+            return 0.0;
+        }
+        float sum = 0.0;
+        for (float binOccupancy : binOccupancies) {
+            sum += binOccupancy;
+        }
+        return sum / binOccupancies.size();
+    }
+
+    float AtlasPacker::OccupancyReport::minimumBinOccupancy() const {
+        if (binOccupancies.empty()) {
+            return 0.0;
+        }
+        return *std::min_element(binOccupancies.begin(), binOccupancies.end());
+    }
+
+#pragma mark - Lifecycle
+
+    AtlasPacker::AtlasPacker()
+            :
+            AtlasPacker(Settings()) {
+    }
+
+    AtlasPacker::AtlasPacker(const Settings &settings)
+            :
+            AtlasPacker(settings, &ThreadPool::Default()) {
+    }
+
+    AtlasPacker::AtlasPacker(const Settings &settings, ThreadPool *threadPool)
+            :
+            mSettings(settings),
+            mThreadPool(threadPool) {
+        if (mSettings.binWidth <= 0 || mSettings.binHeight <= 0) {
+            throw std::invalid_argument(string_format("Invalid atlas bin size: %dx%d", mSettings.binWidth, mSettings.binHeight));
+        }
+        mSettings.expectedOccupancy = std::min(std::max(mSettings.expectedOccupancy, 0.05f), 1.0f);
+    }
+
+#pragma mark - Packing
+
+    AtlasPacker::Result AtlasPacker::pack(const std::vector<rbp::RectSize> &sizes) const {
+        EA_PROFILE_SCOPE("Pack atlas");
+
+        Result result;
+        result.placements.resize(sizes.size());
+
+        std::vector<uint32_t> pending;
+        for (uint32_t i = 0; i < sizes.size(); i++) {
+            auto &size = sizes[i];
+            if (size.width > 0 && size.height > 0 && size.width <= mSettings.binWidth && size.height <= mSettings.binHeight) {
+                pending.push_back(i);
+            } else {
+                result.report.unpackedCount++;
+            }
+        }
+
+        std::sort(pending.begin(), pending.end(), [&](uint32_t lhs, uint32_t rhs) {
+            return IsPackedEarlier(sizes, lhs, rhs);
+        });
+
+        for (uint32_t index : pending) {
+            result.report.packedArea += uint64_t(sizes[index].width) * sizes[index].height;
+        }
+        result.report.packedCount = pending.size();
+
+        switch (mSettings.algorithm) {
+            case Algorithm::Skyline:
+                PackInRounds<SkylinePacker>(mSettings, *mThreadPool, sizes, std::move(pending), result);
+                break;
+            case Algorithm::MaxRects:
+                PackInRounds<IndexedMaxRectsPacker>(mSettings, *mThreadPool, sizes, std::move(pending), result);
+                break;
+        }
+
+        return result;
+    }
+
+}
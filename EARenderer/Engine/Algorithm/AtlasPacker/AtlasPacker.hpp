@@ -0,0 +1,94 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_ATLASPACKER_HPP
+#define EARENDERER_ATLASPACKER_HPP
+
+#include "Rect.h"
+
+#include <vector>
+#include <cstdint>
+
+namespace EARenderer {
+
+    class ThreadPool;
+
+    /**
+     Packs a batch of rectangles into as many bins as needed.
+
+     Rectangles are sorted by their longer side, then by area, largest first. Packing proceeds in rounds:
+     the pending area determines how many new bins are opened, rectangles are dealt to them in sorted order
+     and the bins are filled concurrently. Rectangles a bin had no room for are offered to the other bins
+     of the round, and whatever still doesn't fit is carried over to the next round.
+     Dealing only depends on the input, so the result is identical regardless of the amount of threads.
+     Rectangles are never flipped.
+     */
+    class AtlasPacker {
+    public:
+        enum class Algorithm {
+            // Fastest, leaves the space under the skyline unused
+            Skyline,
+            // Densest, best short side fit on indexed free rectangles
+            MaxRects
+        };
+
+        struct Settings {
+            int binWidth = 1024;
+            int binHeight = 1024;
+            Algorithm algorithm = Algorithm::MaxRects;
+            // Fraction of a bin's area expected to be filled, used to estimate the amount of bins for a round
+            float expectedOccupancy = 0.85;
+        };
+
+        struct Placement {
+            static constexpr uint32_t NoBin = UINT32_MAX;
+
+            uint32_t binIndex = NoBin;
+            // Zero sized if the rectangle is larger than a bin
+            rbp::Rect rect{0, 0, 0, 0};
+
+            bool isPacked() const;
+        };
+
+        struct OccupancyReport {
+            size_t packedCount = 0;
+            // Rectangles larger than a bin or of zero area
+            size_t unpackedCount = 0;
+            uint64_t packedArea = 0;
+            std::vector<float> binOccupancies;
+
+            size_t binCount() const;
+
+            /**
+             @return packed area relative to the area of all bins
+             */
+            float occupancy() const;
+
+            float minimumBinOccupancy() const;
+        };
+
+        struct Result {
+            // Placements in the order of input sizes
+            std::vector<Placement> placements;
+            OccupancyReport report;
+        };
+
+    private:
+        Settings mSettings;
+        ThreadPool *mThreadPool;
+
+    public:
+        AtlasPacker();
+
+        AtlasPacker(const Settings &settings);
+
+        AtlasPacker(const Settings &settings, ThreadPool *threadPool);
+
+        Result pack(const std::vector<rbp::RectSize> &sizes) const;
+    };
+
+}
+
+#endif //EARENDERER_ATLASPACKER_HPP
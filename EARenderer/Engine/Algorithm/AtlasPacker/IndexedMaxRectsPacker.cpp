@@ -0,0 +1,279 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "IndexedMaxRectsPacker.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <tuple>
+
+namespace EARenderer {
+
+    namespace {
+
+        // Grid cells along the longer side of the bin
+        constexpr int GridResolution = 64;
+        constexpr int MinimumCellSize = 8;
+
+        int FloorLog2(int value) {
+            int log = 0;
+            while (value >>= 1) {
+                log++;
+            }
+            return log;
+        }
+
+        bool Overlap(const rbp::Rect &a, const rbp::Rect &b) {
+            return a.x < b.x + b.width && a.x + a.width > b.x &&
+                   a.y < b.y + b.height && a.y + a.height > b.y;
+        }
+
+        /**
+         Appends maximal rectangles of the free rectangle's area left uncovered by the used one
+         */
+        void Split(const rbp::Rect &free, const rbp::Rect &used, std::vector<rbp::Rect> &output) {
+            if (used.x > free.x) {
+                output.push_back({free.x, free.y, used.x - free.x, free.height});
+            }
+            if (used.x + used.width < free.x + free.width) {
+                output.push_back({used.x + used.width, free.y, free.x + free.width - used.x - used.width, free.height});
+            }
+            if (used.y > free.y) {
+                output.push_back({free.x, free.y, free.width, used.y - free.y});
+            }
+            if (used.y + used.height < free.y + free.height) {
+                output.push_back({free.x, used.y + used.height, free.width, free.y + free.height - used.y - used.height});
+            }
+        }
+
+    }
+
+#pragma mark - Lifecycle
+
+    IndexedMaxRectsPacker::IndexedMaxRectsPacker(int width, int height)
+            :
+            mWidth(width),
+            mHeight(height),
+            mBucketsPerSide(FloorLog2(std::max({width, height, 1})) + 1),
+            mBuckets(size_t(mBucketsPerSide) * mBucketsPerSide),
+            mCellSize(std::max(MinimumCellSize, (std::max(width, height) + GridResolution - 1) / GridResolution)),
+            mCellsX(std::max(1, (width + mCellSize - 1) / mCellSize)),
+            mCellsY(std::max(1, (height + mCellSize - 1) / mCellSize)),
+            mCells(size_t(mCellsX) * mCellsY) {
+
+        if (width > 0 && height > 0) {
+            addFreeRect({0, 0, width, height});
+        }
+    }
+
+#pragma mark - Free rectangles
+
+    uint32_t IndexedMaxRectsPacker::bucketIndex(const rbp::Rect &rect) const {
+        return uint32_t(FloorLog2(rect.width) * mBucketsPerSide + FloorLog2(rect.height));
+    }
+
+    void IndexedMaxRectsPacker::addFreeRect(const rbp::Rect &rect) {
+        uint32_t slot;
+        if (mReleasedSlots.empty()) {
+            slot = uint32_t(mFreeRects.size());
+            mFreeRects.emplace_back();
+            mVisitStamps.push_back(0);
+        } else {
+            slot = mReleasedSlots.back();
+            mReleasedSlots.pop_back();
+        }
+
+        auto &freeRect = mFreeRects[slot];
+        freeRect.rect = rect;
+        freeRect.isAlive = true;
+        freeRect.bucket = bucketIndex(rect);
+
+        auto &bucket = mBuckets[freeRect.bucket];
+        freeRect.bucketPosition = uint32_t(bucket.size());
+        bucket.push_back(slot);
+
+        int cellX0 = rect.x / mCellSize;
+        int cellY0 = rect.y / mCellSize;
+        int cellX1 = std::min((rect.x + rect.width - 1) / mCellSize, mCellsX - 1);
+        int cellY1 = std::min((rect.y + rect.height - 1) / mCellSize, mCellsY - 1);
+
+        for (int y = cellY0; y <= cellY1; y++) {
+            for (int x = cellX0; x <= cellX1; x++) {
+                mCells[size_t(y) * mCellsX + x].push_back({slot, freeRect.generation});
+            }
+        }
+    }
+
+    void IndexedMaxRectsPacker::removeFreeRect(uint32_t slot) {
+        auto &freeRect = mFreeRects[slot];
+
+        // Swap with the last element of the bucket, grid entries are dropped lazily
+        auto &bucket = mBuckets[freeRect.bucket];
+        uint32_t movedSlot = bucket.back();
+        bucket[freeRect.bucketPosition] = movedSlot;
+        mFreeRects[movedSlot].bucketPosition = freeRect.bucketPosition;
+        bucket.pop_back();
+
+        freeRect.isAlive = false;
+        freeRect.generation++;
+        mReleasedSlots.push_back(slot);
+    }
+
+    template<typename Func>
+    void IndexedMaxRectsPacker::forEachFreeRectAround(const rbp::Rect &area, Func &&func) {
+        if (++mVisitStamp == 0) {
+            std::fill(mVisitStamps.begin(), mVisitStamps.end(), 0);
+            mVisitStamp = 1;
+        }
+
+        int cellX0 = std::max(area.x / mCellSize, 0);
+        int cellY0 = std::max(area.y / mCellSize, 0);
+        int cellX1 = std::min((area.x + area.width - 1) / mCellSize, mCellsX - 1);
+        int cellY1 = std::min((area.y + area.height - 1) / mCellSize, mCellsY - 1);
+
+        for (int y = cellY0; y <= cellY1; y++) {
+            for (int x = cellX0; x <= cellX1; x++) {
+                auto &cell = mCells[size_t(y) * mCellsX + x];
+                size_t liveCount = 0;
+
+                for (auto &entry : cell) {
+                    auto &freeRect = mFreeRects[entry.slot];
+                    if (!freeRect.isAlive || freeRect.generation != entry.generation) {
+                        continue;
+                    }
+
+                    cell[liveCount++] = entry;
+
+                    if (mVisitStamps[entry.slot] != mVisitStamp) {
+                        mVisitStamps[entry.slot] = mVisitStamp;
+                        func(entry.slot);
+                    }
+                }
+
+                cell.resize(liveCount);
+            }
+        }
+    }
+
+#pragma mark - Placement
+
+    uint32_t IndexedMaxRectsPacker::findBestFit(int width, int height) const {
+        // Short side leftover, long side leftover, then position, which makes the choice independent of slot order
+        using Score = std::tuple<int, int, int, int>;
+        int maximum = std::numeric_limits<int>::max();
+        Score bestScore(maximum, maximum, maximum, maximum);
+        uint32_t bestSlot = NoSlot;
+
+        for (int widthLog = FloorLog2(width); widthLog < mBucketsPerSide; widthLog++) {
+            for (int heightLog = FloorLog2(height); heightLog < mBucketsPerSide; heightLog++) {
+                auto &bucket = mBuckets[size_t(widthLog) * mBucketsPerSide + heightLog];
+                if (bucket.empty()) {
+                    continue;
+                }
+
+                // Every rectangle of the bucket is at least 2^log long, which bounds the leftover from below
+                int lowerBound = std::min(std::max(0, (1 << widthLog) - width), std::max(0, (1 << heightLog) - height));
+                if (lowerBound > std::get<0>(bestScore)) {
+                    continue;
+                }
+
+                for (uint32_t slot : bucket) {
+                    auto &rect = mFreeRects[slot].rect;
+                    if (rect.width < width || rect.height < height) {
+                        continue;
+                    }
+
+                    int leftoverX = rect.width - width;
+                    int leftoverY = rect.height - height;
+                    Score score(std::min(leftoverX, leftoverY), std::max(leftoverX, leftoverY), rect.y, rect.x);
+
+                    if (score < bestScore) {
+                        bestScore = score;
+                        bestSlot = slot;
+                    }
+                }
+            }
+        }
+
+        return bestSlot;
+    }
+
+    void IndexedMaxRectsPacker::place(const rbp::Rect &used) {
+        mScratchSlots.clear();
+        forEachFreeRectAround(used, [&](uint32_t slot) {
+            if (Overlap(mFreeRects[slot].rect, used)) {
+                mScratchSlots.push_back(slot);
+            }
+        });
+
+        mScratchRects.clear();
+        for (uint32_t slot : mScratchSlots) {
+            Split(mFreeRects[slot].rect, used, mScratchRects);
+            removeFreeRect(slot);
+        }
+
+        // Free rectangles not touched by the placement were maximal before and stay maximal,
+        // so only the new ones can be redundant, either among themselves or inside an old one
+        for (size_t i = 0; i < mScratchRects.size(); i++) {
+            auto &candidate = mScratchRects[i];
+            bool isRedundant = false;
+
+            for (size_t j = 0; j < mScratchRects.size() && !isRedundant; j++) {
+                if (i == j || !rbp::IsContainedIn(candidate, mScratchRects[j])) {
+                    continue;
+                }
+                // Of equal rectangles the first one survives
+                bool isEqual = rbp::IsContainedIn(mScratchRects[j], candidate);
+                isRedundant = !isEqual || j < i;
+            }
+
+            // A free rectangle containing the candidate has to contain its corner
+            if (!isRedundant) {
+                forEachFreeRectAround({candidate.x, candidate.y, 1, 1}, [&](uint32_t slot) {
+                    isRedundant = isRedundant || rbp::IsContainedIn(candidate, mFreeRects[slot].rect);
+                });
+            }
+
+            if (isRedundant) {
+                // Mark instead of erasing, later candidates are still compared against it
+                candidate.width = -candidate.width;
+            }
+        }
+
+        for (auto &rect : mScratchRects) {
+            if (rect.width > 0) {
+                addFreeRect(rect);
+            }
+        }
+    }
+
+#pragma mark - Packing
+
+    rbp::Rect IndexedMaxRectsPacker::insert(int width, int height) {
+        if (width <= 0 || height <= 0 || width > mWidth || height > mHeight) {
+            return rbp::Rect{0, 0, 0, 0};
+        }
+
+        uint32_t slot = findBestFit(width, height);
+        if (slot == NoSlot) {
+            return rbp::Rect{0, 0, 0, 0};
+        }
+
+        rbp::Rect used{mFreeRects[slot].rect.x, mFreeRects[slot].rect.y, width, height};
+        place(used);
+        mUsedArea += uint64_t(width) * uint64_t(height);
+
+        return used;
+    }
+
+    float IndexedMaxRectsPacker::occupancy() const {
+        return float(double(mUsedArea) / (double(mWidth) * double(mHeight)));
+    }
+
+    size_t IndexedMaxRectsPacker::freeRectCount() const {
+        return mFreeRects.size() - mReleasedSlots.size();
+    }
+
+}
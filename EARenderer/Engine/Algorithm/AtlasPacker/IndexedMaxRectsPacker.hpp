@@ -0,0 +1,104 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_INDEXEDMAXRECTSPACKER_HPP
+#define EARENDERER_INDEXEDMAXRECTSPACKER_HPP
+
+#include "Rect.h"
+
+#include <vector>
+#include <cstdint>
+
+namespace EARenderer {
+
+    /**
+     MaxRects packer placing rectangles by the best short side fit rule like rbp::MaxRectsBinPack
+     with RectBestShortSideFit and no flipping, but with indexed free rectangles.
+     Ties are broken by position, so placements may differ from rbp's while occupancy stays on par.
+
+     Free rectangles are bucketed by the binary logarithms of their sides, so that the search
+     for a fitting one skips buckets that can't beat the best candidate found so far.
+     They are also registered in a uniform grid, so that splitting and pruning only visit
+     free rectangles around the placed one instead of the whole list.
+     */
+    class IndexedMaxRectsPacker {
+    private:
+        static constexpr uint32_t NoSlot = UINT32_MAX;
+
+        struct FreeRect {
+            rbp::Rect rect;
+            // Bumped whenever the slot is released, which invalidates grid entries pointing to it
+            uint32_t generation = 0;
+            uint32_t bucket = NoSlot;
+            uint32_t bucketPosition = 0;
+            bool isAlive = false;
+        };
+
+        struct GridEntry {
+            uint32_t slot;
+            uint32_t generation;
+        };
+
+        int mWidth;
+        int mHeight;
+        uint64_t mUsedArea = 0;
+
+        std::vector<FreeRect> mFreeRects;
+        std::vector<uint32_t> mReleasedSlots;
+
+        int mBucketsPerSide;
+        std::vector<std::vector<uint32_t>> mBuckets;
+
+        int mCellSize;
+        int mCellsX;
+        int mCellsY;
+        std::vector<std::vector<GridEntry>> mCells;
+
+        // Visit marks deduplicating free rectangles registered in several cells
+        std::vector<uint32_t> mVisitStamps;
+        uint32_t mVisitStamp = 0;
+
+        std::vector<uint32_t> mScratchSlots;
+        std::vector<rbp::Rect> mScratchRects;
+
+        uint32_t bucketIndex(const rbp::Rect &rect) const;
+
+        void addFreeRect(const rbp::Rect &rect);
+
+        void removeFreeRect(uint32_t slot);
+
+        /**
+         Calls func(slot) once for every live free rectangle registered in cells overlapping the area,
+         dropping stale grid entries along the way
+         */
+        template<typename Func>
+        void forEachFreeRectAround(const rbp::Rect &area, Func &&func);
+
+        /**
+         @return slot of the free rectangle fitting the size best, NoSlot if none does
+         */
+        uint32_t findBestFit(int width, int height) const;
+
+        void place(const rbp::Rect &rect);
+
+    public:
+        IndexedMaxRectsPacker(int width, int height);
+
+        /**
+         @return placed rectangle, or a rectangle of zero height if there's no room for it
+         */
+        rbp::Rect insert(int width, int height);
+
+        /**
+         @return ratio of the packed area to the area of the bin
+         */
+        float occupancy() const;
+
+        size_t freeRectCount() const;
+    };
+
+}
+
+#endif //EARENDERER_INDEXEDMAXRECTSPACKER_HPP
@@ -0,0 +1,107 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "SkylinePacker.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace EARenderer {
+
+#pragma mark - Lifecycle
+
+    SkylinePacker::SkylinePacker(int width, int height)
+            :
+            mWidth(width),
+            mHeight(height),
+            mSkyline({{0, 0, width}}) {
+    }
+
+#pragma mark - Private helpers
+
+    int SkylinePacker::fit(size_t segmentIndex, int width, int height) const {
+        int x = mSkyline[segmentIndex].x;
+        if (x + width > mWidth) {
+            return -1;
+        }
+
+        // The rectangle rests on the highest segment below it
+        int y = 0;
+        int widthLeft = width;
+        for (size_t i = segmentIndex; widthLeft > 0; i++) {
+            y = std::max(y, mSkyline[i].y);
+            if (y + height > mHeight) {
+                return -1;
+            }
+            widthLeft -= mSkyline[i].width;
+        }
+
+        return y;
+    }
+
+    void SkylinePacker::addSegment(size_t segmentIndex, const rbp::Rect &rect) {
+        mSkyline.insert(mSkyline.begin() + segmentIndex, {rect.x, rect.y + rect.height, rect.width});
+
+        // Cut segments now hidden under the new one
+        size_t next = segmentIndex + 1;
+        int right = rect.x + rect.width;
+        while (next < mSkyline.size() && mSkyline[next].x < right) {
+            int shrink = right - mSkyline[next].x;
+            if (shrink >= mSkyline[next].width) {
+                mSkyline.erase(mSkyline.begin() + next);
+            } else {
+                mSkyline[next].x += shrink;
+                mSkyline[next].width -= shrink;
+                break;
+            }
+        }
+
+        // Merge neighbours of equal height
+        for (size_t i = segmentIndex > 0 ? segmentIndex - 1 : 0; i + 1 < mSkyline.size() && i <= segmentIndex + 1;) {
+            if (mSkyline[i].y == mSkyline[i + 1].y) {
+                mSkyline[i].width += mSkyline[i + 1].width;
+                mSkyline.erase(mSkyline.begin() + i + 1);
+            } else {
+                i++;
+            }
+        }
+    }
+
+#pragma mark - Packing
+
+    rbp::Rect SkylinePacker::insert(int width, int height) {
+        rbp::Rect result{0, 0, 0, 0};
+        if (width <= 0 || height <= 0) {
+            return result;
+        }
+
+        int bestTop = std::numeric_limits<int>::max();
+        size_t bestSegment = mSkyline.size();
+
+        for (size_t i = 0; i < mSkyline.size(); i++) {
+            int y = fit(i, width, height);
+            // Lowest top edge first, leftmost position among equal ones
+            if (y >= 0 && y + height < bestTop) {
+                bestTop = y + height;
+                bestSegment = i;
+                result = {mSkyline[i].x, y, width, height};
+            }
+        }
+
+        if (bestSegment == mSkyline.size()) {
+            return rbp::Rect{0, 0, 0, 0};
+        }
+
+        addSegment(bestSegment, result);
+        mUsedArea += uint64_t(width) * uint64_t(height);
+
+        return result;
+    }
+
+    float SkylinePacker::occupancy() const {
+        return float(double(mUsedArea) / (double(mWidth) * double(mHeight)));
+    }
+
+}
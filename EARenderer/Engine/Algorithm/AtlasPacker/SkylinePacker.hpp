@@ -0,0 +1,58 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_SKYLINEPACKER_HPP
+#define EARENDERER_SKYLINEPACKER_HPP
+
+#include "Rect.h"
+
+#include <vector>
+#include <cstdint>
+
+namespace EARenderer {
+
+    /**
+     Packs rectangles into a bin by keeping the top edge of the packed area as a list of horizontal segments
+     and placing every rectangle where its top ends up lowest (bottom-left rule).
+     Space below the skyline is never reused, which trades some occupancy for insertions costing
+     a pass over the skyline instead of a pass over all free rectangles.
+     */
+    class SkylinePacker {
+    private:
+        struct Segment {
+            int x;
+            int y;
+            int width;
+        };
+
+        int mWidth;
+        int mHeight;
+        uint64_t mUsedArea = 0;
+        std::vector<Segment> mSkyline;
+
+        /**
+         @return lowest y a rectangle starting at the segment's left edge could be placed at, -1 if it doesn't fit
+         */
+        int fit(size_t segmentIndex, int width, int height) const;
+
+        void addSegment(size_t segmentIndex, const rbp::Rect &rect);
+
+    public:
+        SkylinePacker(int width, int height);
+
+        /**
+         @return placed rectangle, or a rectangle of zero height if there's no room for it
+         */
+        rbp::Rect insert(int width, int height);
+
+        /**
+         @return ratio of the packed area to the area of the bin
+         */
+        float occupancy() const;
+    };
+
+}
+
+#endif //EARENDERER_SKYLINEPACKER_HPP
@@ -7,15 +7,39 @@
 //
 
 #include "EmbreeRayTracer.hpp"
+#include "MemoryTracker.hpp"
 
 #include <stdio.h>
+#include <limits>
 
 namespace EARenderer {
 
+    namespace {
+
+        // Embree hands the context to filter functions, so the filter travels with each query
+        // instead of being stored in the tracer, which would make concurrent queries race
+        struct FilteredIntersectContext {
+            RTCIntersectContext context;
+            EmbreeRayTracer::FaceFilter faceFilter;
+        };
+
+        FilteredIntersectContext MakeContext(EmbreeRayTracer::FaceFilter faceFilter) {
+            FilteredIntersectContext context;
+            rtcInitIntersectContext(&context.context);
+            context.faceFilter = faceFilter;
+            return context;
+        }
+
+    }
+
 #pragma mark - Lifecycle
 
     EmbreeRayTracer::EmbreeRayTracer(const std::vector<Triangle3D> &triangles)
-            : mDevice(rtcNewDevice(nullptr)), mScene(rtcNewScene(mDevice)) {
+            : mDevice(rtcNewDevice(nullptr)), mAllocatedBytes(std::make_unique<std::atomic<int64_t>>(0)) {
+
+        // Monitor has to be installed before the scene is created to catch every allocation
+        rtcSetDeviceMemoryMonitorFunction(mDevice, deviceMemoryMonitorCallback, mAllocatedBytes.get());
+        mScene = rtcNewScene(mDevice);
 
         RTCGeometry geometry = rtcNewGeometry(mDevice, RTC_GEOMETRY_TYPE_TRIANGLE);
 
@@ -67,6 +91,11 @@ namespace EARenderer {
     EmbreeRayTracer::~EmbreeRayTracer() {
         rtcReleaseScene(mScene);
         rtcReleaseDevice(mDevice);
+
+        // Moved-from objects don't own a counter
+        if (mAllocatedBytes && *mAllocatedBytes > 0) {
+            MemoryTracker::shared().deallocate(MemoryTag::RayTracing, MemoryDomain::CPU, size_t(mAllocatedBytes->load()));
+        }
     }
 
 #pragma mark - Operators
@@ -81,6 +110,7 @@ namespace EARenderer {
     void EmbreeRayTracer::swap(EmbreeRayTracer &that) {
         std::swap(mDevice, that.mDevice);
         std::swap(mScene, that.mScene);
+        std::swap(mAllocatedBytes, that.mAllocatedBytes);
     }
 
     void swap(EmbreeRayTracer &lhs, EmbreeRayTracer &rhs) {
@@ -94,10 +124,25 @@ namespace EARenderer {
         printf("Embree device error detected: \ncode: %d, message: %s \n", code, str);
     }
 
+    bool EmbreeRayTracer::deviceMemoryMonitorCallback(void *userPtr, ssize_t bytes, bool post) {
+        auto allocatedBytes = reinterpret_cast<std::atomic<int64_t> *>(userPtr);
+        allocatedBytes->fetch_add(int64_t(bytes), std::memory_order_relaxed);
+
+        // Embree reports deallocations with negative sizes
+        if (bytes > 0) {
+            MemoryTracker::shared().allocate(MemoryTag::RayTracing, MemoryDomain::CPU, size_t(bytes));
+        } else if (bytes < 0) {
+            MemoryTracker::shared().deallocate(MemoryTag::RayTracing, MemoryDomain::CPU, size_t(-bytes));
+        }
+
+        // Never deny an allocation
+        return true;
+    }
+
     void EmbreeRayTracer::intersectionFilter(const struct RTCFilterFunctionNArguments *args) {
-        EmbreeRayTracer *thisPtr = reinterpret_cast<EmbreeRayTracer *>(args->geometryUserPtr);
+        auto context = reinterpret_cast<const FilteredIntersectContext *>(args->context);
 
-        if (thisPtr->mFaceFilter == FaceFilter::None) return;
+        if (context->faceFilter == FaceFilter::None) return;
 
         glm::vec3 triangleNormal(RTCHitN_Ng_x(args->hit, args->N, 0),
                 RTCHitN_Ng_y(args->hit, args->N, 0),
@@ -110,7 +155,7 @@ namespace EARenderer {
         float dot = glm::dot(triangleNormal, rayDirection);
         bool vectorsPointingInSameHemisphere = dot > 0.0;
 
-        switch (thisPtr->mFaceFilter) {
+        switch (context->faceFilter) {
             case FaceFilter::CullFront:
                 args->valid[0] = vectorsPointingInSameHemisphere ? -1 : 0;
                 break;
@@ -131,10 +176,7 @@ namespace EARenderer {
             float p1OffsetFactor,
             FaceFilter faceFilter) {
 
-        RTCIntersectContext context;
-        rtcInitIntersectContext(&context);
-
-        mFaceFilter = faceFilter;
+        FilteredIntersectContext context = MakeContext(faceFilter);
 
         p0OffsetFactor = std::clamp(p0OffsetFactor, 0.0f, 1.0f);
         p1OffsetFactor = std::clamp(p1OffsetFactor, 0.0f, 1.0f);
@@ -152,7 +194,7 @@ namespace EARenderer {
         ray.tfar = 1.0 - p1OffsetFactor;
         ray.flags = 0;
 
-        rtcOccluded1(mScene, &context, &ray);
+        rtcOccluded1(mScene, &context.context, &ray);
 
         // When no intersection is found, the ray data is not updated.
         // In case a hit was found, the tfar component of the ray is set to -inf.
@@ -161,10 +203,17 @@ namespace EARenderer {
     }
 
     bool EmbreeRayTracer::rayHit(const Ray3D &ray, float &distance, FaceFilter faceFilter) {
-        RTCIntersectContext context;
-        rtcInitIntersectContext(&context);
+        Hit hit;
+        if (!rayHit(ray, hit, faceFilter)) {
+            distance = std::numeric_limits<float>::max();
+            return false;
+        }
+        distance = hit.distance;
+        return true;
+    }
 
-        mFaceFilter = faceFilter;
+    bool EmbreeRayTracer::rayHit(const Ray3D &ray, Hit &hit, FaceFilter faceFilter) {
+        FilteredIntersectContext context = MakeContext(faceFilter);
 
         RTCRayHit rayHit;
 
@@ -182,11 +231,19 @@ namespace EARenderer {
         rayHit.hit.instID[0] = RTC_INVALID_GEOMETRY_ID;
         rayHit.hit.geomID = RTC_INVALID_GEOMETRY_ID;
 
-        rtcIntersect1(mScene, &context, &rayHit);
+        rtcIntersect1(mScene, &context.context, &rayHit);
+
+        if (rayHit.hit.geomID == RTC_INVALID_GEOMETRY_ID) {
+            return false;
+        }
 
-        distance = rayHit.ray.tfar;
+        hit.distance = rayHit.ray.tfar;
+        hit.triangleIndex = rayHit.hit.primID;
+        hit.barycentrics = glm::vec2(rayHit.hit.u, rayHit.hit.v);
+        // Embree's geometric normal points out of the clockwise side
+        hit.normal = -glm::vec3(rayHit.hit.Ng_x, rayHit.hit.Ng_y, rayHit.hit.Ng_z);
 
-        return rayHit.hit.geomID != RTC_INVALID_GEOMETRY_ID;
+        return true;
     }
 
 }
@@ -13,6 +13,9 @@
 #include "Triangle3D.hpp"
 
 #include <vector>
+#include <memory>
+#include <atomic>
+#include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 #include <rtcore.h>
 
@@ -24,19 +27,35 @@ namespace EARenderer {
             None, CullFront, CullBack
         };
 
+        struct Hit {
+            float distance;
+            // Index of the hit triangle in the vector the tracer was built from
+            uint32_t triangleIndex;
+            // Weights of the second and the third vertex of the triangle
+            glm::vec2 barycentrics;
+            // Unnormalized geometric normal pointing out of the side the vertices are wound counterclockwise on
+            glm::vec3 normal;
+        };
+
     private:
         RTCDevice mDevice = nullptr;
         RTCScene mScene = nullptr;
 
-        FaceFilter mFaceFilter;
+        // Heap allocated so that the address handed to Embree survives moves
+        std::unique_ptr<std::atomic<int64_t>> mAllocatedBytes;
 
         static void deviceErrorCallback(void *userPtr, enum RTCError code, const char *str);
 
+        static bool deviceMemoryMonitorCallback(void *userPtr, ssize_t bytes, bool post);
+
         static void intersectionFilter(const struct RTCFilterFunctionNArguments *args);
 
         static void occlusionFilter(const struct RTCFilterFunctionNArguments *args);
 
     public:
+        /**
+         Queries don't modify the tracer and can be issued from multiple threads at once
+         */
         EmbreeRayTracer(const std::vector<Triangle3D> &triangles);
 
         EmbreeRayTracer(const EmbreeRayTracer &that) = delete;
@@ -69,6 +88,14 @@ namespace EARenderer {
         );
 
         bool rayHit(const Ray3D &ray, float &distance, FaceFilter faceFilter = FaceFilter::None);
+
+        /**
+         @param ray ray to trace
+         @param hit closest intersection, left untouched if there is none
+         @param faceFilter indicates which faces should be ignored during ray tracing
+         @return flag indicating whether ray hit anything
+         */
+        bool rayHit(const Ray3D &ray, Hit &hit, FaceFilter faceFilter = FaceFilter::None);
     };
 
     void swap(EmbreeRayTracer &lhs, EmbreeRayTracer &rhs);
@@ -28,6 +28,9 @@ namespace EARenderer {
 
         using Index = uint64_t;
 
+        // Bins double their capacity when full, so a small start keeps sparsely populated bins cheap
+        static constexpr size_t InitialBinCapacity = 64;
+
         struct BinObject {
             T object;
             float weight = 0.0f;
@@ -40,7 +43,7 @@ namespace EARenderer {
             PackedLookupTable<BinObject> objects;
             float totalWeight = 0.0f;
 
-            Bin() : objects(1000) {
+            Bin() : objects(InitialBinCapacity) {
             }
         };
 
@@ -101,6 +104,11 @@ namespace EARenderer {
 
         LogarithmicBin(float maxWeight);
 
+        /**
+         Makes the sequence of objects picked by random() reproducible, otherwise bins are seeded nondeterministically
+         */
+        void seed(uint32_t value);
+
         float minWeight() const;
 
         float maxWeight() const;
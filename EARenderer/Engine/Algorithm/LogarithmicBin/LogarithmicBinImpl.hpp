@@ -31,6 +31,12 @@ namespace EARenderer {
             LogarithmicBin(0.0f, maxWeight) {
     }
 
+    template<typename T>
+    void
+    LogarithmicBin<T>::seed(uint32_t value) {
+        mEngine.seed(value);
+    }
+
 #pragma mark - Accessors
 
     template<typename T>
@@ -0,0 +1,403 @@
+//
+// Created by Pavlo Muratov on 2019-02-15.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "MeshSimplifier.hpp"
+#include "Profiler.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtx/norm.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <tuple>
+
+namespace EARenderer {
+
+    namespace {
+
+        glm::vec3 TriangleNormal(const glm::vec3 &p0, const glm::vec3 &p1, const glm::vec3 &p2) {
+            return glm::cross(p1 - p0, p2 - p0);
+        }
+
+        /**
+         Vertex to triangle adjacency in compressed form: triangles of vertex v are
+         triangles[offsets[v], offsets[v + 1]), in ascending order
+         */
+        struct Adjacency {
+            std::vector<uint32_t> offsets;
+            std::vector<uint32_t> triangles;
+
+            Adjacency(const std::vector<uint32_t> &indices, size_t vertexCount)
+                    :
+                    offsets(vertexCount + 1, 0),
+                    triangles(indices.size()) {
+                for (uint32_t index : indices) {
+                    offsets[index + 1]++;
+                }
+                std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+                std::vector<uint32_t> cursors(offsets.begin(), offsets.end() - 1);
+                for (size_t i = 0; i < indices.size(); i++) {
+                    triangles[cursors[indices[i]]++] = uint32_t(i / 3);
+                }
+            }
+
+            size_t count(uint32_t vertex) const {
+                return offsets[vertex + 1] - offsets[vertex];
+            }
+        };
+
+    }
+
+#pragma mark - Quadric
+
+    void MeshSimplifier::Quadric::addPlane(const glm::vec3 &n, float d, float w) {
+        a00 += w * n.x * n.x;
+        a01 += w * n.x * n.y;
+        a02 += w * n.x * n.z;
+        a03 += w * n.x * d;
+        a11 += w * n.y * n.y;
+        a12 += w * n.y * n.z;
+        a13 += w * n.y * d;
+        a22 += w * n.z * n.z;
+        a23 += w * n.z * d;
+        a33 += w * d * d;
+        weight += w;
+    }
+
+    void MeshSimplifier::Quadric::add(const Quadric &q) {
+        a00 += q.a00;
+        a01 += q.a01;
+        a02 += q.a02;
+        a03 += q.a03;
+        a11 += q.a11;
+        a12 += q.a12;
+        a13 += q.a13;
+        a22 += q.a22;
+        a23 += q.a23;
+        a33 += q.a33;
+        weight += q.weight;
+    }
+
+    float MeshSimplifier::Quadric::error(const glm::vec3 &p) const {
+        if (weight <= 0.0) {
+            return 0.0;
+        }
+
+        double x = p.x, y = p.y, z = p.z;
+        double e = a00 * x * x + 2.0 * a01 * x * y + 2.0 * a02 * x * z + 2.0 * a03 * x +
+                   a11 * y * y + 2.0 * a12 * y * z + 2.0 * a13 * y +
+                   a22 * z * z + 2.0 * a23 * z +
+                   a33;
+
+        // Rounding can make the sum slightly negative
+        return float(std::max(e, 0.0) / weight);
+    }
+
+#pragma mark - Lifecycle
+
+    MeshSimplifier::MeshSimplifier(const SubMesh::VertexVector &vertices, const AxisAlignedBox3D &boundingBox, const Settings &settings)
+            :
+            mSettings(settings),
+            mAttributeScale(settings.attributeWeight * boundingBox.diagonal()) {
+
+        weldVertices(vertices);
+
+        mQuadrics.resize(mVertices.size());
+        for (size_t i = 0; i < mIndices.size(); i += 3) {
+            glm::vec3 p0 = mVertices[mIndices[i]].position;
+            glm::vec3 p1 = mVertices[mIndices[i + 1]].position;
+            glm::vec3 p2 = mVertices[mIndices[i + 2]].position;
+
+            glm::vec3 normal = TriangleNormal(p0, p1, p2);
+            float doubleArea = glm::length(normal);
+            if (doubleArea <= 0.0f) {
+                continue;
+            }
+
+            normal /= doubleArea;
+            float distance = -glm::dot(normal, p0);
+
+            for (size_t c = 0; c < 3; c++) {
+                mQuadrics[mIndices[i + c]].addPlane(normal, distance, doubleArea * 0.5f);
+            }
+        }
+
+        mLockedVertices.assign(mVertices.size(), 0);
+        if (mSettings.lockBorders) {
+            lockBorderVertices();
+        }
+    }
+
+#pragma mark - Private helpers
+
+    void MeshSimplifier::weldVertices(const SubMesh::VertexVector &vertices) {
+        size_t vertexCount = vertices.size() / 3 * 3;
+
+        // Vertices are welded if position, normal and both texture coordinates are bitwise equal.
+        // Tangent frames are derived from those and are allowed to differ slightly, the first occurrence wins.
+        auto compare = [&](uint32_t lhs, uint32_t rhs) {
+            return std::memcmp(&vertices[lhs], &vertices[rhs], sizeof(Vertex1P1N2UV));
+        };
+
+        std::vector<uint32_t> order(vertexCount);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](uint32_t lhs, uint32_t rhs) {
+            int comparison = compare(lhs, rhs);
+            return comparison != 0 ? comparison < 0 : lhs < rhs;
+        });
+
+        // Unique vertices are numbered in the order of their first occurrence
+        std::vector<uint32_t> representatives(vertexCount);
+        for (size_t i = 0; i < vertexCount; i++) {
+            bool isFirst = i == 0 || compare(order[i], order[i - 1]) != 0;
+            representatives[order[i]] = isFirst ? order[i] : representatives[order[i - 1]];
+        }
+
+        std::vector<uint32_t> remap(vertexCount, UINT32_MAX);
+        mIndices.reserve(vertexCount);
+        for (size_t i = 0; i < vertexCount; i += 3) {
+            // Triangles referencing the same vertex twice have no area and no adjacency worth keeping
+            if (representatives[i] == representatives[i + 1] ||
+                representatives[i + 1] == representatives[i + 2] ||
+                representatives[i + 2] == representatives[i]) {
+                continue;
+            }
+
+            for (size_t c = i; c < i + 3; c++) {
+                uint32_t representative = representatives[c];
+                if (remap[representative] == UINT32_MAX) {
+                    remap[representative] = uint32_t(mVertices.size());
+                    mVertices.push_back(vertices[representative]);
+                }
+                mIndices.push_back(remap[representative]);
+            }
+        }
+    }
+
+    void MeshSimplifier::lockBorderVertices() {
+        // Edges shared by other than two triangles are either open borders, attribute seams
+        // (vertices on both sides differ, so they weren't welded) or non-manifold
+        std::vector<uint64_t> edges;
+        edges.reserve(mIndices.size());
+        for (size_t i = 0; i < mIndices.size(); i += 3) {
+            for (size_t c = 0; c < 3; c++) {
+                uint64_t a = mIndices[i + c];
+                uint64_t b = mIndices[i + (c + 1) % 3];
+                edges.push_back(std::min(a, b) << 32 | std::max(a, b));
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+
+        for (size_t first = 0; first < edges.size();) {
+            size_t last = first;
+            while (last < edges.size() && edges[last] == edges[first]) {
+                last++;
+            }
+
+            if (last - first != 2) {
+                mLockedVertices[uint32_t(edges[first] >> 32)] = 1;
+                mLockedVertices[uint32_t(edges[first] & 0xFFFFFFFF)] = 1;
+            }
+
+            first = last;
+        }
+    }
+
+    float MeshSimplifier::collapseCost(uint32_t from, uint32_t to) const {
+        auto &source = mVertices[from];
+        auto &target = mVertices[to];
+
+        float geometricError = mQuadrics[from].error(target.position);
+
+        float attributeDeviation = glm::length2(source.normal - target.normal) +
+                                   glm::length2(glm::vec2(source.textureCoords) - glm::vec2(target.textureCoords)) +
+                                   glm::length2(source.lightmapCoords - target.lightmapCoords);
+
+        return geometricError + mAttributeScale * mAttributeScale * attributeDeviation;
+    }
+
+    bool MeshSimplifier::collapseFlipsTriangles(uint32_t from, uint32_t to, const std::vector<uint32_t> &adjacentTriangles) const {
+        glm::vec3 target = mVertices[to].position;
+
+        for (uint32_t triangle : adjacentTriangles) {
+            const uint32_t *indices = &mIndices[triangle * 3];
+
+            // Triangles sharing the collapsed edge disappear
+            if (indices[0] == to || indices[1] == to || indices[2] == to) {
+                continue;
+            }
+
+            std::array<glm::vec3, 3> positions;
+            for (size_t c = 0; c < 3; c++) {
+                positions[c] = mVertices[indices[c]].position;
+            }
+            glm::vec3 oldNormal = TriangleNormal(positions[0], positions[1], positions[2]);
+
+            // Zero area triangles have no orientation to lose
+            if (glm::length2(oldNormal) == 0.0f) {
+                continue;
+            }
+
+            for (size_t c = 0; c < 3; c++) {
+                if (indices[c] == from) {
+                    positions[c] = target;
+                }
+            }
+            glm::vec3 newNormal = TriangleNormal(positions[0], positions[1], positions[2]);
+
+            if (glm::dot(oldNormal, newNormal) <= 0.0f) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+#pragma mark - Getters
+
+    size_t MeshSimplifier::triangleCount() const {
+        return mIndices.size() / 3;
+    }
+
+    float MeshSimplifier::error() const {
+        return mError;
+    }
+
+#pragma mark - Simplification
+
+    bool MeshSimplifier::simplify(size_t targetTriangleCount, float maximumError) {
+        EA_PROFILE_SCOPE("Simplify mesh");
+
+        struct Collapse {
+            float cost;
+            uint32_t from;
+            uint32_t to;
+
+            bool operator<(const Collapse &that) const {
+                return std::tie(cost, from) < std::tie(that.cost, that.from);
+            }
+        };
+
+        float maximumCost = maximumError * maximumError;
+        bool didCollapse = false;
+
+        std::vector<Collapse> collapses;
+        std::vector<uint8_t> touchedVertices;
+        std::vector<uint8_t> deadTriangles;
+        std::vector<uint32_t> adjacentTriangles;
+
+        while (triangleCount() > targetTriangleCount) {
+            Adjacency adjacency(mIndices, mVertices.size());
+
+            // Cheapest collapse for every vertex
+            collapses.clear();
+            for (uint32_t from = 0; from < mVertices.size(); from++) {
+                if (mLockedVertices[from] || adjacency.count(from) == 0) {
+                    continue;
+                }
+
+                Collapse best{std::numeric_limits<float>::max(), from, from};
+                for (uint32_t a = adjacency.offsets[from]; a < adjacency.offsets[from + 1]; a++) {
+                    const uint32_t *indices = &mIndices[adjacency.triangles[a] * 3];
+                    for (size_t c = 0; c < 3; c++) {
+                        uint32_t to = indices[c];
+                        if (to == from) {
+                            continue;
+                        }
+                        float cost = collapseCost(from, to);
+                        if (cost < best.cost || (cost == best.cost && to < best.to)) {
+                            best.cost = cost;
+                            best.to = to;
+                        }
+                    }
+                }
+
+                if (best.to != from && best.cost <= maximumCost) {
+                    collapses.push_back(best);
+                }
+            }
+
+            std::sort(collapses.begin(), collapses.end());
+
+            touchedVertices.assign(mVertices.size(), 0);
+            deadTriangles.assign(triangleCount(), 0);
+            size_t remainingTriangleCount = triangleCount();
+            size_t appliedCollapseCount = 0;
+
+            for (auto &collapse : collapses) {
+                if (remainingTriangleCount <= targetTriangleCount) {
+                    break;
+                }
+
+                if (touchedVertices[collapse.from] || touchedVertices[collapse.to]) {
+                    continue;
+                }
+
+                adjacentTriangles.assign(adjacency.triangles.begin() + adjacency.offsets[collapse.from],
+                        adjacency.triangles.begin() + adjacency.offsets[collapse.from + 1]);
+
+                if (collapseFlipsTriangles(collapse.from, collapse.to, adjacentTriangles)) {
+                    continue;
+                }
+
+                for (uint32_t triangle : adjacentTriangles) {
+                    uint32_t *indices = &mIndices[triangle * 3];
+                    bool isDegenerate = indices[0] == collapse.to || indices[1] == collapse.to || indices[2] == collapse.to;
+
+                    for (size_t c = 0; c < 3; c++) {
+                        touchedVertices[indices[c]] = 1;
+                        if (indices[c] == collapse.from) {
+                            indices[c] = collapse.to;
+                        }
+                    }
+
+                    if (isDegenerate && !deadTriangles[triangle]) {
+                        deadTriangles[triangle] = 1;
+                        remainingTriangleCount--;
+                    }
+                }
+
+                mQuadrics[collapse.to].add(mQuadrics[collapse.from]);
+                mError = std::max(mError, std::sqrt(collapse.cost));
+                appliedCollapseCount++;
+            }
+
+            if (appliedCollapseCount == 0) {
+                break;
+            }
+
+            // Drop collapsed triangles, keeping the order of the rest
+            size_t aliveIndexCount = 0;
+            for (size_t triangle = 0; triangle < deadTriangles.size(); triangle++) {
+                if (deadTriangles[triangle]) {
+                    continue;
+                }
+                for (size_t c = 0; c < 3; c++) {
+                    mIndices[aliveIndexCount++] = mIndices[triangle * 3 + c];
+                }
+            }
+            mIndices.resize(aliveIndexCount);
+
+            didCollapse = true;
+        }
+
+        return didCollapse;
+    }
+
+    SubMesh::VertexVector MeshSimplifier::vertices() const {
+        SubMesh::VertexVector vertices;
+        vertices.reserve(mIndices.size());
+        for (uint32_t index : mIndices) {
+            vertices.push_back(mVertices[index]);
+        }
+        return vertices;
+    }
+
+}
@@ -0,0 +1,105 @@
+//
+// Created by Pavlo Muratov on 2019-02-15.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_MESHSIMPLIFIER_HPP
+#define EARENDERER_MESHSIMPLIFIER_HPP
+
+#include "SubMesh.hpp"
+
+#include <vector>
+#include <cstdint>
+
+namespace EARenderer {
+
+    /**
+     Reduces the amount of triangles of a sub mesh with quadric error metrics (Garland & Heckbert).
+     Edges are collapsed onto one of their existing vertices, so simplified meshes reference
+     a subset of original vertices and keep their attributes exactly.
+
+     Collapses are done in passes: every pass picks the cheapest collapse for each vertex, sorts
+     them by cost and applies those not touching an area already modified during the pass.
+     Ties are broken by vertex indices, so the output is deterministic.
+
+     Simplification is progressive, consecutive calls continue from the state left by the previous one,
+     which makes a LOD chain cheap to build.
+     */
+    class MeshSimplifier {
+    public:
+        struct Settings {
+            // Deviation of normals and texture coordinates of collapsed vertices is turned into
+            // geometric error scaled by this fraction of the bounding box diagonal
+            float attributeWeight = 0.01;
+            // Keeps vertices on open borders and attribute seams (normal or UV discontinuities) in place,
+            // so that simplified meshes don't open cracks or smear textures across seams
+            bool lockBorders = true;
+        };
+
+    private:
+        /**
+         Symmetric 4x4 matrix accumulating squared distances to planes of adjacent triangles,
+         weighted by triangle areas
+         */
+        struct Quadric {
+            double a00 = 0.0, a01 = 0.0, a02 = 0.0, a03 = 0.0;
+            double a11 = 0.0, a12 = 0.0, a13 = 0.0;
+            double a22 = 0.0, a23 = 0.0;
+            double a33 = 0.0;
+            double weight = 0.0;
+
+            void addPlane(const glm::vec3 &normal, float distance, float weight);
+
+            void add(const Quadric &quadric);
+
+            /**
+             @return weighted average of squared distances from the point to accumulated planes
+             */
+            float error(const glm::vec3 &point) const;
+        };
+
+        Settings mSettings;
+        std::vector<Vertex1P1N2UV1T1BT> mVertices;
+        std::vector<uint32_t> mIndices;
+        std::vector<Quadric> mQuadrics;
+        std::vector<uint8_t> mLockedVertices;
+        float mAttributeScale = 0.0;
+        float mError = 0.0;
+
+        void weldVertices(const SubMesh::VertexVector &vertices);
+
+        void lockBorderVertices();
+
+        float collapseCost(uint32_t from, uint32_t to) const;
+
+        bool collapseFlipsTriangles(uint32_t from, uint32_t to, const std::vector<uint32_t> &adjacentTriangles) const;
+
+    public:
+        MeshSimplifier(const SubMesh::VertexVector &vertices, const AxisAlignedBox3D &boundingBox, const Settings &settings);
+
+        size_t triangleCount() const;
+
+        /**
+         @return largest error introduced by collapses so far, in mesh space units
+         */
+        float error() const;
+
+        /**
+         Collapses edges until the triangle count drops to the target, no collapse under the error limit is left
+         or no collapse is possible without flipping triangles or moving locked vertices
+
+         @param targetTriangleCount desired amount of triangles
+         @param maximumError limit of the error, in mesh space units
+         @return true if at least one edge has been collapsed
+         */
+        bool simplify(size_t targetTriangleCount, float maximumError);
+
+        /**
+         @return current state of the mesh as a triangle list, triangles keeping their original relative order
+         */
+        SubMesh::VertexVector vertices() const;
+    };
+
+}
+
+#endif //EARENDERER_MESHSIMPLIFIER_HPP
@@ -0,0 +1,304 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "MeshletBuilder.hpp"
+#include "Profiler.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtx/norm.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <tuple>
+
+namespace EARenderer {
+
+    namespace {
+
+        constexpr uint32_t NoMeshlet = std::numeric_limits<uint32_t>::max();
+
+        // Cones wider than this are useless for rejection, normals have to be within ~84 degrees from the axis
+        constexpr float MinimumConeCosine = 0.1;
+
+        /**
+         @param less strict weak ordering of vertex indices by the property vertices are identified by
+         @return identifier of each vertex, equal for vertices having equal property
+         */
+        template<typename Less>
+        std::vector<uint32_t> Identifiers(size_t vertexCount, Less less) {
+            std::vector<uint32_t> order(vertexCount);
+            for (size_t i = 0; i < vertexCount; i++) {
+                order[i] = uint32_t(i);
+            }
+
+            std::sort(order.begin(), order.end(), [&](uint32_t lhs, uint32_t rhs) {
+                return less(lhs, rhs) || (!less(rhs, lhs) && lhs < rhs);
+            });
+
+            std::vector<uint32_t> identifiers(vertexCount);
+            uint32_t identifier = 0;
+            for (size_t i = 0; i < vertexCount; i++) {
+                if (i > 0 && less(order[i - 1], order[i])) {
+                    identifier++;
+                }
+                identifiers[order[i]] = identifier;
+            }
+            return identifiers;
+        }
+
+    }
+
+#pragma mark - Lifecycle
+
+    MeshletBuilder::MeshletBuilder()
+            :
+            MeshletBuilder(Settings()) {
+    }
+
+    MeshletBuilder::MeshletBuilder(const Settings &settings)
+            :
+            mSettings(settings) {
+        mSettings.maximumVertexCount = std::max(mSettings.maximumVertexCount, 3u);
+        mSettings.maximumTriangleCount = std::max(mSettings.maximumTriangleCount, 1u);
+    }
+
+#pragma mark - Private helpers
+
+    Meshlet MeshletBuilder::boundedMeshlet(const SubMesh::VertexVector &vertices, uint32_t firstVertex, uint32_t vertexCount) const {
+        Meshlet meshlet;
+        meshlet.firstVertex = firstVertex;
+        meshlet.vertexCount = vertexCount;
+        meshlet.boundingBox = AxisAlignedBox3D::MaximumReversed();
+
+        for (uint32_t i = firstVertex; i < firstVertex + vertexCount; i++) {
+            meshlet.boundingBox.min = glm::min(meshlet.boundingBox.min, glm::vec3(vertices[i].position));
+            meshlet.boundingBox.max = glm::max(meshlet.boundingBox.max, glm::vec3(vertices[i].position));
+        }
+
+        meshlet.sphereCenter = meshlet.boundingBox.center();
+        for (uint32_t i = firstVertex; i < firstVertex + vertexCount; i++) {
+            meshlet.sphereRadius = std::max(meshlet.sphereRadius, glm::length(glm::vec3(vertices[i].position) - meshlet.sphereCenter));
+        }
+
+        // Geometric normals, since shading normals don't decide which side of a triangle is visible
+        std::vector<glm::vec3> normals;
+        glm::vec3 normalSum(0.0);
+        for (uint32_t i = firstVertex; i < firstVertex + vertexCount; i += 3) {
+            glm::vec3 p0(vertices[i].position);
+            glm::vec3 normal = glm::cross(glm::vec3(vertices[i + 1].position) - p0, glm::vec3(vertices[i + 2].position) - p0);
+            float length2 = glm::length2(normal);
+            if (length2 > 0.0f) {
+                normals.push_back(normal / std::sqrt(length2));
+                normalSum += normals.back();
+            }
+        }
+
+        meshlet.coneAxis = glm::vec3(0.0, 0.0, 1.0);
+        meshlet.coneCutoff = 1.0;
+
+        if (normals.empty() || glm::length2(normalSum) <= std::numeric_limits<float>::epsilon()) {
+            return meshlet;
+        }
+
+        glm::vec3 axis = glm::normalize(normalSum);
+        float minimumCosine = 1.0;
+        for (auto &normal : normals) {
+            minimumCosine = std::min(minimumCosine, glm::dot(axis, normal));
+        }
+
+        meshlet.coneAxis = axis;
+        if (minimumCosine > MinimumConeCosine) {
+            // Sine of the cone's half angle
+            meshlet.coneCutoff = std::sqrt(1.0f - minimumCosine * minimumCosine);
+        }
+
+        return meshlet;
+    }
+
+#pragma mark - Building
+
+    void MeshletBuilder::build(SubMesh &subMesh) const {
+        EA_PROFILE_SCOPE("Build meshlets");
+
+        auto &vertices = subMesh.vertices();
+        size_t triangleCount = vertices.size() / 3;
+
+        if (triangleCount == 0) {
+            subMesh.setMeshlets({});
+            return;
+        }
+
+        // Meshlet size is measured in vertices differing in any attribute, the way a GPU would fetch them,
+        // while adjacency ignores attributes, so that seams don't break meshlets apart
+        auto vertexIDs = Identifiers(triangleCount * 3, [&](uint32_t lhs, uint32_t rhs) {
+            return std::memcmp(&vertices[lhs], &vertices[rhs], sizeof(Vertex1P1N2UV1T1BT)) < 0;
+        });
+        auto positionIDs = Identifiers(triangleCount * 3, [&](uint32_t lhs, uint32_t rhs) {
+            return std::memcmp(&vertices[lhs].position, &vertices[rhs].position, sizeof(glm::vec4)) < 0;
+        });
+
+        uint32_t vertexIDCount = *std::max_element(vertexIDs.begin(), vertexIDs.end()) + 1;
+        uint32_t positionIDCount = *std::max_element(positionIDs.begin(), positionIDs.end()) + 1;
+
+        // Triangles adjacent to position p are [adjacentTriangles[offsets[p]], adjacentTriangles[offsets[p + 1]])
+        std::vector<uint32_t> offsets(positionIDCount + 1, 0);
+        std::vector<uint32_t> adjacentTriangles(triangleCount * 3);
+
+        for (uint32_t id : positionIDs) {
+            offsets[id + 1]++;
+        }
+        for (size_t i = 1; i < offsets.size(); i++) {
+            offsets[i] += offsets[i - 1];
+        }
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < positionIDs.size(); i++) {
+            adjacentTriangles[fill[positionIDs[i]]++] = uint32_t(i / 3);
+        }
+
+        std::vector<glm::vec3> centroids(triangleCount);
+        for (size_t t = 0; t < triangleCount; t++) {
+            centroids[t] = glm::vec3(vertices[t * 3].position + vertices[t * 3 + 1].position + vertices[t * 3 + 2].position) / 3.0f;
+        }
+
+        std::vector<uint8_t> isAssigned(triangleCount, 0);
+        std::vector<uint32_t> vertexMeshlet(vertexIDCount, NoMeshlet);
+        std::vector<uint32_t> candidateMeshlet(triangleCount, NoMeshlet);
+        std::vector<uint32_t> candidates;
+        std::vector<uint32_t> triangleOrder;
+        std::vector<uint32_t> meshletTriangleCounts;
+        triangleOrder.reserve(triangleCount);
+
+        uint32_t meshlet = 0;
+        uint32_t meshletVertexCount = 0;
+        uint32_t meshletTriangleCount = 0;
+        glm::vec3 centroidSum(0.0);
+        AxisAlignedBox3D meshletBox = AxisAlignedBox3D::MaximumReversed();
+        size_t cursor = 0;
+
+        auto newVertexCount = [&](uint32_t triangle) {
+            uint32_t count = 0;
+            for (size_t k = 0; k < 3; k++) {
+                uint32_t id = vertexIDs[triangle * 3 + k];
+                bool isRepeated = (k > 0 && id == vertexIDs[triangle * 3]) || (k > 1 && id == vertexIDs[triangle * 3 + 1]);
+                count += vertexMeshlet[id] != meshlet && !isRepeated;
+            }
+            return count;
+        };
+
+        auto addTriangle = [&](uint32_t triangle) {
+            meshletVertexCount += newVertexCount(triangle);
+            meshletTriangleCount++;
+            centroidSum += centroids[triangle];
+            isAssigned[triangle] = 1;
+            triangleOrder.push_back(triangle);
+
+            for (size_t k = 0; k < 3; k++) {
+                vertexMeshlet[vertexIDs[triangle * 3 + k]] = meshlet;
+                meshletBox.min = glm::min(meshletBox.min, glm::vec3(vertices[triangle * 3 + k].position));
+                meshletBox.max = glm::max(meshletBox.max, glm::vec3(vertices[triangle * 3 + k].position));
+
+                uint32_t positionID = positionIDs[triangle * 3 + k];
+                for (uint32_t i = offsets[positionID]; i < offsets[positionID + 1]; i++) {
+                    uint32_t adjacent = adjacentTriangles[i];
+                    if (!isAssigned[adjacent] && candidateMeshlet[adjacent] != meshlet) {
+                        candidateMeshlet[adjacent] = meshlet;
+                        candidates.push_back(adjacent);
+                    }
+                }
+            }
+        };
+
+        auto closeMeshlet = [&]() {
+            meshletTriangleCounts.push_back(meshletTriangleCount);
+            meshlet++;
+            meshletVertexCount = 0;
+            meshletTriangleCount = 0;
+            centroidSum = glm::vec3(0.0);
+            meshletBox = AxisAlignedBox3D::MaximumReversed();
+        };
+
+        while (triangleOrder.size() < triangleCount) {
+            candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [&](uint32_t triangle) {
+                return isAssigned[triangle];
+            }), candidates.end());
+
+            if (meshletTriangleCount == 0) {
+                // Continue next to the previous meshlet, or from the first unassigned triangle
+                while (isAssigned[cursor]) {
+                    cursor++;
+                }
+                uint32_t seed = candidates.empty() ? uint32_t(cursor) : candidates.front();
+                candidates.clear();
+                addTriangle(seed);
+            } else {
+                glm::vec3 centroid = centroidSum / float(meshletTriangleCount);
+                auto bestScore = std::make_tuple(std::numeric_limits<uint32_t>::max(), std::numeric_limits<float>::max(), NoMeshlet);
+
+                for (uint32_t candidate : candidates) {
+                    uint32_t extraVertices = newVertexCount(candidate);
+                    if (meshletVertexCount + extraVertices > mSettings.maximumVertexCount) {
+                        continue;
+                    }
+                    auto score = std::make_tuple(extraVertices, glm::distance2(centroids[candidate], centroid), candidate);
+                    bestScore = std::min(bestScore, score);
+                }
+
+                uint32_t best = std::get<2>(bestScore);
+
+                // Disconnected pieces, such as foliage cards, are packed in their original order as long as they are close.
+                // Leftovers of already clustered areas are usually far away and would blow up meshlet bounds.
+                if (best == NoMeshlet && candidates.empty()) {
+                    while (isAssigned[cursor]) {
+                        cursor++;
+                    }
+
+                    glm::vec3 margin(meshletBox.diagonal());
+                    AxisAlignedBox3D neighbourhood(meshletBox.min - margin, meshletBox.max + margin);
+
+                    if (neighbourhood.contains(centroids[cursor]) &&
+                        meshletVertexCount + newVertexCount(uint32_t(cursor)) <= mSettings.maximumVertexCount) {
+                        best = uint32_t(cursor);
+                    }
+                }
+
+                if (best == NoMeshlet) {
+                    closeMeshlet();
+                    continue;
+                }
+
+                addTriangle(best);
+            }
+
+            if (meshletTriangleCount == mSettings.maximumTriangleCount) {
+                closeMeshlet();
+            }
+        }
+
+        if (meshletTriangleCount > 0) {
+            closeMeshlet();
+        }
+
+        SubMesh::VertexVector reorderedVertices;
+        reorderedVertices.reserve(vertices.size());
+        for (uint32_t triangle : triangleOrder) {
+            for (size_t k = 0; k < 3; k++) {
+                reorderedVertices.push_back(vertices[triangle * 3 + k]);
+            }
+        }
+
+        SubMesh::MeshletVector meshlets;
+        meshlets.reserve(meshletTriangleCounts.size());
+        uint32_t firstVertex = 0;
+        for (uint32_t count : meshletTriangleCounts) {
+            meshlets.push_back(boundedMeshlet(reorderedVertices, firstVertex, count * 3));
+            firstVertex += count * 3;
+        }
+
+        vertices = std::move(reorderedVertices);
+        subMesh.setMeshlets(std::move(meshlets));
+    }
+
+}
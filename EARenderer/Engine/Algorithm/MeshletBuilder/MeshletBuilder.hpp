@@ -0,0 +1,52 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_MESHLETBUILDER_HPP
+#define EARENDERER_MESHLETBUILDER_HPP
+
+#include "SubMesh.hpp"
+
+#include <vector>
+#include <cstdint>
+
+namespace EARenderer {
+
+    /**
+     Splits a sub mesh into meshlets of bounded size. Meshlets are grown greedily from a seed triangle
+     by adding the adjacent triangle introducing the fewest new vertices, ties broken by distance
+     to the meshlet's centroid and then by triangle index, so that the output is deterministic.
+     A new meshlet is seeded next to the previous one whenever possible.
+
+     Triangles of the sub mesh are reordered so that every meshlet covers a contiguous range of vertices,
+     which is what unindexed draws of meshlet ranges require.
+     */
+    class MeshletBuilder {
+    public:
+        struct Settings {
+            // Unique vertices referenced by a meshlet
+            uint32_t maximumVertexCount = 64;
+            uint32_t maximumTriangleCount = 124;
+        };
+
+    private:
+        Settings mSettings;
+
+        Meshlet boundedMeshlet(const SubMesh::VertexVector &vertices, uint32_t firstVertex, uint32_t vertexCount) const;
+
+    public:
+        MeshletBuilder();
+
+        MeshletBuilder(const Settings &settings);
+
+        /**
+         Reorders triangles of the sub mesh and assigns meshlets to it. Bounding box, areas and LODs
+         of the sub mesh are left untouched and have to be computed afterwards.
+         */
+        void build(SubMesh &subMesh) const;
+    };
+
+}
+
+#endif //EARENDERER_MESHLETBUILDER_HPP
@@ -20,6 +20,7 @@
 
 #include "AxisAlignedBox3D.hpp"
 #include "Ray3D.hpp"
+#include "TaggedAllocator.hpp"
 
 // Design and implementation of virtualized sparse voxel octree ray casting
 // http://sam.cs.lth.se/ExjobGetFile?id=359
@@ -43,6 +44,8 @@ namespace EARenderer {
 
     public:
 
+        using ObjectVector = TaggedVector<T, MemoryTag::SparseOctree>;
+
         struct Node {
         private:
             friend SparseOctree;
@@ -51,7 +54,7 @@ namespace EARenderer {
             uint16_t mChildInfo = 0;
 
             AxisAlignedBox3D mBoundingBox;
-            std::vector<T> mObjects;
+            ObjectVector mObjects;
 
             void setChildPresent(BitMask childIndex, bool isPresent);
 
@@ -64,7 +67,7 @@ namespace EARenderer {
         public:
             const AxisAlignedBox3D &boundingBox() const;
 
-            const std::vector<T> &objects() const;
+            const ObjectVector &objects() const;
         };
 
     private:
@@ -106,7 +109,7 @@ namespace EARenderer {
         size_t mDepthCap = 10;
         size_t mMaximumDepth;
         AxisAlignedBox3D mBoundingBox;
-        std::unordered_map<NodeIndex, Node> mNodes;
+        TaggedUnorderedMap<NodeIndex, Node, MemoryTag::SparseOctree> mNodes;
         std::stack<StackFrame> mTraversalStack;
         std::vector<float> mCuttingPlaneOffsets;
         ContainmentDetector mContainmentDetector;
@@ -142,8 +145,8 @@ namespace EARenderer {
         private:
             friend SparseOctree;
 
-            using MapIterator = typename std::unordered_map<NodeIndex, Node>::iterator;
-            using VectorIterator = typename std::vector<T>::iterator;
+            using MapIterator = typename TaggedUnorderedMap<NodeIndex, Node, MemoryTag::SparseOctree>::iterator;
+            using VectorIterator = typename ObjectVector::iterator;
 
             MapIterator mNodesIterator;
             MapIterator mNodesEndIterator;
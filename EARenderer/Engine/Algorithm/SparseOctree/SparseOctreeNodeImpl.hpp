@@ -56,7 +56,7 @@ namespace EARenderer {
     }
 
     template<typename T>
-    const std::vector<T> &
+    const typename SparseOctree<T>::ObjectVector &
     SparseOctree<T>::Node::objects() const {
         return mObjects;
     }
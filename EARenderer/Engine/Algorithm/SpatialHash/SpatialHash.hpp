@@ -11,9 +11,11 @@
 
 #include "TupleHash.hpp"
 #include "AxisAlignedBox3D.hpp"
+#include "MemoryPool.hpp"
 
 #include <unordered_map>
 #include <vector>
+#include <memory>
 #include <stdexcept>
 #include <limits>
 
@@ -27,7 +29,9 @@ namespace EARenderer {
 
 #pragma mark - Type aliases
 
-        using Objects = std::vector<T>;
+        // Cells and map nodes are small and numerous, so they are served from a pool owned by the hash
+        using Objects = std::vector<T, PoolAllocator<T>>;
+        using ObjectMap = std::unordered_map<uint64_t, Objects, std::hash<uint64_t>, std::equal_to<uint64_t>, PoolAllocator<std::pair<const uint64_t, Objects>>>;
 
 #pragma mark - Nested types
 #pragma mark Cell
@@ -68,8 +72,8 @@ namespace EARenderer {
         private:
             friend SpatialHash;
 
-            using MapIterator = typename std::unordered_map<uint64_t, Objects>::iterator;
-            using VectorIterator = typename std::vector<T>::iterator;
+            using MapIterator = typename ObjectMap::iterator;
+            using VectorIterator = typename Objects::iterator;
 
             MapIterator mMapIterator;
             MapIterator mMapEndIterator;
@@ -95,7 +99,7 @@ namespace EARenderer {
 
         class Range {
         private:
-            using CellObjectsIterator = typename std::vector<T>::iterator;
+            using CellObjectsIterator = typename Objects::iterator;
             using CellBeginEndPair = std::pair<CellObjectsIterator, CellObjectsIterator>;
 
         public:
@@ -142,7 +146,9 @@ namespace EARenderer {
 
 #pragma mark - SpatialHash's private contents
 
-        std::unordered_map<uint64_t, Objects> mObjects;
+        // Declared before the objects to outlive them
+        std::unique_ptr<PoolResource> mPool;
+        ObjectMap mObjects;
         AxisAlignedBox3D mBoundaries;
         uint16_t mResolution;
         size_t mSize;
@@ -161,6 +167,12 @@ namespace EARenderer {
     public:
         SpatialHash(const AxisAlignedBox3D &boundaries, uint32_t resolution);
 
+        SpatialHash(SpatialHash &&that) = default;
+
+        SpatialHash &operator=(SpatialHash &&rhs);
+
+        void swap(SpatialHash &that);
+
 #pragma mark Modifiers
 
         void insert(const T &object, const glm::vec3 &position);
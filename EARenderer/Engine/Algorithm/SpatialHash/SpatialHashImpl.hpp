@@ -17,7 +17,30 @@ namespace EARenderer {
 
     template<typename T>
     SpatialHash<T>::SpatialHash(const AxisAlignedBox3D &boundaries, uint32_t resolution)
-            : mBoundaries(boundaries), mResolution(resolution), mSize(0) {}
+            :
+            mPool(std::make_unique<PoolResource>()),
+            mObjects(PoolAllocator<typename ObjectMap::value_type>(*mPool)),
+            mBoundaries(boundaries),
+            mResolution(resolution),
+            mSize(0) {}
+
+    template<typename T>
+    SpatialHash<T> &
+    SpatialHash<T>::operator=(SpatialHash &&rhs) {
+        // Member-wise assignment would destroy the pool before the cells allocated from it
+        swap(rhs);
+        return *this;
+    }
+
+    template<typename T>
+    void
+    SpatialHash<T>::swap(SpatialHash &that) {
+        std::swap(mPool, that.mPool);
+        mObjects.swap(that.mObjects);
+        std::swap(mBoundaries, that.mBoundaries);
+        std::swap(mResolution, that.mResolution);
+        std::swap(mSize, that.mSize);
+    }
 
 #pragma mark - Accessors
 
@@ -72,8 +95,8 @@ namespace EARenderer {
                         Cell neighbour(newX, newY, newZ);
                         bool present = mObjects.find(neighbour.hash()) != mObjects.end();
                         if (present) {
-                            neighbours[neighbourIndex] = neighbour;
                             neighbourIndex++;
+                            neighbours[neighbourIndex] = neighbour;
                         }
                     }
                 }
@@ -95,7 +118,8 @@ namespace EARenderer {
         if (!mBoundaries.contains(position)) {
             throw std::out_of_range("Attempt to insert an object outside of spatial hash's boundaries");
         }
-        mObjects[cell(position).hash()].push_back(object);
+        auto cellIt = mObjects.try_emplace(cell(position).hash(), PoolAllocator<T>(*mPool)).first;
+        cellIt->second.push_back(object);
         mSize++;
     }
 
@@ -122,7 +146,8 @@ namespace EARenderer {
                 break;
             }
 
-            auto &objectsInCell = mObjects[neighbourCells[i].hash()];
+            // Only non-empty cells are reported as neighbours
+            auto &objectsInCell = mObjects.find(neighbourCells[i].hash())->second;
             neighbourIteratorPairs[i] = std::make_pair(objectsInCell.begin(), objectsInCell.end());
             neighboursCount++;
         }
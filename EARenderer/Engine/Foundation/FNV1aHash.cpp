@@ -0,0 +1,29 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "FNV1aHash.hpp"
+
+namespace EARenderer {
+
+    static constexpr uint64_t Prime = 1099511628211ull;
+
+    void FNV1aHash::combine(const void *data, size_t size) {
+        auto bytes = reinterpret_cast<const uint8_t *>(data);
+        for (size_t i = 0; i < size; i++) {
+            mValue ^= bytes[i];
+            mValue *= Prime;
+        }
+    }
+
+    void FNV1aHash::combineString(const std::string &string) {
+        combine(string.data(), string.size());
+        combine(uint8_t(0xFF));
+    }
+
+    uint64_t FNV1aHash::value() const {
+        return mValue;
+    }
+
+}
@@ -0,0 +1,47 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_FNV1AHASH_HPP
+#define EARENDERER_FNV1AHASH_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <type_traits>
+
+namespace EARenderer {
+
+    /**
+     Incremental 64-bit FNV-1a hash of raw bytes. Used to key caches on disk,
+     so its output must stay stable between runs and platforms of the same endianness.
+     */
+    class FNV1aHash {
+    private:
+        uint64_t mValue = 14695981039346656037ull;
+
+    public:
+        void combine(const void *data, size_t size);
+
+        /**
+         Combines the object representation of a value, so padding bytes must not be present
+         */
+        template<class T>
+        void combine(const T &value) {
+            static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be hashed by their bytes");
+            combine(&value, sizeof(T));
+        }
+
+        /**
+         Combines characters of a string followed by a separator,
+         so that {"AB", ""} and {"A", "B"} hash differently
+         */
+        void combineString(const std::string &string);
+
+        uint64_t value() const;
+    };
+
+}
+
+#endif //EARENDERER_FNV1AHASH_HPP
@@ -23,6 +23,10 @@ namespace EARenderer {
         return mResourceRootPath;
     }
 
+    const std::string &FileManager::cacheRootPath() const {
+        return mCacheRootPath;
+    }
+
 #pragma mark - Setters
 
     void FileManager::setResourceRootPath(const std::string &path) {
@@ -33,4 +37,12 @@ namespace EARenderer {
         }
     }
 
+    void FileManager::setCacheRootPath(const std::string &path) {
+        if (path.empty() || path.back() == '/') {
+            mCacheRootPath = path;
+        } else {
+            mCacheRootPath = path + "/";
+        }
+    }
+
 }
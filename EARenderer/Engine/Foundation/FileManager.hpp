@@ -17,6 +17,7 @@ namespace EARenderer {
     private:
         std::string mResourceRootPath;
         std::string mShaderSourceFolderPath;
+        std::string mCacheRootPath;
 
         FileManager() = default;
 
@@ -32,6 +33,13 @@ namespace EARenderer {
         const std::string &resourceRootPath() const;
 
         void setResourceRootPath(const std::string &path);
+
+        /**
+         @return user-writable directory for data that can be regenerated, empty if not set
+         */
+        const std::string &cacheRootPath() const;
+
+        void setCacheRootPath(const std::string &path);
     };
 
 }
@@ -12,21 +12,47 @@ namespace EARenderer {
 
 #pragma mark - Lifecycle
 
-    FrameMeter::FrameMeter(float throttleMilliseconds)
+    FrameMeter::FrameMeter(float throttleMilliseconds, size_t statisticsWindowSize)
             :
-            mThrottle(throttleMilliseconds) {
+            mThrottle(throttleMilliseconds),
+            mStatistics(statisticsWindowSize) {
     }
 
 #pragma mark - Public methods
 
     FrameMeter::FrameCharacteristics FrameMeter::tick() {
+        auto now = Clock::now();
+        if (mPreviousTickTime) {
+            std::chrono::duration<double, std::milli> frameTime = now - *mPreviousTickTime;
+            mStatistics.addFrame(frameTime.count());
+        }
+        mPreviousTickTime = now;
+
+        if (mPassTimer) {
+            mPassTimer->finishFrame();
+            while (auto timings = mPassTimer->collectFrame()) {
+                mStatistics.addPassTimings(*timings);
+            }
+        }
+
         mPassedFrames++;
         mThrottle.attemptToPerformAction([this]() {
             mFrameCharacteristics.framesPerSecond = 1000.f / mThrottle.cooldown() * mPassedFrames;
             mFrameCharacteristics.frameTimeMillisecons = mThrottle.cooldown() / mPassedFrames;
+            mFrameCharacteristics.frameTimePercentile99Milliseconds = mStatistics.frameSummary().percentile99;
             mPassedFrames = 0;
         });
         return mFrameCharacteristics;
     }
 
+    void FrameMeter::setPassTimer(PassTimer *timer) {
+        mPassTimer = timer;
+    }
+
+#pragma mark - Getters
+
+    const FrameStatistics &FrameMeter::statistics() const {
+        return mStatistics;
+    }
+
 }
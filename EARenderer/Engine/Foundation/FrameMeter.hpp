@@ -12,6 +12,11 @@
 #include <stdlib.h>
 
 #include "Throttle.hpp"
+#include "FrameStatistics.hpp"
+#include "PassTimer.hpp"
+
+#include <chrono>
+#include <optional>
 
 namespace EARenderer {
 
@@ -20,17 +25,40 @@ namespace EARenderer {
         struct FrameCharacteristics {
             double framesPerSecond;
             double frameTimeMillisecons;
+            double frameTimePercentile99Milliseconds;
         };
 
     private:
-        uint64_t mPassedFrames;
-        FrameCharacteristics mFrameCharacteristics;
+        using Clock = std::chrono::steady_clock;
+
+        uint64_t mPassedFrames = 0;
+        FrameCharacteristics mFrameCharacteristics{};
         Throttle mThrottle;
+        FrameStatistics mStatistics;
+        std::optional<Clock::time_point> mPreviousTickTime;
+        PassTimer *mPassTimer = nullptr;
 
     public:
-        FrameMeter(float throttleMilliseconds = 200);
+        /**
+         @param throttleMilliseconds how often returned frame characteristics are refreshed
+         @param statisticsWindowSize number of most recent frames kept for statistics
+         */
+        FrameMeter(float throttleMilliseconds = 200, size_t statisticsWindowSize = 600);
+
+        /**
+         Should be called once per frame. Records the time since the previous call
+         and collects pass timings that became available.
 
+         @return averaged characteristics, refreshed at most once per throttle period
+         */
         FrameCharacteristics tick();
+
+        /**
+         @param timer timer bracketing passes of every frame, whose frames are finished on each tick, or nullptr
+         */
+        void setPassTimer(PassTimer *timer);
+
+        const FrameStatistics &statistics() const;
     };
 
 }
@@ -0,0 +1,185 @@
+//
+// Created by Pavlo Muratov on 2019-02-10.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "FrameStatistics.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <stdexcept>
+
+namespace EARenderer {
+
+#pragma mark - Helpers
+
+    static double NearestRankPercentile(const std::vector<double> &sortedSamples, double percentile) {
+        auto rank = static_cast<size_t>(std::ceil(percentile / 100.0 * sortedSamples.size()));
+        return sortedSamples[std::clamp(rank, size_t(1), sortedSamples.size()) - 1];
+    }
+
+#pragma mark - Window
+
+    FrameStatistics::Window::Window(size_t capacity)
+            : mCapacity(capacity) {
+        mSamples.reserve(capacity);
+    }
+
+    void FrameStatistics::Window::push(double sample) {
+        if (mSamples.size() < mCapacity) {
+            mSamples.push_back(sample);
+        } else {
+            mSamples[mNextIndex] = sample;
+        }
+        mNextIndex = (mNextIndex + 1) % mCapacity;
+    }
+
+    void FrameStatistics::Window::clear() {
+        mSamples.clear();
+        mNextIndex = 0;
+    }
+
+    size_t FrameStatistics::Window::size() const {
+        return mSamples.size();
+    }
+
+    const std::vector<double> &FrameStatistics::Window::samples() const {
+        return mSamples;
+    }
+
+    FrameStatistics::Summary FrameStatistics::Window::summary() const {
+        Summary summary;
+        if (mSamples.empty()) {
+            return summary;
+        }
+
+        std::vector<double> sorted(mSamples);
+        std::sort(sorted.begin(), sorted.end());
+
+        summary.sampleCount = sorted.size();
+        summary.average = std::accumulate(sorted.begin(), sorted.end(), 0.0) / sorted.size();
+        summary.percentile50 = NearestRankPercentile(sorted, 50.0);
+        summary.percentile95 = NearestRankPercentile(sorted, 95.0);
+        summary.percentile99 = NearestRankPercentile(sorted, 99.0);
+        summary.maximum = sorted.back();
+        return summary;
+    }
+
+    FrameStatistics::Histogram FrameStatistics::Window::histogram(double range, size_t bucketCount) const {
+        if (range <= 0.0 || bucketCount == 0) {
+            throw std::invalid_argument("Histogram range and bucket count must be positive");
+        }
+
+        Histogram histogram;
+        histogram.bucketWidth = range / bucketCount;
+        histogram.counts.resize(bucketCount, 0);
+
+        for (double sample : mSamples) {
+            auto bucket = static_cast<size_t>(std::max(sample, 0.0) / histogram.bucketWidth);
+            histogram.counts[std::min(bucket, bucketCount - 1)]++;
+        }
+
+        return histogram;
+    }
+
+    double FrameStatistics::Window::median() const {
+        std::vector<double> samples(mSamples);
+        auto middle = samples.begin() + samples.size() / 2;
+        std::nth_element(samples.begin(), middle, samples.end());
+        return *middle;
+    }
+
+#pragma mark - Lifecycle
+
+    FrameStatistics::FrameStatistics(size_t windowSize, double spikeThreshold)
+            :
+            mWindowSize(windowSize),
+            mSpikeThreshold(spikeThreshold),
+            // Median of a handful of frames, e.g. right after loading, is not representative
+            mMinimumSpikeDetectionSamples(std::min(windowSize, size_t(30))),
+            mFrameTimes(windowSize) {
+        if (windowSize == 0) {
+            throw std::invalid_argument("Frame statistics window must not be empty");
+        }
+    }
+
+#pragma mark - Recording
+
+    void FrameStatistics::addFrame(double milliseconds) {
+        mIsLastFrameSpike = mFrameTimes.size() >= mMinimumSpikeDetectionSamples &&
+                milliseconds > mFrameTimes.median() * mSpikeThreshold;
+
+        if (mIsLastFrameSpike) {
+            mSpikeCount++;
+        }
+
+        mFrameTimes.push(milliseconds);
+        mFrameCount++;
+    }
+
+    void FrameStatistics::addPassTimings(const PassTimer::FrameTimings &timings) {
+        for (auto &timing : timings) {
+            auto windowIt = mPassTimes.find(timing.passName);
+            if (windowIt == mPassTimes.end()) {
+                windowIt = mPassTimes.emplace(timing.passName, Window(mWindowSize)).first;
+            }
+            windowIt->second.push(timing.milliseconds);
+        }
+    }
+
+    void FrameStatistics::reset() {
+        mFrameTimes.clear();
+        mPassTimes.clear();
+        mFrameCount = 0;
+        mSpikeCount = 0;
+        mIsLastFrameSpike = false;
+    }
+
+#pragma mark - Queries
+
+    uint64_t FrameStatistics::frameCount() const {
+        return mFrameCount;
+    }
+
+    FrameStatistics::Summary FrameStatistics::frameSummary() const {
+        return mFrameTimes.summary();
+    }
+
+    FrameStatistics::Summary FrameStatistics::passSummary(const std::string &passName) const {
+        auto windowIt = mPassTimes.find(passName);
+        return windowIt != mPassTimes.end() ? windowIt->second.summary() : Summary();
+    }
+
+    std::vector<std::string> FrameStatistics::passNames() const {
+        std::vector<std::string> names;
+        for (auto &nameWindowPair : mPassTimes) {
+            names.push_back(nameWindowPair.first);
+        }
+        return names;
+    }
+
+    FrameStatistics::Histogram FrameStatistics::frameHistogram(double rangeMilliseconds, size_t bucketCount) const {
+        return mFrameTimes.histogram(rangeMilliseconds, bucketCount);
+    }
+
+    FrameStatistics::Histogram FrameStatistics::passHistogram(const std::string &passName, double rangeMilliseconds, size_t bucketCount) const {
+        auto windowIt = mPassTimes.find(passName);
+        return windowIt != mPassTimes.end() ? windowIt->second.histogram(rangeMilliseconds, bucketCount) : Window(1).histogram(rangeMilliseconds, bucketCount);
+    }
+
+    const std::vector<double> &FrameStatistics::frameTimes() const {
+        return mFrameTimes.samples();
+    }
+
+#pragma mark - Spikes
+
+    bool FrameStatistics::isLastFrameSpike() const {
+        return mIsLastFrameSpike;
+    }
+
+    uint64_t FrameStatistics::spikeCount() const {
+        return mSpikeCount;
+    }
+
+}
@@ -0,0 +1,137 @@
+//
+// Created by Pavlo Muratov on 2019-02-10.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_FRAMESTATISTICS_HPP
+#define EARENDERER_FRAMESTATISTICS_HPP
+
+#include "PassTimer.hpp"
+
+#include <vector>
+#include <string>
+#include <map>
+#include <cstdint>
+
+namespace EARenderer {
+
+    /**
+     Rolling window of frame times and per-pass timings with distribution queries.
+     Percentiles are computed with the nearest rank method over the samples currently in the window.
+     */
+    class FrameStatistics {
+    public:
+        struct Summary {
+            size_t sampleCount = 0;
+            double average = 0.0;
+            double percentile50 = 0.0;
+            double percentile95 = 0.0;
+            double percentile99 = 0.0;
+            double maximum = 0.0;
+        };
+
+        /**
+         Fixed range histogram, the last bucket also counts every sample beyond the range
+         */
+        struct Histogram {
+            double bucketWidth = 0.0;
+            std::vector<size_t> counts;
+        };
+
+    private:
+        class Window {
+        private:
+            std::vector<double> mSamples;
+            size_t mCapacity;
+            size_t mNextIndex = 0;
+
+        public:
+            Window(size_t capacity);
+
+            void push(double sample);
+
+            void clear();
+
+            size_t size() const;
+
+            const std::vector<double> &samples() const;
+
+            Summary summary() const;
+
+            Histogram histogram(double range, size_t bucketCount) const;
+
+            double median() const;
+        };
+
+        size_t mWindowSize;
+        double mSpikeThreshold;
+        size_t mMinimumSpikeDetectionSamples;
+
+        Window mFrameTimes;
+        std::map<std::string, Window> mPassTimes;
+
+        uint64_t mFrameCount = 0;
+        uint64_t mSpikeCount = 0;
+        bool mIsLastFrameSpike = false;
+
+    public:
+        /**
+         @param windowSize number of most recent frames taken into account
+         @param spikeThreshold frame is considered a spike when it takes that many times longer than the median
+         */
+        FrameStatistics(size_t windowSize = 600, double spikeThreshold = 2.0);
+
+#pragma mark - Recording
+
+        /**
+         @param milliseconds CPU time of a frame
+         */
+        void addFrame(double milliseconds);
+
+        /**
+         Adds timings of a single frame, passes are distinguished by name
+         */
+        void addPassTimings(const PassTimer::FrameTimings &timings);
+
+        void reset();
+
+#pragma mark - Queries
+
+        uint64_t frameCount() const;
+
+        Summary frameSummary() const;
+
+        /**
+         @param passName name of the pass
+         @return statistics of the pass or an empty summary if the pass has never been timed
+         */
+        Summary passSummary(const std::string &passName) const;
+
+        std::vector<std::string> passNames() const;
+
+        /**
+         @param rangeMilliseconds frame times covered by the histogram, starting at zero
+         @param bucketCount number of buckets the range is split into
+         */
+        Histogram frameHistogram(double rangeMilliseconds, size_t bucketCount) const;
+
+        Histogram passHistogram(const std::string &passName, double rangeMilliseconds, size_t bucketCount) const;
+
+        /**
+         @return frame times in the window, not in chronological order once the window is full
+         */
+        const std::vector<double> &frameTimes() const;
+
+#pragma mark - Spikes
+
+        bool isLastFrameSpike() const;
+
+        /**
+         @return number of spikes since construction or reset, including ones already out of the window
+         */
+        uint64_t spikeCount() const;
+    };
+
+}
+
+#endif //EARENDERER_FRAMESTATISTICS_HPP
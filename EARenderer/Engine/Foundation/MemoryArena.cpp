@@ -0,0 +1,130 @@
+//
+// Created by Pavlo Muratov on 2019-02-12.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "MemoryArena.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace EARenderer {
+
+#pragma mark - Helpers
+
+    static uintptr_t AlignUp(uintptr_t address, size_t alignment) {
+        return (address + alignment - 1) & ~uintptr_t(alignment - 1);
+    }
+
+#pragma mark - Scope
+
+    MemoryArena::Scope::Scope(MemoryArena &arena)
+            : mArena(arena), mMarker(arena.marker()) {}
+
+    MemoryArena::Scope::~Scope() {
+        mArena.rewind(mMarker);
+    }
+
+#pragma mark - Lifecycle
+
+    MemoryArena::MemoryArena(size_t blockSize)
+            : mBlockSize(blockSize) {
+        if (blockSize == 0) {
+            throw std::invalid_argument("Memory arena block size must not be zero");
+        }
+    }
+
+    MemoryArena &MemoryArena::ThreadLocal() {
+        static thread_local MemoryArena arena;
+        return arena;
+    }
+
+#pragma mark - Private helpers
+
+    void MemoryArena::advanceToBlockFitting(size_t bytes, size_t alignment) {
+        // Worst case padding is accounted for so that any alignment fits
+        size_t requiredSize = bytes + alignment;
+        size_t nextBlock = mBlocks.empty() ? 0 : mCurrentBlock + 1;
+
+        if (nextBlock >= mBlocks.size() || mBlocks[nextBlock].size < requiredSize) {
+            Block block;
+            block.size = std::max(mBlockSize, requiredSize);
+            block.memory.reset(new uint8_t[block.size]);
+            mBlocks.insert(mBlocks.begin() + nextBlock, std::move(block));
+        }
+
+        mCurrentBlock = nextBlock;
+        mOffset = 0;
+    }
+
+#pragma mark - Allocation
+
+    void *MemoryArena::allocate(size_t bytes, size_t alignment) {
+        if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+            throw std::invalid_argument("Memory arena alignment must be a power of two");
+        }
+
+        if (mBlocks.empty()) {
+            advanceToBlockFitting(bytes, alignment);
+        }
+
+        auto base = reinterpret_cast<uintptr_t>(mBlocks[mCurrentBlock].memory.get());
+        size_t alignedOffset = AlignUp(base + mOffset, alignment) - base;
+
+        if (alignedOffset + bytes > mBlocks[mCurrentBlock].size) {
+            advanceToBlockFitting(bytes, alignment);
+            base = reinterpret_cast<uintptr_t>(mBlocks[mCurrentBlock].memory.get());
+            alignedOffset = AlignUp(base, alignment) - base;
+        }
+
+        mOffset = alignedOffset + bytes;
+        return reinterpret_cast<void *>(base + alignedOffset);
+    }
+
+#pragma mark - Rewinding
+
+    MemoryArena::Marker MemoryArena::marker() const {
+        return {mCurrentBlock, mOffset};
+    }
+
+    void MemoryArena::rewind(const Marker &marker) {
+        mCurrentBlock = marker.blockIndex;
+        mOffset = marker.offset;
+    }
+
+    void MemoryArena::reset() {
+        rewind(Marker());
+    }
+
+    void MemoryArena::shrink() {
+        if (mBlocks.empty()) {
+            return;
+        }
+
+        bool isEmpty = mCurrentBlock == 0 && mOffset == 0;
+        mBlocks.resize(isEmpty ? 0 : mCurrentBlock + 1);
+    }
+
+#pragma mark - Getters
+
+    size_t MemoryArena::bytesAllocated() const {
+        if (mBlocks.empty()) {
+            return 0;
+        }
+
+        size_t bytes = mOffset;
+        for (size_t i = 0; i < mCurrentBlock; i++) {
+            bytes += mBlocks[i].size;
+        }
+        return bytes;
+    }
+
+    size_t MemoryArena::capacity() const {
+        size_t bytes = 0;
+        for (auto &block : mBlocks) {
+            bytes += block.size;
+        }
+        return bytes;
+    }
+
+}
@@ -0,0 +1,162 @@
+//
+// Created by Pavlo Muratov on 2019-02-12.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_MEMORYARENA_HPP
+#define EARENDERER_MEMORYARENA_HPP
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+namespace EARenderer {
+
+    /**
+     Monotonic allocator for short-lived temporaries. Memory is handed out by bumping an offset
+     inside large blocks and is only reclaimed all at once, either by a reset or by rewinding
+     to a previously taken marker. Blocks are kept around and reused after rewinding,
+     so a warmed up arena doesn't touch the heap at all.
+
+     Not thread safe, parallel stages should use ThreadLocal() arenas.
+     */
+    class MemoryArena {
+    public:
+        struct Marker {
+            size_t blockIndex = 0;
+            size_t offset = 0;
+        };
+
+        /**
+         Rewinds the arena to the state it was in at construction of the scope.
+         Everything allocated during the scope's lifetime must be dead by then.
+         */
+        class Scope {
+        private:
+            MemoryArena &mArena;
+            Marker mMarker;
+
+        public:
+            Scope(MemoryArena &arena);
+
+            ~Scope();
+
+            Scope(const Scope &that) = delete;
+
+            Scope &operator=(const Scope &rhs) = delete;
+        };
+
+    private:
+        struct Block {
+            std::unique_ptr<uint8_t[]> memory;
+            size_t size = 0;
+        };
+
+        std::vector<Block> mBlocks;
+        size_t mBlockSize;
+        size_t mCurrentBlock = 0;
+        size_t mOffset = 0;
+        size_t mBytesAllocated = 0;
+
+        /**
+         Makes block following the current one capable of holding an allocation of a given size
+         */
+        void advanceToBlockFitting(size_t bytes, size_t alignment);
+
+    public:
+        static constexpr size_t DefaultBlockSize = 1024 * 1024;
+
+        /**
+         @param blockSize size of blocks requested from the heap, larger allocations get dedicated blocks
+         */
+        MemoryArena(size_t blockSize = DefaultBlockSize);
+
+        MemoryArena(const MemoryArena &that) = delete;
+
+        MemoryArena &operator=(const MemoryArena &rhs) = delete;
+
+        /**
+         @return arena owned by the calling thread
+         */
+        static MemoryArena &ThreadLocal();
+
+        void *allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+        Marker marker() const;
+
+        void rewind(const Marker &marker);
+
+        /**
+         Releases every allocation but keeps blocks for reuse
+         */
+        void reset();
+
+        /**
+         Returns blocks to the heap
+         */
+        void shrink();
+
+        /**
+         @return bytes handed out since the last reset, including alignment padding
+         */
+        size_t bytesAllocated() const;
+
+        /**
+         @return total size of blocks owned by the arena
+         */
+        size_t capacity() const;
+    };
+
+    /**
+     Standard allocator serving containers from an arena. Deallocation is a no-op,
+     so containers that grow repeatedly leave their old storage behind until the arena is rewound.
+     */
+    template<typename T>
+    class ArenaAllocator {
+    private:
+        template<typename U>
+        friend class ArenaAllocator;
+
+        MemoryArena *mArena;
+
+    public:
+        using value_type = T;
+
+        template<typename U>
+        struct rebind {
+            using other = ArenaAllocator<U>;
+        };
+
+        ArenaAllocator(MemoryArena &arena) : mArena(&arena) {}
+
+        template<typename U>
+        ArenaAllocator(const ArenaAllocator<U> &that) : mArena(that.mArena) {}
+
+        T *allocate(size_t count) {
+            return static_cast<T *>(mArena->allocate(count * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T *, size_t) {}
+
+        MemoryArena &arena() const {
+            return *mArena;
+        }
+
+        template<typename U>
+        bool operator==(const ArenaAllocator<U> &that) const {
+            return mArena == that.mArena;
+        }
+
+        template<typename U>
+        bool operator!=(const ArenaAllocator<U> &that) const {
+            return mArena != that.mArena;
+        }
+    };
+
+    template<typename T>
+    using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+}
+
+#endif //EARENDERER_MEMORYARENA_HPP
@@ -0,0 +1,111 @@
+//
+// Created by Pavlo Muratov on 2019-02-12.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "MemoryPool.hpp"
+
+#include <new>
+#include <algorithm>
+#include <stdexcept>
+
+namespace EARenderer {
+
+#pragma mark - Fixed size pool
+
+    FixedSizePool::FixedSizePool(size_t blockSize, size_t blocksPerChunk)
+            : mBlockSize(std::max(blockSize, sizeof(FreeBlock))), mBlocksPerChunk(blocksPerChunk) {
+        if (blocksPerChunk == 0) {
+            throw std::invalid_argument("Fixed size pool chunks must not be empty");
+        }
+
+        // Chunks are maximally aligned, rounding the size keeps every block aligned as well
+        constexpr size_t alignment = alignof(std::max_align_t);
+        mBlockSize = (mBlockSize + alignment - 1) / alignment * alignment;
+    }
+
+    void FixedSizePool::allocateChunk() {
+        mChunks.emplace_back(new uint8_t[mBlockSize * mBlocksPerChunk]);
+        uint8_t *chunk = mChunks.back().get();
+
+        // Thread blocks in reverse so that allocations walk the chunk forward
+        for (size_t i = mBlocksPerChunk; i > 0; i--) {
+            auto block = reinterpret_cast<FreeBlock *>(chunk + (i - 1) * mBlockSize);
+            block->next = mFreeList;
+            mFreeList = block;
+        }
+    }
+
+    void *FixedSizePool::allocate() {
+        if (!mFreeList) {
+            allocateChunk();
+        }
+
+        FreeBlock *block = mFreeList;
+        mFreeList = block->next;
+        mAllocatedBlockCount++;
+        return block;
+    }
+
+    void FixedSizePool::deallocate(void *block) {
+        auto freeBlock = static_cast<FreeBlock *>(block);
+        freeBlock->next = mFreeList;
+        mFreeList = freeBlock;
+        mAllocatedBlockCount--;
+    }
+
+    size_t FixedSizePool::blockSize() const {
+        return mBlockSize;
+    }
+
+    size_t FixedSizePool::allocatedBlockCount() const {
+        return mAllocatedBlockCount;
+    }
+
+    size_t FixedSizePool::capacity() const {
+        return mChunks.size() * mBlocksPerChunk;
+    }
+
+#pragma mark - Pool resource
+
+    PoolResource::PoolResource()
+            : mPools{{
+            FixedSizePool(SmallestSizeClass),
+            FixedSizePool(SmallestSizeClass << 1),
+            FixedSizePool(SmallestSizeClass << 2),
+            FixedSizePool(SmallestSizeClass << 3),
+            FixedSizePool(SmallestSizeClass << 4),
+            FixedSizePool(SmallestSizeClass << 5)
+    }} {}
+
+    size_t PoolResource::SizeClassIndex(size_t bytes) {
+        size_t index = 0;
+        size_t classSize = SmallestSizeClass;
+        while (classSize < bytes) {
+            classSize <<= 1;
+            index++;
+        }
+        return index;
+    }
+
+    void *PoolResource::allocate(size_t bytes, size_t alignment) {
+        // Aligned operator new is unavailable on the deployment target
+        if (alignment > alignof(std::max_align_t)) {
+            throw std::invalid_argument("Pool resource doesn't support over-aligned allocations");
+        }
+
+        if (bytes > LargestPooledAllocation) {
+            return ::operator new(bytes);
+        }
+        return mPools[SizeClassIndex(bytes)].allocate();
+    }
+
+    void PoolResource::deallocate(void *memory, size_t bytes, size_t alignment) {
+        if (bytes > LargestPooledAllocation) {
+            ::operator delete(memory);
+            return;
+        }
+        mPools[SizeClassIndex(bytes)].deallocate(memory);
+    }
+
+}
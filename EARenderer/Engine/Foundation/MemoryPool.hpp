@@ -0,0 +1,140 @@
+//
+// Created by Pavlo Muratov on 2019-02-12.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_MEMORYPOOL_HPP
+#define EARENDERER_MEMORYPOOL_HPP
+
+#include <vector>
+#include <array>
+#include <memory>
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+
+namespace EARenderer {
+
+    /**
+     Hands out blocks of a single size from large chunks, freed blocks are kept in an intrusive list
+     and reused by subsequent allocations. Chunks are only returned to the heap on destruction.
+
+     Not thread safe.
+     */
+    class FixedSizePool {
+    private:
+        struct FreeBlock {
+            FreeBlock *next;
+        };
+
+        std::vector<std::unique_ptr<uint8_t[]>> mChunks;
+        FreeBlock *mFreeList = nullptr;
+        size_t mBlockSize;
+        size_t mBlocksPerChunk;
+        size_t mAllocatedBlockCount = 0;
+
+        void allocateChunk();
+
+    public:
+        /**
+         @param blockSize size of a single allocation, rounded up to keep every block maximally aligned
+         @param blocksPerChunk amount of blocks requested from the heap at once
+         */
+        FixedSizePool(size_t blockSize, size_t blocksPerChunk = 256);
+
+        FixedSizePool(FixedSizePool &&that) = default;
+
+        FixedSizePool &operator=(FixedSizePool &&rhs) = default;
+
+        FixedSizePool(const FixedSizePool &that) = delete;
+
+        FixedSizePool &operator=(const FixedSizePool &rhs) = delete;
+
+        void *allocate();
+
+        void deallocate(void *block);
+
+        size_t blockSize() const;
+
+        size_t allocatedBlockCount() const;
+
+        size_t capacity() const;
+    };
+
+    /**
+     Set of fixed size pools serving small allocations by size class.
+     Allocations larger than the biggest class go straight to the heap.
+     Suits node based containers, whose nodes are allocated and freed one by one.
+     */
+    class PoolResource {
+    private:
+        static constexpr size_t SizeClassCount = 6;
+        static constexpr size_t SmallestSizeClass = 16;
+
+        std::array<FixedSizePool, SizeClassCount> mPools;
+
+        static size_t SizeClassIndex(size_t bytes);
+
+    public:
+        static constexpr size_t LargestPooledAllocation = SmallestSizeClass << (SizeClassCount - 1);
+
+        PoolResource();
+
+        PoolResource(const PoolResource &that) = delete;
+
+        PoolResource &operator=(const PoolResource &rhs) = delete;
+
+        void *allocate(size_t bytes, size_t alignment);
+
+        void deallocate(void *memory, size_t bytes, size_t alignment);
+    };
+
+    /**
+     Standard allocator serving containers from a pool resource.
+     The resource follows containers on move assignment and swap, so they stay cheap.
+     */
+    template<typename T>
+    class PoolAllocator {
+    private:
+        template<typename U>
+        friend class PoolAllocator;
+
+        PoolResource *mResource;
+
+    public:
+        using value_type = T;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+        template<typename U>
+        struct rebind {
+            using other = PoolAllocator<U>;
+        };
+
+        PoolAllocator(PoolResource &resource) : mResource(&resource) {}
+
+        template<typename U>
+        PoolAllocator(const PoolAllocator<U> &that) : mResource(that.mResource) {}
+
+        T *allocate(size_t count) {
+            return static_cast<T *>(mResource->allocate(count * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T *memory, size_t count) {
+            mResource->deallocate(memory, count * sizeof(T), alignof(T));
+        }
+
+        template<typename U>
+        bool operator==(const PoolAllocator<U> &that) const {
+            return mResource == that.mResource;
+        }
+
+        template<typename U>
+        bool operator!=(const PoolAllocator<U> &that) const {
+            return mResource != that.mResource;
+        }
+    };
+
+}
+
+#endif //EARENDERER_MEMORYPOOL_HPP
@@ -0,0 +1,198 @@
+//
+// Created by Pavlo Muratov on 2019-02-11.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "MemoryTracker.hpp"
+
+#include <sstream>
+#include <iomanip>
+#include <utility>
+
+namespace EARenderer {
+
+    static thread_local MemoryTag CurrentThreadTag = MemoryTag::Untagged;
+
+#pragma mark - Snapshot
+
+    const MemoryTracker::Counter &MemoryTracker::Snapshot::counter(MemoryTag tag, MemoryDomain domain) const {
+        return mCounters[CounterIndex(tag, domain)];
+    }
+
+    int64_t MemoryTracker::Snapshot::bytes(MemoryTag tag, MemoryDomain domain) const {
+        return counter(tag, domain).bytes;
+    }
+
+    int64_t MemoryTracker::Snapshot::totalBytes(MemoryDomain domain) const {
+        int64_t total = 0;
+        for (size_t tag = 0; tag < TagCount; tag++) {
+            total += bytes(MemoryTag(tag), domain);
+        }
+        return total;
+    }
+
+    MemoryTracker::Snapshot MemoryTracker::Snapshot::difference(const Snapshot &earlier) const {
+        Snapshot difference;
+        for (size_t i = 0; i < mCounters.size(); i++) {
+            difference.mCounters[i].bytes = mCounters[i].bytes - earlier.mCounters[i].bytes;
+            difference.mCounters[i].allocationCount = mCounters[i].allocationCount - earlier.mCounters[i].allocationCount;
+        }
+        return difference;
+    }
+
+    std::string MemoryTracker::Snapshot::report() const {
+        auto megabytes = [](int64_t bytes) { return bytes / (1024.0 * 1024.0); };
+
+        std::ostringstream stream;
+        stream << std::fixed << std::setprecision(2);
+        stream << std::left << std::setw(20) << "Tag" << std::right << std::setw(14) << "CPU, MB" << std::setw(14) << "GPU, MB" << "\n";
+
+        for (size_t tag = 0; tag < TagCount; tag++) {
+            const Counter &cpu = counter(MemoryTag(tag), MemoryDomain::CPU);
+            const Counter &gpu = counter(MemoryTag(tag), MemoryDomain::GPU);
+            if (cpu.bytes == 0 && gpu.bytes == 0 && cpu.allocationCount == 0 && gpu.allocationCount == 0) {
+                continue;
+            }
+
+            stream << std::left << std::setw(20) << TagName(MemoryTag(tag)) << std::right
+                    << std::setw(14) << megabytes(cpu.bytes)
+                    << std::setw(14) << megabytes(gpu.bytes) << "\n";
+        }
+
+        stream << std::left << std::setw(20) << "Total" << std::right
+                << std::setw(14) << megabytes(totalBytes(MemoryDomain::CPU))
+                << std::setw(14) << megabytes(totalBytes(MemoryDomain::GPU)) << "\n";
+
+        return stream.str();
+    }
+
+#pragma mark - Scope
+
+    MemoryTracker::Scope::Scope(MemoryTag tag)
+            : mPreviousTag(CurrentThreadTag) {
+        CurrentThreadTag = tag;
+    }
+
+    MemoryTracker::Scope::~Scope() {
+        CurrentThreadTag = mPreviousTag;
+    }
+
+#pragma mark - Lifecycle
+
+    MemoryTracker &MemoryTracker::shared() {
+        static MemoryTracker tracker;
+        return tracker;
+    }
+
+#pragma mark - Static
+
+    size_t MemoryTracker::CounterIndex(MemoryTag tag, MemoryDomain domain) {
+        return size_t(tag) * DomainCount + size_t(domain);
+    }
+
+    const char *MemoryTracker::TagName(MemoryTag tag) {
+        switch (tag) {
+            case MemoryTag::Untagged:
+                return "Untagged";
+            case MemoryTag::Meshes:
+                return "Meshes";
+            case MemoryTag::MaterialTextures:
+                return "Material textures";
+            case MemoryTag::Environment:
+                return "Environment";
+            case MemoryTag::Surfels:
+                return "Surfels";
+            case MemoryTag::DiffuseLightProbes:
+                return "Diffuse light probes";
+            case MemoryTag::SparseOctree:
+                return "Sparse octree";
+            case MemoryTag::RayTracing:
+                return "Ray tracing";
+            case MemoryTag::GBuffer:
+                return "G-buffer";
+            case MemoryTag::Renderer:
+                return "Renderer";
+            case MemoryTag::FrameGraph:
+                return "Frame graph";
+            case MemoryTag::Lightmaps:
+                return "Lightmaps";
+            case MemoryTag::Count:
+                return "Invalid";
+        }
+    }
+
+    MemoryTag MemoryTracker::CurrentTag() {
+        return CurrentThreadTag;
+    }
+
+#pragma mark - Public interface
+
+    void MemoryTracker::allocate(MemoryTag tag, MemoryDomain domain, size_t bytes) {
+        AtomicCounter &counter = mCounters[CounterIndex(tag, domain)];
+        counter.bytes.fetch_add(int64_t(bytes), std::memory_order_relaxed);
+        counter.allocationCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void MemoryTracker::deallocate(MemoryTag tag, MemoryDomain domain, size_t bytes) {
+        AtomicCounter &counter = mCounters[CounterIndex(tag, domain)];
+        counter.bytes.fetch_sub(int64_t(bytes), std::memory_order_relaxed);
+        counter.allocationCount.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    MemoryTracker::Snapshot MemoryTracker::snapshot() const {
+        Snapshot snapshot;
+        for (size_t i = 0; i < mCounters.size(); i++) {
+            snapshot.mCounters[i].bytes = mCounters[i].bytes.load(std::memory_order_relaxed);
+            snapshot.mCounters[i].allocationCount = mCounters[i].allocationCount.load(std::memory_order_relaxed);
+        }
+        return snapshot;
+    }
+
+#pragma mark - Tracked allocation
+
+    TrackedAllocation::TrackedAllocation(MemoryDomain domain)
+            : mTag(MemoryTracker::CurrentTag()), mDomain(domain) {}
+
+    TrackedAllocation::TrackedAllocation(TrackedAllocation &&that)
+            : mTag(that.mTag), mDomain(that.mDomain), mBytes(that.mBytes) {
+        that.mBytes = 0;
+    }
+
+    TrackedAllocation &TrackedAllocation::operator=(TrackedAllocation &&rhs) {
+        swap(rhs);
+        return *this;
+    }
+
+    TrackedAllocation::~TrackedAllocation() {
+        resize(0);
+    }
+
+    void TrackedAllocation::swap(TrackedAllocation &that) {
+        std::swap(mTag, that.mTag);
+        std::swap(mDomain, that.mDomain);
+        std::swap(mBytes, that.mBytes);
+    }
+
+    void TrackedAllocation::resize(size_t bytes) {
+        if (bytes == mBytes) {
+            return;
+        }
+
+        if (mBytes > 0) {
+            MemoryTracker::shared().deallocate(mTag, mDomain, mBytes);
+        }
+        if (bytes > 0) {
+            MemoryTracker::shared().allocate(mTag, mDomain, bytes);
+        }
+        mBytes = bytes;
+    }
+
+    size_t TrackedAllocation::bytes() const {
+        return mBytes;
+    }
+
+    MemoryTag TrackedAllocation::tag() const {
+        return mTag;
+    }
+
+}
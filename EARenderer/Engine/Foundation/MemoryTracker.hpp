@@ -0,0 +1,171 @@
+//
+// Created by Pavlo Muratov on 2019-02-11.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_MEMORYTRACKER_HPP
+#define EARENDERER_MEMORYTRACKER_HPP
+
+#include <array>
+#include <atomic>
+#include <string>
+#include <cstdint>
+
+namespace EARenderer {
+
+    /**
+     Subsystem an allocation is attributed to
+     */
+    enum class MemoryTag : uint8_t {
+        Untagged,
+        Meshes,
+        MaterialTextures,
+        Environment,
+        Surfels,
+        DiffuseLightProbes,
+        SparseOctree,
+        RayTracing,
+        GBuffer,
+        Renderer,
+        FrameGraph,
+        Lightmaps,
+        Count
+    };
+
+    enum class MemoryDomain : uint8_t {
+        CPU, GPU, Count
+    };
+
+    /**
+     Aggregates sizes of live allocations per subsystem and memory domain.
+
+     CPU allocations are reported by tagged allocators of big containers and by
+     third party allocation callbacks. GPU allocations are reported by OpenGL objects
+     at the moment their storage is specified, attributed to the tag of the innermost
+     Scope active on the creating thread.
+     */
+    class MemoryTracker {
+    public:
+        static constexpr size_t TagCount = size_t(MemoryTag::Count);
+        static constexpr size_t DomainCount = size_t(MemoryDomain::Count);
+
+        struct Counter {
+            int64_t bytes = 0;
+            int64_t allocationCount = 0;
+        };
+
+        /**
+         Copy of all counters at some moment
+         */
+        class Snapshot {
+        private:
+            friend MemoryTracker;
+
+            std::array<Counter, TagCount * DomainCount> mCounters;
+
+        public:
+            const Counter &counter(MemoryTag tag, MemoryDomain domain) const;
+
+            int64_t bytes(MemoryTag tag, MemoryDomain domain) const;
+
+            int64_t totalBytes(MemoryDomain domain) const;
+
+            /**
+             @param earlier snapshot taken before this one
+             @return changes of every counter since the earlier snapshot
+             */
+            Snapshot difference(const Snapshot &earlier) const;
+
+            /**
+             @return human readable table of non-zero counters
+             */
+            std::string report() const;
+        };
+
+        /**
+         Attributes GPU allocations made on the current thread during its lifetime to a tag.
+         Scopes nest, the innermost one wins.
+         */
+        class Scope {
+        private:
+            MemoryTag mPreviousTag;
+
+        public:
+            Scope(MemoryTag tag);
+
+            ~Scope();
+
+            Scope(const Scope &that) = delete;
+
+            Scope &operator=(const Scope &rhs) = delete;
+        };
+
+    private:
+        struct AtomicCounter {
+            std::atomic<int64_t> bytes{0};
+            std::atomic<int64_t> allocationCount{0};
+        };
+
+        std::array<AtomicCounter, TagCount * DomainCount> mCounters;
+
+        MemoryTracker() = default;
+
+        MemoryTracker(const MemoryTracker &that) = delete;
+
+        MemoryTracker &operator=(const MemoryTracker &rhs) = delete;
+
+        static size_t CounterIndex(MemoryTag tag, MemoryDomain domain);
+
+    public:
+        static MemoryTracker &shared();
+
+        static const char *TagName(MemoryTag tag);
+
+        /**
+         @return tag of the innermost scope active on the calling thread
+         */
+        static MemoryTag CurrentTag();
+
+        void allocate(MemoryTag tag, MemoryDomain domain, size_t bytes);
+
+        void deallocate(MemoryTag tag, MemoryDomain domain, size_t bytes);
+
+        Snapshot snapshot() const;
+    };
+
+    /**
+     Movable handle reporting the size of a single resource, e.g. storage of an OpenGL object.
+     The tag is captured on construction, the size can change during the lifetime of the resource
+     and is released from the tracker on destruction.
+     */
+    class TrackedAllocation {
+    private:
+        MemoryTag mTag;
+        MemoryDomain mDomain;
+        size_t mBytes = 0;
+
+    public:
+        TrackedAllocation(MemoryDomain domain);
+
+        TrackedAllocation(TrackedAllocation &&that);
+
+        TrackedAllocation &operator=(TrackedAllocation &&rhs);
+
+        TrackedAllocation(const TrackedAllocation &that) = delete;
+
+        TrackedAllocation &operator=(const TrackedAllocation &rhs) = delete;
+
+        ~TrackedAllocation();
+
+        void swap(TrackedAllocation &that);
+
+        void resize(size_t bytes);
+
+        size_t bytes() const;
+
+        MemoryTag tag() const;
+    };
+
+}
+
+#endif //EARENDERER_MEMORYTRACKER_HPP
@@ -0,0 +1,58 @@
+//
+// Created by Pavlo Muratov on 2019-02-10.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "MockPassTimer.hpp"
+
+#include <stdexcept>
+
+namespace EARenderer {
+
+#pragma mark - Lifecycle
+
+    MockPassTimer::MockPassTimer(size_t latency)
+            : mLatency(latency) {}
+
+#pragma mark - Setters
+
+    void MockPassTimer::setPassDuration(const std::string &passName, double milliseconds) {
+        mPassDurations[passName] = milliseconds;
+    }
+
+#pragma mark - PassTimer
+
+    void MockPassTimer::beginPass(const std::string &name) {
+        if (mActivePass) {
+            throw std::logic_error("Pass '" + name + "' started before '" + *mActivePass + "' ended");
+        }
+        mActivePass = name;
+    }
+
+    void MockPassTimer::endPass() {
+        if (!mActivePass) {
+            throw std::logic_error("No pass is being timed");
+        }
+
+        auto durationIt = mPassDurations.find(*mActivePass);
+        double milliseconds = durationIt != mPassDurations.end() ? durationIt->second : 0.0;
+        mCurrentFrame.push_back(Timing{*mActivePass, milliseconds});
+        mActivePass.reset();
+    }
+
+    void MockPassTimer::finishFrame() {
+        mFinishedFrames.push_back(std::move(mCurrentFrame));
+        mCurrentFrame.clear();
+    }
+
+    std::optional<PassTimer::FrameTimings> MockPassTimer::collectFrame() {
+        if (mFinishedFrames.size() <= mLatency) {
+            return std::nullopt;
+        }
+
+        FrameTimings timings = std::move(mFinishedFrames.front());
+        mFinishedFrames.pop_front();
+        return timings;
+    }
+
+}
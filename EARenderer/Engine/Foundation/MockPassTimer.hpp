@@ -0,0 +1,51 @@
+//
+// Created by Pavlo Muratov on 2019-02-10.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_MOCKPASSTIMER_HPP
+#define EARENDERER_MOCKPASSTIMER_HPP
+
+#include "PassTimer.hpp"
+
+#include <unordered_map>
+#include <deque>
+
+namespace EARenderer {
+
+    /**
+     Pass timer reporting predefined durations, for exercising frame statistics without a GPU.
+     Results become available after a configurable number of finished frames, imitating query latency.
+     */
+    class MockPassTimer : public PassTimer {
+    private:
+        std::unordered_map<std::string, double> mPassDurations;
+        size_t mLatency;
+        std::optional<std::string> mActivePass;
+        FrameTimings mCurrentFrame;
+        std::deque<FrameTimings> mFinishedFrames;
+
+    public:
+        /**
+         @param latency number of frames finished after a frame before its timings are reported
+         */
+        MockPassTimer(size_t latency = 0);
+
+        /**
+         @param passName name of the pass
+         @param milliseconds duration reported for every following execution of the pass, unknown passes take 0 ms
+         */
+        void setPassDuration(const std::string &passName, double milliseconds);
+
+        void beginPass(const std::string &name) override;
+
+        void endPass() override;
+
+        void finishFrame() override;
+
+        std::optional<FrameTimings> collectFrame() override;
+    };
+
+}
+
+#endif //EARENDERER_MOCKPASSTIMER_HPP
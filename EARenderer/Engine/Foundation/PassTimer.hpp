@@ -0,0 +1,53 @@
+//
+// Created by Pavlo Muratov on 2019-02-10.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_PASSTIMER_HPP
+#define EARENDERER_PASSTIMER_HPP
+
+#include <string>
+#include <vector>
+#include <optional>
+
+namespace EARenderer {
+
+    /**
+     Source of per-pass execution times. GPU implementations deliver results
+     with a latency of several frames, so timings are collected per finished frame
+     whenever they become available instead of being queried right after a pass.
+     */
+    class PassTimer {
+    public:
+        struct Timing {
+            std::string passName;
+            double milliseconds;
+        };
+
+        using FrameTimings = std::vector<Timing>;
+
+        virtual ~PassTimer() = default;
+
+        /**
+         Starts timing a pass. Passes can't be nested.
+
+         @param name name of the pass
+         */
+        virtual void beginPass(const std::string &name) = 0;
+
+        virtual void endPass() = 0;
+
+        /**
+         Closes the current frame, passes timed afterwards belong to the next one
+         */
+        virtual void finishFrame() = 0;
+
+        /**
+         @return timings of the oldest finished frame whose results are ready, if any
+         */
+        virtual std::optional<FrameTimings> collectFrame() = 0;
+    };
+
+}
+
+#endif //EARENDERER_PASSTIMER_HPP
@@ -0,0 +1,293 @@
+//
+// Created by Pavlo Muratov on 2019-02-09.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "Profiler.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+#include <algorithm>
+
+namespace EARenderer {
+
+#pragma mark - Zone
+
+    Profiler::Zone::Zone(const char *name) {
+        Profiler::shared().beginZone(name);
+    }
+
+    Profiler::Zone::~Zone() {
+        Profiler::shared().endZone();
+    }
+
+#pragma mark - Thread buffer
+
+    Profiler::ThreadBuffer::ThreadBuffer(uint32_t threadID, size_t capacity)
+            : mEvents(capacity), mThreadID(threadID), mThreadName("Thread " + std::to_string(threadID)) {}
+
+    void Profiler::ThreadBuffer::push(const Event &event) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mEvents[mWrittenEventCount % mEvents.size()] = event;
+        mWrittenEventCount++;
+    }
+
+    void Profiler::ThreadBuffer::setThreadName(const std::string &name) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mThreadName = name;
+    }
+
+    void Profiler::ThreadBuffer::clear() {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mWrittenEventCount = 0;
+    }
+
+    uint32_t Profiler::ThreadBuffer::threadID() const {
+        return mThreadID;
+    }
+
+    std::string Profiler::ThreadBuffer::threadName() const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mThreadName;
+    }
+
+    std::vector<Profiler::Event> Profiler::ThreadBuffer::events() const {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        uint64_t capacity = mEvents.size();
+        uint64_t count = std::min(mWrittenEventCount, capacity);
+        uint64_t first = mWrittenEventCount - count;
+
+        std::vector<Event> events;
+        events.reserve(count);
+        for (uint64_t i = first; i < mWrittenEventCount; i++) {
+            events.push_back(mEvents[i % capacity]);
+        }
+        return events;
+    }
+
+#pragma mark - Lifecycle
+
+    Profiler &Profiler::shared() {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    Profiler::Profiler() {
+        mEpoch = 0;
+        mEpoch = now();
+    }
+
+#pragma mark - Private helpers
+
+    uint64_t Profiler::now() const {
+        auto sinceClockEpoch = std::chrono::steady_clock::now().time_since_epoch();
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(sinceClockEpoch).count() - mEpoch;
+    }
+
+    Profiler::ThreadBuffer &Profiler::threadBuffer() {
+        // Buffers are owned by the profiler so that events of finished threads survive until export
+        thread_local ThreadBuffer *buffer = nullptr;
+
+        if (!buffer) {
+            std::lock_guard<std::mutex> lock(mMutex);
+            auto threadID = static_cast<uint32_t>(mThreadBuffers.size());
+            mThreadBuffers.push_back(std::make_unique<ThreadBuffer>(threadID, mThreadBufferCapacity));
+            buffer = mThreadBuffers.back().get();
+        }
+
+        return *buffer;
+    }
+
+#pragma mark - Recording
+
+    void Profiler::beginZone(const char *name) {
+        threadBuffer().push(Event{EventType::Begin, name, now(), 0.0});
+    }
+
+    void Profiler::endZone() {
+        threadBuffer().push(Event{EventType::End, nullptr, now(), 0.0});
+    }
+
+    void Profiler::counter(const char *name, double value) {
+        threadBuffer().push(Event{EventType::Counter, name, now(), value});
+    }
+
+    void Profiler::setThreadName(const std::string &name) {
+        threadBuffer().setThreadName(name);
+    }
+
+    const char *Profiler::intern(const std::string &name) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        // Elements of unordered containers never move in memory
+        return mInternedNames.insert(name).first->c_str();
+    }
+
+#pragma mark - Management
+
+    void Profiler::setThreadBufferCapacity(size_t capacity) {
+        if (capacity == 0) {
+            throw std::invalid_argument("Profiler thread buffer capacity must be positive");
+        }
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        mThreadBufferCapacity = capacity;
+    }
+
+    void Profiler::clear() {
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (auto &buffer : mThreadBuffers) {
+            buffer->clear();
+        }
+    }
+
+#pragma mark - Export
+
+    static void WriteJSONString(std::ostream &stream, const char *string) {
+        stream << '"';
+        for (const char *c = string; *c; c++) {
+            switch (*c) {
+                case '"':
+                    stream << "\\\"";
+                    break;
+
+                case '\\':
+                    stream << "\\\\";
+                    break;
+
+                case '\n':
+                    stream << "\\n";
+                    break;
+
+                default:
+                    stream << *c;
+                    break;
+            }
+        }
+        stream << '"';
+    }
+
+    std::string Profiler::chromeTrace() const {
+        std::vector<const ThreadBuffer *> buffers;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            for (auto &buffer : mThreadBuffers) {
+                buffers.push_back(buffer.get());
+            }
+        }
+
+        std::ostringstream stream;
+        stream << std::fixed << std::setprecision(3);
+        stream << "{\"traceEvents\":[";
+
+        bool isFirstEvent = true;
+        auto beginEvent = [&](const char *phase, uint32_t threadID) {
+            stream << (isFirstEvent ? "\n" : ",\n");
+            stream << "{\"ph\":\"" << phase << "\",\"pid\":1,\"tid\":" << threadID;
+            isFirstEvent = false;
+        };
+
+        for (const ThreadBuffer *buffer : buffers) {
+            uint32_t threadID = buffer->threadID();
+
+            beginEvent("M", threadID);
+            stream << ",\"name\":\"thread_name\",\"args\":{\"name\":";
+            WriteJSONString(stream, buffer->threadName().c_str());
+            stream << "}}";
+
+            // End events of zones whose beginning has been overwritten are dropped
+            // to keep the remaining zones correctly nested
+            size_t depth = 0;
+            for (const Event &event : buffer->events()) {
+                double microseconds = event.timestamp / 1000.0;
+
+                switch (event.type) {
+                    case EventType::Begin:
+                        depth++;
+                        beginEvent("B", threadID);
+                        stream << ",\"ts\":" << microseconds << ",\"name\":";
+                        WriteJSONString(stream, event.name);
+                        stream << "}";
+                        break;
+
+                    case EventType::End:
+                        if (depth == 0) {
+                            break;
+                        }
+                        depth--;
+                        beginEvent("E", threadID);
+                        stream << ",\"ts\":" << microseconds << "}";
+                        break;
+
+                    case EventType::Counter:
+                        beginEvent("C", threadID);
+                        stream << ",\"ts\":" << microseconds << ",\"name\":";
+                        WriteJSONString(stream, event.name);
+                        stream << ",\"args\":{\"value\":" << event.value << "}}";
+                        break;
+                }
+            }
+        }
+
+        stream << "\n]}\n";
+        return stream.str();
+    }
+
+    bool Profiler::exportChromeTrace(const std::string &filePath) const {
+        std::ofstream file(filePath, std::ios::out | std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        file << chromeTrace();
+        return file.good();
+    }
+
+    std::map<std::string, Profiler::ZoneSummary> Profiler::zoneSummaries() const {
+        std::vector<const ThreadBuffer *> buffers;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            for (auto &buffer : mThreadBuffers) {
+                buffers.push_back(buffer.get());
+            }
+        }
+
+        std::map<std::string, ZoneSummary> summaries;
+
+        for (const ThreadBuffer *buffer : buffers) {
+            std::vector<const Event *> openZones;
+            std::vector<Event> events = buffer->events();
+
+            for (const Event &event : events) {
+                switch (event.type) {
+                    case EventType::Begin:
+                        openZones.push_back(&event);
+                        break;
+
+                    case EventType::End: {
+                        // Beginning has been overwritten in the ring buffer
+                        if (openZones.empty()) {
+                            break;
+                        }
+                        const Event *begin = openZones.back();
+                        openZones.pop_back();
+
+                        ZoneSummary &summary = summaries[begin->name];
+                        summary.callCount++;
+                        summary.totalDuration += event.timestamp - begin->timestamp;
+                        break;
+                    }
+
+                    case EventType::Counter:
+                        break;
+                }
+            }
+        }
+
+        return summaries;
+    }
+
+}
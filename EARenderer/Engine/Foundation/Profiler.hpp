@@ -0,0 +1,200 @@
+//
+// Created by Pavlo Muratov on 2019-02-09.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_PROFILER_HPP
+#define EARENDERER_PROFILER_HPP
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <cstdint>
+
+// Instrumentation is compiled in only when the build defines EARENDERER_PROFILING=1
+#ifndef EARENDERER_PROFILING
+#define EARENDERER_PROFILING 0
+#endif
+
+namespace EARenderer {
+
+    /**
+     Hierarchical CPU profiler. Every thread records begin/end/counter events into its own
+     fixed size ring buffer, so recording takes no global locks and memory use is bounded:
+     when a buffer is full the oldest events are overwritten.
+
+     Event names are stored as raw pointers and must outlive the profiler, which holds
+     for string literals. Names built at runtime have to be passed through intern() first.
+
+     Recorded events are exported in Chrome trace event format, viewable in chrome://tracing or Perfetto.
+     */
+    class Profiler {
+    public:
+        enum class EventType : uint8_t {
+            Begin, End, Counter
+        };
+
+        struct Event {
+            EventType type;
+            const char *name;
+            // Nanoseconds since profiler creation
+            uint64_t timestamp;
+            double value;
+        };
+
+        struct ZoneSummary {
+            uint64_t callCount = 0;
+            // Nanoseconds spent inside the zone, including nested zones
+            uint64_t totalDuration = 0;
+        };
+
+        /**
+         Scoped zone closing itself on destruction
+         */
+        class Zone {
+        public:
+            Zone(const char *name);
+
+            ~Zone();
+
+            Zone(const Zone &that) = delete;
+
+            Zone &operator=(const Zone &rhs) = delete;
+        };
+
+    private:
+        class ThreadBuffer {
+        private:
+            // Guards against concurrent export only, never contended while recording
+            mutable std::mutex mMutex;
+            std::vector<Event> mEvents;
+            uint64_t mWrittenEventCount = 0;
+            uint32_t mThreadID;
+            std::string mThreadName;
+
+        public:
+            ThreadBuffer(uint32_t threadID, size_t capacity);
+
+            void push(const Event &event);
+
+            void setThreadName(const std::string &name);
+
+            void clear();
+
+            uint32_t threadID() const;
+
+            std::string threadName() const;
+
+            /**
+             @return recorded events from oldest to newest
+             */
+            std::vector<Event> events() const;
+        };
+
+        mutable std::mutex mMutex;
+        std::vector<std::unique_ptr<ThreadBuffer>> mThreadBuffers;
+        std::unordered_set<std::string> mInternedNames;
+        size_t mThreadBufferCapacity = 65536;
+        uint64_t mEpoch;
+
+        Profiler();
+
+        Profiler(const Profiler &that) = delete;
+
+        Profiler &operator=(const Profiler &rhs) = delete;
+
+        uint64_t now() const;
+
+        ThreadBuffer &threadBuffer();
+
+    public:
+        static Profiler &shared();
+
+#pragma mark - Recording
+
+        void beginZone(const char *name);
+
+        void endZone();
+
+        /**
+         Records a value plotted as a separate track over time
+
+         @param name counter name
+         @param value current value of the counter
+         */
+        void counter(const char *name, double value);
+
+        /**
+         Names the calling thread in exported traces
+         */
+        void setThreadName(const std::string &name);
+
+        /**
+         @param name name built at runtime
+         @return pointer to a copy of the name living as long as the profiler
+         */
+        const char *intern(const std::string &name);
+
+#pragma mark - Management
+
+        /**
+         Sets the number of events kept per thread. Affects threads recording their first event afterwards.
+         */
+        void setThreadBufferCapacity(size_t capacity);
+
+        /**
+         Drops events recorded so far by all threads
+         */
+        void clear();
+
+#pragma mark - Export
+
+        /**
+         Serializes recorded events into Chrome trace event JSON.
+         Should be called while instrumented threads are idle, otherwise the most recent events may be missing.
+         Zones whose beginning has already been overwritten in a ring buffer are skipped.
+
+         @return JSON string
+         */
+        std::string chromeTrace() const;
+
+        /**
+         @param filePath path of the JSON file to write
+         @return whether the file has been written successfully
+         */
+        bool exportChromeTrace(const std::string &filePath) const;
+
+        /**
+         Aggregates recorded zones of all threads by name. Same restrictions as for chromeTrace() apply,
+         zones which haven't been closed yet are not accounted for.
+
+         @return call count and total duration of every recorded zone
+         */
+        std::map<std::string, ZoneSummary> zoneSummaries() const;
+    };
+
+}
+
+#define EA_PROFILER_CONCAT_IMPL(a, b) a##b
+#define EA_PROFILER_CONCAT(a, b) EA_PROFILER_CONCAT_IMPL(a, b)
+
+#if EARENDERER_PROFILING
+
+#define EA_PROFILE_SCOPE(name) ::EARenderer::Profiler::Zone EA_PROFILER_CONCAT(profilerZone, __COUNTER__)(name)
+#define EA_PROFILE_SCOPE_DYNAMIC(name) ::EARenderer::Profiler::Zone EA_PROFILER_CONCAT(profilerZone, __COUNTER__)(::EARenderer::Profiler::shared().intern(name))
+#define EA_PROFILE_COUNTER(name, value) ::EARenderer::Profiler::shared().counter(name, static_cast<double>(value))
+#define EA_PROFILE_THREAD_NAME(name) ::EARenderer::Profiler::shared().setThreadName(name)
+
+#else
+
+#define EA_PROFILE_SCOPE(name)
+#define EA_PROFILE_SCOPE_DYNAMIC(name)
+#define EA_PROFILE_COUNTER(name, value)
+#define EA_PROFILE_THREAD_NAME(name)
+
+#endif
+
+#endif //EARENDERER_PROFILER_HPP
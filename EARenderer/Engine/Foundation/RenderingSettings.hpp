@@ -28,6 +28,15 @@ namespace EARenderer {
 
             float parallaxMappingStrength = 0.003;
 
+            // Largest geometric error of mesh LODs allowed on screen or in a shadow map, in pixels
+            float lodScreenSpaceError = 1.0;
+
+            // Full resolution sub meshes are drawn meshlet by meshlet, skipping those outside of the view
+            bool meshletCullingEnabled = true;
+            // Also skip meshlets facing away from the view. Back faces aren't culled otherwise,
+            // so this only suits scenes made of closed meshes
+            bool meshletConeCullingEnabled = false;
+
             uint32_t shadowCascadesCount = 1;
             GaussianBlurSettings shadowBlur{8, 8};
 
@@ -58,10 +67,25 @@ namespace EARenderer {
             float sphereRadius = 0.05;
         };
 
+        struct GlobalIllumination {
+            // Spread surfel relighting and probe updates over multiple frames.
+            // When disabled, all surfels and probes are recomputed every frame.
+            bool timeSlicingEnabled = true;
+            uint32_t surfelsPerFrame = 16384;
+            uint32_t probesPerFrame = 2048;
+
+            // Light baking volumes are loaded once the camera gets closer than the activation distance
+            // and unloaded once it moves further than the deactivation distance
+            float volumeActivationDistance = 10.0;
+            float volumeDeactivationDistance = 15.0;
+            uint32_t volumeActivationsPerFrame = 1;
+        };
+
         Mesh meshSettings;
         Surfel surfelSettings;
         Probe probeSettings;
         BloomSettings bloomSettings;
+        GlobalIllumination giSettings;
 
         bool skyboxRenderingEnabled = true;
         bool triangleRenderingEnabled = false;
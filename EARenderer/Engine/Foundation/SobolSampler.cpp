@@ -0,0 +1,270 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "SobolSampler.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+
+#include <array>
+#include <algorithm>
+#include <cmath>
+
+namespace EARenderer {
+
+    namespace {
+
+        struct PrimitivePolynomial {
+            uint32_t degree;
+            // Coefficients between the highest and the lowest term, highest first
+            uint32_t coefficients;
+            std::array<uint32_t, 7> initialDirections;
+        };
+
+        // Dimensions 1 and above, from new-joe-kuo-6.21201 (Joe and Kuo, Constructing Sobol Sequences with Better Two-Dimensional Projections)
+        constexpr std::array<PrimitivePolynomial, SobolSampler::DimensionCount - 1> Polynomials{{
+                {1, 0, {1}},
+                {2, 1, {1, 3}},
+                {3, 1, {1, 3, 1}},
+                {3, 2, {1, 1, 1}},
+                {4, 1, {1, 1, 3, 3}},
+                {4, 4, {1, 3, 5, 13}},
+                {5, 2, {1, 1, 5, 5, 17}},
+                {5, 4, {1, 1, 5, 5, 5}},
+                {5, 7, {1, 1, 7, 11, 19}},
+                {5, 11, {1, 1, 5, 1, 1}},
+                {5, 13, {1, 1, 1, 3, 11}},
+                {5, 14, {1, 3, 5, 5, 31}},
+                {6, 1, {1, 3, 3, 9, 7, 49}},
+                {6, 13, {1, 1, 1, 15, 21, 21}},
+                {6, 16, {1, 3, 1, 13, 27, 49}},
+                {6, 19, {1, 1, 1, 15, 7, 5}},
+                {6, 22, {1, 3, 1, 15, 13, 25}},
+                {6, 25, {1, 1, 5, 5, 19, 61}},
+                {7, 1, {1, 3, 7, 11, 23, 15, 103}},
+                {7, 4, {1, 3, 7, 13, 13, 15, 69}},
+                {7, 7, {1, 1, 3, 13, 7, 35, 63}},
+                {7, 8, {1, 3, 5, 9, 1, 25, 53}},
+                {7, 14, {1, 3, 1, 13, 9, 35, 107}},
+                {7, 19, {1, 3, 1, 5, 27, 61, 31}},
+                {7, 21, {1, 1, 5, 11, 19, 41, 61}},
+                {7, 28, {1, 3, 5, 3, 3, 13, 69}},
+                {7, 31, {1, 1, 7, 13, 1, 19, 1}},
+                {7, 32, {1, 3, 7, 5, 13, 19, 59}},
+                {7, 37, {1, 1, 3, 9, 25, 29, 41}},
+                {7, 41, {1, 3, 5, 13, 23, 1, 55}},
+                {7, 42, {1, 3, 7, 3, 13, 59, 17}}
+        }};
+
+        using DirectionNumbers = std::array<std::array<uint32_t, 32>, SobolSampler::DimensionCount>;
+
+        DirectionNumbers MakeDirectionNumbers() {
+            DirectionNumbers directions;
+
+            // The first dimension is the van der Corput sequence
+            for (uint32_t bit = 0; bit < 32; bit++) {
+                directions[0][bit] = 1u << (31 - bit);
+            }
+
+            for (uint32_t dimension = 1; dimension < SobolSampler::DimensionCount; dimension++) {
+                auto &polynomial = Polynomials[dimension - 1];
+                auto &v = directions[dimension];
+                uint32_t s = polynomial.degree;
+
+                for (uint32_t bit = 0; bit < 32; bit++) {
+                    if (bit < s) {
+                        v[bit] = polynomial.initialDirections[bit] << (31 - bit);
+                        continue;
+                    }
+
+                    v[bit] = v[bit - s] ^ (v[bit - s] >> s);
+                    for (uint32_t k = 1; k < s; k++) {
+                        if ((polynomial.coefficients >> (s - 1 - k)) & 1) {
+                            v[bit] ^= v[bit - k];
+                        }
+                    }
+                }
+            }
+
+            return directions;
+        }
+
+        uint32_t Hash(uint32_t x) {
+            x ^= x >> 16;
+            x *= 0x7feb352d;
+            x ^= x >> 15;
+            x *= 0x846ca68b;
+            x ^= x >> 16;
+            return x;
+        }
+
+        uint32_t HashCombine(uint32_t seed, uint32_t value) {
+            return Hash(seed ^ (value + 0x9e3779b9 + (seed << 6) + (seed >> 2)));
+        }
+
+        uint32_t ReverseBits(uint32_t bits) {
+            bits = (bits << 16) | (bits >> 16);
+            bits = ((bits & 0x55555555) << 1) | ((bits & 0xAAAAAAAA) >> 1);
+            bits = ((bits & 0x33333333) << 2) | ((bits & 0xCCCCCCCC) >> 2);
+            bits = ((bits & 0x0F0F0F0F) << 4) | ((bits & 0xF0F0F0F0) >> 4);
+            bits = ((bits & 0x00FF00FF) << 8) | ((bits & 0xFF00FF00) >> 8);
+            return bits;
+        }
+
+        /**
+         Flips every bit depending on the bits below it only (Laine and Karras permutation with Burley's constants)
+         */
+        uint32_t LaineKarrasPermutation(uint32_t x, uint32_t seed) {
+            x ^= x * 0x3d20adea;
+            x += seed;
+            x *= (seed >> 16) | 1;
+            x ^= x * 0x05526c56;
+            x ^= x * 0x53a22864;
+            return x;
+        }
+
+        /**
+         Owen scrambling: flips every bit depending on the bits above it, which randomly permutes
+         intervals of every level of the binary hierarchy while keeping them intact
+         */
+        uint32_t NestedUniformScramble(uint32_t x, uint32_t seed) {
+            return ReverseBits(LaineKarrasPermutation(ReverseBits(x), seed));
+        }
+
+        uint32_t SpreadBits2D(uint32_t x) {
+            x &= 0x0000FFFF;
+            x = (x | (x << 8)) & 0x00FF00FF;
+            x = (x | (x << 4)) & 0x0F0F0F0F;
+            x = (x | (x << 2)) & 0x33333333;
+            x = (x | (x << 1)) & 0x55555555;
+            return x;
+        }
+
+        uint32_t SpreadBits3D(uint32_t x) {
+            x &= 0x000003FF;
+            x = (x | (x << 16)) & 0x030000FF;
+            x = (x | (x << 8)) & 0x0300F00F;
+            x = (x | (x << 4)) & 0x030C30C3;
+            x = (x | (x << 2)) & 0x09249249;
+            return x;
+        }
+
+        /**
+         Rotates a direction given relative to the z axis into the frame of the normal
+         (Duff et al., Building an Orthonormal Basis, Revisited)
+         */
+        glm::vec3 AroundNormal(const glm::vec3 &local, const glm::vec3 &normal) {
+            float sign = std::copysign(1.0f, normal.z);
+            float a = -1.0f / (sign + normal.z);
+            float b = normal.x * normal.y * a;
+            glm::vec3 tangent(1.0f + sign * normal.x * normal.x * a, sign * b, -sign * normal.x);
+            glm::vec3 bitangent(b, sign + normal.y * normal.y * a, -normal.y);
+
+            return tangent * local.x + bitangent * local.y + normal * local.z;
+        }
+
+    }
+
+#pragma mark - Lifecycle
+
+    SobolSampler::SobolSampler(uint32_t seed)
+            :
+            mSeed(seed) {
+    }
+
+    SobolSampler SobolSampler::Ranked(uint32_t seed, uint32_t rank, uint32_t sampleBudget) {
+        uint32_t budgetBits = 0;
+        while (budgetBits < 31 && (1u << budgetBits) < sampleBudget) {
+            budgetBits++;
+        }
+
+        // Ranks of pixels further apart than the sequence can hold share their blocks
+        SobolSampler sampler(seed);
+        sampler.mSampleBudget = 1u << budgetBits;
+        sampler.mFirstIndex = rank << budgetBits;
+        return sampler;
+    }
+
+#pragma mark - Ranks
+
+    uint32_t SobolSampler::PixelRank(const glm::uvec2 &pixel, uint32_t seed) {
+        uint32_t morton = SpreadBits2D(pixel.x) | (SpreadBits2D(pixel.y) << 1);
+        return NestedUniformScramble(morton, Hash(seed));
+    }
+
+    uint32_t SobolSampler::CellRank(const glm::uvec3 &cell, uint32_t seed) {
+        uint32_t morton = SpreadBits3D(cell.x) | (SpreadBits3D(cell.y) << 1) | (SpreadBits3D(cell.z) << 2);
+        // Morton code of 30 bits is aligned to the top, so that scrambling treats it as the full hierarchy
+        return NestedUniformScramble(morton << 2, Hash(seed)) >> 2;
+    }
+
+#pragma mark - Sampling
+
+    uint32_t SobolSampler::Sobol(uint32_t index, uint32_t dimension) {
+        static const DirectionNumbers directions = MakeDirectionNumbers();
+
+        auto &v = directions[dimension % DimensionCount];
+        uint32_t result = 0;
+        for (uint32_t bit = 0; index; index >>= 1, bit++) {
+            if (index & 1) {
+                result ^= v[bit];
+            }
+        }
+        return result;
+    }
+
+    float SobolSampler::sample1D(uint32_t index, uint32_t dimension) const {
+        // Shuffling the order scrambles the index the same way as a point, so prefixes stay aligned blocks of the sequence
+        uint32_t sequenceIndex = mSampleBudget == 0 ?
+                                 NestedUniformScramble(index, Hash(mSeed)) :
+                                 mFirstIndex + (index & (mSampleBudget - 1));
+
+        uint32_t bits = NestedUniformScramble(Sobol(sequenceIndex, dimension), HashCombine(mSeed, dimension));
+
+        // 24 bits keep the result below 1 after conversion to float
+        return float(bits >> 8) * 0x1p-24f;
+    }
+
+    glm::vec2 SobolSampler::sample2D(uint32_t index, uint32_t dimension) const {
+        return glm::vec2(sample1D(index, dimension), sample1D(index, dimension + 1));
+    }
+
+    glm::vec3 SobolSampler::sphereDirection(uint32_t index, uint32_t dimension) const {
+        return UniformSphere(sample2D(index, dimension));
+    }
+
+    glm::vec3 SobolSampler::hemisphereDirection(uint32_t index, uint32_t dimension, const glm::vec3 &normal) const {
+        return UniformHemisphere(sample2D(index, dimension), normal);
+    }
+
+    glm::vec3 SobolSampler::cosineWeightedHemisphereDirection(uint32_t index, uint32_t dimension, const glm::vec3 &normal) const {
+        return CosineWeightedHemisphere(sample2D(index, dimension), normal);
+    }
+
+#pragma mark - Mappings
+
+    glm::vec3 SobolSampler::UniformSphere(const glm::vec2 &sample) {
+        float z = 1.0f - 2.0f * sample.x;
+        float radius = std::sqrt(std::max(0.0f, 1.0f - z * z));
+        float phi = glm::two_pi<float>() * sample.y;
+        return glm::vec3(radius * std::cos(phi), radius * std::sin(phi), z);
+    }
+
+    glm::vec3 SobolSampler::UniformHemisphere(const glm::vec2 &sample, const glm::vec3 &normal) {
+        float z = 1.0f - sample.x;
+        float radius = std::sqrt(std::max(0.0f, 1.0f - z * z));
+        float phi = glm::two_pi<float>() * sample.y;
+        return AroundNormal(glm::vec3(radius * std::cos(phi), radius * std::sin(phi), z), normal);
+    }
+
+    glm::vec3 SobolSampler::CosineWeightedHemisphere(const glm::vec2 &sample, const glm::vec3 &normal) {
+        // Malley's method: uniform disk points projected up onto the hemisphere
+        float radius = std::sqrt(sample.x);
+        float phi = glm::two_pi<float>() * sample.y;
+        float z = std::sqrt(std::max(0.0f, 1.0f - sample.x));
+        return AroundNormal(glm::vec3(radius * std::cos(phi), radius * std::sin(phi), z), normal);
+    }
+
+}
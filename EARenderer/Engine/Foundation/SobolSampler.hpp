@@ -0,0 +1,109 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_SOBOLSAMPLER_HPP
+#define EARENDERER_SOBOLSAMPLER_HPP
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <cstdint>
+
+namespace EARenderer {
+
+    /**
+     Owen scrambled Sobol sequence (Burley, Practical Hash-based Owen Scrambling).
+
+     Unlike Hammersley points the sequence doesn't need the sample count up front: every prefix of a power of two
+     length is stratified, so sampling can stop as soon as an estimate converges. Scrambling keeps
+     the stratification while decorrelating samplers of different seeds, e.g. per pixel or per probe seeds.
+
+     A ranked sampler instead shares the seed between all pixels and hands each of them a block of consecutive
+     sequence points picked by the pixel's rank. Ranks follow a randomly shuffled Morton order, so blocks of spatially
+     close pixels complement each other in a larger stratified set, which pushes the error towards blue noise
+     (Ahmed and Wonka, Screen-Space Blue-Noise Diffusion of Monte Carlo Sampling Error via Hierarchical Ordering of Pixels).
+     */
+    class SobolSampler {
+    public:
+        // Dimensions with their own direction numbers (Joe and Kuo), higher ones reuse them with independent scrambling
+        static constexpr uint32_t DimensionCount = 32;
+
+    private:
+        uint32_t mSeed;
+        uint32_t mFirstIndex = 0;
+        // Zero for seeded samplers, which shuffle the order of points instead
+        uint32_t mSampleBudget = 0;
+
+    public:
+        /**
+         @param seed seed of the scrambling, samplers of different seeds are statistically independent
+         */
+        explicit SobolSampler(uint32_t seed);
+
+        /**
+         @param seed seed shared by all pixels or probes sampled together
+         @param rank rank of the pixel or probe, see PixelRank() and CellRank()
+         @param sampleBudget maximum amount of samples per pixel, rounded up to a power of two.
+         Indices wrap around past the budget.
+         */
+        static SobolSampler Ranked(uint32_t seed, uint32_t rank, uint32_t sampleBudget);
+
+        /**
+         @return rank of a pixel in a hierarchically shuffled Morton order, unique within 65536 x 65536 pixels
+         */
+        static uint32_t PixelRank(const glm::uvec2 &pixel, uint32_t seed);
+
+        /**
+         @return rank of a grid cell in a hierarchically shuffled Morton order, unique within 1024^3 cells
+         */
+        static uint32_t CellRank(const glm::uvec3 &cell, uint32_t seed);
+
+        /**
+         @return unscrambled Sobol sequence point as a 0.32 fixed point number
+         */
+        static uint32_t Sobol(uint32_t index, uint32_t dimension);
+
+        /**
+         @return value in [0, 1)
+         */
+        float sample1D(uint32_t index, uint32_t dimension) const;
+
+        /**
+         @return values of the dimension and the one following it
+         */
+        glm::vec2 sample2D(uint32_t index, uint32_t dimension) const;
+
+        /**
+         Uses two dimensions starting from the given one
+
+         @return uniformly distributed unit vector
+         */
+        glm::vec3 sphereDirection(uint32_t index, uint32_t dimension) const;
+
+        /**
+         Uses two dimensions starting from the given one
+
+         @return unit vector uniformly distributed in the hemisphere around the normal
+         */
+        glm::vec3 hemisphereDirection(uint32_t index, uint32_t dimension, const glm::vec3 &normal) const;
+
+        /**
+         Uses two dimensions starting from the given one
+
+         @return unit vector in the hemisphere around the normal distributed by the cosine of its angle to the normal
+         */
+        glm::vec3 cosineWeightedHemisphereDirection(uint32_t index, uint32_t dimension, const glm::vec3 &normal) const;
+
+#pragma mark - Mappings
+
+        static glm::vec3 UniformSphere(const glm::vec2 &sample);
+
+        static glm::vec3 UniformHemisphere(const glm::vec2 &sample, const glm::vec3 &normal);
+
+        static glm::vec3 CosineWeightedHemisphere(const glm::vec2 &sample, const glm::vec3 &normal);
+    };
+
+}
+
+#endif //EARENDERER_SOBOLSAMPLER_HPP
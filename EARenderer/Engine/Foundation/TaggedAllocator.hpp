@@ -0,0 +1,66 @@
+//
+// Created by Pavlo Muratov on 2019-02-11.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_TAGGEDALLOCATOR_HPP
+#define EARENDERER_TAGGEDALLOCATOR_HPP
+
+#include "MemoryTracker.hpp"
+
+#include <memory>
+#include <vector>
+#include <unordered_map>
+
+namespace EARenderer {
+
+    /**
+     Standard allocator reporting every allocation to the memory tracker under a fixed tag.
+     Stateless, so containers using it stay interchangeable with each other.
+     */
+    template<typename T, MemoryTag Tag>
+    class TaggedAllocator {
+    public:
+        using value_type = T;
+
+        template<typename U>
+        struct rebind {
+            using other = TaggedAllocator<U, Tag>;
+        };
+
+        TaggedAllocator() = default;
+
+        template<typename U>
+        TaggedAllocator(const TaggedAllocator<U, Tag> &) {}
+
+        T *allocate(size_t count) {
+            T *memory = std::allocator<T>().allocate(count);
+            MemoryTracker::shared().allocate(Tag, MemoryDomain::CPU, count * sizeof(T));
+            return memory;
+        }
+
+        void deallocate(T *memory, size_t count) {
+            MemoryTracker::shared().deallocate(Tag, MemoryDomain::CPU, count * sizeof(T));
+            std::allocator<T>().deallocate(memory, count);
+        }
+
+        template<typename U>
+        bool operator==(const TaggedAllocator<U, Tag> &) const {
+            return true;
+        }
+
+        template<typename U>
+        bool operator!=(const TaggedAllocator<U, Tag> &) const {
+            return false;
+        }
+    };
+
+    template<typename T, MemoryTag Tag>
+    using TaggedVector = std::vector<T, TaggedAllocator<T, Tag>>;
+
+    template<typename Key, typename Value, MemoryTag Tag>
+    using TaggedUnorderedMap = std::unordered_map<Key, Value, std::hash<Key>, std::equal_to<Key>, TaggedAllocator<std::pair<const Key, Value>, Tag>>;
+
+}
+
+#endif //EARENDERER_TAGGEDALLOCATOR_HPP
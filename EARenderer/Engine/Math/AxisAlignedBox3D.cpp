@@ -108,6 +108,10 @@ namespace EARenderer {
         return contains(box.min) && contains(box.max);
     }
 
+    bool AxisAlignedBox3D::intersects(const AxisAlignedBox3D &box) const {
+        return glm::all(glm::lessThanEqual(box.min, max)) && glm::all(glm::greaterThanEqual(box.max, min));
+    }
+
     std::array<AxisAlignedBox3D, 8> AxisAlignedBox3D::octet() const {
         glm::vec3 c = center();
         return {
@@ -62,6 +62,8 @@ namespace EARenderer {
 
         bool contains(const AxisAlignedBox3D &box) const;
 
+        bool intersects(const AxisAlignedBox3D &box) const;
+
         /**
          Splits into 8 sub-boxes of equal size
          The order is:
@@ -0,0 +1,139 @@
+//
+// Created by Pavlo Muratov on 2019-02-04.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "QuantizedSphericalHarmonics.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace EARenderer {
+
+    namespace {
+
+        uint32_t FloatBits(float value) {
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        }
+
+        float BitsToFloat(uint32_t bits) {
+            float value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+
+        uint32_t Pack2x16(int32_t first, int32_t second) {
+            return (uint32_t(first) & 0xFFFFu) << 16 | (uint32_t(second) & 0xFFFFu);
+        }
+
+        int32_t Unpack16(uint32_t package, uint32_t index) {
+            return int16_t((package >> (16 * (1 - index))) & 0xFFFFu);
+        }
+
+        uint32_t Pack4x8(int32_t a, int32_t b, int32_t c, int32_t d) {
+            return (uint32_t(a) & 0xFFu) << 24 | (uint32_t(b) & 0xFFu) << 16 | (uint32_t(c) & 0xFFu) << 8 | (uint32_t(d) & 0xFFu);
+        }
+
+        int32_t Unpack8(uint32_t package, uint32_t index) {
+            return int8_t((package >> (8 * (3 - index))) & 0xFFu);
+        }
+
+    }
+
+#pragma mark - Lifecycle
+
+    QuantizedSphericalHarmonics::QuantizedSphericalHarmonics(const SphericalHarmonics &sphericalHarmonics) {
+        auto coefficients = sphericalHarmonics.coefficients();
+
+        float lumaScale = 0.0;
+        float chromaScale = 0.0;
+        for (auto &c : coefficients) {
+            lumaScale = std::max(lumaScale, std::abs(c.r));
+            chromaScale = std::max(chromaScale, std::max(std::abs(c.g), std::abs(c.b)));
+        }
+
+        std::array<int32_t, 9> Y;
+        std::array<int32_t, 9> Co;
+        std::array<int32_t, 9> Cg;
+        for (size_t i = 0; i < 9; i++) {
+            Y[i] = Quantize(coefficients[i].r, lumaScale, LumaQuantizationBase);
+            Co[i] = Quantize(coefficients[i].g, chromaScale, ChromaQuantizationBase);
+            Cg[i] = Quantize(coefficients[i].b, chromaScale, ChromaQuantizationBase);
+        }
+
+        mData = {
+                FloatBits(lumaScale), FloatBits(chromaScale), Pack2x16(Y[0], Y[1]), Pack2x16(Y[2], Y[3]),
+                Pack2x16(Y[4], Y[5]), Pack2x16(Y[6], Y[7]), Pack2x16(Y[8], 0), Pack4x8(Co[0], Co[1], Co[2], Co[3]),
+                Pack4x8(Co[4], Co[5], Co[6], Co[7]), Pack4x8(Co[8], Cg[0], Cg[1], Cg[2]), Pack4x8(Cg[3], Cg[4], Cg[5], Cg[6]), Pack4x8(Cg[7], Cg[8], 0, 0)
+        };
+    }
+
+#pragma mark - Private Helpers
+
+    int32_t QuantizedSphericalHarmonics::Quantize(float value, float scale, float base) {
+        if (scale <= 0.0) {
+            return 0;
+        }
+        float normalized = std::min(std::max(value / scale, -1.0f), 1.0f);
+        return int32_t(std::round(normalized * base));
+    }
+
+    float QuantizedSphericalHarmonics::Dequantize(int32_t value, float scale, float base) {
+        return float(value) / base * scale;
+    }
+
+#pragma mark - Getters
+
+    float QuantizedSphericalHarmonics::lumaScale() const {
+        return BitsToFloat(mData[0]);
+    }
+
+    float QuantizedSphericalHarmonics::chromaScale() const {
+        return BitsToFloat(mData[1]);
+    }
+
+    float QuantizedSphericalHarmonics::maximumError() const {
+        // Rounding to the nearest level never deviates by more than a half of the quantization step.
+        // Small slack accounts for the float arithmetic of quantization and dequantization
+        float lumaError = lumaScale() / (2.0f * LumaQuantizationBase);
+        float chromaError = chromaScale() / (2.0f * ChromaQuantizationBase);
+        return std::max(lumaError, chromaError) * 1.001f;
+    }
+
+#pragma mark - Public Interface
+
+    SphericalHarmonics QuantizedSphericalHarmonics::dequantized() const {
+        float lumaScale = this->lumaScale();
+        float chromaScale = this->chromaScale();
+
+        std::array<int32_t, 9> Y{
+                Unpack16(mData[2], 0), Unpack16(mData[2], 1), Unpack16(mData[3], 0), Unpack16(mData[3], 1),
+                Unpack16(mData[4], 0), Unpack16(mData[4], 1), Unpack16(mData[5], 0), Unpack16(mData[5], 1),
+                Unpack16(mData[6], 0)
+        };
+
+        std::array<int32_t, 9> Co{
+                Unpack8(mData[7], 0), Unpack8(mData[7], 1), Unpack8(mData[7], 2), Unpack8(mData[7], 3),
+                Unpack8(mData[8], 0), Unpack8(mData[8], 1), Unpack8(mData[8], 2), Unpack8(mData[8], 3),
+                Unpack8(mData[9], 0)
+        };
+
+        std::array<int32_t, 9> Cg{
+                Unpack8(mData[9], 1), Unpack8(mData[9], 2), Unpack8(mData[9], 3),
+                Unpack8(mData[10], 0), Unpack8(mData[10], 1), Unpack8(mData[10], 2), Unpack8(mData[10], 3),
+                Unpack8(mData[11], 0), Unpack8(mData[11], 1)
+        };
+
+        std::array<glm::vec3, 9> coefficients;
+        for (size_t i = 0; i < 9; i++) {
+            coefficients[i] = glm::vec3(Dequantize(Y[i], lumaScale, LumaQuantizationBase),
+                                        Dequantize(Co[i], chromaScale, ChromaQuantizationBase),
+                                        Dequantize(Cg[i], chromaScale, ChromaQuantizationBase));
+        }
+
+        return SphericalHarmonics(coefficients);
+    }
+
+}
@@ -0,0 +1,76 @@
+//
+// Created by Pavlo Muratov on 2019-02-04.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_QUANTIZEDSPHERICALHARMONICS_HPP
+#define EARENDERER_QUANTIZEDSPHERICALHARMONICS_HPP
+
+#include "SphericalHarmonics.hpp"
+
+#include <array>
+#include <cstdint>
+#include <bitsery/bitsery.h>
+#include <bitsery/traits/array.h>
+
+namespace EARenderer {
+
+    /**
+     Compact representation of spherical harmonics holding colors in YCoCg space.
+
+     Luma (Y) coefficients are quantized to 16 bits, chroma (Co and Cg) coefficients are quantized to 8 bits.
+     Luma and chroma have individual scales equal to the largest absolute coefficient of the group,
+     so that nothing is clipped and the error of every coefficient is bounded by half of the quantization step.
+
+     Data occupies 48 bytes (3 RGBA32UI texels) instead of 108 bytes of the float representation:
+     [lumaScale, chromaScale, Y(L00, L11), Y(L10, L1_1)]
+     [Y(L21, L2_1), Y(L2_2, L20), Y(L22, 0), Co(L00, L11, L10, L1_1)]
+     [Co(L21, L2_1, L2_2, L20), Co(L22) Cg(L00, L11, L10), Cg(L1_1, L21, L2_1, L2_2), Cg(L20, L22, 0, 0)]
+     16 bit pairs store the first value in the most significant bits, as PackSnorm2x16 does in Packing.glsl.
+     8 bit quadruples store the first value in the most significant byte.
+     */
+    class QuantizedSphericalHarmonics {
+    public:
+        static constexpr float LumaQuantizationBase = 32767.0;
+        static constexpr float ChromaQuantizationBase = 127.0;
+
+    private:
+        std::array<uint32_t, 12> mData{};
+
+        static int32_t Quantize(float value, float scale, float base);
+
+        static float Dequantize(int32_t value, float scale, float base);
+
+    public:
+        QuantizedSphericalHarmonics() = default;
+
+        /**
+         @param sphericalHarmonics spherical harmonics with colors in YCoCg space
+         */
+        QuantizedSphericalHarmonics(const SphericalHarmonics &sphericalHarmonics);
+
+        float lumaScale() const;
+
+        float chromaScale() const;
+
+        /**
+         @return upper bound of the absolute error of any luma or chroma coefficient
+         */
+        float maximumError() const;
+
+        /**
+         @return restored spherical harmonics with colors in YCoCg space
+         */
+        SphericalHarmonics dequantized() const;
+
+        template<typename S>
+        void serialize(S &s) {
+            s.container4b(mData);
+        }
+    };
+
+    static_assert(sizeof(QuantizedSphericalHarmonics) == 48, "Quantized spherical harmonics must occupy exactly 3 RGBA32UI texels");
+
+}
+
+#endif //EARENDERER_QUANTIZEDSPHERICALHARMONICS_HPP
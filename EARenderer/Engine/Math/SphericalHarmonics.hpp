@@ -14,6 +14,7 @@
 #include <glm/vec3.hpp>
 #include <glm/gtc/constants.hpp>
 #include <cmath>
+#include <array>
 #include <bitsery/bitsery.h>
 #include <bitsery/adapter/stream.h>
 
@@ -59,6 +60,11 @@ namespace EARenderer {
 
         SphericalHarmonics(const glm::vec3 &direction, const Color &color);
 
+        /**
+         @param coefficients coefficients in L00, L11, L10, L1_1, L21, L2_1, L2_2, L20, L22 order
+         */
+        SphericalHarmonics(const std::array<glm::vec3, 9> &coefficients);
+
         const glm::vec3 &L00() const;
 
         const glm::vec3 &L11() const;
@@ -77,6 +83,11 @@ namespace EARenderer {
 
         const glm::vec3 &L22() const;
 
+        /**
+         @return coefficients in L00, L11, L10, L1_1, L21, L2_1, L2_2, L20, L22 order (same as GPU and serialization layout)
+         */
+        std::array<glm::vec3, 9> coefficients() const;
+
         void convolve();
 
         float magnitude() const;
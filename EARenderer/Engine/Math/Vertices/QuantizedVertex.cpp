@@ -0,0 +1,135 @@
+//
+// Created by Pavlo Muratov on 2019-02-14.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "QuantizedVertex.hpp"
+
+#include <glm/gtc/packing.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/geometric.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace EARenderer {
+
+    namespace {
+
+        constexpr uint16_t PositiveBitangentSign = 65535;
+
+        glm::vec2 SignNotZero(const glm::vec2 &v) {
+            return glm::vec2(v.x >= 0.0f ? 1.0f : -1.0f, v.y >= 0.0f ? 1.0f : -1.0f);
+        }
+
+        glm::vec3 NormalizedPositionInBox(const glm::vec3 &position, const AxisAlignedBox3D &bounds) {
+            glm::vec3 extent = bounds.max - bounds.min;
+            glm::vec3 normalized;
+            for (glm::length_t i = 0; i < 3; i++) {
+                normalized[i] = extent[i] > 0.0f ? (position[i] - bounds.min[i]) / extent[i] : 0.0f;
+            }
+            return glm::clamp(normalized, glm::vec3(0.0), glm::vec3(1.0));
+        }
+
+        float AngleInDegrees(const glm::vec3 &original, const glm::vec3 &restored) {
+            float length = glm::length(original);
+            if (length <= 0.0f) {
+                return 0.0;
+            }
+            float cosine = glm::clamp(glm::dot(original / length, glm::normalize(restored)), -1.0f, 1.0f);
+            return glm::degrees(std::acos(cosine));
+        }
+
+    }
+
+#pragma mark - Lifecycle
+
+    QuantizedVertex::QuantizedVertex(const Vertex1P1N2UV1T1BT &vertex, const AxisAlignedBox3D &bounds) {
+        glm::vec3 normalizedPosition = NormalizedPositionInBox(vertex.position, bounds);
+        bool isBitangentPositive = glm::dot(glm::cross(vertex.normal, vertex.tangent), vertex.bitangent) >= 0.0f;
+
+        position = glm::u16vec4(glm::packUnorm1x16(normalizedPosition.x),
+                glm::packUnorm1x16(normalizedPosition.y),
+                glm::packUnorm1x16(normalizedPosition.z),
+                isBitangentPositive ? PositiveBitangentSign : 0);
+
+        textureCoords = glm::u16vec2(glm::packHalf1x16(vertex.textureCoords.x), glm::packHalf1x16(vertex.textureCoords.y));
+        lightmapCoords = glm::u16vec2(glm::packUnorm1x16(vertex.lightmapCoords.x), glm::packUnorm1x16(vertex.lightmapCoords.y));
+        normal = OctahedralEncode(vertex.normal);
+        tangent = OctahedralEncode(vertex.tangent);
+    }
+
+#pragma mark - Public Interface
+
+    Vertex1P1N2UV1T1BT QuantizedVertex::dequantized(const AxisAlignedBox3D &bounds) const {
+        glm::vec3 normalizedPosition(glm::unpackUnorm1x16(position.x), glm::unpackUnorm1x16(position.y), glm::unpackUnorm1x16(position.z));
+        glm::vec3 restoredPosition = bounds.min + normalizedPosition * (bounds.max - bounds.min);
+
+        glm::vec3 restoredNormal = OctahedralDecode(normal);
+        glm::vec3 restoredTangent = OctahedralDecode(tangent);
+        float bitangentSign = position.w == PositiveBitangentSign ? 1.0f : -1.0f;
+
+        return Vertex1P1N2UV1T1BT(glm::vec4(restoredPosition, 1.0),
+                glm::vec3(glm::unpackHalf1x16(textureCoords.x), glm::unpackHalf1x16(textureCoords.y), 0.0),
+                glm::vec2(glm::unpackUnorm1x16(lightmapCoords.x), glm::unpackUnorm1x16(lightmapCoords.y)),
+                restoredNormal,
+                restoredTangent,
+                bitangentSign * glm::cross(restoredNormal, restoredTangent));
+    }
+
+    glm::i16vec2 QuantizedVertex::OctahedralEncode(const glm::vec3 &direction) {
+        float manhattanLength = std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z);
+        if (manhattanLength <= 0.0f) {
+            return glm::i16vec2(0);
+        }
+
+        // Project onto the octahedron, then fold the lower hemisphere over the diagonals
+        glm::vec3 projected = direction / manhattanLength;
+        glm::vec2 encoded(projected.x, projected.y);
+        if (projected.z < 0.0f) {
+            encoded = (glm::vec2(1.0) - glm::abs(glm::vec2(encoded.y, encoded.x))) * SignNotZero(encoded);
+        }
+
+        return glm::i16vec2(int16_t(glm::packSnorm1x16(encoded.x)), int16_t(glm::packSnorm1x16(encoded.y)));
+    }
+
+    glm::vec3 QuantizedVertex::OctahedralDecode(const glm::i16vec2 &encoded) {
+        glm::vec2 folded(glm::unpackSnorm1x16(uint16_t(encoded.x)), glm::unpackSnorm1x16(uint16_t(encoded.y)));
+        glm::vec3 direction(folded.x, folded.y, 1.0f - std::abs(folded.x) - std::abs(folded.y));
+
+        if (direction.z < 0.0f) {
+            glm::vec2 unfolded = (glm::vec2(1.0) - glm::abs(glm::vec2(direction.y, direction.x))) * SignNotZero(folded);
+            direction.x = unfolded.x;
+            direction.y = unfolded.y;
+        }
+
+        return glm::normalize(direction);
+    }
+
+    glm::mat4 QuantizedVertex::PositionDequantizationMatrix(const AxisAlignedBox3D &bounds) {
+        glm::mat4 translation = glm::translate(glm::mat4(1.0), bounds.min);
+        return glm::scale(translation, bounds.max - bounds.min);
+    }
+
+    QuantizedVertex::Error QuantizedVertex::MeasureError(const Vertex1P1N2UV1T1BT *vertices, size_t vertexCount, const AxisAlignedBox3D &bounds) {
+        Error error;
+        float diagonal = bounds.diagonal();
+
+        for (size_t i = 0; i < vertexCount; i++) {
+            const Vertex1P1N2UV1T1BT &original = vertices[i];
+            Vertex1P1N2UV1T1BT restored = QuantizedVertex(original, bounds).dequantized(bounds);
+
+            float positionError = glm::length(glm::vec3(original.position) - glm::vec3(restored.position));
+            error.position = std::max(error.position, diagonal > 0.0f ? positionError / diagonal : positionError);
+            error.normal = std::max(error.normal, AngleInDegrees(original.normal, restored.normal));
+            error.tangent = std::max(error.tangent, AngleInDegrees(original.tangent, restored.tangent));
+
+            glm::vec2 textureCoordsError = glm::abs(glm::vec2(original.textureCoords) - glm::vec2(restored.textureCoords));
+            glm::vec2 lightmapCoordsError = glm::abs(original.lightmapCoords - restored.lightmapCoords);
+            error.textureCoords = std::max({error.textureCoords, textureCoordsError.x, textureCoordsError.y});
+            error.lightmapCoords = std::max({error.lightmapCoords, lightmapCoordsError.x, lightmapCoordsError.y});
+        }
+
+        return error;
+    }
+
+}
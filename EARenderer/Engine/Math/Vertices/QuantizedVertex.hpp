@@ -0,0 +1,92 @@
+//
+// Created by Pavlo Muratov on 2019-02-14.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_QUANTIZEDVERTEX_HPP
+#define EARENDERER_QUANTIZEDVERTEX_HPP
+
+#include "Vertex1P1N2UV1T1BT.hpp"
+#include "AxisAlignedBox3D.hpp"
+
+#include <glm/gtc/type_precision.hpp>
+#include <glm/mat4x4.hpp>
+
+namespace EARenderer {
+
+    /**
+     Compact GPU representation of Vertex1P1N2UV1T1BT, 24 bytes instead of 72.
+
+     Position is quantized to 16 bit unsigned normalized values relative to the bounding box of the sub mesh,
+     w component holds the sign of the bitangent (0 for -1, 65535 for +1).
+     Texture coordinates are half floats since tiled textures use coordinates outside of [0, 1],
+     the third texture coordinate is dropped as no shader reads it.
+     Lightmap coordinates are 16 bit unsigned normalized values.
+     Normal and tangent are octahedral-encoded into pairs of 16 bit signed normalized values,
+     bitangent is restored as sign * cross(normal, tangent).
+     */
+    struct QuantizedVertex {
+        /**
+         Largest deviations of dequantized vertices from the original ones
+         */
+        struct Error {
+            // Relative to the diagonal of the bounding box
+            float position = 0.0;
+            // Degrees
+            float normal = 0.0;
+            float tangent = 0.0;
+            float textureCoords = 0.0;
+            float lightmapCoords = 0.0;
+        };
+
+        glm::u16vec4 position;
+        glm::u16vec2 textureCoords;
+        glm::u16vec2 lightmapCoords;
+        glm::i16vec2 normal;
+        glm::i16vec2 tangent;
+
+        QuantizedVertex() = default;
+
+        /**
+         @param vertex vertex to quantize
+         @param bounds bounding box of the sub mesh the vertex belongs to
+         */
+        QuantizedVertex(const Vertex1P1N2UV1T1BT &vertex, const AxisAlignedBox3D &bounds);
+
+        /**
+         @param bounds bounding box used for quantization
+         @return restored vertex, unit length normal, tangent and bitangent
+         */
+        Vertex1P1N2UV1T1BT dequantized(const AxisAlignedBox3D &bounds) const;
+
+        /**
+         @param direction unit vector
+         @return octahedral projection of the direction in signed normalized 16 bit values
+         */
+        static glm::i16vec2 OctahedralEncode(const glm::vec3 &direction);
+
+        static glm::vec3 OctahedralDecode(const glm::i16vec2 &encoded);
+
+        /**
+         Maps quantized positions back into the space of the sub mesh. Shaders get it premultiplied into the model matrix,
+         so that positions need no decoding. Normal matrix has to be derived from the original model matrix.
+
+         @param bounds bounding box used for quantization
+         @return scale and translation matrix
+         */
+        static glm::mat4 PositionDequantizationMatrix(const AxisAlignedBox3D &bounds);
+
+        /**
+         @param vertices vertices of a single sub mesh
+         @param vertexCount amount of vertices
+         @param bounds bounding box of the sub mesh
+         @return largest errors of quantization round trips
+         */
+        static Error MeasureError(const Vertex1P1N2UV1T1BT *vertices, size_t vertexCount, const AxisAlignedBox3D &bounds);
+    };
+
+    static_assert(sizeof(QuantizedVertex) == 24, "Quantized vertex must stay tightly packed");
+
+}
+
+#endif //EARENDERER_QUANTIZEDVERTEX_HPP
@@ -14,8 +14,10 @@
 #include <cmath>
 
 #include "GLNamedObject.hpp"
+#include "GLStateCache.hpp"
 #include "GLBufferWritingSession.hpp"
 #include "MemoryUtils.hpp"
+#include "MemoryTracker.hpp"
 
 namespace EARenderer {
 
@@ -27,6 +29,7 @@ namespace EARenderer {
         size_t mAlignment = 1;
         size_t mSize = 0;
         size_t mCount = 0;
+        TrackedAllocation mMemory{MemoryDomain::GPU};
 
     public:
 
@@ -44,7 +47,7 @@ namespace EARenderer {
                 throw std::invalid_argument("Buffer size cannot be 0, though it can be constructed without any data");
             }
 
-            glGenBuffers(1, &mName);
+            mName = GLStateCache::shared().backend().genBuffer();
             bind();
 
             size_t padding = Utils::Memory::Padding<DataType>(perObjectAlignment);
@@ -54,10 +57,11 @@ namespace EARenderer {
 
             mSize = totalBytes;
             mCount = count;
+            mMemory.resize(totalBytes);
 
             // Data is already aligned. Lucky!
             if (alignedObjectSize == objectSize || data == nullptr) {
-                glBufferData(mBindingPoint, totalBytes, data, mUsageMode);
+                GLStateCache::shared().backend().bufferData(mBindingPoint, totalBytes, data, mUsageMode);
                 return;
             }
 
@@ -66,12 +70,12 @@ namespace EARenderer {
             for (int i = 0; i < count; ++i) {
                 memcpy(alignedStorage + alignedObjectSize * i, data + i, objectSize);
             }
-            glBufferData(mBindingPoint, totalBytes, alignedStorage, mUsageMode);
+            GLStateCache::shared().backend().bufferData(mBindingPoint, totalBytes, alignedStorage, mUsageMode);
             delete[] (alignedStorage);
         }
 
         ~GLBuffer() override {
-            glDeleteBuffers(1, &mName);
+            GLStateCache::shared().backend().deleteBuffer(mName);
         }
 
         GLBuffer(GLBuffer &&that) = default;
@@ -99,7 +103,7 @@ namespace EARenderer {
 #pragma mark - Binding
 
         virtual void bind() const {
-            glBindBuffer(mBindingPoint, mName);
+            GLStateCache::shared().backend().bindBuffer(mBindingPoint, mName);
         }
 
 #pragma mark - Helpers
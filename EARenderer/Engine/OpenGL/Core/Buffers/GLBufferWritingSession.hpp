@@ -13,6 +13,7 @@
 #include "MemoryUtils.hpp"
 #include "StringUtils.hpp"
 #include "LogUtils.hpp"
+#include "GLStateCache.hpp"
 
 namespace EARenderer {
 
@@ -66,13 +67,14 @@ namespace EARenderer {
             }
 
             mBuffer->bind();
-            auto ptr = reinterpret_cast<DataType *>(glMapBufferRange(mBindingPoint, 0, mDataQueue.back().nextOffset, GL_MAP_WRITE_BIT));
+            auto &backend = GLStateCache::shared().backend();
+            auto ptr = reinterpret_cast<DataType *>(backend.mapBufferRange(mBindingPoint, 0, mDataQueue.back().nextOffset, GL_MAP_WRITE_BIT));
             size_t offset = 0;
             for (auto &location : mDataQueue) {
                 memcpy(ptr + offset, location.data, sizeof(DataType) * location.count);
                 offset = location.nextOffset;
             }
-            glUnmapBuffer(mBindingPoint);
+            backend.unmapBuffer(mBindingPoint);
         }
 
     };
@@ -9,6 +9,7 @@
 #include "GLFramebuffer.hpp"
 
 #include "StringUtils.hpp"
+#include "GLStateCache.hpp"
 
 #include <OpenGL/OpenGL.h>
 #include <vector>
@@ -27,7 +28,7 @@ namespace EARenderer {
             throw std::invalid_argument("Framebuffer's size must be greater than zero");
         }
 
-        glGenFramebuffers(1, &mName);
+        mName = GLStateCache::shared().backend().genFramebuffer();
         obtainHardwareLimits();
 
         std::vector<GLenum> colorAttachments{
@@ -41,7 +42,8 @@ namespace EARenderer {
     }
 
     GLFramebuffer::~GLFramebuffer() {
-        glDeleteFramebuffers(1, &mName);
+        GLStateCache::shared().forgetFramebuffer(mName);
+        GLStateCache::shared().backend().deleteFramebuffer(mName);
     }
 
 #pragma mark - Getters
@@ -51,7 +53,7 @@ namespace EARenderer {
     }
 
     bool GLFramebuffer::isComplete() const {
-        auto status = glCheckFramebufferStatus(mBindingPoint);
+        auto status = GLStateCache::shared().backend().checkFramebufferStatus(mBindingPoint);
         return status == GL_FRAMEBUFFER_COMPLETE;
     }
 
@@ -66,14 +68,14 @@ namespace EARenderer {
 #pragma mark - Binding
 
     void GLFramebuffer::bind() const {
-        glBindFramebuffer(mBindingPoint, mName);
+        GLStateCache::shared().bindFramebuffer(mBindingPoint, mName);
     }
 
 #pragma mark - Private helpers
 
     void GLFramebuffer::obtainHardwareLimits() {
-        glGetIntegerv(GL_MAX_COLOR_ATTACHMENTS, &mMaximumColorAttachments);
-        glGetIntegerv(GL_MAX_DRAW_BUFFERS, &mMaximumDrawBuffers);
+        mMaximumColorAttachments = GLStateCache::shared().backend().integer(GL_MAX_COLOR_ATTACHMENTS);
+        mMaximumDrawBuffers = GLStateCache::shared().backend().integer(GL_MAX_DRAW_BUFFERS);
     }
 
     void GLFramebuffer::setRequestedDrawBuffers() {
@@ -87,8 +89,8 @@ namespace EARenderer {
 
         std::sort(drawBuffers.begin(), drawBuffers.begin() + i);
 
-        glDrawBuffers((GLsizei) mRequestedAttachments.size(), drawBuffers.data());
-        glReadBuffer(GL_NONE);
+        GLStateCache::shared().drawBuffers((GLsizei) mRequestedAttachments.size(), drawBuffers.data());
+        GLStateCache::shared().backend().readBuffer(GL_NONE);
     }
 
     void GLFramebuffer::attachTextureToDepthAttachment(const GLTexture &texture, uint16_t mipLevel, int16_t layer) {
@@ -99,16 +101,17 @@ namespace EARenderer {
         bind();
 
         if (layer == AllLayers) {
-            glFramebufferTexture(mBindingPoint, GL_DEPTH_ATTACHMENT, texture.name(), mipLevel);
+            GLStateCache::shared().backend().framebufferTexture(mBindingPoint, GL_DEPTH_ATTACHMENT, texture.name(), mipLevel);
         } else {
-            glFramebufferTextureLayer(mBindingPoint, GL_DEPTH_ATTACHMENT, texture.name(), mipLevel, layer);
+            GLStateCache::shared().backend().framebufferTextureLayer(mBindingPoint, GL_DEPTH_ATTACHMENT, texture.name(), mipLevel, layer);
         }
 
         if (mRequestedAttachments.empty()) {
-            glDrawBuffer(GL_NONE);
+            GLenum none = GL_NONE;
+            GLStateCache::shared().drawBuffers(1, &none);
         }
 
-        glReadBuffer(GL_NONE);
+        GLStateCache::shared().backend().readBuffer(GL_NONE);
     }
 
     void GLFramebuffer::attachTextureToColorAttachment(const GLTexture &texture, ColorAttachment colorAttachment, uint16_t mipLevel, int16_t layer) {
@@ -158,9 +161,9 @@ namespace EARenderer {
         mTextureAttachmentMap[texture.name()] = attachmentMetadata;
 
         if (layer == AllLayers) {
-            glFramebufferTexture(mBindingPoint, glAttachment, texture.name(), mipLevel);
+            GLStateCache::shared().backend().framebufferTexture(mBindingPoint, glAttachment, texture.name(), mipLevel);
         } else {
-            glFramebufferTextureLayer(mBindingPoint, glAttachment, texture.name(), mipLevel, layer);
+            GLStateCache::shared().backend().framebufferTextureLayer(mBindingPoint, glAttachment, texture.name(), mipLevel, layer);
         }
 
         mRequestedAttachments.insert(glAttachment);
@@ -204,7 +207,7 @@ namespace EARenderer {
     void GLFramebuffer::attachRenderbuffer(const GLDepthRenderbuffer &renderbuffer) {
         bind();
         renderbuffer.bind();
-        glFramebufferRenderbuffer(mBindingPoint, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, renderbuffer.name());
+        GLStateCache::shared().backend().framebufferRenderbuffer(mBindingPoint, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, renderbuffer.name());
     }
 
     void GLFramebuffer::detachTexture(const GLTexture &texture) {
@@ -218,9 +221,9 @@ namespace EARenderer {
         AttachmentMetadata metadata = attachmentIt->second;
 
         if (metadata.layer == AllLayers) {
-            glFramebufferTexture(mBindingPoint, metadata.glColorAttachment, 0, 0);
+            GLStateCache::shared().backend().framebufferTexture(mBindingPoint, metadata.glColorAttachment, 0, 0);
         } else {
-            glFramebufferTextureLayer(mBindingPoint, metadata.glColorAttachment, 0, 0, 0);
+            GLStateCache::shared().backend().framebufferTextureLayer(mBindingPoint, metadata.glColorAttachment, 0, 0, 0);
         }
 
         mTextureAttachmentMap.erase(attachmentIt);
@@ -235,9 +238,9 @@ namespace EARenderer {
             auto attachmentMetadata = kvPair.second;
 
             if (attachmentMetadata.layer == AllLayers) {
-                glFramebufferTexture(mBindingPoint, attachmentMetadata.glColorAttachment, 0, 0);
+                GLStateCache::shared().backend().framebufferTexture(mBindingPoint, attachmentMetadata.glColorAttachment, 0, 0);
             } else {
-                glFramebufferTextureLayer(mBindingPoint, attachmentMetadata.glColorAttachment, 0, 0, 0);
+                GLStateCache::shared().backend().framebufferTextureLayer(mBindingPoint, attachmentMetadata.glColorAttachment, 0, 0, 0);
             }
 
             mRequestedAttachments.erase(attachmentMetadata.glColorAttachment);
@@ -263,13 +266,14 @@ namespace EARenderer {
         }
 
         bind();
-        glReadBuffer(fromAttachmentIt->second.glColorAttachment);
-        glDrawBuffer(toAttachmentIt->second.glColorAttachment);
+        GLStateCache::shared().backend().readBuffer(fromAttachmentIt->second.glColorAttachment);
+        GLStateCache::shared().drawBuffers(1, &toAttachmentIt->second.glColorAttachment);
 
         Rect2D srcRect(fromTexture.size());
         Rect2D dstRect(toTexture.size());
 
-        glBlitFramebuffer(srcRect.origin.x, srcRect.origin.y, srcRect.origin.x + srcRect.size.width, srcRect.origin.y + srcRect.size.height,
+        GLStateCache::shared().backend().blitFramebuffer(
+                srcRect.origin.x, srcRect.origin.y, srcRect.origin.x + srcRect.size.width, srcRect.origin.y + srcRect.size.height,
                 dstRect.origin.x, dstRect.origin.y, dstRect.origin.x + dstRect.size.width, dstRect.origin.y + dstRect.size.height,
                 GL_COLOR_BUFFER_BIT, useLinearFilter ? GL_LINEAR : GL_NEAREST);
     }
@@ -278,7 +282,7 @@ namespace EARenderer {
         using underlying = typename std::underlying_type<UnderlyingBuffer>::type;
         auto bitmask = static_cast<underlying>(bufferMask);
         bind();
-        glClear(bitmask);
+        GLStateCache::shared().clear(bitmask);
     }
 
 }
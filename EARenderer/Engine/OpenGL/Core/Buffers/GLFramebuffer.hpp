@@ -20,6 +20,7 @@
 #include "GLHDRTexture3D.hpp"
 #include "GLLDRTexture3D.hpp"
 #include "GLTextureCubemapArray.hpp"
+#include "GLStateCache.hpp"
 
 #include "Size2D.hpp"
 #include "Range.hpp"
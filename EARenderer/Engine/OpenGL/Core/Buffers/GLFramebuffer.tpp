@@ -20,7 +20,7 @@ namespace EARenderer {
 
         if (buffersToClear != UnderlyingBuffer::None) {
             using type = std::underlying_type<UnderlyingBuffer>::type;
-            glClear(static_cast<type>(buffersToClear));
+            GLStateCache::shared().clear(static_cast<type>(buffersToClear));
         }
     }
 
@@ -39,7 +39,7 @@ namespace EARenderer {
 
         if (buffersToClear != UnderlyingBuffer::None) {
             using type = std::underlying_type<UnderlyingBuffer>::type;
-            glClear(static_cast<type>(buffersToClear));
+            GLStateCache::shared().clear(static_cast<type>(buffersToClear));
         }
     }
 
@@ -99,7 +99,7 @@ namespace EARenderer {
 
         bind();
         mDrawBuffers.emplace_back(attachmentIt->second.glColorAttachment);
-        glDrawBuffers(GLsizei(mDrawBuffers.size()), mDrawBuffers.data());
+        GLStateCache::shared().drawBuffers(GLsizei(mDrawBuffers.size()), mDrawBuffers.data());
         mDrawBuffers.clear();
     }
 
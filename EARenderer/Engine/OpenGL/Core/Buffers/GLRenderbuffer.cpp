@@ -8,6 +8,8 @@
 
 #include "GLRenderbuffer.hpp"
 #include "StringUtils.hpp"
+#include "GLTexture.hpp"
+#include "GLStateCache.hpp"
 
 namespace EARenderer {
 
@@ -20,19 +22,20 @@ namespace EARenderer {
             throw std::invalid_argument("Renderbuffer's size must be greater than zero");
         }
 
-        glGenRenderbuffers(1, &mName);
+        mName = GLStateCache::shared().backend().genRenderbuffer();
         bind();
-        glRenderbufferStorage(GL_RENDERBUFFER, internalFormat, size.width, size.height);
+        GLStateCache::shared().backend().renderbufferStorage(GL_RENDERBUFFER, internalFormat, size.width, size.height);
+        mMemory.resize(size_t(size.width) * size_t(size.height) * GLTexture::BytesPerTexel(internalFormat));
     }
 
     GLRenderbuffer::~GLRenderbuffer() {
-        glDeleteRenderbuffers(1, &mName);
+        GLStateCache::shared().backend().deleteRenderbuffer(mName);
     }
 
 #pragma mark - Binding
 
     void GLRenderbuffer::bind() const {
-        glBindRenderbuffer(GL_RENDERBUFFER, mName);
+        GLStateCache::shared().backend().bindRenderbuffer(GL_RENDERBUFFER, mName);
     }
 
 #pragma mark - Getters
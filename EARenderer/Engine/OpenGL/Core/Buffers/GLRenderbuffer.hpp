@@ -11,12 +11,14 @@
 
 #include "GLNamedObject.hpp"
 #include "Size2D.hpp"
+#include "MemoryTracker.hpp"
 
 namespace EARenderer {
 
     class GLRenderbuffer : public GLNamedObject {
     private:
         Size2D mSize;
+        TrackedAllocation mMemory{MemoryDomain::GPU};
 
     protected:
         GLRenderbuffer(const Size2D &size, GLenum internalFormat);
@@ -30,7 +30,7 @@ namespace EARenderer {
 
         void bind() const {
             GLBuffer<DataType>::bind();
-            glTexBuffer(GL_TEXTURE_BUFFER, mInternalFormat, GLBuffer<DataType>::mName);
+            GLStateCache::shared().backend().texBuffer(GL_TEXTURE_BUFFER, mInternalFormat, GLBuffer<DataType>::mName);
         }
     };
 
@@ -5,6 +5,7 @@
 
 #include "GLUniformBuffer.hpp"
 #include "StringUtils.hpp"
+#include "GLStateCache.hpp"
 
 namespace EARenderer {
 
@@ -22,15 +23,11 @@ namespace EARenderer {
     GLUniformBuffer::GLUniformBuffer() : GLUniformBuffer(obtainMaximumSize()) {}
 
     GLint GLUniformBuffer::obtainMandatoryAlignment() const {
-        GLint alignment = 1;
-        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
-        return alignment;
+        return GLStateCache::shared().backend().integer(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT);
     }
 
     GLint GLUniformBuffer::obtainMaximumSize() const {
-        GLint size = 1;
-        glGetIntegerv(GL_MAX_UNIFORM_BLOCK_SIZE, &size);
-        return size;
+        return GLStateCache::shared().backend().integer(GL_MAX_UNIFORM_BLOCK_SIZE);
     }
 
 }
\ No newline at end of file
@@ -18,6 +18,7 @@
 #include "GLVertexArrayBuffer.hpp"
 #include "GLElementArrayBuffer.hpp"
 #include "GLVertexAttribute.hpp"
+#include "GLStateCache.hpp"
 
 namespace EARenderer {
 
@@ -35,12 +36,13 @@ namespace EARenderer {
                 mIndexBuffer->bind();
             }
 
+            auto &backend = GLStateCache::shared().backend();
             GLuint offset = 0;
             for (GLuint location = 0; location < attributeCount; location++) {
-                glEnableVertexAttribArray(location);
+                backend.enableVertexAttribArray(location);
                 const GLVertexAttribute &attribute = attributes[location];
-                glVertexAttribPointer(location, attribute.components, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void *>(offset));
-                glVertexAttribDivisor(location, attribute.divisor);
+                backend.vertexAttribPointer(location, attribute.components, attribute.type, attribute.normalized, sizeof(Vertex), reinterpret_cast<void *>(offset));
+                backend.vertexAttribDivisor(location, attribute.divisor);
                 offset += attribute.bytes;
             }
         }
@@ -69,7 +71,7 @@ namespace EARenderer {
         GLVertexArray(const Vertex *vertices, size_t vertexCount, const GLVertexAttribute *attributes, size_t attributeCount)
                 : mVertexBuffer(std::make_unique<GLVertexArrayBuffer<Vertex>>(vertices, vertexCount)) {
 
-            glGenVertexArrays(1, &mName);
+            mName = GLStateCache::shared().backend().genVertexArray();
             hookUpBuffers(attributes, attributeCount);
         }
 
@@ -77,12 +79,13 @@ namespace EARenderer {
                 : mVertexBuffer(std::make_unique<GLVertexArrayBuffer<Vertex>>(vertices, vertexCount)),
                   mIndexBuffer(std::make_unique<GLElementArrayBuffer>(indices, indexCount)) {
 
-            glGenVertexArrays(1, &mName);
+            mName = GLStateCache::shared().backend().genVertexArray();
             hookUpBuffers(attributes, attributeCount);
         }
 
         ~GLVertexArray() override {
-            glDeleteVertexArrays(1, &mName);
+            GLStateCache::shared().forgetVertexArray(mName);
+            GLStateCache::shared().backend().deleteVertexArray(mName);
         }
 
         GLVertexArray(GLVertexArray &&that) = default;
@@ -92,7 +95,7 @@ namespace EARenderer {
 #pragma mark - Binbable
 
         void bind() const {
-            glBindVertexArray(mName);
+            GLStateCache::shared().bindVertexArray(mName);
         }
 
         template<typename T, template<class...> class AttributeContainer>
@@ -100,15 +103,16 @@ namespace EARenderer {
             bind();
             buffer.bind();
 
+            auto &backend = GLStateCache::shared().backend();
             GLuint offset = 0;
             for (auto &attribute : attributes) {
                 if (attribute.location == GLVertexAttribute::LocationAutomatic) {
                     throw std::logic_error("You're trying to use external buffer with attribute's location set to Automatic which will probably override attributes taken from internal buffer and replace data at location 0 and so forth");
                 }
 
-                glEnableVertexAttribArray(attribute.location);
-                glVertexAttribPointer(attribute.location, attribute.components, GL_FLOAT, GL_FALSE, sizeof(T), reinterpret_cast<void *>(offset));
-                glVertexAttribDivisor(attribute.location, attribute.divisor);
+                backend.enableVertexAttribArray(attribute.location);
+                backend.vertexAttribPointer(attribute.location, attribute.components, attribute.type, attribute.normalized, sizeof(T), reinterpret_cast<void *>(offset));
+                backend.vertexAttribDivisor(attribute.location, attribute.divisor);
                 offset += attribute.bytes;
             }
         }
@@ -24,10 +24,10 @@ namespace EARenderer {
 
     GLVertexAttribute::GLVertexAttribute(GLint sizeInBytes, GLint componentCount, GLint divisor, GLint location)
             :
+            location(location),
             bytes(sizeInBytes),
             components(componentCount),
-            divisor(divisor),
-            location(location) {
+            divisor(divisor) {
     }
 
     GLVertexAttribute GLVertexAttribute::UniqueAttribute(GLint sizeInBytes, GLint componentCount, GLint location) {
@@ -38,4 +38,11 @@ namespace EARenderer {
         return GLVertexAttribute(sizeInBytes, componentCount, 1, location);
     }
 
+    GLVertexAttribute GLVertexAttribute::PackedAttribute(GLint sizeInBytes, GLint componentCount, GLenum type, GLboolean normalized, GLint location) {
+        GLVertexAttribute attribute(sizeInBytes, componentCount, 0, location);
+        attribute.type = type;
+        attribute.normalized = normalized;
+        return attribute;
+    }
+
 }
@@ -10,6 +10,7 @@
 #define GLVertexAttribute_hpp
 
 #include <OpenGL/OpenGL.h>
+#include <OpenGL/gl3.h>
 
 namespace EARenderer {
 
@@ -19,7 +20,11 @@ namespace EARenderer {
         GLint location = LocationAutomatic;
         GLint bytes;
         GLint components;
-        GLint divisor;
+        GLint divisor = 0;
+        // Type of components as stored in the buffer
+        GLenum type = GL_FLOAT;
+        // Whether integer components are mapped to [0, 1] or [-1, 1] when read by shaders
+        GLboolean normalized = GL_FALSE;
 
         GLVertexAttribute(GLint sizeInBytes, GLint componentCount);
 
@@ -42,6 +47,17 @@ namespace EARenderer {
          @return attribute with divisor parameter set to 1
          */
         static GLVertexAttribute SharedAttribute(GLint sizeInBytes, GLint componentCount, GLint location = LocationAutomatic);
+
+        /**
+         Factory function providing per-vertex attribute stored in a compact form, e.g. half floats or normalized integers
+
+         @param sizeInBytes attribute's size in bytes, including padding
+         @param componentCount number of attribute's components
+         @param type type of a single component, e.g. GL_HALF_FLOAT or GL_UNSIGNED_SHORT
+         @param normalized whether integer components should be mapped to [0, 1] or [-1, 1]
+         @return attribute with divisor parameter set to 0
+         */
+        static GLVertexAttribute PackedAttribute(GLint sizeInBytes, GLint componentCount, GLenum type, GLboolean normalized, GLint location = LocationAutomatic);
     };
 
 }
@@ -8,6 +8,7 @@
 
 #include "GLTextureUnitManager.hpp"
 #include "StringUtils.hpp"
+#include "GLStateCache.hpp"
 
 namespace EARenderer {
 
@@ -19,7 +20,7 @@ namespace EARenderer {
     }
 
     GLTextureUnitManager::GLTextureUnitManager() {
-        glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &mMaximumTextureUnits);
+        mMaximumTextureUnits = GLStateCache::shared().backend().integer(GL_MAX_TEXTURE_IMAGE_UNITS);
     }
 
 #pragma mark - Getters
@@ -51,17 +52,11 @@ namespace EARenderer {
             throw std::invalid_argument(string_format("Texture unit %d exceeds maximum texture unit index %d", unit, mMaximumTextureUnits - 1));
         }
 
-        auto it = mBoundSamplers.find(unit);
-        if (it != mBoundSamplers.end() && it->second == sampler.name()) {
-            return;
-        }
-
-        glBindSampler(unit, sampler.name());
-        mBoundSamplers[unit] = sampler.name();
+        GLStateCache::shared().bindSampler(unit, sampler.name());
     }
 
     void GLTextureUnitManager::activateUnit(TextureUnit unit) {
-        glActiveTexture(GL_TEXTURE0 + unit);
+        GLStateCache::shared().activeTexture(GL_TEXTURE0 + unit);
         mActiveTextureUnit = unit;
     }
 
@@ -76,19 +71,15 @@ namespace EARenderer {
 
         if (name > 0 && bindingPoint != texture.bindingPoint()) {
             // Unbind previous texture
-            glBindTexture(bindingPoint, 0);
+            GLStateCache::shared().bindTexture(bindingPoint, 0);
         }
 
-        glBindTexture(texture.bindingPoint(), texture.name());
+        GLStateCache::shared().bindTexture(texture.bindingPoint(), texture.name());
         mBoundTextures[mActiveTextureUnit] = std::make_pair(texture.name(), texture.bindingPoint());
     }
 
     void GLTextureUnitManager::unbindAllSamplers() {
-        for (auto &unitSamplerPair : mBoundSamplers) {
-            TextureUnit unit = unitSamplerPair.first;
-            glBindSampler(unit, 0);
-        }
-        mBoundSamplers.clear();
+        GLStateCache::shared().unbindAllSamplers();
     }
 
 }
@@ -26,7 +26,6 @@ namespace EARenderer {
     private:
         std::unordered_map<TextureUnit, std::pair<ObjectName, BindingPoint>> mBoundTextures;
         std::unordered_map<ObjectName, std::pair<TextureUnit, BindingPoint>> mBoundTexturesReverse;
-        std::unordered_map<TextureUnit, ObjectName> mBoundSamplers;
 
         GLint mMaximumTextureUnits = 0;
         TextureUnit mActiveTextureUnit = 0;
@@ -7,6 +7,7 @@
 //
 
 #include "GLViewport.hpp"
+#include "GLStateCache.hpp"
 
 #include <OpenGL/gl3.h>
 #include <glm/gtx/transform.hpp>
@@ -47,7 +48,7 @@ namespace EARenderer {
 #pragma mark - Other methods
 
     void GLViewport::apply() const {
-        glViewport(mFrame.origin.x, mFrame.origin.y, mFrame.size.width, mFrame.size.height);
+        GLStateCache::shared().viewport(mFrame.origin.x, mFrame.origin.y, mFrame.size.width, mFrame.size.height);
     }
 
     glm::vec2 GLViewport::NDCFromPoint(const glm::vec2 &screenPoint) const {
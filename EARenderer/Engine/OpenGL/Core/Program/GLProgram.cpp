@@ -10,9 +10,13 @@
 #include "FileManager.hpp"
 #include "StringUtils.hpp"
 #include "GLTextureUnitManager.hpp"
+#include "GLStateCache.hpp"
 
 #include <sstream>
 #include <regex>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
 
 #include <glm/gtc/type_ptr.hpp>
 
@@ -20,13 +24,46 @@ namespace EARenderer {
 
 #pragma mark - Lifecycle
 
-    GLProgram::GLProgram(const std::string &vertexSourceName, const std::string &fragmentSourceName, const std::string &geometrySourceName)
-            : GLNamedObject(glCreateProgram()),
-              mVertexShader(vertexSourceName.empty() ? nullptr : new GLShader(FileManager::shared().resourceRootPath() + vertexSourceName, GL_VERTEX_SHADER)),
-              mFragmentShader(fragmentSourceName.empty() ? nullptr : new GLShader(FileManager::shared().resourceRootPath() + fragmentSourceName, GL_FRAGMENT_SHADER)),
-              mGeometryShader(geometrySourceName.empty() ? nullptr : new GLShader(FileManager::shared().resourceRootPath() + geometrySourceName, GL_GEOMETRY_SHADER)) {
+    GLProgram::GLProgram(const std::string &vertexSourceName, const std::string &fragmentSourceName, const std::string &geometrySourceName,
+            const GLSLPreprocessor::Defines &defines)
+            : GLNamedObject(GLStateCache::shared().backend().createProgram()) {
+
+        auto preprocess = [&](const std::string &sourceName) -> std::shared_ptr<const GLSLPreprocessor::Output> {
+            if (sourceName.empty()) {
+                return nullptr;
+            }
+            return GLSLPreprocessor::shared().preprocess(FileManager::shared().resourceRootPath() + sourceName, defines);
+        };
+
+        auto vertexSource = preprocess(vertexSourceName);
+        auto fragmentSource = preprocess(fragmentSourceName);
+        auto geometrySource = preprocess(geometrySourceName);
+        std::array<const GLSLPreprocessor::Output *, 3> stageSources{vertexSource.get(), fragmentSource.get(), geometrySource.get()};
+
+        auto &binaryCache = GLProgramBinaryCache::shared();
+        if (binaryCache.isEnabled() && !binaryCache.hasDriverIdentity()) {
+            auto &backend = GLStateCache::shared().backend();
+            binaryCache.setDriverIdentity(
+                    reinterpret_cast<const char *>(backend.string(GL_VENDOR)),
+                    reinterpret_cast<const char *>(backend.string(GL_RENDERER)),
+                    reinterpret_cast<const char *>(backend.string(GL_VERSION))
+            );
+        }
+
+        uint64_t binaryKey = binaryCache.key({stageSources.begin(), stageSources.end()}, defines);
+
+        auto start = std::chrono::high_resolution_clock::now();
+
+        if (loadBinary(binaryKey)) {
+            auto duration = std::chrono::high_resolution_clock::now() - start;
+            binaryCache.recordLoading(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+        } else {
+            compileAndLink(stageSources);
+            storeBinary(binaryKey);
+            auto duration = std::chrono::high_resolution_clock::now() - start;
+            binaryCache.recordCompilation(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+        }
 
-        link();
         bind();
         obtainVertexAttributes();
         obtainUniforms();
@@ -34,7 +71,8 @@ namespace EARenderer {
     }
 
     GLProgram::~GLProgram() {
-        glDeleteProgram(mName);
+        GLStateCache::shared().forgetProgram(mName);
+        GLStateCache::shared().backend().deleteProgram(mName);
 
         delete mVertexShader;
         delete mGeometryShader;
@@ -43,27 +81,107 @@ namespace EARenderer {
 
 #pragma mark - Private helper methods
 
+    bool GLProgram::loadBinary(uint64_t key) {
+        auto &binaryCache = GLProgramBinaryCache::shared();
+
+        GLProgramBinaryCache::Binary binary;
+        if (!binaryCache.load(key, binary)) {
+            return false;
+        }
+
+        auto &backend = GLStateCache::shared().backend();
+        backend.programBinary(mName, binary.format, binary.data.data(), GLsizei(binary.data.size()));
+
+        GLint isLinked = backend.programInteger(mName, GL_LINK_STATUS);
+
+        // Driver is free to reject binaries, e.g. after an update that didn't change its version string
+        if (!isLinked) {
+            binaryCache.reject(key);
+            return false;
+        }
+
+        return true;
+    }
+
+    void GLProgram::compileAndLink(const std::array<const GLSLPreprocessor::Output *, 3> &stageSources) {
+        mVertexShader = stageSources[0] ? new GLShader(*stageSources[0], GL_VERTEX_SHADER) : nullptr;
+        mFragmentShader = stageSources[1] ? new GLShader(*stageSources[1], GL_FRAGMENT_SHADER) : nullptr;
+        mGeometryShader = stageSources[2] ? new GLShader(*stageSources[2], GL_GEOMETRY_SHADER) : nullptr;
+
+        if (GLProgramBinaryCache::shared().isEnabled()) {
+            GLStateCache::shared().backend().programParameteri(mName, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        }
+
+        link();
+    }
+
+    void GLProgram::storeBinary(uint64_t key) {
+        auto &binaryCache = GLProgramBinaryCache::shared();
+        if (!binaryCache.isEnabled()) {
+            return;
+        }
+
+        // Some drivers support no binary formats at all and report zero length
+        auto &backend = GLStateCache::shared().backend();
+        GLint length = backend.programInteger(mName, GL_PROGRAM_BINARY_LENGTH);
+        if (length <= 0) {
+            return;
+        }
+
+        GLProgramBinaryCache::Binary binary;
+        binary.data.resize(length);
+
+        GLsizei writtenLength = 0;
+        GLenum format = 0;
+        backend.getProgramBinary(mName, length, &writtenLength, &format, binary.data.data());
+
+        binary.data.resize(writtenLength);
+        binary.format = format;
+        binaryCache.store(key, binary);
+    }
+
+    bool GLProgram::shouldUploadUniform(UniformHandle handle, const void *value, size_t size) {
+        UniformShadow &shadow = mUniformShadows[handle.index];
+
+        // Values of unknown size are always uploaded
+        if (size > shadow.capacity) {
+            shadow.validSize = 0;
+            mUniformStatistics.uploads++;
+            return true;
+        }
+
+        uint8_t *shadowValue = mUniformShadowStorage.data() + shadow.offset;
+        if (size <= shadow.validSize && std::memcmp(shadowValue, value, size) == 0) {
+            mUniformStatistics.skippedUploads++;
+            return false;
+        }
+
+        std::memcpy(shadowValue, value, size);
+        shadow.validSize = std::max(shadow.validSize, size);
+        mUniformStatistics.uploads++;
+        return true;
+    }
+
     void GLProgram::link() {
-        glAttachShader(mName, mVertexShader->name());
+        auto &backend = GLStateCache::shared().backend();
+        backend.attachShader(mName, mVertexShader->name());
 
-        if (mFragmentShader) {glAttachShader(mName, mFragmentShader->name());}
-        if (mGeometryShader) {glAttachShader(mName, mGeometryShader->name());}
+        if (mFragmentShader) {backend.attachShader(mName, mFragmentShader->name());}
+        if (mGeometryShader) {backend.attachShader(mName, mGeometryShader->name());}
 
-        glLinkProgram(mName);
+        backend.linkProgram(mName);
 
-        GLint isLinked = 0;
-        glGetProgramiv(mName, GL_LINK_STATUS, &isLinked);
+        GLint isLinked = backend.programInteger(mName, GL_LINK_STATUS);
 
         if (isLinked) {
             return;
         }
 
-        GLint infoLength = 0;
-        glGetProgramiv(mName, GL_INFO_LOG_LENGTH, &infoLength);
+        GLint infoLength = backend.programInteger(mName, GL_INFO_LOG_LENGTH);
 
         if (infoLength > 1) {
             std::vector<char> infoChars(infoLength);
-            glGetProgramInfoLog(mName, infoLength, nullptr, infoChars.data());
+            backend.programInfoLog(mName, infoLength, nullptr, infoChars.data());
             std::string infoLog(infoChars.data());
 
             if (!isLinked) {
@@ -77,31 +195,31 @@ namespace EARenderer {
     }
 
     void GLProgram::obtainVertexAttributes() {
-        GLint count = 0;
-        glGetProgramiv(mName, GL_ACTIVE_ATTRIBUTES, &count);
+        auto &backend = GLStateCache::shared().backend();
+        GLint count = backend.programInteger(mName, GL_ACTIVE_ATTRIBUTES);
 
         for (GLuint index = 0; index < count; index++) {
             std::vector<GLchar> attributeNameChars(128);
             GLint size;
             GLenum type;
-            glGetActiveAttrib(mName, index, static_cast<GLsizei>(attributeNameChars.size()), nullptr, &size, &type, attributeNameChars.data());
+            backend.activeAttrib(mName, index, static_cast<GLsizei>(attributeNameChars.size()), &size, &type, attributeNameChars.data());
             std::string name(attributeNameChars.data());
 //            GLint location = glGetAttribLocation(mName, &name[0]);
         }
     }
 
     void GLProgram::obtainUniforms() {
-        GLint count = 0;
-        glGetProgramiv(mName, GL_ACTIVE_UNIFORMS, &count);
+        auto &backend = GLStateCache::shared().backend();
+        GLint count = backend.programInteger(mName, GL_ACTIVE_UNIFORMS);
 
         GLint textureUnit = 0;
         for (GLuint index = 0; index < count; index++) {
             std::vector<GLchar> uniformNameChars(128);
             GLint size;
             GLenum type;
-            glGetActiveUniform(mName, index, static_cast<GLsizei>(uniformNameChars.size()), nullptr, &size, &type, uniformNameChars.data());
+            backend.activeUniform(mName, index, static_cast<GLsizei>(uniformNameChars.size()), &size, &type, uniformNameChars.data());
             std::string name(uniformNameChars.data());
-            GLint location = glGetUniformLocation(mName, &name[0]);
+            GLint location = backend.uniformLocation(mName, &name[0]);
 
             GLUniform uniform = GLUniform(location, size, type, name);
 
@@ -109,23 +227,29 @@ namespace EARenderer {
                 if (textureUnit >= GLTextureUnitManager::Shared().maximumTextureUnits()) {
                     throw std::runtime_error(string_format("Exceeded the number of available texture units (%d)", mAvailableTextureUnits));
                 }
-                glUniform1i(uniform.location(), textureUnit);
+                backend.uniform1i(uniform.location(), textureUnit);
                 uniform.setTextureUnit(textureUnit);
 
                 textureUnit++;
             }
 
-            uint32_t crc = ctcrc32(name);
-            mUniforms.insert(std::make_pair(crc, uniform));
+            UniformShadow shadow;
+            shadow.offset = mUniformShadowStorage.size();
+            shadow.capacity = uniform.elementSize() * std::max(size, 1);
+            mUniformShadowStorage.resize(shadow.offset + shadow.capacity);
+
+            mUniformIndices.emplace_back(ctcrc32(name), uint32_t(mUniforms.size()));
+            mUniforms.push_back(uniform);
+            mUniformShadows.push_back(shadow);
         }
+
+        std::sort(mUniformIndices.begin(), mUniformIndices.end());
     }
 
     void GLProgram::obtainUniformBlocks() {
-        GLint numBlocks;
-        glGetProgramiv(mName, GL_ACTIVE_UNIFORM_BLOCKS, &numBlocks);
-
-        GLint maxUBOBindings;
-        glGetIntegerv(GL_MAX_UNIFORM_BUFFER_BINDINGS, &maxUBOBindings);
+        auto &backend = GLStateCache::shared().backend();
+        GLint numBlocks = backend.programInteger(mName, GL_ACTIVE_UNIFORM_BLOCKS);
+        GLint maxUBOBindings = backend.integer(GL_MAX_UNIFORM_BUFFER_BINDINGS);
 
         std::vector<std::string> nameList;
         nameList.reserve(numBlocks);
@@ -135,26 +259,21 @@ namespace EARenderer {
                 throw std::range_error(string_format("Exceeded maximum number of Uniform Buffer Object bindings (%d)", maxUBOBindings));
             }
 
-            GLint nameLen;
-            glGetActiveUniformBlockiv(mName, blockIndex, GL_UNIFORM_BLOCK_NAME_LENGTH, &nameLen);
+            GLint nameLen = backend.activeUniformBlockInteger(mName, blockIndex, GL_UNIFORM_BLOCK_NAME_LENGTH);
 
             std::vector<GLchar> name;
             name.resize(nameLen);
-            glGetActiveUniformBlockName(mName, blockIndex, nameLen, nullptr, &name[0]);
+            backend.activeUniformBlockName(mName, blockIndex, nameLen, &name[0]);
 
             nameList.emplace_back();
             nameList.back().assign(name.begin(), name.end() - 1); // Remove the null terminator.
 
             GLuint binding = uniformBlockBinding(nameList.back(), maxUBOBindings);
-            glUniformBlockBinding(mName, blockIndex, binding);
-
-            auto testIdx = glGetUniformBlockIndex(mName, nameList.back().c_str());
+            backend.uniformBlockBinding(mName, blockIndex, binding);
 
             GLUniformBlock block(nameList.back(), blockIndex, binding);
             CRC32 key = ctcrc32(nameList.back());
             mUniformBlocks.insert(std::pair<CRC32, GLUniformBlock>(key, block));
-
-            printf("Program %d | UBO Name %s | UBO Index %d | Test Index %d |  UBO Binding %d \n", mName, nameList.back().c_str(), blockIndex, testIdx, binding);
         }
     }
 
@@ -171,6 +290,10 @@ namespace EARenderer {
         std::swap(mFragmentShader, that.mFragmentShader);
         std::swap(mGeometryShader, that.mGeometryShader);
         std::swap(mUniforms, that.mUniforms);
+        std::swap(mUniformIndices, that.mUniformIndices);
+        std::swap(mUniformShadows, that.mUniformShadows);
+        std::swap(mUniformShadowStorage, that.mUniformShadowStorage);
+        std::swap(mUniformStatistics, that.mUniformStatistics);
     }
 
     void swap(GLProgram &lhs, GLProgram &rhs) {
@@ -180,7 +303,7 @@ namespace EARenderer {
 #pragma mark - Bindable
 
     void GLProgram::bind() const {
-        glUseProgram(mName);
+        GLStateCache::shared().useProgram(mName);
     }
 
 #pragma mark - Protected
@@ -194,11 +317,23 @@ namespace EARenderer {
     }
 
     const GLUniform &GLProgram::uniformByNameCRC32(CRC32 crc32) {
-        auto it = mUniforms.find(crc32);
-        if (it == mUniforms.end()) {
+        return uniform(uniformHandle(crc32));
+    }
+
+    GLProgram::UniformHandle GLProgram::uniformHandle(CRC32 crc32) const {
+        auto it = std::lower_bound(mUniformIndices.begin(), mUniformIndices.end(), crc32, [](auto &entry, CRC32 value) {
+            return entry.first < value;
+        });
+
+        if (it == mUniformIndices.end() || it->first != crc32) {
             throw std::invalid_argument("Uniform couldn't be found");
         }
-        return it->second;
+
+        return UniformHandle{it->second};
+    }
+
+    const GLUniform &GLProgram::uniform(UniformHandle handle) const {
+        return mUniforms[handle.index];
     }
 
     const GLUniformBlock &GLProgram::uniformBlockByNameCRC32(CRC32 crc32) {
@@ -227,9 +362,79 @@ namespace EARenderer {
         }
     }
 
+    void GLProgram::setUniform1f(UniformHandle handle, GLfloat value) {
+        if (shouldUploadUniform(handle, &value, sizeof(value))) {
+            GLStateCache::shared().backend().uniform1f(mUniforms[handle.index].location(), value);
+        }
+    }
+
+    void GLProgram::setUniform1i(UniformHandle handle, GLint value) {
+        if (shouldUploadUniform(handle, &value, sizeof(value))) {
+            GLStateCache::shared().backend().uniform1i(mUniforms[handle.index].location(), value);
+        }
+    }
+
+    void GLProgram::setUniform1ui(UniformHandle handle, GLuint value) {
+        if (shouldUploadUniform(handle, &value, sizeof(value))) {
+            GLStateCache::shared().backend().uniform1ui(mUniforms[handle.index].location(), value);
+        }
+    }
+
+    void GLProgram::setUniform1fv(UniformHandle handle, GLsizei count, const GLfloat *values) {
+        if (shouldUploadUniform(handle, values, sizeof(GLfloat) * count)) {
+            GLStateCache::shared().backend().uniform1fv(mUniforms[handle.index].location(), count, values);
+        }
+    }
+
+    void GLProgram::setUniform2fv(UniformHandle handle, GLsizei count, const GLfloat *values) {
+        if (shouldUploadUniform(handle, values, sizeof(GLfloat) * 2 * count)) {
+            GLStateCache::shared().backend().uniform2fv(mUniforms[handle.index].location(), count, values);
+        }
+    }
+
+    void GLProgram::setUniform3fv(UniformHandle handle, GLsizei count, const GLfloat *values) {
+        if (shouldUploadUniform(handle, values, sizeof(GLfloat) * 3 * count)) {
+            GLStateCache::shared().backend().uniform3fv(mUniforms[handle.index].location(), count, values);
+        }
+    }
+
+    void GLProgram::setUniform4fv(UniformHandle handle, GLsizei count, const GLfloat *values) {
+        if (shouldUploadUniform(handle, values, sizeof(GLfloat) * 4 * count)) {
+            GLStateCache::shared().backend().uniform4fv(mUniforms[handle.index].location(), count, values);
+        }
+    }
+
+    void GLProgram::setUniform3iv(UniformHandle handle, GLsizei count, const GLint *values) {
+        if (shouldUploadUniform(handle, values, sizeof(GLint) * 3 * count)) {
+            GLStateCache::shared().backend().uniform3iv(mUniforms[handle.index].location(), count, values);
+        }
+    }
+
+    void GLProgram::setUniformMatrix4fv(UniformHandle handle, GLsizei count, GLboolean transpose, const GLfloat *values) {
+        // Shadows hold matrices in the column-major layout OpenGL keeps them in,
+        // so row-major matrices are transposed up front and compared like any other value
+        if (transpose) {
+            mTransposedMatrices.resize(size_t(count) * 16);
+            for (GLsizei i = 0; i < count; i++) {
+                const GLfloat *matrix = values + i * 16;
+                GLfloat *transposedMatrix = mTransposedMatrices.data() + i * 16;
+                for (size_t column = 0; column < 4; column++) {
+                    for (size_t row = 0; row < 4; row++) {
+                        transposedMatrix[column * 4 + row] = matrix[row * 4 + column];
+                    }
+                }
+            }
+            values = mTransposedMatrices.data();
+        }
+
+        if (shouldUploadUniform(handle, values, sizeof(GLfloat) * 16 * count)) {
+            GLStateCache::shared().backend().uniformMatrix4fv(mUniforms[handle.index].location(), count, GL_FALSE, values);
+        }
+    }
+
     void GLProgram::setUniformBuffer(CRC32 uniformNameCRC32, const GLUniformBuffer &UBO, const GLUBODataLocation& location) {
         const GLUniformBlock& block = uniformBlockByNameCRC32(uniformNameCRC32);
-        glBindBufferRange(GL_UNIFORM_BUFFER, block.binding(), UBO.name(), location.offset, location.dataSize);
+        GLStateCache::shared().backend().bindBufferRange(GL_UNIFORM_BUFFER, block.binding(), UBO.name(), location.offset, location.dataSize);
     }
 
 #pragma mark - Public
@@ -247,8 +452,8 @@ namespace EARenderer {
     bool GLProgram::validateState() const {
         GLsizei loglen = 0;
         GLchar logbuffer[1000];
-        glValidateProgram(mName);
-        glGetProgramInfoLog(mName, sizeof(logbuffer), &loglen, logbuffer);
+        GLStateCache::shared().backend().validateProgram(mName);
+        GLStateCache::shared().backend().programInfoLog(mName, sizeof(logbuffer), &loglen, logbuffer);
         if (loglen > 0) {
             printf("OpenGL Program %d is invalid: \n %s\n", mName, logbuffer);
             return false;
@@ -258,4 +463,8 @@ namespace EARenderer {
         }
     }
 
+    const GLProgram::UniformStatistics &GLProgram::uniformStatistics() const {
+        return mUniformStatistics;
+    }
+
 }
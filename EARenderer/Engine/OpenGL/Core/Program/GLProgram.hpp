@@ -26,6 +26,8 @@
 #include "GLUniform.hpp"
 #include "GLUniformBlock.hpp"
 #include "GLShader.hpp"
+#include "GLSLPreprocessor.hpp"
+#include "GLProgramBinaryCache.hpp"
 #include "GLSampler.hpp"
 #include "GLTexture2D.hpp"
 #include "GLTextureCubemap.hpp"
@@ -33,23 +35,54 @@
 #include "GLTexture2DArray.hpp"
 #include "GLBufferTexture.hpp"
 #include "GLUniformBuffer.hpp"
+#include "GLTextureUnitManager.hpp"
 #include "CRC32.hpp"
 
 namespace EARenderer {
 
     class GLProgram : public GLNamedObject {
+    public:
+        struct UniformStatistics {
+            uint64_t uploads = 0;
+            uint64_t skippedUploads = 0;
+        };
+
     protected:
         using VertexAttributeName = std::string;
         using CRC32 = uint32_t;
 
+        /**
+         Index of a uniform in the program's uniform table.
+         Resolve it once with uniformHandle() to skip name lookups in frequently called setters.
+         */
+        struct UniformHandle {
+            uint32_t index = 0;
+        };
+
     private:
+        /**
+         CPU-side copy of the last value uploaded to a uniform
+         */
+        struct UniformShadow {
+            size_t offset = 0;
+            size_t capacity = 0;
+            size_t validSize = 0;
+        };
+
         const GLShader *mVertexShader = nullptr;
         const GLShader *mFragmentShader = nullptr;
         const GLShader *mGeometryShader = nullptr;
 
         std::unordered_map<VertexAttributeName, GLVertexAttribute> mVertexAttributes;
         std::unordered_map<CRC32, GLUniformBlock> mUniformBlocks;
-        std::unordered_map<CRC32, GLUniform> mUniforms;
+        // Dense uniform table and a lookup of table indices sorted by name hash
+        std::vector<GLUniform> mUniforms;
+        std::vector<std::pair<CRC32, uint32_t>> mUniformIndices;
+        std::vector<UniformShadow> mUniformShadows;
+        std::vector<uint8_t> mUniformShadowStorage;
+        UniformStatistics mUniformStatistics;
+        // Scratch space for column-major copies of transposed matrix uploads
+        std::vector<GLfloat> mTransposedMatrices;
 
         GLint mAvailableTextureUnits = 0;
 
@@ -57,6 +90,12 @@ namespace EARenderer {
 
         void link();
 
+        bool loadBinary(uint64_t key);
+
+        void compileAndLink(const std::array<const GLSLPreprocessor::Output *, 3> &stageSources);
+
+        void storeBinary(uint64_t key);
+
         void obtainVertexAttributes();
 
         void obtainUniforms();
@@ -65,13 +104,66 @@ namespace EARenderer {
 
         GLuint uniformBlockBinding(const std::string& UBOName, GLint maximumUBOBindings);
 
+        /**
+         Compares a value with the uniform's shadow and updates the shadow
+
+         @return true if the value differs from the one uploaded previously and has to be uploaded
+         */
+        bool shouldUploadUniform(UniformHandle handle, const void *value, size_t size);
+
     protected:
-        GLProgram(const std::string &vertexSourceName, const std::string &fragmentSourceName, const std::string &geometrySourceName);
+        GLProgram(const std::string &vertexSourceName, const std::string &fragmentSourceName, const std::string &geometrySourceName,
+                const GLSLPreprocessor::Defines &defines = {});
 
         const GLVertexAttribute &vertexAttributeByName(const std::string &name);
 
         const GLUniform &uniformByNameCRC32(CRC32 crc32);
 
+        UniformHandle uniformHandle(CRC32 crc32) const;
+
+        const GLUniform &uniform(UniformHandle handle) const;
+
+#pragma mark - Uniform setters
+        // Uniform setters mirror glUniform* functions and skip uploads of values the uniform already holds
+
+        void setUniform1f(UniformHandle handle, GLfloat value);
+
+        void setUniform1i(UniformHandle handle, GLint value);
+
+        void setUniform1ui(UniformHandle handle, GLuint value);
+
+        void setUniform1fv(UniformHandle handle, GLsizei count, const GLfloat *values);
+
+        void setUniform2fv(UniformHandle handle, GLsizei count, const GLfloat *values);
+
+        void setUniform3fv(UniformHandle handle, GLsizei count, const GLfloat *values);
+
+        void setUniform4fv(UniformHandle handle, GLsizei count, const GLfloat *values);
+
+        void setUniform3iv(UniformHandle handle, GLsizei count, const GLint *values);
+
+        void setUniformMatrix4fv(UniformHandle handle, GLsizei count, GLboolean transpose, const GLfloat *values);
+
+        void setUniform1f(CRC32 crc32, GLfloat value) { setUniform1f(uniformHandle(crc32), value); }
+
+        void setUniform1i(CRC32 crc32, GLint value) { setUniform1i(uniformHandle(crc32), value); }
+
+        void setUniform1ui(CRC32 crc32, GLuint value) { setUniform1ui(uniformHandle(crc32), value); }
+
+        void setUniform1fv(CRC32 crc32, GLsizei count, const GLfloat *values) { setUniform1fv(uniformHandle(crc32), count, values); }
+
+        void setUniform2fv(CRC32 crc32, GLsizei count, const GLfloat *values) { setUniform2fv(uniformHandle(crc32), count, values); }
+
+        void setUniform3fv(CRC32 crc32, GLsizei count, const GLfloat *values) { setUniform3fv(uniformHandle(crc32), count, values); }
+
+        void setUniform4fv(CRC32 crc32, GLsizei count, const GLfloat *values) { setUniform4fv(uniformHandle(crc32), count, values); }
+
+        void setUniform3iv(CRC32 crc32, GLsizei count, const GLint *values) { setUniform3iv(uniformHandle(crc32), count, values); }
+
+        void setUniformMatrix4fv(CRC32 crc32, GLsizei count, GLboolean transpose, const GLfloat *values) {
+            setUniformMatrix4fv(uniformHandle(crc32), count, transpose, values);
+        }
+
         const GLUniformBlock &uniformBlockByNameCRC32(CRC32 crc32);
 
         void setUniformTexture(CRC32 uniformNameCRC32, const GLTexture &texture, const GLSampler *sampler = nullptr);
@@ -83,7 +175,7 @@ namespace EARenderer {
             }
 
             GLUniform sampler = uniformByNameCRC32(uniformNameCRC32);
-            glActiveTexture(GL_TEXTURE0 + sampler.textureUnit());
+            GLTextureUnitManager::Shared().activateUnit(sampler.textureUnit());
             bufferTexture.bind();
         }
 
@@ -117,6 +209,11 @@ namespace EARenderer {
         void ensureSamplerValidity(UniformModifierClosure closure);
 
         void setUniformBuffer(CRC32 uniformNameCRC32, const GLUniformBuffer& UBO, const GLUBODataLocation& location);
+
+        /**
+         @return amount of uniform uploads performed and skipped because the uniform already held the value
+         */
+        const UniformStatistics &uniformStatistics() const;
     };
 
     void swap(GLProgram &, GLProgram &);
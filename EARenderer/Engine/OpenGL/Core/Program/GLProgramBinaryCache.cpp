@@ -0,0 +1,182 @@
+//
+// Created by Pavlo Muratov on 2019-02-06.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "GLProgramBinaryCache.hpp"
+#include "StringUtils.hpp"
+#include "FNV1aHash.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include <bitsery/bitsery.h>
+#include <bitsery/traits/vector.h>
+#include <bitsery/adapter/buffer.h>
+
+namespace EARenderer {
+
+#pragma mark - Lifecycle
+
+    GLProgramBinaryCache &GLProgramBinaryCache::shared() {
+        static GLProgramBinaryCache cache;
+        return cache;
+    }
+
+#pragma mark - Getters / Setters
+
+    void GLProgramBinaryCache::setStorage(std::unique_ptr<GLProgramBinaryStorage> storage) {
+        mStorage = std::move(storage);
+    }
+
+    void GLProgramBinaryCache::setDriverIdentity(const std::string &vendor, const std::string &renderer, const std::string &version) {
+        mDriverIdentity = vendor + "\n" + renderer + "\n" + version;
+    }
+
+    void GLProgramBinaryCache::setCapacity(size_t capacity) {
+        mCapacity = capacity;
+    }
+
+    bool GLProgramBinaryCache::isEnabled() const {
+        return mStorage != nullptr;
+    }
+
+    bool GLProgramBinaryCache::hasDriverIdentity() const {
+        return !mDriverIdentity.empty();
+    }
+
+    const GLProgramBinaryCache::Statistics &GLProgramBinaryCache::statistics() const {
+        return mStatistics;
+    }
+
+#pragma mark - Private helpers
+
+    std::string GLProgramBinaryCache::EntryName(uint64_t key) {
+        return string_format("%016llx.bin", (unsigned long long) key);
+    }
+
+    void GLProgramBinaryCache::evictLeastRecentlyUsedEntries(const std::string &protectedEntryName) {
+        auto entries = mStorage->entries();
+
+        size_t totalSize = 0;
+        for (auto &entry : entries) {
+            totalSize += entry.size;
+        }
+
+        std::sort(entries.begin(), entries.end(), [](auto &lhs, auto &rhs) {
+            return lhs.lastUseTime < rhs.lastUseTime;
+        });
+
+        for (auto &entry : entries) {
+            if (totalSize <= mCapacity) {
+                break;
+            }
+
+            if (entry.name == protectedEntryName) {
+                continue;
+            }
+
+            mStorage->remove(entry.name);
+            totalSize -= entry.size;
+            mStatistics.evictions++;
+        }
+    }
+
+#pragma mark - Public interface
+
+    uint64_t GLProgramBinaryCache::key(const std::vector<const GLSLPreprocessor::Output *> &stageSources, const GLSLPreprocessor::Defines &defines) const {
+        FNV1aHash hash;
+        hash.combine(FormatVersion);
+        hash.combine(mDriverIdentity.data(), mDriverIdentity.size());
+        hash.combine(defines.hash());
+
+        for (auto source : stageSources) {
+            // Stage marker distinguishes an absent stage from an empty one
+            hash.combine(uint8_t(source ? 1 : 0));
+
+            if (source) {
+                hash.combine(uint64_t(source->source.size()));
+                hash.combine(source->source.data(), source->source.size());
+            }
+        }
+
+        return hash.value();
+    }
+
+    bool GLProgramBinaryCache::load(uint64_t key, Binary &binary) {
+        if (!mStorage) {
+            return false;
+        }
+
+        std::string name = EntryName(key);
+        std::vector<uint8_t> bytes;
+        if (!mStorage->read(name, bytes)) {
+            return false;
+        }
+
+        uint32_t magic = 0;
+        uint32_t formatVersion = 0;
+        uint64_t storedKey = 0;
+
+        using InputAdapter = bitsery::InputBufferAdapter<std::vector<uint8_t>>;
+        bitsery::Deserializer<InputAdapter> deserializer(InputAdapter(bytes.begin(), bytes.size()));
+        deserializer.value4b(magic);
+        deserializer.value4b(formatVersion);
+        deserializer.value8b(storedKey);
+        deserializer.value4b(binary.format);
+        deserializer.container1b(binary.data, std::numeric_limits<uint32_t>::max());
+
+        bool isValid = bitsery::AdapterAccess::getReader(deserializer).isCompletedSuccessfully() &&
+                       magic == Magic && formatVersion == FormatVersion && storedKey == key && !binary.data.empty();
+
+        if (!isValid) {
+            mStorage->remove(name);
+            binary = Binary();
+        }
+
+        return isValid;
+    }
+
+    void GLProgramBinaryCache::store(uint64_t key, const Binary &binary) {
+        if (!mStorage || binary.data.empty()) {
+            return;
+        }
+
+        std::vector<uint8_t> bytes;
+        using OutputAdapter = bitsery::OutputBufferAdapter<std::vector<uint8_t>>;
+        bitsery::Serializer<OutputAdapter> serializer(bytes);
+        serializer.value4b(Magic);
+        serializer.value4b(FormatVersion);
+        serializer.value8b(key);
+        serializer.value4b(binary.format);
+        serializer.container1b(binary.data, std::numeric_limits<uint32_t>::max());
+
+        auto &writer = bitsery::AdapterAccess::getWriter(serializer);
+        writer.flush();
+        bytes.resize(writer.writtenBytesCount());
+
+        std::string name = EntryName(key);
+        mStorage->write(name, bytes);
+        evictLeastRecentlyUsedEntries(name);
+    }
+
+    void GLProgramBinaryCache::reject(uint64_t key) {
+        if (!mStorage) {
+            return;
+        }
+
+        mStorage->remove(EntryName(key));
+        mStatistics.rejections++;
+    }
+
+    void GLProgramBinaryCache::recordLoading(uint64_t microseconds) {
+        mStatistics.hits++;
+        mStatistics.loadingMicroseconds += microseconds;
+    }
+
+    void GLProgramBinaryCache::recordCompilation(uint64_t microseconds) {
+        mStatistics.misses++;
+        mStatistics.compilationMicroseconds += microseconds;
+    }
+
+}
@@ -0,0 +1,109 @@
+//
+// Created by Pavlo Muratov on 2019-02-06.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_GLPROGRAMBINARYCACHE_HPP
+#define EARENDERER_GLPROGRAMBINARYCACHE_HPP
+
+#include "GLProgramBinaryStorage.hpp"
+#include "GLSLPreprocessor.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace EARenderer {
+
+    /**
+     Keeps linked program binaries between launches, so that programs don't have to be compiled on every start.
+
+     Entries are keyed by a hash of the preprocessed sources of all program stages, the define set,
+     the driver identity (vendor, renderer and version strings) and the entry format version,
+     so any change of these produces a miss instead of feeding the driver an incompatible binary.
+     Corrupted entries and entries rejected by the driver are removed.
+     Least recently used entries are evicted once the storage exceeds its capacity.
+
+     Doesn't call OpenGL itself, so any storage implementation can be plugged in.
+     */
+    class GLProgramBinaryCache {
+    public:
+        struct Binary {
+            uint32_t format = 0;
+            std::vector<uint8_t> data;
+        };
+
+        struct Statistics {
+            uint32_t hits = 0;
+            uint32_t misses = 0;
+            uint32_t rejections = 0;
+            uint32_t evictions = 0;
+            uint64_t loadingMicroseconds = 0;
+            uint64_t compilationMicroseconds = 0;
+        };
+
+    private:
+        static constexpr uint32_t Magic = 0x45415042; // "EAPB"
+        static constexpr uint32_t FormatVersion = 1;
+
+        std::unique_ptr<GLProgramBinaryStorage> mStorage;
+        std::string mDriverIdentity;
+        size_t mCapacity = 64 * 1024 * 1024;
+        Statistics mStatistics;
+
+        static std::string EntryName(uint64_t key);
+
+        void evictLeastRecentlyUsedEntries(const std::string &protectedEntryName);
+
+    public:
+        static GLProgramBinaryCache &shared();
+
+        /**
+         @param storage storage of the cache entries, or nullptr to disable caching
+         */
+        void setStorage(std::unique_ptr<GLProgramBinaryStorage> storage);
+
+        void setDriverIdentity(const std::string &vendor, const std::string &renderer, const std::string &version);
+
+        /**
+         @param capacity maximum total size of the stored entries in bytes
+         */
+        void setCapacity(size_t capacity);
+
+        bool isEnabled() const;
+
+        bool hasDriverIdentity() const;
+
+        const Statistics &statistics() const;
+
+        /**
+         @param stageSources preprocessed sources of every program stage in a fixed order, nullptr for absent stages
+         @param defines define set the sources were preprocessed with
+         @return key of the program binary
+         */
+        uint64_t key(const std::vector<const GLSLPreprocessor::Output *> &stageSources, const GLSLPreprocessor::Defines &defines) const;
+
+        /**
+         @param key key of the program binary
+         @param binary binary read from the storage
+         @return false if there is no valid entry for the key
+         */
+        bool load(uint64_t key, Binary &binary);
+
+        void store(uint64_t key, const Binary &binary);
+
+        /**
+         Removes an entry the driver failed to link
+
+         @param key key of the program binary
+         */
+        void reject(uint64_t key);
+
+        void recordLoading(uint64_t microseconds);
+
+        void recordCompilation(uint64_t microseconds);
+    };
+
+}
+
+#endif //EARENDERER_GLPROGRAMBINARYCACHE_HPP
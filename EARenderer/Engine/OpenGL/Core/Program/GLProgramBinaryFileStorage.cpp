@@ -0,0 +1,113 @@
+//
+// Created by Pavlo Muratov on 2019-02-06.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "GLProgramBinaryFileStorage.hpp"
+
+#include <fstream>
+#include <cstdio>
+
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <dirent.h>
+
+namespace EARenderer {
+
+#pragma mark - Lifecycle
+
+    GLProgramBinaryFileStorage::GLProgramBinaryFileStorage(const std::string &directoryPath)
+            :
+            mDirectoryPath(directoryPath.empty() || directoryPath.back() == '/' ? directoryPath : directoryPath + "/") {
+        mkdir(mDirectoryPath.c_str(), 0755);
+    }
+
+#pragma mark - Private helpers
+
+    bool GLProgramBinaryFileStorage::IsTemporaryFile(const std::string &name) {
+        std::string suffix = ".tmp";
+        return name.size() >= suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    std::string GLProgramBinaryFileStorage::filePath(const std::string &name) const {
+        return mDirectoryPath + name;
+    }
+
+#pragma mark - Public interface
+
+    bool GLProgramBinaryFileStorage::read(const std::string &name, std::vector<uint8_t> &bytes) {
+        std::string path = filePath(name);
+        std::ifstream stream(path, std::ios::binary | std::ios::ate);
+        if (!stream.is_open()) {
+            return false;
+        }
+
+        bytes.resize(size_t(stream.tellg()));
+        stream.seekg(0);
+        if (!stream.read(reinterpret_cast<char *>(bytes.data()), bytes.size())) {
+            return false;
+        }
+
+        // Touch the file to postpone its eviction
+        utimes(path.c_str(), nullptr);
+        return true;
+    }
+
+    void GLProgramBinaryFileStorage::write(const std::string &name, const std::vector<uint8_t> &bytes) {
+        // Write to a temporary file first, so that a crash never leaves a truncated entry behind
+        std::string path = filePath(name);
+        std::string temporaryPath = path + ".tmp";
+
+        std::ofstream stream(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!stream.is_open()) {
+            return;
+        }
+
+        stream.write(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+        stream.close();
+
+        if (stream.fail()) {
+            std::remove(temporaryPath.c_str());
+            return;
+        }
+
+        std::rename(temporaryPath.c_str(), path.c_str());
+    }
+
+    void GLProgramBinaryFileStorage::remove(const std::string &name) {
+        std::remove(filePath(name).c_str());
+    }
+
+    std::vector<GLProgramBinaryStorage::Entry> GLProgramBinaryFileStorage::entries() const {
+        std::vector<Entry> entries;
+
+        DIR *directory = opendir(mDirectoryPath.c_str());
+        if (!directory) {
+            return entries;
+        }
+
+        while (dirent *directoryEntry = readdir(directory)) {
+            std::string name(directoryEntry->d_name);
+
+            // Leftovers of interrupted writes are not entries
+            if (IsTemporaryFile(name)) {
+                continue;
+            }
+
+            struct stat attributes;
+            if (stat(filePath(name).c_str(), &attributes) != 0 || !S_ISREG(attributes.st_mode)) {
+                continue;
+            }
+
+            Entry entry;
+            entry.name = name;
+            entry.size = size_t(attributes.st_size);
+            entry.lastUseTime = int64_t(attributes.st_mtime);
+            entries.push_back(entry);
+        }
+
+        closedir(directory);
+        return entries;
+    }
+
+}
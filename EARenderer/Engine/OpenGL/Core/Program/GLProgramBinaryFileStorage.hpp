@@ -0,0 +1,43 @@
+//
+// Created by Pavlo Muratov on 2019-02-06.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_GLPROGRAMBINARYFILESTORAGE_HPP
+#define EARENDERER_GLPROGRAMBINARYFILESTORAGE_HPP
+
+#include "GLProgramBinaryStorage.hpp"
+
+namespace EARenderer {
+
+    /**
+     Stores every program binary cache entry in a separate file of a directory.
+     File modification time serves as the last use time of an entry.
+     Entries are written to temporary files first, which are never listed as entries.
+     */
+    class GLProgramBinaryFileStorage : public GLProgramBinaryStorage {
+    private:
+        std::string mDirectoryPath;
+
+        static bool IsTemporaryFile(const std::string &name);
+
+        std::string filePath(const std::string &name) const;
+
+    public:
+        /**
+         @param directoryPath directory to keep the entries in, created if missing
+         */
+        GLProgramBinaryFileStorage(const std::string &directoryPath);
+
+        bool read(const std::string &name, std::vector<uint8_t> &bytes) override;
+
+        void write(const std::string &name, const std::vector<uint8_t> &bytes) override;
+
+        void remove(const std::string &name) override;
+
+        std::vector<Entry> entries() const override;
+    };
+
+}
+
+#endif //EARENDERER_GLPROGRAMBINARYFILESTORAGE_HPP
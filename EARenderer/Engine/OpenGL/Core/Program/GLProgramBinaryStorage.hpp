@@ -0,0 +1,47 @@
+//
+// Created by Pavlo Muratov on 2019-02-06.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_GLPROGRAMBINARYSTORAGE_HPP
+#define EARENDERER_GLPROGRAMBINARYSTORAGE_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace EARenderer {
+
+    /**
+     Key-value storage of program binary cache entries
+     */
+    class GLProgramBinaryStorage {
+    public:
+        struct Entry {
+            std::string name;
+            size_t size = 0;
+            // Entries with lower values are evicted first
+            int64_t lastUseTime = 0;
+        };
+
+        virtual ~GLProgramBinaryStorage() = default;
+
+        /**
+         Reads an entry and marks it as recently used
+
+         @param name name of the entry
+         @param bytes contents of the entry
+         @return false if the entry doesn't exist or can't be read
+         */
+        virtual bool read(const std::string &name, std::vector<uint8_t> &bytes) = 0;
+
+        virtual void write(const std::string &name, const std::vector<uint8_t> &bytes) = 0;
+
+        virtual void remove(const std::string &name) = 0;
+
+        virtual std::vector<Entry> entries() const = 0;
+    };
+
+}
+
+#endif //EARENDERER_GLPROGRAMBINARYSTORAGE_HPP
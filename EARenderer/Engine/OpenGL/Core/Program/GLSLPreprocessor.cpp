@@ -0,0 +1,336 @@
+//
+// Created by Pavlo Muratov on 2019-02-06.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "GLSLPreprocessor.hpp"
+#include "StringUtils.hpp"
+#include "FNV1aHash.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iterator>
+#include <queue>
+#include <stdexcept>
+
+#include <sys/stat.h>
+
+namespace EARenderer {
+
+#pragma mark - Defines
+
+    GLSLPreprocessor::Defines::Defines(std::initializer_list<std::pair<const std::string, std::string>> definitions)
+            :
+            mDefinitions(definitions) {
+    }
+
+    void GLSLPreprocessor::Defines::set(const std::string &name, const std::string &value) {
+        mDefinitions[name] = value;
+    }
+
+    bool GLSLPreprocessor::Defines::empty() const {
+        return mDefinitions.empty();
+    }
+
+    uint64_t GLSLPreprocessor::Defines::hash() const {
+        FNV1aHash hash;
+        for (auto &definition : mDefinitions) {
+            hash.combineString(definition.first);
+            hash.combineString(definition.second);
+        }
+        return hash.value();
+    }
+
+    std::string GLSLPreprocessor::Defines::directives() const {
+        std::string directives;
+        for (auto &definition : mDefinitions) {
+            directives += "#define " + definition.first;
+            if (!definition.second.empty()) {
+                directives += " " + definition.second;
+            }
+            directives += "\n";
+        }
+        return directives;
+    }
+
+#pragma mark - File stamp
+
+    bool GLSLPreprocessor::FileStamp::operator==(const FileStamp &rhs) const {
+        return modificationTime == rhs.modificationTime && size == rhs.size;
+    }
+
+    bool GLSLPreprocessor::FileStamp::operator!=(const FileStamp &rhs) const {
+        return !(rhs == *this);
+    }
+
+#pragma mark - Lifecycle
+
+    GLSLPreprocessor &GLSLPreprocessor::shared() {
+        static GLSLPreprocessor preprocessor;
+        return preprocessor;
+    }
+
+#pragma mark - Private helpers
+
+    GLSLPreprocessor::FileStamp GLSLPreprocessor::Stamp(const std::string &filePath) {
+        FileStamp stamp;
+        struct stat attributes;
+        if (stat(filePath.c_str(), &attributes) == 0 && S_ISREG(attributes.st_mode)) {
+            stamp.modificationTime = attributes.st_mtime;
+            stamp.size = attributes.st_size;
+        }
+        return stamp;
+    }
+
+    GLSLPreprocessor::ParsedFile GLSLPreprocessor::Parse(const std::string &filePath, const std::string &source) {
+        ParsedFile file;
+        std::string directory = filePath.substr(0, filePath.find_last_of('/') + 1);
+
+        Chunk chunk;
+        bool isInsideBlockComment = false;
+        uint32_t lineNumber = 0;
+        size_t lineStart = 0;
+
+        auto isSpace = [](char character) {
+            return character == ' ' || character == '\t' || character == '\r';
+        };
+
+        while (lineStart < source.size()) {
+            size_t lineEnd = source.find('\n', lineStart);
+            if (lineEnd == std::string::npos) {
+                lineEnd = source.size();
+            }
+            lineNumber++;
+
+            size_t i = lineStart;
+            bool isDirectiveHandled = false;
+
+            // Directives are only recognized outside of block comments
+            if (!isInsideBlockComment) {
+                while (i < lineEnd && isSpace(source[i])) { i++; }
+
+                if (i < lineEnd && source[i] == '#') {
+                    i++;
+                    while (i < lineEnd && isSpace(source[i])) { i++; }
+
+                    size_t nameStart = i;
+                    while (i < lineEnd && std::isalpha(uint8_t(source[i]))) { i++; }
+                    std::string name = source.substr(nameStart, i - nameStart);
+
+                    if (name == "include") {
+                        while (i < lineEnd && isSpace(source[i])) { i++; }
+
+                        size_t pathStart = i + 1;
+                        size_t pathEnd = i < lineEnd && source[i] == '"' ? source.find('"', pathStart) : std::string::npos;
+
+                        // Malformed includes are passed to the compiler as is, to be reported as errors
+                        if (pathEnd != std::string::npos && pathEnd < lineEnd && pathEnd > pathStart) {
+                            chunk.includePath = directory + source.substr(pathStart, pathEnd - pathStart);
+                            file.includes.push_back(chunk.includePath);
+                            file.chunks.push_back(std::move(chunk));
+
+                            chunk = Chunk();
+                            chunk.firstLine = lineNumber + 1;
+                            isDirectiveHandled = true;
+                        }
+                    } else if (name == "version" && file.versionDirective.empty() && file.chunks.empty()) {
+                        // Only comments and blank lines may precede #version, so they're safely dropped
+                        file.versionDirective = source.substr(lineStart, lineEnd - lineStart);
+                        chunk = Chunk();
+                        chunk.firstLine = lineNumber + 1;
+                        isDirectiveHandled = true;
+                    }
+                }
+            }
+
+            if (!isDirectiveHandled) {
+                chunk.text.append(source, lineStart, lineEnd - lineStart);
+                chunk.text.push_back('\n');
+
+                // Track block comments to skip directives commented out with /* */
+                for (size_t j = lineStart; j + 1 < lineEnd; j++) {
+                    if (isInsideBlockComment) {
+                        if (source[j] == '*' && source[j + 1] == '/') {
+                            isInsideBlockComment = false;
+                            j++;
+                        }
+                    } else if (source[j] == '/' && source[j + 1] == '/') {
+                        break;
+                    } else if (source[j] == '/' && source[j + 1] == '*') {
+                        isInsideBlockComment = true;
+                        j++;
+                    }
+                }
+            }
+
+            lineStart = lineEnd + 1;
+        }
+
+        file.chunks.push_back(std::move(chunk));
+        return file;
+    }
+
+    const GLSLPreprocessor::ParsedFile &GLSLPreprocessor::parsedFile(const std::string &filePath) {
+        FileStamp stamp = Stamp(filePath);
+
+        auto cachedFileIt = mParsedFiles.find(filePath);
+        if (cachedFileIt != mParsedFiles.end() && cachedFileIt->second.stamp == stamp) {
+            return cachedFileIt->second;
+        }
+
+        std::ifstream stream(filePath);
+        if (!stream.is_open()) {
+            throw std::invalid_argument(string_format("Can't read shader file: %s", filePath.c_str()));
+        }
+
+        std::string source((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+        ParsedFile file = Parse(filePath, source);
+        file.stamp = stamp;
+
+        if (cachedFileIt != mParsedFiles.end()) {
+            for (auto &include : cachedFileIt->second.includes) {
+                mIncluders[include].erase(filePath);
+            }
+        }
+
+        for (auto &include : file.includes) {
+            mIncluders[include].insert(filePath);
+        }
+
+        ParsedFile &slot = mParsedFiles[filePath];
+        slot = std::move(file);
+        return slot;
+    }
+
+    void GLSLPreprocessor::forget(const std::string &filePath) {
+        auto cachedFileIt = mParsedFiles.find(filePath);
+        if (cachedFileIt == mParsedFiles.end()) {
+            return;
+        }
+
+        for (auto &include : cachedFileIt->second.includes) {
+            mIncluders[include].erase(filePath);
+        }
+
+        mParsedFiles.erase(cachedFileIt);
+    }
+
+    void GLSLPreprocessor::append(const std::string &filePath, Output &output, std::unordered_set<std::string> &includedFiles) {
+        const ParsedFile &file = parsedFile(filePath);
+
+        std::string fileIndex = std::to_string(output.files.size());
+        output.files.push_back(filePath);
+
+        for (auto &chunk : file.chunks) {
+            if (!chunk.text.empty()) {
+                output.source += "#line " + std::to_string(chunk.firstLine) + " " + fileIndex + "\n";
+                output.source += chunk.text;
+            }
+
+            if (chunk.includePath.empty() || !includedFiles.insert(chunk.includePath).second) {
+                continue;
+            }
+
+            if (Stamp(chunk.includePath).size < 0) {
+                throw std::runtime_error(string_format("glsl #include directive in %s (%s) does not reference a real file",
+                        filePath.c_str(), chunk.includePath.c_str()));
+            }
+
+            append(chunk.includePath, output, includedFiles);
+        }
+    }
+
+#pragma mark - Public interface
+
+    std::shared_ptr<const GLSLPreprocessor::Output> GLSLPreprocessor::preprocess(const std::string &filePath, const Defines &defines) {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        // Keyed by the exact directives rather than their hash, so colliding define sets never share an output
+        std::string outputKey = filePath + "\n" + defines.directives();
+
+        auto cachedOutputIt = mOutputs.find(outputKey);
+        if (cachedOutputIt != mOutputs.end()) {
+            bool isUpToDate = true;
+            for (auto &dependency : cachedOutputIt->second.dependencies) {
+                if (Stamp(dependency.first) != dependency.second) {
+                    isUpToDate = false;
+                    break;
+                }
+            }
+
+            if (isUpToDate) {
+                return cachedOutputIt->second.output;
+            }
+        }
+
+        auto output = std::make_shared<Output>();
+        std::unordered_set<std::string> includedFiles{filePath};
+
+        // Defines must follow #version, which in turn must be the first directive of the source
+        const ParsedFile &rootFile = parsedFile(filePath);
+        if (!rootFile.versionDirective.empty()) {
+            output->source += rootFile.versionDirective + "\n";
+        }
+        output->source += defines.directives();
+
+        append(filePath, *output, includedFiles);
+
+        CachedOutput cachedOutput;
+        cachedOutput.output = output;
+        for (auto &file : output->files) {
+            cachedOutput.dependencies.emplace_back(file, mParsedFiles[file].stamp);
+        }
+        mOutputs[outputKey] = std::move(cachedOutput);
+
+        return output;
+    }
+
+    std::unordered_set<std::string> GLSLPreprocessor::includers(const std::string &filePath) const {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        std::unordered_set<std::string> includers;
+        std::queue<std::string> pendingFiles;
+        pendingFiles.push(filePath);
+
+        while (!pendingFiles.empty()) {
+            auto includersIt = mIncluders.find(pendingFiles.front());
+            pendingFiles.pop();
+
+            if (includersIt == mIncluders.end()) {
+                continue;
+            }
+
+            for (auto &includer : includersIt->second) {
+                if (includers.insert(includer).second) {
+                    pendingFiles.push(includer);
+                }
+            }
+        }
+
+        return includers;
+    }
+
+    void GLSLPreprocessor::invalidate(const std::string &filePath) {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        for (auto it = mOutputs.begin(); it != mOutputs.end();) {
+            auto &dependencies = it->second.dependencies;
+            bool isDependent = std::any_of(dependencies.begin(), dependencies.end(), [&](auto &dependency) {
+                return dependency.first == filePath;
+            });
+
+            it = isDependent ? mOutputs.erase(it) : std::next(it);
+        }
+
+        forget(filePath);
+    }
+
+    void GLSLPreprocessor::clear() {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mParsedFiles.clear();
+        mIncluders.clear();
+        mOutputs.clear();
+    }
+
+}
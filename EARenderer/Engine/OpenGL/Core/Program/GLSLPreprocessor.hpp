@@ -0,0 +1,150 @@
+//
+// Created by Pavlo Muratov on 2019-02-06.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_GLSLPREPROCESSOR_HPP
+#define EARENDERER_GLSLPREPROCESSOR_HPP
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <memory>
+#include <mutex>
+#include <ctime>
+
+#include <sys/types.h>
+
+namespace EARenderer {
+
+    /**
+     Resolves #include directives of GLSL sources and injects #define sets, without touching OpenGL.
+
+     Parsed files are cached by path and invalidated when their modification time or size changes,
+     so a file included by many shaders is read from disk once. Assembled sources are cached
+     per root file and define set. Include relationships are kept in a graph,
+     which tells which root shaders have to be rebuilt when a file changes.
+
+     Included files are resolved relative to the including file and are included once per assembled source.
+     Every chunk of the output is preceded by a #line directive whose source string number indexes
+     Output::files, so compiler errors point to the original file and line.
+     */
+    class GLSLPreprocessor {
+    public:
+
+#pragma mark - Nested types
+
+        /**
+         A permutation of #define directives injected right after the #version directive of the root file
+         */
+        class Defines {
+        private:
+            // Ordered, so that equal sets always produce equal directives and hashes
+            std::map<std::string, std::string> mDefinitions;
+
+        public:
+            Defines() = default;
+
+            Defines(std::initializer_list<std::pair<const std::string, std::string>> definitions);
+
+            void set(const std::string &name, const std::string &value = "");
+
+            bool empty() const;
+
+            /**
+             @return hash of the set, stable across runs and platforms
+             */
+            uint64_t hash() const;
+
+            /**
+             @return #define directives, one per line
+             */
+            std::string directives() const;
+        };
+
+        struct Output {
+            std::string source;
+            // Files participating in the output, indexed by the source string number of #line directives
+            std::vector<std::string> files;
+        };
+
+    private:
+        struct FileStamp {
+            time_t modificationTime = 0;
+            off_t size = -1;
+
+            bool operator==(const FileStamp &rhs) const;
+
+            bool operator!=(const FileStamp &rhs) const;
+        };
+
+        /**
+         Piece of a file's text followed by an optional #include directive
+         */
+        struct Chunk {
+            std::string text;
+            uint32_t firstLine = 1;
+            std::string includePath;
+        };
+
+        struct ParsedFile {
+            FileStamp stamp;
+            std::string versionDirective;
+            std::vector<Chunk> chunks;
+            std::vector<std::string> includes;
+        };
+
+        struct CachedOutput {
+            std::shared_ptr<const Output> output;
+            std::vector<std::pair<std::string, FileStamp>> dependencies;
+        };
+
+        std::unordered_map<std::string, ParsedFile> mParsedFiles;
+        // Maps a file to files directly including it
+        std::unordered_map<std::string, std::unordered_set<std::string>> mIncluders;
+        std::unordered_map<std::string, CachedOutput> mOutputs;
+        mutable std::mutex mMutex;
+
+        static FileStamp Stamp(const std::string &filePath);
+
+        static ParsedFile Parse(const std::string &filePath, const std::string &source);
+
+        const ParsedFile &parsedFile(const std::string &filePath);
+
+        void forget(const std::string &filePath);
+
+        void append(const std::string &filePath, Output &output, std::unordered_set<std::string> &includedFiles);
+
+    public:
+        static GLSLPreprocessor &shared();
+
+        /**
+         Assembles a single source string from the root file, its includes and the define set
+
+         @param filePath path to the root GLSL source file
+         @param defines definitions injected into the source
+         @return assembled source, shared with other requests of the same root file and define set
+         */
+        std::shared_ptr<const Output> preprocess(const std::string &filePath, const Defines &defines = {});
+
+        /**
+         @param filePath path to a GLSL source file
+         @return all files including the given one directly or indirectly
+         */
+        std::unordered_set<std::string> includers(const std::string &filePath) const;
+
+        /**
+         Drops cached data of the file and of every assembled source that depends on it
+
+         @param filePath path to a changed GLSL source file
+         */
+        void invalidate(const std::string &filePath);
+
+        void clear();
+    };
+
+}
+
+#endif //EARENDERER_GLSLPREPROCESSOR_HPP
@@ -11,50 +11,26 @@
 
 #include <string>
 #include <vector>
-#include <unordered_map>
-#include <unordered_set>
 
 #include "GLNamedObject.hpp"
+#include "GLSLPreprocessor.hpp"
 #include "Range.hpp"
 
 namespace EARenderer {
 
     class GLShader : public GLNamedObject {
     private:
-        using IncludePath = std::string;
-        using IndexPair = std::pair<int32_t, int32_t>;
-
         GLenum mType;
-        int32_t mNumberOfLines = 0;
-        std::unordered_map<IncludePath, std::vector<IndexPair>> mIncludeLineIndices;
-        std::unordered_set<std::string> mProcessedIncludes;
+        std::vector<std::string> mSourceFiles;
 
         /**
-         Parses #include tree and composes a single source file.
-         Current implementation expects all included files to be in the same folder as the root file.
-
-         @param filePath path to the root GLSL source file
-         @return source string composed from all files: root and it's includes
-         */
-        std::string assembleSource(const std::string &filePath);
-
-        /**
-         Retrieves an error line number from info log message provided by OpenGL API
+         Matches a source string number and a line reported in the OpenGL info log
+         with files involved in the shader compilation
 
          @param infoLog error message from OpenGL
-         @return zero-based index of the line in which error has occured
-         */
-        int32_t errorLine(const std::string &infoLog);
-
-        /**
-         Matches an OpenGL-provided error line number with all files involved in
-         the shader compilation and returns a string containing information
-         about the actual file in which error has occured and the line respective to that file.
-
-         @param errorLine global error line from the complete source string
-         @return info about actual file and line
+         @return info about actual file and line in which error has occured
          */
-        std::string errorHeader(int32_t errorLine);
+        std::string errorHeader(const std::string &infoLog);
 
         /**
          Compiles an OpenGL shader from a string
@@ -66,7 +42,18 @@ namespace EARenderer {
     public:
         using GLNamedObject::GLNamedObject;
 
-        GLShader(const std::string &sourcePath, GLenum type);
+        /**
+         @param sourcePath path to the root GLSL source file
+         @param type shader type
+         @param defines definitions injected into the source, e.g. to compile a permutation of an uber shader
+         */
+        GLShader(const std::string &sourcePath, GLenum type, const GLSLPreprocessor::Defines &defines = {});
+
+        /**
+         @param source source assembled by the GLSL preprocessor
+         @param type shader type
+         */
+        GLShader(const GLSLPreprocessor::Output &source, GLenum type);
 
         GLShader(const GLShader &) = delete;
 
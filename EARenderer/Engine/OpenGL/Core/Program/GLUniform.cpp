@@ -95,4 +95,58 @@ namespace EARenderer {
                         || mType == GL_UNSIGNED_INT_SAMPLER_CUBE_MAP_ARRAY;
     }
 
+    size_t GLUniform::elementSize() const {
+        if (isSampler()) {
+            return sizeof(GLint);
+        }
+
+        switch (mType) {
+            case GL_FLOAT:
+            case GL_INT:
+            case GL_UNSIGNED_INT:
+            case GL_BOOL:
+                return 4;
+
+            case GL_FLOAT_VEC2:
+            case GL_INT_VEC2:
+            case GL_UNSIGNED_INT_VEC2:
+            case GL_BOOL_VEC2:
+                return 8;
+
+            case GL_FLOAT_VEC3:
+            case GL_INT_VEC3:
+            case GL_UNSIGNED_INT_VEC3:
+            case GL_BOOL_VEC3:
+                return 12;
+
+            case GL_FLOAT_VEC4:
+            case GL_INT_VEC4:
+            case GL_UNSIGNED_INT_VEC4:
+            case GL_BOOL_VEC4:
+            case GL_FLOAT_MAT2:
+                return 16;
+
+            case GL_FLOAT_MAT2x3:
+            case GL_FLOAT_MAT3x2:
+                return 24;
+
+            case GL_FLOAT_MAT2x4:
+            case GL_FLOAT_MAT4x2:
+                return 32;
+
+            case GL_FLOAT_MAT3:
+                return 36;
+
+            case GL_FLOAT_MAT3x4:
+            case GL_FLOAT_MAT4x3:
+                return 48;
+
+            case GL_FLOAT_MAT4:
+                return 64;
+
+            default:
+                return 0;
+        }
+    }
+
 }
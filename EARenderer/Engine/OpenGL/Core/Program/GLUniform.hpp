@@ -44,6 +44,12 @@ namespace EARenderer {
         bool isValid() const;
 
         bool isSampler() const;
+
+        /**
+         @return size in bytes of a single element of the uniform (or of the uniform itself if it's not an array),
+         or 0 for types whose values aren't set with glUniform* functions
+         */
+        size_t elementSize() const;
     };
 
 }
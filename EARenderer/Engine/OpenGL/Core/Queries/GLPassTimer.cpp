@@ -0,0 +1,113 @@
+//
+// Created by Pavlo Muratov on 2019-02-10.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "GLPassTimer.hpp"
+
+#include <stdexcept>
+#include <algorithm>
+
+namespace EARenderer {
+
+#pragma mark - Lifecycle
+
+    GLPassTimer::GLPassTimer(size_t maximumPendingFrameCount)
+            : mMaximumPendingFrameCount(std::max(maximumPendingFrameCount, size_t(1))) {}
+
+    GLPassTimer::~GLPassTimer() {
+        recycleQueries(mCurrentFrame);
+        for (auto &frame : mFinishedFrames) {
+            recycleQueries(frame);
+        }
+        glDeleteQueries(static_cast<GLsizei>(mFreeQueries.size()), mFreeQueries.data());
+    }
+
+#pragma mark - Private helpers
+
+    GLuint GLPassTimer::obtainQuery() {
+        if (mFreeQueries.empty()) {
+            GLuint query = 0;
+            glGenQueries(1, &query);
+            return query;
+        }
+
+        GLuint query = mFreeQueries.back();
+        mFreeQueries.pop_back();
+        return query;
+    }
+
+    void GLPassTimer::recycleQueries(const PendingFrame &frame) {
+        for (auto &pass : frame) {
+            mFreeQueries.push_back(pass.query);
+        }
+    }
+
+#pragma mark - PassTimer
+
+    void GLPassTimer::beginPass(const std::string &name) {
+        // Time elapsed queries of the same target can't be active simultaneously
+        if (mIsPassActive) {
+            throw std::logic_error("Pass '" + name + "' started before the previous one ended");
+        }
+
+        GLuint query = obtainQuery();
+        glBeginQuery(GL_TIME_ELAPSED, query);
+        mCurrentFrame.push_back(PendingPass{name, query});
+        mIsPassActive = true;
+    }
+
+    void GLPassTimer::endPass() {
+        if (!mIsPassActive) {
+            throw std::logic_error("No pass is being timed");
+        }
+
+        glEndQuery(GL_TIME_ELAPSED);
+        mIsPassActive = false;
+    }
+
+    void GLPassTimer::finishFrame() {
+        if (mIsPassActive) {
+            throw std::logic_error("Frame finished while a pass is being timed");
+        }
+
+        mFinishedFrames.push_back(std::move(mCurrentFrame));
+        mCurrentFrame.clear();
+
+        // Results nobody collects must not accumulate
+        while (mFinishedFrames.size() > mMaximumPendingFrameCount) {
+            recycleQueries(mFinishedFrames.front());
+            mFinishedFrames.pop_front();
+        }
+    }
+
+    std::optional<PassTimer::FrameTimings> GLPassTimer::collectFrame() {
+        if (mFinishedFrames.empty()) {
+            return std::nullopt;
+        }
+
+        const PendingFrame &frame = mFinishedFrames.front();
+
+        // Queries complete in submission order, so the last one being ready means the whole frame is
+        if (!frame.empty()) {
+            GLint isAvailable = GL_FALSE;
+            glGetQueryObjectiv(frame.back().query, GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+            if (isAvailable == GL_FALSE) {
+                return std::nullopt;
+            }
+        }
+
+        FrameTimings timings;
+        timings.reserve(frame.size());
+        for (auto &pass : frame) {
+            GLuint64 nanoseconds = 0;
+            glGetQueryObjectui64v(pass.query, GL_QUERY_RESULT, &nanoseconds);
+            timings.push_back(Timing{pass.name, nanoseconds / 1e6});
+        }
+
+        recycleQueries(frame);
+        mFinishedFrames.pop_front();
+        return timings;
+    }
+
+}
@@ -0,0 +1,63 @@
+//
+// Created by Pavlo Muratov on 2019-02-10.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_GLPASSTIMER_HPP
+#define EARENDERER_GLPASSTIMER_HPP
+
+#include "PassTimer.hpp"
+
+#include <OpenGL/gl3.h>
+#include <deque>
+
+namespace EARenderer {
+
+    /**
+     Measures GPU time of passes with GL_TIME_ELAPSED queries. Results are read only
+     once the driver reports them available, so timing never stalls the pipeline.
+     Query objects are recycled after their results have been read.
+     */
+    class GLPassTimer : public PassTimer {
+    private:
+        struct PendingPass {
+            std::string name;
+            GLuint query;
+        };
+
+        using PendingFrame = std::vector<PendingPass>;
+
+        std::vector<GLuint> mFreeQueries;
+        PendingFrame mCurrentFrame;
+        std::deque<PendingFrame> mFinishedFrames;
+        size_t mMaximumPendingFrameCount;
+        bool mIsPassActive = false;
+
+        GLuint obtainQuery();
+
+        void recycleQueries(const PendingFrame &frame);
+
+    public:
+        /**
+         @param maximumPendingFrameCount number of frames waiting for results after which the oldest ones are dropped
+         */
+        GLPassTimer(size_t maximumPendingFrameCount = 8);
+
+        ~GLPassTimer() override;
+
+        GLPassTimer(const GLPassTimer &that) = delete;
+
+        GLPassTimer &operator=(const GLPassTimer &rhs) = delete;
+
+        void beginPass(const std::string &name) override;
+
+        void endPass() override;
+
+        void finishFrame() override;
+
+        std::optional<FrameTimings> collectFrame() override;
+    };
+
+}
+
+#endif //EARENDERER_GLPASSTIMER_HPP
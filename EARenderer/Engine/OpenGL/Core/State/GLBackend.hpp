@@ -0,0 +1,237 @@
+//
+// Created by Pavlo Muratov on 2019-02-08.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_GLBACKEND_HPP
+#define EARENDERER_GLBACKEND_HPP
+
+#include <OpenGL/gl3.h>
+
+namespace EARenderer {
+
+    /**
+     Table of OpenGL functions issued by the renderer, from resource creation and uploads to state changes and draws.
+     Lets the driver be replaced with an implementation recording the command stream or discarding it,
+     so that passes can run without a GPU. Only CPU read backs of texture data still go to the driver directly.
+     */
+    class GLBackend {
+    public:
+        virtual ~GLBackend() = default;
+
+#pragma mark - Queries
+
+        virtual GLint integer(GLenum parameter) = 0;
+
+        virtual GLfloat floatValue(GLenum parameter) = 0;
+
+        /**
+         @return string describing the implementation, e.g. GL_VENDOR
+         */
+        virtual const GLubyte *string(GLenum name) = 0;
+
+        virtual GLint textureLevelInteger(GLenum target, GLint level, GLenum parameter) = 0;
+
+        virtual GLenum checkFramebufferStatus(GLenum target) = 0;
+
+#pragma mark - Resources
+
+        virtual GLuint genTexture() = 0;
+
+        virtual void deleteTexture(GLuint texture) = 0;
+
+        virtual GLuint genSampler() = 0;
+
+        virtual void deleteSampler(GLuint sampler) = 0;
+
+        virtual GLuint genFramebuffer() = 0;
+
+        virtual void deleteFramebuffer(GLuint framebuffer) = 0;
+
+        virtual GLuint genRenderbuffer() = 0;
+
+        virtual void deleteRenderbuffer(GLuint renderbuffer) = 0;
+
+        virtual GLuint genBuffer() = 0;
+
+        virtual void deleteBuffer(GLuint buffer) = 0;
+
+        virtual GLuint genVertexArray() = 0;
+
+        virtual void deleteVertexArray(GLuint vertexArray) = 0;
+
+        virtual GLuint createShader(GLenum type) = 0;
+
+        virtual void deleteShader(GLuint shader) = 0;
+
+        virtual GLuint createProgram() = 0;
+
+        virtual void deleteProgram(GLuint program) = 0;
+
+#pragma mark - Bindings
+
+        virtual void bindFramebuffer(GLenum target, GLuint framebuffer) = 0;
+
+        virtual void bindRenderbuffer(GLenum target, GLuint renderbuffer) = 0;
+
+        virtual void useProgram(GLuint program) = 0;
+
+        virtual void bindVertexArray(GLuint vertexArray) = 0;
+
+        virtual void bindBuffer(GLenum target, GLuint buffer) = 0;
+
+        virtual void bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) = 0;
+
+        virtual void activeTexture(GLenum unit) = 0;
+
+        virtual void bindTexture(GLenum target, GLuint texture) = 0;
+
+        virtual void bindSampler(GLuint unit, GLuint sampler) = 0;
+
+#pragma mark - Fixed function state
+
+        virtual void enable(GLenum capability) = 0;
+
+        virtual void disable(GLenum capability) = 0;
+
+        virtual void blendFunc(GLenum source, GLenum destination) = 0;
+
+        virtual void depthMask(GLboolean flag) = 0;
+
+        virtual void depthFunc(GLenum function) = 0;
+
+        virtual void cullFace(GLenum mode) = 0;
+
+        virtual void viewport(GLint x, GLint y, GLsizei width, GLsizei height) = 0;
+
+        virtual void scissor(GLint x, GLint y, GLsizei width, GLsizei height) = 0;
+
+        virtual void drawBuffers(GLsizei count, const GLenum *buffers) = 0;
+
+        virtual void readBuffer(GLenum mode) = 0;
+
+        virtual void clearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) = 0;
+
+        virtual void clearDepth(GLdouble depth) = 0;
+
+#pragma mark - Textures and samplers
+
+        virtual void texParameteri(GLenum target, GLenum parameter, GLint value) = 0;
+
+        virtual void texParameterf(GLenum target, GLenum parameter, GLfloat value) = 0;
+
+        virtual void texImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLenum format, GLenum type, const void *pixels) = 0;
+
+        virtual void texStorage3D(GLenum target, GLsizei levels, GLenum internalFormat, GLsizei width, GLsizei height, GLsizei depth) = 0;
+
+        virtual void texSubImage3D(GLenum target, GLint level, GLint xOffset, GLint yOffset, GLint zOffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const void *pixels) = 0;
+
+        virtual void generateMipmap(GLenum target) = 0;
+
+        virtual void texBuffer(GLenum target, GLenum internalFormat, GLuint buffer) = 0;
+
+        virtual void samplerParameteri(GLuint sampler, GLenum parameter, GLint value) = 0;
+
+        virtual void samplerParameterf(GLuint sampler, GLenum parameter, GLfloat value) = 0;
+
+#pragma mark - Framebuffers
+
+        virtual void renderbufferStorage(GLenum target, GLenum internalFormat, GLsizei width, GLsizei height) = 0;
+
+        virtual void framebufferTexture(GLenum target, GLenum attachment, GLuint texture, GLint level) = 0;
+
+        virtual void framebufferTextureLayer(GLenum target, GLenum attachment, GLuint texture, GLint level, GLint layer) = 0;
+
+        virtual void framebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbufferTarget, GLuint renderbuffer) = 0;
+
+#pragma mark - Buffers and vertex arrays
+
+        virtual void bufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage) = 0;
+
+        /**
+         @return pointer to the mapped range, which stays valid until unmapBuffer()
+         */
+        virtual void *mapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) = 0;
+
+        virtual void unmapBuffer(GLenum target) = 0;
+
+        virtual void enableVertexAttribArray(GLuint index) = 0;
+
+        virtual void vertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void *pointer) = 0;
+
+        virtual void vertexAttribDivisor(GLuint index, GLuint divisor) = 0;
+
+#pragma mark - Shaders and programs
+
+        virtual void shaderSource(GLuint shader, const GLchar *source) = 0;
+
+        virtual void compileShader(GLuint shader) = 0;
+
+        virtual GLint shaderInteger(GLuint shader, GLenum parameter) = 0;
+
+        virtual void shaderInfoLog(GLuint shader, GLsizei bufferSize, GLchar *infoLog) = 0;
+
+        virtual void attachShader(GLuint program, GLuint shader) = 0;
+
+        virtual void linkProgram(GLuint program) = 0;
+
+        virtual void validateProgram(GLuint program) = 0;
+
+        virtual void programParameteri(GLuint program, GLenum parameter, GLint value) = 0;
+
+        virtual void programBinary(GLuint program, GLenum format, const void *binary, GLsizei length) = 0;
+
+        virtual void getProgramBinary(GLuint program, GLsizei bufferSize, GLsizei *length, GLenum *format, void *binary) = 0;
+
+        virtual GLint programInteger(GLuint program, GLenum parameter) = 0;
+
+        virtual void programInfoLog(GLuint program, GLsizei bufferSize, GLsizei *length, GLchar *infoLog) = 0;
+
+        virtual void activeAttrib(GLuint program, GLuint index, GLsizei bufferSize, GLint *size, GLenum *type, GLchar *name) = 0;
+
+        virtual void activeUniform(GLuint program, GLuint index, GLsizei bufferSize, GLint *size, GLenum *type, GLchar *name) = 0;
+
+        virtual GLint uniformLocation(GLuint program, const GLchar *name) = 0;
+
+        virtual GLint activeUniformBlockInteger(GLuint program, GLuint blockIndex, GLenum parameter) = 0;
+
+        virtual void activeUniformBlockName(GLuint program, GLuint blockIndex, GLsizei bufferSize, GLchar *name) = 0;
+
+        virtual void uniformBlockBinding(GLuint program, GLuint blockIndex, GLuint binding) = 0;
+
+#pragma mark - Uniforms
+
+        virtual void uniform1f(GLint location, GLfloat value) = 0;
+
+        virtual void uniform1i(GLint location, GLint value) = 0;
+
+        virtual void uniform1ui(GLint location, GLuint value) = 0;
+
+        virtual void uniform1fv(GLint location, GLsizei count, const GLfloat *values) = 0;
+
+        virtual void uniform2fv(GLint location, GLsizei count, const GLfloat *values) = 0;
+
+        virtual void uniform3fv(GLint location, GLsizei count, const GLfloat *values) = 0;
+
+        virtual void uniform4fv(GLint location, GLsizei count, const GLfloat *values) = 0;
+
+        virtual void uniform3iv(GLint location, GLsizei count, const GLint *values) = 0;
+
+        virtual void uniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *values) = 0;
+
+#pragma mark - Commands
+
+        virtual void clear(GLbitfield mask) = 0;
+
+        virtual void blitFramebuffer(GLint sourceX0, GLint sourceY0, GLint sourceX1, GLint sourceY1, GLint destinationX0, GLint destinationY0, GLint destinationX1, GLint destinationY1, GLbitfield mask, GLenum filter) = 0;
+
+        virtual void drawArrays(GLenum mode, GLint first, GLsizei count) = 0;
+
+        virtual void drawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instanceCount) = 0;
+
+        virtual void multiDrawArrays(GLenum mode, const GLint *first, const GLsizei *count, GLsizei drawCount) = 0;
+    };
+
+}
+
+#endif //EARENDERER_GLBACKEND_HPP
@@ -0,0 +1,426 @@
+//
+// Created by Pavlo Muratov on 2019-02-08.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "GLDriverBackend.hpp"
+
+namespace EARenderer {
+
+#pragma mark - Queries
+
+    GLint GLDriverBackend::integer(GLenum parameter) {
+        GLint value = 0;
+        glGetIntegerv(parameter, &value);
+        return value;
+    }
+
+    GLfloat GLDriverBackend::floatValue(GLenum parameter) {
+        GLfloat value = 0.0;
+        glGetFloatv(parameter, &value);
+        return value;
+    }
+
+    const GLubyte *GLDriverBackend::string(GLenum name) {
+        return glGetString(name);
+    }
+
+    GLint GLDriverBackend::textureLevelInteger(GLenum target, GLint level, GLenum parameter) {
+        GLint value = 0;
+        glGetTexLevelParameteriv(target, level, parameter, &value);
+        return value;
+    }
+
+    GLenum GLDriverBackend::checkFramebufferStatus(GLenum target) {
+        return glCheckFramebufferStatus(target);
+    }
+
+#pragma mark - Resources
+
+    GLuint GLDriverBackend::genTexture() {
+        GLuint name = 0;
+        glGenTextures(1, &name);
+        return name;
+    }
+
+    void GLDriverBackend::deleteTexture(GLuint texture) {
+        glDeleteTextures(1, &texture);
+    }
+
+    GLuint GLDriverBackend::genSampler() {
+        GLuint name = 0;
+        glGenSamplers(1, &name);
+        return name;
+    }
+
+    void GLDriverBackend::deleteSampler(GLuint sampler) {
+        glDeleteSamplers(1, &sampler);
+    }
+
+    GLuint GLDriverBackend::genFramebuffer() {
+        GLuint name = 0;
+        glGenFramebuffers(1, &name);
+        return name;
+    }
+
+    void GLDriverBackend::deleteFramebuffer(GLuint framebuffer) {
+        glDeleteFramebuffers(1, &framebuffer);
+    }
+
+    GLuint GLDriverBackend::genRenderbuffer() {
+        GLuint name = 0;
+        glGenRenderbuffers(1, &name);
+        return name;
+    }
+
+    void GLDriverBackend::deleteRenderbuffer(GLuint renderbuffer) {
+        glDeleteRenderbuffers(1, &renderbuffer);
+    }
+
+    GLuint GLDriverBackend::genBuffer() {
+        GLuint name = 0;
+        glGenBuffers(1, &name);
+        return name;
+    }
+
+    void GLDriverBackend::deleteBuffer(GLuint buffer) {
+        glDeleteBuffers(1, &buffer);
+    }
+
+    GLuint GLDriverBackend::genVertexArray() {
+        GLuint name = 0;
+        glGenVertexArrays(1, &name);
+        return name;
+    }
+
+    void GLDriverBackend::deleteVertexArray(GLuint vertexArray) {
+        glDeleteVertexArrays(1, &vertexArray);
+    }
+
+    GLuint GLDriverBackend::createShader(GLenum type) {
+        return glCreateShader(type);
+    }
+
+    void GLDriverBackend::deleteShader(GLuint shader) {
+        glDeleteShader(shader);
+    }
+
+    GLuint GLDriverBackend::createProgram() {
+        return glCreateProgram();
+    }
+
+    void GLDriverBackend::deleteProgram(GLuint program) {
+        glDeleteProgram(program);
+    }
+
+#pragma mark - Bindings
+
+    void GLDriverBackend::bindFramebuffer(GLenum target, GLuint framebuffer) {
+        glBindFramebuffer(target, framebuffer);
+    }
+
+    void GLDriverBackend::bindRenderbuffer(GLenum target, GLuint renderbuffer) {
+        glBindRenderbuffer(target, renderbuffer);
+    }
+
+    void GLDriverBackend::useProgram(GLuint program) {
+        glUseProgram(program);
+    }
+
+    void GLDriverBackend::bindVertexArray(GLuint vertexArray) {
+        glBindVertexArray(vertexArray);
+    }
+
+    void GLDriverBackend::bindBuffer(GLenum target, GLuint buffer) {
+        glBindBuffer(target, buffer);
+    }
+
+    void GLDriverBackend::bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) {
+        glBindBufferRange(target, index, buffer, offset, size);
+    }
+
+    void GLDriverBackend::activeTexture(GLenum unit) {
+        glActiveTexture(unit);
+    }
+
+    void GLDriverBackend::bindTexture(GLenum target, GLuint texture) {
+        glBindTexture(target, texture);
+    }
+
+    void GLDriverBackend::bindSampler(GLuint unit, GLuint sampler) {
+        glBindSampler(unit, sampler);
+    }
+
+#pragma mark - Fixed function state
+
+    void GLDriverBackend::enable(GLenum capability) {
+        glEnable(capability);
+    }
+
+    void GLDriverBackend::disable(GLenum capability) {
+        glDisable(capability);
+    }
+
+    void GLDriverBackend::blendFunc(GLenum source, GLenum destination) {
+        glBlendFunc(source, destination);
+    }
+
+    void GLDriverBackend::depthMask(GLboolean flag) {
+        glDepthMask(flag);
+    }
+
+    void GLDriverBackend::depthFunc(GLenum function) {
+        glDepthFunc(function);
+    }
+
+    void GLDriverBackend::cullFace(GLenum mode) {
+        glCullFace(mode);
+    }
+
+    void GLDriverBackend::viewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+        glViewport(x, y, width, height);
+    }
+
+    void GLDriverBackend::scissor(GLint x, GLint y, GLsizei width, GLsizei height) {
+        glScissor(x, y, width, height);
+    }
+
+    void GLDriverBackend::drawBuffers(GLsizei count, const GLenum *buffers) {
+        glDrawBuffers(count, buffers);
+    }
+
+    void GLDriverBackend::readBuffer(GLenum mode) {
+        glReadBuffer(mode);
+    }
+
+    void GLDriverBackend::clearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) {
+        glClearColor(red, green, blue, alpha);
+    }
+
+    void GLDriverBackend::clearDepth(GLdouble depth) {
+        glClearDepth(depth);
+    }
+
+#pragma mark - Textures and samplers
+
+    void GLDriverBackend::texParameteri(GLenum target, GLenum parameter, GLint value) {
+        glTexParameteri(target, parameter, value);
+    }
+
+    void GLDriverBackend::texParameterf(GLenum target, GLenum parameter, GLfloat value) {
+        glTexParameterf(target, parameter, value);
+    }
+
+    void GLDriverBackend::texImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLenum format, GLenum type, const void *pixels) {
+        glTexImage2D(target, level, internalFormat, width, height, 0, format, type, pixels);
+    }
+
+    void GLDriverBackend::texStorage3D(GLenum target, GLsizei levels, GLenum internalFormat, GLsizei width, GLsizei height, GLsizei depth) {
+        glTexStorage3D(target, levels, internalFormat, width, height, depth);
+    }
+
+    void GLDriverBackend::texSubImage3D(GLenum target, GLint level, GLint xOffset, GLint yOffset, GLint zOffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const void *pixels) {
+        glTexSubImage3D(target, level, xOffset, yOffset, zOffset, width, height, depth, format, type, pixels);
+    }
+
+    void GLDriverBackend::generateMipmap(GLenum target) {
+        glGenerateMipmap(target);
+    }
+
+    void GLDriverBackend::texBuffer(GLenum target, GLenum internalFormat, GLuint buffer) {
+        glTexBuffer(target, internalFormat, buffer);
+    }
+
+    void GLDriverBackend::samplerParameteri(GLuint sampler, GLenum parameter, GLint value) {
+        glSamplerParameteri(sampler, parameter, value);
+    }
+
+    void GLDriverBackend::samplerParameterf(GLuint sampler, GLenum parameter, GLfloat value) {
+        glSamplerParameterf(sampler, parameter, value);
+    }
+
+#pragma mark - Framebuffers
+
+    void GLDriverBackend::renderbufferStorage(GLenum target, GLenum internalFormat, GLsizei width, GLsizei height) {
+        glRenderbufferStorage(target, internalFormat, width, height);
+    }
+
+    void GLDriverBackend::framebufferTexture(GLenum target, GLenum attachment, GLuint texture, GLint level) {
+        glFramebufferTexture(target, attachment, texture, level);
+    }
+
+    void GLDriverBackend::framebufferTextureLayer(GLenum target, GLenum attachment, GLuint texture, GLint level, GLint layer) {
+        glFramebufferTextureLayer(target, attachment, texture, level, layer);
+    }
+
+    void GLDriverBackend::framebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbufferTarget, GLuint renderbuffer) {
+        glFramebufferRenderbuffer(target, attachment, renderbufferTarget, renderbuffer);
+    }
+
+#pragma mark - Buffers and vertex arrays
+
+    void GLDriverBackend::bufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage) {
+        glBufferData(target, size, data, usage);
+    }
+
+    void *GLDriverBackend::mapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) {
+        return glMapBufferRange(target, offset, length, access);
+    }
+
+    void GLDriverBackend::unmapBuffer(GLenum target) {
+        glUnmapBuffer(target);
+    }
+
+    void GLDriverBackend::enableVertexAttribArray(GLuint index) {
+        glEnableVertexAttribArray(index);
+    }
+
+    void GLDriverBackend::vertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void *pointer) {
+        glVertexAttribPointer(index, size, type, normalized, stride, pointer);
+    }
+
+    void GLDriverBackend::vertexAttribDivisor(GLuint index, GLuint divisor) {
+        glVertexAttribDivisor(index, divisor);
+    }
+
+#pragma mark - Shaders and programs
+
+    void GLDriverBackend::shaderSource(GLuint shader, const GLchar *source) {
+        glShaderSource(shader, 1, &source, nullptr);
+    }
+
+    void GLDriverBackend::compileShader(GLuint shader) {
+        glCompileShader(shader);
+    }
+
+    GLint GLDriverBackend::shaderInteger(GLuint shader, GLenum parameter) {
+        GLint value = 0;
+        glGetShaderiv(shader, parameter, &value);
+        return value;
+    }
+
+    void GLDriverBackend::shaderInfoLog(GLuint shader, GLsizei bufferSize, GLchar *infoLog) {
+        glGetShaderInfoLog(shader, bufferSize, nullptr, infoLog);
+    }
+
+    void GLDriverBackend::attachShader(GLuint program, GLuint shader) {
+        glAttachShader(program, shader);
+    }
+
+    void GLDriverBackend::linkProgram(GLuint program) {
+        glLinkProgram(program);
+    }
+
+    void GLDriverBackend::validateProgram(GLuint program) {
+        glValidateProgram(program);
+    }
+
+    void GLDriverBackend::programParameteri(GLuint program, GLenum parameter, GLint value) {
+        glProgramParameteri(program, parameter, value);
+    }
+
+    void GLDriverBackend::programBinary(GLuint program, GLenum format, const void *binary, GLsizei length) {
+        glProgramBinary(program, format, binary, length);
+    }
+
+    void GLDriverBackend::getProgramBinary(GLuint program, GLsizei bufferSize, GLsizei *length, GLenum *format, void *binary) {
+        glGetProgramBinary(program, bufferSize, length, format, binary);
+    }
+
+    GLint GLDriverBackend::programInteger(GLuint program, GLenum parameter) {
+        GLint value = 0;
+        glGetProgramiv(program, parameter, &value);
+        return value;
+    }
+
+    void GLDriverBackend::programInfoLog(GLuint program, GLsizei bufferSize, GLsizei *length, GLchar *infoLog) {
+        glGetProgramInfoLog(program, bufferSize, length, infoLog);
+    }
+
+    void GLDriverBackend::activeAttrib(GLuint program, GLuint index, GLsizei bufferSize, GLint *size, GLenum *type, GLchar *name) {
+        glGetActiveAttrib(program, index, bufferSize, nullptr, size, type, name);
+    }
+
+    void GLDriverBackend::activeUniform(GLuint program, GLuint index, GLsizei bufferSize, GLint *size, GLenum *type, GLchar *name) {
+        glGetActiveUniform(program, index, bufferSize, nullptr, size, type, name);
+    }
+
+    GLint GLDriverBackend::uniformLocation(GLuint program, const GLchar *name) {
+        return glGetUniformLocation(program, name);
+    }
+
+    GLint GLDriverBackend::activeUniformBlockInteger(GLuint program, GLuint blockIndex, GLenum parameter) {
+        GLint value = 0;
+        glGetActiveUniformBlockiv(program, blockIndex, parameter, &value);
+        return value;
+    }
+
+    void GLDriverBackend::activeUniformBlockName(GLuint program, GLuint blockIndex, GLsizei bufferSize, GLchar *name) {
+        glGetActiveUniformBlockName(program, blockIndex, bufferSize, nullptr, name);
+    }
+
+    void GLDriverBackend::uniformBlockBinding(GLuint program, GLuint blockIndex, GLuint binding) {
+        glUniformBlockBinding(program, blockIndex, binding);
+    }
+
+#pragma mark - Uniforms
+
+    void GLDriverBackend::uniform1f(GLint location, GLfloat value) {
+        glUniform1f(location, value);
+    }
+
+    void GLDriverBackend::uniform1i(GLint location, GLint value) {
+        glUniform1i(location, value);
+    }
+
+    void GLDriverBackend::uniform1ui(GLint location, GLuint value) {
+        glUniform1ui(location, value);
+    }
+
+    void GLDriverBackend::uniform1fv(GLint location, GLsizei count, const GLfloat *values) {
+        glUniform1fv(location, count, values);
+    }
+
+    void GLDriverBackend::uniform2fv(GLint location, GLsizei count, const GLfloat *values) {
+        glUniform2fv(location, count, values);
+    }
+
+    void GLDriverBackend::uniform3fv(GLint location, GLsizei count, const GLfloat *values) {
+        glUniform3fv(location, count, values);
+    }
+
+    void GLDriverBackend::uniform4fv(GLint location, GLsizei count, const GLfloat *values) {
+        glUniform4fv(location, count, values);
+    }
+
+    void GLDriverBackend::uniform3iv(GLint location, GLsizei count, const GLint *values) {
+        glUniform3iv(location, count, values);
+    }
+
+    void GLDriverBackend::uniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *values) {
+        glUniformMatrix4fv(location, count, transpose, values);
+    }
+
+#pragma mark - Commands
+
+    void GLDriverBackend::clear(GLbitfield mask) {
+        glClear(mask);
+    }
+
+    void GLDriverBackend::blitFramebuffer(GLint sourceX0, GLint sourceY0, GLint sourceX1, GLint sourceY1, GLint destinationX0, GLint destinationY0, GLint destinationX1, GLint destinationY1, GLbitfield mask, GLenum filter) {
+        glBlitFramebuffer(sourceX0, sourceY0, sourceX1, sourceY1, destinationX0, destinationY0, destinationX1, destinationY1, mask, filter);
+    }
+
+    void GLDriverBackend::drawArrays(GLenum mode, GLint first, GLsizei count) {
+        glDrawArrays(mode, first, count);
+    }
+
+    void GLDriverBackend::drawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instanceCount) {
+        glDrawArraysInstanced(mode, first, count, instanceCount);
+    }
+
+    void GLDriverBackend::multiDrawArrays(GLenum mode, const GLint *first, const GLsizei *count, GLsizei drawCount) {
+        glMultiDrawArrays(mode, first, count, drawCount);
+    }
+
+}
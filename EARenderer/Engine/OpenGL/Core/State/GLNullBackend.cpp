@@ -0,0 +1,526 @@
+//
+// Created by Pavlo Muratov on 2019-02-08.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "GLNullBackend.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <regex>
+#include <sstream>
+
+namespace EARenderer {
+
+    namespace {
+
+        struct Declaration {
+            std::string type;
+            std::string name;
+            // Zero if the declaration isn't an array
+            GLint arraySize = 0;
+        };
+
+        /**
+         Declarations of a single shader stage, enough to name uniforms the way a driver does
+         */
+        struct ShaderInterface {
+            std::unordered_map<std::string, std::vector<Declaration>> structs;
+            std::vector<Declaration> uniforms;
+            std::vector<std::string> uniformBlocks;
+        };
+
+        const std::unordered_map<std::string, GLenum> &UniformTypes() {
+            static const std::unordered_map<std::string, GLenum> types{
+                    {"float", GL_FLOAT}, {"vec2", GL_FLOAT_VEC2}, {"vec3", GL_FLOAT_VEC3}, {"vec4", GL_FLOAT_VEC4},
+                    {"int", GL_INT}, {"ivec2", GL_INT_VEC2}, {"ivec3", GL_INT_VEC3}, {"ivec4", GL_INT_VEC4},
+                    {"uint", GL_UNSIGNED_INT}, {"uvec2", GL_UNSIGNED_INT_VEC2}, {"uvec3", GL_UNSIGNED_INT_VEC3}, {"uvec4", GL_UNSIGNED_INT_VEC4},
+                    {"bool", GL_BOOL}, {"mat2", GL_FLOAT_MAT2}, {"mat3", GL_FLOAT_MAT3}, {"mat4", GL_FLOAT_MAT4},
+                    {"sampler1D", GL_SAMPLER_1D}, {"sampler2D", GL_SAMPLER_2D}, {"sampler3D", GL_SAMPLER_3D}, {"samplerCube", GL_SAMPLER_CUBE},
+                    {"sampler2DShadow", GL_SAMPLER_2D_SHADOW}, {"sampler2DArray", GL_SAMPLER_2D_ARRAY}, {"sampler2DArrayShadow", GL_SAMPLER_2D_ARRAY_SHADOW},
+                    {"samplerCubeShadow", GL_SAMPLER_CUBE_SHADOW}, {"samplerCubeArray", GL_SAMPLER_CUBE_MAP_ARRAY}, {"samplerBuffer", GL_SAMPLER_BUFFER},
+                    {"isampler2D", GL_INT_SAMPLER_2D}, {"isampler3D", GL_INT_SAMPLER_3D}, {"isamplerBuffer", GL_INT_SAMPLER_BUFFER},
+                    {"usampler2D", GL_UNSIGNED_INT_SAMPLER_2D}, {"usampler3D", GL_UNSIGNED_INT_SAMPLER_3D},
+                    {"usampler2DArray", GL_UNSIGNED_INT_SAMPLER_2D_ARRAY}, {"usamplerBuffer", GL_UNSIGNED_INT_SAMPLER_BUFFER}
+            };
+            return types;
+        }
+
+        std::vector<std::string> Tokens(const std::string &text) {
+            std::istringstream stream(text);
+            std::vector<std::string> tokens;
+            for (std::string token; stream >> token;) {
+                tokens.push_back(token);
+            }
+            return tokens;
+        }
+
+        std::string StrippedComments(const std::string &source) {
+            static const std::regex comments(R"(/\*[\s\S]*?\*/|//[^\n]*)");
+            return std::regex_replace(source, comments, " ");
+        }
+
+        /**
+         Evaluates conditions the engine's shaders use: defined(NAME), !defined(NAME), NAME and integer literals.
+         Anything more elaborate is considered true.
+         */
+        bool EvaluateCondition(std::string condition, const std::unordered_map<std::string, std::string> &definitions) {
+            static const std::regex defined(R"(^\s*(!?)\s*defined\s*\(?\s*(\w+)\s*\)?\s*$)");
+            static const std::regex word(R"(^\s*(!?)\s*(\w+)\s*$)");
+
+            std::smatch match;
+            if (std::regex_match(condition, match, defined)) {
+                bool isDefined = definitions.count(match[2]) > 0;
+                return isDefined != (match[1].length() > 0);
+            }
+            if (std::regex_match(condition, match, word)) {
+                std::string value = match[2];
+                auto it = definitions.find(value);
+                if (it != definitions.end()) {
+                    value = it->second;
+                }
+                bool isTrue = !value.empty() && std::all_of(value.begin(), value.end(), ::isdigit) && std::stol(value) != 0;
+                return isTrue != (match[1].length() > 0);
+            }
+            return true;
+        }
+
+        /**
+         @return source without comments, preprocessor directives and lines excluded by conditional directives
+         */
+        std::string ActiveSource(const std::string &source, std::unordered_map<std::string, std::string> &definitions) {
+            struct Conditional {
+                bool parentActive;
+                bool active;
+                bool taken;
+            };
+
+            std::vector<Conditional> conditionals;
+            auto isActive = [&] { return conditionals.empty() || conditionals.back().active; };
+
+            std::istringstream lines(StrippedComments(source));
+            std::string activeSource;
+
+            for (std::string line; std::getline(lines, line);) {
+                auto tokens = Tokens(line);
+                if (tokens.empty() || tokens[0][0] != '#') {
+                    if (isActive()) {
+                        activeSource += line + "\n";
+                    }
+                    continue;
+                }
+
+                // Directives may be written as "# ifdef"
+                std::string directive = tokens[0].size() > 1 ? tokens[0].substr(1) : (tokens.size() > 1 ? tokens[1] : "");
+                std::string argument = line.substr(line.find(directive) + directive.size());
+
+                if (directive == "ifdef" || directive == "ifndef" || directive == "if") {
+                    bool condition = directive == "if" ? EvaluateCondition(argument, definitions) :
+                            (definitions.count(Tokens(argument).empty() ? "" : Tokens(argument)[0]) > 0) == (directive == "ifdef");
+                    bool parentActive = isActive();
+                    conditionals.push_back({parentActive, parentActive && condition, condition});
+                } else if (directive == "elif" && !conditionals.empty()) {
+                    auto &conditional = conditionals.back();
+                    bool condition = !conditional.taken && EvaluateCondition(argument, definitions);
+                    conditional.active = conditional.parentActive && condition;
+                    conditional.taken = conditional.taken || condition;
+                } else if (directive == "else" && !conditionals.empty()) {
+                    auto &conditional = conditionals.back();
+                    conditional.active = conditional.parentActive && !conditional.taken;
+                    conditional.taken = true;
+                } else if (directive == "endif" && !conditionals.empty()) {
+                    conditionals.pop_back();
+                } else if (directive == "define" && isActive()) {
+                    auto arguments = Tokens(argument);
+                    if (!arguments.empty()) {
+                        definitions[arguments[0]] = arguments.size() > 1 ? arguments[1] : "";
+                    }
+                }
+            }
+
+            return activeSource;
+        }
+
+        GLint ArraySize(const std::string &expression, const std::unordered_map<std::string, std::string> &constants) {
+            auto tokens = Tokens(expression);
+            if (tokens.empty()) {
+                return 1;
+            }
+
+            std::string value = tokens[0];
+            auto it = constants.find(value);
+            if (it != constants.end()) {
+                value = it->second;
+            }
+
+            bool isNumber = !value.empty() && std::all_of(value.begin(), value.end(), ::isdigit);
+            return isNumber ? std::max(GLint(std::stol(value)), 1) : 1;
+        }
+
+        /**
+         @param text declaration without qualifiers, e.g. "float uSplits[Count], uBias"
+         */
+        std::vector<Declaration> Declarations(const std::string &text, const std::unordered_map<std::string, std::string> &constants) {
+            static const std::regex declarator(R"(^\s*(\w+)\s*(?:\[([^\]]*)\])?\s*$)");
+
+            std::vector<Declaration> declarations;
+
+            auto tokens = Tokens(text);
+            if (tokens.size() < 2) {
+                return declarations;
+            }
+
+            std::string type = tokens[0];
+            std::string declarators = text.substr(text.find(type) + type.size());
+
+            std::istringstream stream(declarators);
+            for (std::string declaratorText; std::getline(stream, declaratorText, ',');) {
+                std::smatch match;
+                if (!std::regex_match(declaratorText, match, declarator)) {
+                    continue;
+                }
+
+                Declaration declaration;
+                declaration.type = type;
+                declaration.name = match[1];
+                declaration.arraySize = match[2].matched ? ArraySize(match[2], constants) : 0;
+                declarations.push_back(declaration);
+            }
+
+            return declarations;
+        }
+
+        void ParseStatement(std::string statement, ShaderInterface &interface, std::unordered_map<std::string, std::string> &constants) {
+            static const std::regex layout(R"(\blayout\s*\([^)]*\))");
+            static const std::regex precision(R"(\b(highp|mediump|lowp)\b)");
+            static const std::regex constant(R"(^\s*const\s+u?int\s+(\w+)\s*=\s*(\d+)u?\s*$)");
+
+            statement = std::regex_replace(statement, layout, " ");
+            statement = std::regex_replace(statement, precision, " ");
+
+            size_t bodyStart = statement.find('{');
+            if (bodyStart != std::string::npos) {
+                auto head = Tokens(statement.substr(0, bodyStart));
+                size_t bodyEnd = statement.rfind('}');
+                std::string body = statement.substr(bodyStart + 1, bodyEnd - bodyStart - 1);
+
+                if (head.size() == 2 && head[0] == "struct") {
+                    auto &members = interface.structs[head[1]];
+                    std::istringstream stream(body);
+                    for (std::string member; std::getline(stream, member, ';');) {
+                        auto declarations = Declarations(member, constants);
+                        members.insert(members.end(), declarations.begin(), declarations.end());
+                    }
+                } else if (head.size() >= 2 && std::find(head.begin(), head.end(), "uniform") != head.end()) {
+                    interface.uniformBlocks.push_back(head.back());
+                }
+                return;
+            }
+
+            std::smatch match;
+            if (std::regex_match(statement, match, constant)) {
+                constants[match[1]] = match[2];
+                return;
+            }
+
+            auto tokens = Tokens(statement);
+            if (!tokens.empty() && tokens[0] == "uniform") {
+                auto declarations = Declarations(statement.substr(statement.find("uniform") + 7), constants);
+                interface.uniforms.insert(interface.uniforms.end(), declarations.begin(), declarations.end());
+            }
+        }
+
+        ShaderInterface Interface(const std::string &source) {
+            std::unordered_map<std::string, std::string> constants;
+            std::string activeSource = ActiveSource(source, constants);
+
+            ShaderInterface interface;
+            std::string statement;
+            int depth = 0;
+
+            for (char character : activeSource) {
+                statement += character;
+
+                if (character == '{') {
+                    depth++;
+                } else if (character == '}') {
+                    depth = std::max(depth - 1, 0);
+
+                    // Function bodies end without a semicolon
+                    if (depth == 0) {
+                        auto head = Tokens(statement.substr(0, statement.find('{')));
+                        bool isDeclaration = std::find(head.begin(), head.end(), "struct") != head.end() ||
+                                std::find(head.begin(), head.end(), "uniform") != head.end();
+                        if (!isDeclaration) {
+                            statement.clear();
+                        }
+                    }
+                } else if (character == ';' && depth == 0) {
+                    statement.pop_back();
+                    ParseStatement(statement, interface, constants);
+                    statement.clear();
+                }
+            }
+
+            return interface;
+        }
+
+        /**
+         Expands structures and arrays of structures into separate uniforms, arrays of basic types are named by their first element
+         */
+        template<class ActiveUniform>
+        void AppendUniforms(const ShaderInterface &interface, const Declaration &declaration, const std::string &name, std::vector<ActiveUniform> &uniforms) {
+            auto structIt = interface.structs.find(declaration.type);
+
+            if (structIt == interface.structs.end()) {
+                auto typeIt = UniformTypes().find(declaration.type);
+                if (typeIt == UniformTypes().end()) {
+                    return;
+                }
+
+                std::string uniformName = declaration.arraySize > 0 ? name + "[0]" : name;
+                bool isDeclared = std::any_of(uniforms.begin(), uniforms.end(), [&](const ActiveUniform &uniform) { return uniform.name == uniformName; });
+                if (!isDeclared) {
+                    uniforms.push_back({uniformName, std::max(declaration.arraySize, 1), typeIt->second});
+                }
+                return;
+            }
+
+            for (GLint element = 0; element < std::max(declaration.arraySize, 1); element++) {
+                std::string elementName = declaration.arraySize > 0 ? name + "[" + std::to_string(element) + "]" : name;
+                for (auto &member : structIt->second) {
+                    AppendUniforms(interface, member, elementName + "." + member.name, uniforms);
+                }
+            }
+        }
+
+        void CopyName(const std::string &name, GLsizei bufferSize, GLchar *buffer) {
+            if (bufferSize <= 0) {
+                return;
+            }
+            size_t length = std::min(name.size(), size_t(bufferSize - 1));
+            memcpy(buffer, name.data(), length);
+            buffer[length] = '\0';
+        }
+
+    }
+
+#pragma mark - Lifecycle
+
+    GLNullBackend::GLNullBackend() {
+        mIntegers[GL_MAX_TEXTURE_IMAGE_UNITS] = 16;
+        mIntegers[GL_MAX_COLOR_ATTACHMENTS] = 8;
+        mIntegers[GL_MAX_DRAW_BUFFERS] = 8;
+        mIntegers[GL_MAX_UNIFORM_BUFFER_BINDINGS] = 24;
+        mIntegers[GL_MAX_UNIFORM_BLOCK_SIZE] = 64 * 1024;
+        mIntegers[GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT] = 256;
+    }
+
+#pragma mark - Private helpers
+
+    GLuint GLNullBackend::nextName() {
+        return ++mLastName;
+    }
+
+#pragma mark - Queries
+
+    void GLNullBackend::setInteger(GLenum parameter, GLint value) {
+        mIntegers[parameter] = value;
+    }
+
+    GLint GLNullBackend::integer(GLenum parameter) {
+        auto it = mIntegers.find(parameter);
+        return it != mIntegers.end() ? it->second : 0;
+    }
+
+    GLfloat GLNullBackend::floatValue(GLenum parameter) {
+        return 0.0;
+    }
+
+    const GLubyte *GLNullBackend::string(GLenum name) {
+        return reinterpret_cast<const GLubyte *>("Null");
+    }
+
+    GLint GLNullBackend::textureLevelInteger(GLenum target, GLint level, GLenum parameter) {
+        return 0;
+    }
+
+    GLenum GLNullBackend::checkFramebufferStatus(GLenum target) {
+        return GL_FRAMEBUFFER_COMPLETE;
+    }
+
+#pragma mark - Resources
+
+    GLuint GLNullBackend::genTexture() {
+        return nextName();
+    }
+
+    GLuint GLNullBackend::genSampler() {
+        return nextName();
+    }
+
+    GLuint GLNullBackend::genFramebuffer() {
+        return nextName();
+    }
+
+    GLuint GLNullBackend::genRenderbuffer() {
+        return nextName();
+    }
+
+    GLuint GLNullBackend::genBuffer() {
+        return nextName();
+    }
+
+    GLuint GLNullBackend::genVertexArray() {
+        return nextName();
+    }
+
+    GLuint GLNullBackend::createShader(GLenum type) {
+        return nextName();
+    }
+
+    GLuint GLNullBackend::createProgram() {
+        return nextName();
+    }
+
+#pragma mark - Buffers and vertex arrays
+
+    void *GLNullBackend::mapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) {
+        mMappedBuffer.resize(size_t(length));
+        return mMappedBuffer.data();
+    }
+
+#pragma mark - Shaders and programs
+
+    void GLNullBackend::deleteShader(GLuint shader) {
+        mShaderSources.erase(shader);
+    }
+
+    void GLNullBackend::deleteProgram(GLuint program) {
+        mProgramShaders.erase(program);
+        mProgramInterfaces.erase(program);
+    }
+
+    void GLNullBackend::shaderSource(GLuint shader, const GLchar *source) {
+        mShaderSources[shader] = source;
+    }
+
+    void GLNullBackend::attachShader(GLuint program, GLuint shader) {
+        mProgramShaders[program].push_back(shader);
+    }
+
+    void GLNullBackend::linkProgram(GLuint program) {
+        ProgramInterface programInterface;
+
+        for (GLuint shader : mProgramShaders[program]) {
+            ShaderInterface shaderInterface = Interface(mShaderSources[shader]);
+
+            for (auto &uniform : shaderInterface.uniforms) {
+                AppendUniforms(shaderInterface, uniform, uniform.name, programInterface.uniforms);
+            }
+
+            for (auto &block : shaderInterface.uniformBlocks) {
+                auto &blocks = programInterface.uniformBlocks;
+                if (std::find(blocks.begin(), blocks.end(), block) == blocks.end()) {
+                    blocks.push_back(block);
+                }
+            }
+        }
+
+        mProgramInterfaces[program] = programInterface;
+    }
+
+    GLint GLNullBackend::shaderInteger(GLuint shader, GLenum parameter) {
+        return parameter == GL_COMPILE_STATUS ? GL_TRUE : 0;
+    }
+
+    void GLNullBackend::shaderInfoLog(GLuint shader, GLsizei bufferSize, GLchar *infoLog) {
+        if (bufferSize > 0) {
+            infoLog[0] = '\0';
+        }
+    }
+
+    void GLNullBackend::getProgramBinary(GLuint program, GLsizei bufferSize, GLsizei *length, GLenum *format, void *binary) {
+        if (length) {
+            *length = 0;
+        }
+        *format = 0;
+    }
+
+    GLint GLNullBackend::programInteger(GLuint program, GLenum parameter) {
+        switch (parameter) {
+            case GL_LINK_STATUS:
+            case GL_VALIDATE_STATUS:
+                return GL_TRUE;
+
+            case GL_ACTIVE_UNIFORMS:
+                return GLint(mProgramInterfaces[program].uniforms.size());
+
+            case GL_ACTIVE_UNIFORM_BLOCKS:
+                return GLint(mProgramInterfaces[program].uniformBlocks.size());
+
+            default:
+                return 0;
+        }
+    }
+
+    void GLNullBackend::programInfoLog(GLuint program, GLsizei bufferSize, GLsizei *length, GLchar *infoLog) {
+        if (length) {
+            *length = 0;
+        }
+        if (bufferSize > 0) {
+            infoLog[0] = '\0';
+        }
+    }
+
+    void GLNullBackend::activeAttrib(GLuint program, GLuint index, GLsizei bufferSize, GLint *size, GLenum *type, GLchar *name) {
+        *size = 0;
+        *type = 0;
+        if (bufferSize > 0) {
+            name[0] = '\0';
+        }
+    }
+
+    void GLNullBackend::activeUniform(GLuint program, GLuint index, GLsizei bufferSize, GLint *size, GLenum *type, GLchar *name) {
+        auto &uniforms = mProgramInterfaces[program].uniforms;
+        if (index >= uniforms.size()) {
+            *size = 0;
+            *type = 0;
+            CopyName("", bufferSize, name);
+            return;
+        }
+
+        *size = uniforms[index].size;
+        *type = uniforms[index].type;
+        CopyName(uniforms[index].name, bufferSize, name);
+    }
+
+    GLint GLNullBackend::uniformLocation(GLuint program, const GLchar *name) {
+        auto &uniforms = mProgramInterfaces[program].uniforms;
+        std::string uniformName(name);
+
+        for (size_t i = 0; i < uniforms.size(); i++) {
+            // Arrays can be located by their names as well as by their first elements
+            if (uniforms[i].name == uniformName || uniforms[i].name == uniformName + "[0]") {
+                return GLint(i);
+            }
+        }
+
+        return -1;
+    }
+
+    GLint GLNullBackend::activeUniformBlockInteger(GLuint program, GLuint blockIndex, GLenum parameter) {
+        auto &blocks = mProgramInterfaces[program].uniformBlocks;
+        if (parameter != GL_UNIFORM_BLOCK_NAME_LENGTH || blockIndex >= blocks.size()) {
+            return 0;
+        }
+        return GLint(blocks[blockIndex].size() + 1);
+    }
+
+    void GLNullBackend::activeUniformBlockName(GLuint program, GLuint blockIndex, GLsizei bufferSize, GLchar *name) {
+        auto &blocks = mProgramInterfaces[program].uniformBlocks;
+        CopyName(blockIndex < blocks.size() ? blocks[blockIndex] : "", bufferSize, name);
+    }
+
+}
@@ -0,0 +1,240 @@
+//
+// Created by Pavlo Muratov on 2019-02-08.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_GLNULLBACKEND_HPP
+#define EARENDERER_GLNULLBACKEND_HPP
+
+#include "GLBackend.hpp"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace EARenderer {
+
+    /**
+     Discards all commands, which leaves only the CPU cost of submission.
+     Queries are answered from a table of limits typical for desktop hardware, which can be overridden.
+     Objects get unique names, shaders always compile and programs always link. Linked programs report uniforms
+     and uniform blocks declared in their sources as active, so passes can be created without a driver as well.
+     */
+    class GLNullBackend : public GLBackend {
+    private:
+        struct ActiveUniform {
+            std::string name;
+            GLint size;
+            GLenum type;
+        };
+
+        struct ProgramInterface {
+            std::vector<ActiveUniform> uniforms;
+            std::vector<std::string> uniformBlocks;
+        };
+
+        std::unordered_map<GLenum, GLint> mIntegers;
+        std::unordered_map<GLuint, std::string> mShaderSources;
+        std::unordered_map<GLuint, std::vector<GLuint>> mProgramShaders;
+        std::unordered_map<GLuint, ProgramInterface> mProgramInterfaces;
+        GLuint mLastName = 0;
+        // Receives writes to mapped buffers
+        std::vector<uint8_t> mMappedBuffer;
+
+        GLuint nextName();
+
+    public:
+        GLNullBackend();
+
+        void setInteger(GLenum parameter, GLint value);
+
+        GLint integer(GLenum parameter) override;
+
+        GLfloat floatValue(GLenum parameter) override;
+
+        const GLubyte *string(GLenum name) override;
+
+        GLint textureLevelInteger(GLenum target, GLint level, GLenum parameter) override;
+
+        GLenum checkFramebufferStatus(GLenum target) override;
+
+        GLuint genTexture() override;
+
+        void deleteTexture(GLuint texture) override {}
+
+        GLuint genSampler() override;
+
+        void deleteSampler(GLuint sampler) override {}
+
+        GLuint genFramebuffer() override;
+
+        void deleteFramebuffer(GLuint framebuffer) override {}
+
+        GLuint genRenderbuffer() override;
+
+        void deleteRenderbuffer(GLuint renderbuffer) override {}
+
+        GLuint genBuffer() override;
+
+        void deleteBuffer(GLuint buffer) override {}
+
+        GLuint genVertexArray() override;
+
+        void deleteVertexArray(GLuint vertexArray) override {}
+
+        GLuint createShader(GLenum type) override;
+
+        void deleteShader(GLuint shader) override;
+
+        GLuint createProgram() override;
+
+        void deleteProgram(GLuint program) override;
+
+        void bindFramebuffer(GLenum target, GLuint framebuffer) override {}
+
+        void bindRenderbuffer(GLenum target, GLuint renderbuffer) override {}
+
+        void useProgram(GLuint program) override {}
+
+        void bindVertexArray(GLuint vertexArray) override {}
+
+        void bindBuffer(GLenum target, GLuint buffer) override {}
+
+        void bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) override {}
+
+        void activeTexture(GLenum unit) override {}
+
+        void bindTexture(GLenum target, GLuint texture) override {}
+
+        void bindSampler(GLuint unit, GLuint sampler) override {}
+
+        void enable(GLenum capability) override {}
+
+        void disable(GLenum capability) override {}
+
+        void blendFunc(GLenum source, GLenum destination) override {}
+
+        void depthMask(GLboolean flag) override {}
+
+        void depthFunc(GLenum function) override {}
+
+        void cullFace(GLenum mode) override {}
+
+        void viewport(GLint x, GLint y, GLsizei width, GLsizei height) override {}
+
+        void scissor(GLint x, GLint y, GLsizei width, GLsizei height) override {}
+
+        void drawBuffers(GLsizei count, const GLenum *buffers) override {}
+
+        void readBuffer(GLenum mode) override {}
+
+        void clearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) override {}
+
+        void clearDepth(GLdouble depth) override {}
+
+        void texParameteri(GLenum target, GLenum parameter, GLint value) override {}
+
+        void texParameterf(GLenum target, GLenum parameter, GLfloat value) override {}
+
+        void texImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLenum format, GLenum type, const void *pixels) override {}
+
+        void texStorage3D(GLenum target, GLsizei levels, GLenum internalFormat, GLsizei width, GLsizei height, GLsizei depth) override {}
+
+        void texSubImage3D(GLenum target, GLint level, GLint xOffset, GLint yOffset, GLint zOffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const void *pixels) override {}
+
+        void generateMipmap(GLenum target) override {}
+
+        void texBuffer(GLenum target, GLenum internalFormat, GLuint buffer) override {}
+
+        void samplerParameteri(GLuint sampler, GLenum parameter, GLint value) override {}
+
+        void samplerParameterf(GLuint sampler, GLenum parameter, GLfloat value) override {}
+
+        void renderbufferStorage(GLenum target, GLenum internalFormat, GLsizei width, GLsizei height) override {}
+
+        void framebufferTexture(GLenum target, GLenum attachment, GLuint texture, GLint level) override {}
+
+        void framebufferTextureLayer(GLenum target, GLenum attachment, GLuint texture, GLint level, GLint layer) override {}
+
+        void framebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbufferTarget, GLuint renderbuffer) override {}
+
+        void bufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage) override {}
+
+        void *mapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) override;
+
+        void unmapBuffer(GLenum target) override {}
+
+        void enableVertexAttribArray(GLuint index) override {}
+
+        void vertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void *pointer) override {}
+
+        void vertexAttribDivisor(GLuint index, GLuint divisor) override {}
+
+        void shaderSource(GLuint shader, const GLchar *source) override;
+
+        void compileShader(GLuint shader) override {}
+
+        GLint shaderInteger(GLuint shader, GLenum parameter) override;
+
+        void shaderInfoLog(GLuint shader, GLsizei bufferSize, GLchar *infoLog) override;
+
+        void attachShader(GLuint program, GLuint shader) override;
+
+        void linkProgram(GLuint program) override;
+
+        void validateProgram(GLuint program) override {}
+
+        void programParameteri(GLuint program, GLenum parameter, GLint value) override {}
+
+        void programBinary(GLuint program, GLenum format, const void *binary, GLsizei length) override {}
+
+        void getProgramBinary(GLuint program, GLsizei bufferSize, GLsizei *length, GLenum *format, void *binary) override;
+
+        GLint programInteger(GLuint program, GLenum parameter) override;
+
+        void programInfoLog(GLuint program, GLsizei bufferSize, GLsizei *length, GLchar *infoLog) override;
+
+        void activeAttrib(GLuint program, GLuint index, GLsizei bufferSize, GLint *size, GLenum *type, GLchar *name) override;
+
+        void activeUniform(GLuint program, GLuint index, GLsizei bufferSize, GLint *size, GLenum *type, GLchar *name) override;
+
+        GLint uniformLocation(GLuint program, const GLchar *name) override;
+
+        GLint activeUniformBlockInteger(GLuint program, GLuint blockIndex, GLenum parameter) override;
+
+        void activeUniformBlockName(GLuint program, GLuint blockIndex, GLsizei bufferSize, GLchar *name) override;
+
+        void uniformBlockBinding(GLuint program, GLuint blockIndex, GLuint binding) override {}
+
+        void uniform1f(GLint location, GLfloat value) override {}
+
+        void uniform1i(GLint location, GLint value) override {}
+
+        void uniform1ui(GLint location, GLuint value) override {}
+
+        void uniform1fv(GLint location, GLsizei count, const GLfloat *values) override {}
+
+        void uniform2fv(GLint location, GLsizei count, const GLfloat *values) override {}
+
+        void uniform3fv(GLint location, GLsizei count, const GLfloat *values) override {}
+
+        void uniform4fv(GLint location, GLsizei count, const GLfloat *values) override {}
+
+        void uniform3iv(GLint location, GLsizei count, const GLint *values) override {}
+
+        void uniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *values) override {}
+
+        void clear(GLbitfield mask) override {}
+
+        void blitFramebuffer(GLint sourceX0, GLint sourceY0, GLint sourceX1, GLint sourceY1, GLint destinationX0, GLint destinationY0, GLint destinationX1, GLint destinationY1, GLbitfield mask, GLenum filter) override {}
+
+        void drawArrays(GLenum mode, GLint first, GLsizei count) override {}
+
+        void drawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instanceCount) override {}
+
+        void multiDrawArrays(GLenum mode, const GLint *first, const GLsizei *count, GLsizei drawCount) override {}
+    };
+
+}
+
+#endif //EARENDERER_GLNULLBACKEND_HPP
@@ -0,0 +1,909 @@
+//
+// Created by Pavlo Muratov on 2019-02-08.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "GLRecordingBackend.hpp"
+
+#include <algorithm>
+
+namespace EARenderer {
+
+#pragma mark - Command
+
+    GLRecordingBackend::Command::Command(Function function, std::vector<int64_t> arguments)
+            : function(function), arguments(std::move(arguments)) {}
+
+    bool GLRecordingBackend::Command::operator==(const Command &rhs) const {
+        return function == rhs.function && arguments == rhs.arguments;
+    }
+
+    bool GLRecordingBackend::Command::operator!=(const Command &rhs) const {
+        return !(rhs == *this);
+    }
+
+    std::string GLRecordingBackend::Command::description() const {
+        std::string name;
+
+        switch (function) {
+            case Function::GenTexture:
+                name = "glGenTextures";
+                break;
+
+            case Function::DeleteTexture:
+                name = "glDeleteTextures";
+                break;
+
+            case Function::GenSampler:
+                name = "glGenSamplers";
+                break;
+
+            case Function::DeleteSampler:
+                name = "glDeleteSamplers";
+                break;
+
+            case Function::GenFramebuffer:
+                name = "glGenFramebuffers";
+                break;
+
+            case Function::DeleteFramebuffer:
+                name = "glDeleteFramebuffers";
+                break;
+
+            case Function::GenRenderbuffer:
+                name = "glGenRenderbuffers";
+                break;
+
+            case Function::DeleteRenderbuffer:
+                name = "glDeleteRenderbuffers";
+                break;
+
+            case Function::GenBuffer:
+                name = "glGenBuffers";
+                break;
+
+            case Function::DeleteBuffer:
+                name = "glDeleteBuffers";
+                break;
+
+            case Function::GenVertexArray:
+                name = "glGenVertexArrays";
+                break;
+
+            case Function::DeleteVertexArray:
+                name = "glDeleteVertexArrays";
+                break;
+
+            case Function::CreateShader:
+                name = "glCreateShader";
+                break;
+
+            case Function::DeleteShader:
+                name = "glDeleteShader";
+                break;
+
+            case Function::CreateProgram:
+                name = "glCreateProgram";
+                break;
+
+            case Function::DeleteProgram:
+                name = "glDeleteProgram";
+                break;
+
+            case Function::BindFramebuffer:
+                name = "glBindFramebuffer";
+                break;
+
+            case Function::BindRenderbuffer:
+                name = "glBindRenderbuffer";
+                break;
+
+            case Function::UseProgram:
+                name = "glUseProgram";
+                break;
+
+            case Function::BindVertexArray:
+                name = "glBindVertexArray";
+                break;
+
+            case Function::BindBuffer:
+                name = "glBindBuffer";
+                break;
+
+            case Function::BindBufferRange:
+                name = "glBindBufferRange";
+                break;
+
+            case Function::ActiveTexture:
+                name = "glActiveTexture";
+                break;
+
+            case Function::BindTexture:
+                name = "glBindTexture";
+                break;
+
+            case Function::BindSampler:
+                name = "glBindSampler";
+                break;
+
+            case Function::Enable:
+                name = "glEnable";
+                break;
+
+            case Function::Disable:
+                name = "glDisable";
+                break;
+
+            case Function::BlendFunc:
+                name = "glBlendFunc";
+                break;
+
+            case Function::DepthMask:
+                name = "glDepthMask";
+                break;
+
+            case Function::DepthFunc:
+                name = "glDepthFunc";
+                break;
+
+            case Function::CullFace:
+                name = "glCullFace";
+                break;
+
+            case Function::Viewport:
+                name = "glViewport";
+                break;
+
+            case Function::Scissor:
+                name = "glScissor";
+                break;
+
+            case Function::DrawBuffers:
+                name = "glDrawBuffers";
+                break;
+
+            case Function::ReadBuffer:
+                name = "glReadBuffer";
+                break;
+
+            case Function::ClearColor:
+                name = "glClearColor";
+                break;
+
+            case Function::ClearDepth:
+                name = "glClearDepth";
+                break;
+
+            case Function::TexParameteri:
+                name = "glTexParameteri";
+                break;
+
+            case Function::TexParameterf:
+                name = "glTexParameterf";
+                break;
+
+            case Function::TexImage2D:
+                name = "glTexImage2D";
+                break;
+
+            case Function::TexStorage3D:
+                name = "glTexStorage3D";
+                break;
+
+            case Function::TexSubImage3D:
+                name = "glTexSubImage3D";
+                break;
+
+            case Function::GenerateMipmap:
+                name = "glGenerateMipmap";
+                break;
+
+            case Function::TexBuffer:
+                name = "glTexBuffer";
+                break;
+
+            case Function::SamplerParameteri:
+                name = "glSamplerParameteri";
+                break;
+
+            case Function::SamplerParameterf:
+                name = "glSamplerParameterf";
+                break;
+
+            case Function::RenderbufferStorage:
+                name = "glRenderbufferStorage";
+                break;
+
+            case Function::FramebufferTexture:
+                name = "glFramebufferTexture";
+                break;
+
+            case Function::FramebufferTextureLayer:
+                name = "glFramebufferTextureLayer";
+                break;
+
+            case Function::FramebufferRenderbuffer:
+                name = "glFramebufferRenderbuffer";
+                break;
+
+            case Function::BufferData:
+                name = "glBufferData";
+                break;
+
+            case Function::MapBufferRange:
+                name = "glMapBufferRange";
+                break;
+
+            case Function::UnmapBuffer:
+                name = "glUnmapBuffer";
+                break;
+
+            case Function::EnableVertexAttribArray:
+                name = "glEnableVertexAttribArray";
+                break;
+
+            case Function::VertexAttribPointer:
+                name = "glVertexAttribPointer";
+                break;
+
+            case Function::VertexAttribDivisor:
+                name = "glVertexAttribDivisor";
+                break;
+
+            case Function::ShaderSource:
+                name = "glShaderSource";
+                break;
+
+            case Function::CompileShader:
+                name = "glCompileShader";
+                break;
+
+            case Function::AttachShader:
+                name = "glAttachShader";
+                break;
+
+            case Function::LinkProgram:
+                name = "glLinkProgram";
+                break;
+
+            case Function::ValidateProgram:
+                name = "glValidateProgram";
+                break;
+
+            case Function::ProgramParameteri:
+                name = "glProgramParameteri";
+                break;
+
+            case Function::ProgramBinary:
+                name = "glProgramBinary";
+                break;
+
+            case Function::UniformBlockBinding:
+                name = "glUniformBlockBinding";
+                break;
+
+            case Function::Uniform1f:
+                name = "glUniform1f";
+                break;
+
+            case Function::Uniform1i:
+                name = "glUniform1i";
+                break;
+
+            case Function::Uniform1ui:
+                name = "glUniform1ui";
+                break;
+
+            case Function::Uniform1fv:
+                name = "glUniform1fv";
+                break;
+
+            case Function::Uniform2fv:
+                name = "glUniform2fv";
+                break;
+
+            case Function::Uniform3fv:
+                name = "glUniform3fv";
+                break;
+
+            case Function::Uniform4fv:
+                name = "glUniform4fv";
+                break;
+
+            case Function::Uniform3iv:
+                name = "glUniform3iv";
+                break;
+
+            case Function::UniformMatrix4fv:
+                name = "glUniformMatrix4fv";
+                break;
+
+            case Function::Clear:
+                name = "glClear";
+                break;
+
+            case Function::BlitFramebuffer:
+                name = "glBlitFramebuffer";
+                break;
+
+            case Function::DrawArrays:
+                name = "glDrawArrays";
+                break;
+
+            case Function::DrawArraysInstanced:
+                name = "glDrawArraysInstanced";
+                break;
+
+            case Function::MultiDrawArrays:
+                name = "glMultiDrawArrays";
+                break;
+        }
+
+        std::string description = name + "(";
+        for (size_t i = 0; i < arguments.size(); i++) {
+            description += (i > 0 ? ", " : "") + std::to_string(arguments[i]);
+        }
+        return description + ")";
+    }
+
+#pragma mark - Lifecycle
+
+    GLRecordingBackend::GLRecordingBackend(GLBackend *target)
+            : mTarget(target) {}
+
+#pragma mark - Recording
+
+    void GLRecordingBackend::record(Function function, std::vector<int64_t> arguments) {
+        mCommands.emplace_back(function, std::move(arguments));
+    }
+
+    const std::vector<GLRecordingBackend::Command> &GLRecordingBackend::commands() const {
+        return mCommands;
+    }
+
+    size_t GLRecordingBackend::drawCallCount() const {
+        return std::count_if(mCommands.begin(), mCommands.end(), [](const Command &command) {
+            return command.function == Function::DrawArrays ||
+                   command.function == Function::DrawArraysInstanced ||
+                   command.function == Function::MultiDrawArrays;
+        });
+    }
+
+    size_t GLRecordingBackend::uniformUploadCount() const {
+        return std::count_if(mCommands.begin(), mCommands.end(), [](const Command &command) {
+            return command.function >= Function::Uniform1f && command.function <= Function::UniformMatrix4fv;
+        });
+    }
+
+    void GLRecordingBackend::clearCommands() {
+        mCommands.clear();
+    }
+
+#pragma mark - Queries
+
+    GLint GLRecordingBackend::integer(GLenum parameter) {
+        return mTarget ? mTarget->integer(parameter) : GLNullBackend::integer(parameter);
+    }
+
+    GLfloat GLRecordingBackend::floatValue(GLenum parameter) {
+        return mTarget ? mTarget->floatValue(parameter) : GLNullBackend::floatValue(parameter);
+    }
+
+    const GLubyte *GLRecordingBackend::string(GLenum name) {
+        return mTarget ? mTarget->string(name) : GLNullBackend::string(name);
+    }
+
+    GLint GLRecordingBackend::textureLevelInteger(GLenum target, GLint level, GLenum parameter) {
+        return mTarget ? mTarget->textureLevelInteger(target, level, parameter) : GLNullBackend::textureLevelInteger(target, level, parameter);
+    }
+
+    GLenum GLRecordingBackend::checkFramebufferStatus(GLenum target) {
+        return mTarget ? mTarget->checkFramebufferStatus(target) : GLNullBackend::checkFramebufferStatus(target);
+    }
+
+#pragma mark - Resources
+
+    GLuint GLRecordingBackend::genTexture() {
+        GLuint name = mTarget ? mTarget->genTexture() : GLNullBackend::genTexture();
+        record(Function::GenTexture, {name});
+        return name;
+    }
+
+    void GLRecordingBackend::deleteTexture(GLuint texture) {
+        record(Function::DeleteTexture, {texture});
+        if (mTarget) mTarget->deleteTexture(texture);
+    }
+
+    GLuint GLRecordingBackend::genSampler() {
+        GLuint name = mTarget ? mTarget->genSampler() : GLNullBackend::genSampler();
+        record(Function::GenSampler, {name});
+        return name;
+    }
+
+    void GLRecordingBackend::deleteSampler(GLuint sampler) {
+        record(Function::DeleteSampler, {sampler});
+        if (mTarget) mTarget->deleteSampler(sampler);
+    }
+
+    GLuint GLRecordingBackend::genFramebuffer() {
+        GLuint name = mTarget ? mTarget->genFramebuffer() : GLNullBackend::genFramebuffer();
+        record(Function::GenFramebuffer, {name});
+        return name;
+    }
+
+    void GLRecordingBackend::deleteFramebuffer(GLuint framebuffer) {
+        record(Function::DeleteFramebuffer, {framebuffer});
+        if (mTarget) mTarget->deleteFramebuffer(framebuffer);
+    }
+
+    GLuint GLRecordingBackend::genRenderbuffer() {
+        GLuint name = mTarget ? mTarget->genRenderbuffer() : GLNullBackend::genRenderbuffer();
+        record(Function::GenRenderbuffer, {name});
+        return name;
+    }
+
+    void GLRecordingBackend::deleteRenderbuffer(GLuint renderbuffer) {
+        record(Function::DeleteRenderbuffer, {renderbuffer});
+        if (mTarget) mTarget->deleteRenderbuffer(renderbuffer);
+    }
+
+    GLuint GLRecordingBackend::genBuffer() {
+        GLuint name = mTarget ? mTarget->genBuffer() : GLNullBackend::genBuffer();
+        record(Function::GenBuffer, {name});
+        return name;
+    }
+
+    void GLRecordingBackend::deleteBuffer(GLuint buffer) {
+        record(Function::DeleteBuffer, {buffer});
+        if (mTarget) mTarget->deleteBuffer(buffer);
+    }
+
+    GLuint GLRecordingBackend::genVertexArray() {
+        GLuint name = mTarget ? mTarget->genVertexArray() : GLNullBackend::genVertexArray();
+        record(Function::GenVertexArray, {name});
+        return name;
+    }
+
+    void GLRecordingBackend::deleteVertexArray(GLuint vertexArray) {
+        record(Function::DeleteVertexArray, {vertexArray});
+        if (mTarget) mTarget->deleteVertexArray(vertexArray);
+    }
+
+    GLuint GLRecordingBackend::createShader(GLenum type) {
+        GLuint name = mTarget ? mTarget->createShader(type) : GLNullBackend::createShader(type);
+        record(Function::CreateShader, {name});
+        return name;
+    }
+
+    void GLRecordingBackend::deleteShader(GLuint shader) {
+        record(Function::DeleteShader, {shader});
+        if (mTarget) {
+            mTarget->deleteShader(shader);
+        } else {
+            GLNullBackend::deleteShader(shader);
+        }
+    }
+
+    GLuint GLRecordingBackend::createProgram() {
+        GLuint name = mTarget ? mTarget->createProgram() : GLNullBackend::createProgram();
+        record(Function::CreateProgram, {name});
+        return name;
+    }
+
+    void GLRecordingBackend::deleteProgram(GLuint program) {
+        record(Function::DeleteProgram, {program});
+        if (mTarget) {
+            mTarget->deleteProgram(program);
+        } else {
+            GLNullBackend::deleteProgram(program);
+        }
+    }
+
+#pragma mark - Bindings
+
+    void GLRecordingBackend::bindFramebuffer(GLenum target, GLuint framebuffer) {
+        record(Function::BindFramebuffer, {target, framebuffer});
+        if (mTarget) mTarget->bindFramebuffer(target, framebuffer);
+    }
+
+    void GLRecordingBackend::bindRenderbuffer(GLenum target, GLuint renderbuffer) {
+        record(Function::BindRenderbuffer, {target, renderbuffer});
+        if (mTarget) mTarget->bindRenderbuffer(target, renderbuffer);
+    }
+
+    void GLRecordingBackend::useProgram(GLuint program) {
+        record(Function::UseProgram, {program});
+        if (mTarget) mTarget->useProgram(program);
+    }
+
+    void GLRecordingBackend::bindVertexArray(GLuint vertexArray) {
+        record(Function::BindVertexArray, {vertexArray});
+        if (mTarget) mTarget->bindVertexArray(vertexArray);
+    }
+
+    void GLRecordingBackend::bindBuffer(GLenum target, GLuint buffer) {
+        record(Function::BindBuffer, {target, buffer});
+        if (mTarget) mTarget->bindBuffer(target, buffer);
+    }
+
+    void GLRecordingBackend::bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) {
+        record(Function::BindBufferRange, {target, index, buffer, offset, size});
+        if (mTarget) mTarget->bindBufferRange(target, index, buffer, offset, size);
+    }
+
+    void GLRecordingBackend::activeTexture(GLenum unit) {
+        record(Function::ActiveTexture, {unit});
+        if (mTarget) mTarget->activeTexture(unit);
+    }
+
+    void GLRecordingBackend::bindTexture(GLenum target, GLuint texture) {
+        record(Function::BindTexture, {target, texture});
+        if (mTarget) mTarget->bindTexture(target, texture);
+    }
+
+    void GLRecordingBackend::bindSampler(GLuint unit, GLuint sampler) {
+        record(Function::BindSampler, {unit, sampler});
+        if (mTarget) mTarget->bindSampler(unit, sampler);
+    }
+
+#pragma mark - Fixed function state
+
+    void GLRecordingBackend::enable(GLenum capability) {
+        record(Function::Enable, {capability});
+        if (mTarget) mTarget->enable(capability);
+    }
+
+    void GLRecordingBackend::disable(GLenum capability) {
+        record(Function::Disable, {capability});
+        if (mTarget) mTarget->disable(capability);
+    }
+
+    void GLRecordingBackend::blendFunc(GLenum source, GLenum destination) {
+        record(Function::BlendFunc, {source, destination});
+        if (mTarget) mTarget->blendFunc(source, destination);
+    }
+
+    void GLRecordingBackend::depthMask(GLboolean flag) {
+        record(Function::DepthMask, {flag});
+        if (mTarget) mTarget->depthMask(flag);
+    }
+
+    void GLRecordingBackend::depthFunc(GLenum function) {
+        record(Function::DepthFunc, {function});
+        if (mTarget) mTarget->depthFunc(function);
+    }
+
+    void GLRecordingBackend::cullFace(GLenum mode) {
+        record(Function::CullFace, {mode});
+        if (mTarget) mTarget->cullFace(mode);
+    }
+
+    void GLRecordingBackend::viewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+        record(Function::Viewport, {x, y, width, height});
+        if (mTarget) mTarget->viewport(x, y, width, height);
+    }
+
+    void GLRecordingBackend::scissor(GLint x, GLint y, GLsizei width, GLsizei height) {
+        record(Function::Scissor, {x, y, width, height});
+        if (mTarget) mTarget->scissor(x, y, width, height);
+    }
+
+    void GLRecordingBackend::drawBuffers(GLsizei count, const GLenum *buffers) {
+        record(Function::DrawBuffers, std::vector<int64_t>(buffers, buffers + count));
+        if (mTarget) mTarget->drawBuffers(count, buffers);
+    }
+
+    void GLRecordingBackend::readBuffer(GLenum mode) {
+        record(Function::ReadBuffer, {mode});
+        if (mTarget) mTarget->readBuffer(mode);
+    }
+
+    void GLRecordingBackend::clearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) {
+        record(Function::ClearColor, {});
+        if (mTarget) mTarget->clearColor(red, green, blue, alpha);
+    }
+
+    void GLRecordingBackend::clearDepth(GLdouble depth) {
+        record(Function::ClearDepth, {});
+        if (mTarget) mTarget->clearDepth(depth);
+    }
+
+#pragma mark - Textures and samplers
+
+    void GLRecordingBackend::texParameteri(GLenum target, GLenum parameter, GLint value) {
+        record(Function::TexParameteri, {target, parameter, value});
+        if (mTarget) mTarget->texParameteri(target, parameter, value);
+    }
+
+    void GLRecordingBackend::texParameterf(GLenum target, GLenum parameter, GLfloat value) {
+        record(Function::TexParameterf, {target, parameter});
+        if (mTarget) mTarget->texParameterf(target, parameter, value);
+    }
+
+    void GLRecordingBackend::texImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLenum format, GLenum type, const void *pixels) {
+        record(Function::TexImage2D, {target, level, internalFormat, width, height, format, type});
+        if (mTarget) mTarget->texImage2D(target, level, internalFormat, width, height, format, type, pixels);
+    }
+
+    void GLRecordingBackend::texStorage3D(GLenum target, GLsizei levels, GLenum internalFormat, GLsizei width, GLsizei height, GLsizei depth) {
+        record(Function::TexStorage3D, {target, levels, internalFormat, width, height, depth});
+        if (mTarget) mTarget->texStorage3D(target, levels, internalFormat, width, height, depth);
+    }
+
+    void GLRecordingBackend::texSubImage3D(GLenum target, GLint level, GLint xOffset, GLint yOffset, GLint zOffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const void *pixels) {
+        record(Function::TexSubImage3D, {target, level, xOffset, yOffset, zOffset, width, height, depth, format, type});
+        if (mTarget) mTarget->texSubImage3D(target, level, xOffset, yOffset, zOffset, width, height, depth, format, type, pixels);
+    }
+
+    void GLRecordingBackend::generateMipmap(GLenum target) {
+        record(Function::GenerateMipmap, {target});
+        if (mTarget) mTarget->generateMipmap(target);
+    }
+
+    void GLRecordingBackend::texBuffer(GLenum target, GLenum internalFormat, GLuint buffer) {
+        record(Function::TexBuffer, {target, internalFormat, buffer});
+        if (mTarget) mTarget->texBuffer(target, internalFormat, buffer);
+    }
+
+    void GLRecordingBackend::samplerParameteri(GLuint sampler, GLenum parameter, GLint value) {
+        record(Function::SamplerParameteri, {sampler, parameter, value});
+        if (mTarget) mTarget->samplerParameteri(sampler, parameter, value);
+    }
+
+    void GLRecordingBackend::samplerParameterf(GLuint sampler, GLenum parameter, GLfloat value) {
+        record(Function::SamplerParameterf, {sampler, parameter});
+        if (mTarget) mTarget->samplerParameterf(sampler, parameter, value);
+    }
+
+#pragma mark - Framebuffers
+
+    void GLRecordingBackend::renderbufferStorage(GLenum target, GLenum internalFormat, GLsizei width, GLsizei height) {
+        record(Function::RenderbufferStorage, {target, internalFormat, width, height});
+        if (mTarget) mTarget->renderbufferStorage(target, internalFormat, width, height);
+    }
+
+    void GLRecordingBackend::framebufferTexture(GLenum target, GLenum attachment, GLuint texture, GLint level) {
+        record(Function::FramebufferTexture, {target, attachment, texture, level});
+        if (mTarget) mTarget->framebufferTexture(target, attachment, texture, level);
+    }
+
+    void GLRecordingBackend::framebufferTextureLayer(GLenum target, GLenum attachment, GLuint texture, GLint level, GLint layer) {
+        record(Function::FramebufferTextureLayer, {target, attachment, texture, level, layer});
+        if (mTarget) mTarget->framebufferTextureLayer(target, attachment, texture, level, layer);
+    }
+
+    void GLRecordingBackend::framebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbufferTarget, GLuint renderbuffer) {
+        record(Function::FramebufferRenderbuffer, {target, attachment, renderbufferTarget, renderbuffer});
+        if (mTarget) mTarget->framebufferRenderbuffer(target, attachment, renderbufferTarget, renderbuffer);
+    }
+
+#pragma mark - Buffers and vertex arrays
+
+    void GLRecordingBackend::bufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage) {
+        record(Function::BufferData, {target, size, usage});
+        if (mTarget) mTarget->bufferData(target, size, data, usage);
+    }
+
+    void *GLRecordingBackend::mapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) {
+        record(Function::MapBufferRange, {target, offset, length, access});
+        return mTarget ? mTarget->mapBufferRange(target, offset, length, access) : GLNullBackend::mapBufferRange(target, offset, length, access);
+    }
+
+    void GLRecordingBackend::unmapBuffer(GLenum target) {
+        record(Function::UnmapBuffer, {target});
+        if (mTarget) mTarget->unmapBuffer(target);
+    }
+
+    void GLRecordingBackend::enableVertexAttribArray(GLuint index) {
+        record(Function::EnableVertexAttribArray, {index});
+        if (mTarget) mTarget->enableVertexAttribArray(index);
+    }
+
+    void GLRecordingBackend::vertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void *pointer) {
+        record(Function::VertexAttribPointer, {index, size, type, normalized, stride, reinterpret_cast<intptr_t>(pointer)});
+        if (mTarget) mTarget->vertexAttribPointer(index, size, type, normalized, stride, pointer);
+    }
+
+    void GLRecordingBackend::vertexAttribDivisor(GLuint index, GLuint divisor) {
+        record(Function::VertexAttribDivisor, {index, divisor});
+        if (mTarget) mTarget->vertexAttribDivisor(index, divisor);
+    }
+
+#pragma mark - Shaders and programs
+
+    void GLRecordingBackend::shaderSource(GLuint shader, const GLchar *source) {
+        record(Function::ShaderSource, {shader});
+        if (mTarget) {
+            mTarget->shaderSource(shader, source);
+        } else {
+            GLNullBackend::shaderSource(shader, source);
+        }
+    }
+
+    void GLRecordingBackend::compileShader(GLuint shader) {
+        record(Function::CompileShader, {shader});
+        if (mTarget) mTarget->compileShader(shader);
+    }
+
+    GLint GLRecordingBackend::shaderInteger(GLuint shader, GLenum parameter) {
+        return mTarget ? mTarget->shaderInteger(shader, parameter) : GLNullBackend::shaderInteger(shader, parameter);
+    }
+
+    void GLRecordingBackend::shaderInfoLog(GLuint shader, GLsizei bufferSize, GLchar *infoLog) {
+        if (mTarget) {
+            mTarget->shaderInfoLog(shader, bufferSize, infoLog);
+        } else {
+            GLNullBackend::shaderInfoLog(shader, bufferSize, infoLog);
+        }
+    }
+
+    void GLRecordingBackend::attachShader(GLuint program, GLuint shader) {
+        record(Function::AttachShader, {program, shader});
+        if (mTarget) {
+            mTarget->attachShader(program, shader);
+        } else {
+            GLNullBackend::attachShader(program, shader);
+        }
+    }
+
+    void GLRecordingBackend::linkProgram(GLuint program) {
+        record(Function::LinkProgram, {program});
+        if (mTarget) {
+            mTarget->linkProgram(program);
+        } else {
+            GLNullBackend::linkProgram(program);
+        }
+    }
+
+    void GLRecordingBackend::validateProgram(GLuint program) {
+        record(Function::ValidateProgram, {program});
+        if (mTarget) mTarget->validateProgram(program);
+    }
+
+    void GLRecordingBackend::programParameteri(GLuint program, GLenum parameter, GLint value) {
+        record(Function::ProgramParameteri, {program, parameter, value});
+        if (mTarget) mTarget->programParameteri(program, parameter, value);
+    }
+
+    void GLRecordingBackend::programBinary(GLuint program, GLenum format, const void *binary, GLsizei length) {
+        record(Function::ProgramBinary, {program, format, length});
+        if (mTarget) mTarget->programBinary(program, format, binary, length);
+    }
+
+    void GLRecordingBackend::getProgramBinary(GLuint program, GLsizei bufferSize, GLsizei *length, GLenum *format, void *binary) {
+        if (mTarget) {
+            mTarget->getProgramBinary(program, bufferSize, length, format, binary);
+        } else {
+            GLNullBackend::getProgramBinary(program, bufferSize, length, format, binary);
+        }
+    }
+
+    GLint GLRecordingBackend::programInteger(GLuint program, GLenum parameter) {
+        return mTarget ? mTarget->programInteger(program, parameter) : GLNullBackend::programInteger(program, parameter);
+    }
+
+    void GLRecordingBackend::programInfoLog(GLuint program, GLsizei bufferSize, GLsizei *length, GLchar *infoLog) {
+        if (mTarget) {
+            mTarget->programInfoLog(program, bufferSize, length, infoLog);
+        } else {
+            GLNullBackend::programInfoLog(program, bufferSize, length, infoLog);
+        }
+    }
+
+    void GLRecordingBackend::activeAttrib(GLuint program, GLuint index, GLsizei bufferSize, GLint *size, GLenum *type, GLchar *name) {
+        if (mTarget) {
+            mTarget->activeAttrib(program, index, bufferSize, size, type, name);
+        } else {
+            GLNullBackend::activeAttrib(program, index, bufferSize, size, type, name);
+        }
+    }
+
+    void GLRecordingBackend::activeUniform(GLuint program, GLuint index, GLsizei bufferSize, GLint *size, GLenum *type, GLchar *name) {
+        if (mTarget) {
+            mTarget->activeUniform(program, index, bufferSize, size, type, name);
+        } else {
+            GLNullBackend::activeUniform(program, index, bufferSize, size, type, name);
+        }
+    }
+
+    GLint GLRecordingBackend::uniformLocation(GLuint program, const GLchar *name) {
+        return mTarget ? mTarget->uniformLocation(program, name) : GLNullBackend::uniformLocation(program, name);
+    }
+
+    GLint GLRecordingBackend::activeUniformBlockInteger(GLuint program, GLuint blockIndex, GLenum parameter) {
+        return mTarget ? mTarget->activeUniformBlockInteger(program, blockIndex, parameter) : GLNullBackend::activeUniformBlockInteger(program, blockIndex, parameter);
+    }
+
+    void GLRecordingBackend::activeUniformBlockName(GLuint program, GLuint blockIndex, GLsizei bufferSize, GLchar *name) {
+        if (mTarget) {
+            mTarget->activeUniformBlockName(program, blockIndex, bufferSize, name);
+        } else {
+            GLNullBackend::activeUniformBlockName(program, blockIndex, bufferSize, name);
+        }
+    }
+
+    void GLRecordingBackend::uniformBlockBinding(GLuint program, GLuint blockIndex, GLuint binding) {
+        record(Function::UniformBlockBinding, {program, blockIndex, binding});
+        if (mTarget) mTarget->uniformBlockBinding(program, blockIndex, binding);
+    }
+
+#pragma mark - Uniforms
+
+    void GLRecordingBackend::uniform1f(GLint location, GLfloat value) {
+        record(Function::Uniform1f, {location});
+        if (mTarget) mTarget->uniform1f(location, value);
+    }
+
+    void GLRecordingBackend::uniform1i(GLint location, GLint value) {
+        record(Function::Uniform1i, {location});
+        if (mTarget) mTarget->uniform1i(location, value);
+    }
+
+    void GLRecordingBackend::uniform1ui(GLint location, GLuint value) {
+        record(Function::Uniform1ui, {location});
+        if (mTarget) mTarget->uniform1ui(location, value);
+    }
+
+    void GLRecordingBackend::uniform1fv(GLint location, GLsizei count, const GLfloat *values) {
+        record(Function::Uniform1fv, {location, count});
+        if (mTarget) mTarget->uniform1fv(location, count, values);
+    }
+
+    void GLRecordingBackend::uniform2fv(GLint location, GLsizei count, const GLfloat *values) {
+        record(Function::Uniform2fv, {location, count});
+        if (mTarget) mTarget->uniform2fv(location, count, values);
+    }
+
+    void GLRecordingBackend::uniform3fv(GLint location, GLsizei count, const GLfloat *values) {
+        record(Function::Uniform3fv, {location, count});
+        if (mTarget) mTarget->uniform3fv(location, count, values);
+    }
+
+    void GLRecordingBackend::uniform4fv(GLint location, GLsizei count, const GLfloat *values) {
+        record(Function::Uniform4fv, {location, count});
+        if (mTarget) mTarget->uniform4fv(location, count, values);
+    }
+
+    void GLRecordingBackend::uniform3iv(GLint location, GLsizei count, const GLint *values) {
+        record(Function::Uniform3iv, {location, count});
+        if (mTarget) mTarget->uniform3iv(location, count, values);
+    }
+
+    void GLRecordingBackend::uniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *values) {
+        record(Function::UniformMatrix4fv, {location, count, transpose});
+        if (mTarget) mTarget->uniformMatrix4fv(location, count, transpose, values);
+    }
+
+#pragma mark - Commands
+
+    void GLRecordingBackend::clear(GLbitfield mask) {
+        record(Function::Clear, {mask});
+        if (mTarget) mTarget->clear(mask);
+    }
+
+    void GLRecordingBackend::blitFramebuffer(GLint sourceX0, GLint sourceY0, GLint sourceX1, GLint sourceY1, GLint destinationX0, GLint destinationY0, GLint destinationX1, GLint destinationY1, GLbitfield mask, GLenum filter) {
+        record(Function::BlitFramebuffer, {sourceX0, sourceY0, sourceX1, sourceY1, destinationX0, destinationY0, destinationX1, destinationY1, mask, filter});
+        if (mTarget) mTarget->blitFramebuffer(sourceX0, sourceY0, sourceX1, sourceY1, destinationX0, destinationY0, destinationX1, destinationY1, mask, filter);
+    }
+
+    void GLRecordingBackend::drawArrays(GLenum mode, GLint first, GLsizei count) {
+        record(Function::DrawArrays, {mode, first, count});
+        if (mTarget) mTarget->drawArrays(mode, first, count);
+    }
+
+    void GLRecordingBackend::drawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instanceCount) {
+        record(Function::DrawArraysInstanced, {mode, first, count, instanceCount});
+        if (mTarget) mTarget->drawArraysInstanced(mode, first, count, instanceCount);
+    }
+
+    void GLRecordingBackend::multiDrawArrays(GLenum mode, const GLint *first, const GLsizei *count, GLsizei drawCount) {
+        std::vector<int64_t> arguments{mode, drawCount};
+        for (GLsizei i = 0; i < drawCount; i++) {
+            arguments.push_back(first[i]);
+            arguments.push_back(count[i]);
+        }
+        record(Function::MultiDrawArrays, std::move(arguments));
+        if (mTarget) mTarget->multiDrawArrays(mode, first, count, drawCount);
+    }
+
+}
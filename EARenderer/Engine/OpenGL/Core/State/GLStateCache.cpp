@@ -0,0 +1,310 @@
+//
+// Created by Pavlo Muratov on 2019-02-08.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "GLStateCache.hpp"
+#include "Profiler.hpp"
+
+namespace EARenderer {
+
+#pragma mark - Lifecycle
+
+    GLStateCache &GLStateCache::shared() {
+        static GLStateCache cache;
+        return cache;
+    }
+
+    GLStateCache::GLStateCache()
+            : mBackend(&mDriverBackend) {}
+
+#pragma mark - Private helpers
+
+    bool GLStateCache::elide(bool isRedundant) {
+        if (isRedundant) {
+            mStatistics.elidedCalls++;
+        } else {
+            mStatistics.issuedCalls++;
+        }
+        return isRedundant;
+    }
+
+#pragma mark - Backend
+
+    void GLStateCache::setBackend(GLBackend *backend) {
+        mBackend = backend ? backend : &mDriverBackend;
+        invalidate();
+    }
+
+    GLBackend &GLStateCache::backend() {
+        return *mBackend;
+    }
+
+#pragma mark - Frames
+
+    void GLStateCache::invalidate() {
+        mDrawFramebuffer.reset();
+        mReadFramebuffer.reset();
+        mProgram.reset();
+        mVertexArray.reset();
+        mActiveTexture.reset();
+        mTextures.clear();
+        mSamplers.clear();
+        mCapabilities.clear();
+        mBlendFunc.reset();
+        mDepthMask.reset();
+        mDepthFunc.reset();
+        mCullFace.reset();
+        mViewport.reset();
+        mScissor.reset();
+    }
+
+    void GLStateCache::beginFrame() {
+        mLastFrameStatistics = mStatistics;
+        mStatistics = Statistics();
+
+        EA_PROFILE_COUNTER("Draw calls", mLastFrameStatistics.drawCalls);
+        EA_PROFILE_COUNTER("Issued GL calls", mLastFrameStatistics.issuedCalls);
+        EA_PROFILE_COUNTER("Elided GL calls", mLastFrameStatistics.elidedCalls);
+
+        invalidate();
+    }
+
+    const GLStateCache::Statistics &GLStateCache::statistics() const {
+        return mStatistics;
+    }
+
+    const GLStateCache::Statistics &GLStateCache::lastFrameStatistics() const {
+        return mLastFrameStatistics;
+    }
+
+#pragma mark - Object lifetime
+
+    void GLStateCache::forgetFramebuffer(GLuint framebuffer) {
+        // Deleting a bound framebuffer reverts the binding to the default one
+        if (mDrawFramebuffer == framebuffer) mDrawFramebuffer = 0;
+        if (mReadFramebuffer == framebuffer) mReadFramebuffer = 0;
+    }
+
+    void GLStateCache::forgetProgram(GLuint program) {
+        if (mProgram == program) mProgram.reset();
+    }
+
+    void GLStateCache::forgetVertexArray(GLuint vertexArray) {
+        if (mVertexArray == vertexArray) mVertexArray = 0;
+    }
+
+    void GLStateCache::forgetTexture(GLuint texture) {
+        for (auto &bindingTexturePair : mTextures) {
+            if (bindingTexturePair.second == texture) {
+                bindingTexturePair.second = 0;
+            }
+        }
+    }
+
+    void GLStateCache::forgetSampler(GLuint sampler) {
+        for (auto &unitSamplerPair : mSamplers) {
+            if (unitSamplerPair.second == sampler) {
+                unitSamplerPair.second = 0;
+            }
+        }
+    }
+
+#pragma mark - Bindings
+
+    void GLStateCache::bindFramebuffer(GLenum target, GLuint framebuffer) {
+        bool bindsDraw = target == GL_FRAMEBUFFER || target == GL_DRAW_FRAMEBUFFER;
+        bool bindsRead = target == GL_FRAMEBUFFER || target == GL_READ_FRAMEBUFFER;
+
+        bool isRedundant = (!bindsDraw || mDrawFramebuffer == framebuffer) && (!bindsRead || mReadFramebuffer == framebuffer);
+        if (elide(isRedundant)) {
+            return;
+        }
+
+        mBackend->bindFramebuffer(target, framebuffer);
+        mStatistics.framebufferBinds++;
+        if (bindsDraw) mDrawFramebuffer = framebuffer;
+        if (bindsRead) mReadFramebuffer = framebuffer;
+    }
+
+    void GLStateCache::useProgram(GLuint program) {
+        if (elide(mProgram == program)) {
+            return;
+        }
+
+        mBackend->useProgram(program);
+        mStatistics.programBinds++;
+        mProgram = program;
+    }
+
+    void GLStateCache::bindVertexArray(GLuint vertexArray) {
+        if (elide(mVertexArray == vertexArray)) {
+            return;
+        }
+
+        mBackend->bindVertexArray(vertexArray);
+        mStatistics.vertexArrayBinds++;
+        mVertexArray = vertexArray;
+    }
+
+    void GLStateCache::activeTexture(GLenum unit) {
+        if (elide(mActiveTexture == unit)) {
+            return;
+        }
+
+        mBackend->activeTexture(unit);
+        mActiveTexture = unit;
+    }
+
+    void GLStateCache::bindTexture(GLenum target, GLuint texture) {
+        // Bindings can't be tracked until the active unit is known
+        if (!mActiveTexture) {
+            mStatistics.issuedCalls++;
+            mBackend->bindTexture(target, texture);
+            mStatistics.textureBinds++;
+            return;
+        }
+
+        uint64_t key = (uint64_t(*mActiveTexture) << 32) | target;
+        auto it = mTextures.find(key);
+        if (elide(it != mTextures.end() && it->second == texture)) {
+            return;
+        }
+
+        mBackend->bindTexture(target, texture);
+        mStatistics.textureBinds++;
+        mTextures[key] = texture;
+    }
+
+    void GLStateCache::bindSampler(GLuint unit, GLuint sampler) {
+        auto it = mSamplers.find(unit);
+        if (elide(it != mSamplers.end() && it->second == sampler)) {
+            return;
+        }
+
+        mBackend->bindSampler(unit, sampler);
+        mSamplers[unit] = sampler;
+    }
+
+    void GLStateCache::unbindAllSamplers() {
+        for (auto &unitSamplerPair : mSamplers) {
+            if (elide(unitSamplerPair.second == 0)) {
+                continue;
+            }
+            mBackend->bindSampler(unitSamplerPair.first, 0);
+            unitSamplerPair.second = 0;
+        }
+    }
+
+#pragma mark - Fixed function state
+
+    void GLStateCache::setCapability(GLenum capability, bool enabled) {
+        auto it = mCapabilities.find(capability);
+        if (elide(it != mCapabilities.end() && it->second == enabled)) {
+            return;
+        }
+
+        if (enabled) {
+            mBackend->enable(capability);
+        } else {
+            mBackend->disable(capability);
+        }
+        mCapabilities[capability] = enabled;
+    }
+
+    void GLStateCache::enable(GLenum capability) {
+        setCapability(capability, true);
+    }
+
+    void GLStateCache::disable(GLenum capability) {
+        setCapability(capability, false);
+    }
+
+    void GLStateCache::blendFunc(GLenum source, GLenum destination) {
+        auto function = std::make_pair(source, destination);
+        if (elide(mBlendFunc == function)) {
+            return;
+        }
+
+        mBackend->blendFunc(source, destination);
+        mBlendFunc = function;
+    }
+
+    void GLStateCache::depthMask(GLboolean flag) {
+        if (elide(mDepthMask == flag)) {
+            return;
+        }
+
+        mBackend->depthMask(flag);
+        mDepthMask = flag;
+    }
+
+    void GLStateCache::depthFunc(GLenum function) {
+        if (elide(mDepthFunc == function)) {
+            return;
+        }
+
+        mBackend->depthFunc(function);
+        mDepthFunc = function;
+    }
+
+    void GLStateCache::cullFace(GLenum mode) {
+        if (elide(mCullFace == mode)) {
+            return;
+        }
+
+        mBackend->cullFace(mode);
+        mCullFace = mode;
+    }
+
+    void GLStateCache::viewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+        Rectangle rectangle{x, y, width, height};
+        if (elide(mViewport == rectangle)) {
+            return;
+        }
+
+        mBackend->viewport(x, y, width, height);
+        mViewport = rectangle;
+    }
+
+    void GLStateCache::scissor(GLint x, GLint y, GLsizei width, GLsizei height) {
+        Rectangle rectangle{x, y, width, height};
+        if (elide(mScissor == rectangle)) {
+            return;
+        }
+
+        mBackend->scissor(x, y, width, height);
+        mScissor = rectangle;
+    }
+
+    void GLStateCache::drawBuffers(GLsizei count, const GLenum *buffers) {
+        mStatistics.issuedCalls++;
+        mBackend->drawBuffers(count, buffers);
+    }
+
+#pragma mark - Commands
+
+    void GLStateCache::clear(GLbitfield mask) {
+        mStatistics.issuedCalls++;
+        mBackend->clear(mask);
+    }
+
+    void GLStateCache::drawArrays(GLenum mode, GLint first, GLsizei count) {
+        mStatistics.issuedCalls++;
+        mStatistics.drawCalls++;
+        mBackend->drawArrays(mode, first, count);
+    }
+
+    void GLStateCache::drawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instanceCount) {
+        mStatistics.issuedCalls++;
+        mStatistics.drawCalls++;
+        mBackend->drawArraysInstanced(mode, first, count, instanceCount);
+    }
+
+    void GLStateCache::multiDrawArrays(GLenum mode, const GLint *first, const GLsizei *count, GLsizei drawCount) {
+        mStatistics.issuedCalls++;
+        mStatistics.drawCalls++;
+        mBackend->multiDrawArrays(mode, first, count, drawCount);
+    }
+
+}
@@ -0,0 +1,189 @@
+//
+// Created by Pavlo Muratov on 2019-02-08.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_GLSTATECACHE_HPP
+#define EARENDERER_GLSTATECACHE_HPP
+
+#include "GLBackend.hpp"
+#include "GLDriverBackend.hpp"
+
+#include <optional>
+#include <unordered_map>
+#include <array>
+#include <utility>
+
+namespace EARenderer {
+
+    /**
+     Central tracker of OpenGL state. Every binding and fixed function state change is compared
+     with the last value submitted through the tracker and dropped when redundant.
+
+     State is unknown after construction, after a backend change and after invalidate(),
+     so the first call for each piece of state always reaches the backend. Code changing
+     the state bypassing the tracker must call invalidate() afterwards.
+     */
+    class GLStateCache {
+    public:
+        struct Statistics {
+            uint64_t issuedCalls = 0;
+            uint64_t elidedCalls = 0;
+            uint64_t drawCalls = 0;
+            uint64_t framebufferBinds = 0;
+            uint64_t programBinds = 0;
+            uint64_t vertexArrayBinds = 0;
+            uint64_t textureBinds = 0;
+        };
+
+    private:
+        using Rectangle = std::array<GLint, 4>;
+
+        GLDriverBackend mDriverBackend;
+        GLBackend *mBackend;
+
+        std::optional<GLuint> mDrawFramebuffer;
+        std::optional<GLuint> mReadFramebuffer;
+        std::optional<GLuint> mProgram;
+        std::optional<GLuint> mVertexArray;
+        std::optional<GLenum> mActiveTexture;
+        // Keyed by active texture unit and binding point
+        std::unordered_map<uint64_t, GLuint> mTextures;
+        std::unordered_map<GLuint, GLuint> mSamplers;
+        std::unordered_map<GLenum, bool> mCapabilities;
+        std::optional<std::pair<GLenum, GLenum>> mBlendFunc;
+        std::optional<GLboolean> mDepthMask;
+        std::optional<GLenum> mDepthFunc;
+        std::optional<GLenum> mCullFace;
+        std::optional<Rectangle> mViewport;
+        std::optional<Rectangle> mScissor;
+
+        Statistics mStatistics;
+        Statistics mLastFrameStatistics;
+
+        GLStateCache();
+
+        GLStateCache(const GLStateCache &that) = delete;
+
+        GLStateCache &operator=(const GLStateCache &rhs) = delete;
+
+        /**
+         Counts the call and tells whether it has to be dropped
+
+         @param isRedundant whether the requested state equals the tracked one
+         @return true if the call should not reach the backend
+         */
+        bool elide(bool isRedundant);
+
+    public:
+        static GLStateCache &shared();
+
+#pragma mark - Backend
+
+        /**
+         Redirects all subsequent calls, e.g. to a recording or null backend, and invalidates tracked state
+
+         @param backend backend to use or nullptr to go back to the driver
+         */
+        void setBackend(GLBackend *backend);
+
+        GLBackend &backend();
+
+#pragma mark - Frames
+
+        /**
+         Forgets all tracked state
+         */
+        void invalidate();
+
+        /**
+         Stores counters of the previous frame, resets the current ones and invalidates tracked state,
+         since the windowing system may change the context between frames
+         */
+        void beginFrame();
+
+        /**
+         @return counters accumulated since the beginning of the current frame
+         */
+        const Statistics &statistics() const;
+
+        const Statistics &lastFrameStatistics() const;
+
+#pragma mark - Object lifetime
+
+        // Names of deleted objects are reused by the driver, so they must not be considered bound anymore
+
+        void forgetFramebuffer(GLuint framebuffer);
+
+        void forgetProgram(GLuint program);
+
+        void forgetVertexArray(GLuint vertexArray);
+
+        void forgetTexture(GLuint texture);
+
+        void forgetSampler(GLuint sampler);
+
+#pragma mark - Bindings
+
+        void bindFramebuffer(GLenum target, GLuint framebuffer);
+
+        void useProgram(GLuint program);
+
+        void bindVertexArray(GLuint vertexArray);
+
+        /**
+         @param unit texture unit enum, e.g. GL_TEXTURE0
+         */
+        void activeTexture(GLenum unit);
+
+        /**
+         Binds a texture to the active texture unit
+         */
+        void bindTexture(GLenum target, GLuint texture);
+
+        void bindSampler(GLuint unit, GLuint sampler);
+
+        void unbindAllSamplers();
+
+#pragma mark - Fixed function state
+
+        void setCapability(GLenum capability, bool enabled);
+
+        void enable(GLenum capability);
+
+        void disable(GLenum capability);
+
+        void blendFunc(GLenum source, GLenum destination);
+
+        void depthMask(GLboolean flag);
+
+        void depthFunc(GLenum function);
+
+        void cullFace(GLenum mode);
+
+        void viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+        void scissor(GLint x, GLint y, GLsizei width, GLsizei height);
+
+        /**
+         Draw buffers belong to the bound framebuffer and are not tracked
+         */
+        void drawBuffers(GLsizei count, const GLenum *buffers);
+
+#pragma mark - Commands
+
+        void clear(GLbitfield mask);
+
+        void drawArrays(GLenum mode, GLint first, GLsizei count);
+
+        void drawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instanceCount);
+
+        /**
+         Counted as a single draw call, which is what the driver sees
+         */
+        void multiDrawArrays(GLenum mode, const GLint *first, const GLsizei *count, GLsizei drawCount);
+    };
+
+}
+
+#endif //EARENDERER_GLSTATECACHE_HPP
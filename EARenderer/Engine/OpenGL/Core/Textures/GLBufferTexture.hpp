@@ -12,6 +12,7 @@
 #include "GLNamedObject.hpp"
 #include "GLTextureBuffer.hpp"
 #include "GLTexture.hpp"
+#include "GLStateCache.hpp"
 
 namespace EARenderer {
 
@@ -23,13 +24,13 @@ namespace EARenderer {
     public:
         GLBufferTexture(const BufferDataType *data, uint64_t count)
                 : mBuffer(data, count, GLTexture::glFormat(Format).internalFormat) {
-            glGenTextures(1, &mName);
+            mName = GLStateCache::shared().backend().genTexture();
         }
 
         virtual ~GLBufferTexture() = 0;
 
         void bind() const {
-            glBindTexture(GL_TEXTURE_BUFFER, mName);
+            GLStateCache::shared().bindTexture(GL_TEXTURE_BUFFER, mName);
             mBuffer.bind();
         }
 
@@ -44,7 +45,8 @@ namespace EARenderer {
 
     template<typename TextureFormat, TextureFormat Format, typename BufferDataType>
     GLBufferTexture<TextureFormat, Format, BufferDataType>::~GLBufferTexture() {
-        glDeleteTextures(1, &mName);
+        GLStateCache::shared().forgetTexture(mName);
+        GLStateCache::shared().backend().deleteTexture(mName);
     }
 
     // Specializing by data type
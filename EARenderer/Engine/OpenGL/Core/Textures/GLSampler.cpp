@@ -7,6 +7,7 @@
 //
 
 #include "GLSampler.hpp"
+#include "GLStateCache.hpp"
 
 #include <OpenGL/gl3ext.h>
 
@@ -15,19 +16,21 @@ namespace EARenderer {
 #pragma mark - Lifecycle
 
     GLSampler::GLSampler(Sampling::Filter filter, Sampling::WrapMode wrapMode, Sampling::ComparisonMode comparisonMode) {
-        glGenSamplers(1, &mName);
+        mName = GLStateCache::shared().backend().genSampler();
         setFilter(filter);
         setWrapMode(wrapMode);
         setComparisonMode(comparisonMode);
     }
 
     GLSampler::~GLSampler() {
-        glDeleteSamplers(1, &mName);
+        GLStateCache::shared().forgetSampler(mName);
+        GLStateCache::shared().backend().deleteSampler(mName);
     }
 
 #pragma mark - Binding
 
     void GLSampler::setFilter(Sampling::Filter filter) {
+        auto &backend = GLStateCache::shared().backend();
         GLint glMinFilter = 0;
         GLint glMagFilter = 0;
 
@@ -45,17 +48,17 @@ namespace EARenderer {
             case Sampling::Filter::Anisotropic:
                 glMinFilter = GL_LINEAR_MIPMAP_LINEAR;
                 glMagFilter = GL_LINEAR;
-                float aniso = 0.0f;
-                glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &aniso);
-                glSamplerParameterf(mName, GL_TEXTURE_MAX_ANISOTROPY_EXT, std::min(aniso, 16.0f));
+                float aniso = backend.floatValue(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT);
+                backend.samplerParameterf(mName, GL_TEXTURE_MAX_ANISOTROPY_EXT, std::min(aniso, 16.0f));
                 break;
         }
 
-        glSamplerParameteri(mName, GL_TEXTURE_MIN_FILTER, glMinFilter);
-        glSamplerParameteri(mName, GL_TEXTURE_MAG_FILTER, glMagFilter);
+        backend.samplerParameteri(mName, GL_TEXTURE_MIN_FILTER, glMinFilter);
+        backend.samplerParameteri(mName, GL_TEXTURE_MAG_FILTER, glMagFilter);
     }
 
     void GLSampler::setWrapMode(Sampling::WrapMode wrapMode) {
+        auto &backend = GLStateCache::shared().backend();
         GLint wrap = 0;
 
         switch (wrapMode) {
@@ -70,19 +73,21 @@ namespace EARenderer {
                 break;
         }
 
-        glSamplerParameteri(mName, GL_TEXTURE_WRAP_S, wrap);
-        glSamplerParameteri(mName, GL_TEXTURE_WRAP_T, wrap);
-        glSamplerParameteri(mName, GL_TEXTURE_WRAP_R, wrap);
+        backend.samplerParameteri(mName, GL_TEXTURE_WRAP_S, wrap);
+        backend.samplerParameteri(mName, GL_TEXTURE_WRAP_T, wrap);
+        backend.samplerParameteri(mName, GL_TEXTURE_WRAP_R, wrap);
     }
 
     void GLSampler::setComparisonMode(Sampling::ComparisonMode comparisonMode) {
+        auto &backend = GLStateCache::shared().backend();
+
         switch (comparisonMode) {
             case Sampling::ComparisonMode::None:
-                glSamplerParameteri(mName, GL_TEXTURE_COMPARE_MODE, GL_NONE);
+                backend.samplerParameteri(mName, GL_TEXTURE_COMPARE_MODE, GL_NONE);
                 break;
             case Sampling::ComparisonMode::ReferenceToTexture:
-                glSamplerParameteri(mName, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
-                glSamplerParameteri(mName, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+                backend.samplerParameteri(mName, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+                backend.samplerParameteri(mName, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
                 break;
         }
     }
@@ -8,6 +8,7 @@
 
 #include "GLTexture.hpp"
 #include "GLTextureUnitManager.hpp"
+#include "GLStateCache.hpp"
 
 #include <cmath>
 #include <OpenGL/gl3ext.h>
@@ -20,17 +21,19 @@ namespace EARenderer {
     }
 
     GLTexture::GLTexture(const Size2D &size, GLenum bindingPoint) : mSize(size), mBindingPoint(bindingPoint) {
-        glGenTextures(1, &mName);
+        mName = GLStateCache::shared().backend().genTexture();
         GLTextureUnitManager::Shared().bindTextureToActiveUnit(*this);
     }
 
     GLTexture::~GLTexture() {
-        glDeleteTextures(1, &mName);
+        GLStateCache::shared().forgetTexture(mName);
+        GLStateCache::shared().backend().deleteTexture(mName);
     }
 
 #pragma mark - Protected helpers
 
     void GLTexture::setFilter(Sampling::Filter filter) {
+        auto &backend = GLStateCache::shared().backend();
         GLint glMinFilter = 0;
         GLint glMagFilter = 0;
 
@@ -48,14 +51,13 @@ namespace EARenderer {
             case Sampling::Filter::Anisotropic:
                 glMinFilter = GL_LINEAR_MIPMAP_LINEAR;
                 glMagFilter = GL_LINEAR;
-                float aniso = 0.0f;
-                glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &aniso);
-                glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, std::min(aniso, 16.0f));
+                float aniso = backend.floatValue(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT);
+                backend.texParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, std::min(aniso, 16.0f));
                 break;
         }
 
-        glTexParameteri(mBindingPoint, GL_TEXTURE_MIN_FILTER, glMinFilter);
-        glTexParameteri(mBindingPoint, GL_TEXTURE_MAG_FILTER, glMagFilter);
+        backend.texParameteri(mBindingPoint, GL_TEXTURE_MIN_FILTER, glMinFilter);
+        backend.texParameteri(mBindingPoint, GL_TEXTURE_MAG_FILTER, glMagFilter);
     }
 
     void GLTexture::setWrapMode(Sampling::WrapMode wrapMode) {
@@ -73,23 +75,61 @@ namespace EARenderer {
                 break;
         }
 
-        glTexParameteri(mBindingPoint, GL_TEXTURE_WRAP_S, wrap);
-        glTexParameteri(mBindingPoint, GL_TEXTURE_WRAP_T, wrap);
-        glTexParameteri(mBindingPoint, GL_TEXTURE_WRAP_R, wrap);
+        auto &backend = GLStateCache::shared().backend();
+        backend.texParameteri(mBindingPoint, GL_TEXTURE_WRAP_S, wrap);
+        backend.texParameteri(mBindingPoint, GL_TEXTURE_WRAP_T, wrap);
+        backend.texParameteri(mBindingPoint, GL_TEXTURE_WRAP_R, wrap);
     }
 
     void GLTexture::setComparisonMode(Sampling::ComparisonMode comparisonMode) {
+        auto &backend = GLStateCache::shared().backend();
+
         switch (comparisonMode) {
             case Sampling::ComparisonMode::None:
-                glTexParameteri(mBindingPoint, GL_TEXTURE_COMPARE_MODE, GL_NONE);
+                backend.texParameteri(mBindingPoint, GL_TEXTURE_COMPARE_MODE, GL_NONE);
                 break;
             case Sampling::ComparisonMode::ReferenceToTexture:
-                glTexParameteri(mBindingPoint, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
-                glTexParameteri(mBindingPoint, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+                backend.texParameteri(mBindingPoint, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+                backend.texParameteri(mBindingPoint, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
                 break;
         }
     }
 
+    void GLTexture::trackStorage(GLint internalFormat, size_t layerCount) {
+        mInternalFormat = internalFormat;
+        mLayerCount = layerCount;
+        updateMemoryFootprint();
+    }
+
+#pragma mark - Private helpers
+
+    void GLTexture::updateMemoryFootprint() {
+        if (mInternalFormat == 0) {
+            return;
+        }
+
+        size_t bytesPerTexel = BytesPerTexel(mInternalFormat);
+        size_t bytes = 0;
+
+        for (size_t level = 0; level <= mMipMapsCount; level++) {
+            if (bytesPerTexel > 0) {
+                size_t width = std::max(size_t(mSize.width) >> level, size_t(1));
+                size_t height = std::max(size_t(mSize.height) >> level, size_t(1));
+                // Depth of 3D textures shrinks with every level, unlike faces and array layers
+                size_t layerCount = mBindingPoint == GL_TEXTURE_3D ? std::max(mLayerCount >> level, size_t(1)) : mLayerCount;
+                bytes += width * height * layerCount * bytesPerTexel;
+            } else {
+                // Generic compressed formats are sized by the driver, so ask it.
+                // Cube map levels are queried per face.
+                GLenum target = mBindingPoint == GL_TEXTURE_CUBE_MAP ? GL_TEXTURE_CUBE_MAP_POSITIVE_X : mBindingPoint;
+                size_t faceCount = mBindingPoint == GL_TEXTURE_CUBE_MAP ? 6 : 1;
+                GLint compressedSize = GLStateCache::shared().backend().textureLevelInteger(target, GLint(level), GL_TEXTURE_COMPRESSED_IMAGE_SIZE);
+                bytes += size_t(compressedSize) * faceCount;
+            }
+        }
+
+        mMemory.resize(bytes);
+    }
 
 #pragma mark - Static
 
@@ -141,6 +181,40 @@ namespace EARenderer {
         return textureSize.transformedBy(glm::vec2(std::pow(0.5, mipLevel)));
     }
 
+    size_t GLTexture::BytesPerTexel(GLint internalFormat) {
+        switch (internalFormat) {
+            case GL_R8:
+                return 1;
+            case GL_RG8:
+            case GL_R16F:
+                return 2;
+            case GL_RGB8:
+                return 3;
+            case GL_RGBA8:
+            case GL_RG16F:
+            case GL_R32F:
+            case GL_R32UI:
+            // Packed into 32 bits by virtually every driver
+            case GL_DEPTH_COMPONENT:
+            case GL_DEPTH_COMPONENT24:
+                return 4;
+            case GL_RGB16F:
+                return 6;
+            case GL_RGBA16F:
+            case GL_RG32F:
+            case GL_RG32UI:
+                return 8;
+            case GL_RGB32F:
+            case GL_RGB32UI:
+                return 12;
+            case GL_RGBA32F:
+            case GL_RGBA32UI:
+                return 16;
+            default:
+                return 0;
+        }
+    }
+
 #pragma mark - Getters
 
     const Size2D &GLTexture::size() const {
@@ -159,21 +233,27 @@ namespace EARenderer {
 
     void GLTexture::generateMipMaps(size_t count) {
         GLTextureUnitManager::Shared().bindTextureToActiveUnit(*this);
-        glTexParameteri(mBindingPoint, GL_TEXTURE_MAX_LEVEL, GLint(count));
+        GLStateCache::shared().backend().texParameteri(mBindingPoint, GL_TEXTURE_MAX_LEVEL, GLint(count));
         setFilter(Sampling::Filter::Trilinear);
-        glGenerateMipmap(mBindingPoint);
+        GLStateCache::shared().backend().generateMipmap(mBindingPoint);
 
         mMipMapsCount = floor(std::log2(std::max(mSize.width, mSize.height)));
         mMipMapsCount = std::min(mMipMapsCount, uint16_t(count));
+
+        updateMemoryFootprint();
     }
 
     Size2D GLTexture::mipMapSize(size_t mipLevel) const {
         GLTextureUnitManager::Shared().bindTextureToActiveUnit(*this);
-        GLint w = 0;
-        GLint h = 0;
-        glGetTexLevelParameteriv(mBindingPoint, GLint(mipLevel), GL_TEXTURE_WIDTH, &w);
-        glGetTexLevelParameteriv(mBindingPoint, GLint(mipLevel), GL_TEXTURE_HEIGHT, &h);
+        GLint w = GLStateCache::shared().backend().textureLevelInteger(mBindingPoint, GLint(mipLevel), GL_TEXTURE_WIDTH);
+        GLint h = GLStateCache::shared().backend().textureLevelInteger(mBindingPoint, GLint(mipLevel), GL_TEXTURE_HEIGHT);
         return {float(w), float(h)};
     }
 
+#pragma mark - Memory
+
+    size_t GLTexture::memorySize() const {
+        return mMemory.bytes();
+    }
+
 }
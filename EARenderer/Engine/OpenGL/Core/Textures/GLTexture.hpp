@@ -14,6 +14,7 @@
 #include "Color.hpp"
 #include "GLTextureFormat.hpp"
 #include "Sampling.hpp"
+#include "MemoryTracker.hpp"
 
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
@@ -42,6 +43,14 @@ namespace EARenderer {
 
     private:
         GLenum mBindingPoint;
+        GLint mInternalFormat = 0;
+        size_t mLayerCount = 1;
+        TrackedAllocation mMemory{MemoryDomain::GPU};
+
+        /**
+         Reports current storage size, including mip maps, to the memory tracker
+         */
+        void updateMemoryFootprint();
 
     protected:
         Size2D mSize;
@@ -57,6 +66,14 @@ namespace EARenderer {
 
         void setComparisonMode(Sampling::ComparisonMode comparisonMode);
 
+        /**
+         Must be called by subclasses once storage is specified
+
+         @param internalFormat internal format of the storage
+         @param layerCount number of faces, array layers or depth slices of the base level
+         */
+        void trackStorage(GLint internalFormat, size_t layerCount = 1);
+
         static constexpr GLTextureFormat glFormat(Depth format) {
             switch (format) {
                 case Depth::Default:
@@ -140,6 +157,12 @@ namespace EARenderer {
 
         static Size2D EstimatedMipSize(const Size2D &textureSize, uint8_t mipLevel);
 
+        /**
+         @param internalFormat sized or depth internal format
+         @return size of a texel, 0 for compressed formats whose size is chosen by the driver
+         */
+        static size_t BytesPerTexel(GLint internalFormat);
+
         const Size2D &size() const;
 
         uint16_t mipMapCount() const;
@@ -149,6 +172,11 @@ namespace EARenderer {
         void generateMipMaps(size_t count = 1000);
 
         Size2D mipMapSize(size_t mipLevel) const;
+
+        /**
+         @return bytes occupied by the storage of all layers and mip maps
+         */
+        size_t memorySize() const;
     };
 
 }
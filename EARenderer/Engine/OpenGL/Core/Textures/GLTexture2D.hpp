@@ -11,6 +11,7 @@
 
 #include "GLTexture.hpp"
 #include "GLTexture2DSampler.hpp"
+#include "GLStateCache.hpp"
 
 namespace EARenderer {
 
@@ -25,7 +26,8 @@ namespace EARenderer {
             mSize = size;
             constexpr GLTextureFormat f = glFormat(Format);
 
-            glTexImage2D(GL_TEXTURE_2D, 0, f.internalFormat, size.width, size.height, 0, f.inputPixelFormat, f.inputPixelType, pixelData);
+            GLStateCache::shared().backend().texImage2D(GL_TEXTURE_2D, 0, f.internalFormat, size.width, size.height, f.inputPixelFormat, f.inputPixelType, pixelData);
+            trackStorage(f.internalFormat);
 
             setFilter(filter);
             setWrapMode(wrapMode);
@@ -10,6 +10,7 @@
 #define GLTexture2DArray_hpp
 
 #include "GLTexture.hpp"
+#include "GLStateCache.hpp"
 
 #include <OpenGL/gl3ext.h>
 #include <vector>
@@ -37,15 +38,17 @@ namespace EARenderer {
 
             constexpr GLTextureFormat f = glFormat(Format);
 
-            glTexStorage3D(GL_TEXTURE_2D_ARRAY,
+            auto &backend = GLStateCache::shared().backend();
+            backend.texStorage3D(GL_TEXTURE_2D_ARRAY,
                     1, // No mipmaps (1 means that there is only one base image level)
                     f.internalFormat, // Internal format
                     size.width, // Width
                     size.height, // Height
                     (GLint) count); // Number of layers (elements, textures) in the array
+            trackStorage(f.internalFormat, count);
 
             for (size_t i = 0; i < pixelData.size(); i++) {
-                glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, (GLint) i,
+                backend.texSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, (GLint) i,
                         size.width, size.height, 1,
                         f.inputPixelFormat, f.inputPixelType, pixelData[i]);
             }
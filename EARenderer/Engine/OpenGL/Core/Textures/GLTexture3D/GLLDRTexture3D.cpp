@@ -16,4 +16,13 @@ namespace EARenderer {
         initialize(size, depth, Sampling::Filter::None, Sampling::WrapMode::ClampToEdge, GL_RGBA32UI);
     }
 
+    GLLDRTexture3D::GLLDRTexture3D(const Size2D &size, size_t depth, const glm::uvec4 *texels) {
+        size_t layerSize = size_t(size.width) * size_t(size.height);
+        std::vector<void *> layers;
+        for (size_t i = 0; i < depth; i++) {
+            layers.push_back((void *) (texels + i * layerSize));
+        }
+        initialize(size, Sampling::Filter::None, Sampling::WrapMode::ClampToEdge, GL_RGBA32UI, GL_RGBA_INTEGER, GL_UNSIGNED_INT, layers);
+    }
+
 }
@@ -11,12 +11,21 @@
 
 #include "GLTexture3D.hpp"
 
+#include <glm/vec4.hpp>
+
 namespace EARenderer {
 
     class GLLDRTexture3D : public GLTexture3D {
     public:
         GLLDRTexture3D(const Size2D &size, size_t depth);
 
+        /**
+         @param size width and height of the texture
+         @param depth amount of layers
+         @param texels width * height * depth texels, layer by layer
+         */
+        GLLDRTexture3D(const Size2D &size, size_t depth, const glm::uvec4 *texels);
+
         ~GLLDRTexture3D() = default;
     };
 
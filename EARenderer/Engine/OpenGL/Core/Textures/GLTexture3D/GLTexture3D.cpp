@@ -7,6 +7,7 @@
 //
 
 #include "GLTexture3D.hpp"
+#include "GLStateCache.hpp"
 
 #include <stdexcept>
 #include <OpenGL/gl3ext.h>
@@ -35,12 +36,13 @@ namespace EARenderer {
         mDepth = depth;
         mSize = size;
 
-        glTexStorage3D(GL_TEXTURE_3D,
+        GLStateCache::shared().backend().texStorage3D(GL_TEXTURE_3D,
                 1, // No mipmaps (1 means that there is only one base image level)
                 internalFormat, // Internal format
                 size.width, // Width
                 size.height, // Height
                 (GLint) depth); // Depth of the 3D texture
+        trackStorage(internalFormat, depth);
 
         setFilter(filter);
         setWrapMode(wrapMode);
@@ -52,7 +54,7 @@ namespace EARenderer {
 
         for (size_t i = 0; i < pixelData.size(); i++) {
             void *pixels = pixelData[i];
-            glTexSubImage3D(GL_TEXTURE_3D, 0, 0, 0, (GLint) i,
+            GLStateCache::shared().backend().texSubImage3D(GL_TEXTURE_3D, 0, 0, 0, (GLint) i,
                     size.width, size.height, 1,
                     format, type, pixels);
         }
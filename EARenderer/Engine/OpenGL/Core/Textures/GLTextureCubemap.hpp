@@ -11,6 +11,7 @@
 
 #include "GLTexture.hpp"
 #include "GLCubemapFace.hpp"
+#include "GLStateCache.hpp"
 
 #include <array>
 #include <OpenGL/OpenGL.h>
@@ -30,9 +31,10 @@ namespace EARenderer {
             constexpr GLTextureFormat f = glFormat(Format);
 
             for (GLuint i = 0; i < 6; i++) {
-                glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, f.internalFormat, size.width,
-                        size.height, 0, f.inputPixelFormat, f.inputPixelType, pixelData[i]);
+                GLStateCache::shared().backend().texImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, f.internalFormat, size.width,
+                        size.height, f.inputPixelFormat, f.inputPixelType, pixelData[i]);
             }
+            trackStorage(f.internalFormat, 6);
 
             setFilter(filter);
             setWrapMode(wrapMode);
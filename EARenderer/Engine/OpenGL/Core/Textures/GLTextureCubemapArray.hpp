@@ -10,6 +10,7 @@
 #define GLTextureCubemapArray_hpp
 
 #include "GLTexture.hpp"
+#include "GLStateCache.hpp"
 
 #include <OpenGL/gl3ext.h>
 
@@ -36,12 +37,13 @@ namespace EARenderer {
 
             constexpr GLTextureFormat f = glFormat(Format);
 
-            glTexStorage3D(GL_TEXTURE_3D,
+            GLStateCache::shared().backend().texStorage3D(GL_TEXTURE_3D,
                     1, // No mipmaps (1 means that there is only one base image level)
                     f.internalFormat, // Internal format
                     size.width, // Width
                     size.height, // Height
                     (GLint) count * 6); // Number of layers * number of faces per layer
+            trackStorage(f.internalFormat, count * 6);
 
             setFilter(filter);
             setWrapMode(wrapMode);
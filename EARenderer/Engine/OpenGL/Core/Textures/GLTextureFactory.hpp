@@ -12,6 +12,7 @@
 #include "GLTexture2D.hpp"
 #include "GLTextureCubemap.hpp"
 #include "StringUtils.hpp"
+#include "Profiler.hpp"
 
 #include <string>
 #include <memory>
@@ -26,6 +27,7 @@ namespace EARenderer {
 
         template<GLTexture::Normalized Format>
         static std::unique_ptr<GLNormalizedTexture2D<Format>> LoadLDRImage(const std::string &imagePath) {
+            EA_PROFILE_SCOPE("Load LDR image");
 
             int32_t width = 0;
             int32_t height = 0;
@@ -45,6 +47,7 @@ namespace EARenderer {
         }
 
         static std::unique_ptr<GLFloatTexture2D<GLTexture::Float::RGB16F>> LoadHDRImage(const std::string &imagePath) {
+            EA_PROFILE_SCOPE("Load HDR image");
 
             int32_t width = 0;
             int32_t height = 0;
@@ -72,6 +75,7 @@ namespace EARenderer {
                 const std::string &negativeYImagePath,
                 const std::string &positiveZImagePath,
                 const std::string &negativeZImagePath) {
+            EA_PROFILE_SCOPE("Load LDR cube image");
 
             int32_t width = 0;
             int32_t height = 0;
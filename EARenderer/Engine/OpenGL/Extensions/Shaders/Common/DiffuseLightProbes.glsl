@@ -108,6 +108,29 @@ SH UnpackSH(usampler3D gridSHMap0,
 #endif
 }
 
+uvec3 UnpackBrickLookupValue(uint value) {
+    return uvec3(value & 0x3FFu, (value >> 10u) & 0x3FFu, (value >> 20u) & 0x3FFu);
+}
+
+// Converts normalized coordinates inside the light probe volume into
+// unnormalized coordinates inside the probe atlas (floating-point indices of probes).
+// Each lookup cell refers to a brick of probes covering a box of cells,
+// for the uniform layout there is a single cell and a single brick spanning the whole grid.
+vec3 ProbeAtlasCoordinates(usampler3D brickLookup, vec3 normTexCoords) {
+    ivec3 lookupSize = textureSize(brickLookup, 0);
+    vec3 cellCoords = clamp(normTexCoords, 0.0, 1.0) * vec3(lookupSize);
+    ivec3 cell = clamp(ivec3(cellCoords), ivec3(0), lookupSize - 1);
+
+    uvec4 brick = texelFetch(brickLookup, cell, 0);
+    vec3 atlasOrigin = vec3(UnpackBrickLookupValue(brick.x));
+    vec3 cellOrigin = vec3(UnpackBrickLookupValue(brick.y));
+    vec3 cellExtent = vec3(UnpackBrickLookupValue(brick.z));
+    vec3 probeIntervals = vec3(UnpackBrickLookupValue(brick.w));
+
+    vec3 brickCoords = clamp((cellCoords - cellOrigin) / cellExtent, 0.0, 1.0);
+    return atlasOrigin + brickCoords * probeIntervals;
+}
+
 float ProbeOcclusionFactor(samplerBuffer probePositions, // A sequential buffer containing world positions for all probes in the scene
                            ivec3 probeGridPosition, // 3D integer position of a probe in probe grid ( [0; 5; 3] for example )
                            ivec3 gridSize, // Size of the probe grid
@@ -120,11 +143,12 @@ float ProbeOcclusionFactor(samplerBuffer probePositions, // A sequential buffer
     // [x + WIDTH * (y + HEIGHT * z)]
     int probeCoord1D = probeGridPosition.x + gridWidth * (probeGridPosition.y + gridHeight * probeGridPosition.z);
 
-    vec3 probePosition = texelFetch(probePositions, probeCoord1D).xyz;
+    // W component is 0 for probes embedded in geometry
+    vec4 probePosition = texelFetch(probePositions, probeCoord1D);
 
-    vec3 surfaceToProbe = normalize(probePosition - worldPosition);
+    vec3 surfaceToProbe = normalize(probePosition.xyz - worldPosition);
     float weight = max(0.0, dot(surfaceToProbe, surfaceNormal));
-    return weight;
+    return weight * probePosition.w;
 }
 
 // Computes 8 interpolation weights given 2 corner points and a point of interest
@@ -165,6 +189,7 @@ SH TriLerpSurroundingProbes(usampler3D gridSHMap0, // Each uint sampled from the
                             usampler3D gridSHMap1, // contains 2 encoded half-precision float values
                             usampler3D gridSHMap2, // 4 3D textures
                             usampler3D gridSHMap3,
+                            usampler3D brickLookup,
                             samplerBuffer probeWorldPositions,
                             vec3 surfaceNormal,
                             vec3 surfaceWorldPosition,
@@ -179,8 +204,8 @@ SH TriLerpSurroundingProbes(usampler3D gridSHMap0, // Each uint sampled from the
     // Compute normalized 3D texture coordinates of a surface
     vec3 normTexCoords = (gridSpaceTransform * vec4(surfaceWorldPosition, 1.0)).xyz;
 
-    // Compute unnormalized coordinates of a surface, basically floating-point indices inside the probe grid
-    vec3 unnormTexCoords = normTexCoords * vec3(gridSize - 1);
+    // Compute unnormalized coordinates of a surface, basically floating-point indices inside the probe atlas
+    vec3 unnormTexCoords = ProbeAtlasCoordinates(brickLookup, normTexCoords);
 
     // Get unnormalized texture coordinates of the closest corner points
     // that can represent a cell containing current surface in the light probe grid
@@ -266,7 +291,7 @@ SH TriLerpSurroundingProbes(usampler3D gridSHMap0, // Each uint sampled from the
     // non-zero weights will still sum up to 1.
     // By doing this we're effectively excluding occluded probes
     // from calculations
-    float weightScale = 1.0 / (1.0 - excludedWeight);
+    float weightScale = 1.0 / max(1.0 - excludedWeight, 1e-5);
 
     weights.value0 *= weightScale; weights.value1 *= weightScale;
     weights.value2 *= weightScale; weights.value3 *= weightScale;
@@ -289,6 +314,7 @@ vec3 EvaluateDiffuseLightProbes(usampler3D gridSHMap0, // Each uint sampled from
                                 usampler3D gridSHMap1, // contains 2 encoded half-precision float values
                                 usampler3D gridSHMap2, // 4 3D textures
                                 usampler3D gridSHMap3,
+                                usampler3D brickLookup,
                                 samplerBuffer probeWorldPositions,
                                 vec3 surfaceNormal,
                                 vec3 surfaceWorldPosition,
@@ -298,6 +324,7 @@ vec3 EvaluateDiffuseLightProbes(usampler3D gridSHMap0, // Each uint sampled from
                                      gridSHMap1,
                                      gridSHMap2,
                                      gridSHMap3,
+                                     brickLookup,
                                      probeWorldPositions,
                                      surfaceNormal,
                                      surfaceWorldPosition,
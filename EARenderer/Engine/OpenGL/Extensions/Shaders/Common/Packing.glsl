@@ -48,6 +48,19 @@ vec2 UnpackSnorm2x16(uint package, float range) {
     return vec2(fFirst, fSecond);
 }
 
+// Unpacks 4 signed 8-bit integers (first one in the most significant byte)
+// into floats in [-range, range]
+vec4 UnpackSnorm4x8(uint package, float range) {
+    const float base = 127.0;
+
+    ivec4 values = ivec4(int(package >> 24), int(package >> 16), int(package >> 8), int(package)) & 0xFF;
+
+    // Sign-extend 8-bit values
+    values -= ivec4(greaterThan(values, ivec4(127))) * 256;
+
+    return vec4(values) / base * range;
+}
+
 vec4 Decode8888(uint encoded) {
     vec4 decoded;
     decoded.x = (0xFF000000u & encoded) >> 24;
@@ -65,3 +78,14 @@ uint Encode8888(vec4 vector) {
     uint(vector.w * 255.0);
     return rgba;
 }
+
+// Restores a unit vector from its octahedral projection in [-1, 1],
+// see QuantizedVertex::OctahedralEncode() for the encoding side
+vec3 OctahedralDecode(vec2 encoded) {
+    vec3 direction = vec3(encoded.xy, 1.0 - abs(encoded.x) - abs(encoded.y));
+    if (direction.z < 0.0) {
+        vec2 signNotZero = vec2(encoded.x >= 0.0 ? 1.0 : -1.0, encoded.y >= 0.0 ? 1.0 : -1.0);
+        direction.xy = (1.0 - abs(direction.yx)) * signNotZero;
+    }
+    return normalize(direction);
+}
@@ -20,23 +20,23 @@ namespace EARenderer {
 #pragma mark - Setters
 
     void GLSLSurfelRendering::setViewProjectionMatrix(const glm::mat4 &mvp) {
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uViewProjectionMatrix")).location(), 1, GL_FALSE, glm::value_ptr(mvp));
+        setUniformMatrix4fv(ctcrc32("uViewProjectionMatrix"), 1, GL_FALSE, glm::value_ptr(mvp));
     }
 
     void GLSLSurfelRendering::setSurfelRadius(float radius) {
-        glUniform1f(uniformByNameCRC32(ctcrc32("uRadius")).location(), radius);
+        setUniform1f(ctcrc32("uRadius"), radius);
     }
 
     void GLSLSurfelRendering::setShouldUseExternalColor(bool useExternalColor) {
-        glUniform1i(uniformByNameCRC32(ctcrc32("uUseExternalColor")).location(), useExternalColor);
+        setUniform1i(ctcrc32("uUseExternalColor"), useExternalColor);
     }
 
     void GLSLSurfelRendering::setExternalColor(const Color &externalColor) {
-        glUniform3fv(uniformByNameCRC32(ctcrc32("uExternalColor")).location(), 1, glm::value_ptr(externalColor.rgb()));
+        setUniform3fv(ctcrc32("uExternalColor"), 1, glm::value_ptr(externalColor.rgb()));
     }
 
     void GLSLSurfelRendering::setSurfelGroupOffset(int32_t surfelGroupOffset) {
-        glUniform1i(uniformByNameCRC32(ctcrc32("uSurfelGroupOffset")).location(), surfelGroupOffset);
+        setUniform1i(ctcrc32("uSurfelGroupOffset"), surfelGroupOffset);
     }
 
     void GLSLSurfelRendering::setSurfelLuminances(const GLFloatTexture2D<GLTexture::Float::R16F> &surfelLuminances) {
@@ -22,8 +22,8 @@ namespace EARenderer {
 #pragma mark - Setters
 
     void GLSLGridLightProbeRendering::setCamera(const Camera &camera) {
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uCameraSpaceMat")).location(), 1, GL_FALSE, glm::value_ptr(camera.viewProjectionMatrix()));
-        glUniform3fv(uniformByNameCRC32(ctcrc32("uCameraPosition")).location(), 1, glm::value_ptr(camera.position()));
+        setUniformMatrix4fv(ctcrc32("uCameraSpaceMat"), 1, GL_FALSE, glm::value_ptr(camera.viewProjectionMatrix()));
+        setUniform3fv(ctcrc32("uCameraPosition"), 1, glm::value_ptr(camera.position()));
     }
 
     void GLSLGridLightProbeRendering::setGridProbesSHTextures(const std::array<GLLDRTexture3D, 4> &textures) {
@@ -33,16 +33,8 @@ namespace EARenderer {
         setUniformTexture(ctcrc32("uGridSHMap3"), textures[3]);
     }
 
-    void GLSLGridLightProbeRendering::setWorldBoundingBox(const AxisAlignedBox3D &box) {
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uWorldBoudningBoxTransform")).location(), 1, GL_FALSE, glm::value_ptr(box.localSpaceMatrix()));
-    }
-
-    void GLSLGridLightProbeRendering::setProbesGridResolution(const glm::ivec3 &resolution) {
-        glUniform3iv(uniformByNameCRC32(ctcrc32("uProbesGridResolution")).location(), 1, glm::value_ptr(resolution));
-    }
-
     void GLSLGridLightProbeRendering::setSphereRadius(float radius) {
-        glUniform1f(uniformByNameCRC32(ctcrc32("uRadius")).location(), radius);
+        setUniform1f(ctcrc32("uRadius"), radius);
     }
 
 }
@@ -24,10 +24,6 @@ namespace EARenderer {
 
         void setGridProbesSHTextures(const std::array<GLLDRTexture3D, 4> &textures);
 
-        void setWorldBoundingBox(const AxisAlignedBox3D &box);
-
-        void setProbesGridResolution(const glm::ivec3 &resolution);
-
         void setSphereRadius(float radius);
     };
 
@@ -20,11 +20,11 @@ namespace EARenderer {
 #pragma mark - Setters
 
     void GLSLLightProbeLinksRendering::setCamera(const Camera &camera) {
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uCameraSpaceMat")).location(), 1, GL_FALSE, glm::value_ptr(camera.viewProjectionMatrix()));
+        setUniformMatrix4fv(ctcrc32("uCameraSpaceMat"), 1, GL_FALSE, glm::value_ptr(camera.viewProjectionMatrix()));
     }
 
     void GLSLLightProbeLinksRendering::setWorldBoundingBox(const AxisAlignedBox3D &box) {
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uWorldBoudningBoxTransform")).location(), 1, GL_FALSE, glm::value_ptr(box.localSpaceMatrix()));
+        setUniformMatrix4fv(ctcrc32("uWorldBoudningBoxTransform"), 1, GL_FALSE, glm::value_ptr(box.localSpaceMatrix()));
     }
 
     void GLSLLightProbeLinksRendering::setProjectionClusterIndices(const GLIntegerBufferTexture<GLTexture::Integer::R32UI, uint32_t> &indices) {
@@ -40,7 +40,7 @@ namespace EARenderer {
     }
 
     void GLSLLightProbeLinksRendering::setProbesGridResolution(const glm::ivec3 &resolution) {
-        glUniform3iv(uniformByNameCRC32(ctcrc32("uProbesGridResolution")).location(), 1, glm::value_ptr(resolution));
+        setUniform3iv(ctcrc32("uProbesGridResolution"), 1, glm::value_ptr(resolution));
     }
 
 }
@@ -8,7 +8,7 @@
 // Input
 
 in vec3 vCurrentPosition;
-in vec3 vTexCoords;
+in vec3 vTexCoords; // Integer coordinates of the probe in the probe atlas
 in mat3 vNormalMatrix;
 
 // Output
@@ -18,7 +18,6 @@ out vec4 oFragColor;
 // Uniforms
 
 uniform float uRadius;
-uniform ivec3 uProbesGridResolution;
 
 uniform usampler3D uGridSHMap0;
 uniform usampler3D uGridSHMap1;
@@ -27,18 +26,10 @@ uniform usampler3D uGridSHMap3;
 
 // Functions
 
-// Shrink tex coords by the size of 1 texel, which will result in a (0; 0; 0)
-// coordinate to become (0.5; 0.5; 0.5) coordinate (in texel space)
-vec3 AlignWithTexelCenters(vec3 texCoords) {
-    vec3 halfTexel = 1.0 / vec3(uProbesGridResolution) / 2.0;
-    vec3 reductionFactor = vec3(uProbesGridResolution - 1) / vec3(uProbesGridResolution);
-    return texCoords * reductionFactor + halfTexel;
-}
-
 SH UnpackSH_333_HalfPacked() {
     SH sh = ZeroSH();
 
-    ivec3 iTexCoords = ivec3(AlignWithTexelCenters(vTexCoords) * uProbesGridResolution);
+    ivec3 iTexCoords = ivec3(round(vTexCoords));
 
     uvec4 shMap0Data = texelFetch(uGridSHMap0, iTexCoords, 0);
     uvec4 shMap1Data = texelFetch(uGridSHMap1, iTexCoords, 0);
@@ -3,9 +3,15 @@
 // Attributes
 
 layout (location = 0) in vec3 iPosition;
+layout (location = 1) in vec3 iAtlasCoordinates;
+
+// Output
+
+out vec3 vAtlasCoordinates;
 
 // Functions
 
 void main() {
     gl_Position = vec4(iPosition, 1.0);
+    vAtlasCoordinates = iAtlasCoordinates;
 }
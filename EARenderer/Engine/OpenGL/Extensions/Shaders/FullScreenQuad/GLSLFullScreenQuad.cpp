@@ -21,13 +21,13 @@ namespace EARenderer {
 
     void GLSLFullScreenQuad::setTexture(const GLTexture3D &texture, float depth) {
         setUniformTexture(ctcrc32("uTexture3D"), texture);
-        glUniform1i(uniformByNameCRC32(ctcrc32("uDepth")).location(), depth);
-        glUniform1i(uniformByNameCRC32(ctcrc32("uShouldSample3DTexture")).location(), GL_TRUE);
-        glUniform1i(uniformByNameCRC32(ctcrc32("uShouldSampleArray")).location(), GL_FALSE);
+        setUniform1i(ctcrc32("uDepth"), depth);
+        setUniform1i(ctcrc32("uShouldSample3DTexture"), GL_TRUE);
+        setUniform1i(ctcrc32("uShouldSampleArray"), GL_FALSE);
     }
 
     void GLSLFullScreenQuad::setApplyToneMapping(bool toneMap) {
-        glUniform1i(uniformByNameCRC32(ctcrc32("uShouldApplyToneMapping")).location(), toneMap);
+        setUniform1i(ctcrc32("uShouldApplyToneMapping"), toneMap);
     }
 
 }
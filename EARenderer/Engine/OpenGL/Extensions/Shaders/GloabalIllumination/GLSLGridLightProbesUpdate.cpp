@@ -19,15 +19,25 @@ namespace EARenderer {
 #pragma mark - Setters
 
     void GLSLGridLightProbesUpdate::setProbesGridResolution(const glm::ivec3 &resolution) {
-        glUniform3iv(uniformByNameCRC32(ctcrc32("uProbesGridResolution")).location(), 1, glm::value_ptr(resolution));
+        setUniform3iv(ctcrc32("uProbesGridResolution"), 1, glm::value_ptr(resolution));
+    }
+
+    void GLSLGridLightProbesUpdate::setLayerOffset(int32_t offset) {
+        setUniform1i(ctcrc32("uLayerOffset"), offset);
     }
 
     void GLSLGridLightProbesUpdate::setSurfelClustersLuminaceMap(const GLFloatTexture2D<GLTexture::Float::R16F> &luminanceMap) {
         setUniformTexture(ctcrc32("uSurfelClustersLuminanceMap"), luminanceMap);
     }
 
-    void GLSLGridLightProbesUpdate::setProjectionClusterSphericalHarmonics(const GLFloatBufferTexture<GLTexture::Float::RGB32F, SphericalHarmonics> &SH) {
+    void GLSLGridLightProbesUpdate::setProjectionClusterSphericalHarmonics(const GLIntegerBufferTexture<GLTexture::Integer::RGB32UI, SphericalHarmonics> &SH) {
+        setBufferTexture(ctcrc32("uProjectionClusterSphericalHarmonics"), SH);
+        setUniform1i(ctcrc32("uQuantizedProjections"), GL_FALSE);
+    }
+
+    void GLSLGridLightProbesUpdate::setProjectionClusterSphericalHarmonics(const GLIntegerBufferTexture<GLTexture::Integer::RGBA32UI, QuantizedSphericalHarmonics> &SH) {
         setBufferTexture(ctcrc32("uProjectionClusterSphericalHarmonics"), SH);
+        setUniform1i(ctcrc32("uQuantizedProjections"), GL_TRUE);
     }
 
     void GLSLGridLightProbesUpdate::setSkySphericalHarmonics(const GLFloatBufferTexture<GLTexture::Float::RGB32F, SphericalHarmonics> &SH) {
@@ -43,15 +53,15 @@ namespace EARenderer {
     }
 
     void GLSLGridLightProbesUpdate::setSkyColorSphericalHarmonics(const SphericalHarmonics &skyColorSH) {
-        glUniform3fv(uniformByNameCRC32(ctcrc32("uSkyColorSphericalHarmonics.L00")).location(), 1, (GLfloat *) &skyColorSH.L00());
-        glUniform3fv(uniformByNameCRC32(ctcrc32("uSkyColorSphericalHarmonics.L11")).location(), 1, (GLfloat *) &skyColorSH.L11());
-        glUniform3fv(uniformByNameCRC32(ctcrc32("uSkyColorSphericalHarmonics.L10")).location(), 1, (GLfloat *) &skyColorSH.L10());
-        glUniform3fv(uniformByNameCRC32(ctcrc32("uSkyColorSphericalHarmonics.L1_1")).location(), 1, (GLfloat *) &skyColorSH.L1_1());
-        glUniform3fv(uniformByNameCRC32(ctcrc32("uSkyColorSphericalHarmonics.L21")).location(), 1, (GLfloat *) &skyColorSH.L21());
-        glUniform3fv(uniformByNameCRC32(ctcrc32("uSkyColorSphericalHarmonics.L2_1")).location(), 1, (GLfloat *) &skyColorSH.L2_1());
-        glUniform3fv(uniformByNameCRC32(ctcrc32("uSkyColorSphericalHarmonics.L2_2")).location(), 1, (GLfloat *) &skyColorSH.L2_2());
-        glUniform3fv(uniformByNameCRC32(ctcrc32("uSkyColorSphericalHarmonics.L20")).location(), 1, (GLfloat *) &skyColorSH.L20());
-        glUniform3fv(uniformByNameCRC32(ctcrc32("uSkyColorSphericalHarmonics.L22")).location(), 1, (GLfloat *) &skyColorSH.L22());
+        setUniform3fv(ctcrc32("uSkyColorSphericalHarmonics.L00"), 1, (GLfloat *) &skyColorSH.L00());
+        setUniform3fv(ctcrc32("uSkyColorSphericalHarmonics.L11"), 1, (GLfloat *) &skyColorSH.L11());
+        setUniform3fv(ctcrc32("uSkyColorSphericalHarmonics.L10"), 1, (GLfloat *) &skyColorSH.L10());
+        setUniform3fv(ctcrc32("uSkyColorSphericalHarmonics.L1_1"), 1, (GLfloat *) &skyColorSH.L1_1());
+        setUniform3fv(ctcrc32("uSkyColorSphericalHarmonics.L21"), 1, (GLfloat *) &skyColorSH.L21());
+        setUniform3fv(ctcrc32("uSkyColorSphericalHarmonics.L2_1"), 1, (GLfloat *) &skyColorSH.L2_1());
+        setUniform3fv(ctcrc32("uSkyColorSphericalHarmonics.L2_2"), 1, (GLfloat *) &skyColorSH.L2_2());
+        setUniform3fv(ctcrc32("uSkyColorSphericalHarmonics.L20"), 1, (GLfloat *) &skyColorSH.L20());
+        setUniform3fv(ctcrc32("uSkyColorSphericalHarmonics.L22"), 1, (GLfloat *) &skyColorSH.L22());
     }
 
 }
@@ -13,6 +13,7 @@
 #include "GLTextureBuffer.hpp"
 #include "GLTexture2D.hpp"
 #include "SphericalHarmonics.hpp"
+#include "QuantizedSphericalHarmonics.hpp"
 
 namespace EARenderer {
 
@@ -22,9 +23,13 @@ namespace EARenderer {
 
         void setProbesGridResolution(const glm::ivec3 &resolution);
 
+        void setLayerOffset(int32_t offset);
+
         void setSurfelClustersLuminaceMap(const GLFloatTexture2D<GLTexture::Float::R16F> &luminanceMap);
 
-        void setProjectionClusterSphericalHarmonics(const GLFloatBufferTexture<GLTexture::Float::RGB32F, SphericalHarmonics> &SH);
+        void setProjectionClusterSphericalHarmonics(const GLIntegerBufferTexture<GLTexture::Integer::RGB32UI, SphericalHarmonics> &SH);
+
+        void setProjectionClusterSphericalHarmonics(const GLIntegerBufferTexture<GLTexture::Integer::RGBA32UI, QuantizedSphericalHarmonics> &SH);
 
         void setSkySphericalHarmonics(const GLFloatBufferTexture<GLTexture::Float::RGB32F, SphericalHarmonics> &SH);
 
@@ -15,31 +15,31 @@ namespace EARenderer {
     GLSLLightProbeEnvironmentCapture::GLSLLightProbeEnvironmentCapture()
             :
             EARenderer::GLProgram("LightProbeEnvironmentCapture.vert", "CookTorrance.frag", "LightProbeEnvironmentCapture.geom") {
-//        glUniform1i(uniformByNameCRC32(ctcrc32("uShouldEvaluateSphericalHarmonics")).location(), GL_FALSE);
+//        setUniform1i(ctcrc32("uShouldEvaluateSphericalHarmonics"), GL_FALSE);
     }
 
 #pragma mark - Setters
 
     void GLSLLightProbeEnvironmentCapture::setModelMatrix(const glm::mat4 &modelMatrix) {
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uModelMat")).location(), 1, GL_FALSE, glm::value_ptr(modelMatrix));
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uNormalMat")).location(), 1, GL_FALSE, glm::value_ptr(glm::transpose(glm::inverse(modelMatrix))));
+        setUniformMatrix4fv(ctcrc32("uModelMat"), 1, GL_FALSE, glm::value_ptr(modelMatrix));
+        setUniformMatrix4fv(ctcrc32("uNormalMat"), 1, GL_FALSE, glm::value_ptr(glm::transpose(glm::inverse(modelMatrix))));
     }
 
 //    void GLSLLightProbeEnvironmentCapture::setLightProbe(const LightProbe& probe) {
-//        glUniform3fv(uniformByNameCRC32(ctcrc32("uCameraPosition")).location(), 1, glm::value_ptr(probe.position));
-//        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uViewProjectionMatrices[0]")).location(), 6, GL_FALSE, reinterpret_cast<const GLfloat *>(probe.viewProjectionMatrices().data()));
+//        setUniform3fv(ctcrc32("uCameraPosition"), 1, glm::value_ptr(probe.position));
+//        setUniformMatrix4fv(ctcrc32("uViewProjectionMatrices[0]"), 6, GL_FALSE, reinterpret_cast<const GLfloat *>(probe.viewProjectionMatrices().data()));
 //    }
 
     void GLSLLightProbeEnvironmentCapture::setLight(const PointLight &light) {
-        glUniform3fv(uniformByNameCRC32(ctcrc32("uPointLight.position")).location(), 1, glm::value_ptr(light.position()));
-        glUniform3fv(uniformByNameCRC32(ctcrc32("uPointLight.radiantFlux")).location(), 1, reinterpret_cast<const GLfloat *>(&light.color()));
-        glUniform1i(uniformByNameCRC32(ctcrc32("uLightType")).location(), 1);
+        setUniform3fv(ctcrc32("uPointLight.position"), 1, glm::value_ptr(light.position()));
+        setUniform3fv(ctcrc32("uPointLight.radiantFlux"), 1, reinterpret_cast<const GLfloat *>(&light.color()));
+        setUniform1i(ctcrc32("uLightType"), 1);
     }
 
     void GLSLLightProbeEnvironmentCapture::setLight(const DirectionalLight &light) {
-        glUniform3fv(uniformByNameCRC32(ctcrc32("uDirectionalLight.direction")).location(), 1, glm::value_ptr(light.direction()));
-        glUniform3fv(uniformByNameCRC32(ctcrc32("uDirectionalLight.radiantFlux")).location(), 1, reinterpret_cast<const GLfloat *>(&light.color()));
-        glUniform1i(uniformByNameCRC32(ctcrc32("uLightType")).location(), 0);
+        setUniform3fv(ctcrc32("uDirectionalLight.direction"), 1, glm::value_ptr(light.direction()));
+        setUniform3fv(ctcrc32("uDirectionalLight.radiantFlux"), 1, reinterpret_cast<const GLfloat *>(&light.color()));
+        setUniform1i(ctcrc32("uLightType"), 0);
     }
 
     void GLSLLightProbeEnvironmentCapture::setMaterial(const CookTorranceMaterial &material) {
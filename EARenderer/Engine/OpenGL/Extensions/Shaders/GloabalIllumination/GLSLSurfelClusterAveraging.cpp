@@ -18,7 +18,7 @@ namespace EARenderer {
 
 #pragma mark - Setters
 
-    void GLSLSurfelClusterAveraging::setSurfelClustersGBuffer(const GLIntegerTexture2D<GLTexture::Integer::R32UI> &gBuffer) {
+    void GLSLSurfelClusterAveraging::setSurfelClustersGBuffer(const GLIntegerTexture2D<GLTexture::Integer::RG32UI> &gBuffer) {
         setUniformTexture(ctcrc32("uSurfelClustersGBuffer"), gBuffer);
     }
 
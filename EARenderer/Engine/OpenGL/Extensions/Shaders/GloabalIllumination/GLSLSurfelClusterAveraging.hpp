@@ -18,7 +18,7 @@ namespace EARenderer {
     public:
         GLSLSurfelClusterAveraging();
 
-        void setSurfelClustersGBuffer(const GLIntegerTexture2D<GLTexture::Integer::R32UI> &gBuffer);
+        void setSurfelClustersGBuffer(const GLIntegerTexture2D<GLTexture::Integer::RG32UI> &gBuffer);
 
         void setSurfelsLuminaceMap(const GLFloatTexture2D<GLTexture::Float::R16F> &map);
     };
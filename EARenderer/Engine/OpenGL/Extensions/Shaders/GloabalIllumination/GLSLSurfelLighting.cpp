@@ -20,17 +20,15 @@ namespace EARenderer {
 #pragma mark - Setters
 
     void GLSLSurfelLighting::setShadowCascades(const FrustumCascades &cascades) {
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uLightSpaceMatrices[0]")).location(),
-                static_cast<GLsizei>(cascades.lightViewProjections.size()), GL_FALSE,
+        setUniformMatrix4fv(ctcrc32("uLightSpaceMatrices[0]"), static_cast<GLsizei>(cascades.lightViewProjections.size()), GL_FALSE,
                 reinterpret_cast<const GLfloat *>(cascades.lightViewProjections.data()));
 
-        glUniform1i(uniformByNameCRC32(ctcrc32("uDepthSplitsAxis")).location(), static_cast<GLint>(cascades.splitAxis));
+        setUniform1i(ctcrc32("uDepthSplitsAxis"), static_cast<GLint>(cascades.splitAxis));
 
-        glUniform1fv(uniformByNameCRC32(ctcrc32("uDepthSplits[0]")).location(),
-                static_cast<GLsizei>(cascades.splits.size()),
+        setUniform1fv(ctcrc32("uDepthSplits[0]"), static_cast<GLsizei>(cascades.splits.size()),
                 reinterpret_cast<const GLfloat *>(cascades.splits.data()));
 
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uCSMSplitSpaceMat")).location(), 1, GL_FALSE, glm::value_ptr(cascades.splitSpaceMatrix));
+        setUniformMatrix4fv(ctcrc32("uCSMSplitSpaceMat"), 1, GL_FALSE, glm::value_ptr(cascades.splitSpaceMatrix));
     }
 
     void GLSLSurfelLighting::setDirectionalShadowMapArray(const GLDepthTexture2DArray &array) {
@@ -38,15 +36,15 @@ namespace EARenderer {
     }
 
     void GLSLSurfelLighting::setLightType(LightType type) {
-        glUniform1i(uniformByNameCRC32(ctcrc32("uLightType")).location(), std::underlying_type<LightType>::type(type));
+        setUniform1i(ctcrc32("uLightType"), std::underlying_type<LightType>::type(type));
     }
 
     void GLSLSurfelLighting::setLight(const DirectionalLight &light) {
-        glUniform3fv(uniformByNameCRC32(ctcrc32("uDirectionalLight.direction")).location(), 1, glm::value_ptr(light.direction()));
-        glUniform3fv(uniformByNameCRC32(ctcrc32("uDirectionalLight.radiantFlux")).location(), 1, reinterpret_cast<const GLfloat *>(&light.color()));
-        glUniform1f(uniformByNameCRC32(ctcrc32("uDirectionalLight.area")).location(), light.area());
-        glUniform1f(uniformByNameCRC32(ctcrc32("uDirectionalLight.shadowBias")).location(), light.shadowBias());
-        glUniform1i(uniformByNameCRC32(ctcrc32("uLightType")).location(), 0);
+        setUniform3fv(ctcrc32("uDirectionalLight.direction"), 1, glm::value_ptr(light.direction()));
+        setUniform3fv(ctcrc32("uDirectionalLight.radiantFlux"), 1, reinterpret_cast<const GLfloat *>(&light.color()));
+        setUniform1f(ctcrc32("uDirectionalLight.area"), light.area());
+        setUniform1f(ctcrc32("uDirectionalLight.shadowBias"), light.shadowBias());
+        setUniform1i(ctcrc32("uLightType"), 0);
     }
 
     void GLSLSurfelLighting::setSurfelsGBuffer(const GLFloatTexture2DArray<GLTexture::Float::RGB32F> &gBuffer) {
@@ -61,19 +59,23 @@ namespace EARenderer {
     }
 
     void GLSLSurfelLighting::setWorldBoundingBox(const AxisAlignedBox3D &box) {
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uWorldBoudningBoxTransform")).location(), 1, GL_FALSE, glm::value_ptr(box.localSpaceMatrix()));
+        setUniformMatrix4fv(ctcrc32("uWorldBoudningBoxTransform"), 1, GL_FALSE, glm::value_ptr(box.localSpaceMatrix()));
     }
 
-    void GLSLSurfelLighting::setProbePositions(const GLFloatBufferTexture<GLTexture::Float::RGB32F, glm::vec3> &positions) {
+    void GLSLSurfelLighting::setProbePositions(const GLFloatBufferTexture<GLTexture::Float::RGBA32F, glm::vec4> &positions) {
         setBufferTexture(ctcrc32("uProbePositions"), positions);
     }
 
+    void GLSLSurfelLighting::setProbeBrickLookup(const GLLDRTexture3D &lookup) {
+        setUniformTexture(ctcrc32("uProbeBrickLookup"), lookup);
+    }
+
     void GLSLSurfelLighting::setOmnidirectionalShadowMap(const GLDepthTextureCubemap &shadowMap) {
         setUniformTexture(ctcrc32("uOmnidirectionalShadowMap"), shadowMap);
     }
 
     void GLSLSurfelLighting::setSettings(const RenderingSettings &settings) {
-        glUniform1i(uniformByNameCRC32(ctcrc32("uEnableMultibounce")).location(), settings.meshSettings.lightMultibounceEnabled);
+        setUniform1i(ctcrc32("uEnableMultibounce"), settings.meshSettings.lightMultibounceEnabled);
     }
 
 }
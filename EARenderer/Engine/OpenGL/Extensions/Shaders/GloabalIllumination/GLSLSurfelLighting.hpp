@@ -35,7 +35,9 @@ namespace EARenderer {
 
         void setWorldBoundingBox(const AxisAlignedBox3D &box);
 
-        void setProbePositions(const GLFloatBufferTexture<GLTexture::Float::RGB32F, glm::vec3> &positions);
+        void setProbePositions(const GLFloatBufferTexture<GLTexture::Float::RGBA32F, glm::vec4> &positions);
+
+        void setProbeBrickLookup(const GLLDRTexture3D &lookup);
 
         void setShadowCascades(const FrustumCascades &cascades);
 
@@ -21,7 +21,8 @@ in float vLayer;
 
 uniform ivec3 uProbesGridResolution;
 
-uniform samplerBuffer uProjectionClusterSphericalHarmonics;
+uniform usamplerBuffer uProjectionClusterSphericalHarmonics;
+uniform bool uQuantizedProjections;
 uniform samplerBuffer uSkySphericalHarmonics;
 uniform usamplerBuffer uProjectionClusterIndices;
 uniform usamplerBuffer uProbeProjectionsMetadata;
@@ -68,6 +69,72 @@ SH UnpackSH(samplerBuffer buffer, int index) {
     return sh;
 }
 
+//
+// Unpacks lossless spherical harmonics stored as raw float bits
+// (9 RGB texels per projection)
+//
+SH UnpackSH(usamplerBuffer buffer, int index) {
+    SH sh;
+
+    index *= 9;
+
+    sh.L00  = uintBitsToFloat(texelFetch(buffer, index + 0).rgb);
+    sh.L11  = uintBitsToFloat(texelFetch(buffer, index + 1).rgb);
+    sh.L10  = uintBitsToFloat(texelFetch(buffer, index + 2).rgb);
+    sh.L1_1 = uintBitsToFloat(texelFetch(buffer, index + 3).rgb);
+    sh.L21  = uintBitsToFloat(texelFetch(buffer, index + 4).rgb);
+    sh.L2_1 = uintBitsToFloat(texelFetch(buffer, index + 5).rgb);
+    sh.L2_2 = uintBitsToFloat(texelFetch(buffer, index + 6).rgb);
+    sh.L20  = uintBitsToFloat(texelFetch(buffer, index + 7).rgb);
+    sh.L22  = uintBitsToFloat(texelFetch(buffer, index + 8).rgb);
+
+    return sh;
+}
+
+//
+// Unpacks quantized YCoCg spherical harmonics (3 RGBA texels per projection).
+// Layout matches QuantizedSphericalHarmonics:
+// [lumaScale, chromaScale, Y(L00, L11), Y(L10, L1_1)]
+// [Y(L21, L2_1), Y(L2_2, L20), Y(L22, 0), Co(L00, L11, L10, L1_1)]
+// [Co(L21, L2_1, L2_2, L20), Co(L22) Cg(L00, L11, L10), Cg(L1_1, L21, L2_1, L2_2), Cg(L20, L22, 0, 0)]
+//
+SH UnpackQuantizedSH(usamplerBuffer buffer, int index) {
+    index *= 3;
+
+    uvec4 texel0 = texelFetch(buffer, index + 0);
+    uvec4 texel1 = texelFetch(buffer, index + 1);
+    uvec4 texel2 = texelFetch(buffer, index + 2);
+
+    float lumaScale = uintBitsToFloat(texel0.x);
+    float chromaScale = uintBitsToFloat(texel0.y);
+
+    vec2 Y0 = UnpackSnorm2x16(texel0.z, lumaScale);
+    vec2 Y1 = UnpackSnorm2x16(texel0.w, lumaScale);
+    vec2 Y2 = UnpackSnorm2x16(texel1.x, lumaScale);
+    vec2 Y3 = UnpackSnorm2x16(texel1.y, lumaScale);
+    vec2 Y4 = UnpackSnorm2x16(texel1.z, lumaScale);
+
+    vec4 C0 = UnpackSnorm4x8(texel1.w, chromaScale);
+    vec4 C1 = UnpackSnorm4x8(texel2.x, chromaScale);
+    vec4 C2 = UnpackSnorm4x8(texel2.y, chromaScale);
+    vec4 C3 = UnpackSnorm4x8(texel2.z, chromaScale);
+    vec4 C4 = UnpackSnorm4x8(texel2.w, chromaScale);
+
+    SH sh;
+    //               Y      Co     Cg
+    sh.L00  = vec3(Y0.x,  C0.x,  C2.y);
+    sh.L11  = vec3(Y0.y,  C0.y,  C2.z);
+    sh.L10  = vec3(Y1.x,  C0.z,  C2.w);
+    sh.L1_1 = vec3(Y1.y,  C0.w,  C3.x);
+    sh.L21  = vec3(Y2.x,  C1.x,  C3.y);
+    sh.L2_1 = vec3(Y2.y,  C1.y,  C3.z);
+    sh.L2_2 = vec3(Y3.x,  C1.z,  C3.w);
+    sh.L20  = vec3(Y3.y,  C1.w,  C4.x);
+    sh.L22  = vec3(Y4.x,  C2.x,  C4.y);
+
+    return sh;
+}
+
 // Packing scheme:
 //                         Y    Y      Y    Y       Y    Y       Y     Y      Y   Co
 // 9 Luma coefficients  [(L00, L11), (L10, L1_1), (L21, L2_1), (L2_2, L20), (L22, L00),
@@ -142,7 +209,9 @@ void main() {
 
         float surfelClusterLuminance = texelFetch(uSurfelClustersLuminanceMap, luminanceUV, 0).r;
 
-        SH surfelClusterPrecomputedSH = UnpackSH(uProjectionClusterSphericalHarmonics, int(i));
+        SH surfelClusterPrecomputedSH = uQuantizedProjections ?
+                                        UnpackQuantizedSH(uProjectionClusterSphericalHarmonics, int(i)) :
+                                        UnpackSH(uProjectionClusterSphericalHarmonics, int(i));
         SH luminanceSH = ScaleSH(surfelClusterPrecomputedSH, vec3(surfelClusterLuminance));
 
         resultingSH = Sum2SH(resultingSH, luminanceSH);
@@ -34,12 +34,18 @@ void main() {
     int luminanceMapWidth = luminanceMapSize.x;
     int luminanceMapHeight = luminanceMapSize.y;
 
-    uint clusterMetadata = texture(uSurfelClustersGBuffer, vTexCoords).r;
+    uvec2 clusterMetadata = texture(uSurfelClustersGBuffer, vTexCoords).rg;
 
-    uint surfelOffset = UnpackSurfelOffset(clusterMetadata);
-    uint surfelCount = UnpackSurfelCount(clusterMetadata);
+    uint surfelOffset = UnpackSurfelOffset(clusterMetadata.r);
+    uint surfelCount = UnpackSurfelCount(clusterMetadata.r);
+    uint surfelRange = clusterMetadata.g;
 
-    for (uint i = surfelOffset; i < surfelOffset + surfelCount; ++i) {
+    // Leaf clusters cover no more than 255 surfels and visit each of them,
+    // parent clusters of the hierarchy evenly sample their whole surfel range
+    float stride = float(surfelRange) / float(surfelCount);
+
+    for (uint s = 0u; s < surfelCount; ++s) {
+        uint i = surfelOffset + uint(float(s) * stride);
         ivec2 uv = ivec2(i % luminanceMapWidth,
                          i / luminanceMapWidth);
 
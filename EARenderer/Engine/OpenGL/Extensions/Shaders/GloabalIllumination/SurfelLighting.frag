@@ -50,6 +50,7 @@ uniform usampler3D uGridSHMap0;
 uniform usampler3D uGridSHMap1;
 uniform usampler3D uGridSHMap2;
 uniform usampler3D uGridSHMap3;
+uniform usampler3D uProbeBrickLookup;
 
 uniform samplerBuffer uProbePositions;
 uniform mat4 uWorldBoudningBoxTransform;
@@ -97,6 +98,7 @@ void main() {
                                                            uGridSHMap1,
                                                            uGridSHMap2,
                                                            uGridSHMap3,
+                                                           uProbeBrickLookup,
                                                            uProbePositions,
                                                            N,
                                                            worldPosition,
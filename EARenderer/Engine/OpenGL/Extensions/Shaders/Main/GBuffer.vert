@@ -1,18 +1,29 @@
 #version 400 core
 
 #include "CameraUBO.glsl"
+#include "Packing.glsl"
 
 // Constants
 const int kMaxCascades = 4;
 
 // Attributes
 
+#ifdef QUANTIZED_VERTICES
+// Position within the sub mesh bounding box, restored by uModelMat. w holds the bitangent sign mapped to [0, 1]
+layout (location = 0) in vec4 iPosition;
+layout (location = 1) in vec2 iTexCoords;
+layout (location = 2) in vec2 iLightmapCoords;
+// Octahedral-encoded directions
+layout (location = 3) in vec2 iNormal;
+layout (location = 4) in vec2 iTangent;
+#else
 layout (location = 0) in vec4 iPosition;
 layout (location = 1) in vec3 iTexCoords;
 layout (location = 2) in vec2 iLightmapCoords;
 layout (location = 3) in vec3 iNormal;
 layout (location = 4) in vec3 iTangent;
 layout (location = 5) in vec3 iBitangent;
+#endif
 
 // Uniforms
 
@@ -34,17 +45,41 @@ out vec3 vCameraPosInTangentSpace;
 
 // Functions
 
+vec3 ObjectSpaceNormal() {
+#ifdef QUANTIZED_VERTICES
+    return OctahedralDecode(iNormal);
+#else
+    return iNormal;
+#endif
+}
+
+vec3 ObjectSpaceTangent() {
+#ifdef QUANTIZED_VERTICES
+    return OctahedralDecode(iTangent);
+#else
+    return iTangent;
+#endif
+}
+
+vec3 ObjectSpaceBitangent() {
+#ifdef QUANTIZED_VERTICES
+    return (iPosition.w * 2.0 - 1.0) * cross(ObjectSpaceNormal(), ObjectSpaceTangent());
+#else
+    return iBitangent;
+#endif
+}
+
 // Build TBN matrix as-is
 mat3 TBN() {
-    vec3 T = normalize(uNormalMat * vec4(iTangent, 0.0)).xyz;
-    vec3 B = normalize(uNormalMat * vec4(iBitangent, 0.0)).xyz;
-    vec3 N = normalize(uNormalMat * vec4(iNormal, 0.0)).xyz;
+    vec3 T = normalize(uNormalMat * vec4(ObjectSpaceTangent(), 0.0)).xyz;
+    vec3 B = normalize(uNormalMat * vec4(ObjectSpaceBitangent(), 0.0)).xyz;
+    vec3 N = normalize(uNormalMat * vec4(ObjectSpaceNormal(), 0.0)).xyz;
     return mat3(T, B, N);
 }
 
 mat3 OrthogonalTBN() {
-    vec3 T = normalize(uNormalMat * vec4(iTangent, 0.0)).xyz;
-    vec3 N = normalize(uNormalMat * vec4(iNormal, 0.0)).xyz;
+    vec3 T = normalize(uNormalMat * vec4(ObjectSpaceTangent(), 0.0)).xyz;
+    vec3 N = normalize(uNormalMat * vec4(ObjectSpaceNormal(), 0.0)).xyz;
     // re-orthogonalize T with respect to N
     T = normalize(T - dot(T, N) * N);
     vec3 B = cross(N, T);
@@ -52,11 +87,15 @@ mat3 OrthogonalTBN() {
 }
 
 void main() {
-    vec4 worldPosition = uModelMat * iPosition;
+    vec4 worldPosition = uModelMat * vec4(iPosition.xyz, 1.0);
 
     mat3 TBN = TBN();
 
+#ifdef QUANTIZED_VERTICES
+    vTexCoords = vec3(iTexCoords.st, 0.0);
+#else
     vTexCoords = vec3(iTexCoords.s, iTexCoords.t, iTexCoords.r);
+#endif
     vWorldPosition = worldPosition.xyz;
     vTBN = TBN;
     vPosInCSMSplitSpace = uCSMSplitSpaceMat * worldPosition;
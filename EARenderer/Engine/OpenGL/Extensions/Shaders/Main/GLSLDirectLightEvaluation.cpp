@@ -22,23 +22,23 @@ namespace EARenderer {
 #pragma mark - Setters
 
     void GLSLDirectLightEvaluation::setCamera(const Camera &camera) {
-        glUniform3fv(uniformByNameCRC32(ctcrc32("uCameraPosition")).location(), 1, glm::value_ptr(camera.position()));
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uCameraViewInverse")).location(), 1, GL_FALSE,
+        setUniform3fv(ctcrc32("uCameraPosition"), 1, glm::value_ptr(camera.position()));
+        setUniformMatrix4fv(ctcrc32("uCameraViewInverse"), 1, GL_FALSE,
                 glm::value_ptr(camera.inverseViewMatrix()));
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uCameraProjectionInverse")).location(), 1, GL_FALSE,
+        setUniformMatrix4fv(ctcrc32("uCameraProjectionInverse"), 1, GL_FALSE,
                 glm::value_ptr(camera.inverseProjectionMatrix()));
     }
 
     void GLSLDirectLightEvaluation::setLightType(LightType type) {
-        glUniform1i(uniformByNameCRC32(ctcrc32("uLightType")).location(), std::underlying_type<LightType>::type(type));
+        setUniform1i(ctcrc32("uLightType"), std::underlying_type<LightType>::type(type));
     }
 
     void GLSLDirectLightEvaluation::setLight(const DirectionalLight &light) {
-        glUniform3fv(uniformByNameCRC32(ctcrc32("uDirectionalLight.direction")).location(), 1, glm::value_ptr(light.direction()));
-        glUniform3fv(uniformByNameCRC32(ctcrc32("uDirectionalLight.radiantFlux")).location(), 1, reinterpret_cast<const GLfloat *>(&light.color()));
-        glUniform1f(uniformByNameCRC32(ctcrc32("uDirectionalLight.area")).location(), light.area());
-        glUniform1f(uniformByNameCRC32(ctcrc32("uDirectionalLight.shadowBias")).location(), light.shadowBias());
-        glUniform1i(uniformByNameCRC32(ctcrc32("uLightType")).location(), 0);
+        setUniform3fv(ctcrc32("uDirectionalLight.direction"), 1, glm::value_ptr(light.direction()));
+        setUniform3fv(ctcrc32("uDirectionalLight.radiantFlux"), 1, reinterpret_cast<const GLfloat *>(&light.color()));
+        setUniform1f(ctcrc32("uDirectionalLight.area"), light.area());
+        setUniform1f(ctcrc32("uDirectionalLight.shadowBias"), light.shadowBias());
+        setUniform1i(ctcrc32("uLightType"), 0);
     }
 
     void GLSLDirectLightEvaluation::setGBuffer(const SceneGBuffer &GBuffer) {
@@ -47,17 +47,15 @@ namespace EARenderer {
     }
 
     void GLSLDirectLightEvaluation::setFrustumCascades(const FrustumCascades &cascades) {
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uLightSpaceMatrices[0]")).location(),
-                static_cast<GLsizei>(cascades.lightViewProjections.size()), GL_FALSE,
+        setUniformMatrix4fv(ctcrc32("uLightSpaceMatrices[0]"), static_cast<GLsizei>(cascades.lightViewProjections.size()), GL_FALSE,
                 reinterpret_cast<const GLfloat *>(cascades.lightViewProjections.data()));
 
-        glUniform1i(uniformByNameCRC32(ctcrc32("uDepthSplitsAxis")).location(), static_cast<GLint>(cascades.splitAxis));
+        setUniform1i(ctcrc32("uDepthSplitsAxis"), static_cast<GLint>(cascades.splitAxis));
 
-        glUniform1fv(uniformByNameCRC32(ctcrc32("uDepthSplits[0]")).location(),
-                static_cast<GLsizei>(cascades.splits.size()),
+        setUniform1fv(ctcrc32("uDepthSplits[0]"), static_cast<GLsizei>(cascades.splits.size()),
                 reinterpret_cast<const GLfloat *>(cascades.splits.data()));
 
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uCSMSplitSpaceMat")).location(), 1, GL_FALSE, glm::value_ptr(cascades.splitSpaceMatrix));
+        setUniformMatrix4fv(ctcrc32("uCSMSplitSpaceMat"), 1, GL_FALSE, glm::value_ptr(cascades.splitSpaceMatrix));
     }
 
     void GLSLDirectLightEvaluation::setDirectionalShadowMapArray(const GLDepthTexture2DArray &array) {
@@ -73,8 +71,8 @@ namespace EARenderer {
     }
 
     void GLSLDirectLightEvaluation::setSettings(const RenderingSettings &settings) {
-        glUniform1ui(uniformByNameCRC32(ctcrc32("uSettingsBitmask")).location(), settings.meshSettings.booleanBitmask());
-        //        glUniform1f(uniformByNameCRC32(ctcrc32("uParallaxMappingStrength")).location(), settings.meshSettings.parallaxMappingStrength);
+        setUniform1ui(ctcrc32("uSettingsBitmask"), settings.meshSettings.booleanBitmask());
+        //        setUniform1f(ctcrc32("uParallaxMappingStrength"), settings.meshSettings.parallaxMappingStrength);
     }
 
 }
@@ -12,21 +12,31 @@ namespace EARenderer {
 
 #pragma mark - Lifecycle
 
-    GLSLGBuffer::GLSLGBuffer()
-            : GLProgram("GBuffer.vert", "GBuffer.frag", "") {
+    GLSLGBuffer::GLSLGBuffer(MeshVertexLayout::Format vertexFormat)
+            : GLProgram("GBuffer.vert", "GBuffer.frag", "", MeshVertexLayout::ShaderDefines(vertexFormat)),
+              mModelMatrixUniform(uniformHandle(ctcrc32("uModelMat"))),
+              mNormalMatrixUniform(uniformHandle(ctcrc32("uNormalMat"))),
+              mMaterialTypeUniform(uniformHandle(ctcrc32("uMaterialType"))) {
     }
 
 #pragma mark - Setters
 
     void GLSLGBuffer::setCamera(const Camera &camera) {
-        glUniform3fv(uniformByNameCRC32(ctcrc32("uCameraPosition")).location(), 1, glm::value_ptr(camera.position()));
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uCameraViewMat")).location(), 1, GL_FALSE, glm::value_ptr(camera.viewMatrix()));
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uCameraProjectionMat")).location(), 1, GL_FALSE, glm::value_ptr(camera.projectionMatrix()));
+        setUniform3fv(ctcrc32("uCameraPosition"), 1, glm::value_ptr(camera.position()));
+        setUniformMatrix4fv(ctcrc32("uCameraViewMat"), 1, GL_FALSE, glm::value_ptr(camera.viewMatrix()));
+        setUniformMatrix4fv(ctcrc32("uCameraProjectionMat"), 1, GL_FALSE, glm::value_ptr(camera.projectionMatrix()));
     }
 
     void GLSLGBuffer::setModelMatrix(const glm::mat4 &matrix) {
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uModelMat")).location(), 1, GL_FALSE, glm::value_ptr(matrix));
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uNormalMat")).location(), 1, GL_FALSE, glm::value_ptr(glm::transpose(glm::inverse(matrix))));
+        mModelMatrix = matrix;
+        setUniformMatrix4fv(mModelMatrixUniform, 1, GL_FALSE, glm::value_ptr(mModelMatrix * mPositionDequantization));
+        // Normals are not quantized relative to the bounding box, hence the original model matrix
+        setUniformMatrix4fv(mNormalMatrixUniform, 1, GL_FALSE, glm::value_ptr(glm::transpose(glm::inverse(matrix))));
+    }
+
+    void GLSLGBuffer::setPositionDequantization(const glm::mat4 &matrix) {
+        mPositionDequantization = matrix;
+        setUniformMatrix4fv(mModelMatrixUniform, 1, GL_FALSE, glm::value_ptr(mModelMatrix * mPositionDequantization));
     }
 
     void GLSLGBuffer::setMaterial(const CookTorranceMaterial &material) {
@@ -37,16 +47,16 @@ namespace EARenderer {
         if (material.ambientOcclusionMap()) {setUniformTexture(ctcrc32("uMaterialCookTorrance.AOMap"), *material.ambientOcclusionMap());}
         if (material.displacementMap()) {setUniformTexture(ctcrc32("uMaterialCookTorrance.displacementMap"), *material.displacementMap());}
 
-        glUniform1i(uniformByNameCRC32(ctcrc32("uMaterialType")).location(), std::underlying_type<MaterialType>::type(MaterialType::CookTorrance));
+        setUniform1i(mMaterialTypeUniform, std::underlying_type<MaterialType>::type(MaterialType::CookTorrance));
     }
 
     void GLSLGBuffer::setMaterial(const EmissiveMaterial &material) {
-        glUniform3fv(uniformByNameCRC32(ctcrc32("uMaterialEmissive.emission")).location(), 1, glm::value_ptr(material.emissionColor.rgb()));
-        glUniform1i(uniformByNameCRC32(ctcrc32("uMaterialType")).location(), std::underlying_type<MaterialType>::type(MaterialType::Emissive));
+        setUniform3fv(ctcrc32("uMaterialEmissive.emission"), 1, glm::value_ptr(material.emissionColor.rgb()));
+        setUniform1i(mMaterialTypeUniform, std::underlying_type<MaterialType>::type(MaterialType::Emissive));
     }
 
     void GLSLGBuffer::setSettings(const RenderingSettings &settings) {
-        glUniform1f(uniformByNameCRC32(ctcrc32("uPOMStrength")).location(), settings.meshSettings.parallaxMappingStrength);
+        setUniform1f(ctcrc32("uPOMStrength"), settings.meshSettings.parallaxMappingStrength);
     }
 
 }
@@ -14,19 +14,37 @@
 #include "EmissiveMaterial.hpp"
 #include "Camera.hpp"
 #include "RenderingSettings.hpp"
+#include "MeshVertexLayout.hpp"
 
 namespace EARenderer {
 
     class GLSLGBuffer : public GLProgram {
+    private:
+        // Uniforms set for every draw
+        UniformHandle mModelMatrixUniform;
+        UniformHandle mNormalMatrixUniform;
+        UniformHandle mMaterialTypeUniform;
+
+        glm::mat4 mModelMatrix = glm::mat4(1.0);
+        glm::mat4 mPositionDequantization = glm::mat4(1.0);
+
     public:
         using GLProgram::GLProgram;
 
-        GLSLGBuffer();
+        /**
+         @param vertexFormat format of the vertex buffer meshes are drawn from
+         */
+        GLSLGBuffer(MeshVertexLayout::Format vertexFormat = MeshVertexLayout::Format::Float);
 
         void setCamera(const Camera &camera);
 
         void setModelMatrix(const glm::mat4 &matrix);
 
+        /**
+         @param matrix matrix restoring quantized positions of the sub mesh being drawn, applied before the model matrix
+         */
+        void setPositionDequantization(const glm::mat4 &matrix);
+
         void setMaterial(const CookTorranceMaterial &material);
 
         void setMaterial(const EmissiveMaterial &material);
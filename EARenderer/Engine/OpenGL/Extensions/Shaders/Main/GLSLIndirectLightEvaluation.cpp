@@ -18,10 +18,10 @@ namespace EARenderer {
 #pragma mark - Setters
 
     void GLSLIndirectLightEvaluation::setCamera(const Camera &camera) {
-        glUniform3fv(uniformByNameCRC32(ctcrc32("uCameraPosition")).location(), 1, glm::value_ptr(camera.position()));
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uCameraViewInverse")).location(), 1, GL_FALSE,
+        setUniform3fv(ctcrc32("uCameraPosition"), 1, glm::value_ptr(camera.position()));
+        setUniformMatrix4fv(ctcrc32("uCameraViewInverse"), 1, GL_FALSE,
                 glm::value_ptr(camera.inverseViewMatrix()));
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uCameraProjectionInverse")).location(), 1, GL_FALSE,
+        setUniformMatrix4fv(ctcrc32("uCameraProjectionInverse"), 1, GL_FALSE,
                 glm::value_ptr(camera.inverseProjectionMatrix()));
     }
 
@@ -38,15 +38,42 @@ namespace EARenderer {
     }
 
     void GLSLIndirectLightEvaluation::setWorldBoundingBox(const AxisAlignedBox3D &box) {
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uWorldBoudningBoxTransform")).location(), 1, GL_FALSE, glm::value_ptr(box.localSpaceMatrix()));
+        setUniformMatrix4fv(ctcrc32("uWorldBoudningBoxTransform"), 1, GL_FALSE, glm::value_ptr(box.localSpaceMatrix()));
     }
 
-    void GLSLIndirectLightEvaluation::setProbePositions(const GLFloatBufferTexture<GLTexture::Float::RGB32F, glm::vec3> &positions) {
+    void GLSLIndirectLightEvaluation::setProbePositions(const GLFloatBufferTexture<GLTexture::Float::RGBA32F, glm::vec4> &positions) {
         setBufferTexture(ctcrc32("uProbePositions"), positions);
     }
 
+    void GLSLIndirectLightEvaluation::setProbeBrickLookup(const GLLDRTexture3D &lookup) {
+        setUniformTexture(ctcrc32("uProbeBrickLookup"), lookup);
+    }
+
     void GLSLIndirectLightEvaluation::setSettings(const RenderingSettings &settings) {
-        glUniform1ui(uniformByNameCRC32(ctcrc32("uSettingsBitmask")).location(), settings.meshSettings.booleanBitmask());
+        setUniform1ui(ctcrc32("uSettingsBitmask"), settings.meshSettings.booleanBitmask());
+    }
+
+    void GLSLIndirectLightEvaluation::setBlendedVolumes(const std::vector<LightBakingVolume> &volumes, size_t currentVolumeIndex) {
+        size_t count = std::min(volumes.size(), MaximumBlendedVolumeCount);
+
+        std::array<glm::vec3, MaximumBlendedVolumeCount> minimums;
+        std::array<glm::vec3, MaximumBlendedVolumeCount> maximums;
+        std::array<float, MaximumBlendedVolumeCount> blendDistances;
+
+        for (size_t i = 0; i < count; i++) {
+            minimums[i] = volumes[i].bounds.min;
+            maximums[i] = volumes[i].bounds.max;
+            blendDistances[i] = volumes[i].blendDistance;
+        }
+
+        if (count > 0) {
+            setUniform3fv(ctcrc32("uBlendedVolumeMin[0]"), GLsizei(count), glm::value_ptr(minimums[0]));
+            setUniform3fv(ctcrc32("uBlendedVolumeMax[0]"), GLsizei(count), glm::value_ptr(maximums[0]));
+            setUniform1fv(ctcrc32("uBlendedVolumeBlendDistance[0]"), GLsizei(count), blendDistances.data());
+        }
+
+        setUniform1i(ctcrc32("uBlendedVolumeCount"), GLint(count));
+        setUniform1i(ctcrc32("uBlendedVolumeIndex"), GLint(currentVolumeIndex));
     }
 
 }
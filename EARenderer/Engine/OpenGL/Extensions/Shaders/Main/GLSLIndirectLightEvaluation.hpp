@@ -16,6 +16,9 @@
 #include "RenderingSettings.hpp"
 #include "GLTexture2D.hpp"
 #include "ImageBasedLightProbe.hpp"
+#include "LightBakingVolume.hpp"
+
+#include <vector>
 
 namespace EARenderer {
 
@@ -31,9 +34,20 @@ namespace EARenderer {
 
         void setWorldBoundingBox(const AxisAlignedBox3D &box);
 
-        void setProbePositions(const GLFloatBufferTexture<GLTexture::Float::RGB32F, glm::vec3> &positions);
+        void setProbePositions(const GLFloatBufferTexture<GLTexture::Float::RGBA32F, glm::vec4> &positions);
+
+        void setProbeBrickLookup(const GLLDRTexture3D &lookup);
 
         void setSettings(const RenderingSettings& settings);
+
+        /**
+         @param volumes volumes whose indirect light is accumulated this frame, MaximumBlendedVolumeCount at most
+         @param currentVolumeIndex index of the volume being evaluated by the current draw
+         */
+        void setBlendedVolumes(const std::vector<LightBakingVolume> &volumes, size_t currentVolumeIndex);
+
+        // Must match MAX_BLENDED_VOLUMES in IndirectLightEvaluation.frag
+        static constexpr size_t MaximumBlendedVolumeCount = 8;
     };
 
 }
@@ -2,6 +2,9 @@
 
 //#define PROBE_SH_COMPRESSION_322
 
+// Must match GLSLIndirectLightEvaluation::MaximumBlendedVolumeCount
+#define MAX_BLENDED_VOLUMES 8
+
 #include "GBuffer.glsl"
 #include "ColorSpace.glsl"
 #include "DiffuseLightProbes.glsl"
@@ -34,12 +37,21 @@ uniform usampler3D uGridSHMap0;
 uniform usampler3D uGridSHMap1;
 uniform usampler3D uGridSHMap2;
 uniform usampler3D uGridSHMap3;
+uniform usampler3D uProbeBrickLookup;
 
 uniform samplerBuffer uProbePositions;
 
 uniform IBLProbe uIBLProbe;
 uniform bool uUseIBL;
 
+// Light baking volumes rendered this frame
+
+uniform vec3 uBlendedVolumeMin[MAX_BLENDED_VOLUMES];
+uniform vec3 uBlendedVolumeMax[MAX_BLENDED_VOLUMES];
+uniform float uBlendedVolumeBlendDistance[MAX_BLENDED_VOLUMES];
+uniform int uBlendedVolumeCount;
+uniform int uBlendedVolumeIndex;
+
 // Functions
 
 // Shrink tex coords by the size of 1 texel, which will result in a (0; 0; 0)
@@ -51,6 +63,42 @@ vec3 AlignWithTexelCenters(vec3 texCoords) {
     return texCoords * reductionFactor + halfTexel;
 }
 
+// Distance-based weight of a volume: 1.0 deeper than the blend distance inside the volume, fading to 0.0 at its boundary
+float VolumeBlendWeight(int volumeIndex, vec3 worldPosition) {
+    vec3 distancesToFaces = min(worldPosition - uBlendedVolumeMin[volumeIndex], uBlendedVolumeMax[volumeIndex] - worldPosition);
+    float distanceToBoundary = min(min(distancesToFaces.x, distancesToFaces.y), distancesToFaces.z);
+    return clamp(distanceToBoundary / max(uBlendedVolumeBlendDistance[volumeIndex], 1e-5), 0.0, 1.0);
+}
+
+float DistanceToVolume(int volumeIndex, vec3 worldPosition) {
+    vec3 outside = max(max(uBlendedVolumeMin[volumeIndex] - worldPosition, worldPosition - uBlendedVolumeMax[volumeIndex]), vec3(0.0));
+    return length(outside);
+}
+
+// Weight of the current volume normalized against all the volumes, so that the overlapping ones cross-fade.
+// Points outside of every volume are lit by the closest one.
+float CurrentVolumeWeight(vec3 worldPosition) {
+    float totalWeight = 0.0;
+    int closestVolume = 0;
+    float closestDistance = 1e30;
+
+    for (int i = 0; i < uBlendedVolumeCount; i++) {
+        totalWeight += VolumeBlendWeight(i, worldPosition);
+
+        float distance = DistanceToVolume(i, worldPosition);
+        if (distance < closestDistance) {
+            closestDistance = distance;
+            closestVolume = i;
+        }
+    }
+
+    if (totalWeight <= 0.0) {
+        return closestVolume == uBlendedVolumeIndex ? 1.0 : 0.0;
+    }
+
+    return VolumeBlendWeight(uBlendedVolumeIndex, worldPosition) / totalWeight;
+}
+
 // Settings
 bool areMaterialsEnabled()          { return bool((uSettingsBitmask >> 4u) & 1u); }
 bool isGlobalIlluminationEnabled()  { return bool((uSettingsBitmask >> 3u) & 1u); }
@@ -68,6 +116,12 @@ void main() {
 
     vec3 worldPosition  = ReconstructWorldPosition(uGBufferHiZBuffer, vTexCoords, uCameraViewInverse, uCameraProjectionInverse);
 
+    float volumeWeight = CurrentVolumeWeight(worldPosition);
+    if (volumeWeight <= 0.0) {
+        oOutputColor = vec4(0.0);
+        return;
+    }
+
     float ao            = gBuffer.AO;
     float metalness     = gBuffer.metalness;
     vec3 albedo         = gBuffer.albedo;
@@ -86,7 +140,7 @@ void main() {
 
     vec3 indirectRadiance;
 
-    indirectRadiance = EvaluateDiffuseLightProbes(uGridSHMap0, uGridSHMap1, uGridSHMap2, uGridSHMap3,
+    indirectRadiance = EvaluateDiffuseLightProbes(uGridSHMap0, uGridSHMap1, uGridSHMap2, uGridSHMap3, uProbeBrickLookup,
                                                   uProbePositions, N, worldPosition, uWorldBoudningBoxTransform);
 
     indirectRadiance = RGB_From_YCoCg(indirectRadiance);
@@ -94,7 +148,7 @@ void main() {
     indirectRadiance = max(indirectRadiance, vec3(0.0));
 
     indirectRadiance *= isGlobalIlluminationEnabled() ? 1.0 : 0.0;
-    vec3 fragmentColor = indirectRadiance * Kd * albedo * ao;
+    vec3 fragmentColor = indirectRadiance * Kd * albedo * ao * volumeWeight;
 
     oOutputColor = vec4(fragmentColor / HDRNormalizationFactor, 1.0);
 }
@@ -31,22 +31,22 @@ namespace EARenderer {
                 dir = glm::vec2(0.0, 1.0);
                 break;
         }
-        glUniform2fv(uniformByNameCRC32(ctcrc32("uBlurDirection")).location(), 1, glm::value_ptr(dir));
+        setUniform2fv(ctcrc32("uBlurDirection"), 1, glm::value_ptr(dir));
     }
 
     void GLSLGaussianBlur::setKernelWeights(const std::vector<float> &weights) {
-        glUniform1fv(uniformByNameCRC32(ctcrc32("uKernelWeights[0]")).location(), (GLint) weights.size(), reinterpret_cast<const GLfloat *>(weights.data()));
-        glUniform1i(uniformByNameCRC32(ctcrc32("uKernelSize")).location(), (GLint) weights.size());
+        setUniform1fv(ctcrc32("uKernelWeights[0]"), (GLint) weights.size(), reinterpret_cast<const GLfloat *>(weights.data()));
+        setUniform1i(ctcrc32("uKernelSize"), (GLint) weights.size());
     }
 
     void GLSLGaussianBlur::setTextureOffsets(const std::vector<float> &offsets) {
-        glUniform1fv(uniformByNameCRC32(ctcrc32("uTextureOffsets[0]")).location(), (GLint) offsets.size(), reinterpret_cast<const GLfloat *>(offsets.data()));
-        glUniform1i(uniformByNameCRC32(ctcrc32("uKernelSize")).location(), (GLint) offsets.size());
+        setUniform1fv(ctcrc32("uTextureOffsets[0]"), (GLint) offsets.size(), reinterpret_cast<const GLfloat *>(offsets.data()));
+        setUniform1i(ctcrc32("uKernelSize"), (GLint) offsets.size());
     }
 
     void GLSLGaussianBlur::setRenderTargetSize(const Size2D &RTSize) {
         glm::vec2 size(RTSize.width, RTSize.height);
-        glUniform2fv(uniformByNameCRC32(ctcrc32("uRenderTargetSize")).location(), 1, glm::value_ptr(size));
+        setUniform2fv(ctcrc32("uRenderTargetSize"), 1, glm::value_ptr(size));
     }
 
 }
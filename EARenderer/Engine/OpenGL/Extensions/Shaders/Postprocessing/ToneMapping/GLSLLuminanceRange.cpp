@@ -24,7 +24,7 @@ namespace EARenderer {
     }
 
     void GLSLLuminanceRange::setMipLevel(int8_t mipLevel) {
-        glUniform1i(uniformByNameCRC32(ctcrc32("uLOD")).location(), mipLevel);
+        setUniform1i(ctcrc32("uLOD"), mipLevel);
     }
 
 }
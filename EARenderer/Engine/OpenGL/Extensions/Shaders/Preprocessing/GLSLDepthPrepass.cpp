@@ -14,17 +14,18 @@ namespace EARenderer {
 
     GLSLDepthPrepass::GLSLDepthPrepass()
             :
-            GLProgram("DepthPrepass.vert", "DepthPrepass.frag", "") {
+            GLProgram("DepthPrepass.vert", "DepthPrepass.frag", ""),
+            mModelMatrixUniform(uniformHandle(ctcrc32("uModelMat"))) {
     }
 
 #pragma mark - Setters
 
     void GLSLDepthPrepass::setCamera(const Camera &camera) {
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uCameraSpaceMat")).location(), 1, GL_FALSE, glm::value_ptr(camera.viewProjectionMatrix()));
+        setUniformMatrix4fv(ctcrc32("uCameraSpaceMat"), 1, GL_FALSE, glm::value_ptr(camera.viewProjectionMatrix()));
     }
 
     void GLSLDepthPrepass::setModelMatrix(const glm::mat4 &matrix) {
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uModelMat")).location(), 1, GL_FALSE, glm::value_ptr(matrix));
+        setUniformMatrix4fv(mModelMatrixUniform, 1, GL_FALSE, glm::value_ptr(matrix));
     }
 
 }
@@ -17,6 +17,9 @@
 namespace EARenderer {
 
     class GLSLDepthPrepass : public GLProgram {
+    private:
+        UniformHandle mModelMatrixUniform;
+
     public:
         using GLProgram::GLProgram;
 
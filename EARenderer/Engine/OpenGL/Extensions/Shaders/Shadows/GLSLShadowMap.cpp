@@ -16,18 +16,18 @@ namespace EARenderer {
 
     GLSLShadowMap::GLSLShadowMap()
             :
-            GLProgram("ShadowMap.vert", "ShadowMap.frag", "ShadowMap.geom") {
+            GLProgram("ShadowMap.vert", "ShadowMap.frag", "ShadowMap.geom"),
+            mModelMatrixUniform(uniformHandle(ctcrc32("uModelMatrix"))) {
     }
 
 #pragma mark - Setters
 
     void GLSLShadowMap::setModelMatrix(const glm::mat4 &modelMatrix) {
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uModelMatrix")).location(), 1, GL_FALSE, glm::value_ptr(modelMatrix));
+        setUniformMatrix4fv(mModelMatrixUniform, 1, GL_FALSE, glm::value_ptr(modelMatrix));
     }
 
     void GLSLShadowMap::setViewProjectionMatrices(const std::vector<glm::mat4> &matrices) {
-        glUniformMatrix4fv(uniformByNameCRC32(ctcrc32("uLightSpaceMatrices[0]")).location(),
-                (GLsizei) matrices.size(),
+        setUniformMatrix4fv(ctcrc32("uLightSpaceMatrices[0]"), (GLsizei) matrices.size(),
                 GL_FALSE,
                 (GLfloat *) matrices.data());
     }
@@ -19,6 +19,9 @@
 namespace EARenderer {
 
     class GLSLShadowMap : public GLProgram {
+    private:
+        UniformHandle mModelMatrixUniform;
+
     public:
         GLSLShadowMap();
 
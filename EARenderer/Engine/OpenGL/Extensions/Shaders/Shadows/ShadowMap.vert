@@ -16,5 +16,6 @@ out InterfaceBlock {
 
 void main() {
     vs_out.instanceID = gl_InstanceID;
-    gl_Position = iPosition;
+    // w holds the bitangent sign when vertices are quantized
+    gl_Position = vec4(iPosition.xyz, 1.0);
 }
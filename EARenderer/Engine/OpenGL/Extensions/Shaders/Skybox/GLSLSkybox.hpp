@@ -31,7 +31,7 @@ namespace EARenderer {
         template<class TextureFormat, TextureFormat Format>
         void setCubemap(const GLTextureCubemap<TextureFormat, Format> &cubemap) {
             setUniformTexture(ctcrc32("uCubeMapTexture"), cubemap);
-            glUniform1i(uniformByNameCRC32(ctcrc32("uIsCube")).location(), GL_TRUE);
+            setUniform1i(ctcrc32("uIsCube"), GL_TRUE);
         }
     };
 
@@ -0,0 +1,230 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "BakeCheckpoint.hpp"
+#include "StringUtils.hpp"
+#include "Profiler.hpp"
+
+#include <bitsery/bitsery.h>
+#include <bitsery/traits/vector.h>
+#include <bitsery/adapter/stream.h>
+
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+namespace EARenderer {
+
+    namespace {
+
+        // Bumped whenever the layout of checkpoint files changes
+        constexpr uint32_t FormatVersion = 1;
+
+        struct Manifest {
+            uint32_t version = FormatVersion;
+            uint64_t inputHash = 0;
+            bool hasSurfels = false;
+        };
+
+        template<typename S>
+        void serialize(S &s, Manifest &manifest) {
+            s.value4b(manifest.version);
+            s.value8b(manifest.inputHash);
+            s.value1b(manifest.hasSurfels);
+        }
+
+    }
+
+#pragma mark - Lifecycle
+
+    BakeCheckpoint::BakeCheckpoint(const std::string &pathPrefix, uint64_t inputHash)
+            :
+            BakeCheckpoint(pathPrefix, inputHash, Settings()) {
+    }
+
+    BakeCheckpoint::BakeCheckpoint(const std::string &pathPrefix, uint64_t inputHash, const Settings &settings)
+            :
+            mPathPrefix(pathPrefix),
+            mInputHash(inputHash),
+            mSettings(settings),
+            mLastProbeSaveTime(std::chrono::steady_clock::now()) {
+        EA_PROFILE_SCOPE("Load bake checkpoint");
+
+        std::ifstream manifestStream(manifestPath(), std::ios::binary);
+        if (!manifestStream.is_open()) {
+            return;
+        }
+
+        Manifest manifest;
+        bitsery::Deserializer<bitsery::InputStreamAdapter> manifestDeserializer(manifestStream);
+        manifestDeserializer.object(manifest);
+
+        if (!bitsery::AdapterAccess::getReader(manifestDeserializer).isCompletedSuccessfully() ||
+            manifest.version != FormatVersion || manifest.inputHash != mInputHash) {
+            // Saved for different inputs, nothing to resume
+            clear();
+            return;
+        }
+
+        mHasSurfels = manifest.hasSurfels;
+
+        std::ifstream probesStream(probesPath(), std::ios::binary);
+        if (!mHasSurfels || !probesStream.is_open()) {
+            return;
+        }
+
+        uint32_t savedVersion = 0;
+        uint64_t savedInputHash = 0;
+        ProbeProgress progress;
+
+        bitsery::Deserializer<bitsery::InputStreamAdapter> deserializer(probesStream);
+        deserializer.value4b(savedVersion);
+        deserializer.value8b(savedInputHash);
+        deserializer.value4b(progress.projectionEncoding);
+        deserializer.value4b(progress.layout);
+        deserializer.container(progress.probes, std::numeric_limits<uint32_t>::max());
+        deserializer.container(progress.projections, std::numeric_limits<uint32_t>::max());
+        deserializer.container(progress.quantizedProjections, std::numeric_limits<uint32_t>::max());
+
+        if (bitsery::AdapterAccess::getReader(deserializer).isCompletedSuccessfully() &&
+            savedVersion == FormatVersion && savedInputHash == mInputHash) {
+            mProbeProgress = std::move(progress);
+        }
+    }
+
+#pragma mark - Private helpers
+
+    std::string BakeCheckpoint::manifestPath() const {
+        return mPathPrefix + "_manifest";
+    }
+
+    std::string BakeCheckpoint::surfelsPath() const {
+        return mPathPrefix + "_surfels";
+    }
+
+    std::string BakeCheckpoint::probesPath() const {
+        return mPathPrefix + "_probes";
+    }
+
+    void BakeCheckpoint::saveManifest() const {
+        Manifest manifest;
+        manifest.inputHash = mInputHash;
+        manifest.hasSurfels = mHasSurfels;
+
+        ReplaceFile(manifestPath(), [&](const std::string &path) {
+            std::ofstream stream(path, std::ios::trunc | std::ios::binary);
+            if (!stream.is_open()) {
+                throw std::runtime_error(string_format("Unable to save bake checkpoint: %s", path.c_str()));
+            }
+
+            bitsery::Serializer<bitsery::OutputBufferedStreamAdapter> serializer(stream);
+            serializer.object(manifest);
+            bitsery::AdapterAccess::getWriter(serializer).flush();
+        });
+    }
+
+    void BakeCheckpoint::saveProbeProgress(const DiffuseLightProbeData &probeData) const {
+        EA_PROFILE_SCOPE("Save probe bake checkpoint");
+
+        ReplaceFile(probesPath(), [&](const std::string &path) {
+            std::ofstream stream(path, std::ios::trunc | std::ios::binary);
+            if (!stream.is_open()) {
+                throw std::runtime_error(string_format("Unable to save bake checkpoint: %s", path.c_str()));
+            }
+
+            // Projections of the probe data belong to baked probes only, since probes are baked one after another
+            auto &projections = probeData.surfelClusterProjections();
+            auto &quantizedProjections = probeData.quantizedSurfelClusterProjections();
+
+            bitsery::Serializer<bitsery::OutputBufferedStreamAdapter> serializer(stream);
+            serializer.value4b(FormatVersion);
+            serializer.value8b(mInputHash);
+            serializer.value4b(mProbeProgress.projectionEncoding);
+            serializer.value4b(mProbeProgress.layout);
+            serializer.container(mProbeProgress.probes, mProbeProgress.probes.size());
+            serializer.container(projections, projections.size());
+            serializer.container(quantizedProjections, quantizedProjections.size());
+            bitsery::AdapterAccess::getWriter(serializer).flush();
+        });
+    }
+
+#pragma mark - Files
+
+    void BakeCheckpoint::ReplaceFile(const std::string &path, const std::function<void(const std::string &)> &write) {
+        std::string temporaryPath = path + ".tmp";
+
+        try {
+            write(temporaryPath);
+        } catch (...) {
+            std::remove(temporaryPath.c_str());
+            throw;
+        }
+
+        if (std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+            std::remove(temporaryPath.c_str());
+            throw std::runtime_error(string_format("Unable to replace file: %s", path.c_str()));
+        }
+    }
+
+#pragma mark - Surfels
+
+    bool BakeCheckpoint::loadSurfels(SurfelData &surfelData) const {
+        return mHasSurfels && surfelData.deserialize(surfelsPath());
+    }
+
+    void BakeCheckpoint::saveSurfels(SurfelData &surfelData) {
+        EA_PROFILE_SCOPE("Save surfel bake checkpoint");
+
+        // Probes saved so far may reference clusters of previous surfels
+        std::remove(probesPath().c_str());
+        mProbeProgress = ProbeProgress();
+
+        ReplaceFile(surfelsPath(), [&](const std::string &path) {
+            surfelData.serialize(path);
+        });
+
+        mHasSurfels = true;
+        saveManifest();
+    }
+
+#pragma mark - Probes
+
+    const BakeCheckpoint::ProbeProgress &BakeCheckpoint::beginProbes(DiffuseLightProbeData::ProjectionEncoding encoding, DiffuseLightProbeData::Layout layout) {
+        if (mProbeProgress.projectionEncoding != encoding || mProbeProgress.layout != layout) {
+            mProbeProgress = ProbeProgress();
+            mProbeProgress.projectionEncoding = encoding;
+            mProbeProgress.layout = layout;
+        }
+
+        mLastProbeSaveTime = std::chrono::steady_clock::now();
+        return mProbeProgress;
+    }
+
+    void BakeCheckpoint::probeBaked(const DiffuseLightProbe &probe, const DiffuseLightProbeData &probeData) {
+        mProbeProgress.probes.push_back(probe);
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - mLastProbeSaveTime < mSettings.probeSaveInterval) {
+            return;
+        }
+
+        saveProbeProgress(probeData);
+        mLastProbeSaveTime = now;
+
+        if (mSettings.probeProgressSaved) {
+            mSettings.probeProgressSaved(mProbeProgress.probes.size());
+        }
+    }
+
+    void BakeCheckpoint::clear() {
+        std::remove(manifestPath().c_str());
+        std::remove(surfelsPath().c_str());
+        std::remove(probesPath().c_str());
+        mHasSurfels = false;
+        mProbeProgress = ProbeProgress();
+    }
+
+}
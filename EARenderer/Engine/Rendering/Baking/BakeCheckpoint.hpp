@@ -0,0 +1,116 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_BAKECHECKPOINT_HPP
+#define EARENDERER_BAKECHECKPOINT_HPP
+
+#include "SurfelData.hpp"
+#include "DiffuseLightProbeData.hpp"
+
+#include <chrono>
+#include <functional>
+#include <string>
+
+namespace EARenderer {
+
+    /**
+     Keeps progress of a bake on disk, so that an interrupted bake resumes where it stopped.
+
+     Surfels, which include the cluster hierarchy, are saved once generated. Probes are saved in the order they were baked,
+     together with the surfel cluster projections referenced by them, whenever the save interval elapses.
+     Every file is written to a temporary path and renamed over the previous one, so an interruption never leaves
+     a truncated checkpoint behind. Files carry a hash of the bake's inputs and are discarded once the inputs change.
+     */
+    class BakeCheckpoint {
+    public:
+        struct Settings {
+            // Minimum time between two saves of probe progress
+            std::chrono::duration<double> probeSaveInterval = std::chrono::seconds(30);
+            // Called after every save of probe progress with the amount of saved probes, exceptions abort the bake
+            std::function<void(size_t)> probeProgressSaved;
+        };
+
+        struct ProbeProgress {
+            DiffuseLightProbeData::ProjectionEncoding projectionEncoding = DiffuseLightProbeData::ProjectionEncoding::Lossless;
+            DiffuseLightProbeData::Layout layout = DiffuseLightProbeData::Layout::UniformGrid;
+            // Probes in the order they were baked
+            DiffuseLightProbeData::ProbeVector probes;
+            DiffuseLightProbeData::ProjectionVector projections;
+            DiffuseLightProbeData::QuantizedProjectionVector quantizedProjections;
+        };
+
+    private:
+        std::string mPathPrefix;
+        uint64_t mInputHash;
+        Settings mSettings;
+        bool mHasSurfels = false;
+        ProbeProgress mProbeProgress;
+        std::chrono::steady_clock::time_point mLastProbeSaveTime;
+
+        std::string manifestPath() const;
+
+        std::string surfelsPath() const;
+
+        std::string probesPath() const;
+
+        void saveManifest() const;
+
+        void saveProbeProgress(const DiffuseLightProbeData &probeData) const;
+
+    public:
+        /**
+         Loads progress saved under the path prefix, unless it was saved for different inputs
+
+         @param pathPrefix prefix of checkpoint files' paths
+         @param inputHash hash of everything the bake depends on
+         */
+        BakeCheckpoint(const std::string &pathPrefix, uint64_t inputHash);
+
+        BakeCheckpoint(const std::string &pathPrefix, uint64_t inputHash, const Settings &settings);
+
+        /**
+         Writes a file to a temporary path and renames it over the destination, so the destination either keeps
+         its previous contents or receives complete new ones
+
+         @param path destination file path
+         @param write function writing the file to the path it's given
+         */
+        static void ReplaceFile(const std::string &path, const std::function<void(const std::string &)> &write);
+
+        /**
+         @param surfelData receives saved surfels
+         @return true if surfels were saved for the same inputs and loaded successfully
+         */
+        bool loadSurfels(SurfelData &surfelData) const;
+
+        /**
+         Saves generated surfels and discards probe progress, since projections reference clusters of other surfels
+         */
+        void saveSurfels(SurfelData &surfelData);
+
+        /**
+         Starts the probe stage. Progress saved with another projection encoding or layout is discarded.
+
+         @return progress to resume from, empty if probes are baked from scratch
+         */
+        const ProbeProgress &beginProbes(DiffuseLightProbeData::ProjectionEncoding encoding, DiffuseLightProbeData::Layout layout);
+
+        /**
+         Records a newly baked probe and saves progress once the save interval has elapsed
+
+         @param probe baked probe, referencing projections already added to the probe data
+         @param probeData data the probe's projections were added to
+         */
+        void probeBaked(const DiffuseLightProbe &probe, const DiffuseLightProbeData &probeData);
+
+        /**
+         Removes checkpoint files, called once results of the bake are stored
+         */
+        void clear();
+    };
+
+}
+
+#endif //EARENDERER_BAKECHECKPOINT_HPP
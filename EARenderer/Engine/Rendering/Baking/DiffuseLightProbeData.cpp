@@ -9,75 +9,138 @@
 #include "DiffuseLightProbeData.hpp"
 #include "StringUtils.hpp"
 #include "Serializers.hpp"
+#include "Profiler.hpp"
 
 #include <bitsery/bitsery.h>
 #include <bitsery/traits/vector.h>
 #include <bitsery/adapter/stream.h>
 #include <fstream>
+#include <algorithm>
+#include <stdexcept>
 
 namespace EARenderer {
 
+#pragma mark - Brick lookup
+
+    uint32_t DiffuseLightProbeData::PackBrickLookupValue(const glm::uvec3 &value) {
+        if (glm::any(glm::greaterThan(value, glm::uvec3(1023)))) {
+            throw std::invalid_argument("Brick lookup values must fit in 10 bits");
+        }
+        return value.x | (value.y << 10) | (value.z << 20);
+    }
+
+    glm::uvec4 DiffuseLightProbeData::BrickLookupEntry(const glm::uvec3 &atlasOrigin, const glm::uvec3 &cellOrigin, const glm::uvec3 &cellExtent, const glm::uvec3 &brickResolution) {
+        // Interpolation only needs the amount of intervals between probes
+        return glm::uvec4(PackBrickLookupValue(atlasOrigin),
+                PackBrickLookupValue(cellOrigin),
+                PackBrickLookupValue(cellExtent),
+                PackBrickLookupValue(brickResolution - glm::uvec3(1)));
+    }
+
 #pragma mark - Data
 
     void DiffuseLightProbeData::initializeBuffers() {
+        MemoryTracker::Scope memoryScope(MemoryTag::DiffuseLightProbes);
+
         // Transfer spherical harmonics coefficients to the GPU via buffer texture
         std::vector<SphericalHarmonics> shs;
         for (auto &projection : mSurfelClusterProjections) {
             shs.push_back(projection.sphericalHarmonics);
         }
 
+        std::vector<QuantizedSphericalHarmonics> quantizedSHs;
+        for (auto &projection : mQuantizedSurfelClusterProjections) {
+            quantizedSHs.push_back(projection.sphericalHarmonics);
+        }
+
         // Transfer surfel cluster indices to the GPU via buffer texture
         std::vector<uint32_t> indices;
-        for (auto &projection : mSurfelClusterProjections) {
-            indices.push_back(static_cast<uint32_t>(projection.surfelClusterIndex));
+        for (size_t i = 0; i < surfelClusterProjectionCount(); i++) {
+            indices.push_back(surfelClusterIndex(i));
         }
 
         // Transfer surfel cluster projection group offsets, sizes and probe positions to the GPU via buffer texture
         std::vector<SphericalHarmonics> skySHs;
         std::vector<uint32_t> metadata;
-        std::vector<glm::vec3> positions;
+        std::vector<glm::vec4> positions;
 
         for (auto &probe : mProbes) {
             metadata.push_back((uint32_t) probe.surfelClusterProjectionGroupOffset);
             metadata.push_back((uint32_t) probe.surfelClusterProjectionGroupSize);
-            positions.push_back(probe.position);
+            positions.emplace_back(probe.position, probe.isValid ? 1.0 : 0.0);
             skySHs.push_back(probe.skySphericalHarmonics);
         }
 
-        mProjectionClusterSHsBufferTexture = std::make_shared<GLFloatBufferTexture<GLTexture::Float::RGB32F, SphericalHarmonics>>(shs.data(), shs.size());
+        mProjectionClusterSHsBufferTexture = nullptr;
+        mQuantizedProjectionClusterSHsBufferTexture = nullptr;
+
+        switch (mProjectionEncoding) {
+            case ProjectionEncoding::Lossless:
+                mProjectionClusterSHsBufferTexture = std::make_shared<GLIntegerBufferTexture<GLTexture::Integer::RGB32UI, SphericalHarmonics>>(shs.data(), shs.size());
+                break;
+            case ProjectionEncoding::Quantized:
+                mQuantizedProjectionClusterSHsBufferTexture = std::make_shared<GLIntegerBufferTexture<GLTexture::Integer::RGBA32UI, QuantizedSphericalHarmonics>>(quantizedSHs.data(), quantizedSHs.size());
+                break;
+        }
+
         mSkySHsBufferTexture = std::make_shared<GLFloatBufferTexture<GLTexture::Float::RGB32F, SphericalHarmonics>>(skySHs.data(), skySHs.size());
         mProjectionClusterIndicesBufferTexture = std::make_shared<GLIntegerBufferTexture<GLTexture::Integer::R32UI, uint32_t>>(indices.data(), indices.size());
         mProbeClusterProjectionsMetadataBufferTexture = std::make_shared<GLIntegerBufferTexture<GLTexture::Integer::R32UI, uint32_t>>(metadata.data(), metadata.size());
-        mProbePositionsBufferTexture = std::make_shared<GLFloatBufferTexture<GLTexture::Float::RGB32F, glm::vec3>>(positions.data(), positions.size());
+        mProbePositionsBufferTexture = std::make_shared<GLFloatBufferTexture<GLTexture::Float::RGBA32F, glm::vec4>>(positions.data(), positions.size());
+        mBrickLookupTexture = std::make_shared<GLLDRTexture3D>(Size2D(mBrickLookupResolution.x, mBrickLookupResolution.y), mBrickLookupResolution.z, mBrickLookup.data());
+    }
+
+    void DiffuseLightProbeData::setProjectionEncoding(ProjectionEncoding encoding) {
+        if (encoding == mProjectionEncoding) {
+            return;
+        }
+
+        switch (encoding) {
+            case ProjectionEncoding::Quantized:
+                for (auto &projection : mSurfelClusterProjections) {
+                    mQuantizedSurfelClusterProjections.push_back({projection.surfelClusterIndex, QuantizedSphericalHarmonics(projection.sphericalHarmonics)});
+                }
+                mSurfelClusterProjections = {};
+                break;
+
+            case ProjectionEncoding::Lossless:
+                for (auto &projection : mQuantizedSurfelClusterProjections) {
+                    mSurfelClusterProjections.push_back({projection.surfelClusterIndex, projection.sphericalHarmonics.dequantized()});
+                }
+                mQuantizedSurfelClusterProjections = {};
+                break;
+        }
+
+        mProjectionEncoding = encoding;
     }
 
     void DiffuseLightProbeData::serialize(const std::string &filePath) {
+        EA_PROFILE_SCOPE("Serialize diffuse light probes");
+
         std::ofstream stream(filePath, std::ios::trunc | std::ios::binary);
         if (!stream.is_open()) {
             throw std::runtime_error(string_format("Unable to serialize light probes: %s", filePath.c_str()));
         }
 
         bitsery::Serializer<bitsery::OutputBufferedStreamAdapter> serializer(stream);
-        serializer.container(mProbes, mProbes.size());
-        serializer.container(mSurfelClusterProjections, mSurfelClusterProjections.size());
-        serializer.object(mGridResolution);
+        serializer.object(*this);
         bitsery::AdapterAccess::getWriter(serializer).flush();
     }
 
-    bool DiffuseLightProbeData::deserialize(const std::string &filePath) {
+    bool DiffuseLightProbeData::deserialize(const std::string &filePath, bool initializesBuffers) {
+        EA_PROFILE_SCOPE("Deserialize diffuse light probes");
+
         std::ifstream stream(filePath);
         if (!stream.is_open()) {
             return false;
         }
 
         bitsery::Deserializer<bitsery::InputStreamAdapter> deserializer(stream);
-        deserializer.container(mProbes, std::numeric_limits<uint32_t>::max());
-        deserializer.container(mSurfelClusterProjections, std::numeric_limits<uint32_t>::max());
-        deserializer.object(mGridResolution);
+        deserializer.object(*this);
 
         auto &reader = bitsery::AdapterAccess::getReader(deserializer);
 
-        if (reader.isCompletedSuccessfully()) {
+        if (reader.isCompletedSuccessfully() && initializesBuffers) {
             initializeBuffers();
         }
 
@@ -86,19 +149,59 @@ namespace EARenderer {
 
 #pragma mark - Getters
 
-    const std::vector<DiffuseLightProbe> &DiffuseLightProbeData::probes() const {
+    const DiffuseLightProbeData::ProbeVector &DiffuseLightProbeData::probes() const {
         return mProbes;
     }
 
-    const std::vector<SurfelClusterProjection> &DiffuseLightProbeData::surfelClusterProjections() const {
+    const DiffuseLightProbeData::ProjectionVector &DiffuseLightProbeData::surfelClusterProjections() const {
         return mSurfelClusterProjections;
     }
 
+    DiffuseLightProbeData::ProjectionEncoding DiffuseLightProbeData::projectionEncoding() const {
+        return mProjectionEncoding;
+    }
+
+    const DiffuseLightProbeData::QuantizedProjectionVector &DiffuseLightProbeData::quantizedSurfelClusterProjections() const {
+        return mQuantizedSurfelClusterProjections;
+    }
+
+    size_t DiffuseLightProbeData::surfelClusterProjectionCount() const {
+        switch (mProjectionEncoding) {
+            case ProjectionEncoding::Lossless:
+                return mSurfelClusterProjections.size();
+            case ProjectionEncoding::Quantized:
+                return mQuantizedSurfelClusterProjections.size();
+        }
+        throw std::logic_error("Unknown projection encoding");
+    }
+
+    uint32_t DiffuseLightProbeData::surfelClusterIndex(size_t projectionIndex) const {
+        switch (mProjectionEncoding) {
+            case ProjectionEncoding::Lossless:
+                return mSurfelClusterProjections[projectionIndex].surfelClusterIndex;
+            case ProjectionEncoding::Quantized:
+                return mQuantizedSurfelClusterProjections[projectionIndex].surfelClusterIndex;
+        }
+        throw std::logic_error("Unknown projection encoding");
+    }
+
+    DiffuseLightProbeData::Layout DiffuseLightProbeData::layout() const {
+        return mLayout;
+    }
+
     const glm::ivec3 &DiffuseLightProbeData::gridResolution() const {
         return mGridResolution;
     }
 
-    std::shared_ptr<GLFloatBufferTexture<GLTexture::Float::RGB32F, SphericalHarmonics>> DiffuseLightProbeData::projectionClusterSHsBufferTexture() const {
+    const glm::ivec3 &DiffuseLightProbeData::brickLookupResolution() const {
+        return mBrickLookupResolution;
+    }
+
+    size_t DiffuseLightProbeData::validProbeCount() const {
+        return std::count_if(mProbes.begin(), mProbes.end(), [](const DiffuseLightProbe &probe) { return probe.isValid; });
+    }
+
+    std::shared_ptr<GLIntegerBufferTexture<GLTexture::Integer::RGB32UI, SphericalHarmonics>> DiffuseLightProbeData::projectionClusterSHsBufferTexture() const {
         return mProjectionClusterSHsBufferTexture;
     }
 
@@ -106,6 +209,10 @@ namespace EARenderer {
         return mSkySHsBufferTexture;
     }
 
+    std::shared_ptr<GLIntegerBufferTexture<GLTexture::Integer::RGBA32UI, QuantizedSphericalHarmonics>> DiffuseLightProbeData::quantizedProjectionClusterSHsBufferTexture() const {
+        return mQuantizedProjectionClusterSHsBufferTexture;
+    }
+
     std::shared_ptr<GLIntegerBufferTexture<GLTexture::Integer::R32UI, uint32_t>> DiffuseLightProbeData::projectionClusterIndicesBufferTexture() const {
         return mProjectionClusterIndicesBufferTexture;
     };
@@ -114,8 +221,12 @@ namespace EARenderer {
         return mProbeClusterProjectionsMetadataBufferTexture;
     }
 
-    std::shared_ptr<GLFloatBufferTexture<GLTexture::Float::RGB32F, glm::vec3>> DiffuseLightProbeData::probePositionsBufferTexture() const {
+    std::shared_ptr<GLFloatBufferTexture<GLTexture::Float::RGBA32F, glm::vec4>> DiffuseLightProbeData::probePositionsBufferTexture() const {
         return mProbePositionsBufferTexture;
     }
 
+    std::shared_ptr<GLLDRTexture3D> DiffuseLightProbeData::brickLookupTexture() const {
+        return mBrickLookupTexture;
+    }
+
 }
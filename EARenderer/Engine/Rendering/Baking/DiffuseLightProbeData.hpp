@@ -14,42 +14,142 @@
 #include "GLBufferTexture.hpp"
 #include "SphericalHarmonics.hpp"
 #include "GLTexture2D.hpp"
+#include "GLLDRTexture3D.hpp"
+#include "TaggedAllocator.hpp"
+#include "Serializers.hpp"
 
 #include <vector>
 #include <memory>
+#include <limits>
+#include <bitsery/bitsery.h>
+#include <bitsery/traits/vector.h>
 
 namespace EARenderer {
 
     class DiffuseLightProbeGenerator;
+    class DiffuseLightProbeShard;
 
     class DiffuseLightProbeData {
+    public:
+        enum class ProjectionEncoding : uint32_t {
+            // Full float spherical harmonics, kept as a reference
+            Lossless,
+            // 16 bit luma and 8 bit chroma coefficients with per-projection scales
+            Quantized
+        };
+
+        enum class Layout : uint32_t {
+            // Probes form a single regular grid spanning the whole baking volume
+            UniformGrid,
+            // Probes are grouped in bricks of varying density, packed into an atlas
+            SparseBricks
+        };
+
+        using ProbeVector = TaggedVector<DiffuseLightProbe, MemoryTag::DiffuseLightProbes>;
+        using ProjectionVector = TaggedVector<SurfelClusterProjection, MemoryTag::DiffuseLightProbes>;
+        using QuantizedProjectionVector = TaggedVector<QuantizedSurfelClusterProjection, MemoryTag::DiffuseLightProbes>;
+
     private:
         friend DiffuseLightProbeGenerator;
+        friend DiffuseLightProbeShard;
+
+        template<typename S>
+        friend void serialize(S &s, DiffuseLightProbeData &data);
 
-        std::vector<DiffuseLightProbe> mProbes;
-        std::vector<SurfelClusterProjection> mSurfelClusterProjections;
+        ProbeVector mProbes;
+        ProjectionVector mSurfelClusterProjections;
+        QuantizedProjectionVector mQuantizedSurfelClusterProjections;
+        ProjectionEncoding mProjectionEncoding = ProjectionEncoding::Lossless;
+        Layout mLayout = Layout::UniformGrid;
+        // Resolution of the 3D textures probes are stored in, probes are ordered the same way
         glm::ivec3 mGridResolution;
+        glm::ivec3 mBrickLookupResolution;
+        TaggedVector<glm::uvec4, MemoryTag::DiffuseLightProbes> mBrickLookup;
 
-        std::shared_ptr<GLFloatBufferTexture<GLTexture::Float::RGB32F, SphericalHarmonics>> mProjectionClusterSHsBufferTexture;
+        std::shared_ptr<GLIntegerBufferTexture<GLTexture::Integer::RGB32UI, SphericalHarmonics>> mProjectionClusterSHsBufferTexture;
+        std::shared_ptr<GLIntegerBufferTexture<GLTexture::Integer::RGBA32UI, QuantizedSphericalHarmonics>> mQuantizedProjectionClusterSHsBufferTexture;
         std::shared_ptr<GLFloatBufferTexture<GLTexture::Float::RGB32F, SphericalHarmonics>> mSkySHsBufferTexture;
         std::shared_ptr<GLIntegerBufferTexture<GLTexture::Integer::R32UI, uint32_t>> mProjectionClusterIndicesBufferTexture;
         std::shared_ptr<GLIntegerBufferTexture<GLTexture::Integer::R32UI, uint32_t>> mProbeClusterProjectionsMetadataBufferTexture;
-        std::shared_ptr<GLFloatBufferTexture<GLTexture::Float::RGB32F, glm::vec3>> mProbePositionsBufferTexture;
+        std::shared_ptr<GLFloatBufferTexture<GLTexture::Float::RGBA32F, glm::vec4>> mProbePositionsBufferTexture;
+        std::shared_ptr<GLLDRTexture3D> mBrickLookupTexture;
+
+        static uint32_t PackBrickLookupValue(const glm::uvec3 &value);
 
     public:
+        /**
+         Builds an entry of the brick lookup texture. Every lookup cell refers to a brick of probes
+         covering a box of cells, all values are packed as 10 bit triplets.
+
+         @param atlasOrigin first texel of the brick in the probe atlas
+         @param cellOrigin first lookup cell covered by the brick
+         @param cellExtent amount of lookup cells covered by the brick
+         @param brickResolution amount of probes along each side of the brick
+         @return packed lookup entry
+         */
+        static glm::uvec4 BrickLookupEntry(const glm::uvec3 &atlasOrigin, const glm::uvec3 &cellOrigin, const glm::uvec3 &cellExtent, const glm::uvec3 &brickResolution);
+
         void initializeBuffers();
 
         void serialize(const std::string &filePath);
 
-        bool deserialize(const std::string &filePath);
+        /**
+         @param filePath path of a file written by serialize()
+         @param initializesBuffers false to leave GPU buffers to a later initializeBuffers() call,
+         which allows reading on threads without a GL context
+         @return true if the file was read successfully
+         */
+        bool deserialize(const std::string &filePath, bool initializesBuffers = true);
+
+        const ProbeVector &probes() const;
+
+        /**
+         Converts surfel cluster projections into the requested encoding, releasing memory of the previous one.
+         Has to be followed by initializeBuffers() to take effect on the GPU.
+
+         @param encoding desired encoding of projection spherical harmonics
+         */
+        void setProjectionEncoding(ProjectionEncoding encoding);
+
+        ProjectionEncoding projectionEncoding() const;
 
-        const std::vector<DiffuseLightProbe> &probes() const;
+        /**
+         @return lossless projections, empty when projections are quantized
+         */
+        const ProjectionVector &surfelClusterProjections() const;
 
-        const std::vector<SurfelClusterProjection> &surfelClusterProjections() const;
+        /**
+         @return quantized projections, empty when projections are lossless
+         */
+        const QuantizedProjectionVector &quantizedSurfelClusterProjections() const;
 
+        size_t surfelClusterProjectionCount() const;
+
+        uint32_t surfelClusterIndex(size_t projectionIndex) const;
+
+        Layout layout() const;
+
+        /**
+         @return resolution of the probe atlas, which is the whole probe grid for the uniform layout
+         */
         const glm::ivec3 &gridResolution() const;
 
-        std::shared_ptr<GLFloatBufferTexture<GLTexture::Float::RGB32F, SphericalHarmonics>> projectionClusterSHsBufferTexture() const;
+        const glm::ivec3 &brickLookupResolution() const;
+
+        /**
+         @return amount of probes participating in the interpolation
+         */
+        size_t validProbeCount() const;
+
+        /**
+         @return buffer of lossless projection SHs, nullptr when projections are quantized
+         */
+        std::shared_ptr<GLIntegerBufferTexture<GLTexture::Integer::RGB32UI, SphericalHarmonics>> projectionClusterSHsBufferTexture() const;
+
+        /**
+         @return buffer of quantized projection SHs, nullptr when projections are lossless
+         */
+        std::shared_ptr<GLIntegerBufferTexture<GLTexture::Integer::RGBA32UI, QuantizedSphericalHarmonics>> quantizedProjectionClusterSHsBufferTexture() const;
 
         std::shared_ptr<GLFloatBufferTexture<GLTexture::Float::RGB32F, SphericalHarmonics>> skySHsBufferTexture() const;
 
@@ -57,9 +157,30 @@ namespace EARenderer {
 
         std::shared_ptr<GLIntegerBufferTexture<GLTexture::Integer::R32UI, uint32_t>> probeClusterProjectionsMetadataBufferTexture() const;
 
-        std::shared_ptr<GLFloatBufferTexture<GLTexture::Float::RGB32F, glm::vec3>> probePositionsBufferTexture() const;
+        /**
+         @return buffer of probe positions, w component is 0 for probes excluded from the interpolation
+         */
+        std::shared_ptr<GLFloatBufferTexture<GLTexture::Float::RGBA32F, glm::vec4>> probePositionsBufferTexture() const;
+
+        /**
+         @return 3D texture mapping normalized baking volume coordinates to bricks of the probe atlas
+         */
+        std::shared_ptr<GLLDRTexture3D> brickLookupTexture() const;
     };
 
+    template<typename S>
+    void serialize(S &s, DiffuseLightProbeData &data) {
+        constexpr size_t maxSize = std::numeric_limits<uint32_t>::max();
+        s.container(data.mProbes, maxSize);
+        s.container(data.mSurfelClusterProjections, maxSize);
+        s.object(data.mGridResolution);
+        s.value4b(data.mProjectionEncoding);
+        s.container(data.mQuantizedSurfelClusterProjections, maxSize);
+        s.value4b(data.mLayout);
+        s.object(data.mBrickLookupResolution);
+        s.container(data.mBrickLookup, maxSize);
+    }
+
 }
 
 #endif /* DiffuseLightProbeData_hpp */
@@ -8,6 +8,15 @@
 
 #include "DiffuseLightProbeGenerator.hpp"
 #include "Measurement.hpp"
+#include "Profiler.hpp"
+#include "MemoryArena.hpp"
+#include "StringUtils.hpp"
+
+#include <limits>
+#include <vector>
+#include <unordered_map>
+#include <cmath>
+#include <stdexcept>
 
 namespace EARenderer {
 
@@ -34,6 +43,17 @@ namespace EARenderer {
         return distanceTerm * visibilityTerm * visibilityTest;
     }
 
+    float DiffuseLightProbeGenerator::clusterBoundsSolidAngle(const SurfelCluster &cluster, const DiffuseLightProbe &probe) {
+        float radius = cluster.bounds.diagonal() / 2.0;
+        float distance = glm::length(cluster.bounds.center() - probe.position);
+
+        if (distance <= radius) {
+            return std::numeric_limits<float>::max();
+        }
+
+        return M_PI * radius * radius / (distance * distance);
+    }
+
     SurfelClusterProjection DiffuseLightProbeGenerator::projectSurfelCluster(const SurfelCluster &cluster, const DiffuseLightProbe &probe, const SurfelData& surfelData, const Scene &scene) {
         SurfelClusterProjection projection;
 
@@ -54,17 +74,92 @@ namespace EARenderer {
         return projection;
     }
 
+    SurfelClusterProjection DiffuseLightProbeGenerator::projectSurfelClusterProxy(const SurfelCluster &cluster, const DiffuseLightProbe &probe, const SurfelData& surfelData, const Scene &scene) {
+        SurfelClusterProjection projection;
+
+        glm::vec3 center = cluster.bounds.center();
+        glm::vec3 Wps = center - probe.position;
+        float distance2 = glm::length2(Wps);
+        Wps = glm::normalize(Wps);
+
+        float distanceTerm = std::min(cluster.area / distance2, 1.f);
+
+        // Average normal is not normalized, so incoherent normals naturally weaken the contribution
+        float visibilityTerm = std::max(glm::dot(-cluster.normal, Wps), 0.f);
+
+        if (visibilityTerm > 0.0) {
+            // Estimate occlusion with a few surfels evenly distributed over the cluster's surfel range
+            size_t sampleCount = std::min<size_t>(mClusterProxyVisibilitySampleCount, cluster.surfelCount);
+            float stride = float(cluster.surfelCount) / sampleCount;
+            size_t visibleCount = 0;
+
+            for (size_t s = 0; s < sampleCount; s++) {
+                const Surfel &surfel = surfelData.surfels()[cluster.surfelOffset + size_t(s * stride)];
+                constexpr float p0Offset = 0.01;
+                constexpr float p1Offset = 0.01;
+                if (!scene.rayTracer()->lineSegmentOccluded(probe.position, surfel.position, p0Offset, p1Offset)) {
+                    visibleCount++;
+                }
+            }
+
+            float solidAngle = distanceTerm * visibilityTerm * float(visibleCount) / sampleCount;
+
+            if (solidAngle > 0.0) {
+                auto ycocg = Color(cluster.albedo.r, cluster.albedo.g, cluster.albedo.b).convertedTo(Color::Space::YCoCg).rgb();
+                projection.sphericalHarmonics.contribute(Wps, ycocg, solidAngle);
+            }
+        }
+
+        projection.sphericalHarmonics.convolve();
+        projection.sphericalHarmonics.scale(glm::vec3(1.0f / (4.0f * M_PI)));
+
+        return projection;
+    }
+
     void DiffuseLightProbeGenerator::projectSurfelClustersOnProbe(DiffuseLightProbe &probe, const SurfelData& surfelData, const Scene &scene) {
-        probe.surfelClusterProjectionGroupOffset = (uint32_t) mProbeData->mSurfelClusterProjections.size();
+        EA_PROFILE_SCOPE("Project surfel clusters on probe");
+
+        probe.surfelClusterProjectionGroupOffset = (uint32_t) mProbeData->surfelClusterProjectionCount();
+
+        // Walk the cluster hierarchy from the roots down, stopping at the coarsest level
+        // that still looks small enough from the probe's standpoint
+        MemoryArena &arena = MemoryArena::ThreadLocal();
+        MemoryArena::Scope arenaScope(arena);
+
+        ArenaVector<uint32_t> clusterIndices(surfelData.rootSurfelClusterIndices().rbegin(), surfelData.rootSurfelClusterIndices().rend(), arena);
+
+        while (!clusterIndices.empty()) {
+            uint32_t i = clusterIndices.back();
+            clusterIndices.pop_back();
 
-        for (size_t i = 0; i < surfelData.surfelClusters().size(); i++) {
             const SurfelCluster &cluster = surfelData.surfelClusters()[i];
-            SurfelClusterProjection projection = projectSurfelCluster(cluster, probe, surfelData, scene);
+            SurfelClusterProjection projection;
+
+            if (cluster.isLeaf()) {
+                projection = projectSurfelCluster(cluster, probe, surfelData, scene);
+            } else if (clusterBoundsSolidAngle(cluster, probe) <= mMaximumClusterProxySolidAngle) {
+                projection = projectSurfelClusterProxy(cluster, probe, surfelData, scene);
+            } else {
+                for (uint32_t child = cluster.childOffset + cluster.childCount; child > cluster.childOffset; child--) {
+                    clusterIndices.push_back(child - 1);
+                }
+                continue;
+            }
 
             // Only accept projections with non-zero SH
             if (projection.sphericalHarmonics.magnitude() > 10e-7) {
                 projection.surfelClusterIndex = (uint32_t) i;
-                mProbeData->mSurfelClusterProjections.push_back(projection);
+
+                // Quantize right away to avoid keeping all the float projections in memory
+                switch (mProbeData->mProjectionEncoding) {
+                    case DiffuseLightProbeData::ProjectionEncoding::Lossless:
+                        mProbeData->mSurfelClusterProjections.push_back(projection);
+                        break;
+                    case DiffuseLightProbeData::ProjectionEncoding::Quantized:
+                        mProbeData->mQuantizedSurfelClusterProjections.push_back({projection.surfelClusterIndex, QuantizedSphericalHarmonics(projection.sphericalHarmonics)});
+                        break;
+                }
+
                 probe.surfelClusterProjectionGroupSize++;
             }
         }
@@ -106,12 +201,95 @@ namespace EARenderer {
         probe.skySphericalHarmonics.convolve();
     }
 
-#pragma mark - Public interface
+    bool DiffuseLightProbeGenerator::isProbeEmbedded(const glm::vec3 &position, const Scene &scene, glm::vec3 &escapeDirection, float &escapeDistance) {
+        size_t backfaceHitCount = 0;
+        escapeDistance = std::numeric_limits<float>::max();
+
+        for (size_t i = 0; i < mEmbeddedProbeTestRayCount; i++) {
+            // Fibonacci lattice distributes directions evenly over the sphere
+            float z = 1.0 - (2.0 * i + 1.0) / mEmbeddedProbeTestRayCount;
+            float radius = std::sqrt(std::max(1.0f - z * z, 0.0f));
+            float phi = i * M_PI * (3.0 - std::sqrt(5.0));
+            glm::vec3 direction(radius * std::cos(phi), radius * std::sin(phi), z);
+
+            Ray3D ray(position, direction);
+            float frontFaceDistance = 0.0;
+            float backFaceDistance = 0.0;
+            bool frontFaceHit = scene.rayTracer()->rayHit(ray, frontFaceDistance, EmbreeRayTracer::FaceFilter::CullBack);
+            bool backFaceHit = scene.rayTracer()->rayHit(ray, backFaceDistance, EmbreeRayTracer::FaceFilter::CullFront);
+
+            if (backFaceHit && (!frontFaceHit || backFaceDistance < frontFaceDistance)) {
+                backfaceHitCount++;
+
+                if (backFaceDistance < escapeDistance) {
+                    escapeDistance = backFaceDistance;
+                    escapeDirection = direction;
+                }
+            }
+        }
 
-    std::unique_ptr<DiffuseLightProbeData> DiffuseLightProbeGenerator::generateProbes(const Scene &scene, const SurfelData& surfelData) {
-        mProbeData = std::make_unique<DiffuseLightProbeData>();
+        return backfaceHitCount > mMaximumBackfaceHitFraction * mEmbeddedProbeTestRayCount;
+    }
 
-        AxisAlignedBox3D bb = scene.lightBakingVolume();
+    void DiffuseLightProbeGenerator::relocateEmbeddedProbe(DiffuseLightProbe &probe, const AxisAlignedBox3D &bounds, const Scene &scene) {
+        glm::vec3 escapeDirection;
+        float escapeDistance = 0.0;
+
+        if (!isProbeEmbedded(probe.position, scene, escapeDirection, escapeDistance)) {
+            return;
+        }
+
+        // Step a little past the closest back face to end up in front of the surface
+        float offset = 0.1 * scene.difuseProbesSpacing();
+        glm::vec3 relocatedPosition = probe.position + escapeDirection * (escapeDistance + offset);
+
+        if (bounds.contains(relocatedPosition) && !isProbeEmbedded(relocatedPosition, scene, escapeDirection, escapeDistance)) {
+            probe.position = relocatedPosition;
+        } else {
+            probe.isValid = false;
+        }
+    }
+
+    void DiffuseLightProbeGenerator::bakeProbe(DiffuseLightProbe &probe, const SurfelData& surfelData, const Scene &scene) {
+        EA_PROFILE_SCOPE("Bake diffuse light probe");
+
+        // Probes excluded from interpolation are not worth baking
+        if (!probe.isValid) {
+            return;
+        }
+
+        projectSurfelClustersOnProbe(probe, surfelData, scene);
+        projectSkyOnProbe(probe, scene);
+    }
+
+    void DiffuseLightProbeGenerator::bakeProbeResumably(DiffuseLightProbe &probe, uint32_t probeIndex, const AxisAlignedBox3D *relocationBounds, const SurfelData& surfelData, const Scene &scene) {
+        uint32_t shard = DiffuseLightProbeShard::ShardOfProbe(mBakeOrder.size(), mShardCount);
+        mBakeOrder.push_back(probeIndex);
+
+        if (shard != mShardIndex) {
+            return;
+        }
+
+        if (mBakedProbeCount < mRestoredProbes.size()) {
+            probe = mRestoredProbes[mBakedProbeCount++];
+            return;
+        }
+
+        if (relocationBounds) {
+            relocateEmbeddedProbe(probe, *relocationBounds, scene);
+        }
+        bakeProbe(probe, surfelData, scene);
+        mBakedProbeCount++;
+
+        if (mCheckpoint) {
+            mCheckpoint->probeBaked(probe, *mProbeData);
+        }
+    }
+
+    void DiffuseLightProbeGenerator::generateUniformGridProbes(const Scene &scene, const SurfelData& surfelData, const AxisAlignedBox3D &volume) {
+        EA_PROFILE_SCOPE("Generate uniform grid probes");
+
+        const AxisAlignedBox3D &bb = volume;
         glm::vec3 bbLengths = bb.max - bb.min;
         glm::vec3 resolution = glm::max(glm::vec3(1.0), glm::round(bbLengths / scene.difuseProbesSpacing()));
         glm::vec3 step = bbLengths / (resolution - 1.0f);
@@ -120,17 +298,237 @@ namespace EARenderer {
             for (float y = bb.min.y; y <= bb.max.y + step.y / 2.0; y += step.y) {
                 for (float x = bb.min.x; x <= bb.max.x + step.x / 2.0; x += step.x) {
                     DiffuseLightProbe probe({x, y, z});
-                    projectSurfelClustersOnProbe(probe, surfelData, scene);
-                    projectSkyOnProbe(probe, scene);
+                    bakeProbeResumably(probe, (uint32_t) mProbeData->mProbes.size(), nullptr, surfelData, scene);
                     mProbeData->mProbes.push_back(probe);
                 }
             }
         }
 
         mProbeData->mGridResolution = resolution;
+
+        // A single lookup cell covering the whole grid keeps interpolation the same for both layouts
+        mProbeData->mBrickLookupResolution = glm::ivec3(1);
+        mProbeData->mBrickLookup = {
+                DiffuseLightProbeData::BrickLookupEntry(glm::uvec3(0), glm::uvec3(0), glm::uvec3(1), glm::uvec3(resolution))
+        };
+    }
+
+    void DiffuseLightProbeGenerator::generateSparseBrickProbes(const Scene &scene, const SurfelData& surfelData, const AxisAlignedBox3D &volume) {
+        EA_PROFILE_SCOPE("Generate sparse brick probes");
+
+        const AxisAlignedBox3D &bb = volume;
+        glm::vec3 bbLengths = bb.max - bb.min;
+
+        // Cells of the lookup grid are covered by the densest bricks, which keep the requested probe spacing
+        glm::vec3 finestBrickLength = glm::vec3(scene.difuseProbesSpacing() * (BrickResolution - 1));
+        glm::ivec3 cellResolution = glm::max(glm::ivec3(1), glm::ivec3(glm::ceil(bbLengths / finestBrickLength)));
+        glm::vec3 cellSize = glm::max(bbLengths / glm::vec3(cellResolution), glm::vec3(std::numeric_limits<float>::epsilon()));
+
+        // Summed volume table of surfel counts to get the amount of surfels in any box of cells in constant time
+        glm::ivec3 tableResolution = cellResolution + 1;
+        std::vector<uint32_t> surfelCounts(size_t(tableResolution.x) * tableResolution.y * tableResolution.z, 0);
+
+        auto tableIndex = [&](int32_t x, int32_t y, int32_t z) {
+            return (size_t(z) * tableResolution.y + y) * tableResolution.x + x;
+        };
+
+        for (auto &surfel : surfelData.surfels()) {
+            glm::ivec3 cell = glm::clamp(glm::ivec3((surfel.position - bb.min) / cellSize), glm::ivec3(0), cellResolution - 1);
+            surfelCounts[tableIndex(cell.x + 1, cell.y + 1, cell.z + 1)]++;
+        }
+
+        for (int32_t z = 1; z < tableResolution.z; z++) {
+            for (int32_t y = 1; y < tableResolution.y; y++) {
+                for (int32_t x = 1; x < tableResolution.x; x++) {
+                    surfelCounts[tableIndex(x, y, z)] +=
+                            surfelCounts[tableIndex(x - 1, y, z)] + surfelCounts[tableIndex(x, y - 1, z)] + surfelCounts[tableIndex(x, y, z - 1)]
+                            - surfelCounts[tableIndex(x - 1, y - 1, z)] - surfelCounts[tableIndex(x - 1, y, z - 1)] - surfelCounts[tableIndex(x, y - 1, z - 1)]
+                            + surfelCounts[tableIndex(x - 1, y - 1, z - 1)];
+                }
+            }
+        }
+
+        auto surfelCount = [&](const BrickCell &cell) {
+            glm::ivec3 a = cell.origin;
+            glm::ivec3 b = cell.origin + cell.extent;
+            return surfelCounts[tableIndex(b.x, b.y, b.z)]
+                    - surfelCounts[tableIndex(a.x, b.y, b.z)] - surfelCounts[tableIndex(b.x, a.y, b.z)] - surfelCounts[tableIndex(b.x, b.y, a.z)]
+                    + surfelCounts[tableIndex(a.x, a.y, b.z)] + surfelCounts[tableIndex(a.x, b.y, a.z)] + surfelCounts[tableIndex(b.x, a.y, a.z)]
+                    - surfelCounts[tableIndex(a.x, a.y, a.z)];
+        };
+
+        // Subdivide the sparsest bricks where geometry is dense
+        int32_t rootExtent = 1 << mMaximumBrickSubdivisionDepth;
+        std::vector<BrickCell> cellStack;
+        std::vector<BrickCell> leaves;
+
+        for (int32_t z = 0; z < cellResolution.z; z += rootExtent) {
+            for (int32_t y = 0; y < cellResolution.y; y += rootExtent) {
+                for (int32_t x = 0; x < cellResolution.x; x += rootExtent) {
+                    glm::ivec3 origin(x, y, z);
+                    cellStack.push_back({origin, glm::min(glm::ivec3(rootExtent), cellResolution - origin)});
+                }
+            }
+        }
+
+        while (!cellStack.empty()) {
+            BrickCell cell = cellStack.back();
+            cellStack.pop_back();
+
+            if (glm::all(glm::equal(cell.extent, glm::ivec3(1))) || surfelCount(cell) < mBrickSubdivisionSurfelCount) {
+                leaves.push_back(cell);
+                continue;
+            }
+
+            // Axes of a single cell are not split any further
+            glm::ivec3 firstHalf = (cell.extent + 1) / 2;
+            for (int32_t i = 0; i < 8; i++) {
+                glm::ivec3 side((i >> 0) & 1, (i >> 1) & 1, (i >> 2) & 1);
+                BrickCell child;
+                child.origin = cell.origin + side * firstHalf;
+                child.extent = glm::mix(firstHalf, cell.extent - firstHalf, glm::bvec3(side));
+                if (glm::all(glm::greaterThan(child.extent, glm::ivec3(0)))) {
+                    cellStack.push_back(child);
+                }
+            }
+        }
+
+        // Pack bricks into a roughly cubic atlas
+        int32_t slotsPerSide = std::max(1, int32_t(std::ceil(std::cbrt(double(leaves.size())))));
+        int32_t slotLayers = std::max(1, int32_t((leaves.size() + slotsPerSide * slotsPerSide - 1) / (slotsPerSide * slotsPerSide)));
+        glm::ivec3 atlasResolution = glm::ivec3(slotsPerSide, slotsPerSide, slotLayers) * BrickResolution;
+
+        // Unused atlas slots are never referenced by the lookup and stay invalid
+        DiffuseLightProbe unusedProbe(bb.center());
+        unusedProbe.isValid = false;
+        mProbeData->mProbes.assign(size_t(atlasResolution.x) * atlasResolution.y * atlasResolution.z, unusedProbe);
+        mProbeData->mBrickLookup.assign(size_t(cellResolution.x) * cellResolution.y * cellResolution.z, glm::uvec4(0));
+
+        // Probe positions on the lattice of the densest bricks, neighbouring bricks share the probes of their common faces
+        std::unordered_map<uint64_t, uint32_t> latticeProbes;
+
+        for (size_t leafIndex = 0; leafIndex < leaves.size(); leafIndex++) {
+            const BrickCell &cell = leaves[leafIndex];
+
+            glm::ivec3 slot(leafIndex % slotsPerSide, (leafIndex / slotsPerSide) % slotsPerSide, leafIndex / (slotsPerSide * slotsPerSide));
+            glm::ivec3 atlasOrigin = slot * BrickResolution;
+
+            AxisAlignedBox3D brickBounds(bb.min + glm::vec3(cell.origin) * cellSize, bb.min + glm::vec3(cell.origin + cell.extent) * cellSize);
+            glm::vec3 probeStep = (brickBounds.max - brickBounds.min) / float(BrickResolution - 1);
+
+            for (int32_t z = 0; z < BrickResolution; z++) {
+                for (int32_t y = 0; y < BrickResolution; y++) {
+                    for (int32_t x = 0; x < BrickResolution; x++) {
+                        glm::ivec3 texel = atlasOrigin + glm::ivec3(x, y, z);
+                        size_t probeIndex = (size_t(texel.z) * atlasResolution.y + texel.y) * atlasResolution.x + texel.x;
+
+                        glm::uvec3 lattice(cell.origin * (BrickResolution - 1) + glm::ivec3(x, y, z) * cell.extent);
+                        uint64_t latticeKey = (uint64_t(lattice.z) << 42) | (uint64_t(lattice.y) << 21) | uint64_t(lattice.x);
+
+                        auto latticeProbe = latticeProbes.emplace(latticeKey, (uint32_t) probeIndex);
+                        if (!latticeProbe.second) {
+                            mSharedProbes.push_back({(uint32_t) probeIndex, latticeProbe.first->second});
+                            continue;
+                        }
+
+                        DiffuseLightProbe probe(brickBounds.min + glm::vec3(x, y, z) * probeStep);
+                        bakeProbeResumably(probe, (uint32_t) probeIndex, &brickBounds, surfelData, scene);
+                        mProbeData->mProbes[probeIndex] = probe;
+                    }
+                }
+            }
+
+            glm::uvec4 entry = DiffuseLightProbeData::BrickLookupEntry(atlasOrigin, cell.origin, cell.extent, glm::uvec3(BrickResolution));
+            glm::ivec3 cellEnd = cell.origin + cell.extent;
+
+            for (int32_t z = cell.origin.z; z < cellEnd.z; z++) {
+                for (int32_t y = cell.origin.y; y < cellEnd.y; y++) {
+                    for (int32_t x = cell.origin.x; x < cellEnd.x; x++) {
+                        mProbeData->mBrickLookup[(size_t(z) * cellResolution.y + y) * cellResolution.x + x] = entry;
+                    }
+                }
+            }
+        }
+
+        DiffuseLightProbeShard::CopySharedProbes(mSharedProbes, mProbeData->mProbes);
+
+        mProbeData->mGridResolution = atlasResolution;
+        mProbeData->mBrickLookupResolution = cellResolution;
+    }
+
+#pragma mark - Public interface
+
+    void DiffuseLightProbeGenerator::setProjectionEncoding(DiffuseLightProbeData::ProjectionEncoding encoding) {
+        mProjectionEncoding = encoding;
+    }
+
+    void DiffuseLightProbeGenerator::setLayout(DiffuseLightProbeData::Layout layout) {
+        mLayout = layout;
+    }
+
+    void DiffuseLightProbeGenerator::setCheckpoint(BakeCheckpoint *checkpoint) {
+        mCheckpoint = checkpoint;
+    }
+
+    std::unique_ptr<DiffuseLightProbeData> DiffuseLightProbeGenerator::generateProbes(const Scene &scene, const SurfelData& surfelData) {
+        return generateProbes(scene, surfelData, scene.lightBakingVolume());
+    }
+
+    void DiffuseLightProbeGenerator::generate(const Scene &scene, const SurfelData& surfelData, const AxisAlignedBox3D &volume, uint32_t shardIndex, uint32_t shardCount) {
+        mProbeData = std::make_unique<DiffuseLightProbeData>();
+        mProbeData->mProjectionEncoding = mProjectionEncoding;
+        mProbeData->mLayout = mLayout;
+        mRestoredProbes.clear();
+        mBakedProbeCount = 0;
+        mShardIndex = shardIndex;
+        mShardCount = shardCount;
+        mBakeOrder.clear();
+        mSharedProbes.clear();
+
+        if (mCheckpoint) {
+            auto &progress = mCheckpoint->beginProbes(mProjectionEncoding, mLayout);
+            mProbeData->mSurfelClusterProjections.assign(progress.projections.begin(), progress.projections.end());
+            mProbeData->mQuantizedSurfelClusterProjections.assign(progress.quantizedProjections.begin(), progress.quantizedProjections.end());
+            mRestoredProbes = progress.probes;
+        }
+
+        switch (mLayout) {
+            case DiffuseLightProbeData::Layout::UniformGrid:
+                generateUniformGridProbes(scene, surfelData, volume);
+                break;
+            case DiffuseLightProbeData::Layout::SparseBricks:
+                generateSparseBrickProbes(scene, surfelData, volume);
+                break;
+        }
+
+        mRestoredProbes = {};
+    }
+
+    std::unique_ptr<DiffuseLightProbeData> DiffuseLightProbeGenerator::generateProbes(const Scene &scene, const SurfelData& surfelData, const AxisAlignedBox3D &volume) {
+        EA_PROFILE_SCOPE("Diffuse light probe generation");
+
+        generate(scene, surfelData, volume, 0, 1);
+        mBakeOrder = {};
+        mSharedProbes = {};
         mProbeData->initializeBuffers();
 
         return std::move(mProbeData);
     }
 
+    std::unique_ptr<DiffuseLightProbeShard> DiffuseLightProbeGenerator::generateProbeShard(const Scene &scene, const SurfelData& surfelData, uint32_t shardIndex, uint32_t shardCount) {
+        return generateProbeShard(scene, surfelData, scene.lightBakingVolume(), shardIndex, shardCount);
+    }
+
+    std::unique_ptr<DiffuseLightProbeShard> DiffuseLightProbeGenerator::generateProbeShard(const Scene &scene, const SurfelData& surfelData, const AxisAlignedBox3D &volume, uint32_t shardIndex, uint32_t shardCount) {
+        EA_PROFILE_SCOPE("Diffuse light probe shard generation");
+
+        if (shardIndex >= shardCount) {
+            throw std::invalid_argument(string_format("Shard index %u is out of range of %u shards", shardIndex, shardCount));
+        }
+
+        generate(scene, surfelData, volume, shardIndex, shardCount);
+
+        return std::make_unique<DiffuseLightProbeShard>(shardIndex, shardCount, std::move(mBakeOrder), std::move(mSharedProbes), std::move(mProbeData));
+    }
+
 }
@@ -11,27 +11,176 @@
 
 #include "Scene.hpp"
 #include "DiffuseLightProbeData.hpp"
+#include "DiffuseLightProbeShard.hpp"
 #include "SurfelData.hpp"
+#include "BakeCheckpoint.hpp"
 
 #include <memory>
+#include <vector>
 #include <glm/vec2.hpp>
 
 namespace EARenderer {
 
     class DiffuseLightProbeGenerator {
     private:
+        struct BrickCell {
+            glm::ivec3 origin;
+            glm::ivec3 extent;
+        };
+
+        // Probes along each side of a brick of the sparse layout
+        static constexpr int32_t BrickResolution = 4;
+
         std::unique_ptr<DiffuseLightProbeData> mProbeData;
+        DiffuseLightProbeData::ProjectionEncoding mProjectionEncoding = DiffuseLightProbeData::ProjectionEncoding::Quantized;
+        DiffuseLightProbeData::Layout mLayout = DiffuseLightProbeData::Layout::SparseBricks;
+
+        // Bricks of the sparse layout are subdivided at most this many times,
+        // so the sparsest bricks have 2^depth times larger spacing between probes than the densest ones
+        int32_t mMaximumBrickSubdivisionDepth = 2;
+        // Bricks containing at least this many surfels are subdivided
+        uint32_t mBrickSubdivisionSurfelCount = 64;
+        // Amount of rays used to detect whether a probe is located inside solid geometry
+        size_t mEmbeddedProbeTestRayCount = 32;
+        // Probes seeing back faces in a larger portion of directions are considered embedded in geometry
+        float mMaximumBackfaceHitFraction = 0.25;
+
+        // Parent clusters subtending a smaller solid angle are projected as a whole instead of their children
+        float mMaximumClusterProxySolidAngle = 0.05;
+        // Amount of visibility rays used to estimate occlusion of a parent cluster
+        size_t mClusterProxyVisibilitySampleCount = 4;
+
+        BakeCheckpoint *mCheckpoint = nullptr;
+        // Probes restored from the checkpoint, in the order they were baked
+        DiffuseLightProbeData::ProbeVector mRestoredProbes;
+        size_t mBakedProbeCount = 0;
+
+        uint32_t mShardIndex = 0;
+        uint32_t mShardCount = 1;
+        // Indices of probes in the order they are visited, including probes of other shards
+        std::vector<uint32_t> mBakeOrder;
+        // Atlas texels repeating probes of neighbouring bricks, which are baked once
+        std::vector<DiffuseLightProbeShard::SharedProbe> mSharedProbes;
 
         float surfelSolidAngle(const Surfel &surfel, const DiffuseLightProbe &probe, const Scene &scene);
 
+        /**
+         Approximates the solid angle of the cluster's bounding sphere as seen from the probe
+
+         @return solid angle in steradians, or a value larger than the full sphere when probe is inside the bounds
+         */
+        float clusterBoundsSolidAngle(const SurfelCluster &cluster, const DiffuseLightProbe &probe);
+
         SurfelClusterProjection projectSurfelCluster(const SurfelCluster &cluster, const DiffuseLightProbe &probe, const SurfelData& surfelData, const Scene &scene);
 
+        /**
+         Projects a parent cluster as a single surface element with aggregated area, albedo and normal,
+         estimating its visibility with only a few rays
+
+         @param cluster parent cluster of the surfel hierarchy
+         @param probe probe to project onto
+         @param surfelData surfels and clusters
+         @param scene scene providing a ray tracer
+         @return projection of the aggregated surface
+         */
+        SurfelClusterProjection projectSurfelClusterProxy(const SurfelCluster &cluster, const DiffuseLightProbe &probe, const SurfelData& surfelData, const Scene &scene);
+
         void projectSurfelClustersOnProbe(DiffuseLightProbe &probe, const SurfelData& surfelData, const Scene &scene);
 
         void projectSkyOnProbe(DiffuseLightProbe &probe, const Scene &scene);
 
+        /**
+         Checks whether the probe sees back faces in too many directions, which means it's located inside geometry
+
+         @param position position of the probe
+         @param scene scene providing a ray tracer
+         @param escapeDirection direction towards the closest back face, which is the shortest way out of the geometry
+         @param escapeDistance distance to the closest back face
+         @return true if probe is embedded in geometry
+         */
+        bool isProbeEmbedded(const glm::vec3 &position, const Scene &scene, glm::vec3 &escapeDirection, float &escapeDistance);
+
+        /**
+         Pushes an embedded probe out of geometry, staying inside the given bounds
+
+         @param probe probe to relocate, marked as invalid if relocation fails
+         @param bounds region the probe is allowed to move within
+         @param scene scene providing a ray tracer
+         */
+        void relocateEmbeddedProbe(DiffuseLightProbe &probe, const AxisAlignedBox3D &bounds, const Scene &scene);
+
+        void bakeProbe(DiffuseLightProbe &probe, const SurfelData& surfelData, const Scene &scene);
+
+        /**
+         Relocates and bakes the probe, or takes it from the checkpoint if it was baked before the bake was interrupted.
+         Probes are baked in a deterministic order, which is what makes the n-th restored probe the n-th baked one.
+         Probes belonging to other shards are only recorded in the bake order.
+
+         @param probe probe to bake
+         @param probeIndex index of the probe in the probe data
+         @param relocationBounds region an embedded probe is allowed to move within, nullptr to keep the probe in place
+         @param surfelData surfels and clusters
+         @param scene scene providing a ray tracer
+         */
+        void bakeProbeResumably(DiffuseLightProbe &probe, uint32_t probeIndex, const AxisAlignedBox3D *relocationBounds, const SurfelData& surfelData, const Scene &scene);
+
+        void generateUniformGridProbes(const Scene &scene, const SurfelData& surfelData, const AxisAlignedBox3D &volume);
+
+        /**
+         Splits the baking volume into an octree of bricks, subdividing where surfels are dense.
+         Every leaf holds a brick of BrickResolution^3 probes, bricks are packed into an atlas
+         and a lookup texture maps baking volume cells to the bricks.
+         Bricks are filtered independently, so probes on shared faces are repeated in every brick's atlas slot,
+         but a probe at any lattice position is baked only once and its projections are referenced by every copy.
+         */
+        void generateSparseBrickProbes(const Scene &scene, const SurfelData& surfelData, const AxisAlignedBox3D &volume);
+
+        void generate(const Scene &scene, const SurfelData& surfelData, const AxisAlignedBox3D &volume, uint32_t shardIndex, uint32_t shardCount);
+
     public:
+        /**
+         @param encoding encoding of generated surfel cluster projections, quantized by default
+         */
+        void setProjectionEncoding(DiffuseLightProbeData::ProjectionEncoding encoding);
+
+        /**
+         @param layout probe placement strategy, sparse bricks by default
+         */
+        void setLayout(DiffuseLightProbeData::Layout layout);
+
+        /**
+         @param checkpoint checkpoint receiving progress of subsequent generations and providing progress to resume from,
+         nullptr to bake without checkpoints. Must outlive generation.
+         */
+        void setCheckpoint(BakeCheckpoint *checkpoint);
+
         std::unique_ptr<DiffuseLightProbeData> generateProbes(const Scene &scene, const SurfelData& surfelData);
+
+        /**
+         Places and bakes probes inside the volume
+
+         @param scene scene providing a ray tracer and probe spacing
+         @param surfelData surfels generated for the same volume
+         @param volume region of the scene to fill with probes
+         @return baked probes of the volume
+         */
+        std::unique_ptr<DiffuseLightProbeData> generateProbes(const Scene &scene, const SurfelData& surfelData, const AxisAlignedBox3D &volume);
+
+        std::unique_ptr<DiffuseLightProbeShard> generateProbeShard(const Scene &scene, const SurfelData& surfelData, uint32_t shardIndex, uint32_t shardCount);
+
+        /**
+         Places all probes inside the volume, but only bakes the ones belonging to the shard.
+         Shards are meant to be baked by separate processes from the same surfels and merged with DiffuseLightProbeShard::Merge().
+         A checkpoint used while baking a shard must not be shared with other shards.
+
+         @param scene scene providing a ray tracer and probe spacing
+         @param surfelData surfels generated for the same volume
+         @param volume region of the scene to fill with probes
+         @param shardIndex index of the shard to bake
+         @param shardCount amount of shards the bake is split into
+         @return probes of the volume with buffers left uninitialized
+         */
+        std::unique_ptr<DiffuseLightProbeShard> generateProbeShard(const Scene &scene, const SurfelData& surfelData, const AxisAlignedBox3D &volume, uint32_t shardIndex, uint32_t shardCount);
     };
 
 }
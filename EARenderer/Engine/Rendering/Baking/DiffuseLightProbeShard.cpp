@@ -0,0 +1,204 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "DiffuseLightProbeShard.hpp"
+#include "StringUtils.hpp"
+#include "Profiler.hpp"
+
+#include <bitsery/bitsery.h>
+#include <bitsery/traits/vector.h>
+#include <bitsery/adapter/stream.h>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+namespace EARenderer {
+
+#pragma mark - Nested types
+
+    bool DiffuseLightProbeShard::SharedProbe::operator==(const SharedProbe &rhs) const {
+        return probeIndex == rhs.probeIndex && sourceProbeIndex == rhs.sourceProbeIndex;
+    }
+
+#pragma mark - Lifecycle
+
+    DiffuseLightProbeShard::DiffuseLightProbeShard(uint32_t shardIndex, uint32_t shardCount, std::vector<uint32_t> bakeOrder,
+                                                   std::vector<SharedProbe> sharedProbes, std::unique_ptr<DiffuseLightProbeData> probeData)
+            : mShardIndex(shardIndex), mShardCount(shardCount), mBakeOrder(std::move(bakeOrder)),
+              mSharedProbes(std::move(sharedProbes)), mProbeData(std::move(probeData)) {
+        if (shardIndex >= shardCount) {
+            throw std::invalid_argument(string_format("Shard index %u is out of range of %u shards", shardIndex, shardCount));
+        }
+    }
+
+#pragma mark - Merging
+
+    uint32_t DiffuseLightProbeShard::ShardOfProbe(size_t bakeOrderIndex, uint32_t shardCount) {
+        // Interleaving spreads expensive regions of the volume evenly over the shards
+        return uint32_t(bakeOrderIndex % shardCount);
+    }
+
+    void DiffuseLightProbeShard::CopySharedProbes(const std::vector<SharedProbe> &sharedProbes, DiffuseLightProbeData::ProbeVector &probes) {
+        for (auto &sharedProbe : sharedProbes) {
+            if (sharedProbe.probeIndex >= probes.size() || sharedProbe.sourceProbeIndex >= probes.size()) {
+                throw std::invalid_argument(string_format("Shared probe %u refers to probe %u out of %zu",
+                        sharedProbe.probeIndex, sharedProbe.sourceProbeIndex, probes.size()));
+            }
+            probes[sharedProbe.probeIndex] = probes[sharedProbe.sourceProbeIndex];
+        }
+    }
+
+    std::unique_ptr<DiffuseLightProbeData> DiffuseLightProbeShard::Merge(const std::vector<DiffuseLightProbeShard> &shards) {
+        EA_PROFILE_SCOPE("Merge diffuse light probe shards");
+
+        if (shards.empty()) {
+            throw std::invalid_argument("No diffuse light probe shards to merge");
+        }
+
+        uint32_t shardCount = shards.front().mShardCount;
+        if (shards.size() != shardCount) {
+            throw std::invalid_argument(string_format("Bake is split into %u shards, but %zu shards were given", shardCount, shards.size()));
+        }
+
+        std::vector<const DiffuseLightProbeShard *> orderedShards(shardCount, nullptr);
+        const DiffuseLightProbeShard &first = shards.front();
+        const DiffuseLightProbeData &firstData = *first.mProbeData;
+
+        for (auto &shard : shards) {
+            const DiffuseLightProbeData &data = *shard.mProbeData;
+
+            bool isSameBake = shard.mShardCount == shardCount &&
+                    shard.mBakeOrder == first.mBakeOrder &&
+                    shard.mSharedProbes == first.mSharedProbes &&
+                    data.mProjectionEncoding == firstData.mProjectionEncoding &&
+                    data.mLayout == firstData.mLayout &&
+                    data.mGridResolution == firstData.mGridResolution &&
+                    data.mBrickLookupResolution == firstData.mBrickLookupResolution &&
+                    data.mBrickLookup == firstData.mBrickLookup &&
+                    data.mProbes.size() == firstData.mProbes.size();
+
+            if (!isSameBake) {
+                throw std::invalid_argument(string_format("Shard %u doesn't belong to the same bake as shard %u", shard.mShardIndex, first.mShardIndex));
+            }
+            if (orderedShards[shard.mShardIndex]) {
+                throw std::invalid_argument(string_format("Shard %u is given more than once", shard.mShardIndex));
+            }
+            orderedShards[shard.mShardIndex] = &shard;
+        }
+
+        auto merged = std::make_unique<DiffuseLightProbeData>();
+        merged->mProjectionEncoding = firstData.mProjectionEncoding;
+        merged->mLayout = firstData.mLayout;
+        merged->mGridResolution = firstData.mGridResolution;
+        merged->mBrickLookupResolution = firstData.mBrickLookupResolution;
+        merged->mBrickLookup = firstData.mBrickLookup;
+        // Probes missing from the bake order are unused atlas slots, which are the same in every shard
+        merged->mProbes = firstData.mProbes;
+
+        for (size_t i = 0; i < first.mBakeOrder.size(); i++) {
+            uint32_t probeIndex = first.mBakeOrder[i];
+            const DiffuseLightProbeData &data = *orderedShards[ShardOfProbe(i, shardCount)]->mProbeData;
+
+            if (probeIndex >= data.mProbes.size()) {
+                throw std::invalid_argument(string_format("Bake order refers to probe %u out of %zu", probeIndex, data.mProbes.size()));
+            }
+
+            DiffuseLightProbe probe = data.mProbes[probeIndex];
+
+            // Only valid probes are projected, and their projection groups start wherever the previous probe's group ended
+            if (probe.isValid) {
+                size_t groupBegin = probe.surfelClusterProjectionGroupOffset;
+                size_t groupEnd = groupBegin + probe.surfelClusterProjectionGroupSize;
+
+                if (groupEnd > data.surfelClusterProjectionCount()) {
+                    throw std::invalid_argument(string_format("Probe %u refers to projections out of range", probeIndex));
+                }
+
+                probe.surfelClusterProjectionGroupOffset = (uint32_t) merged->surfelClusterProjectionCount();
+
+                switch (merged->mProjectionEncoding) {
+                    case DiffuseLightProbeData::ProjectionEncoding::Lossless:
+                        merged->mSurfelClusterProjections.insert(merged->mSurfelClusterProjections.end(),
+                                data.mSurfelClusterProjections.begin() + groupBegin, data.mSurfelClusterProjections.begin() + groupEnd);
+                        break;
+                    case DiffuseLightProbeData::ProjectionEncoding::Quantized:
+                        merged->mQuantizedSurfelClusterProjections.insert(merged->mQuantizedSurfelClusterProjections.end(),
+                                data.mQuantizedSurfelClusterProjections.begin() + groupBegin, data.mQuantizedSurfelClusterProjections.begin() + groupEnd);
+                        break;
+                }
+            }
+
+            merged->mProbes[probeIndex] = probe;
+        }
+
+        CopySharedProbes(first.mSharedProbes, merged->mProbes);
+
+        return merged;
+    }
+
+#pragma mark - Getters
+
+    uint32_t DiffuseLightProbeShard::shardIndex() const {
+        return mShardIndex;
+    }
+
+    uint32_t DiffuseLightProbeShard::shardCount() const {
+        return mShardCount;
+    }
+
+    const std::vector<uint32_t> &DiffuseLightProbeShard::bakeOrder() const {
+        return mBakeOrder;
+    }
+
+    const std::vector<DiffuseLightProbeShard::SharedProbe> &DiffuseLightProbeShard::sharedProbes() const {
+        return mSharedProbes;
+    }
+
+    const DiffuseLightProbeData &DiffuseLightProbeShard::probeData() const {
+        return *mProbeData;
+    }
+
+#pragma mark - Serialization
+
+    void DiffuseLightProbeShard::serialize(const std::string &filePath) {
+        EA_PROFILE_SCOPE("Serialize diffuse light probe shard");
+
+        std::ofstream stream(filePath, std::ios::trunc | std::ios::binary);
+        if (!stream.is_open()) {
+            throw std::runtime_error(string_format("Unable to serialize light probe shard: %s", filePath.c_str()));
+        }
+
+        bitsery::Serializer<bitsery::OutputBufferedStreamAdapter> serializer(stream);
+        serializer.value4b(mShardIndex);
+        serializer.value4b(mShardCount);
+        serializer.container4b(mBakeOrder, mBakeOrder.size());
+        serializer.container(mSharedProbes, mSharedProbes.size());
+        serializer.object(*mProbeData);
+        bitsery::AdapterAccess::getWriter(serializer).flush();
+    }
+
+    bool DiffuseLightProbeShard::deserialize(const std::string &filePath) {
+        EA_PROFILE_SCOPE("Deserialize diffuse light probe shard");
+
+        std::ifstream stream(filePath, std::ios::binary);
+        if (!stream.is_open()) {
+            return false;
+        }
+
+        // Buffers are left uninitialized, shards are only read to be merged
+        mProbeData = std::make_unique<DiffuseLightProbeData>();
+
+        bitsery::Deserializer<bitsery::InputStreamAdapter> deserializer(stream);
+        deserializer.value4b(mShardIndex);
+        deserializer.value4b(mShardCount);
+        deserializer.container4b(mBakeOrder, std::numeric_limits<uint32_t>::max());
+        deserializer.container(mSharedProbes, std::numeric_limits<uint32_t>::max());
+        deserializer.object(*mProbeData);
+
+        auto &reader = bitsery::AdapterAccess::getReader(deserializer);
+        return reader.isCompletedSuccessfully() && mShardIndex < mShardCount;
+    }
+
+}
@@ -0,0 +1,101 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_DIFFUSELIGHTPROBESHARD_HPP
+#define EARENDERER_DIFFUSELIGHTPROBESHARD_HPP
+
+#include "DiffuseLightProbeData.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace EARenderer {
+
+    /**
+     Part of a diffuse light probe bake split between several processes.
+
+     Every shard places all probes of the baking volume, but only bakes every shardCount-th probe of the bake order
+     starting from its own index. Probes of other shards are left unbaked. Merging the shards walks the bake order
+     and appends projections of every probe in turn, which reproduces the data of a single process bake bit for bit.
+     Probes shared by neighbouring bricks of the sparse layout are baked once and copied to the other bricks after merging.
+     */
+    class DiffuseLightProbeShard {
+    public:
+        /**
+         Atlas texel repeating a probe baked for another brick, since bricks are filtered independently
+         */
+        struct SharedProbe {
+            uint32_t probeIndex = 0;
+            uint32_t sourceProbeIndex = 0;
+
+            bool operator==(const SharedProbe &rhs) const;
+
+            template<typename S>
+            void serialize(S &s) {
+                s.value4b(probeIndex);
+                s.value4b(sourceProbeIndex);
+            }
+        };
+
+    private:
+        uint32_t mShardIndex = 0;
+        uint32_t mShardCount = 1;
+        // Indices of probes in the order they are baked
+        std::vector<uint32_t> mBakeOrder;
+        std::vector<SharedProbe> mSharedProbes;
+        std::unique_ptr<DiffuseLightProbeData> mProbeData;
+
+    public:
+        DiffuseLightProbeShard() = default;
+
+        DiffuseLightProbeShard(uint32_t shardIndex, uint32_t shardCount, std::vector<uint32_t> bakeOrder,
+                               std::vector<SharedProbe> sharedProbes, std::unique_ptr<DiffuseLightProbeData> probeData);
+
+        /**
+         Copies baked probes to the atlas texels repeating them
+
+         @param sharedProbes texels to fill
+         @param probes probes of the whole atlas
+         */
+        static void CopySharedProbes(const std::vector<SharedProbe> &sharedProbes, DiffuseLightProbeData::ProbeVector &probes);
+
+        /**
+         @param bakeOrderIndex position of a probe in the bake order
+         @param shardCount amount of shards the bake is split into
+         @return index of the shard baking the probe
+         */
+        static uint32_t ShardOfProbe(size_t bakeOrderIndex, uint32_t shardCount);
+
+        /**
+         Combines shards of the same bake into the data a single process would have baked.
+         Buffers of the merged data are not initialized.
+
+         @param shards every shard of the bake, in any order
+         @return merged probe data
+         */
+        static std::unique_ptr<DiffuseLightProbeData> Merge(const std::vector<DiffuseLightProbeShard> &shards);
+
+        uint32_t shardIndex() const;
+
+        uint32_t shardCount() const;
+
+        const std::vector<uint32_t> &bakeOrder() const;
+
+        const std::vector<SharedProbe> &sharedProbes() const;
+
+        /**
+         @return probes of the whole volume, only probes of this shard being baked
+         */
+        const DiffuseLightProbeData &probeData() const;
+
+        void serialize(const std::string &filePath);
+
+        bool deserialize(const std::string &filePath);
+    };
+
+}
+
+#endif //EARENDERER_DIFFUSELIGHTPROBESHARD_HPP
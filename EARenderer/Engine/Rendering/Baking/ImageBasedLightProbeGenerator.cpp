@@ -4,8 +4,10 @@
 //
 
 #include "ImageBasedLightProbeGenerator.hpp"
+#include "GLStateCache.hpp"
 #include "ImageBasedLightProbe.hpp"
 #include "Drawable.hpp"
+#include "Profiler.hpp"
 
 namespace EARenderer {
 
@@ -16,6 +18,8 @@ namespace EARenderer {
               mFramebuffer(probeResolution) {}
 
     void ImageBasedLightProbeGenerator::convertEquirectangilarMap(const GLFloatTexture2D<GLTexture::Float::RGB16F> &equirectangularMap) {
+        EA_PROFILE_SCOPE("Convert equirectangular map");
+
         mFramebuffer.redirectRenderingToTextures({mConversionCubemap.size()}, GLFramebuffer::UnderlyingBuffer::None, &mConversionCubemap);
         mConversionShader.bind();
         mConversionShader.ensureSamplerValidity([&] {
@@ -25,6 +29,8 @@ namespace EARenderer {
     }
 
     void ImageBasedLightProbeGenerator::buildBRDFIntegrationMap() {
+        EA_PROFILE_SCOPE("Build BRDF integration map");
+
         mFramebuffer.redirectRenderingToTextures({mBRDFIntegrationMap->size()}, GLFramebuffer::UnderlyingBuffer::None, mBRDFIntegrationMap);
         mBRDFIntegrationShader.bind();
         Drawable::TriangleStripQuad::Draw();
@@ -67,8 +73,10 @@ namespace EARenderer {
     }
 
     ImageBasedLightProbe ImageBasedLightProbeGenerator::generate(GLFloatTextureCubemap<GLTexture::Float::RGB16F> &HDRCubemap) {
-        glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
-        glDisable(GL_BLEND);
+        EA_PROFILE_SCOPE("Image based light probe generation");
+
+        GLStateCache::shared().enable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
+        GLStateCache::shared().disable(GL_BLEND);
 
         if (!mBRDFIntegrationMap) {
             mBRDFIntegrationMap = std::make_shared<GLFloatTexture2D<GLTexture::Float::RG16F>>(512);
@@ -0,0 +1,189 @@
+//
+// Created by Pavlo Muratov on 2019-02-05.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "LightBakingVolumeCache.hpp"
+#include "SurfelGenerator.hpp"
+#include "DiffuseLightProbeGenerator.hpp"
+#include "StringUtils.hpp"
+#include "FNV1aHash.hpp"
+#include "Profiler.hpp"
+#include "FileManager.hpp"
+
+#include <fstream>
+
+namespace EARenderer {
+
+#pragma mark - Lifecycle
+
+    LightBakingVolumeCache::LightBakingVolumeCache(const Scene *scene, const SharedResourceStorage *resourceStorage)
+            :
+            mScene(scene),
+            mResourceStorage(resourceStorage) {
+    }
+
+#pragma mark - Private helpers
+
+    uint64_t LightBakingVolumeCache::fingerprint(const LightBakingVolume &volume) const {
+        // Raw bytes of every input of the bake
+        FNV1aHash hash;
+        hash.combine(volume.bounds.min);
+        hash.combine(volume.bounds.max);
+        hash.combine(mScene->difuseProbesSpacing());
+        hash.combine(mScene->surfelSpacing());
+
+        hash.combine(mProbeLayout);
+        hash.combine(mProjectionEncoding);
+
+        for (ID instanceID : mScene->staticMeshInstanceIDs()) {
+            const MeshInstance &instance = mScene->meshInstances()[instanceID];
+            ID meshID = instance.meshID();
+            const Mesh &mesh = mResourceStorage->mesh(meshID);
+            AxisAlignedBox3D instanceBounds = instance.boundingBox(mesh);
+
+            if (!volume.bounds.intersects(instanceBounds)) {
+                continue;
+            }
+
+            hash.combine(meshID);
+            hash.combine(instanceBounds.min);
+            hash.combine(instanceBounds.max);
+            // Rotations keep bounds intact, so the transform itself is hashed as well
+            hash.combine(instance.modelMatrix());
+
+            // Surfels take their albedo from the material resolved the same way as in SurfelGenerator
+            for (ID subMeshID : mesh.subMeshes()) {
+                auto materialRef = instance.materialReference;
+                if (!materialRef) {
+                    materialRef = instance.materialReferenceForSubMeshID(subMeshID);
+                }
+
+                if (!materialRef.has_value()) {
+                    hash.combine(false);
+                    continue;
+                }
+
+                hash.combine(true);
+                hash.combine(materialRef->first);
+                hash.combine(materialRef->second);
+
+                if (materialRef->first == MaterialType::CookTorrance) {
+                    const CookTorranceMaterial &material = mResourceStorage->cookTorranceMaterial(materialRef->second);
+                    hash.combineString(material.mapPath(CookTorranceMaterial::MapType::Albedo));
+                    hash.combine(material.albedoColor().rgba());
+                }
+            }
+        }
+
+        return hash.value();
+    }
+
+    std::string LightBakingVolumeCache::surfelsFileName(const LightBakingVolume &volume) const {
+        return FileManager::shared().cacheRootPath() + string_format("surfels_%s_%s_%016llx", mScene->name().c_str(), volume.name.c_str(), (unsigned long long) fingerprint(volume));
+    }
+
+    std::string LightBakingVolumeCache::probesFileName(const LightBakingVolume &volume) const {
+        return FileManager::shared().cacheRootPath() + string_format("diffuse_light_probes_%s_%s_%016llx", mScene->name().c_str(), volume.name.c_str(), (unsigned long long) fingerprint(volume));
+    }
+
+    std::string LightBakingVolumeCache::checkpointPathPrefix(const LightBakingVolume &volume) const {
+        return FileManager::shared().cacheRootPath() + string_format("bake_checkpoint_%s_%s", mScene->name().c_str(), volume.name.c_str());
+    }
+
+#pragma mark - Public interface
+
+    void LightBakingVolumeCache::setCheckpointSettings(const BakeCheckpoint::Settings &settings) {
+        mCheckpointSettings = settings;
+    }
+
+    void LightBakingVolumeCache::setProbeLayout(DiffuseLightProbeData::Layout layout) {
+        mProbeLayout = layout;
+    }
+
+    void LightBakingVolumeCache::setProjectionEncoding(DiffuseLightProbeData::ProjectionEncoding encoding) {
+        mProjectionEncoding = encoding;
+    }
+
+    LightBakingVolumeCache::VolumeFiles LightBakingVolumeCache::files(const LightBakingVolume &volume) const {
+        VolumeFiles volumeFiles;
+        volumeFiles.surfelsPath = surfelsFileName(volume);
+        volumeFiles.probesPath = probesFileName(volume);
+        return volumeFiles;
+    }
+
+    bool LightBakingVolumeCache::isBaked(const LightBakingVolume &volume) const {
+        return std::ifstream(surfelsFileName(volume)).is_open() && std::ifstream(probesFileName(volume)).is_open();
+    }
+
+    void LightBakingVolumeCache::bake(const LightBakingVolume &volume) const {
+        EA_PROFILE_SCOPE("Bake light baking volume");
+
+        BakeCheckpoint checkpoint(checkpointPathPrefix(volume), fingerprint(volume), mCheckpointSettings);
+
+        auto surfelData = std::make_unique<SurfelData>();
+        if (!checkpoint.loadSurfels(*surfelData)) {
+            SurfelGenerator surfelGenerator(mResourceStorage, mScene);
+            surfelData = surfelGenerator.generateStaticGeometrySurfels(volume.bounds);
+            checkpoint.saveSurfels(*surfelData);
+        }
+
+        // Probe projections reference surfel clusters by index, so probes are always rebaked together with surfels
+        DiffuseLightProbeGenerator probeGenerator;
+        probeGenerator.setLayout(mProbeLayout);
+        probeGenerator.setProjectionEncoding(mProjectionEncoding);
+        probeGenerator.setCheckpoint(&checkpoint);
+        auto probeData = probeGenerator.generateProbes(*mScene, *surfelData, volume.bounds);
+
+        // Probes are stored last, since having both files is what marks the volume as baked
+        BakeCheckpoint::ReplaceFile(surfelsFileName(volume), [&](const std::string &path) { surfelData->serialize(path); });
+        BakeCheckpoint::ReplaceFile(probesFileName(volume), [&](const std::string &path) { probeData->serialize(path); });
+
+        checkpoint.clear();
+    }
+
+    size_t LightBakingVolumeCache::bakeOutdatedVolumes() const {
+        EA_PROFILE_SCOPE("Bake outdated volumes");
+
+        size_t bakedCount = 0;
+        for (auto &volume : mScene->lightBakingVolumes()) {
+            if (!isBaked(volume)) {
+                bake(volume);
+                bakedCount++;
+            }
+        }
+        return bakedCount;
+    }
+
+    std::unique_ptr<LightBakingVolumeCache::VolumeData> LightBakingVolumeCache::Read(const VolumeFiles &files) {
+        EA_PROFILE_SCOPE("Read light baking volume");
+
+        auto data = std::make_unique<VolumeData>();
+        data->surfelData = std::make_unique<SurfelData>();
+        data->probeData = std::make_unique<DiffuseLightProbeData>();
+
+        if (!data->surfelData->deserialize(files.surfelsPath, false) || !data->probeData->deserialize(files.probesPath, false)) {
+            return nullptr;
+        }
+
+        return data;
+    }
+
+    void LightBakingVolumeCache::Upload(VolumeData &data) {
+        EA_PROFILE_SCOPE("Upload light baking volume");
+
+        data.surfelData->initializeBuffers();
+        data.probeData->initializeBuffers();
+    }
+
+    std::unique_ptr<LightBakingVolumeCache::VolumeData> LightBakingVolumeCache::load(const LightBakingVolume &volume) const {
+        EA_PROFILE_SCOPE("Load light baking volume");
+
+        auto data = Read(files(volume));
+        if (data) {
+            Upload(*data);
+        }
+        return data;
+    }
+
+}
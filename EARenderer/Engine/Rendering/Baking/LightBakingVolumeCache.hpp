@@ -0,0 +1,125 @@
+//
+// Created by Pavlo Muratov on 2019-02-05.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_LIGHTBAKINGVOLUMECACHE_HPP
+#define EARENDERER_LIGHTBAKINGVOLUMECACHE_HPP
+
+#include "Scene.hpp"
+#include "SharedResourceStorage.hpp"
+#include "LightBakingVolume.hpp"
+#include "SurfelData.hpp"
+#include "DiffuseLightProbeData.hpp"
+#include "BakeCheckpoint.hpp"
+
+#include <memory>
+#include <string>
+
+namespace EARenderer {
+
+    /**
+     Bakes surfels and probes of each light baking volume separately and keeps them on disk.
+
+     Cached files are kept under the cache root and named after the scene, the volume and a fingerprint
+     of everything the bake depends on (volume bounds, spacing and probe settings, and transforms and materials
+     of static mesh instances overlapping the volume), so editing one region only invalidates the volumes overlapping it.
+     Bakes keep checkpoints on disk while running, so a bake that was interrupted continues where it stopped.
+     */
+    class LightBakingVolumeCache {
+    public:
+        struct VolumeData {
+            std::unique_ptr<SurfelData> surfelData;
+            std::unique_ptr<DiffuseLightProbeData> probeData;
+        };
+
+        struct VolumeFiles {
+            std::string surfelsPath;
+            std::string probesPath;
+        };
+
+    private:
+        const Scene *mScene;
+        const SharedResourceStorage *mResourceStorage;
+        BakeCheckpoint::Settings mCheckpointSettings;
+        DiffuseLightProbeData::Layout mProbeLayout = DiffuseLightProbeData::Layout::SparseBricks;
+        DiffuseLightProbeData::ProjectionEncoding mProjectionEncoding = DiffuseLightProbeData::ProjectionEncoding::Quantized;
+
+        uint64_t fingerprint(const LightBakingVolume &volume) const;
+
+        std::string surfelsFileName(const LightBakingVolume &volume) const;
+
+        std::string probesFileName(const LightBakingVolume &volume) const;
+
+        /**
+         Not tied to the fingerprint, so that checkpoints of outdated inputs are found and discarded
+         */
+        std::string checkpointPathPrefix(const LightBakingVolume &volume) const;
+
+    public:
+        LightBakingVolumeCache(const Scene *scene, const SharedResourceStorage *resourceStorage);
+
+        void setCheckpointSettings(const BakeCheckpoint::Settings &settings);
+
+        /**
+         @param layout probe placement strategy of subsequent bakes, sparse bricks by default
+         */
+        void setProbeLayout(DiffuseLightProbeData::Layout layout);
+
+        /**
+         @param encoding encoding of surfel cluster projections of subsequent bakes, quantized by default
+         */
+        void setProjectionEncoding(DiffuseLightProbeData::ProjectionEncoding encoding);
+
+        /**
+         @param volume volume of the scene
+         @return paths of the volume's cached files for the current state of the scene
+         */
+        VolumeFiles files(const LightBakingVolume &volume) const;
+
+        /**
+         @param volume volume of the scene
+         @return true if up to date surfels and probes of the volume are cached
+         */
+        bool isBaked(const LightBakingVolume &volume) const;
+
+        /**
+         Generates and caches surfels and probes of the volume, resuming from a checkpoint of an interrupted bake.
+         Requires scene's ray tracer, so it has to be called before the scene's auxiliary data is destroyed.
+
+         @param volume volume of the scene
+         */
+        void bake(const LightBakingVolume &volume) const;
+
+        /**
+         Bakes every volume of the scene which has no up to date cache
+
+         @return amount of baked volumes
+         */
+        size_t bakeOutdatedVolumes() const;
+
+        /**
+         Reads cached surfels and probes without touching the GPU, so it can run on any thread
+
+         @param files paths of the volume's cached files
+         @return volume's data without GPU buffers, or nullptr if the files are missing or corrupted
+         */
+        static std::unique_ptr<VolumeData> Read(const VolumeFiles &files);
+
+        /**
+         Creates GPU buffers of data returned by Read(). Has to be called on the thread owning the GL context.
+         */
+        static void Upload(VolumeData &data);
+
+        /**
+         Loads cached surfels and probes of the volume and uploads them to the GPU
+
+         @param volume volume of the scene
+         @return volume's data, or nullptr if the volume is not baked
+         */
+        std::unique_ptr<VolumeData> load(const LightBakingVolume &volume) const;
+    };
+
+}
+
+#endif //EARENDERER_LIGHTBAKINGVOLUMECACHE_HPP
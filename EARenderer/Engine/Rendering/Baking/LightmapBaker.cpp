@@ -0,0 +1,523 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "LightmapBaker.hpp"
+#include "AtlasPacker.hpp"
+#include "SobolSampler.hpp"
+#include "ThreadPool.hpp"
+#include "Profiler.hpp"
+#include "StringUtils.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_inverse.hpp>
+#include <glm/gtx/norm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace EARenderer {
+
+    namespace {
+
+        // Ray origins are lifted off the surface by this fraction of texel size to avoid self intersections
+        constexpr float SurfaceOffset = 0.25;
+
+        float Cross(const glm::vec2 &lhs, const glm::vec2 &rhs) {
+            return lhs.x * rhs.y - lhs.y * rhs.x;
+        }
+
+        uint32_t Hash(uint32_t x) {
+            x ^= x >> 16;
+            x *= 0x7feb352d;
+            x ^= x >> 15;
+            x *= 0x846ca68b;
+            x ^= x >> 16;
+            return x;
+        }
+
+        std::optional<MaterialReference> SubMeshMaterial(const MeshInstance &instance, ID subMeshID) {
+            auto materialRef = instance.materialReference;
+            if (!materialRef) {
+                materialRef = instance.materialReferenceForSubMeshID(subMeshID);
+            }
+            return materialRef;
+        }
+
+    }
+
+#pragma mark - Lifecycle
+
+    LightmapBaker::LightmapBaker(const SharedResourceStorage *resourcePool, const Scene *scene)
+            :
+            LightmapBaker(resourcePool, scene, Settings()) {
+    }
+
+    LightmapBaker::LightmapBaker(const SharedResourceStorage *resourcePool, const Scene *scene, const Settings &settings)
+            :
+            mSettings(settings),
+            mResourcePool(resourcePool),
+            mScene(scene) {
+
+        if (mSettings.atlasResolution < mSettings.minimumChartResolution + 2 * mSettings.chartPadding) {
+            throw std::invalid_argument(string_format("Lightmap atlas resolution %u can't fit a single chart", mSettings.atlasResolution));
+        }
+
+        mSettings.minimumChartResolution = std::max(mSettings.minimumChartResolution, 1u);
+        mSettings.sampleCount = std::max(mSettings.sampleCount, 1u);
+        mSettings.tileResolution = std::max(mSettings.tileResolution, 1u);
+    }
+
+#pragma mark - Private helpers
+
+    size_t LightmapBaker::texelIndex(uint32_t atlasIndex, uint32_t x, uint32_t y) const {
+        return (size_t(atlasIndex) * mSettings.atlasResolution + y) * mSettings.atlasResolution + x;
+    }
+
+    float LightmapBaker::texelSize() const {
+        return mScene->surfelSpacing() / mSettings.texelsPerSurfelSpacing;
+    }
+
+    template<typename Func>
+    void LightmapBaker::forEachCoveredTexel(Func &&func) const {
+        uint32_t resolution = mSettings.atlasResolution;
+        uint32_t tileResolution = mSettings.tileResolution;
+        uint32_t tilesPerSide = (resolution + tileResolution - 1) / tileResolution;
+        size_t tilesPerAtlas = size_t(tilesPerSide) * tilesPerSide;
+
+        ThreadPool::Default().parallelFor(tilesPerAtlas * mAtlasCount, 1, [&](size_t begin, size_t end) {
+            for (size_t tile = begin; tile < end; tile++) {
+                uint32_t atlasIndex = uint32_t(tile / tilesPerAtlas);
+                uint32_t tileX = uint32_t(tile % tilesPerAtlas) % tilesPerSide * tileResolution;
+                uint32_t tileY = uint32_t(tile % tilesPerAtlas) / tilesPerSide * tileResolution;
+
+                for (uint32_t y = tileY; y < std::min(tileY + tileResolution, resolution); y++) {
+                    for (uint32_t x = tileX; x < std::min(tileX + tileResolution, resolution); x++) {
+                        if (mTexelCoverage[texelIndex(atlasIndex, x, y)]) {
+                            func(atlasIndex, x, y);
+                        }
+                    }
+                }
+            }
+        });
+    }
+
+#pragma mark - Charts
+
+    void LightmapBaker::createCharts() {
+        EA_PROFILE_SCOPE("Create lightmap charts");
+
+        mCharts.clear();
+
+        float texelsPerUnit = 1.0f / texelSize();
+        float maximumResolution = float(mSettings.atlasResolution - 2 * mSettings.chartPadding);
+        float minimumResolution = float(mSettings.minimumChartResolution);
+
+        // Triangles are enumerated in the same order the scene's ray tracer is built in
+        size_t triangleIndex = 0;
+
+        for (ID instanceID : mScene->staticMeshInstanceIDs()) {
+            auto &instance = mScene->meshInstances()[instanceID];
+            auto &mesh = mResourcePool->mesh(instance.meshID());
+
+            for (ID subMeshID : mesh.subMeshes()) {
+                auto &vertices = mesh.subMeshes()[subMeshID].vertices();
+
+                Chart chart;
+                chart.meshInstanceID = instanceID;
+                chart.subMeshID = subMeshID;
+                chart.firstTriangle = triangleIndex;
+                chart.triangleCount = vertices.size() / 3;
+                triangleIndex += chart.triangleCount;
+
+                // Albedo is only known for Cook-Torrance surfaces, same as for surfels
+                auto materialRef = SubMeshMaterial(instance, subMeshID);
+                if (!materialRef.has_value() || materialRef->first != MaterialType::CookTorrance || chart.triangleCount == 0) {
+                    continue;
+                }
+
+                glm::vec2 lightmapCoordsMax(std::numeric_limits<float>::lowest());
+                chart.lightmapCoordsMin = glm::vec2(std::numeric_limits<float>::max());
+                float lightmapArea = 0.0;
+                float worldArea = 0.0;
+
+                for (size_t i = 0; i < chart.triangleCount * 3; i += 3) {
+                    for (size_t k = 0; k < 3; k++) {
+                        chart.lightmapCoordsMin = glm::min(chart.lightmapCoordsMin, vertices[i + k].lightmapCoords);
+                        lightmapCoordsMax = glm::max(lightmapCoordsMax, vertices[i + k].lightmapCoords);
+                    }
+
+                    lightmapArea += std::abs(Cross(vertices[i + 1].lightmapCoords - vertices[i].lightmapCoords,
+                            vertices[i + 2].lightmapCoords - vertices[i].lightmapCoords)) / 2.0f;
+
+                    glm::vec3 p0(instance.modelMatrix() * vertices[i].position);
+                    glm::vec3 p1(instance.modelMatrix() * vertices[i + 1].position);
+                    glm::vec3 p2(instance.modelMatrix() * vertices[i + 2].position);
+                    worldArea += glm::length(glm::cross(p1 - p0, p2 - p0)) / 2.0f;
+                }
+
+                // Sub meshes lacking lightmap coordinates can't be baked
+                if (lightmapArea <= std::numeric_limits<float>::epsilon() || worldArea <= 0.0f) {
+                    continue;
+                }
+
+                chart.lightmapCoordsExtent = lightmapCoordsMax - chart.lightmapCoordsMin;
+
+                // Scale keeping world space area of a texel equal to the desired one
+                float texelsPerLightmapUnit = std::sqrt(worldArea / lightmapArea) * texelsPerUnit;
+                glm::vec2 resolution = glm::ceil(chart.lightmapCoordsExtent * texelsPerLightmapUnit);
+
+                float largestResolution = std::max(resolution.x, resolution.y);
+                if (largestResolution > maximumResolution) {
+                    resolution = glm::floor(resolution * maximumResolution / largestResolution);
+                }
+
+                chart.resolution = glm::uvec2(glm::clamp(resolution, glm::vec2(minimumResolution), glm::vec2(maximumResolution)));
+                mCharts.push_back(chart);
+            }
+        }
+
+        mTriangleMappings.assign(triangleIndex, TriangleChartMapping());
+    }
+
+    void LightmapBaker::packCharts() {
+        EA_PROFILE_SCOPE("Pack lightmap charts");
+
+        int padding = int(mSettings.chartPadding);
+        std::vector<rbp::RectSize> sizes;
+        sizes.reserve(mCharts.size());
+        for (auto &chart : mCharts) {
+            sizes.push_back({int(chart.resolution.x) + 2 * padding, int(chart.resolution.y) + 2 * padding});
+        }
+
+        // Charts are never flipped, since a scale and an offset can't express a rotation of lightmap coordinates
+        AtlasPacker::Settings packerSettings;
+        packerSettings.binWidth = int(mSettings.atlasResolution);
+        packerSettings.binHeight = int(mSettings.atlasResolution);
+        auto result = AtlasPacker(packerSettings).pack(sizes);
+
+        for (size_t i = 0; i < mCharts.size(); i++) {
+            auto &placement = result.placements[i];
+            mCharts[i].atlasIndex = placement.binIndex;
+            mCharts[i].origin = glm::uvec2(placement.rect.x + padding, placement.rect.y + padding);
+        }
+
+        mAtlasCount = uint32_t(result.report.binCount());
+        EA_PROFILE_COUNTER("Lightmap atlas occupancy", result.report.occupancy());
+    }
+
+#pragma mark - Rasterization
+
+    void LightmapBaker::rasterizeCharts() {
+        EA_PROFILE_SCOPE("Rasterize lightmap charts");
+
+        size_t texelCount = size_t(mAtlasCount) * mSettings.atlasResolution * mSettings.atlasResolution;
+        mTexelCharts.assign(texelCount, -1);
+        mTexelCoverage.assign(texelCount, 0);
+        mTexelSurfaces.assign(texelCount, TexelSurface());
+        mTexelAlbedo.assign(texelCount, glm::vec4(0.0));
+
+        for (size_t chartIndex = 0; chartIndex < mCharts.size(); chartIndex++) {
+            auto &chart = mCharts[chartIndex];
+            auto &instance = mScene->meshInstances()[chart.meshInstanceID];
+            auto &mesh = mResourcePool->mesh(instance.meshID());
+            auto &vertices = mesh.subMeshes()[chart.subMeshID].vertices();
+            auto &material = mResourcePool->cookTorranceMaterial(SubMeshMaterial(instance, chart.subMeshID)->second);
+
+            glm::uvec2 paddedOrigin = chart.origin - glm::uvec2(mSettings.chartPadding);
+            glm::uvec2 paddedEnd = chart.origin + chart.resolution + glm::uvec2(mSettings.chartPadding);
+            for (uint32_t y = paddedOrigin.y; y < paddedEnd.y; y++) {
+                for (uint32_t x = paddedOrigin.x; x < paddedEnd.x; x++) {
+                    mTexelCharts[texelIndex(chart.atlasIndex, x, y)] = int32_t(chartIndex);
+                }
+            }
+
+            // Lightmaps only capture low frequency lighting, so a blurred albedo will do, same as for surfels
+            int32_t mipLevel = material.albedoMap()->mipMapCount() * 0.6;
+            auto sampler = material.albedoMap()->sampleTexels(mipLevel);
+
+            glm::mat4 modelMatrix = instance.modelMatrix();
+            glm::mat3 normalMatrix = glm::inverseTranspose(glm::mat3(modelMatrix));
+            glm::vec2 texelsPerLightmapUnit = glm::vec2(chart.resolution) / chart.lightmapCoordsExtent;
+
+            for (size_t triangle = 0; triangle < chart.triangleCount; triangle++) {
+                auto vertex = &vertices[triangle * 3];
+                auto &mapping = mTriangleMappings[chart.firstTriangle + triangle];
+                mapping.chartIndex = int32_t(chartIndex);
+
+                for (size_t k = 0; k < 3; k++) {
+                    mapping.atlasCoords[k] = (vertex[k].lightmapCoords - chart.lightmapCoordsMin) * texelsPerLightmapUnit + glm::vec2(chart.origin);
+                }
+
+                auto &coords = mapping.atlasCoords;
+                float area = Cross(coords[1] - coords[0], coords[2] - coords[0]);
+                if (std::abs(area) <= std::numeric_limits<float>::epsilon()) {
+                    continue;
+                }
+
+                glm::vec2 coordsMin = glm::min(coords[0], glm::min(coords[1], coords[2]));
+                glm::vec2 coordsMax = glm::max(coords[0], glm::max(coords[1], coords[2]));
+                uint32_t xBegin = std::max(uint32_t(std::max(std::floor(coordsMin.x), 0.0f)), chart.origin.x);
+                uint32_t yBegin = std::max(uint32_t(std::max(std::floor(coordsMin.y), 0.0f)), chart.origin.y);
+                uint32_t xEnd = std::min(uint32_t(std::max(std::ceil(coordsMax.x), 0.0f)), chart.origin.x + chart.resolution.x);
+                uint32_t yEnd = std::min(uint32_t(std::max(std::ceil(coordsMax.y), 0.0f)), chart.origin.y + chart.resolution.y);
+
+                glm::vec3 p0(modelMatrix * vertex[0].position);
+                glm::vec3 p1(modelMatrix * vertex[1].position);
+                glm::vec3 p2(modelMatrix * vertex[2].position);
+                glm::vec3 geometricNormal = glm::cross(p1 - p0, p2 - p0);
+                geometricNormal = glm::length2(geometricNormal) > 0.0f ? glm::normalize(geometricNormal) : glm::vec3(0.0, 1.0, 0.0);
+
+                for (uint32_t y = yBegin; y < yEnd; y++) {
+                    for (uint32_t x = xBegin; x < xEnd; x++) {
+                        glm::vec2 center(x + 0.5f, y + 0.5f);
+                        float b1 = Cross(center - coords[0], coords[2] - coords[0]) / area;
+                        float b2 = Cross(coords[1] - coords[0], center - coords[0]) / area;
+                        float b0 = 1.0f - b1 - b2;
+
+                        constexpr float Tolerance = -1e-5;
+                        if (b0 < Tolerance || b1 < Tolerance || b2 < Tolerance) {
+                            continue;
+                        }
+
+                        glm::vec3 normal = normalMatrix * (vertex[0].normal * b0 + vertex[1].normal * b1 + vertex[2].normal * b2);
+                        glm::vec2 textureCoords = glm::vec2(vertex[0].textureCoords * b0 + vertex[1].textureCoords * b1 + vertex[2].textureCoords * b2);
+
+                        auto texel = sampler.sample(GLTexture::WrapCoordinates(textureCoords));
+                        Color albedoLinear = Color(texel.r, texel.g, texel.b).convertedTo(Color::Space::Linear);
+
+                        size_t index = texelIndex(chart.atlasIndex, x, y);
+                        mTexelCoverage[index] = 1;
+                        mTexelSurfaces[index].position = p0 * b0 + p1 * b1 + p2 * b2;
+                        mTexelSurfaces[index].normal = glm::length2(normal) > 0.0f ? glm::normalize(normal) : geometricNormal;
+                        mTexelAlbedo[index] = glm::vec4(albedoLinear.rgb(), 1.0);
+                    }
+                }
+            }
+        }
+
+        dilate(mTexelAlbedo);
+    }
+
+    void LightmapBaker::dilate(std::vector<glm::vec4> &texels) const {
+        uint32_t resolution = mSettings.atlasResolution;
+        std::vector<uint8_t> coverage = mTexelCoverage;
+        std::vector<uint8_t> nextCoverage = coverage;
+
+        for (uint32_t iteration = 0; iteration < std::max(mSettings.chartPadding, 1u); iteration++) {
+            // Texels written in this iteration were not covered, so no other texel reads them until the next one
+            ThreadPool::Default().parallelFor(size_t(mAtlasCount) * resolution, 16, [&](size_t begin, size_t end) {
+                for (size_t row = begin; row < end; row++) {
+                    uint32_t atlasIndex = uint32_t(row / resolution);
+                    uint32_t y = uint32_t(row % resolution);
+
+                    for (uint32_t x = 0; x < resolution; x++) {
+                        size_t index = texelIndex(atlasIndex, x, y);
+                        if (coverage[index] || mTexelCharts[index] < 0) {
+                            continue;
+                        }
+
+                        glm::vec4 sum(0.0);
+                        float count = 0.0;
+
+                        for (int32_t dy = -1; dy <= 1; dy++) {
+                            for (int32_t dx = -1; dx <= 1; dx++) {
+                                int32_t nx = int32_t(x) + dx;
+                                int32_t ny = int32_t(y) + dy;
+                                if (nx < 0 || ny < 0 || nx >= int32_t(resolution) || ny >= int32_t(resolution)) {
+                                    continue;
+                                }
+
+                                size_t neighbour = texelIndex(atlasIndex, uint32_t(nx), uint32_t(ny));
+                                if (coverage[neighbour] && mTexelCharts[neighbour] == mTexelCharts[index]) {
+                                    sum += texels[neighbour];
+                                    count += 1.0f;
+                                }
+                            }
+                        }
+
+                        if (count > 0.0f) {
+                            texels[index] = sum / count;
+                            nextCoverage[index] = 1;
+                        }
+                    }
+                }
+            });
+
+            coverage = nextCoverage;
+        }
+    }
+
+#pragma mark - Lighting
+
+    std::vector<glm::vec4> LightmapBaker::directIrradiance() const {
+        EA_PROFILE_SCOPE("Compute direct lightmap irradiance");
+
+        std::vector<glm::vec4> irradiance(mTexelSurfaces.size(), glm::vec4(0.0));
+        auto rayTracer = mScene->rayTracer();
+        float offset = texelSize() * SurfaceOffset;
+        auto &sun = mScene->sun();
+        auto &pointLights = mScene->pointLights();
+
+        forEachCoveredTexel([&](uint32_t atlasIndex, uint32_t x, uint32_t y) {
+            size_t index = texelIndex(atlasIndex, x, y);
+            auto &surface = mTexelSurfaces[index];
+            glm::vec3 origin = surface.position + surface.normal * offset;
+            glm::vec3 result(0.0);
+
+            if (sun.isEnabled()) {
+                glm::vec3 L = -glm::normalize(sun.direction());
+                float NdotL = glm::dot(surface.normal, L);
+                EmbreeRayTracer::Hit hit;
+
+                if (NdotL > 0.0f && !rayTracer->rayHit(Ray3D(origin, L), hit)) {
+                    result += sun.color().rgb() * NdotL;
+                }
+            }
+
+            for (ID lightID : pointLights) {
+                auto &light = pointLights[lightID];
+                if (!light.isEnabled()) {
+                    continue;
+                }
+
+                glm::vec3 toLight = light.position() - surface.position;
+                float distance = glm::length(toLight);
+                float NdotL = distance > 0.0f ? glm::dot(surface.normal, toLight / distance) : 0.0f;
+
+                if (NdotL <= 0.0f || rayTracer->lineSegmentOccluded(origin, light.position())) {
+                    continue;
+                }
+
+                // Same falloff as the runtime shading uses
+                float attenuation = 1.0f / (light.attenuation.constant +
+                        light.attenuation.linear * distance +
+                        light.attenuation.quadratic * distance * distance);
+
+                result += light.color().rgb() * attenuation * NdotL;
+            }
+
+            irradiance[index] = glm::vec4(result, 0.0);
+        });
+
+        return irradiance;
+    }
+
+    glm::vec3 LightmapBaker::reflectedIrradiance(const std::vector<glm::vec4> &irradiance, const EmbreeRayTracer::Hit &hit, const glm::vec3 &rayDirection) const {
+        if (hit.triangleIndex >= mTriangleMappings.size() || glm::dot(hit.normal, rayDirection) >= 0.0f) {
+            return glm::vec3(0.0);
+        }
+
+        auto &mapping = mTriangleMappings[hit.triangleIndex];
+        if (mapping.chartIndex < 0) {
+            return glm::vec3(0.0);
+        }
+
+        auto &chart = mCharts[mapping.chartIndex];
+        auto &coords = mapping.atlasCoords;
+        glm::vec2 hitCoords = coords[0] * (1.0f - hit.barycentrics.x - hit.barycentrics.y) +
+                coords[1] * hit.barycentrics.x +
+                coords[2] * hit.barycentrics.y;
+
+        glm::vec2 texel = glm::clamp(glm::floor(hitCoords), glm::vec2(chart.origin), glm::vec2(chart.origin + chart.resolution - 1u));
+        size_t index = texelIndex(chart.atlasIndex, uint32_t(texel.x), uint32_t(texel.y));
+
+        return glm::vec3(mTexelAlbedo[index]) * glm::vec3(irradiance[index]);
+    }
+
+    std::vector<glm::vec4> LightmapBaker::bouncedIrradiance(const std::vector<glm::vec4> &sourceIrradiance, uint32_t bounce) const {
+        EA_PROFILE_SCOPE("Compute bounced lightmap irradiance");
+
+        std::vector<glm::vec4> irradiance(mTexelSurfaces.size(), glm::vec4(0.0));
+        auto rayTracer = mScene->rayTracer();
+        float offset = texelSize() * SurfaceOffset;
+        uint32_t sampleCount = mSettings.sampleCount;
+        uint32_t bounceSeed = Hash(mSettings.seed ^ Hash(bounce));
+
+        forEachCoveredTexel([&](uint32_t atlasIndex, uint32_t x, uint32_t y) {
+            size_t index = texelIndex(atlasIndex, x, y);
+            auto &surface = mTexelSurfaces[index];
+            glm::vec3 origin = surface.position + surface.normal * offset;
+
+            // Neighbouring texels take complementary blocks of one sequence, which leaves blue noise rather than white noise
+            uint32_t rank = SobolSampler::PixelRank(glm::uvec2(x, y), Hash(bounceSeed ^ atlasIndex));
+            auto sampler = SobolSampler::Ranked(bounceSeed, rank, sampleCount);
+
+            // With cosine weighted sampling irradiance is pi times the average radiance,
+            // and a diffuse surface reflects albedo * irradiance / pi
+            glm::vec3 reflected(0.0);
+            float skyVisibility = 0.0;
+
+            for (uint32_t sample = 0; sample < sampleCount; sample++) {
+                glm::vec3 direction = sampler.cosineWeightedHemisphereDirection(sample, 0, surface.normal);
+                EmbreeRayTracer::Hit hit;
+
+                if (rayTracer->rayHit(Ray3D(origin, direction), hit)) {
+                    reflected += reflectedIrradiance(sourceIrradiance, hit, direction);
+                } else {
+                    skyVisibility += 1.0f;
+                }
+            }
+
+            irradiance[index] = glm::vec4(reflected, skyVisibility) / float(sampleCount);
+        });
+
+        return irradiance;
+    }
+
+#pragma mark - Baking
+
+    std::unique_ptr<LightmapData> LightmapBaker::bake() {
+        EA_PROFILE_SCOPE("Bake lightmaps");
+
+        if (!mScene->rayTracer()) {
+            throw std::runtime_error("Lightmap baking requires scene's ray tracer");
+        }
+
+        createCharts();
+        packCharts();
+        rasterizeCharts();
+
+        auto irradiance = directIrradiance();
+        dilate(irradiance);
+
+        // Sky visibility comes with the first gather, which is traced even if no bounces were requested
+        auto sourceIrradiance = irradiance;
+        uint32_t gatherCount = std::max(mSettings.bounceCount, 1u);
+
+        for (uint32_t bounce = 0; bounce < gatherCount; bounce++) {
+            auto bounced = bouncedIrradiance(sourceIrradiance, bounce);
+            dilate(bounced);
+
+            for (size_t i = 0; i < irradiance.size(); i++) {
+                if (bounce < mSettings.bounceCount) {
+                    irradiance[i] += glm::vec4(glm::vec3(bounced[i]), 0.0);
+                }
+                if (bounce == 0) {
+                    irradiance[i].a = bounced[i].a;
+                }
+            }
+
+            sourceIrradiance = std::move(bounced);
+        }
+
+        auto data = std::make_unique<LightmapData>();
+        data->mAtlasResolution = mSettings.atlasResolution;
+        data->mAtlasCount = mAtlasCount;
+        data->mTexels.assign(irradiance.begin(), irradiance.end());
+
+        float atlasResolution = float(mSettings.atlasResolution);
+        for (auto &chart : mCharts) {
+            glm::vec2 texelsPerLightmapUnit = glm::vec2(chart.resolution) / chart.lightmapCoordsExtent;
+            glm::vec2 scale = texelsPerLightmapUnit / atlasResolution;
+            glm::vec2 offset = (glm::vec2(chart.origin) - chart.lightmapCoordsMin * texelsPerLightmapUnit) / atlasResolution;
+            data->mPlacements.push_back({chart.meshInstanceID, chart.subMeshID, chart.atlasIndex, glm::vec4(scale, offset)});
+        }
+
+        return data;
+    }
+
+}
@@ -0,0 +1,168 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_LIGHTMAPBAKER_HPP
+#define EARENDERER_LIGHTMAPBAKER_HPP
+
+#include "Scene.hpp"
+#include "SharedResourceStorage.hpp"
+#include "LightmapData.hpp"
+#include "EmbreeRayTracer.hpp"
+
+#include <array>
+#include <memory>
+#include <vector>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+namespace EARenderer {
+
+    /**
+     Bakes diffuse lighting of static geometry into lightmap atlases on the CPU.
+
+     Every sub mesh of a static mesh instance becomes a single chart spanning its lightmap coordinates,
+     which therefore have to be free of overlaps. Chart resolution follows the world space area of the instance,
+     so that texel density is tied to the scene's surfel spacing. Charts are packed into atlases concurrently,
+     texel world positions, normals and albedo are rasterized, and irradiance of the sun, point lights and
+     a number of diffuse bounces is computed with the scene's ray tracer in parallel tiles.
+     Results are deterministic for a given seed regardless of the amount of threads.
+     */
+    class LightmapBaker {
+    public:
+        struct Settings {
+            // Lightmap texels along a distance equal to the scene's surfel spacing
+            float texelsPerSurfelSpacing = 2.0;
+            uint32_t atlasResolution = 1024;
+            // Texels around each chart, filled by dilation so that bilinear filtering doesn't pick up empty texels
+            uint32_t chartPadding = 2;
+            uint32_t minimumChartResolution = 4;
+            // Hemisphere rays per texel traced for each bounce
+            uint32_t sampleCount = 64;
+            uint32_t bounceCount = 1;
+            // Texels along each side of a tile processed as a single task
+            uint32_t tileResolution = 32;
+            uint32_t seed = 0;
+        };
+
+    private:
+
+#pragma mark - Nested types
+
+        struct Chart {
+            ID meshInstanceID;
+            ID subMeshID;
+            // Index of the sub mesh's first triangle in the scene's ray tracer
+            size_t firstTriangle;
+            size_t triangleCount;
+            glm::vec2 lightmapCoordsMin;
+            glm::vec2 lightmapCoordsExtent;
+            // Texels covered by the chart excluding padding
+            glm::uvec2 resolution;
+            uint32_t atlasIndex = 0;
+            glm::uvec2 origin;
+        };
+
+        struct TriangleChartMapping {
+            int32_t chartIndex = -1;
+            // Vertex positions in texel space of the atlas
+            std::array<glm::vec2, 3> atlasCoords;
+        };
+
+        struct TexelSurface {
+            glm::vec3 position;
+            glm::vec3 normal;
+        };
+
+#pragma mark - Member variables
+
+        Settings mSettings;
+        const SharedResourceStorage *mResourcePool = nullptr;
+        const Scene *mScene = nullptr;
+
+        std::vector<Chart> mCharts;
+        // Indexed by triangle indices of the scene's ray tracer, so that ray hits could be looked up in the atlases
+        std::vector<TriangleChartMapping> mTriangleMappings;
+        uint32_t mAtlasCount = 0;
+
+        // Per atlas texel: chart owning the texel including padding (-1 for none),
+        // whether the texel center is covered by a triangle, the surface under it and its albedo in rgb.
+        // Albedo is dilated, so that ray hits near chart edges find a value.
+        std::vector<int32_t> mTexelCharts;
+        std::vector<uint8_t> mTexelCoverage;
+        std::vector<TexelSurface> mTexelSurfaces;
+        std::vector<glm::vec4> mTexelAlbedo;
+
+#pragma mark - Member functions
+
+        size_t texelIndex(uint32_t atlasIndex, uint32_t x, uint32_t y) const;
+
+        /**
+         @return world space size of a lightmap texel
+         */
+        float texelSize() const;
+
+        /**
+         Creates a chart for every sub mesh of static mesh instances having a Cook-Torrance material and
+         non-degenerate lightmap coordinates, and maps triangles of the ray tracer to the charts
+         */
+        void createCharts();
+
+        void packCharts();
+
+        /**
+         Samples surface properties at the centers of texels covered by charts' triangles.
+         Albedo maps are read back from OpenGL, so this has to run on the thread owning the context.
+         */
+        void rasterizeCharts();
+
+        /**
+         Calls func(atlasIndex, x, y) for every covered texel, tiles of texels being processed in parallel
+         */
+        template<typename Func>
+        void forEachCoveredTexel(Func &&func) const;
+
+        /**
+         @return irradiance of the sun and point lights in rgb
+         */
+        std::vector<glm::vec4> directIrradiance() const;
+
+        /**
+         Gathers irradiance reflected by surfaces visible from each texel
+
+         @param sourceIrradiance irradiance reaching every texel, reflected diffusely
+         @param bounce index of the bounce, decorrelating sample patterns of consecutive bounces
+         @return reflected irradiance in rgb and cosine weighted sky visibility in alpha
+         */
+        std::vector<glm::vec4> bouncedIrradiance(const std::vector<glm::vec4> &sourceIrradiance, uint32_t bounce) const;
+
+        /**
+         @return irradiance of the atlas texel under the ray hit scaled by its albedo,
+         zero for back faces and surfaces without lightmaps
+         */
+        glm::vec3 reflectedIrradiance(const std::vector<glm::vec4> &irradiance, const EmbreeRayTracer::Hit &hit, const glm::vec3 &rayDirection) const;
+
+        /**
+         Extends values of covered texels into empty texels of the same chart, which fixes seams
+         where texel centers missed the chart's triangles
+         */
+        void dilate(std::vector<glm::vec4> &texels) const;
+
+    public:
+        LightmapBaker(const SharedResourceStorage *resourcePool, const Scene *scene);
+
+        LightmapBaker(const SharedResourceStorage *resourcePool, const Scene *scene, const Settings &settings);
+
+        /**
+         Requires scene's ray tracer, so it has to be called before the scene's auxiliary data is destroyed
+
+         @return lightmap atlases of static geometry
+         */
+        std::unique_ptr<LightmapData> bake();
+    };
+
+}
+
+#endif //EARENDERER_LIGHTMAPBAKER_HPP
@@ -0,0 +1,89 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "LightmapData.hpp"
+#include "StringUtils.hpp"
+#include "Serializers.hpp"
+#include "Profiler.hpp"
+
+#include <bitsery/bitsery.h>
+#include <bitsery/traits/vector.h>
+#include <bitsery/adapter/stream.h>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+namespace EARenderer {
+
+#pragma mark - Serialization
+
+    void LightmapData::serialize(const std::string &filePath) {
+        EA_PROFILE_SCOPE("Serialize lightmaps");
+
+        std::ofstream stream(filePath, std::ios::trunc | std::ios::binary);
+        if (!stream.is_open()) {
+            throw std::runtime_error(string_format("Unable to serialize lightmaps: %s", filePath.c_str()));
+        }
+
+        bitsery::Serializer<bitsery::OutputBufferedStreamAdapter> serializer(stream);
+        serializer.value4b(mAtlasResolution);
+        serializer.value4b(mAtlasCount);
+        serializer.container(mTexels, mTexels.size());
+        serializer.container(mPlacements, mPlacements.size());
+        bitsery::AdapterAccess::getWriter(serializer).flush();
+    }
+
+    bool LightmapData::deserialize(const std::string &filePath) {
+        EA_PROFILE_SCOPE("Deserialize lightmaps");
+
+        std::ifstream stream(filePath, std::ios::binary);
+        if (!stream.is_open()) {
+            return false;
+        }
+
+        bitsery::Deserializer<bitsery::InputStreamAdapter> deserializer(stream);
+        deserializer.value4b(mAtlasResolution);
+        deserializer.value4b(mAtlasCount);
+        deserializer.container(mTexels, std::numeric_limits<uint32_t>::max());
+        deserializer.container(mPlacements, std::numeric_limits<uint32_t>::max());
+
+        auto &reader = bitsery::AdapterAccess::getReader(deserializer);
+
+        size_t atlasTexelCount = size_t(mAtlasResolution) * mAtlasResolution;
+        return reader.isCompletedSuccessfully() && mTexels.size() == atlasTexelCount * mAtlasCount;
+    }
+
+#pragma mark - Getters
+
+    uint32_t LightmapData::atlasResolution() const {
+        return mAtlasResolution;
+    }
+
+    uint32_t LightmapData::atlasCount() const {
+        return mAtlasCount;
+    }
+
+    const LightmapData::TexelVector &LightmapData::texels() const {
+        return mTexels;
+    }
+
+    const glm::vec4 &LightmapData::texel(uint32_t atlasIndex, uint32_t x, uint32_t y) const {
+        return mTexels[(size_t(atlasIndex) * mAtlasResolution + y) * mAtlasResolution + x];
+    }
+
+    const std::vector<LightmapData::Placement> &LightmapData::placements() const {
+        return mPlacements;
+    }
+
+    const LightmapData::Placement *LightmapData::placement(ID meshInstanceID, ID subMeshID) const {
+        for (auto &placement : mPlacements) {
+            if (placement.meshInstanceID == meshInstanceID && placement.subMeshID == subMeshID) {
+                return &placement;
+            }
+        }
+        return nullptr;
+    }
+
+}
@@ -0,0 +1,81 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_LIGHTMAPDATA_HPP
+#define EARENDERER_LIGHTMAPDATA_HPP
+
+#include "PackedLookupTable.hpp"
+#include "TaggedAllocator.hpp"
+
+#include <glm/vec4.hpp>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace EARenderer {
+
+    class LightmapBaker;
+
+    /**
+     Square atlases of baked diffuse lighting of static geometry.
+     Each sub mesh of a static mesh instance owns a rectangle of one atlas, which its lightmap coordinates
+     are mapped into with a scale and an offset: atlasUV = lightmapCoords * scaleOffset.xy + scaleOffset.zw
+     */
+    class LightmapData {
+    public:
+        struct Placement {
+            ID meshInstanceID;
+            ID subMeshID;
+            uint32_t atlasIndex;
+            glm::vec4 scaleOffset;
+
+            template<typename S>
+            void serialize(S &s) {
+                s.value8b(meshInstanceID);
+                s.value8b(subMeshID);
+                s.value4b(atlasIndex);
+                s.object(scaleOffset);
+            }
+        };
+
+        // Irradiance in rgb and cosine weighted sky visibility in alpha,
+        // so that sky lighting could be applied at runtime without rebaking
+        using TexelVector = TaggedVector<glm::vec4, MemoryTag::Lightmaps>;
+
+    private:
+        friend LightmapBaker;
+
+        uint32_t mAtlasResolution = 0;
+        uint32_t mAtlasCount = 0;
+        TexelVector mTexels;
+        std::vector<Placement> mPlacements;
+
+    public:
+        void serialize(const std::string &filePath);
+
+        bool deserialize(const std::string &filePath);
+
+        uint32_t atlasResolution() const;
+
+        uint32_t atlasCount() const;
+
+        /**
+         @return texels of all atlases, atlas after atlas, row after row
+         */
+        const TexelVector &texels() const;
+
+        const glm::vec4 &texel(uint32_t atlasIndex, uint32_t x, uint32_t y) const;
+
+        const std::vector<Placement> &placements() const;
+
+        /**
+         @return placement of the sub mesh instance, nullptr if it has no lightmap
+         */
+        const Placement *placement(ID meshInstanceID, ID subMeshID) const;
+    };
+
+}
+
+#endif //EARENDERER_LIGHTMAPDATA_HPP
@@ -8,17 +8,23 @@
 
 #include "SurfelData.hpp"
 #include "StringUtils.hpp"
+#include "Profiler.hpp"
 
 #include <bitsery/bitsery.h>
 #include <bitsery/traits/vector.h>
 #include <bitsery/adapter/stream.h>
 #include <fstream>
+#include <algorithm>
+
+#include <glm/vec2.hpp>
 
 namespace EARenderer {
 
 #pragma mark - Data
 
     void SurfelData::initializeBuffers() {
+        MemoryTracker::Scope memoryScope(MemoryTag::Surfels);
+
         std::vector<std::vector<glm::vec3>> surfelGBufferData;
         surfelGBufferData.emplace_back();
         surfelGBufferData.emplace_back();
@@ -30,12 +36,16 @@ namespace EARenderer {
             surfelGBufferData[2].emplace_back(surfel.albedo.rgb());
         }
 
-        std::vector<uint32_t> surfelClusterGBufferData;
+        // Red channel: surfel offset and amount of surfels to average,
+        // green channel: length of the surfel range. Leaf clusters average every surfel,
+        // parent clusters average a strided subset of their (potentially huge) surfel range
+        std::vector<glm::uvec2> surfelClusterGBufferData;
         for (auto &cluster : mSurfelClusters) {
+            uint32_t sampleCount = std::min<uint32_t>(cluster.surfelCount, 0xFF);
             uint32_t encoded = 0;
             encoded |= cluster.surfelOffset << 8;
-            encoded |= cluster.surfelCount & 0xFF;
-            surfelClusterGBufferData.push_back(encoded);
+            encoded |= sampleCount & 0xFF;
+            surfelClusterGBufferData.emplace_back(encoded, cluster.surfelCount);
         }
 
         std::vector<glm::vec3> clusterCenters;
@@ -48,12 +58,35 @@ namespace EARenderer {
         mSurfelsGBuffer = std::make_shared<GLFloatTexture2DArray<GLTexture::Float::RGB32F>>(surfelGBufferSize, 3, surfelGbufferPointers, Sampling::Filter::None);
 
         auto clusterGBufferSize = GLTexture::EstimatedSize(surfelClusterGBufferData.size());
-        mSurfelClustersGBuffer = std::make_shared<GLIntegerTexture2D<GLTexture::Integer::R32UI>>(clusterGBufferSize, surfelClusterGBufferData.data());
+        mSurfelClustersGBuffer = std::make_shared<GLIntegerTexture2D<GLTexture::Integer::RG32UI>>(clusterGBufferSize, surfelClusterGBufferData.data());
 
         mSurfelClusterCentersBufferTexture = std::make_shared<GLFloatBufferTexture<GLTexture::Float::RGB32F, glm::vec3>>(clusterCenters.data(), clusterCenters.size());
+
+        gatherRootSurfelClusters();
+    }
+
+    void SurfelData::gatherRootSurfelClusters() {
+        std::vector<bool> hasParent(mSurfelClusters.size(), false);
+        for (auto &cluster : mSurfelClusters) {
+            if (cluster.isLeaf()) {
+                continue;
+            }
+            for (size_t i = cluster.childOffset; i < cluster.childOffset + cluster.childCount; i++) {
+                hasParent[i] = true;
+            }
+        }
+
+        mRootSurfelClusterIndices.clear();
+        for (size_t i = 0; i < mSurfelClusters.size(); i++) {
+            if (!hasParent[i]) {
+                mRootSurfelClusterIndices.push_back(uint32_t(i));
+            }
+        }
     }
 
     void SurfelData::serialize(const std::string &filePath) {
+        EA_PROFILE_SCOPE("Serialize surfels");
+
         std::ofstream stream(filePath, std::ios::trunc | std::ios::binary);
         if (!stream.is_open()) {
             throw std::runtime_error(string_format("Unable to serialize surfels: %s", filePath.c_str()));
@@ -62,10 +95,13 @@ namespace EARenderer {
         bitsery::Serializer<bitsery::OutputBufferedStreamAdapter> serializer(stream);
         serializer.container(mSurfels, mSurfels.size());
         serializer.container(mSurfelClusters, mSurfelClusters.size());
+        serializer.value4b(mLeafSurfelClusterCount);
         bitsery::AdapterAccess::getWriter(serializer).flush();
     }
 
-    bool SurfelData::deserialize(const std::string &filePath) {
+    bool SurfelData::deserialize(const std::string &filePath, bool initializesBuffers) {
+        EA_PROFILE_SCOPE("Deserialize surfels");
+
         std::ifstream stream(filePath);
         if (!stream.is_open()) {
             return false;
@@ -74,10 +110,11 @@ namespace EARenderer {
         bitsery::Deserializer<bitsery::InputStreamAdapter> deserializer(stream);
         deserializer.container(mSurfels, std::numeric_limits<uint32_t>::max());
         deserializer.container(mSurfelClusters, std::numeric_limits<uint32_t>::max());
+        deserializer.value4b(mLeafSurfelClusterCount);
 
         auto &reader = bitsery::AdapterAccess::getReader(deserializer);
 
-        if (reader.isCompletedSuccessfully()) {
+        if (reader.isCompletedSuccessfully() && initializesBuffers) {
             initializeBuffers();
         }
 
@@ -86,11 +123,11 @@ namespace EARenderer {
 
 #pragma mark - Getters
 
-    const std::vector<Surfel> &SurfelData::surfels() const {
+    const SurfelData::SurfelVector &SurfelData::surfels() const {
         return mSurfels;
     }
 
-    const std::vector<SurfelCluster> &SurfelData::surfelClusters() const {
+    const SurfelData::SurfelClusterVector &SurfelData::surfelClusters() const {
         return mSurfelClusters;
     }
 
@@ -98,7 +135,15 @@ namespace EARenderer {
         return mSurfelsGBuffer;
     }
 
-    std::shared_ptr<GLIntegerTexture2D<GLTexture::Integer::R32UI>> SurfelData::surfelClustersGBuffer() const {
+    uint32_t SurfelData::leafSurfelClusterCount() const {
+        return mLeafSurfelClusterCount;
+    }
+
+    const SurfelData::IndexVector &SurfelData::rootSurfelClusterIndices() const {
+        return mRootSurfelClusterIndices;
+    }
+
+    std::shared_ptr<GLIntegerTexture2D<GLTexture::Integer::RG32UI>> SurfelData::surfelClustersGBuffer() const {
         return mSurfelClustersGBuffer;
     }
 
@@ -14,6 +14,7 @@
 #include "GLTexture2D.hpp"
 #include "GLTexture2DArray.hpp"
 #include "GLBufferTexture.hpp"
+#include "TaggedAllocator.hpp"
 
 #include <vector>
 #include <memory>
@@ -23,30 +24,58 @@ namespace EARenderer {
     class SurfelGenerator;
 
     class SurfelData {
+    public:
+        using SurfelVector = TaggedVector<Surfel, MemoryTag::Surfels>;
+        using SurfelClusterVector = TaggedVector<SurfelCluster, MemoryTag::Surfels>;
+        using IndexVector = TaggedVector<uint32_t, MemoryTag::Surfels>;
+
     private:
         friend SurfelGenerator;
 
-        std::vector<Surfel> mSurfels;
-        std::vector<SurfelCluster> mSurfelClusters;
+        SurfelVector mSurfels;
+        SurfelClusterVector mSurfelClusters;
+        IndexVector mRootSurfelClusterIndices;
+        uint32_t mLeafSurfelClusterCount = 0;
 
         std::shared_ptr<GLFloatTexture2DArray<GLTexture::Float::RGB32F>> mSurfelsGBuffer;
-        std::shared_ptr<GLIntegerTexture2D<GLTexture::Integer::R32UI>> mSurfelClustersGBuffer;
+        std::shared_ptr<GLIntegerTexture2D<GLTexture::Integer::RG32UI>> mSurfelClustersGBuffer;
         std::shared_ptr<GLFloatBufferTexture<GLTexture::Float::RGB32F, glm::vec3>> mSurfelClusterCentersBufferTexture;
 
+        void gatherRootSurfelClusters();
+
     public:
         void initializeBuffers();
 
         void serialize(const std::string &filePath);
 
-        bool deserialize(const std::string &filePath);
+        /**
+         @param filePath path of a file written by serialize()
+         @param initializesBuffers false to leave GPU buffers to a later initializeBuffers() call,
+         which allows reading on threads without a GL context
+         @return true if the file was read successfully
+         */
+        bool deserialize(const std::string &filePath, bool initializesBuffers = true);
+
+        const SurfelVector &surfels() const;
+
+        /**
+         @return all clusters of the hierarchy: leaf clusters first, followed by parent clusters level by level
+         */
+        const SurfelClusterVector &surfelClusters() const;
 
-        const std::vector<Surfel> &surfels() const;
+        /**
+         @return amount of leaf clusters, which occupy the beginning of the cluster list
+         */
+        uint32_t leafSurfelClusterCount() const;
 
-        const std::vector<SurfelCluster> &surfelClusters() const;
+        /**
+         @return indices of clusters that have no parent
+         */
+        const IndexVector &rootSurfelClusterIndices() const;
 
         std::shared_ptr<GLFloatTexture2DArray<GLTexture::Float::RGB32F>> surfelsGBuffer() const;
 
-        std::shared_ptr<GLIntegerTexture2D<GLTexture::Integer::R32UI>> surfelClustersGBuffer() const;
+        std::shared_ptr<GLIntegerTexture2D<GLTexture::Integer::RG32UI>> surfelClustersGBuffer() const;
 
         std::shared_ptr<GLFloatBufferTexture<GLTexture::Float::RGB32F, glm::vec3>> surfelClusterCentersBufferTexture() const;
     };
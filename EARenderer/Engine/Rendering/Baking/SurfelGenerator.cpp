@@ -15,9 +15,12 @@
 #include "ThreadPool.hpp"
 #include "SparseOctree.hpp"
 #include "GaussianFunction.hpp"
+#include "Profiler.hpp"
+#include "MemoryArena.hpp"
 
 #include <random>
 #include <limits>
+#include <algorithm>
 
 #include <glm/detail/func_exponential.hpp>
 
@@ -98,7 +101,12 @@ namespace EARenderer {
         float minimumArea = std::numeric_limits<float>::max();
         float maximumArea = std::numeric_limits<float>::lowest();
 
-        std::vector<TransformedTriangleData> transformedTriangleProperties;
+        // Per sub mesh scratch, released before the next sub mesh is processed
+        MemoryArena &arena = MemoryArena::ThreadLocal();
+        MemoryArena::Scope arenaScope(arena);
+
+        ArenaVector<TransformedTriangleData> transformedTriangleProperties(arena);
+        transformedTriangleProperties.reserve(subMesh.vertices().size() / 3);
 
         // Calculate triangle areas, transform positions and normals using
         // mesh instance's model transformation
@@ -144,6 +152,7 @@ namespace EARenderer {
         maximumArea = std::max(maximumArea, optimalArea);
 
         LogarithmicBin<TransformedTriangleData> bin(minimumArea, maximumArea);
+        bin.seed(mEngine());
 
         for (auto &transformedTriangle : transformedTriangleProperties) {
             bin.insert(transformedTriangle, minimumAreaTruncated ? minimumArea : transformedTriangle.positions.area());
@@ -225,6 +234,8 @@ namespace EARenderer {
     }
 
     void SurfelGenerator::generateSurflesOnMeshInstance(const MeshInstance &instance) {
+        EA_PROFILE_SCOPE("Generate surfels on mesh instance");
+
         const auto &mesh = mResourcePool->mesh(instance.meshID());
 
         for (ID subMeshID : mesh.subMeshes()) {
@@ -255,8 +266,8 @@ namespace EARenderer {
                 // It then chooses a random point p on the triangle and makes it a surfel candidate.
                 SurfelCandidate surfelCandidate = generateSurfelCandidate(subMesh, bin);
 
-                // Get rid of triangles that lie outside of scene's baking volume
-                if (!mScene->lightBakingVolume().contains(surfelCandidate.position)) {
+                // Get rid of triangles that lie outside of the baking volume
+                if (!mWorkingVolume.contains(surfelCandidate.position)) {
                     bin.erase(surfelCandidate.logarithmicBinIterator);
                     continue;
                 }
@@ -322,8 +333,13 @@ namespace EARenderer {
     }
 
     void SurfelGenerator::formClusters() {
-        std::vector<ID> idsToDelete;
-        float extent2 = mScene->lightBakingVolume().largestDimensionLength() * mScene->lightBakingVolume().largestDimensionLength();
+        EA_PROFILE_SCOPE("Form surfel clusters");
+
+        MemoryArena &arena = MemoryArena::ThreadLocal();
+        MemoryArena::Scope arenaScope(arena);
+
+        ArenaVector<ID> idsToDelete(arena);
+        float extent2 = mWorkingVolume.largestDimensionLength() * mWorkingVolume.largestDimensionLength();
 
         while (mSurfelFlatStorage.size()) {
             // Allocate cluster with count of 1 since we're immediately inserting 1 surfel
@@ -379,19 +395,166 @@ namespace EARenderer {
         }
     }
 
+    uint32_t SurfelGenerator::mortonCode(const glm::vec3 &position) const {
+        const AxisAlignedBox3D &volume = mWorkingVolume;
+        glm::vec3 normalized = (position - volume.min) / glm::max(volume.max - volume.min, glm::vec3(1e-6));
+        glm::uvec3 cell = glm::clamp(normalized * 1024.0f, glm::vec3(0.0), glm::vec3(1023.0));
+
+        // Spread 10 bits of each coordinate apart, leaving 2 zero bits between them
+        auto spread = [](uint32_t v) {
+            v = (v * 0x00010001u) & 0xFF0000FFu;
+            v = (v * 0x00000101u) & 0x0F00F00Fu;
+            v = (v * 0x00000011u) & 0xC30C30C3u;
+            v = (v * 0x00000005u) & 0x49249249u;
+            return v;
+        };
+
+        return spread(cell.x) | (spread(cell.y) << 1) | (spread(cell.z) << 2);
+    }
+
+    void SurfelGenerator::formClusterHierarchy() {
+        EA_PROFILE_SCOPE("Form surfel cluster hierarchy");
+
+        auto &surfels = mSurfelDataContainer->mSurfels;
+        auto &clusters = mSurfelDataContainer->mSurfelClusters;
+
+        for (auto &cluster : clusters) {
+            for (size_t i = cluster.surfelOffset; i < cluster.surfelOffset + cluster.surfelCount; i++) {
+                cluster.aggregate(surfels[i]);
+            }
+        }
+
+        // Reorder leaf clusters (and their surfels) along a Morton curve.
+        // Merging neighbours in this order keeps clusters spatially compact
+        // and keeps surfels of any parent cluster in a single contiguous range
+        MemoryArena &arena = MemoryArena::ThreadLocal();
+        MemoryArena::Scope arenaScope(arena);
+
+        ArenaVector<std::pair<uint32_t, size_t>> order(arena);
+        order.reserve(clusters.size());
+        for (size_t i = 0; i < clusters.size(); i++) {
+            order.emplace_back(mortonCode(clusters[i].bounds.center()), i);
+        }
+        std::sort(order.begin(), order.end());
+
+        SurfelData::SurfelVector orderedSurfels;
+        SurfelData::SurfelClusterVector orderedClusters;
+        orderedSurfels.reserve(surfels.size());
+        orderedClusters.reserve(clusters.size());
+
+        for (auto &entry : order) {
+            SurfelCluster cluster = clusters[entry.second];
+            uint32_t offset = uint32_t(orderedSurfels.size());
+            orderedSurfels.insert(orderedSurfels.end(), surfels.begin() + cluster.surfelOffset, surfels.begin() + cluster.surfelOffset + cluster.surfelCount);
+            cluster.surfelOffset = offset;
+            orderedClusters.push_back(cluster);
+        }
+
+        surfels = std::move(orderedSurfels);
+        clusters = std::move(orderedClusters);
+        mSurfelDataContainer->mLeafSurfelClusterCount = uint32_t(clusters.size());
+
+        if (clusters.empty()) {
+            return;
+        }
+
+        float averageLeafDiagonal = 0.0;
+        for (auto &cluster : clusters) {
+            averageLeafDiagonal += cluster.bounds.diagonal();
+        }
+        averageLeafDiagonal = std::max(averageLeafDiagonal / clusters.size(), mSurfelSpacing);
+
+        size_t levelBegin = 0;
+        size_t levelEnd = clusters.size();
+
+        for (uint32_t level = 1; level <= mMaximumSurfelClusterHierarchyDepth; level++) {
+            // Parent clusters are allowed to grow twice as large with every level
+            float maximumDiagonal = averageLeafDiagonal * float(1u << (level + 1));
+
+            size_t i = levelBegin;
+            while (i < levelEnd) {
+                SurfelCluster parent;
+                parent.level = level;
+                parent.childOffset = uint32_t(i);
+                parent.surfelOffset = clusters[i].surfelOffset;
+                parent.aggregate(clusters[i]);
+
+                uint32_t surfelEnd = clusters[i].surfelOffset + clusters[i].surfelCount;
+
+                size_t next = i + 1;
+                while (next < levelEnd && next - i < mSurfelClusterBranchingFactor) {
+                    // Neighbours separated by a root of the previous level would capture its surfels
+                    if (clusters[next].surfelOffset != surfelEnd) {
+                        break;
+                    }
+
+                    SurfelCluster candidate = parent;
+                    candidate.aggregate(clusters[next]);
+
+                    if (candidate.bounds.diagonal() > maximumDiagonal ||
+                        candidate.normalCoherence() < mMinimumSurfelClusterNormalCoherence) {
+                        break;
+                    }
+
+                    parent = candidate;
+                    surfelEnd = clusters[next].surfelOffset + clusters[next].surfelCount;
+                    next++;
+                }
+
+                // Clusters that can't be merged with their neighbours stay roots of the hierarchy
+                if (next - i > 1) {
+                    parent.childCount = uint32_t(next - i);
+                    parent.surfelCount = surfelEnd - parent.surfelOffset;
+                    parent.center = parent.bounds.center();
+                    clusters.push_back(parent);
+                }
+
+                i = next;
+            }
+
+            levelBegin = levelEnd;
+            levelEnd = clusters.size();
+
+            if (levelEnd - levelBegin < 2) {
+                break;
+            }
+        }
+    }
+
 #pragma mark - Public interface
 
+    void SurfelGenerator::setSeed(uint32_t seed) {
+        mEngine.seed(seed);
+    }
+
     std::unique_ptr<SurfelData> SurfelGenerator::generateStaticGeometrySurfels() {
+        return generateStaticGeometrySurfels(mScene->lightBakingVolume());
+    }
+
+    std::unique_ptr<SurfelData> SurfelGenerator::generateStaticGeometrySurfels(const AxisAlignedBox3D &volume) {
+        EA_PROFILE_SCOPE("Surfel generation");
+
+        mWorkingVolume = volume;
         mSurfelDataContainer = std::make_unique<SurfelData>();
-        mSurfelSpatialHash = SpatialHash<Surfel>(mScene->lightBakingVolume(), spaceDivisionResolution(1.5, mScene->lightBakingVolume()));
+        mSurfelSpatialHash = SpatialHash<Surfel>(mWorkingVolume, spaceDivisionResolution(1.5, mWorkingVolume));
         mSurfelFlatStorage = PackedLookupTable<Surfel>(10000);
 
         for (ID meshInstanceID : mScene->staticMeshInstanceIDs()) {
             const auto &meshInstance = mScene->meshInstances()[meshInstanceID];
+
+            // Instances outside of the volume can't produce any surfels
+            if (!volume.intersects(meshInstance.boundingBox(mResourcePool->mesh(meshInstance.meshID())))) {
+                continue;
+            }
+
             generateSurflesOnMeshInstance(meshInstance);
         }
 
-        formClusters();
+        {
+            EA_PROFILE_SCOPE("Surfel clustering");
+            formClusters();
+            formClusterHierarchy();
+        }
 
         mSurfelDataContainer->initializeBuffers();
 
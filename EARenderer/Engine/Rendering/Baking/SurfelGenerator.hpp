@@ -60,12 +60,16 @@ namespace EARenderer {
 
         float mSurfelSpacing;
         size_t mMaximumSurfelClusterSize = 256;
+        size_t mSurfelClusterBranchingFactor = 8;
+        size_t mMaximumSurfelClusterHierarchyDepth = 4;
+        float mMinimumSurfelClusterNormalCoherence = 0.5;
 
         std::mt19937 mEngine;
         std::uniform_real_distribution<float> mDistribution;
         PackedLookupTable<Surfel> mSurfelFlatStorage;
         SpatialHash<Surfel> mSurfelSpatialHash;
         std::unique_ptr<SurfelData> mSurfelDataContainer;
+        AxisAlignedBox3D mWorkingVolume;
         const SharedResourceStorage *mResourcePool = nullptr;
         const Scene *mScene = nullptr;
 
@@ -163,10 +167,39 @@ namespace EARenderer {
          */
         void formClusters();
 
+        /**
+         Encodes position inside the light baking volume as a 30 bit Morton code
+
+         @param position point to encode
+         @return code preserving spatial locality when used as a sorting key
+         */
+        uint32_t mortonCode(const glm::vec3 &position) const;
+
+        /**
+         Orders leaf clusters along a Morton curve and merges neighbouring clusters bottom-up into parent clusters,
+         so that distant probes could reference a single parent instead of all of its children
+         */
+        void formClusterHierarchy();
+
     public:
         SurfelGenerator(const SharedResourceStorage *resourcePool, const Scene *scene);
 
+        /**
+         Makes subsequent generation reproducible, surfels are placed nondeterministically otherwise
+
+         @param seed seed of the random number generator
+         */
+        void setSeed(uint32_t seed);
+
         std::unique_ptr<SurfelData> generateStaticGeometrySurfels();
+
+        /**
+         Generates surfels only on static geometry located inside the volume
+
+         @param volume region of the scene to cover with surfels
+         @return surfels and surfel clusters of the volume
+         */
+        std::unique_ptr<SurfelData> generateStaticGeometrySurfels(const AxisAlignedBox3D &volume);
     };
 
 }
@@ -0,0 +1,279 @@
+//
+// Created by Pavlo Muratov on 2019-02-07.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "FrameGraph.hpp"
+#include "TransientTexturePool.hpp"
+#include "Profiler.hpp"
+#include "PassTimer.hpp"
+
+#include <stdexcept>
+#include <algorithm>
+
+namespace EARenderer {
+
+#pragma mark - Texture descriptor
+
+    bool FrameGraph::TextureDescriptor::operator==(const TextureDescriptor &rhs) const {
+        return size.width == rhs.size.width &&
+                size.height == rhs.size.height &&
+                format == rhs.format &&
+                mipMaps == rhs.mipMaps;
+    }
+
+    bool FrameGraph::TextureDescriptor::operator!=(const TextureDescriptor &rhs) const {
+        return !(rhs == *this);
+    }
+
+#pragma mark - Resource
+
+    bool FrameGraph::Resource::isValid() const {
+        return index != InvalidIndex;
+    }
+
+#pragma mark - Builder
+
+    FrameGraph::Builder::Builder(FrameGraph *graph, uint32_t passIndex)
+            : mGraph(graph), mPassIndex(passIndex) {}
+
+    FrameGraph::Resource FrameGraph::Builder::create(const std::string &name, const TextureDescriptor &descriptor) {
+        if (descriptor.size.width <= 0.0 || descriptor.size.height <= 0.0) {
+            throw std::invalid_argument("Frame graph texture '" + name + "' must not be empty");
+        }
+
+        ResourceNode node;
+        node.name = name;
+        node.descriptor = descriptor;
+        node.creator = mPassIndex;
+
+        Resource resource{static_cast<uint32_t>(mGraph->mResources.size())};
+        mGraph->mResources.push_back(node);
+        mGraph->mPasses[mPassIndex].creates.push_back(resource.index);
+        return resource;
+    }
+
+    FrameGraph::Resource FrameGraph::Builder::read(Resource resource) {
+        mGraph->validate(resource);
+        mGraph->mPasses[mPassIndex].reads.push_back(resource.index);
+        return resource;
+    }
+
+    FrameGraph::Resource FrameGraph::Builder::write(Resource resource) {
+        mGraph->validate(resource);
+        mGraph->mPasses[mPassIndex].writes.push_back(resource.index);
+        return resource;
+    }
+
+    void FrameGraph::Builder::setSideEffect() {
+        mGraph->mPasses[mPassIndex].hasSideEffect = true;
+    }
+
+#pragma mark - Resources
+
+    FrameGraph::Resources::Resources(const FrameGraph *graph, TransientTexturePool *pool)
+            : mGraph(graph), mPool(pool) {}
+
+    GLTexture &FrameGraph::Resources::physicalTexture(Resource resource, GLTexture::Float format) const {
+        mGraph->validate(resource);
+
+        const ResourceNode &node = mGraph->mResources[resource.index];
+        if (node.descriptor.format != format) {
+            throw std::invalid_argument("Frame graph texture '" + node.name + "' is requested with a wrong format");
+        }
+        if (node.physicalIndex == Resource::InvalidIndex) {
+            throw std::logic_error("Frame graph texture '" + node.name + "' is not used by any scheduled pass");
+        }
+
+        return mPool->texture(node.physicalIndex);
+    }
+
+#pragma mark - Private helpers
+
+    void FrameGraph::validate(Resource resource) const {
+        if (!resource.isValid() || resource.index >= mResources.size()) {
+            throw std::invalid_argument("Invalid frame graph resource");
+        }
+    }
+
+    void FrameGraph::cullPasses() {
+        // Walking backwards, a pass survives if it has a side effect or produces something
+        // a surviving pass consumes. Surviving passes make their inputs and outputs needed,
+        // the latter keeping earlier writers of accumulated textures alive.
+        std::vector<bool> isNeeded(mResources.size(), false);
+
+        for (auto passIt = mPasses.rbegin(); passIt != mPasses.rend(); ++passIt) {
+            PassNode &pass = *passIt;
+
+            auto needed = [&](uint32_t index) { return isNeeded[index]; };
+            pass.isAlive = pass.hasSideEffect ||
+                    std::any_of(pass.creates.begin(), pass.creates.end(), needed) ||
+                    std::any_of(pass.writes.begin(), pass.writes.end(), needed);
+
+            if (!pass.isAlive) {
+                continue;
+            }
+
+            for (uint32_t index : pass.reads) { isNeeded[index] = true; }
+            for (uint32_t index : pass.writes) { isNeeded[index] = true; }
+        }
+
+        mSchedule.clear();
+        for (uint32_t passIndex = 0; passIndex < mPasses.size(); passIndex++) {
+            if (mPasses[passIndex].isAlive) {
+                mSchedule.push_back(passIndex);
+            }
+        }
+    }
+
+    void FrameGraph::computeLifetimes() {
+        for (ResourceNode &resource : mResources) {
+            resource.firstUse = std::numeric_limits<size_t>::max();
+            resource.lastUse = 0;
+            resource.physicalIndex = Resource::InvalidIndex;
+        }
+
+        for (size_t position = 0; position < mSchedule.size(); position++) {
+            const PassNode &pass = mPasses[mSchedule[position]];
+
+            auto use = [&](uint32_t index) {
+                ResourceNode &resource = mResources[index];
+                resource.firstUse = std::min(resource.firstUse, position);
+                resource.lastUse = std::max(resource.lastUse, position);
+            };
+
+            std::for_each(pass.creates.begin(), pass.creates.end(), use);
+            std::for_each(pass.reads.begin(), pass.reads.end(), use);
+            std::for_each(pass.writes.begin(), pass.writes.end(), use);
+        }
+    }
+
+    void FrameGraph::assignPhysicalTextures() {
+        mPhysicalTextures.clear();
+
+        std::vector<std::vector<uint32_t>> releasesPerPosition(mSchedule.size());
+        std::vector<uint32_t> freePhysicalTextures;
+
+        for (size_t position = 0; position < mSchedule.size(); position++) {
+            const PassNode &pass = mPasses[mSchedule[position]];
+
+            // A texture is always first used by the pass creating it
+            for (uint32_t index : pass.creates) {
+                ResourceNode &resource = mResources[index];
+
+                auto freeIt = std::find_if(freePhysicalTextures.rbegin(), freePhysicalTextures.rend(), [&](uint32_t physicalIndex) {
+                    return mPhysicalTextures[physicalIndex] == resource.descriptor;
+                });
+
+                if (freeIt != freePhysicalTextures.rend()) {
+                    resource.physicalIndex = *freeIt;
+                    freePhysicalTextures.erase(std::next(freeIt).base());
+                } else {
+                    resource.physicalIndex = static_cast<uint32_t>(mPhysicalTextures.size());
+                    mPhysicalTextures.push_back(resource.descriptor);
+                }
+
+                releasesPerPosition[resource.lastUse].push_back(resource.physicalIndex);
+            }
+
+            // Textures are released after all textures of the pass are allocated,
+            // so that scratch textures of a single pass never share storage
+            for (uint32_t physicalIndex : releasesPerPosition[position]) {
+                freePhysicalTextures.push_back(physicalIndex);
+            }
+        }
+    }
+
+#pragma mark - Public interface
+
+    void FrameGraph::addPass(const std::string &name, const Setup &setup) {
+        PassNode pass;
+        pass.name = name;
+
+        uint32_t passIndex = static_cast<uint32_t>(mPasses.size());
+        mPasses.push_back(pass);
+        mIsCompiled = false;
+
+        Builder builder(this, passIndex);
+        mPasses[passIndex].execute = setup(builder);
+    }
+
+    void FrameGraph::compile() {
+        EA_PROFILE_SCOPE("Compile frame graph");
+
+        cullPasses();
+        computeLifetimes();
+        assignPhysicalTextures();
+
+        for (uint32_t passIndex : mSchedule) {
+            mPasses[passIndex].profilerName = Profiler::shared().intern(mPasses[passIndex].name);
+        }
+
+        mIsCompiled = true;
+    }
+
+    void FrameGraph::execute(TransientTexturePool &pool, PassTimer *timer) {
+        if (!mIsCompiled) {
+            compile();
+        }
+
+        pool.realize(mPhysicalTextures);
+
+        Resources resources(this, &pool);
+        for (uint32_t passIndex : mSchedule) {
+            const PassNode &pass = mPasses[passIndex];
+            EA_PROFILE_SCOPE(pass.profilerName);
+
+            if (timer) timer->beginPass(pass.name);
+            pass.execute(resources);
+            if (timer) timer->endPass();
+        }
+    }
+
+    void FrameGraph::reset() {
+        mPasses.clear();
+        mResources.clear();
+        mSchedule.clear();
+        mPhysicalTextures.clear();
+        mIsCompiled = false;
+    }
+
+#pragma mark - Getters
+
+    bool FrameGraph::isCompiled() const {
+        return mIsCompiled;
+    }
+
+    const std::vector<uint32_t> &FrameGraph::schedule() const {
+        return mSchedule;
+    }
+
+    const std::vector<FrameGraph::TextureDescriptor> &FrameGraph::physicalTextures() const {
+        return mPhysicalTextures;
+    }
+
+    const std::string &FrameGraph::passName(uint32_t passIndex) const {
+        return mPasses.at(passIndex).name;
+    }
+
+    bool FrameGraph::isPassAlive(uint32_t passIndex) const {
+        return mPasses.at(passIndex).isAlive;
+    }
+
+    uint32_t FrameGraph::physicalIndex(Resource resource) const {
+        validate(resource);
+        return mResources[resource.index].physicalIndex;
+    }
+
+    FrameGraph::Statistics FrameGraph::statistics() const {
+        Statistics statistics;
+        statistics.passCount = mPasses.size();
+        statistics.culledPassCount = mPasses.size() - mSchedule.size();
+        statistics.transientTextureCount = std::count_if(mResources.begin(), mResources.end(), [](const ResourceNode &resource) {
+            return resource.physicalIndex != Resource::InvalidIndex;
+        });
+        statistics.physicalTextureCount = mPhysicalTextures.size();
+        return statistics;
+    }
+
+}
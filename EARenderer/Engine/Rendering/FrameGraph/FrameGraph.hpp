@@ -0,0 +1,221 @@
+//
+// Created by Pavlo Muratov on 2019-02-07.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_FRAMEGRAPH_HPP
+#define EARENDERER_FRAMEGRAPH_HPP
+
+#include "GLTexture2D.hpp"
+#include "Size2D.hpp"
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <limits>
+
+namespace EARenderer {
+
+    class TransientTexturePool;
+
+    class PassTimer;
+
+    /**
+     Declarative description of a frame.
+
+     Passes are added in execution order and declare which textures they create, read and write.
+     Compilation culls passes that contribute neither to a side effect nor to a pass with one,
+     computes lifetimes of transient textures and assigns them to physical textures, so that textures
+     whose lifetimes do not overlap share the same storage. Compilation does not touch OpenGL.
+
+     Physical textures are reused only between textures with identical descriptors:
+     OpenGL does not allow memory of one texture to back a texture of a different format or size.
+     */
+    class FrameGraph {
+    public:
+
+#pragma mark - Nested types
+
+        struct TextureDescriptor {
+            Size2D size;
+            GLTexture::Float format = GLTexture::Float::RGBA16F;
+            bool mipMaps = false;
+
+            bool operator==(const TextureDescriptor &rhs) const;
+
+            bool operator!=(const TextureDescriptor &rhs) const;
+        };
+
+        struct Resource {
+            static constexpr uint32_t InvalidIndex = std::numeric_limits<uint32_t>::max();
+
+            uint32_t index = InvalidIndex;
+
+            bool isValid() const;
+        };
+
+        /**
+         Handed to a pass' setup closure to declare resources used by the pass
+         */
+        class Builder {
+        private:
+            friend FrameGraph;
+
+            FrameGraph *mGraph;
+            uint32_t mPassIndex;
+
+            Builder(FrameGraph *graph, uint32_t passIndex);
+
+        public:
+            /**
+             Declares a new transient texture written by the pass
+
+             @param name debug name of the texture
+             @param descriptor size and format of the texture
+             @return handle of the texture
+             */
+            Resource create(const std::string &name, const TextureDescriptor &descriptor);
+
+            Resource read(Resource resource);
+
+            /**
+             Declares a write into an existing texture. Writes are treated as accumulation,
+             so earlier writers of the same texture are kept alive as long as the pass is.
+             */
+            Resource write(Resource resource);
+
+            /**
+             Prevents the pass from being culled, e.g. when it renders into the default framebuffer
+             */
+            void setSideEffect();
+        };
+
+        /**
+         Handed to a pass' execute closure to access physical textures
+         */
+        class Resources {
+        private:
+            friend FrameGraph;
+
+            const FrameGraph *mGraph;
+            TransientTexturePool *mPool;
+
+            Resources(const FrameGraph *graph, TransientTexturePool *pool);
+
+            GLTexture &physicalTexture(Resource resource, GLTexture::Float format) const;
+
+        public:
+            template<GLTexture::Float Format>
+            GLFloatTexture2D<Format> &texture(Resource resource) const;
+        };
+
+        using Execute = std::function<void(const Resources &resources)>;
+        using Setup = std::function<Execute(Builder &builder)>;
+
+        struct Statistics {
+            size_t passCount = 0;
+            size_t culledPassCount = 0;
+            size_t transientTextureCount = 0;
+            size_t physicalTextureCount = 0;
+        };
+
+    private:
+        struct PassNode {
+            std::string name;
+            // Interned on compilation, so that profiling zones of executed passes don't look names up every frame
+            const char *profilerName = nullptr;
+            Execute execute;
+            std::vector<uint32_t> creates;
+            std::vector<uint32_t> reads;
+            std::vector<uint32_t> writes;
+            bool hasSideEffect = false;
+            bool isAlive = false;
+        };
+
+        struct ResourceNode {
+            std::string name;
+            TextureDescriptor descriptor;
+            uint32_t creator = 0;
+            // Positions in the schedule
+            size_t firstUse = 0;
+            size_t lastUse = 0;
+            uint32_t physicalIndex = Resource::InvalidIndex;
+        };
+
+        std::vector<PassNode> mPasses;
+        std::vector<ResourceNode> mResources;
+        std::vector<uint32_t> mSchedule;
+        std::vector<TextureDescriptor> mPhysicalTextures;
+        bool mIsCompiled = false;
+
+        void validate(Resource resource) const;
+
+        void cullPasses();
+
+        void computeLifetimes();
+
+        void assignPhysicalTextures();
+
+    public:
+        /**
+         Adds a pass to the end of the frame
+
+         @param name debug name of the pass
+         @param setup closure declaring resources of the pass, invoked immediately. Returns a closure
+         performing the work, which is invoked during execution if the pass survives culling
+         */
+        void addPass(const std::string &name, const Setup &setup);
+
+        /**
+         Culls unused passes, computes texture lifetimes and aliases transient textures
+         */
+        void compile();
+
+        /**
+         Allocates physical textures from the pool and runs the scheduled passes in order
+
+         @param pool storage of physical textures, preserved between frames
+         @param timer optional timer bracketing every executed pass
+         */
+        void execute(TransientTexturePool &pool, PassTimer *timer = nullptr);
+
+        /**
+         Drops all passes and resources, so that the graph can be built for the next frame
+         */
+        void reset();
+
+        bool isCompiled() const;
+
+        /**
+         @return indices of passes surviving culling, in execution order
+         */
+        const std::vector<uint32_t> &schedule() const;
+
+        /**
+         @return descriptors of physical textures needed to execute the compiled graph
+         */
+        const std::vector<TextureDescriptor> &physicalTextures() const;
+
+        const std::string &passName(uint32_t passIndex) const;
+
+        bool isPassAlive(uint32_t passIndex) const;
+
+        /**
+         @param resource transient texture of a compiled graph
+         @return index of the physical texture backing the resource
+         */
+        uint32_t physicalIndex(Resource resource) const;
+
+        Statistics statistics() const;
+    };
+
+#pragma mark - Template implementation
+
+    template<GLTexture::Float Format>
+    GLFloatTexture2D<Format> &FrameGraph::Resources::texture(Resource resource) const {
+        return static_cast<GLFloatTexture2D<Format> &>(physicalTexture(resource, Format));
+    }
+
+}
+
+#endif //EARENDERER_FRAMEGRAPH_HPP
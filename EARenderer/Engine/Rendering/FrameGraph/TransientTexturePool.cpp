@@ -0,0 +1,94 @@
+//
+// Created by Pavlo Muratov on 2019-02-07.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "TransientTexturePool.hpp"
+#include "GLTexture2D.hpp"
+#include "MemoryTracker.hpp"
+
+#include <stdexcept>
+#include <algorithm>
+
+namespace EARenderer {
+
+#pragma mark - Private helpers
+
+    std::unique_ptr<GLTexture> TransientTexturePool::MakeTexture(const FrameGraph::TextureDescriptor &descriptor) {
+        std::unique_ptr<GLTexture> texture;
+
+        switch (descriptor.format) {
+            case GLTexture::Float::R16F:
+                texture = std::make_unique<GLFloatTexture2D<GLTexture::Float::R16F>>(descriptor.size);
+                break;
+
+            case GLTexture::Float::RG16F:
+                texture = std::make_unique<GLFloatTexture2D<GLTexture::Float::RG16F>>(descriptor.size);
+                break;
+
+            case GLTexture::Float::RGB16F:
+                texture = std::make_unique<GLFloatTexture2D<GLTexture::Float::RGB16F>>(descriptor.size);
+                break;
+
+            case GLTexture::Float::RGBA16F:
+                texture = std::make_unique<GLFloatTexture2D<GLTexture::Float::RGBA16F>>(descriptor.size);
+                break;
+
+            case GLTexture::Float::R32F:
+                texture = std::make_unique<GLFloatTexture2D<GLTexture::Float::R32F>>(descriptor.size);
+                break;
+
+            case GLTexture::Float::RG32F:
+                texture = std::make_unique<GLFloatTexture2D<GLTexture::Float::RG32F>>(descriptor.size);
+                break;
+
+            case GLTexture::Float::RGB32F:
+                texture = std::make_unique<GLFloatTexture2D<GLTexture::Float::RGB32F>>(descriptor.size);
+                break;
+
+            case GLTexture::Float::RGBA32F:
+                texture = std::make_unique<GLFloatTexture2D<GLTexture::Float::RGBA32F>>(descriptor.size);
+                break;
+        }
+
+        if (descriptor.mipMaps) {
+            texture->generateMipMaps();
+        }
+
+        return texture;
+    }
+
+#pragma mark - Public interface
+
+    void TransientTexturePool::realize(const std::vector<FrameGraph::TextureDescriptor> &descriptors) {
+        MemoryTracker::Scope memoryScope(MemoryTag::FrameGraph);
+        std::vector<Entry> entries;
+        entries.reserve(descriptors.size());
+
+        for (auto &descriptor : descriptors) {
+            auto reusableIt = std::find_if(mEntries.begin(), mEntries.end(), [&](const Entry &entry) {
+                return entry.texture && entry.descriptor == descriptor;
+            });
+
+            if (reusableIt != mEntries.end()) {
+                entries.push_back(std::move(*reusableIt));
+            } else {
+                entries.push_back(Entry{descriptor, MakeTexture(descriptor)});
+            }
+        }
+
+        mEntries = std::move(entries);
+    }
+
+    GLTexture &TransientTexturePool::texture(size_t physicalIndex) const {
+        if (physicalIndex >= mEntries.size()) {
+            throw std::out_of_range("Transient texture pool has not been realized for the requested texture");
+        }
+        return *mEntries[physicalIndex].texture;
+    }
+
+    size_t TransientTexturePool::textureCount() const {
+        return mEntries.size();
+    }
+
+}
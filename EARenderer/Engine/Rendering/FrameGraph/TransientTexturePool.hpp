@@ -0,0 +1,48 @@
+//
+// Created by Pavlo Muratov on 2019-02-07.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_TRANSIENTTEXTUREPOOL_HPP
+#define EARENDERER_TRANSIENTTEXTUREPOOL_HPP
+
+#include "FrameGraph.hpp"
+#include "GLTexture.hpp"
+
+#include <vector>
+#include <memory>
+
+namespace EARenderer {
+
+    /**
+     Owns physical textures of a compiled frame graph.
+     Textures are kept between frames and recreated only when the set of required descriptors changes.
+     */
+    class TransientTexturePool {
+    private:
+        struct Entry {
+            FrameGraph::TextureDescriptor descriptor;
+            std::unique_ptr<GLTexture> texture;
+        };
+
+        std::vector<Entry> mEntries;
+
+        static std::unique_ptr<GLTexture> MakeTexture(const FrameGraph::TextureDescriptor &descriptor);
+
+    public:
+        /**
+         Makes the pool hold exactly one texture per descriptor, in the same order.
+         Existing textures with matching descriptors are reused, the rest are released.
+
+         @param descriptors physical textures of a compiled frame graph
+         */
+        void realize(const std::vector<FrameGraph::TextureDescriptor> &descriptors);
+
+        GLTexture &texture(size_t physicalIndex) const;
+
+        size_t textureCount() const;
+    };
+
+}
+
+#endif //EARENDERER_TRANSIENTTEXTUREPOOL_HPP
@@ -13,28 +13,28 @@ namespace EARenderer {
 
 #pragma mark - Lifecycle
 
-    BloomEffect::BloomEffect(GLFramebuffer *sharedFramebuffer, PostprocessTexturePool *sharedTexturePool)
-            : PostprocessEffect(sharedFramebuffer, sharedTexturePool),
-              mSmallBlurEffect(sharedFramebuffer, sharedTexturePool),
-              mMediumBlurEffect(sharedFramebuffer, sharedTexturePool),
-              mLargeBlurEffect(sharedFramebuffer, sharedTexturePool) {
+    BloomEffect::BloomEffect(GLFramebuffer *sharedFramebuffer)
+            : PostprocessEffect(sharedFramebuffer),
+              mSmallBlurEffect(sharedFramebuffer),
+              mMediumBlurEffect(sharedFramebuffer),
+              mLargeBlurEffect(sharedFramebuffer) {
     }
 
 #pragma mark - Bloom
 
     void BloomEffect::bloom(
-            const PostprocessTexturePool::PostprocessTexture &baseImage,
-            PostprocessTexturePool::PostprocessTexture &thresholdFilteredImage,
-            PostprocessTexturePool::PostprocessTexture &outputImage,
+            const PostprocessTexture &baseImage,
+            PostprocessTexture &thresholdFilteredImage,
+            PostprocessTexture &blurredImage,
+            PostprocessTexture &intermediateImage,
+            PostprocessTexture &outputImage,
             const BloomSettings &settings) {
 
         thresholdFilteredImage.generateMipMaps();
 
-        auto blurTexture = mTexturePool->claim();
-
-        mSmallBlurEffect.blur(thresholdFilteredImage, *blurTexture, settings.smallBlurSettings);
-        mMediumBlurEffect.blur(thresholdFilteredImage, *blurTexture, settings.mediumBlurSettings);
-        mLargeBlurEffect.blur(thresholdFilteredImage, *blurTexture, settings.largeBlurSettings);
+        mSmallBlurEffect.blur(thresholdFilteredImage, intermediateImage, blurredImage, settings.smallBlurSettings);
+        mMediumBlurEffect.blur(thresholdFilteredImage, intermediateImage, blurredImage, settings.mediumBlurSettings);
+        mLargeBlurEffect.blur(thresholdFilteredImage, intermediateImage, blurredImage, settings.largeBlurSettings);
 
         float totalWeight = settings.smallBlurWeight + settings.mediumBlurWeight + settings.largeBlurWeight;
         float smallBlurWeightNorm = settings.smallBlurWeight / totalWeight * settings.bloomStrength;
@@ -43,14 +43,12 @@ namespace EARenderer {
 
         mBloomShader.bind();
         mBloomShader.ensureSamplerValidity([&]() {
-            mBloomShader.setTextures(baseImage, *blurTexture);
+            mBloomShader.setTextures(baseImage, blurredImage);
             mBloomShader.setTextureWeights(smallBlurWeightNorm, mediumBlurWeightNorm, largeBlurWeightNorm);
         });
 
         mFramebuffer->redirectRenderingToTextures(GLFramebuffer::UnderlyingBuffer::None, &outputImage);
         Drawable::TriangleStripQuad::Draw();
-
-        mTexturePool->putBack(blurTexture);
     }
 
 }
@@ -29,12 +29,22 @@ namespace EARenderer {
         GLSLBloom mBloomShader;
 
     public:
-        BloomEffect(GLFramebuffer *sharedFramebuffer, PostprocessTexturePool *sharedTexturePool);
-
+        BloomEffect(GLFramebuffer *sharedFramebuffer);
+
+        /**
+         @param baseImage image the bloom is added to
+         @param thresholdFilteredImage bright parts of the image, mip maps are regenerated
+         @param blurredImage scratch image with mip maps receiving blurred bright parts
+         @param intermediateImage scratch image with mip maps used by the blur
+         @param outputImage image receiving the result
+         @param settings bloom settings
+         */
         void bloom(
-                const PostprocessTexturePool::PostprocessTexture &baseImage,
-                PostprocessTexturePool::PostprocessTexture &thresholdFilteredImage,
-                PostprocessTexturePool::PostprocessTexture &outputImage,
+                const PostprocessTexture &baseImage,
+                PostprocessTexture &thresholdFilteredImage,
+                PostprocessTexture &blurredImage,
+                PostprocessTexture &intermediateImage,
+                PostprocessTexture &outputImage,
                 const BloomSettings &settings
         );
     };
@@ -55,16 +55,15 @@ namespace EARenderer {
     }
 
     void GaussianBlurEffect::blur(
-            const PostprocessTexturePool::PostprocessTexture &inputImage,
-            PostprocessTexturePool::PostprocessTexture &outputImage,
+            const PostprocessTexture &inputImage,
+            PostprocessTexture &intermediateImage,
+            PostprocessTexture &outputImage,
             const GaussianBlurSettings &settings) {
 
         if (settings.radius == 0) throw std::invalid_argument("Blur radius must be greater than 0");
 
         computeWeightsAndOffsetsIfNeeded(settings);
 
-        auto intermediateTexture = mTexturePool->claim();
-
         mBlurShader.bind();
         mBlurShader.setRenderTargetSize(inputImage.mipMapSize(settings.outputImageMipLevel));
         mBlurShader.setKernelWeights(mWeights);
@@ -78,7 +77,7 @@ namespace EARenderer {
         //
         mBlurShader.setBlurDirection(GLSLGaussianBlur::BlurDirection::Horizontal);
 
-        mFramebuffer->redirectRenderingToTexturesMip(settings.outputImageMipLevel, GLFramebuffer::UnderlyingBuffer::None, intermediateTexture);
+        mFramebuffer->redirectRenderingToTexturesMip(settings.outputImageMipLevel, GLFramebuffer::UnderlyingBuffer::None, &intermediateImage);
         Drawable::TriangleStripQuad::Draw();
 
         // But, in the second pass, we read and write from and to the same
@@ -87,14 +86,12 @@ namespace EARenderer {
         mBlurShader.setBlurDirection(GLSLGaussianBlur::BlurDirection::Vertical);
 
         mBlurShader.ensureSamplerValidity([&]() {
-            mBlurShader.setTexture(*intermediateTexture, settings.outputImageMipLevel);
+            mBlurShader.setTexture(intermediateImage, settings.outputImageMipLevel);
         });
 
         mFramebuffer->redirectRenderingToTexturesMip(settings.outputImageMipLevel, GLFramebuffer::UnderlyingBuffer::None, &outputImage);
 
         Drawable::TriangleStripQuad::Draw();
-
-        mTexturePool->putBack(intermediateTexture);
     }
 
 }
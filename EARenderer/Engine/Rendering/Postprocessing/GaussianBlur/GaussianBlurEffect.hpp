@@ -32,9 +32,19 @@ namespace EARenderer {
     public:
         using PostprocessEffect::PostprocessEffect;
 
+        /**
+         Separable blur
+
+         @param inputImage image to blur
+         @param intermediateImage scratch image holding the result of the horizontal pass,
+         must have mip maps when blurring into a mip level other than 0
+         @param outputImage image receiving the result, may be the same as the input image
+         @param settings radius, sigma and mip levels to read from and write to
+         */
         void blur(
-                const PostprocessTexturePool::PostprocessTexture &inputImage,
-                PostprocessTexturePool::PostprocessTexture &outputImage,
+                const PostprocessTexture &inputImage,
+                PostprocessTexture &intermediateImage,
+                PostprocessTexture &outputImage,
                 const GaussianBlurSettings &settings
         );
     };
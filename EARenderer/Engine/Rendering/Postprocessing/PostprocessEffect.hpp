@@ -11,20 +11,25 @@
 
 #include "GLFramebuffer.hpp"
 #include "GLTexture2D.hpp"
-#include "PostprocessTexturePool.hpp"
 
 #include <memory>
 
 namespace EARenderer {
 
+    /**
+     Base of full screen effects. Effects own no intermediate images:
+     every texture they render into is passed in, usually allocated by a frame graph.
+     */
     class PostprocessEffect {
+    public:
+        using PostprocessTexture = GLFloatTexture2D<GLTexture::Float::RGBA16F>;
+
     protected:
         GLFramebuffer *mFramebuffer;
-        PostprocessTexturePool *mTexturePool;
 
     public:
-        PostprocessEffect(GLFramebuffer *sharedFramebuffer, PostprocessTexturePool *sharedTexturePool)
-                : mFramebuffer(sharedFramebuffer), mTexturePool(sharedTexturePool) {}
+        PostprocessEffect(GLFramebuffer *sharedFramebuffer)
+                : mFramebuffer(sharedFramebuffer) {}
     };
 
 }
@@ -18,53 +18,51 @@ namespace EARenderer {
 
 #pragma mark - Lifecycle
 
-    SMAAEffect::SMAAEffect(GLFramebuffer *sharedFramebuffer, PostprocessTexturePool *sharedTexturePool)
-            : PostprocessEffect(sharedFramebuffer, sharedTexturePool),
+    SMAAEffect::SMAAEffect(GLFramebuffer *sharedFramebuffer)
+            : PostprocessEffect(sharedFramebuffer),
               mAreaTexture(Size2D(AREATEX_WIDTH, AREATEX_HEIGHT), areaTexBytes),
-              mSearchTexture(Size2D(SEARCHTEX_WIDTH, SEARCHTEX_HEIGHT), searchTexBytes),
-              mEdgesTexture(sharedFramebuffer->size()),
-              mBlendTexture(sharedFramebuffer->size()) {
+              mSearchTexture(Size2D(SEARCHTEX_WIDTH, SEARCHTEX_HEIGHT), searchTexBytes) {
     }
 
 #pragma mark - Antialiasing
 
-    void SMAAEffect::detectEdges(const PostprocessTexturePool::PostprocessTexture &image) {
+    void SMAAEffect::detectEdges(const PostprocessTexture &image, EdgesTexture &edges) {
         mEdgeDetectionShader.bind();
         mEdgeDetectionShader.ensureSamplerValidity([&]() {
             mEdgeDetectionShader.setImage(image);
         });
 
-        mFramebuffer->redirectRenderingToTextures(GLFramebuffer::UnderlyingBuffer::Color, &mEdgesTexture);
+        mFramebuffer->redirectRenderingToTextures(GLFramebuffer::UnderlyingBuffer::Color, &edges);
         Drawable::TriangleStripQuad::Draw();
     }
 
-    void SMAAEffect::calculateBlendingWeights() {
+    void SMAAEffect::calculateBlendingWeights(const EdgesTexture &edges, PostprocessTexture &blendingWeights) {
         mBlendingWeightCalculationShader.bind();
         mBlendingWeightCalculationShader.ensureSamplerValidity([&]() {
-            mBlendingWeightCalculationShader.setEdgesTexture(mEdgesTexture);
+            mBlendingWeightCalculationShader.setEdgesTexture(edges);
             mBlendingWeightCalculationShader.setAreaTexture(mAreaTexture);
             mBlendingWeightCalculationShader.setSearchTexture(mSearchTexture);
         });
 
-        mFramebuffer->redirectRenderingToTextures(GLFramebuffer::UnderlyingBuffer::Color, &mBlendTexture);
+        mFramebuffer->redirectRenderingToTextures(GLFramebuffer::UnderlyingBuffer::Color, &blendingWeights);
         Drawable::TriangleStripQuad::Draw();
     }
 
-    void SMAAEffect::blendNeighbors(const PostprocessTexturePool::PostprocessTexture &image, PostprocessTexturePool::PostprocessTexture &outputImage) {
+    void SMAAEffect::blendNeighbors(const PostprocessTexture &image, const PostprocessTexture &blendingWeights, PostprocessTexture &outputImage) {
         mNeighborhoodBlendingShader.bind();
         mNeighborhoodBlendingShader.ensureSamplerValidity([&]() {
             mNeighborhoodBlendingShader.setImage(image);
-            mNeighborhoodBlendingShader.setBlendingWeights(mBlendTexture);
+            mNeighborhoodBlendingShader.setBlendingWeights(blendingWeights);
         });
 
         mFramebuffer->redirectRenderingToTextures(GLFramebuffer::UnderlyingBuffer::None, &outputImage);
         Drawable::TriangleStripQuad::Draw();
     }
 
-    void SMAAEffect::antialise(const PostprocessTexturePool::PostprocessTexture &inputImage, PostprocessTexturePool::PostprocessTexture &outputImage) {
-        detectEdges(inputImage);
-        calculateBlendingWeights();
-        blendNeighbors(inputImage, outputImage);
+    void SMAAEffect::antialise(const PostprocessTexture &inputImage, EdgesTexture &edges, PostprocessTexture &blendingWeights, PostprocessTexture &outputImage) {
+        detectEdges(inputImage, edges);
+        calculateBlendingWeights(edges, blendingWeights);
+        blendNeighbors(inputImage, blendingWeights, outputImage);
     }
 
 }
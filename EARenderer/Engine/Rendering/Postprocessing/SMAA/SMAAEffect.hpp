@@ -18,26 +18,33 @@
 namespace EARenderer {
 
     class SMAAEffect : public PostprocessEffect {
+    public:
+        using EdgesTexture = GLFloatTexture2D<GLTexture::Float::RG16F>;
+
     private:
         GLNormalizedTexture2D<GLTexture::Normalized::RG> mAreaTexture;
         GLNormalizedTexture2D<GLTexture::Normalized::R> mSearchTexture;
-        GLFloatTexture2D<GLTexture::Float::RG16F> mEdgesTexture;
-        GLFloatTexture2D<GLTexture::Float::RGBA16F> mBlendTexture;
 
         GLSLSMAAEdgeDetection mEdgeDetectionShader;
         GLSLSMAABlendingWeightCalculation mBlendingWeightCalculationShader;
         GLSLSMAANeighborhoodBlending mNeighborhoodBlendingShader;
 
-        void detectEdges(const PostprocessTexturePool::PostprocessTexture &image);
+        void detectEdges(const PostprocessTexture &image, EdgesTexture &edges);
 
-        void calculateBlendingWeights();
+        void calculateBlendingWeights(const EdgesTexture &edges, PostprocessTexture &blendingWeights);
 
-        void blendNeighbors(const PostprocessTexturePool::PostprocessTexture &image, PostprocessTexturePool::PostprocessTexture &outputImage);
+        void blendNeighbors(const PostprocessTexture &image, const PostprocessTexture &blendingWeights, PostprocessTexture &outputImage);
 
     public:
-        SMAAEffect(GLFramebuffer *sharedFramebuffer, PostprocessTexturePool *sharedTexturePool);
-
-        void antialise(const PostprocessTexturePool::PostprocessTexture &inputImage, PostprocessTexturePool::PostprocessTexture &outputImage);
+        SMAAEffect(GLFramebuffer *sharedFramebuffer);
+
+        /**
+         @param inputImage image to antialias
+         @param edges scratch image receiving detected edges
+         @param blendingWeights scratch image receiving blending weights
+         @param outputImage image receiving the result
+         */
+        void antialise(const PostprocessTexture &inputImage, EdgesTexture &edges, PostprocessTexture &blendingWeights, PostprocessTexture &outputImage);
     };
 
 }
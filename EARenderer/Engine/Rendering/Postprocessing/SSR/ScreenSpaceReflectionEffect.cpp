@@ -13,12 +13,12 @@ namespace EARenderer {
 
 #pragma mark - Lifecycle
 
-    ScreenSpaceReflectionEffect::ScreenSpaceReflectionEffect(GLFramebuffer *sharedFramebuffer, PostprocessTexturePool *sharedTexturePool)
-            : PostprocessEffect(sharedFramebuffer, sharedTexturePool), mBlurEffect(sharedFramebuffer, sharedTexturePool) {}
+    ScreenSpaceReflectionEffect::ScreenSpaceReflectionEffect(GLFramebuffer *sharedFramebuffer)
+            : PostprocessEffect(sharedFramebuffer), mBlurEffect(sharedFramebuffer) {}
 
 #pragma mark - Pivate Helpers
 
-    void ScreenSpaceReflectionEffect::traceReflections(const Camera &camera, const SceneGBuffer &GBuffer, PostprocessTexturePool::PostprocessTexture &rayHitInfo) {
+    void ScreenSpaceReflectionEffect::traceReflections(const Camera &camera, const SceneGBuffer &GBuffer, PostprocessTexture &rayHitInfo) {
         mSSRShader.bind();
         mSSRShader.ensureSamplerValidity([&]() {
             mSSRShader.setCamera(camera);
@@ -30,7 +30,7 @@ namespace EARenderer {
         Drawable::TriangleStripQuad::Draw();
     }
 
-    void ScreenSpaceReflectionEffect::blurProgressively(PostprocessTexturePool::PostprocessTexture &mirrorReflections) {
+    void ScreenSpaceReflectionEffect::blurProgressively(PostprocessTexture &mirrorReflections, PostprocessTexture &intermediateImage) {
         // Shape up the Gaussian curve to obtain [0.474, 0.233, 0.028, 0.001] weights
         // GPU Pro 5, 4.5.4 Pre-convolution Pass
         size_t blurRadius = 3;
@@ -40,18 +40,18 @@ namespace EARenderer {
 
         for (size_t mipLevel = 0; mipLevel < mirrorReflections.mipMapCount(); mipLevel++) {
             GaussianBlurSettings blurSettings{blurRadius, sigma, mipLevel, mipLevel + 1};
-            mBlurEffect.blur(mirrorReflections, mirrorReflections, blurSettings);
+            mBlurEffect.blur(mirrorReflections, intermediateImage, mirrorReflections, blurSettings);
         }
     }
 
     void ScreenSpaceReflectionEffect::traceCones(
             const Camera &camera,
-            const PostprocessTexturePool::PostprocessTexture &lightBuffer,
-            const PostprocessTexturePool::PostprocessTexture &rayHitInfo,
+            const PostprocessTexture &lightBuffer,
+            const PostprocessTexture &rayHitInfo,
             const SceneGBuffer &GBuffer,
             const ImageBasedLightProbe *IBLProbe,
-            PostprocessTexturePool::PostprocessTexture &baseOutputImage,
-            PostprocessTexturePool::PostprocessTexture &brightOutputImage) {
+            PostprocessTexture &baseOutputImage,
+            PostprocessTexture &brightOutputImage) {
 
         mConeTracingShader.bind();
         mConeTracingShader.setCamera(camera);
@@ -72,17 +72,15 @@ namespace EARenderer {
             const Camera &camera,
             const SceneGBuffer &GBuffer,
             const ImageBasedLightProbe *IBLProbe,
-            PostprocessTexturePool::PostprocessTexture &lightBuffer,
-            PostprocessTexturePool::PostprocessTexture &baseOutputImage,
-            PostprocessTexturePool::PostprocessTexture &brightOutputImage) {
-
-        auto rayTracingInfo = mTexturePool->claim();
-
-        traceReflections(camera, GBuffer, *rayTracingInfo);
-        blurProgressively(lightBuffer);
-        traceCones(camera, lightBuffer, *rayTracingInfo, GBuffer, IBLProbe, baseOutputImage, brightOutputImage);
-
-        mTexturePool->putBack(rayTracingInfo);
+            PostprocessTexture &lightBuffer,
+            PostprocessTexture &rayHitInfo,
+            PostprocessTexture &intermediateImage,
+            PostprocessTexture &baseOutputImage,
+            PostprocessTexture &brightOutputImage) {
+
+        traceReflections(camera, GBuffer, rayHitInfo);
+        blurProgressively(lightBuffer, intermediateImage);
+        traceCones(camera, lightBuffer, rayHitInfo, GBuffer, IBLProbe, baseOutputImage, brightOutputImage);
     }
 
 }
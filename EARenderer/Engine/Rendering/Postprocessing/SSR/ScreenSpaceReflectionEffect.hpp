@@ -12,7 +12,6 @@
 #include "PostprocessEffect.hpp"
 #include "GLSLScreenSpaceReflections.hpp"
 #include "GLSLConeTracing.hpp"
-#include "PostprocessTexturePool.hpp"
 #include "SceneGBuffer.hpp"
 #include "Camera.hpp"
 #include "GaussianBlurEffect.hpp"
@@ -32,31 +31,43 @@ namespace EARenderer {
         void traceReflections(
                 const Camera &camera,
                 const SceneGBuffer &GBuffer,
-                PostprocessTexturePool::PostprocessTexture &rayHitInfo
+                PostprocessTexture &rayHitInfo
         );
 
-        void blurProgressively(PostprocessTexturePool::PostprocessTexture &mirrorReflections);
+        void blurProgressively(PostprocessTexture &mirrorReflections, PostprocessTexture &intermediateImage);
 
         void traceCones(
                 const Camera &camera,
-                const PostprocessTexturePool::PostprocessTexture &lightBuffer,
-                const PostprocessTexturePool::PostprocessTexture &rayHitInfo,
+                const PostprocessTexture &lightBuffer,
+                const PostprocessTexture &rayHitInfo,
                 const SceneGBuffer &GBuffer,
                 const ImageBasedLightProbe *IBLProbe,
-                PostprocessTexturePool::PostprocessTexture &baseOutputImage,
-                PostprocessTexturePool::PostprocessTexture &brightOutputImage
+                PostprocessTexture &baseOutputImage,
+                PostprocessTexture &brightOutputImage
         );
 
     public:
-        ScreenSpaceReflectionEffect(GLFramebuffer *sharedFramebuffer, PostprocessTexturePool *sharedTexturePool);
+        ScreenSpaceReflectionEffect(GLFramebuffer *sharedFramebuffer);
 
+        /**
+         @param camera camera the frame is rendered from
+         @param GBuffer geometry buffer of the frame
+         @param IBLProbe optional probe used where reflected rays miss
+         @param lightBuffer lit frame with mip maps, mip maps are overwritten with blurred reflections
+         @param rayHitInfo scratch image receiving ray hit information
+         @param intermediateImage scratch image with mip maps used by the blur
+         @param baseOutputImage frame with reflections applied
+         @param brightOutputImage bright parts of the frame with reflections applied
+         */
         void applyReflections(
                 const Camera &camera,
                 const SceneGBuffer &GBuffer,
                 const ImageBasedLightProbe *IBLProbe,
-                PostprocessTexturePool::PostprocessTexture &lightBuffer,
-                PostprocessTexturePool::PostprocessTexture &baseOutputImage,
-                PostprocessTexturePool::PostprocessTexture &brightOutputImage
+                PostprocessTexture &lightBuffer,
+                PostprocessTexture &rayHitInfo,
+                PostprocessTexture &intermediateImage,
+                PostprocessTexture &baseOutputImage,
+                PostprocessTexture &brightOutputImage
         );
     };
 
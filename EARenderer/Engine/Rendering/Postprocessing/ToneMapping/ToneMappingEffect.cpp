@@ -7,14 +7,15 @@
 //
 
 #include "ToneMappingEffect.hpp"
+#include "GLStateCache.hpp"
 #include "Drawable.hpp"
 
 namespace EARenderer {
 
 #pragma mark - Lifecycle
 
-    ToneMappingEffect::ToneMappingEffect(GLFramebuffer *sharedFramebuffer, PostprocessTexturePool *sharedTexturePool)
-            : PostprocessEffect(sharedFramebuffer, sharedTexturePool),
+    ToneMappingEffect::ToneMappingEffect(GLFramebuffer *sharedFramebuffer)
+            : PostprocessEffect(sharedFramebuffer),
               mLuminance(sharedFramebuffer->size()),
               mHistogram(Size2D(64, 1)),
               mExposure(Size2D(1)) {
@@ -25,7 +26,7 @@ namespace EARenderer {
 
 #pragma mark - Private Interface
 
-    void ToneMappingEffect::measureLuminance(const PostprocessTexturePool::PostprocessTexture &image) {
+    void ToneMappingEffect::measureLuminance(const PostprocessTexture &image) {
         mLuminanceShader.bind();
         mLuminanceShader.ensureSamplerValidity([&]() {
             mLuminanceShader.setImage(image);
@@ -57,10 +58,10 @@ namespace EARenderer {
 
 //        mFramebuffer->redirectRenderingToTextures(GLViewport(mHistogram.size()), &mHistogram);
 
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_ONE, GL_ONE);
+        GLStateCache::shared().enable(GL_BLEND);
+        GLStateCache::shared().blendFunc(GL_ONE, GL_ONE);
         Drawable::Point::Draw(mLuminance.size().width * mLuminance.size().height);
-        glDisable(GL_BLEND);
+        GLStateCache::shared().disable(GL_BLEND);
     }
 
     void ToneMappingEffect::computeExposure() {
@@ -75,7 +76,7 @@ namespace EARenderer {
 
 #pragma mark - Public Interface
 
-    void ToneMappingEffect::toneMap(const PostprocessTexturePool::PostprocessTexture &inputImage, PostprocessTexturePool::PostprocessTexture &outputImage) {
+    void ToneMappingEffect::toneMap(const PostprocessTexture &inputImage, PostprocessTexture &outputImage) {
         //        measureLuminance(inputImage, texturePool);
         //        computeLuminanceRange(texturePool);
         //        buildHistogram(texturePool);
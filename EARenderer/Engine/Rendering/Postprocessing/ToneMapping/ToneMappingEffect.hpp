@@ -18,7 +18,6 @@
 #include "GLSLToneMapping.hpp"
 #include "GLSLLuminanceHistogram.hpp"
 #include "GLSLExposure.hpp"
-#include "PostprocessTexturePool.hpp"
 
 #include <memory>
 
@@ -38,7 +37,7 @@ namespace EARenderer {
         GLFloatTexture2D<GLTexture::Float::R32F> mHistogram;
         GLFloatTexture2D<GLTexture::Float::R16F> mExposure;
 
-        void measureLuminance(const PostprocessTexturePool::PostprocessTexture &image);
+        void measureLuminance(const PostprocessTexture &image);
 
         void computeLuminanceRange();
 
@@ -47,9 +46,9 @@ namespace EARenderer {
         void computeExposure();
 
     public:
-        ToneMappingEffect(GLFramebuffer *sharedFramebuffer, PostprocessTexturePool *sharedTexturePool);
+        ToneMappingEffect(GLFramebuffer *sharedFramebuffer);
 
-        void toneMap(const PostprocessTexturePool::PostprocessTexture &inputImage, PostprocessTexturePool::PostprocessTexture &outputImage);
+        void toneMap(const PostprocessTexture &inputImage, PostprocessTexture &outputImage);
     };
 
 }
@@ -7,6 +7,7 @@
 //
 
 #include "AxesRenderer.hpp"
+#include "GLStateCache.hpp"
 #include "Collision.hpp"
 
 #include <glm/gtx/transform.hpp>
@@ -169,8 +170,8 @@ namespace EARenderer {
     }
 
     void AxesRenderer::render() {
-        glDisable(GL_DEPTH_TEST);
-        glEnable(GL_MULTISAMPLE);
+        GLStateCache::shared().disable(GL_DEPTH_TEST);
+        GLStateCache::shared().enable(GL_MULTISAMPLE);
 
         mGenericGeometryShader.bind();
         for (ID meshInstanceID : mScene->meshInstances()) {
@@ -189,8 +190,8 @@ namespace EARenderer {
             renderSegments(axesToHighlight, mvp);
         }
 
-        glEnable(GL_DEPTH_TEST);
-        glDisable(GL_MULTISAMPLE);
+        GLStateCache::shared().enable(GL_DEPTH_TEST);
+        GLStateCache::shared().disable(GL_MULTISAMPLE);
     }
 
 }
@@ -7,6 +7,7 @@
 //
 
 #include "BoxRenderer.hpp"
+#include "GLStateCache.hpp"
 
 namespace EARenderer {
 
@@ -30,9 +31,9 @@ namespace EARenderer {
 #pragma mark - Rendering
 
     void BoxRenderer::render(Mode renderingMode, const glm::mat4 &boxTransform) {
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        glEnable(GL_BLEND);
-        glDisable(GL_CULL_FACE);
+        GLStateCache::shared().blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        GLStateCache::shared().enable(GL_BLEND);
+        GLStateCache::shared().disable(GL_CULL_FACE);
 
         mVAO.bind();
 
@@ -42,18 +43,18 @@ namespace EARenderer {
             mBoxEdgesRenderingShader.bind();
             mBoxEdgesRenderingShader.setViewProjectionMatrix(mvp);
             mBoxEdgesRenderingShader.setColor(Color(1.0, 0.4, 0.7, 1.0));
-            glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(mPoints.size()));
+            GLStateCache::shared().drawArrays(GL_LINES, 0, static_cast<GLsizei>(mPoints.size()));
         }
 
         if (renderingMode == Mode::Sides || renderingMode == Mode::Full) {
             mBoxSidesRenderingShader.bind();
             mBoxSidesRenderingShader.setViewProjectionMatrix(mvp);
             mBoxSidesRenderingShader.setColor(Color(0.5, 0.6, 0.8, 0.4));
-            glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(mPoints.size()));
+            GLStateCache::shared().drawArrays(GL_LINES, 0, static_cast<GLsizei>(mPoints.size()));
         }
 
-        glDisable(GL_BLEND);
-        glEnable(GL_CULL_FACE);
+        GLStateCache::shared().disable(GL_BLEND);
+        GLStateCache::shared().enable(GL_CULL_FACE);
     }
 
 }
@@ -7,12 +7,14 @@
 //
 
 #include "DeferredSceneRenderer.hpp"
+#include "GLStateCache.hpp"
 #include "GLShader.hpp"
 #include "SharedResourceStorage.hpp"
 #include "Vertex1P4.hpp"
 #include "Collision.hpp"
 #include "Measurement.hpp"
 #include "Drawable.hpp"
+#include "Profiler.hpp"
 
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -27,8 +29,7 @@ namespace EARenderer {
             const SharedResourceStorage *resourceStorage,
             const GPUResourceController *gpuResourceController,
             const DefaultRenderComponentsProviding *provider,
-            const SurfelData *surfelData,
-            const DiffuseLightProbeData *diffuseProbeData,
+            const LightBakingVolumeCache *volumeCache,
             const SceneGBuffer *gBuffer,
             const RenderingSettings &settings)
             :
@@ -36,31 +37,28 @@ namespace EARenderer {
             mResourceStorage(resourceStorage),
             mGPUResourceController(gpuResourceController),
             mDefaultRenderComponentsProvider(provider),
-            mSurfelData(surfelData),
-            mProbeData(diffuseProbeData),
+            mGBuffer(gBuffer),
             mSettings(settings),
 
             // Effects
             mFramebuffer(settings.displayedFrameResolution),
-            mPostprocessTexturePool(settings.displayedFrameResolution),
-            mBloomEffect(&mFramebuffer, &mPostprocessTexturePool),
-            mToneMappingEffect(&mFramebuffer, &mPostprocessTexturePool),
-            mSSREffect(&mFramebuffer, &mPostprocessTexturePool),
-            mSMAAEffect(&mFramebuffer, &mPostprocessTexturePool),
+            mBloomEffect(&mFramebuffer),
+            mToneMappingEffect(&mFramebuffer),
+            mSSREffect(&mFramebuffer),
+            mSMAAEffect(&mFramebuffer),
 
             // Helpers
             mShadowMapper(scene, resourceStorage, gpuResourceController, gBuffer, settings.meshSettings.shadowCascadesCount),
             mDirectLightAccumulator(scene, gBuffer, &mShadowMapper, gpuResourceController),
-            mIndirectLightAccumulator(scene, gpuResourceController, gBuffer, surfelData, diffuseProbeData, &mShadowMapper),
-            mGBuffer(gBuffer) {
+            mVolumeStreamer(scene, resourceStorage, gpuResourceController, gBuffer, &mShadowMapper, volumeCache) {
 
-        glEnable(GL_CULL_FACE);
-        glEnable(GL_DEPTH_TEST);
-        glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
-        glDisable(GL_BLEND);
-        glClearColor(0.0, 0.0, 0.0, 1.0);
-        glClearDepth(1.0);
-        glDepthFunc(GL_LEQUAL);
+        GLStateCache::shared().enable(GL_CULL_FACE);
+        GLStateCache::shared().enable(GL_DEPTH_TEST);
+        GLStateCache::shared().enable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
+        GLStateCache::shared().disable(GL_BLEND);
+        GLStateCache::shared().backend().clearColor(0.0, 0.0, 0.0, 1.0);
+        GLStateCache::shared().backend().clearDepth(1.0);
+        GLStateCache::shared().depthFunc(GL_LEQUAL);
 
         mFramebuffer.attachDepthTexture(mGBuffer->depthBuffer);
     }
@@ -69,23 +67,24 @@ namespace EARenderer {
 
     void DeferredSceneRenderer::setRenderingSettings(const RenderingSettings &settings) {
         mSettings = settings;
+        mFrameGraph.reset();
         mShadowMapper.setRenderingSettings(settings);
         mDirectLightAccumulator.setRenderingSettings(settings);
-        mIndirectLightAccumulator.setRenderingSettings(settings);
+        mVolumeStreamer.setRenderingSettings(settings);
     }
 
-#pragma mark - Getters
-
-    const std::array<GLLDRTexture3D, 4> &DeferredSceneRenderer::gridProbesSphericalHarmonics() const {
-        return mIndirectLightAccumulator.gridProbesSphericalHarmonics();
+    void DeferredSceneRenderer::setPassTimer(PassTimer *timer) {
+        mPassTimer = timer;
     }
 
-    const GLFloatTexture2D<GLTexture::Float::R16F> &DeferredSceneRenderer::surfelsLuminanceMap() const {
-        return mIndirectLightAccumulator.surfelsLuminanceMap();
+#pragma mark - Getters
+
+    const LightBakingVolumeStreamer &DeferredSceneRenderer::volumeStreamer() const {
+        return mVolumeStreamer;
     }
 
-    const GLFloatTexture2D<GLTexture::Float::R16F> &DeferredSceneRenderer::surfelClustersLuminanceMap() const {
-        return mIndirectLightAccumulator.surfelClustersLuminanceMap();
+    const FrameGraph &DeferredSceneRenderer::frameGraph() const {
+        return mFrameGraph;
     }
 
 #pragma mark - Rendering
@@ -110,9 +109,9 @@ namespace EARenderer {
         mScene->skybox()->draw();
     }
 
-    void DeferredSceneRenderer::renderFinalImage(const PostprocessTexturePool::PostprocessTexture &image) {
+    void DeferredSceneRenderer::renderFinalImage(const PostprocessEffect::PostprocessTexture &image) {
         bindDefaultFramebuffer();
-        glDisable(GL_DEPTH_TEST);
+        GLStateCache::shared().disable(GL_DEPTH_TEST);
 
         mFSQuadShader.bind();
         mFSQuadShader.setApplyToneMapping(false);
@@ -121,68 +120,177 @@ namespace EARenderer {
         });
 
         Drawable::TriangleStripQuad::Draw();
-        glEnable(GL_DEPTH_TEST);
+        GLStateCache::shared().enable(GL_DEPTH_TEST);
     }
 
-#pragma mark - Public interface
+    void DeferredSceneRenderer::buildFrameGraph() {
+        EA_PROFILE_SCOPE("Build frame graph");
 
-    void DeferredSceneRenderer::render(const DebugOpportunity &debugClosure) {
-        mShadowMapper.render();
-        mIndirectLightAccumulator.updateProbes();
+        using Float = GLTexture::Float;
+        using Resources = FrameGraph::Resources;
 
-        // We're using depth buffer rendered during g-buffer construction.
-        // Depth writes are disabled for the purpose of combining skybox
-        // and debugging entities with full screen deferred rendering:
-        // mMeshes are rendered as a full screen quad, then skybox is rendered
-        // where it should, using depth buffer filled by geometry.
-        // Then, full screen quad rendering (postprocessing) can be applied without
-        // polluting the depth buffer, which leaves us an ability to render 3D debug entities,
-        // like light probe spheres, surfels etc.
-        glDepthMask(GL_FALSE);
+        // Images can only alias others with the same descriptor, so mip maps are requested
+        // only by images that reflections and bloom write or read coarser levels of
+        FrameGraph::TextureDescriptor image{mSettings.displayedFrameResolution, Float::RGBA16F, false};
+        FrameGraph::TextureDescriptor mippedImage{mSettings.displayedFrameResolution, Float::RGBA16F, true};
+        FrameGraph::TextureDescriptor edges{mSettings.displayedFrameResolution, Float::RG16F, false};
 
-        auto lightAccumulationTarget = mPostprocessTexturePool.claim();
-        mFramebuffer.redirectRenderingToTextures(GLFramebuffer::UnderlyingBuffer::Color, lightAccumulationTarget);
+        mFrameGraph.reset();
 
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_ONE, GL_ONE);
-        glDisable(GL_DEPTH_TEST);
+        FrameGraph::Resource lightBuffer;
+        mFrameGraph.addPass("Light accumulation", [&](FrameGraph::Builder &builder) {
+            lightBuffer = builder.create("Light buffer", mippedImage);
 
-        mDirectLightAccumulator.render();
-        mIndirectLightAccumulator.render();
+            return [this, lightBuffer](const Resources &resources) {
+                mFramebuffer.redirectRenderingToTextures(GLFramebuffer::UnderlyingBuffer::Color, &resources.texture<Float::RGBA16F>(lightBuffer));
 
-        glDisable(GL_BLEND);
-        glEnable(GL_DEPTH_TEST);
+                GLStateCache::shared().enable(GL_BLEND);
+                GLStateCache::shared().blendFunc(GL_ONE, GL_ONE);
+                GLStateCache::shared().disable(GL_DEPTH_TEST);
 
-        if (mSettings.skyboxRenderingEnabled) {
-            renderSkybox();
-        }
+                mDirectLightAccumulator.render();
+                mVolumeStreamer.render();
+
+                GLStateCache::shared().disable(GL_BLEND);
+                GLStateCache::shared().enable(GL_DEPTH_TEST);
+
+                if (mSettings.skyboxRenderingEnabled) {
+                    renderSkybox();
+                }
+            };
+        });
 
-        auto ssrBaseOutputTexture = mPostprocessTexturePool.claim(); // Frame with reflections applied
-        auto ssrBrightOutputTexture = mPostprocessTexturePool.claim(); // Frame filtered by luminosity threshold and suitable for bloom effect
+        FrameGraph::Resource ssrBaseOutput;
+        FrameGraph::Resource ssrBrightOutput;
+        mFrameGraph.addPass("Screen space reflections", [&](FrameGraph::Builder &builder) {
+            // Mip maps of the light buffer are replaced with progressively blurred reflections
+            builder.read(lightBuffer);
+            builder.write(lightBuffer);
+            auto rayHitInfo = builder.create("Ray hit info", image);
+            auto blurIntermediate = builder.create("Reflection blur intermediate", mippedImage);
+            ssrBaseOutput = builder.create("Reflections base output", image); // Frame with reflections applied
+            ssrBrightOutput = builder.create("Reflections bright output", mippedImage); // Frame filtered by luminosity threshold and suitable for bloom effect
+
+            return [=](const Resources &resources) {
+                mSSREffect.applyReflections(
+                        *mScene->camera(), *mGBuffer, mScene->skybox()->lightProbe(),
+                        resources.texture<Float::RGBA16F>(lightBuffer),
+                        resources.texture<Float::RGBA16F>(rayHitInfo),
+                        resources.texture<Float::RGBA16F>(blurIntermediate),
+                        resources.texture<Float::RGBA16F>(ssrBaseOutput),
+                        resources.texture<Float::RGBA16F>(ssrBrightOutput)
+                );
+            };
+        });
 
-        mSSREffect.applyReflections(
-                *mScene->camera(), *mGBuffer, mScene->skybox()->lightProbe(),
-                *lightAccumulationTarget, *ssrBaseOutputTexture, *ssrBrightOutputTexture
-        );
+        FrameGraph::Resource bloomOutput;
+        mFrameGraph.addPass("Bloom", [&](FrameGraph::Builder &builder) {
+            builder.read(ssrBaseOutput);
+            builder.read(ssrBrightOutput);
+            builder.write(ssrBrightOutput);
+            auto blurredImage = builder.create("Bloom blur", mippedImage);
+            auto blurIntermediate = builder.create("Bloom blur intermediate", mippedImage);
+            bloomOutput = builder.create("Bloom output", image);
+
+            return [=](const Resources &resources) {
+                mBloomEffect.bloom(
+                        resources.texture<Float::RGBA16F>(ssrBaseOutput),
+                        resources.texture<Float::RGBA16F>(ssrBrightOutput),
+                        resources.texture<Float::RGBA16F>(blurredImage),
+                        resources.texture<Float::RGBA16F>(blurIntermediate),
+                        resources.texture<Float::RGBA16F>(bloomOutput),
+                        mSettings.bloomSettings
+                );
+            };
+        });
 
-        auto bloomOutputTexture = lightAccumulationTarget;
-        mBloomEffect.bloom(*ssrBaseOutputTexture, *ssrBrightOutputTexture, *bloomOutputTexture, mSettings.bloomSettings);
+        // Debug entities are rendered on top of the HDR frame, depth tested against the g-buffer
+        mFrameGraph.addPass("Debug", [&](FrameGraph::Builder &builder) {
+            builder.read(bloomOutput);
+            builder.write(bloomOutput);
 
-        glDepthMask(GL_TRUE);
+            return [this, bloomOutput](const Resources &resources) {
+                mFramebuffer.redirectRenderingToTextures(GLFramebuffer::UnderlyingBuffer::None, &resources.texture<Float::RGBA16F>(bloomOutput));
+                GLStateCache::shared().depthMask(GL_TRUE);
+                if (mDebugClosure) mDebugClosure();
+            };
+        });
 
-        debugClosure();
+        FrameGraph::Resource toneMappingOutput;
+        mFrameGraph.addPass("Tone mapping", [&](FrameGraph::Builder &builder) {
+            builder.read(bloomOutput);
+            toneMappingOutput = builder.create("Tone mapping output", image);
+
+            return [=](const Resources &resources) {
+                mToneMappingEffect.toneMap(
+                        resources.texture<Float::RGBA16F>(bloomOutput),
+                        resources.texture<Float::RGBA16F>(toneMappingOutput)
+                );
+            };
+        });
 
-        auto toneMappingOutputTexture = ssrBaseOutputTexture;
-        mToneMappingEffect.toneMap(*bloomOutputTexture, *toneMappingOutputTexture);
+        FrameGraph::Resource smaaOutput;
+        mFrameGraph.addPass("SMAA", [&](FrameGraph::Builder &builder) {
+            builder.read(toneMappingOutput);
+            auto smaaEdges = builder.create("SMAA edges", edges);
+            auto blendingWeights = builder.create("SMAA blending weights", image);
+            smaaOutput = builder.create("SMAA output", image);
+
+            return [=](const Resources &resources) {
+                mSMAAEffect.antialise(
+                        resources.texture<Float::RGBA16F>(toneMappingOutput),
+                        resources.texture<Float::RG16F>(smaaEdges),
+                        resources.texture<Float::RGBA16F>(blendingWeights),
+                        resources.texture<Float::RGBA16F>(smaaOutput)
+                );
+            };
+        });
 
-        auto smaaOutputTexture = ssrBrightOutputTexture;
-        mSMAAEffect.antialise(*toneMappingOutputTexture, *smaaOutputTexture);
+        mFrameGraph.addPass("Final image", [&](FrameGraph::Builder &builder) {
+            builder.read(smaaOutput);
+            builder.setSideEffect();
 
-        renderFinalImage(*smaaOutputTexture);
+            return [this, smaaOutput](const Resources &resources) {
+                renderFinalImage(resources.texture<Float::RGBA16F>(smaaOutput));
+            };
+        });
+
+        mFrameGraph.compile();
+    }
+
+#pragma mark - Public interface
+
+    void DeferredSceneRenderer::invalidateIndirectLight() {
+        mVolumeStreamer.invalidate();
+    }
+
+    void DeferredSceneRenderer::render(const DebugOpportunity &debugClosure) {
+        EA_PROFILE_SCOPE("Deferred rendering");
+
+        if (mPassTimer) mPassTimer->beginPass("Shadow maps");
+        mShadowMapper.render();
+        if (mPassTimer) mPassTimer->endPass();
+
+        mVolumeStreamer.update(mScene->camera()->position());
+        mVolumeStreamer.updateProbes();
+
+        // We're using depth buffer rendered during g-buffer construction.
+        // Depth writes are disabled for the purpose of combining skybox
+        // and debugging entities with full screen deferred rendering:
+        // mMeshes are rendered as a full screen quad, then skybox is rendered
+        // where it should, using depth buffer filled by geometry.
+        // Then, full screen quad rendering (postprocessing) can be applied without
+        // polluting the depth buffer, which leaves us an ability to render 3D debug entities,
+        // like light probe spheres, surfels etc.
+        GLStateCache::shared().depthMask(GL_FALSE);
+
+        mDebugClosure = debugClosure;
+        if (!mFrameGraph.isCompiled()) {
+            buildFrameGraph();
+        }
+        mFrameGraph.execute(mTransientTexturePool, mPassTimer);
 
-        mPostprocessTexturePool.putBack(lightAccumulationTarget);
-        mPostprocessTexturePool.putBack(ssrBaseOutputTexture);
-        mPostprocessTexturePool.putBack(ssrBrightOutputTexture);
+        GLStateCache::shared().depthMask(GL_TRUE);
     }
 
 }
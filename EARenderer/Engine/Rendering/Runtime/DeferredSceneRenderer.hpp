@@ -19,7 +19,9 @@
 
 #include "Scene.hpp"
 #include "SceneGBuffer.hpp"
-#include "PostprocessTexturePool.hpp"
+#include "FrameGraph.hpp"
+#include "TransientTexturePool.hpp"
+#include "PassTimer.hpp"
 #include "GLFramebuffer.hpp"
 #include "DefaultRenderComponentsProviding.hpp"
 #include "FrustumCascades.hpp"
@@ -35,6 +37,8 @@
 #include "SMAAEffect.hpp"
 #include "DirectLightAccumulator.hpp"
 #include "IndirectLightAccumulator.hpp"
+#include "LightBakingVolumeCache.hpp"
+#include "LightBakingVolumeStreamer.hpp"
 
 #include "GLSLDepthPrepass.hpp"
 #include "GLSLDirectLightEvaluation.hpp"
@@ -50,6 +54,9 @@
 namespace EARenderer {
 
     class DeferredSceneRenderer {
+    public:
+        using DebugOpportunity = std::function<void()>;
+
     private:
         uint8_t mNumberOfIrradianceMips = 5;
         glm::ivec3 mProbeGridResolution;
@@ -58,14 +65,16 @@ namespace EARenderer {
         const SharedResourceStorage *mResourceStorage;
         const GPUResourceController *mGPUResourceController;
         const DefaultRenderComponentsProviding *mDefaultRenderComponentsProvider;
-        const SurfelData *mSurfelData;
-        const DiffuseLightProbeData *mProbeData;
         const SceneGBuffer *mGBuffer;
 
         RenderingSettings mSettings;
 
         GLFramebuffer mFramebuffer;
-        PostprocessTexturePool mPostprocessTexturePool;
+        // Compiled once and rebuilt only when rendering settings change
+        FrameGraph mFrameGraph;
+        DebugOpportunity mDebugClosure;
+        TransientTexturePool mTransientTexturePool;
+        PassTimer *mPassTimer = nullptr;
 
         BloomEffect mBloomEffect;
         ToneMappingEffect mToneMappingEffect;
@@ -74,7 +83,7 @@ namespace EARenderer {
 
         ShadowMapper mShadowMapper;
         DirectLightAccumulator mDirectLightAccumulator;
-        IndirectLightAccumulator mIndirectLightAccumulator;
+        LightBakingVolumeStreamer mVolumeStreamer;
 
         GLSLDepthPrepass mDepthPrepassShader;
         GLSLSkybox mSkyboxShader;
@@ -84,18 +93,17 @@ namespace EARenderer {
 
         void renderSkybox();
 
-        void renderFinalImage(const PostprocessTexturePool::PostprocessTexture& image);
+        void renderFinalImage(const PostprocessEffect::PostprocessTexture& image);
 
-    public:
-        using DebugOpportunity = std::function<void()>;
+        void buildFrameGraph();
 
+    public:
         DeferredSceneRenderer(
                 const Scene *scene,
                 const SharedResourceStorage *resourceStorage,
                 const GPUResourceController *gpuResourceController,
                 const DefaultRenderComponentsProviding *provider,
-                const SurfelData *surfelData,
-                const DiffuseLightProbeData *diffuseProbeData,
+                const LightBakingVolumeCache *volumeCache,
                 const SceneGBuffer *gBuffer,
                 const RenderingSettings &settings
         );
@@ -103,12 +111,23 @@ namespace EARenderer {
         // Setters
         void setRenderingSettings(const RenderingSettings &settings);
 
+        /**
+         @param timer timer measuring shadow mapping and every frame graph pass, or nullptr
+         */
+        void setPassTimer(PassTimer *timer);
+
         // Getters
-        const std::array<GLLDRTexture3D, 4> &gridProbesSphericalHarmonics() const;
+        const LightBakingVolumeStreamer &volumeStreamer() const;
 
-        const GLFloatTexture2D<GLTexture::Float::R16F> &surfelsLuminanceMap() const;
+        /**
+         @return graph of the most recently rendered frame
+         */
+        const FrameGraph &frameGraph() const;
 
-        const GLFloatTexture2D<GLTexture::Float::R16F> &surfelClustersLuminanceMap() const;
+        /**
+         Makes resident volumes recompute their surfels and probes, to be called when shadow casters have moved
+         */
+        void invalidateIndirectLight();
 
         /**
          Renders the scene
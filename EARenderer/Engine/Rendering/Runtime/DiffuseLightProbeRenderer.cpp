@@ -13,6 +13,23 @@ namespace EARenderer {
 
 #pragma mark - Lifecycle
 
+    std::vector<DiffuseLightProbeRenderer::ProbeVertex> DiffuseLightProbeRenderer::ValidProbeVertices(const DiffuseLightProbeData &probeData) {
+        std::vector<ProbeVertex> vertices;
+        const glm::ivec3 &resolution = probeData.gridResolution();
+
+        for (size_t i = 0; i < probeData.probes().size(); i++) {
+            const DiffuseLightProbe &probe = probeData.probes()[i];
+            if (!probe.isValid) {
+                continue;
+            }
+
+            glm::vec3 atlasCoordinates(i % resolution.x, (i / resolution.x) % resolution.y, i / (resolution.x * resolution.y));
+            vertices.push_back({probe.position, atlasCoordinates});
+        }
+
+        return vertices;
+    }
+
     DiffuseLightProbeRenderer::DiffuseLightProbeRenderer(
             const Scene *scene,
             const DiffuseLightProbeData *probeData,
@@ -21,8 +38,12 @@ namespace EARenderer {
             mScene(scene),
             mProbeData(probeData),
             mSphericalHarmonics(sphericalHarmonics),
-            mDiffuseProbesVAO(GLVertexArray<DiffuseLightProbe>::Create(probeData->probes(),
-                    std::vector<GLVertexAttribute>{ GLVertexAttribute::UniqueAttribute(sizeof(glm::vec3), glm::vec3::length())} )) {}
+            mProbeVertexCount(probeData->validProbeCount()),
+            mDiffuseProbesVAO(GLVertexArray<ProbeVertex>::Create(ValidProbeVertices(*probeData),
+                    std::vector<GLVertexAttribute>{
+                            GLVertexAttribute::UniqueAttribute(sizeof(glm::vec3), glm::vec3::length()),
+                            GLVertexAttribute::UniqueAttribute(sizeof(glm::vec3), glm::vec3::length())
+                    })) {}
 
 #pragma mark - Setters
 
@@ -37,13 +58,11 @@ namespace EARenderer {
         mGridProbeRenderingShader.bind();
         mGridProbeRenderingShader.setCamera(*mScene->camera());
         mGridProbeRenderingShader.setSphereRadius(mRenderingSettings.probeSettings.sphereRadius);
-        mGridProbeRenderingShader.setWorldBoundingBox(mScene->lightBakingVolume());
-        mGridProbeRenderingShader.setProbesGridResolution(mProbeData->gridResolution());
         mGridProbeRenderingShader.ensureSamplerValidity([&] {
             mGridProbeRenderingShader.setGridProbesSHTextures(*mSphericalHarmonics);
         });
 
-        Drawable::Point::Draw(mProbeData->probes().size());
+        Drawable::Point::Draw(mProbeVertexCount);
     }
 
 }
@@ -20,14 +20,26 @@ namespace EARenderer {
 
     class DiffuseLightProbeRenderer {
     private:
+        struct ProbeVertex {
+            glm::vec3 position;
+            // Location of the probe's spherical harmonics in the probe atlas
+            glm::vec3 atlasCoordinates;
+        };
+
         const Scene *mScene;
         const DiffuseLightProbeData *mProbeData;
         const std::array<GLLDRTexture3D, 4> *mSphericalHarmonics;
 
-        GLVertexArray<DiffuseLightProbe> mDiffuseProbesVAO;
+        size_t mProbeVertexCount;
+        GLVertexArray<ProbeVertex> mDiffuseProbesVAO;
         GLSLGridLightProbeRendering mGridProbeRenderingShader;
         RenderingSettings mRenderingSettings;
 
+        /**
+         @return vertices of probes participating in the interpolation
+         */
+        static std::vector<ProbeVertex> ValidProbeVertices(const DiffuseLightProbeData &probeData);
+
     public:
         DiffuseLightProbeRenderer(const Scene *scene, const DiffuseLightProbeData *probeData, const std::array<GLLDRTexture3D, 4> *sphericalHarmonics);
 
@@ -7,6 +7,7 @@
 //
 
 #include "Drawable.hpp"
+#include "GLStateCache.hpp"
 
 namespace EARenderer {
 
@@ -16,9 +17,9 @@ namespace EARenderer {
 
             void Draw(size_t instanceCount) {
                 if (instanceCount > 1) {
-                    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei) instanceCount);
+                    GLStateCache::shared().drawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei) instanceCount);
                 } else {
-                    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+                    GLStateCache::shared().drawArrays(GL_TRIANGLE_STRIP, 0, 4);
                 }
             }
 
@@ -27,7 +28,7 @@ namespace EARenderer {
         namespace Point {
 
             void Draw(size_t count) {
-                glDrawArrays(GL_POINTS, 0, (GLsizei) count);
+                GLStateCache::shared().drawArrays(GL_POINTS, 0, (GLsizei) count);
             }
 
         }
@@ -35,19 +36,23 @@ namespace EARenderer {
         namespace TriangleMesh {
 
             void Draw(size_t vertexCount, size_t VBOOffset) {
-                glDrawArrays(GL_TRIANGLES, VBOOffset, static_cast<GLsizei>(vertexCount));
+                GLStateCache::shared().drawArrays(GL_TRIANGLES, VBOOffset, static_cast<GLsizei>(vertexCount));
             }
 
             void DrawInstanced(size_t instanceCount, size_t vertexCount, size_t VBOOffset) {
-                glDrawArraysInstanced(GL_TRIANGLES, VBOOffset, static_cast<GLsizei>(vertexCount), static_cast<GLsizei>(instanceCount));
+                GLStateCache::shared().drawArraysInstanced(GL_TRIANGLES, VBOOffset, static_cast<GLsizei>(vertexCount), static_cast<GLsizei>(instanceCount));
             }
 
             void TriangleMesh::Draw(const GLVBODataLocation &location) {
-                glDrawArrays(GL_TRIANGLES, location.offset, static_cast<GLsizei>(location.vertexCount));
+                GLStateCache::shared().drawArrays(GL_TRIANGLES, location.offset, static_cast<GLsizei>(location.vertexCount));
             }
 
             void TriangleMesh::DrawInstanced(size_t instanceCount, const GLVBODataLocation &location) {
-                glDrawArraysInstanced(GL_TRIANGLES, location.offset, static_cast<GLsizei>(location.vertexCount), static_cast<GLsizei>(instanceCount));
+                GLStateCache::shared().drawArraysInstanced(GL_TRIANGLES, location.offset, static_cast<GLsizei>(location.vertexCount), static_cast<GLsizei>(instanceCount));
+            }
+
+            void MultiDraw(const std::vector<GLint> &firstVertices, const std::vector<GLsizei> &vertexCounts) {
+                GLStateCache::shared().multiDrawArrays(GL_TRIANGLES, firstVertices.data(), vertexCounts.data(), static_cast<GLsizei>(firstVertices.size()));
             }
 
         }
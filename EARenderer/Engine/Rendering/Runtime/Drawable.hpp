@@ -11,6 +11,7 @@
 
 #include <OpenGL/gl3.h>
 #include <stdio.h>
+#include <vector>
 
 #include "GLVertexArrayBuffer.hpp"
 #include "GLElementArrayBuffer.hpp"
@@ -35,6 +36,11 @@ namespace EARenderer {
             void Draw(const GLVBODataLocation& location);
 
             void DrawInstanced(size_t instanceCount, const GLVBODataLocation& location);
+
+            /**
+             Draws all vertex ranges with a single call
+             */
+            void MultiDraw(const std::vector<GLint> &firstVertices, const std::vector<GLsizei> &vertexCounts);
         }
 
     }
@@ -7,6 +7,7 @@
 //
 
 #include "IndirectLightAccumulator.hpp"
+#include "GLStateCache.hpp"
 #include "Drawable.hpp"
 
 namespace EARenderer {
@@ -15,18 +16,23 @@ namespace EARenderer {
 
     IndirectLightAccumulator::IndirectLightAccumulator(
             const Scene *scene,
+            const SharedResourceStorage *resourceStorage,
             const GPUResourceController *gpuResourceController,
             const SceneGBuffer *gBuffer,
             const SurfelData *surfelData,
             const DiffuseLightProbeData *probeData,
-            const ShadowMapper *shadowMapper)
+            const ShadowMapper *shadowMapper,
+            const LightBakingVolume &volume)
             :
             mScene(scene),
+            mResourceStorage(resourceStorage),
             mGPUResourceController(gpuResourceController),
             mGBuffer(gBuffer),
             mSurfelData(surfelData),
             mProbeData(probeData),
             mShadowMapper(shadowMapper),
+            mVolume(volume),
+            mUpdateScheduler(*surfelData, *probeData),
             mFramebuffer(framebufferResolution()),
             mGridProbeSHMaps(gridProbeSHMaps()),
             mSurfelsLuminanceMap(surfelData->surfelsGBuffer()->size(), nullptr, Sampling::Filter::None),
@@ -56,6 +62,18 @@ namespace EARenderer {
         mSettings = settings;
     }
 
+    const LightBakingVolume &IndirectLightAccumulator::volume() const {
+        return mVolume;
+    }
+
+    const SurfelData *IndirectLightAccumulator::surfelData() const {
+        return mSurfelData;
+    }
+
+    const DiffuseLightProbeData *IndirectLightAccumulator::probeData() const {
+        return mProbeData;
+    }
+
     const std::array<GLLDRTexture3D, 4> &IndirectLightAccumulator::gridProbesSphericalHarmonics() const {
         return mGridProbeSHMaps;
     }
@@ -70,16 +88,35 @@ namespace EARenderer {
 
 #pragma mark - Private Helpers
 
-    void IndirectLightAccumulator::relightSurfels() {
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_ONE, GL_ONE);
+    void IndirectLightAccumulator::ScissorRows(const IndirectLightUpdateScheduler::RowRange &rows, const Size2D &mapSize) {
+        GLStateCache::shared().scissor(0, rows.firstRow, mapSize.width, rows.rowCount);
+    }
 
+    void IndirectLightAccumulator::relightSurfels(const std::vector<IndirectLightUpdateScheduler::RowRange> &rows) {
         const DirectionalLight &directionalLight = mScene->sun();
 
         mFramebuffer.redirectRenderingToTextures(GLViewport(mSurfelsLuminanceMap.size()),
-                GLFramebuffer::UnderlyingBuffer::Color | GLFramebuffer::UnderlyingBuffer::Depth,
+                GLFramebuffer::UnderlyingBuffer::None,
                 &mSurfelsLuminanceMap);
 
+        // Only scheduled rows are cleared and accumulate light, the rest keep luminance from previous frames
+        GLStateCache::shared().enable(GL_SCISSOR_TEST);
+
+        for (auto &range : rows) {
+            ScissorRows(range, mSurfelsLuminanceMap.size());
+            mFramebuffer.clear(GLFramebuffer::UnderlyingBuffer::Color | GLFramebuffer::UnderlyingBuffer::Depth);
+        }
+
+        auto drawRows = [&]() {
+            for (auto &range : rows) {
+                ScissorRows(range, mSurfelsLuminanceMap.size());
+                Drawable::TriangleStripQuad::Draw();
+            }
+        };
+
+        GLStateCache::shared().enable(GL_BLEND);
+        GLStateCache::shared().blendFunc(GL_ONE, GL_ONE);
+
         mSurfelLightingShader.bind();
         mSurfelLightingShader.setSettings(mSettings);
         mSurfelLightingShader.ensureSamplerValidity([&]() {
@@ -87,15 +124,16 @@ namespace EARenderer {
             mSurfelLightingShader.setSurfelsGBuffer(*mSurfelData->surfelsGBuffer());
             mSurfelLightingShader.setGridProbesSHTextures(mGridProbeSHMaps);
             mSurfelLightingShader.setProbePositions(*mProbeData->probePositionsBufferTexture());
+            mSurfelLightingShader.setProbeBrickLookup(*mProbeData->brickLookupTexture());
         });
 
         mSurfelLightingShader.setLightType(LightType::Directional);
 
         mSurfelLightingShader.setLight(directionalLight);
         mSurfelLightingShader.setShadowCascades(mShadowMapper->cascades());
-        mSurfelLightingShader.setWorldBoundingBox(mScene->lightBakingVolume());
+        mSurfelLightingShader.setWorldBoundingBox(mVolume.bounds);
 
-        Drawable::TriangleStripQuad::Draw();
+        drawRows();
 
         mSurfelLightingShader.setLightType(LightType::Point);
 
@@ -111,16 +149,19 @@ namespace EARenderer {
                 mSurfelLightingShader.setOmnidirectionalShadowMap(mShadowMapper->shadowMapForPointLight(lightID));
             });
 
-            Drawable::TriangleStripQuad::Draw();
+            drawRows();
         }
 
-        glDisable(GL_BLEND);
+        GLStateCache::shared().disable(GL_BLEND);
+        GLStateCache::shared().disable(GL_SCISSOR_TEST);
     }
 
-    void IndirectLightAccumulator::averageSurfelClusterLuminances() {
+    void IndirectLightAccumulator::averageSurfelClusterLuminances(const std::vector<IndirectLightUpdateScheduler::RowRange> &rows) {
         mSurfelClusterAveragingShader.bind();
+
+        // Every texel is overwritten, so no clearing is required
         mFramebuffer.redirectRenderingToTextures(GLViewport(mSurfelClustersLuminanceMap.size()),
-                GLFramebuffer::UnderlyingBuffer::Color | GLFramebuffer::UnderlyingBuffer::Depth,
+                GLFramebuffer::UnderlyingBuffer::None,
                 &mSurfelClustersLuminanceMap);
 
         mSurfelClusterAveragingShader.ensureSamplerValidity([&]() {
@@ -128,10 +169,17 @@ namespace EARenderer {
             mSurfelClusterAveragingShader.setSurfelsLuminaceMap(mSurfelsLuminanceMap);
         });
 
-        Drawable::TriangleStripQuad::Draw();
+        GLStateCache::shared().enable(GL_SCISSOR_TEST);
+
+        for (auto &range : rows) {
+            ScissorRows(range, mSurfelClustersLuminanceMap.size());
+            Drawable::TriangleStripQuad::Draw();
+        }
+
+        GLStateCache::shared().disable(GL_SCISSOR_TEST);
     }
 
-    void IndirectLightAccumulator::updateGridProbes() {
+    void IndirectLightAccumulator::updateGridProbes(const std::vector<IndirectLightUpdateScheduler::ProbeBrick> &bricks) {
         float weight = 2.0 * M_PI;
         Color color = mScene->skybox()->ambientColor().convertedTo(EARenderer::Color::Space::YCoCg);
 
@@ -141,40 +189,92 @@ namespace EARenderer {
         skySH.convolve();
 
         GLViewport viewport(Size2D(mProbeData->gridResolution().x, mProbeData->gridResolution().y));
+        // Every texel is overwritten, so no clearing is required
         mFramebuffer.redirectRenderingToTextures(viewport,
-                GLFramebuffer::UnderlyingBuffer::Color | GLFramebuffer::UnderlyingBuffer::Depth,
+                GLFramebuffer::UnderlyingBuffer::None,
                 &(mGridProbeSHMaps)[0], &(mGridProbeSHMaps)[1], &(mGridProbeSHMaps)[2], &(mGridProbeSHMaps)[3]);
 
         mGridProbesUpdateShader.bind();
         mGridProbesUpdateShader.ensureSamplerValidity([&] {
             mGridProbesUpdateShader.setProbeProjectionsMetadata(*mProbeData->probeClusterProjectionsMetadataBufferTexture());
             mGridProbesUpdateShader.setProjectionClusterIndices(*mProbeData->projectionClusterIndicesBufferTexture());
-            mGridProbesUpdateShader.setProjectionClusterSphericalHarmonics(*mProbeData->projectionClusterSHsBufferTexture());
+            switch (mProbeData->projectionEncoding()) {
+                case DiffuseLightProbeData::ProjectionEncoding::Lossless:
+                    mGridProbesUpdateShader.setProjectionClusterSphericalHarmonics(*mProbeData->projectionClusterSHsBufferTexture());
+                    break;
+                case DiffuseLightProbeData::ProjectionEncoding::Quantized:
+                    mGridProbesUpdateShader.setProjectionClusterSphericalHarmonics(*mProbeData->quantizedProjectionClusterSHsBufferTexture());
+                    break;
+            }
             mGridProbesUpdateShader.setSurfelClustersLuminaceMap(mSurfelClustersLuminanceMap);
             mGridProbesUpdateShader.setSkySphericalHarmonics(*mProbeData->skySHsBufferTexture());
             mGridProbesUpdateShader.setProbesGridResolution(mProbeData->gridResolution());
             mGridProbesUpdateShader.setSkyColorSphericalHarmonics(skySH);
         });
 
-        Drawable::TriangleStripQuad::Draw(mProbeData->gridResolution().z);
+        // Brick's XY extents are limited by the scissor rect, Z extent - by the instanced layers
+        GLStateCache::shared().enable(GL_SCISSOR_TEST);
+
+        for (auto &brick : bricks) {
+            GLStateCache::shared().scissor(brick.origin.x, brick.origin.y, brick.size.x, brick.size.y);
+            mGridProbesUpdateShader.setLayerOffset(brick.origin.z);
+            Drawable::TriangleStripQuad::Draw(brick.size.z);
+        }
+
+        GLStateCache::shared().disable(GL_SCISSOR_TEST);
     }
 
 #pragma mark - Public Interface
 
+    void IndirectLightAccumulator::invalidate() {
+        mUpdateScheduler.invalidate();
+    }
+
     void IndirectLightAccumulator::updateProbes() {
-        relightSurfels();
-        averageSurfelClusterLuminances();
-        updateGridProbes();
+        auto lightingState = IndirectLightUpdateScheduler::CaptureLightingState(*mScene, mResourceStorage, mSettings.meshSettings.lightMultibounceEnabled);
+
+        if (lightingState.sunEnabled) {
+            mUpdateScheduler.updateShadowCascades(mShadowMapper->cascades());
+        }
+
+        IndirectLightUpdateScheduler::Plan plan;
+
+        if (mSettings.giSettings.timeSlicingEnabled) {
+            IndirectLightUpdateScheduler::Budget budget;
+            budget.surfelsPerFrame = mSettings.giSettings.surfelsPerFrame;
+            budget.probesPerFrame = mSettings.giSettings.probesPerFrame;
+            plan = mUpdateScheduler.plan(lightingState, mScene->camera()->position(), budget);
+        } else {
+            plan = mUpdateScheduler.planFullUpdate(lightingState);
+        }
+
+        if (plan.empty()) {
+            return;
+        }
+
+        if (!plan.surfelRows.empty()) {
+            relightSurfels(plan.surfelRows);
+        }
+
+        if (!plan.clusterRows.empty()) {
+            averageSurfelClusterLuminances(plan.clusterRows);
+        }
+
+        if (!plan.probeBricks.empty()) {
+            updateGridProbes(plan.probeBricks);
+        }
     }
 
-    void IndirectLightAccumulator::render() {
+    void IndirectLightAccumulator::render(const std::vector<LightBakingVolume> &activeVolumes, size_t volumeIndex) {
         mLightEvaluationShader.bind();
         mLightEvaluationShader.setCamera(*(mScene->camera()));
-        mLightEvaluationShader.setWorldBoundingBox(mScene->lightBakingVolume());
+        mLightEvaluationShader.setWorldBoundingBox(mVolume.bounds);
+        mLightEvaluationShader.setBlendedVolumes(activeVolumes, volumeIndex);
         mLightEvaluationShader.setSettings(mSettings);
         mLightEvaluationShader.ensureSamplerValidity([&]() {
             mLightEvaluationShader.setGBuffer(*mGBuffer);
             mLightEvaluationShader.setProbePositions(*mProbeData->probePositionsBufferTexture());
+            mLightEvaluationShader.setProbeBrickLookup(*mProbeData->brickLookupTexture());
             mLightEvaluationShader.setGridProbesSHTextures(mGridProbeSHMaps);
         });
 
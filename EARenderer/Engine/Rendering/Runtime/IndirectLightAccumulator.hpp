@@ -22,19 +22,24 @@
 #include "GLSLSurfelClusterAveraging.hpp"
 #include "GLSLGridLightProbesUpdate.hpp"
 #include "GLSLIndirectLightEvaluation.hpp"
+#include "IndirectLightUpdateScheduler.hpp"
+#include "LightBakingVolume.hpp"
 
 namespace EARenderer {
 
     class IndirectLightAccumulator {
     private:
         const Scene *mScene;
+        const SharedResourceStorage *mResourceStorage;
         const GPUResourceController *mGPUResourceController;
         const SceneGBuffer *mGBuffer;
         const SurfelData *mSurfelData;
         const DiffuseLightProbeData *mProbeData;
         const ShadowMapper *mShadowMapper;
+        LightBakingVolume mVolume;
 
         RenderingSettings mSettings;
+        IndirectLightUpdateScheduler mUpdateScheduler;
 
         GLSLSurfelLighting mSurfelLightingShader;
         GLSLSurfelClusterAveraging mSurfelClusterAveragingShader;
@@ -50,33 +55,59 @@ namespace EARenderer {
 
         std::array<GLLDRTexture3D, 4> gridProbeSHMaps();
 
-        void relightSurfels();
+        static void ScissorRows(const IndirectLightUpdateScheduler::RowRange &rows, const Size2D &mapSize);
 
-        void averageSurfelClusterLuminances();
+        void relightSurfels(const std::vector<IndirectLightUpdateScheduler::RowRange> &rows);
 
-        void updateGridProbes();
+        void averageSurfelClusterLuminances(const std::vector<IndirectLightUpdateScheduler::RowRange> &rows);
+
+        void updateGridProbes(const std::vector<IndirectLightUpdateScheduler::ProbeBrick> &bricks);
 
     public:
         IndirectLightAccumulator(
                 const Scene *scene,
+                const SharedResourceStorage *resourceStorage,
                 const GPUResourceController *gpuResourceController,
                 const SceneGBuffer *gBuffer,
                 const SurfelData *surfelData,
                 const DiffuseLightProbeData *probeData,
-                const ShadowMapper *shadowMapper
+                const ShadowMapper *shadowMapper,
+                const LightBakingVolume &volume
         );
 
         void setRenderingSettings(const RenderingSettings &settings);
 
+        const LightBakingVolume &volume() const;
+
+        const SurfelData *surfelData() const;
+
+        const DiffuseLightProbeData *probeData() const;
+
         const std::array<GLLDRTexture3D, 4> &gridProbesSphericalHarmonics() const;
 
         const GLFloatTexture2D<GLTexture::Float::R16F> &surfelsLuminanceMap() const;
 
         const GLFloatTexture2D<GLTexture::Float::R16F> &surfelClustersLuminanceMap() const;
 
+        /**
+         Forces all surfels and probes to be recomputed, e.g. after shadow casters have moved
+         */
+        void invalidate();
+
+        /**
+         Relights surfels and updates probes. When time slicing is enabled only a portion of surfels and probes
+         chosen by the update scheduler is recomputed, and nothing is done while the lighting is unchanged.
+         */
         void updateProbes();
 
-        void render();
+        /**
+         Evaluates indirect light of the accumulator's volume, weighted against other volumes
+         so that overlapping volumes cross-fade within their blend distances
+
+         @param activeVolumes all volumes rendered this frame
+         @param volumeIndex index of this accumulator's volume in activeVolumes
+         */
+        void render(const std::vector<LightBakingVolume> &activeVolumes, size_t volumeIndex);
     };
 
 }
@@ -0,0 +1,479 @@
+//
+// Created by Pavlo Muratov on 2019-02-02.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "IndirectLightUpdateScheduler.hpp"
+#include "GLTexture.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+namespace EARenderer {
+
+    namespace {
+
+        std::vector<IndirectLightUpdateScheduler::RowRange> MergedRows(std::vector<IndirectLightUpdateScheduler::RowRange> rows) {
+            using RowRange = IndirectLightUpdateScheduler::RowRange;
+
+            std::sort(rows.begin(), rows.end(), [](const RowRange &lhs, const RowRange &rhs) {
+                return lhs.firstRow < rhs.firstRow;
+            });
+
+            std::vector<RowRange> merged;
+            for (auto &range : rows) {
+                if (range.rowCount == 0) {
+                    continue;
+                }
+
+                if (!merged.empty() && merged.back().firstRow + merged.back().rowCount >= range.firstRow) {
+                    auto &last = merged.back();
+                    uint32_t end = std::max(last.firstRow + last.rowCount, range.firstRow + range.rowCount);
+                    last.rowCount = end - last.firstRow;
+                } else {
+                    merged.push_back(range);
+                }
+            }
+            return merged;
+        }
+
+        float DistanceToBox(const glm::vec3 &point, const AxisAlignedBox3D &box) {
+            glm::vec3 delta = glm::max(glm::max(box.min - point, point - box.max), glm::vec3(0.0));
+            return glm::length(delta);
+        }
+
+        // Same selection as in DirectionalShadows.glsl
+        uint32_t CascadeIndex(const FrustumCascades &cascades, const glm::vec4 &position) {
+            glm::vec4 positionInSplitSpace = cascades.splitSpaceMatrix * position;
+            float locationOnSplitAxis = positionInSplitSpace[int(cascades.splitAxis)] / positionInSplitSpace.w;
+
+            for (uint32_t i = 0; i < cascades.splits.size(); i++) {
+                if (locationOnSplitAxis < cascades.splits[i]) {
+                    return i;
+                }
+            }
+
+            return 0;
+        }
+
+        glm::uvec2 CascadeRange(const FrustumCascades &cascades, const AxisAlignedBox3D &bounds) {
+            glm::uvec2 range(std::numeric_limits<uint32_t>::max(), 0);
+            for (auto &corner : bounds.cornerPoints()) {
+                uint32_t cascade = CascadeIndex(cascades, corner);
+                range.x = std::min(range.x, cascade);
+                range.y = std::max(range.y, cascade);
+            }
+            return range;
+        }
+
+    }
+
+#pragma mark - Nested types
+
+    bool IndirectLightUpdateScheduler::Plan::empty() const {
+        return surfelRows.empty() && clusterRows.empty() && probeBricks.empty();
+    }
+
+    bool IndirectLightUpdateScheduler::PointLightState::operator==(const PointLightState &rhs) const {
+        return lightID == rhs.lightID &&
+                position == rhs.position &&
+                color == rhs.color &&
+                attenuation == rhs.attenuation &&
+                radius == rhs.radius &&
+                enabled == rhs.enabled;
+    }
+
+    bool IndirectLightUpdateScheduler::PointLightState::operator!=(const PointLightState &rhs) const {
+        return !(*this == rhs);
+    }
+
+    bool IndirectLightUpdateScheduler::LightingState::operator==(const LightingState &rhs) const {
+        return sunDirection == rhs.sunDirection &&
+                sunColor == rhs.sunColor &&
+                sunArea == rhs.sunArea &&
+                sunShadowBias == rhs.sunShadowBias &&
+                sunEnabled == rhs.sunEnabled &&
+                ambientColor == rhs.ambientColor &&
+                pointLights == rhs.pointLights &&
+                emissiveColors == rhs.emissiveColors &&
+                multibounceEnabled == rhs.multibounceEnabled;
+    }
+
+    bool IndirectLightUpdateScheduler::LightingState::operator!=(const LightingState &rhs) const {
+        return !(*this == rhs);
+    }
+
+#pragma mark - Lifecycle
+
+    IndirectLightUpdateScheduler::IndirectLightUpdateScheduler(const SurfelData &surfelData, const DiffuseLightProbeData &probeData) {
+        buildSlices(surfelData);
+        buildBricks(probeData);
+    }
+
+#pragma mark - Static
+
+    IndirectLightUpdateScheduler::LightingState IndirectLightUpdateScheduler::CaptureLightingState(
+            const Scene &scene, const SharedResourceStorage *resourceStorage, bool multibounceEnabled) {
+
+        LightingState state;
+
+        const DirectionalLight &sun = scene.sun();
+        state.sunDirection = sun.direction();
+        state.sunColor = sun.color().rgb();
+        state.sunArea = sun.area();
+        state.sunShadowBias = sun.shadowBias();
+        state.sunEnabled = sun.isEnabled();
+
+        if (scene.skybox()) {
+            state.ambientColor = scene.skybox()->ambientColor().rgb();
+        }
+
+        for (ID lightID : scene.pointLights()) {
+            const PointLight &light = scene.pointLights()[lightID];
+
+            PointLightState lightState;
+            lightState.lightID = lightID;
+            lightState.position = light.position();
+            lightState.color = light.color().rgb();
+            lightState.attenuation = glm::vec3(light.attenuation.constant, light.attenuation.linear, light.attenuation.quadratic);
+            lightState.radius = light.radius();
+            lightState.enabled = light.isEnabled();
+
+            state.pointLights.push_back(lightState);
+        }
+
+        if (resourceStorage) {
+            resourceStorage->iterateEmissiveMaterials([&](ID materialID) {
+                state.emissiveColors.push_back(resourceStorage->emissiveMaterial(materialID).emissionColor.rgb());
+            });
+        }
+
+        state.multibounceEnabled = multibounceEnabled;
+
+        return state;
+    }
+
+#pragma mark - Private Helpers
+
+    void IndirectLightUpdateScheduler::buildSlices(const SurfelData &surfelData) {
+        const auto &surfels = surfelData.surfels();
+        const auto &allClusters = surfelData.surfelClusters();
+
+        if (surfels.empty()) {
+            return;
+        }
+
+        uint32_t mapWidth = GLTexture::EstimatedSize(surfels.size()).width;
+        uint32_t clusterMapWidth = std::max<uint32_t>(GLTexture::EstimatedSize(allClusters.size()).width, 1);
+
+        // Only leaf clusters are sorted by surfel offset
+        std::vector<SurfelCluster> clusters(allClusters.begin(), allClusters.begin() + surfelData.leafSurfelClusterCount());
+
+        if (allClusters.size() > clusters.size()) {
+            uint32_t firstParentRow = uint32_t(clusters.size()) / clusterMapWidth;
+            uint32_t lastParentRow = uint32_t(allClusters.size() - 1) / clusterMapWidth;
+            mParentClusterRows = {firstParentRow, lastParentRow - firstParentRow + 1};
+        }
+        uint32_t rowsPerSlice = std::max<uint32_t>(TargetSurfelsPerSlice / mapWidth, 1);
+        uint32_t rowCount = (uint32_t(surfels.size()) + mapWidth - 1) / mapWidth;
+
+        mSurfelsPerSlice = rowsPerSlice * mapWidth;
+
+        for (uint32_t row = 0; row < rowCount; row += rowsPerSlice) {
+            Slice slice;
+            slice.rows = {row, std::min(rowsPerSlice, rowCount - row)};
+
+            size_t firstSurfel = size_t(row) * mapWidth;
+            size_t endSurfel = std::min(size_t(row + slice.rows.rowCount) * mapWidth, surfels.size());
+
+            for (size_t i = firstSurfel; i < endSurfel; i++) {
+                slice.bounds.min = glm::min(slice.bounds.min, surfels[i].position);
+                slice.bounds.max = glm::max(slice.bounds.max, surfels[i].position);
+            }
+
+            // Clusters store contiguous surfel ranges in ascending order,
+            // so all clusters touching the slice form a contiguous range as well
+            auto firstClusterIt = std::upper_bound(clusters.begin(), clusters.end(), firstSurfel, [](size_t surfelIndex, const SurfelCluster &cluster) {
+                return surfelIndex < cluster.surfelOffset + cluster.surfelCount;
+            });
+            auto endClusterIt = std::lower_bound(clusters.begin(), clusters.end(), endSurfel, [](const SurfelCluster &cluster, size_t surfelIndex) {
+                return cluster.surfelOffset < surfelIndex;
+            });
+
+            if (firstClusterIt < endClusterIt) {
+                uint32_t firstClusterRow = uint32_t(firstClusterIt - clusters.begin()) / clusterMapWidth;
+                uint32_t lastClusterRow = uint32_t(endClusterIt - clusters.begin() - 1) / clusterMapWidth;
+                slice.clusterRows = {firstClusterRow, lastClusterRow - firstClusterRow + 1};
+            }
+
+            mSlices.push_back(slice);
+        }
+    }
+
+    void IndirectLightUpdateScheduler::buildBricks(const DiffuseLightProbeData &probeData) {
+        glm::uvec3 resolution = glm::max(probeData.gridResolution(), glm::ivec3(0));
+        const auto &probes = probeData.probes();
+
+        if (probes.size() < size_t(resolution.x) * resolution.y * resolution.z) {
+            return;
+        }
+
+        mProbesPerBrick = ProbeBrickDimension * ProbeBrickDimension * ProbeBrickDimension;
+
+        for (uint32_t z = 0; z < resolution.z; z += ProbeBrickDimension) {
+            for (uint32_t y = 0; y < resolution.y; y += ProbeBrickDimension) {
+                for (uint32_t x = 0; x < resolution.x; x += ProbeBrickDimension) {
+                    Brick brick;
+                    brick.brick.origin = glm::uvec3(x, y, z);
+                    brick.brick.size = glm::min(glm::uvec3(ProbeBrickDimension), resolution - brick.brick.origin);
+
+                    glm::uvec3 end = brick.brick.origin + brick.brick.size;
+                    for (uint32_t pz = z; pz < end.z; pz++) {
+                        for (uint32_t py = y; py < end.y; py++) {
+                            for (uint32_t px = x; px < end.x; px++) {
+                                // Same flattening as in GridLightProbesUpdate.frag
+                                size_t index = size_t(resolution.y) * resolution.x * pz + resolution.x * py + px;
+                                if (probes[index].isValid) {
+                                    brick.bounds.min = glm::min(brick.bounds.min, probes[index].position);
+                                    brick.bounds.max = glm::max(brick.bounds.max, probes[index].position);
+                                }
+                            }
+                        }
+                    }
+
+                    // Bricks made only of unused atlas slots or embedded probes are never sampled
+                    if (brick.bounds.min.x <= brick.bounds.max.x) {
+                        mBricks.push_back(brick);
+                    }
+                }
+            }
+        }
+    }
+
+    void IndirectLightUpdateScheduler::registerLightingChange(const LightingState &newState) {
+        const LightingState &oldState = *mLastLightingState;
+
+        mHotspots.clear();
+
+        // Changed point lights get their old and new areas of influence updated first
+        auto findLight = [](const LightingState &state, ID lightID) -> const PointLightState * {
+            for (auto &light : state.pointLights) {
+                if (light.lightID == lightID) { return &light; }
+            }
+            return nullptr;
+        };
+
+        auto addHotspot = [&](const PointLightState *light) {
+            if (light && light->enabled) {
+                mHotspots.push_back({light->position, light->radius});
+            }
+        };
+
+        for (auto &light : newState.pointLights) {
+            const PointLightState *previous = findLight(oldState, light.lightID);
+            if (!previous || *previous != light) {
+                addHotspot(previous);
+                addHotspot(&light);
+            }
+        }
+
+        for (auto &light : oldState.pointLights) {
+            if (!findLight(newState, light.lightID)) {
+                addHotspot(&light);
+            }
+        }
+
+        for (auto &slice : mSlices) { slice.dirty = true; }
+        for (auto &brick : mBricks) { brick.dirty = true; }
+
+        mPendingSweeps = newState.multibounceEnabled ? MultibounceSweepCount : 1;
+        mLastLightingState = newState;
+    }
+
+    bool IndirectLightUpdateScheduler::intersectsHotspot(const AxisAlignedBox3D &bounds) const {
+        for (auto &hotspot : mHotspots) {
+            if (DistanceToBox(hotspot.center, bounds) <= hotspot.radius) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template<class Unit>
+    std::vector<size_t> IndirectLightUpdateScheduler::selectUnits(std::vector<Unit> &units, size_t budget, size_t &cursor, const glm::vec3 &cameraPosition) {
+        std::vector<size_t> selected;
+
+        if (units.empty() || budget == 0) {
+            return selected;
+        }
+
+        // Round-robin half of the budget guarantees that every region is eventually refreshed
+        size_t roundRobinBudget = std::max<size_t>(budget / 2, 1);
+        size_t visited = 0;
+
+        for (; visited < units.size() && selected.size() < roundRobinBudget; visited++) {
+            size_t index = (cursor + visited) % units.size();
+            if (units[index].dirty) {
+                units[index].dirty = false;
+                selected.push_back(index);
+            }
+        }
+
+        cursor = (cursor + visited) % units.size();
+
+        // The rest goes to the regions affected by changed lights and then to the regions closest to the camera.
+        // Ties are broken by index to keep selection deterministic.
+        std::vector<std::pair<float, size_t>> candidates;
+        for (size_t i = 0; i < units.size(); i++) {
+            if (!units[i].dirty) {
+                continue;
+            }
+            float key = intersectsHotspot(units[i].bounds) ? -1.0f : DistanceToBox(cameraPosition, units[i].bounds);
+            candidates.emplace_back(key, i);
+        }
+
+        size_t priorityBudget = std::min(budget - selected.size(), candidates.size());
+        std::partial_sort(candidates.begin(), candidates.begin() + priorityBudget, candidates.end());
+
+        for (size_t i = 0; i < priorityBudget; i++) {
+            units[candidates[i].second].dirty = false;
+            selected.push_back(candidates[i].second);
+        }
+
+        std::sort(selected.begin(), selected.end());
+
+        return selected;
+    }
+
+    IndirectLightUpdateScheduler::Plan IndirectLightUpdateScheduler::fullPlan() const {
+        Plan plan;
+        plan.isFullUpdate = true;
+
+        std::vector<RowRange> clusterRows;
+        for (auto &slice : mSlices) {
+            plan.surfelRows.push_back(slice.rows);
+            clusterRows.push_back(slice.clusterRows);
+        }
+
+        if (mParentClusterRows.rowCount > 0) {
+            clusterRows.push_back(mParentClusterRows);
+        }
+
+        for (auto &brick : mBricks) {
+            plan.probeBricks.push_back(brick.brick);
+        }
+
+        plan.surfelRows = MergedRows(plan.surfelRows);
+        plan.clusterRows = MergedRows(clusterRows);
+
+        return plan;
+    }
+
+#pragma mark - Public Interface
+
+    void IndirectLightUpdateScheduler::invalidate() {
+        if (mLastLightingState) {
+            LightingState state = *mLastLightingState;
+            registerLightingChange(state);
+        }
+    }
+
+    void IndirectLightUpdateScheduler::updateShadowCascades(const FrustumCascades &cascades) {
+        for (auto &slice : mSlices) {
+            glm::uvec2 range = CascadeRange(cascades, slice.bounds);
+            // Surfels sampling the same cascades only see shadow map texels shift, which isn't worth a relight
+            if (mHasShadowCascades && range != slice.cascades) {
+                slice.dirty = true;
+            }
+            slice.cascades = range;
+        }
+
+        mHasShadowCascades = true;
+    }
+
+    bool IndirectLightUpdateScheduler::isConverged() const {
+        if (!mLastLightingState || mPendingSweeps > 1) {
+            return false;
+        }
+
+        bool slicesClean = std::none_of(mSlices.begin(), mSlices.end(), [](const Slice &slice) { return slice.dirty; });
+        bool bricksClean = std::none_of(mBricks.begin(), mBricks.end(), [](const Brick &brick) { return brick.dirty; });
+
+        return slicesClean && bricksClean;
+    }
+
+    IndirectLightUpdateScheduler::Plan IndirectLightUpdateScheduler::plan(const LightingState &lightingState, const glm::vec3 &cameraPosition, const Budget &budget) {
+        // Nothing has been computed yet
+        if (!mLastLightingState) {
+            return planFullUpdate(lightingState);
+        }
+
+        if (lightingState != *mLastLightingState) {
+            registerLightingChange(lightingState);
+        }
+
+        if (isConverged()) {
+            mPendingSweeps = 0;
+            mHotspots.clear();
+            return Plan();
+        }
+
+        // Start another sweep to propagate the next light bounce
+        bool slicesClean = std::none_of(mSlices.begin(), mSlices.end(), [](const Slice &slice) { return slice.dirty; });
+        bool bricksClean = std::none_of(mBricks.begin(), mBricks.end(), [](const Brick &brick) { return brick.dirty; });
+
+        if (slicesClean && bricksClean) {
+            mPendingSweeps--;
+            for (auto &slice : mSlices) { slice.dirty = true; }
+        }
+
+        Plan plan;
+
+        size_t sliceBudget = std::max<size_t>(budget.surfelsPerFrame / mSurfelsPerSlice, 1);
+        size_t brickBudget = std::max<size_t>(budget.probesPerFrame / mProbesPerBrick, 1);
+
+        std::vector<size_t> slices = selectUnits(mSlices, sliceBudget, mSliceCursor, cameraPosition);
+
+        std::vector<RowRange> clusterRows;
+        for (size_t index : slices) {
+            plan.surfelRows.push_back(mSlices[index].rows);
+            clusterRows.push_back(mSlices[index].clusterRows);
+        }
+
+        // Probes gather luminance from clusters, so as long as surfels keep changing
+        // every probe has to be refreshed once more
+        if (!slices.empty()) {
+            for (auto &brick : mBricks) { brick.dirty = true; }
+
+            if (mParentClusterRows.rowCount > 0) {
+                clusterRows.push_back(mParentClusterRows);
+            }
+        }
+
+        for (size_t index : selectUnits(mBricks, brickBudget, mBrickCursor, cameraPosition)) {
+            plan.probeBricks.push_back(mBricks[index].brick);
+        }
+
+        plan.surfelRows = MergedRows(plan.surfelRows);
+        plan.clusterRows = MergedRows(clusterRows);
+
+        return plan;
+    }
+
+    IndirectLightUpdateScheduler::Plan IndirectLightUpdateScheduler::planFullUpdate(const LightingState &lightingState) {
+        mLastLightingState = lightingState;
+        mHotspots.clear();
+
+        for (auto &slice : mSlices) { slice.dirty = false; }
+        for (auto &brick : mBricks) { brick.dirty = false; }
+
+        // Full update counts as the first sweep
+        mPendingSweeps = lightingState.multibounceEnabled ? MultibounceSweepCount : 1;
+
+        return fullPlan();
+    }
+
+}
@@ -0,0 +1,202 @@
+//
+// Created by Pavlo Muratov on 2019-02-02.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_INDIRECTLIGHTUPDATESCHEDULER_HPP
+#define EARENDERER_INDIRECTLIGHTUPDATESCHEDULER_HPP
+
+#include "Scene.hpp"
+#include "SharedResourceStorage.hpp"
+#include "SurfelData.hpp"
+#include "DiffuseLightProbeData.hpp"
+#include "AxisAlignedBox3D.hpp"
+#include "Size2D.hpp"
+#include "FrustumCascades.hpp"
+
+#include <vector>
+#include <optional>
+
+#include <glm/vec3.hpp>
+
+namespace EARenderer {
+
+    /**
+     Decides which portions of the GI data have to be recomputed during a frame.
+
+     Surfels and surfel clusters are split into slices of luminance map rows, probe grid is split into bricks.
+     Slices and bricks are updated under a per-frame budget: half of the budget is spent in round-robin order,
+     the other half on regions closest to the camera or affected by changed lights.
+     Nothing is scheduled while the lighting stays the same and all the data has converged.
+
+     Plans depend solely on scheduler's state and the arguments passed in (never on time),
+     so a sequence of frames always produces the same sequence of plans.
+     */
+    class IndirectLightUpdateScheduler {
+    public:
+
+#pragma mark - Nested types
+
+        struct Budget {
+            uint32_t surfelsPerFrame = 0;
+            uint32_t probesPerFrame = 0;
+        };
+
+        struct RowRange {
+            uint32_t firstRow = 0;
+            uint32_t rowCount = 0;
+        };
+
+        struct ProbeBrick {
+            glm::uvec3 origin;
+            glm::uvec3 size;
+        };
+
+        struct Plan {
+            std::vector<RowRange> surfelRows;
+            std::vector<RowRange> clusterRows;
+            std::vector<ProbeBrick> probeBricks;
+            bool isFullUpdate = false;
+
+            bool empty() const;
+        };
+
+        struct PointLightState {
+            ID lightID = 0;
+            glm::vec3 position;
+            glm::vec3 color;
+            glm::vec3 attenuation;
+            float radius = 0.0;
+            bool enabled = false;
+
+            bool operator==(const PointLightState &rhs) const;
+
+            bool operator!=(const PointLightState &rhs) const;
+        };
+
+        /**
+         Everything that affects the result of surfel relighting and probe update
+         */
+        struct LightingState {
+            glm::vec3 sunDirection;
+            glm::vec3 sunColor;
+            float sunArea = 0.0;
+            float sunShadowBias = 0.0;
+            bool sunEnabled = false;
+            glm::vec3 ambientColor;
+            std::vector<PointLightState> pointLights;
+            std::vector<glm::vec3> emissiveColors;
+            bool multibounceEnabled = false;
+
+            bool operator==(const LightingState &rhs) const;
+
+            bool operator!=(const LightingState &rhs) const;
+        };
+
+    private:
+        struct Slice {
+            RowRange rows;
+            RowRange clusterRows;
+            AxisAlignedBox3D bounds = AxisAlignedBox3D::MaximumReversed();
+            // First and last sun shadow cascade covering the bounds
+            glm::uvec2 cascades = glm::uvec2(0);
+            bool dirty = true;
+        };
+
+        struct Brick {
+            ProbeBrick brick;
+            AxisAlignedBox3D bounds = AxisAlignedBox3D::MaximumReversed();
+            bool dirty = true;
+        };
+
+        struct Hotspot {
+            glm::vec3 center;
+            float radius;
+        };
+
+        // Amount of sweeps over all the data after a lighting change
+        // to let multiple light bounces propagate through surfels and probes
+        static constexpr uint32_t MultibounceSweepCount = 3;
+
+        static constexpr uint32_t TargetSurfelsPerSlice = 4096;
+        static constexpr uint32_t ProbeBrickDimension = 4;
+
+        std::vector<Slice> mSlices;
+        // Parent clusters of the surfel hierarchy sample surfels from many slices
+        RowRange mParentClusterRows;
+        std::vector<Brick> mBricks;
+        uint32_t mSurfelsPerSlice = 1;
+        uint32_t mProbesPerBrick = 1;
+        size_t mSliceCursor = 0;
+        size_t mBrickCursor = 0;
+        uint32_t mPendingSweeps = 0;
+        std::vector<Hotspot> mHotspots;
+        std::optional<LightingState> mLastLightingState;
+        bool mHasShadowCascades = false;
+
+        void buildSlices(const SurfelData &surfelData);
+
+        void buildBricks(const DiffuseLightProbeData &probeData);
+
+        void registerLightingChange(const LightingState &newState);
+
+        bool intersectsHotspot(const AxisAlignedBox3D &bounds) const;
+
+        template<class Unit>
+        std::vector<size_t> selectUnits(std::vector<Unit> &units, size_t budget, size_t &cursor, const glm::vec3 &cameraPosition);
+
+        Plan fullPlan() const;
+
+    public:
+        IndirectLightUpdateScheduler(const SurfelData &surfelData, const DiffuseLightProbeData &probeData);
+
+        /**
+         Captures lighting parameters relevant for the indirect light computation
+
+         @param scene scene containing lights and sky
+         @param resourceStorage optional storage of emissive materials
+         @param multibounceEnabled whether surfels receive light from the probes
+         @return snapshot of the lighting state that can be compared between frames
+         */
+        static LightingState CaptureLightingState(const Scene &scene, const SharedResourceStorage *resourceStorage, bool multibounceEnabled);
+
+        /**
+         Sun's shadow cascades follow the camera. Slices whose surfels move to other cascades are scheduled
+         for a single relighting pass, while the rest of the data and pending light bounces are left intact.
+
+         @param cascades shadow cascades of the sun surfels are relit with
+         */
+        void updateShadowCascades(const FrustumCascades &cascades);
+
+        /**
+         Forces all the data to be recomputed on the following frames, e.g. when shadow casters have moved
+         */
+        void invalidate();
+
+        /**
+         @return true if all data reflects the most recent lighting state
+         */
+        bool isConverged() const;
+
+        /**
+         Produces a list of regions to be updated this frame and marks them as up to date
+
+         @param lightingState current lighting state
+         @param cameraPosition point of view used to prioritize nearby regions
+         @param budget maximum amount of surfels and probes to update
+         @return update plan for the current frame
+         */
+        Plan plan(const LightingState &lightingState, const glm::vec3 &cameraPosition, const Budget &budget);
+
+        /**
+         Produces a plan covering everything, used as a reference for the time-sliced path
+
+         @param lightingState current lighting state
+         @return update plan covering all surfels, clusters and probes
+         */
+        Plan planFullUpdate(const LightingState &lightingState);
+    };
+
+}
+
+#endif //EARENDERER_INDIRECTLIGHTUPDATESCHEDULER_HPP
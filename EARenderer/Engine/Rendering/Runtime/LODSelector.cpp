@@ -0,0 +1,106 @@
+//
+// Created by Pavlo Muratov on 2019-02-15.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "LODSelector.hpp"
+
+#include <glm/geometric.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace EARenderer {
+
+    namespace {
+
+        glm::vec4 Row(const glm::mat4 &m, glm::length_t i) {
+            return {m[0][i], m[1][i], m[2][i], m[3][i]};
+        }
+
+        // Largest stretch the matrix applies to a unit vector, given it is free of shear
+        float MaximumScale(const glm::mat4 &m) {
+            return std::max({glm::length(glm::vec3(m[0])), glm::length(glm::vec3(m[1])), glm::length(glm::vec3(m[2]))});
+        }
+
+    }
+
+#pragma mark - Lifecycle
+
+    LODSelector::LODSelector(const glm::mat4 &viewProjection, const Size2D &viewportSize, float maximumScreenSpaceError)
+            :
+            mViewProjection(viewProjection),
+            mPixelsPerUnit(std::max(glm::length(glm::vec3(Row(viewProjection, 0))) * viewportSize.width,
+                                    glm::length(glm::vec3(Row(viewProjection, 1))) * viewportSize.height) / 2.0f),
+            mMaximumScreenSpaceError(maximumScreenSpaceError) {
+    }
+
+#pragma mark - Private helpers
+
+    std::array<glm::vec4, 8> LODSelector::clipSpaceCorners(const SubMesh &subMesh, const glm::mat4 &modelMatrix) const {
+        auto corners = subMesh.boundingBox().cornerPoints();
+        glm::mat4 modelViewProjection = mViewProjection * modelMatrix;
+        for (auto &corner : corners) {
+            corner = modelViewProjection * corner;
+        }
+        return corners;
+    }
+
+#pragma mark - Selection
+
+    bool LODSelector::isPotentiallyVisible(const SubMesh &subMesh, const glm::mat4 &modelMatrix) const {
+        auto corners = clipSpaceCorners(subMesh, modelMatrix);
+
+        // Invisible if all corners are outside of the same clipping plane
+        for (glm::length_t axis = 0; axis < 3; axis++) {
+            bool allBelow = true;
+            bool allAbove = true;
+            for (auto &corner : corners) {
+                allBelow = allBelow && corner[axis] < -corner.w;
+                allAbove = allAbove && corner[axis] > corner.w;
+            }
+            if (allBelow || allAbove) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    float LODSelector::pixelsPerMeshUnit(const SubMesh &subMesh, const glm::mat4 &modelMatrix) const {
+        // Clip space w is the view depth for perspective projections and 1 for orthographic ones.
+        // Distances are projected at the nearest corner of the bounding box.
+        float nearestDepth = std::numeric_limits<float>::max();
+        for (auto &corner : clipSpaceCorners(subMesh, modelMatrix)) {
+            nearestDepth = std::min(nearestDepth, corner.w);
+        }
+
+        // The view is inside of or very close to the bounding box
+        if (nearestDepth <= std::numeric_limits<float>::epsilon()) {
+            return std::numeric_limits<float>::infinity();
+        }
+
+        return mPixelsPerUnit * MaximumScale(modelMatrix) / nearestDepth;
+    }
+
+    size_t LODSelector::select(const SubMesh &subMesh, const glm::mat4 &modelMatrix) const {
+        if (subMesh.lodCount() == 1) {
+            return 0;
+        }
+
+        float pixelsPerMeshUnit = this->pixelsPerMeshUnit(subMesh, modelMatrix);
+
+        if (std::isinf(pixelsPerMeshUnit)) {
+            return 0;
+        }
+
+        for (size_t lod = subMesh.lodCount() - 1; lod > 0; lod--) {
+            if (subMesh.lodError(lod) * pixelsPerMeshUnit <= mMaximumScreenSpaceError) {
+                return lod;
+            }
+        }
+
+        return 0;
+    }
+
+}
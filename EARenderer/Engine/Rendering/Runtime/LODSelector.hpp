@@ -0,0 +1,60 @@
+//
+// Created by Pavlo Muratov on 2019-02-15.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_LODSELECTOR_HPP
+#define EARENDERER_LODSELECTOR_HPP
+
+#include "SubMesh.hpp"
+#include "Size2D.hpp"
+
+#include <glm/mat4x4.hpp>
+#include <array>
+
+namespace EARenderer {
+
+    /**
+     Picks the coarsest sub mesh LOD whose error, projected onto a view, stays under a limit in pixels.
+     Works for perspective as well as orthographic views, given their view-projection matrix.
+     */
+    class LODSelector {
+    private:
+        glm::mat4 mViewProjection;
+        // Pixels covered by a world space unit at unit depth (at any depth for orthographic views)
+        float mPixelsPerUnit;
+        float mMaximumScreenSpaceError;
+
+        std::array<glm::vec4, 8> clipSpaceCorners(const SubMesh &subMesh, const glm::mat4 &modelMatrix) const;
+
+    public:
+        /**
+         @param viewProjection view-projection matrix of the view
+         @param viewportSize size of the view's render target in pixels
+         @param maximumScreenSpaceError largest acceptable geometric error in pixels
+         */
+        LODSelector(const glm::mat4 &viewProjection, const Size2D &viewportSize, float maximumScreenSpaceError);
+
+        /**
+         Conservative frustum test of the sub mesh bounding box
+
+         @return false if the sub mesh is certainly outside of the view
+         */
+        bool isPotentiallyVisible(const SubMesh &subMesh, const glm::mat4 &modelMatrix) const;
+
+        /**
+         Projects a mesh space distance at the nearest corner of the sub mesh bounding box
+
+         @return pixels covered by a mesh space unit, infinity if the view is inside of the bounding box
+         */
+        float pixelsPerMeshUnit(const SubMesh &subMesh, const glm::mat4 &modelMatrix) const;
+
+        /**
+         @return index of the LOD to draw the sub mesh with, 0 being the full resolution
+         */
+        size_t select(const SubMesh &subMesh, const glm::mat4 &modelMatrix) const;
+    };
+
+}
+
+#endif //EARENDERER_LODSELECTOR_HPP
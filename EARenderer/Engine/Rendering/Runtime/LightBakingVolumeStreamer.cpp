@@ -0,0 +1,302 @@
+//
+// Created by Pavlo Muratov on 2019-02-05.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "LightBakingVolumeStreamer.hpp"
+#include "Profiler.hpp"
+#include "MemoryTracker.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace EARenderer {
+
+#pragma mark - Lifecycle
+
+    LightBakingVolumeStreamer::LightBakingVolumeStreamer(
+            const Scene *scene,
+            const SharedResourceStorage *resourceStorage,
+            const GPUResourceController *gpuResourceController,
+            const SceneGBuffer *gBuffer,
+            const ShadowMapper *shadowMapper,
+            const LightBakingVolumeCache *cache)
+            :
+            LightBakingVolumeStreamer(scene, resourceStorage, gpuResourceController, gBuffer, shadowMapper, cache, &ThreadPool::Default()) {
+    }
+
+    LightBakingVolumeStreamer::LightBakingVolumeStreamer(
+            const Scene *scene,
+            const SharedResourceStorage *resourceStorage,
+            const GPUResourceController *gpuResourceController,
+            const SceneGBuffer *gBuffer,
+            const ShadowMapper *shadowMapper,
+            const LightBakingVolumeCache *cache,
+            ThreadPool *threadPool)
+            :
+            mScene(scene),
+            mResourceStorage(resourceStorage),
+            mGPUResourceController(gpuResourceController),
+            mGBuffer(gBuffer),
+            mShadowMapper(shadowMapper),
+            mCache(cache),
+            mThreadPool(threadPool) {
+    }
+
+    LightBakingVolumeStreamer::~LightBakingVolumeStreamer() {
+        // Futures block until their tasks are done
+        mPendingLoads.clear();
+    }
+
+#pragma mark - Getters / Setters
+
+    void LightBakingVolumeStreamer::setRenderingSettings(const RenderingSettings &settings) {
+        mSettings = settings;
+        distributeUpdateBudget();
+    }
+
+    uint64_t LightBakingVolumeStreamer::residencyVersion() const {
+        return mResidencyVersion;
+    }
+
+    size_t LightBakingVolumeStreamer::residentVolumeCount() const {
+        return mResidentVolumes.size();
+    }
+
+    const IndirectLightAccumulator *LightBakingVolumeStreamer::closestAccumulator(const glm::vec3 &point) const {
+        const IndirectLightAccumulator *closest = nullptr;
+        float closestDistance = std::numeric_limits<float>::max();
+
+        for (auto &resident : mResidentVolumes) {
+            float distance = resident.volume.distance(point);
+            if (distance < closestDistance) {
+                closestDistance = distance;
+                closest = resident.accumulator.get();
+            }
+        }
+
+        return closest;
+    }
+
+#pragma mark - Private helpers
+
+    bool LightBakingVolumeStreamer::isResident(const LightBakingVolume &volume) const {
+        return std::any_of(mResidentVolumes.begin(), mResidentVolumes.end(), [&](const ResidentVolume &resident) {
+            return resident.volume.name == volume.name;
+        });
+    }
+
+    bool LightBakingVolumeStreamer::isWanted(const LightBakingVolume &volume,
+                                             const std::vector<LightBakingVolume> &volumes,
+                                             const glm::vec3 &cameraPosition,
+                                             const std::string &closestVolumeName) const {
+        // Volumes removed from the scene or changed since loading aren't wanted anymore
+        bool isStillInScene = std::any_of(volumes.begin(), volumes.end(), [&](const LightBakingVolume &sceneVolume) {
+            return sceneVolume.name == volume.name &&
+                   sceneVolume.bounds.min == volume.bounds.min &&
+                   sceneVolume.bounds.max == volume.bounds.max;
+        });
+
+        if (!isStillInScene) {
+            return false;
+        }
+
+        return volume.name == closestVolumeName || volume.distance(cameraPosition) <= mSettings.giSettings.volumeDeactivationDistance;
+    }
+
+    void LightBakingVolumeStreamer::issueLoad(const LightBakingVolume &volume) {
+        // Paths depend on the scene, so they're resolved here rather than on a worker
+        auto files = mCache->files(volume);
+        auto volumeName = volume.name;
+
+        auto task = mThreadPool->submit([this, volumeName, files] {
+            CompletedLoad load;
+            load.volumeName = volumeName;
+
+            try {
+                load.data = LightBakingVolumeCache::Read(files);
+            } catch (...) {
+                load.exception = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(mCompletedLoadsMutex);
+            mCompletedLoads.emplace_back(std::move(load));
+        });
+
+        mPendingLoads.emplace(volume.name, PendingLoad{volume, std::move(task)});
+    }
+
+    void LightBakingVolumeStreamer::activate(const LightBakingVolume &volume, std::unique_ptr<LightBakingVolumeCache::VolumeData> data) {
+        MemoryTracker::Scope memoryScope(MemoryTag::DiffuseLightProbes);
+        LightBakingVolumeCache::Upload(*data);
+
+        ResidentVolume resident;
+        resident.volume = volume;
+        resident.accumulator = std::make_unique<IndirectLightAccumulator>(
+                mScene, mResourceStorage, mGPUResourceController, mGBuffer,
+                data->surfelData.get(), data->probeData.get(), mShadowMapper, volume
+        );
+        resident.data = std::move(data);
+
+        mResidentVolumes.push_back(std::move(resident));
+        mResidencyVersion++;
+    }
+
+    void LightBakingVolumeStreamer::processCompletedLoads(const std::vector<LightBakingVolume> &volumes,
+                                                          const glm::vec3 &cameraPosition,
+                                                          const std::string &closestVolumeName) {
+        std::vector<CompletedLoad> completedLoads;
+        {
+            std::lock_guard<std::mutex> lock(mCompletedLoadsMutex);
+            completedLoads.swap(mCompletedLoads);
+        }
+
+        // Failures are reported once every load is processed, so that none of them stays pending forever
+        std::exception_ptr exception;
+
+        for (auto &load : completedLoads) {
+            auto pendingIt = mPendingLoads.find(load.volumeName);
+            LightBakingVolume volume = pendingIt->second.volume;
+            mPendingLoads.erase(pendingIt);
+
+            if (load.exception) {
+                exception = load.exception;
+                continue;
+            }
+
+            // Volumes that aren't baked yet are requested again by later updates
+            if (!load.data || !isWanted(volume, volumes, cameraPosition, closestVolumeName) || mResidentVolumes.size() >= MaximumResidentVolumeCount) {
+                continue;
+            }
+
+            activate(volume, std::move(load.data));
+        }
+
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+
+    void LightBakingVolumeStreamer::finishPendingLoad(const std::string &volumeName) {
+        auto pendingIt = mPendingLoads.find(volumeName);
+        if (pendingIt == mPendingLoads.end()) {
+            return;
+        }
+
+        // Blocks until the read is done, the load stays registered until it's processed
+        pendingIt->second.task.get();
+    }
+
+    void LightBakingVolumeStreamer::deactivateDistantVolumes(const std::vector<LightBakingVolume> &volumes,
+                                                             const glm::vec3 &cameraPosition,
+                                                             const std::string &closestVolumeName) {
+        auto isDistant = [&](const ResidentVolume &resident) {
+            return !isWanted(resident.volume, volumes, cameraPosition, closestVolumeName);
+        };
+
+        auto firstDistant = std::remove_if(mResidentVolumes.begin(), mResidentVolumes.end(), isDistant);
+        if (firstDistant != mResidentVolumes.end()) {
+            mResidentVolumes.erase(firstDistant, mResidentVolumes.end());
+            mResidencyVersion++;
+        }
+    }
+
+    void LightBakingVolumeStreamer::activateNearbyVolumes(const std::vector<LightBakingVolume> &volumes,
+                                                          const glm::vec3 &cameraPosition,
+                                                          const std::string &closestVolumeName) {
+        std::vector<const LightBakingVolume *> candidates;
+        for (auto &volume : volumes) {
+            bool isNearby = volume.name == closestVolumeName || volume.distance(cameraPosition) <= mSettings.giSettings.volumeActivationDistance;
+            if (isNearby && !isResident(volume) && mPendingLoads.find(volume.name) == mPendingLoads.end()) {
+                candidates.push_back(&volume);
+            }
+        }
+
+        std::sort(candidates.begin(), candidates.end(), [&](const LightBakingVolume *lhs, const LightBakingVolume *rhs) {
+            return lhs->distance(cameraPosition) < rhs->distance(cameraPosition);
+        });
+
+        // Closest volume is requested regardless of the per-frame limit when nothing is resident or on its way
+        bool isEmpty = mResidentVolumes.empty() && mPendingLoads.empty();
+        uint32_t activationsLeft = std::max(mSettings.giSettings.volumeActivationsPerFrame, isEmpty ? 1u : 0u);
+
+        for (auto candidate : candidates) {
+            if (activationsLeft == 0 || mResidentVolumes.size() + mPendingLoads.size() >= MaximumResidentVolumeCount) {
+                break;
+            }
+
+            issueLoad(*candidate);
+            activationsLeft--;
+        }
+    }
+
+    void LightBakingVolumeStreamer::distributeUpdateBudget() {
+        RenderingSettings volumeSettings = mSettings;
+        uint32_t residentCount = std::max<uint32_t>(uint32_t(mResidentVolumes.size()), 1);
+        volumeSettings.giSettings.surfelsPerFrame = std::max<uint32_t>(mSettings.giSettings.surfelsPerFrame / residentCount, 1);
+        volumeSettings.giSettings.probesPerFrame = std::max<uint32_t>(mSettings.giSettings.probesPerFrame / residentCount, 1);
+
+        for (auto &resident : mResidentVolumes) {
+            resident.accumulator->setRenderingSettings(volumeSettings);
+        }
+    }
+
+#pragma mark - Public interface
+
+    void LightBakingVolumeStreamer::update(const glm::vec3 &cameraPosition) {
+        EA_PROFILE_SCOPE("Light baking volume streaming");
+
+        auto volumes = mScene->lightBakingVolumes();
+
+        std::string closestVolumeName;
+        float closestDistance = std::numeric_limits<float>::max();
+        for (auto &volume : volumes) {
+            float distance = volume.distance(cameraPosition);
+            if (distance < closestDistance) {
+                closestDistance = distance;
+                closestVolumeName = volume.name;
+            }
+        }
+
+        uint64_t previousVersion = mResidencyVersion;
+
+        processCompletedLoads(volumes, cameraPosition, closestVolumeName);
+        deactivateDistantVolumes(volumes, cameraPosition, closestVolumeName);
+        activateNearbyVolumes(volumes, cameraPosition, closestVolumeName);
+
+        if (mResidentVolumes.empty()) {
+            finishPendingLoad(closestVolumeName);
+            processCompletedLoads(volumes, cameraPosition, closestVolumeName);
+        }
+
+        if (previousVersion != mResidencyVersion) {
+            distributeUpdateBudget();
+        }
+    }
+
+    void LightBakingVolumeStreamer::invalidate() {
+        for (auto &resident : mResidentVolumes) {
+            resident.accumulator->invalidate();
+        }
+    }
+
+    void LightBakingVolumeStreamer::updateProbes() {
+        EA_PROFILE_SCOPE("Diffuse light probe update");
+
+        for (auto &resident : mResidentVolumes) {
+            resident.accumulator->updateProbes();
+        }
+    }
+
+    void LightBakingVolumeStreamer::render() {
+        std::vector<LightBakingVolume> volumes;
+        for (auto &resident : mResidentVolumes) {
+            volumes.push_back(resident.volume);
+        }
+
+        for (size_t i = 0; i < mResidentVolumes.size(); i++) {
+            mResidentVolumes[i].accumulator->render(volumes, i);
+        }
+    }
+
+}
@@ -0,0 +1,169 @@
+//
+// Created by Pavlo Muratov on 2019-02-05.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_LIGHTBAKINGVOLUMESTREAMER_HPP
+#define EARENDERER_LIGHTBAKINGVOLUMESTREAMER_HPP
+
+#include "Scene.hpp"
+#include "SharedResourceStorage.hpp"
+#include "GPUResourceController.hpp"
+#include "SceneGBuffer.hpp"
+#include "ShadowMapper.hpp"
+#include "RenderingSettings.hpp"
+#include "LightBakingVolume.hpp"
+#include "LightBakingVolumeCache.hpp"
+#include "IndirectLightAccumulator.hpp"
+#include "ThreadPool.hpp"
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <exception>
+#include <unordered_map>
+
+#include <glm/vec3.hpp>
+
+namespace EARenderer {
+
+    /**
+     Keeps surfels, probes and indirect light accumulators of the volumes close to the camera resident,
+     loading volumes from the cache as the camera approaches them and releasing the ones left behind.
+
+     Cached files are read on a thread pool, GPU buffers and accumulators are created on the render thread
+     by the first update after the read finishes.
+     Activation and deactivation distances differ to avoid reloading a volume every frame
+     when the camera moves along its activation boundary.
+     The volume closest to the camera is always kept resident, so the scene never renders without indirect light.
+     While nothing is resident, update waits for the closest volume's read instead of returning without it.
+     */
+    class LightBakingVolumeStreamer {
+    public:
+        // Must match GLSLIndirectLightEvaluation::MaximumBlendedVolumeCount
+        static constexpr size_t MaximumResidentVolumeCount = 8;
+
+    private:
+        struct ResidentVolume {
+            LightBakingVolume volume;
+            std::unique_ptr<LightBakingVolumeCache::VolumeData> data;
+            std::unique_ptr<IndirectLightAccumulator> accumulator;
+        };
+
+        struct PendingLoad {
+            LightBakingVolume volume;
+            ThreadPool::TaskFuture<void> task;
+        };
+
+        struct CompletedLoad {
+            std::string volumeName;
+            std::unique_ptr<LightBakingVolumeCache::VolumeData> data;
+            std::exception_ptr exception;
+        };
+
+        const Scene *mScene;
+        const SharedResourceStorage *mResourceStorage;
+        const GPUResourceController *mGPUResourceController;
+        const SceneGBuffer *mGBuffer;
+        const ShadowMapper *mShadowMapper;
+        const LightBakingVolumeCache *mCache;
+        ThreadPool *mThreadPool;
+
+        RenderingSettings mSettings;
+        std::vector<ResidentVolume> mResidentVolumes;
+        uint64_t mResidencyVersion = 0;
+
+        std::mutex mCompletedLoadsMutex;
+        std::vector<CompletedLoad> mCompletedLoads;
+        // Keyed by volume name
+        std::unordered_map<std::string, PendingLoad> mPendingLoads;
+
+        bool isResident(const LightBakingVolume &volume) const;
+
+        bool isWanted(const LightBakingVolume &volume, const std::vector<LightBakingVolume> &volumes, const glm::vec3 &cameraPosition, const std::string &closestVolumeName) const;
+
+        void issueLoad(const LightBakingVolume &volume);
+
+        void activate(const LightBakingVolume &volume, std::unique_ptr<LightBakingVolumeCache::VolumeData> data);
+
+        void processCompletedLoads(const std::vector<LightBakingVolume> &volumes, const glm::vec3 &cameraPosition, const std::string &closestVolumeName);
+
+        void finishPendingLoad(const std::string &volumeName);
+
+        void deactivateDistantVolumes(const std::vector<LightBakingVolume> &volumes, const glm::vec3 &cameraPosition, const std::string &closestVolumeName);
+
+        void activateNearbyVolumes(const std::vector<LightBakingVolume> &volumes, const glm::vec3 &cameraPosition, const std::string &closestVolumeName);
+
+        void distributeUpdateBudget();
+
+    public:
+        LightBakingVolumeStreamer(
+                const Scene *scene,
+                const SharedResourceStorage *resourceStorage,
+                const GPUResourceController *gpuResourceController,
+                const SceneGBuffer *gBuffer,
+                const ShadowMapper *shadowMapper,
+                const LightBakingVolumeCache *cache
+        );
+
+        LightBakingVolumeStreamer(
+                const Scene *scene,
+                const SharedResourceStorage *resourceStorage,
+                const GPUResourceController *gpuResourceController,
+                const SceneGBuffer *gBuffer,
+                const ShadowMapper *shadowMapper,
+                const LightBakingVolumeCache *cache,
+                ThreadPool *threadPool
+        );
+
+        LightBakingVolumeStreamer(const LightBakingVolumeStreamer &that) = delete;
+
+        LightBakingVolumeStreamer &operator=(const LightBakingVolumeStreamer &rhs) = delete;
+
+        /**
+         Waits for reads in flight
+         */
+        ~LightBakingVolumeStreamer();
+
+        void setRenderingSettings(const RenderingSettings &settings);
+
+        /**
+         @return counter incremented every time a volume is loaded or released
+         */
+        uint64_t residencyVersion() const;
+
+        size_t residentVolumeCount() const;
+
+        /**
+         @param point point in world space
+         @return accumulator of the resident volume closest to the point, or nullptr if nothing is resident
+         */
+        const IndirectLightAccumulator *closestAccumulator(const glm::vec3 &point) const;
+
+        /**
+         Makes volumes whose reads have finished resident, starts reading volumes the camera has approached,
+         at most volumeActivationsPerFrame per call, and releases volumes the camera has moved away from
+
+         @param cameraPosition current position of the camera
+         */
+        void update(const glm::vec3 &cameraPosition);
+
+        /**
+         Forces all resident surfels and probes to be recomputed
+         */
+        void invalidate();
+
+        /**
+         Updates surfels and probes of resident volumes, splitting the update budget between them
+         */
+        void updateProbes();
+
+        /**
+         Accumulates indirect light of all resident volumes
+         */
+        void render();
+    };
+
+}
+
+#endif //EARENDERER_LIGHTBAKINGVOLUMESTREAMER_HPP
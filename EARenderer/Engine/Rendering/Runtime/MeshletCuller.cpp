@@ -0,0 +1,145 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "MeshletCuller.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_inverse.hpp>
+
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace EARenderer {
+
+    namespace {
+
+        /**
+         View in the space of a particular mesh instance. Culling in mesh space keeps meshlet bounds as they are,
+         and facing is preserved by any affine transformation that doesn't mirror.
+         */
+        struct LocalView {
+            std::array<glm::vec4, 6> planes;
+            glm::vec3 viewer;
+            bool isOrthographic;
+        };
+
+        glm::vec4 Row(const glm::mat4 &m, glm::length_t i) {
+            return {m[0][i], m[1][i], m[2][i], m[3][i]};
+        }
+
+        bool IsInsideFrustum(const LocalView &view, const Meshlet &meshlet) {
+            for (auto &plane : view.planes) {
+                if (glm::dot(glm::vec3(plane), meshlet.sphereCenter) + plane.w < -meshlet.sphereRadius) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool IsFacingAway(const LocalView &view, const Meshlet &meshlet) {
+            if (meshlet.coneCutoff >= 1.0f) {
+                return false;
+            }
+            if (view.isOrthographic) {
+                return glm::dot(view.viewer, meshlet.coneAxis) >= meshlet.coneCutoff;
+            }
+            glm::vec3 toCenter = meshlet.sphereCenter - view.viewer;
+            return glm::dot(toCenter, meshlet.coneAxis) >= meshlet.coneCutoff * glm::length(toCenter) + meshlet.sphereRadius;
+        }
+
+    }
+
+#pragma mark - Draw ranges
+
+    size_t MeshletCuller::DrawRanges::count() const {
+        return firstVertices.size();
+    }
+
+    void MeshletCuller::DrawRanges::clear() {
+        firstVertices.clear();
+        vertexCounts.clear();
+    }
+
+#pragma mark - Lifecycle
+
+    MeshletCuller::MeshletCuller(const std::vector<glm::mat4> &viewProjections, bool coneCullingEnabled)
+            :
+            mIsConeCullingEnabled(coneCullingEnabled) {
+
+        for (auto &viewProjection : viewProjections) {
+            // The eye is the point projected to clip space (0, 0, z, 0). Orthographic projections
+            // have no such finite point and yield the direction of view instead.
+            glm::vec4 viewer = glm::inverse(viewProjection) * glm::vec4(0.0, 0.0, 1.0, 0.0);
+            if (std::abs(viewer.w) > std::numeric_limits<float>::epsilon() * glm::length(glm::vec3(viewer))) {
+                viewer = glm::vec4(glm::vec3(viewer) / viewer.w, 1.0);
+            } else {
+                viewer = glm::vec4(glm::normalize(glm::vec3(viewer)), 0.0);
+            }
+            mViews.push_back({viewProjection, viewer});
+        }
+    }
+
+#pragma mark - Culling
+
+    size_t MeshletCuller::cull(const SubMesh::MeshletVector &meshlets, const glm::mat4 &modelMatrix, size_t firstVertex, DrawRanges &ranges) const {
+        // A mirroring transformation swaps front and back faces
+        bool isConeCullingEnabled = mIsConeCullingEnabled && glm::determinant(glm::mat3(modelMatrix)) > 0.0f;
+        glm::mat4 inverseModel = glm::inverse(modelMatrix);
+
+        std::vector<LocalView> localViews;
+        localViews.reserve(mViews.size());
+
+        for (auto &view : mViews) {
+            LocalView localView;
+
+            // Clipping planes of the model-view-projection matrix (Gribb & Hartmann), normalized for sphere tests
+            glm::mat4 modelViewProjection = view.viewProjection * modelMatrix;
+            glm::vec4 w = Row(modelViewProjection, 3);
+            for (glm::length_t axis = 0; axis < 3; axis++) {
+                glm::vec4 row = Row(modelViewProjection, axis);
+                localView.planes[axis * 2] = w + row;
+                localView.planes[axis * 2 + 1] = w - row;
+            }
+            for (auto &plane : localView.planes) {
+                plane /= glm::length(glm::vec3(plane));
+            }
+
+            glm::vec4 viewer = inverseModel * view.viewer;
+            localView.isOrthographic = view.viewer.w == 0.0f;
+            localView.viewer = localView.isOrthographic ? glm::normalize(glm::vec3(viewer)) : glm::vec3(viewer) / viewer.w;
+
+            localViews.push_back(localView);
+        }
+
+        size_t rejectedCount = 0;
+
+        for (auto &meshlet : meshlets) {
+            bool isVisible = false;
+            for (auto &view : localViews) {
+                if (IsInsideFrustum(view, meshlet) && !(isConeCullingEnabled && IsFacingAway(view, meshlet))) {
+                    isVisible = true;
+                    break;
+                }
+            }
+
+            if (!isVisible) {
+                rejectedCount++;
+                continue;
+            }
+
+            GLint first = GLint(firstVertex + meshlet.firstVertex);
+            if (ranges.count() > 0 && ranges.firstVertices.back() + ranges.vertexCounts.back() == first) {
+                ranges.vertexCounts.back() += GLsizei(meshlet.vertexCount);
+            } else {
+                ranges.firstVertices.push_back(first);
+                ranges.vertexCounts.push_back(GLsizei(meshlet.vertexCount));
+            }
+        }
+
+        return rejectedCount;
+    }
+
+}
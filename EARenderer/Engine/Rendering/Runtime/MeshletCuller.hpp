@@ -0,0 +1,65 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_MESHLETCULLER_HPP
+#define EARENDERER_MESHLETCULLER_HPP
+
+#include "SubMesh.hpp"
+
+#include <OpenGL/gl3.h>
+#include <glm/mat4x4.hpp>
+#include <vector>
+
+namespace EARenderer {
+
+    /**
+     Rejects meshlets outside of the frustums of a set of views and, optionally, meshlets facing away from all of them.
+     Views sharing a draw call, such as shadow cascades or cube map faces, are culled together:
+     a meshlet survives if any of the views needs it.
+     */
+    class MeshletCuller {
+    public:
+        /**
+         Vertex ranges of surviving meshlets in the form glMultiDrawArrays takes them.
+         Ranges of meshlets adjacent in the vertex buffer are merged.
+         */
+        struct DrawRanges {
+            std::vector<GLint> firstVertices;
+            std::vector<GLsizei> vertexCounts;
+
+            size_t count() const;
+
+            void clear();
+        };
+
+    private:
+        struct View {
+            glm::mat4 viewProjection;
+            // Position of the viewer (w = 1) or direction of view for orthographic projections (w = 0), in world space
+            glm::vec4 viewer;
+        };
+
+        std::vector<View> mViews;
+        bool mIsConeCullingEnabled;
+
+    public:
+        /**
+         @param coneCullingEnabled whether meshlets facing away from the views are rejected. The renderer doesn't cull
+         back faces, so this is only correct for closed meshes and surfaces not meant to be seen from behind
+         */
+        MeshletCuller(const std::vector<glm::mat4> &viewProjections, bool coneCullingEnabled);
+
+        /**
+         Appends vertex ranges of visible meshlets
+
+         @param firstVertex offset of the sub mesh in the vertex buffer
+         @return amount of meshlets rejected
+         */
+        size_t cull(const SubMesh::MeshletVector &meshlets, const glm::mat4 &modelMatrix, size_t firstVertex, DrawRanges &ranges) const;
+    };
+
+}
+
+#endif //EARENDERER_MESHLETCULLER_HPP
@@ -7,7 +7,9 @@
 //
 
 #include "SceneGBufferConstructor.hpp"
+#include "GLStateCache.hpp"
 #include "Drawable.hpp"
+#include "Profiler.hpp"
 
 namespace EARenderer {
 
@@ -24,6 +26,7 @@ namespace EARenderer {
             mGPUResourceController(gpuResourceController),
             mFramebuffer(settings.displayedFrameResolution),
             mDepthRenderbuffer(settings.displayedFrameResolution),
+            mGBufferShader(gpuResourceController->meshVertexFormat()),
             mGBuffer(std::make_unique<SceneGBuffer>(settings.displayedFrameResolution)) {
 
         mFramebuffer.attachTexture(mGBuffer->materialData);
@@ -48,6 +51,8 @@ namespace EARenderer {
 #pragma mark - Private Helpers
 
     void SceneGBufferConstructor::generateGBuffer() {
+        EA_PROFILE_SCOPE("G-buffer");
+
         mFramebuffer.bind();
         mFramebuffer.viewport().apply();
 
@@ -61,11 +66,15 @@ namespace EARenderer {
                 &mGBuffer->materialData, &mGBuffer->HiZBuffer
         );
 
-        mGPUResourceController->meshVAO()->bind();
+        mGPUResourceController->bindMeshVAO();
+
+        glm::mat4 viewProjection = mScene->camera()->viewProjectionMatrix();
+        LODSelector lodSelector(viewProjection, mSettings.displayedFrameResolution, mSettings.meshSettings.lodScreenSpaceError);
+        MeshletCuller meshletCuller({viewProjection}, mSettings.meshSettings.meshletConeCullingEnabled);
 
         for (ID instanceID : mScene->meshInstances()) {
             auto &instance = mScene->meshInstances()[instanceID];
-            renderMeshInstance(instance);
+            renderMeshInstance(instance, lodSelector, meshletCuller);
         }
 
         for (ID lightID : mScene->pointLights()) {
@@ -77,23 +86,25 @@ namespace EARenderer {
 
             if (light.meshInstance) {
                 Transformation lightBaseTransform(glm::vec3(1.0), light.position(), glm::quat());
-                renderMeshInstance(*light.meshInstance, &lightBaseTransform);
+                renderMeshInstance(*light.meshInstance, lodSelector, meshletCuller, &lightBaseTransform);
             }
         }
     }
 
-    void SceneGBufferConstructor::renderMeshInstance(const MeshInstance &instance, const Transformation *baseTransform) {
+    void SceneGBufferConstructor::renderMeshInstance(const MeshInstance &instance, const LODSelector &lodSelector, const MeshletCuller &meshletCuller, const Transformation *baseTransform) {
         auto &subMeshes = mResourceStorage->mesh(instance.meshID()).subMeshes();
 
-        if (baseTransform) {
-            mGBufferShader.setModelMatrix(instance.transformation().combinedWith(*baseTransform).modelMatrix());
-        } else {
-            mGBufferShader.setModelMatrix(instance.transformation().modelMatrix());
-        }
+        glm::mat4 modelMatrix = baseTransform ?
+                instance.transformation().combinedWith(*baseTransform).modelMatrix() :
+                instance.transformation().modelMatrix();
+
+        mGBufferShader.setModelMatrix(modelMatrix);
 
         for (ID subMeshID : subMeshes) {
             auto &subMesh = subMeshes[subMeshID];
 
+            mGBufferShader.setPositionDequantization(mGPUResourceController->subMeshPositionDequantization(instance.meshID(), subMeshID));
+
             mGBufferShader.ensureSamplerValidity([&] {
                 auto materialRef = instance.materialReference;
 
@@ -115,13 +126,27 @@ namespace EARenderer {
                 }
             });
 
-            Drawable::TriangleMesh::Draw(mGPUResourceController->subMeshVBODataLocation(instance.meshID(), subMeshID));
+            size_t lod = lodSelector.select(subMesh, modelMatrix);
+            const auto &location = mGPUResourceController->subMeshVBODataLocation(instance.meshID(), subMeshID, lod);
+
+            // Meshlets partition full resolution vertices only
+            if (lod == 0 && mSettings.meshSettings.meshletCullingEnabled && !subMesh.meshlets().empty()) {
+                mMeshletDrawRanges.clear();
+                meshletCuller.cull(subMesh.meshlets(), modelMatrix, location.offset, mMeshletDrawRanges);
+                if (mMeshletDrawRanges.count() > 0) {
+                    Drawable::TriangleMesh::MultiDraw(mMeshletDrawRanges.firstVertices, mMeshletDrawRanges.vertexCounts);
+                }
+            } else {
+                Drawable::TriangleMesh::Draw(location);
+            }
         }
     }
 
     void SceneGBufferConstructor::generateHiZBuffer() {
+        EA_PROFILE_SCOPE("Hi-Z buffer");
+
         // Disable depth writes to not pollute depth buffer with HIZ buffer quads
-        glDepthMask(GL_FALSE);
+        GLStateCache::shared().depthMask(GL_FALSE);
 
         mFramebuffer.bind();
 
@@ -144,12 +169,14 @@ namespace EARenderer {
             Drawable::TriangleStripQuad::Draw();
         }
 
-        glDepthMask(GL_TRUE);
+        GLStateCache::shared().depthMask(GL_TRUE);
     }
 
 #pragma mark - Public Interface
 
     void SceneGBufferConstructor::render() {
+        EA_PROFILE_SCOPE("G-buffer construction");
+
         generateGBuffer();
 //        generateHiZBuffer();
     }
@@ -20,6 +20,8 @@
 
 #include <memory>
 #include "GPUResourceController.hpp"
+#include "LODSelector.hpp"
+#include "MeshletCuller.hpp"
 
 namespace EARenderer {
 
@@ -38,9 +40,11 @@ namespace EARenderer {
 
         std::unique_ptr<SceneGBuffer> mGBuffer;
 
+        MeshletCuller::DrawRanges mMeshletDrawRanges;
+
         void generateGBuffer();
 
-        void renderMeshInstance(const MeshInstance &instance, const Transformation *baseTransform = nullptr);
+        void renderMeshInstance(const MeshInstance &instance, const LODSelector &lodSelector, const MeshletCuller &meshletCuller, const Transformation *baseTransform = nullptr);
 
         void generateHiZBuffer();
 
@@ -10,9 +10,41 @@
 #include "Drawable.hpp"
 #include "SharedResourceStorage.hpp"
 #include "LogUtils.hpp"
+#include "Profiler.hpp"
+#include "LODSelector.hpp"
+
+#include <optional>
 
 namespace EARenderer {
 
+    namespace {
+
+        /**
+         Shadow maps of all views are rendered with a single instanced draw call,
+         so the view requiring the most detail decides the LOD
+
+         @return LOD to render the sub mesh with or nothing if the sub mesh is outside of all views
+         */
+        std::optional<size_t> SelectLOD(const std::vector<LODSelector> &selectors, const SubMesh &subMesh, const glm::mat4 &modelMatrix) {
+            std::optional<size_t> lod;
+            for (auto &selector : selectors) {
+                if (selector.isPotentiallyVisible(subMesh, modelMatrix)) {
+                    lod = std::min(lod.value_or(subMesh.lodCount()), selector.select(subMesh, modelMatrix));
+                }
+            }
+            return lod;
+        }
+
+        std::vector<LODSelector> LODSelectors(const std::vector<glm::mat4> &viewProjections, const Size2D &resolution, float maximumScreenSpaceError) {
+            std::vector<LODSelector> selectors;
+            for (auto &viewProjection : viewProjections) {
+                selectors.emplace_back(viewProjection, resolution, maximumScreenSpaceError);
+            }
+            return selectors;
+        }
+
+    }
+
 #pragma mark - Lifecycle
 
     ShadowMapper::ShadowMapper(
@@ -30,10 +62,9 @@ namespace EARenderer {
             mShadowFramebuffer(mSettings.directionalShadowMapResolution),
             mOmnidirectionalShadowFramebuffer(mSettings.omnidirectionalShadowMapResolution),
             mPenumbraFramebuffer(mSettings.penumbraResolution),
-            mTexturePool(mSettings.penumbraResolution),
             mDirectionalPenumbra(mSettings.penumbraResolution),
             mDirectionalShadowMapArray(mSettings.directionalShadowMapResolution, std::min(cascadeCount, MaximumCascadeCount), Sampling::ComparisonMode::ReferenceToTexture),
-            mBlurEffect(&mPenumbraFramebuffer, &mTexturePool),
+            mBlurEffect(&mPenumbraFramebuffer),
             mBilinearSampler(Sampling::Filter::Bilinear, Sampling::WrapMode::ClampToEdge, Sampling::ComparisonMode::None) {
 
         for (ID pointLightID : scene->pointLights()) {
@@ -88,7 +119,29 @@ namespace EARenderer {
 
 #pragma mark - Private Helpers
 
+    void ShadowMapper::drawSubMeshInstanced(ID meshID, ID subMeshID, size_t lod, const glm::mat4 &modelMatrix, const MeshletCuller &meshletCuller, size_t viewCount) {
+        const auto &subMesh = mResourceStorage->mesh(meshID).subMeshes()[subMeshID];
+        const auto &location = mGPUResourceController->subMeshVBODataLocation(meshID, subMeshID, lod);
+
+        mShadowMapShader.setModelMatrix(modelMatrix * mGPUResourceController->subMeshPositionDequantization(meshID, subMeshID));
+
+        // Meshlets partition full resolution vertices only
+        if (lod > 0 || !mSettings.meshSettings.meshletCullingEnabled || subMesh.meshlets().empty()) {
+            Drawable::TriangleMesh::DrawInstanced(viewCount, location);
+            return;
+        }
+
+        // There is no instanced multi draw in OpenGL 4.1, ranges are drawn one by one
+        mMeshletDrawRanges.clear();
+        meshletCuller.cull(subMesh.meshlets(), modelMatrix, location.offset, mMeshletDrawRanges);
+        for (size_t i = 0; i < mMeshletDrawRanges.count(); i++) {
+            Drawable::TriangleMesh::DrawInstanced(viewCount, mMeshletDrawRanges.vertexCounts[i], mMeshletDrawRanges.firstVertices[i]);
+        }
+    }
+
     void ShadowMapper::renderDirectionalShadowMaps() {
+        EA_PROFILE_SCOPE("Directional shadow maps");
+
         if (!mScene->sun().isEnabled()) {
             return;
         }
@@ -101,21 +154,30 @@ namespace EARenderer {
         GLViewport(mSettings.directionalShadowMapResolution).apply();
         mShadowFramebuffer.clear(GLFramebuffer::UnderlyingBuffer::Depth);
 
+        auto lodSelectors = LODSelectors(mShadowCascades.lightViewProjections, mSettings.directionalShadowMapResolution, mSettings.meshSettings.lodScreenSpaceError);
+        MeshletCuller meshletCuller(mShadowCascades.lightViewProjections, mSettings.meshSettings.meshletConeCullingEnabled);
+
         for (ID meshInstanceID : mScene->meshInstances()) {
             const auto &instance = mScene->meshInstances()[meshInstanceID];
             const auto &subMeshes = mResourceStorage->mesh(instance.meshID()).subMeshes();
 
-            mShadowMapShader.setModelMatrix(instance.transformation().modelMatrix());
+            glm::mat4 modelMatrix = instance.transformation().modelMatrix();
 
             for (ID subMeshID : subMeshes) {
                 const auto &subMesh = subMeshes[subMeshID];
-                const auto &location = mGPUResourceController->subMeshVBODataLocation(instance.meshID(), subMeshID);
-                Drawable::TriangleMesh::DrawInstanced(mShadowCascades.amount, location);
+                auto lod = SelectLOD(lodSelectors, subMesh, modelMatrix);
+                if (!lod) {
+                    continue;
+                }
+
+                drawSubMeshInstanced(instance.meshID(), subMeshID, *lod, modelMatrix, meshletCuller, mShadowCascades.amount);
             }
         }
     }
 
     void ShadowMapper::renderOmnidirectionalShadowMaps() {
+        EA_PROFILE_SCOPE("Omnidirectional shadow maps");
+
         mShadowMapShader.bind();
 
         mShadowFramebuffer.bind();
@@ -133,24 +195,34 @@ namespace EARenderer {
             mShadowFramebuffer.clear(GLFramebuffer::UnderlyingBuffer::Depth);
 
             auto matrices = light.viewProjectionMatrices();
-            mShadowMapShader.setViewProjectionMatrices({matrices.begin(), matrices.end()});
+            std::vector<glm::mat4> viewProjections(matrices.begin(), matrices.end());
+            mShadowMapShader.setViewProjectionMatrices(viewProjections);
+
+            auto lodSelectors = LODSelectors(viewProjections, mSettings.omnidirectionalShadowMapResolution, mSettings.meshSettings.lodScreenSpaceError);
+            MeshletCuller meshletCuller(viewProjections, mSettings.meshSettings.meshletConeCullingEnabled);
 
             for (ID meshInstanceID : mScene->meshInstances()) {
                 auto &instance = mScene->meshInstances()[meshInstanceID];
                 auto &subMeshes = mResourceStorage->mesh(instance.meshID()).subMeshes();
 
-                mShadowMapShader.setModelMatrix(instance.transformation().modelMatrix());
+                glm::mat4 modelMatrix = instance.transformation().modelMatrix();
 
                 for (ID subMeshID : subMeshes) {
                     const auto &subMesh = subMeshes[subMeshID];
-                    const auto &location = mGPUResourceController->subMeshVBODataLocation(instance.meshID(), subMeshID);
-                    Drawable::TriangleMesh::DrawInstanced(6, location); // 6 for 6 cubemap faces
+                    auto lod = SelectLOD(lodSelectors, subMesh, modelMatrix);
+                    if (!lod) {
+                        continue;
+                    }
+
+                    drawSubMeshInstanced(instance.meshID(), subMeshID, *lod, modelMatrix, meshletCuller, 6); // 6 for 6 cubemap faces
                 }
             }
         }
     }
 
     void ShadowMapper::renderDirectionalPenumbra() {
+        EA_PROFILE_SCOPE("Directional penumbra");
+
         if (!mScene->sun().isEnabled()) {
             return;
         }
@@ -170,6 +242,8 @@ namespace EARenderer {
     }
 
     void ShadowMapper::renderOmnidirectionalPenumbras() {
+        EA_PROFILE_SCOPE("Omnidirectional penumbras");
+
         mOmnidirectionalPenumbraGenerationShader.bind();
         mOmnidirectionalPenumbraGenerationShader.setCamera(*mScene->camera());
 
@@ -201,14 +275,16 @@ namespace EARenderer {
 
 //        for (auto& pair : mOmnidirectionalPenumbras) {
 //            auto &penumbra = it.second;
-//            mBlurEffect.blur(penumbra, <#EARenderer::PostprocessTexturePool::PostprocessTexture & outputImage#>, { 3, 0.84, 0, 0 })
+//            mBlurEffect.blur(penumbra, <#EARenderer::PostprocessEffect::PostprocessTexture & outputImage#>, { 3, 0.84, 0, 0 })
 //        }
     }
 
 #pragma mark - Rendering
 
     void ShadowMapper::render() {
-        mGPUResourceController->meshVAO()->bind();
+        EA_PROFILE_SCOPE("Shadow mapping");
+
+        mGPUResourceController->bindMeshVAO();
         mShadowCascades = mScene->sun().cascadesForBoundingBox(mScene->boundingBox(), mCascadeCount);
 //        mShadowCascades = mScene->sun().cascadesForCamera(*mScene->camera(), 1);
 
@@ -26,6 +26,7 @@
 #include <memory>
 #include <unordered_map>
 #include "GPUResourceController.hpp"
+#include "MeshletCuller.hpp"
 
 namespace EARenderer {
 
@@ -50,7 +51,6 @@ namespace EARenderer {
         GLFramebuffer mShadowFramebuffer;
         GLFramebuffer mOmnidirectionalShadowFramebuffer;
         GLFramebuffer mPenumbraFramebuffer;
-        PostprocessTexturePool mTexturePool;
 
         GLDepthTexture2DArray mDirectionalShadowMapArray;
         GLFloatTexture2D<GLTexture::Float::R16F> mDirectionalPenumbra;
@@ -60,6 +60,13 @@ namespace EARenderer {
         GaussianBlurEffect mBlurEffect;
         GLSampler mBilinearSampler;
 
+        MeshletCuller::DrawRanges mMeshletDrawRanges;
+
+        /**
+         Draws the sub mesh into all views at once, meshlet ranges visible in any of the views only
+         */
+        void drawSubMeshInstanced(ID meshID, ID subMeshID, size_t lod, const glm::mat4 &modelMatrix, const MeshletCuller &meshletCuller, size_t viewCount);
+
         void renderDirectionalPenumbra();
 
         void renderOmnidirectionalPenumbras();
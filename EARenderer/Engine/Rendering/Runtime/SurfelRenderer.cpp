@@ -76,14 +76,15 @@ namespace EARenderer {
             size_t projectionGroupOffset = probe.surfelClusterProjectionGroupOffset;
 
             for (size_t i = projectionGroupOffset; i < projectionGroupOffset + projectionGroupCount; i++) {
-                const SurfelClusterProjection &projection = mProbeData->surfelClusterProjections()[i];
-                mSurfelClusterVAOs[projection.surfelClusterIndex].bind();
-                mSurfelRenderingShader.setExternalColor(mSurfelClusterColors[projection.surfelClusterIndex]);
-                const SurfelCluster &cluster = mSurfelData->surfelClusters()[projection.surfelClusterIndex];
+                uint32_t clusterIndex = mProbeData->surfelClusterIndex(i);
+                mSurfelClusterVAOs[clusterIndex].bind();
+                mSurfelRenderingShader.setExternalColor(mSurfelClusterColors[clusterIndex]);
+                const SurfelCluster &cluster = mSurfelData->surfelClusters()[clusterIndex];
                 Drawable::Point::Draw(cluster.surfelCount);
             }
         } else {
-            for (size_t i = 0; i < mSurfelClusterVAOs.size(); i++) {
+            // Parent clusters of the hierarchy only repeat surfels of their children
+            for (size_t i = 0; i < mSurfelData->leafSurfelClusterCount(); i++) {
                 mSurfelClusterVAOs[i].bind();
                 const SurfelCluster &cluster = mSurfelData->surfelClusters()[i];
                 mSurfelRenderingShader.setSurfelGroupOffset(cluster.surfelOffset);
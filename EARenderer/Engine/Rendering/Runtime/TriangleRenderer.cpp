@@ -7,6 +7,7 @@
 //
 
 #include "TriangleRenderer.hpp"
+#include "GLStateCache.hpp"
 #include "Drawable.hpp"
 
 namespace EARenderer {
@@ -19,27 +20,29 @@ namespace EARenderer {
 #pragma mark - Rendering
 
     void TriangleRenderer::render() {
-        glEnable(GL_MULTISAMPLE);
+        GLStateCache::shared().enable(GL_MULTISAMPLE);
 
         mTriangleRenderingShader.bind();
         mTriangleRenderingShader.setColor(Color::White());
+        // Passes rendered in between may leave a different vertex array bound
+        mGPUResourceController->bindMeshVAO();
 
         glm::mat4 viewProjection = mScene->camera()->viewProjectionMatrix();
 
         for (ID meshInstanceID : mScene->meshInstances()) {
             auto &instance = mScene->meshInstances()[meshInstanceID];
             auto &subMeshes = mResourceStorage->mesh(instance.meshID()).subMeshes();
-
-            glm::mat4 mvp = viewProjection * instance.modelMatrix();
-            mTriangleRenderingShader.setModelViewProjectionMatrix(mvp);
+            glm::mat4 modelViewProjection = viewProjection * instance.modelMatrix();
 
             for (ID subMeshID : subMeshes) {
-                auto &subMesh = subMeshes[subMeshID];
+                // Quantized positions are relative to the bounding box of their sub mesh
+                glm::mat4 mvp = modelViewProjection * mGPUResourceController->subMeshPositionDequantization(instance.meshID(), subMeshID);
+                mTriangleRenderingShader.setModelViewProjectionMatrix(mvp);
                 Drawable::TriangleMesh::Draw(mGPUResourceController->subMeshVBODataLocation(instance.meshID(), subMeshID));
             }
         }
 
-        glDisable(GL_MULTISAMPLE);
+        GLStateCache::shared().disable(GL_MULTISAMPLE);
     }
 
 }
@@ -7,7 +7,9 @@
 //
 
 #include "AutodeskMeshLoader.hpp"
+#include "MeshProcessor.hpp"
 #include "StringUtils.hpp"
+#include "Profiler.hpp"
 
 #include <stdexcept>
 #include <glm/vec3.hpp>
@@ -114,9 +116,6 @@ namespace EARenderer {
                 vertexId++;
             } // for polygonSize
         } // for polygonCount
-
-        mBoundingBox->min = glm::min(subMesh.boundingBox().min, mBoundingBox->min);
-        mBoundingBox->max = glm::max(subMesh.boundingBox().max, mBoundingBox->max);
     }
 
     void AutodeskMeshLoader::extractUVs(FbxMesh *mesh, size_t vertexId) {
@@ -258,6 +257,8 @@ namespace EARenderer {
 #pragma mark - Public
 
     void AutodeskMeshLoader::load(std::vector<SubMesh> &subMeshes, std::string &meshName, AxisAlignedBox3D &boundingBox) {
+        EA_PROFILE_SCOPE("Load FBX mesh");
+
         FbxScene *scene = importScene();
         FbxNode *rootNode = scene->GetRootNode();
 
@@ -275,6 +276,9 @@ namespace EARenderer {
         for (size_t i = 0; i < rootNode->GetChildCount(); i++) {
             processChildNode(rootNode->GetChild(i));
         }
+
+        // Fills in tangents for files not providing them
+        *mBoundingBox = MeshProcessor().process(*mSubMeshes);
     }
 
 }
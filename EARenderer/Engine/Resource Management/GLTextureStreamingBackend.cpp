@@ -0,0 +1,141 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "GLTextureStreamingBackend.hpp"
+#include "SharedResourceStorage.hpp"
+#include "GLTextureUnitManager.hpp"
+#include "StringUtils.hpp"
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "stb_image.h"
+
+namespace EARenderer {
+
+    namespace {
+
+        // Halves the image with a box filter, an odd last row or column is folded into the previous one
+        std::vector<uint8_t> Downsample(const std::vector<uint8_t> &pixels, uint32_t width, uint32_t height, uint32_t &halfWidth, uint32_t &halfHeight) {
+            halfWidth = std::max(1u, width / 2);
+            halfHeight = std::max(1u, height / 2);
+            std::vector<uint8_t> halfPixels(size_t(halfWidth) * halfHeight * 4);
+
+            for (uint32_t y = 0; y < halfHeight; y++) {
+                for (uint32_t x = 0; x < halfWidth; x++) {
+                    uint32_t x0 = std::min(x * 2, width - 1);
+                    uint32_t y0 = std::min(y * 2, height - 1);
+                    uint32_t x1 = x == halfWidth - 1 ? width - 1 : x0 + 1;
+                    uint32_t y1 = y == halfHeight - 1 ? height - 1 : y0 + 1;
+
+                    for (uint32_t c = 0; c < 4; c++) {
+                        uint32_t sum = 0;
+                        uint32_t count = 0;
+                        for (uint32_t sy = y0; sy <= y1; sy++) {
+                            for (uint32_t sx = x0; sx <= x1; sx++) {
+                                sum += pixels[(size_t(sy) * width + sx) * 4 + c];
+                                count++;
+                            }
+                        }
+                        halfPixels[(size_t(y) * halfWidth + x) * 4 + c] = uint8_t((sum + count / 2) / count);
+                    }
+                }
+            }
+
+            return halfPixels;
+        }
+
+    }
+
+#pragma mark - Lifecycle
+
+    GLTextureStreamingBackend::GLTextureStreamingBackend(SharedResourceStorage *resourceStorage)
+            : mResourceStorage(resourceStorage) {}
+
+#pragma mark - TextureStreamingBackend
+
+    TextureStreamingBackend::TextureDescription GLTextureStreamingBackend::describe(const TextureKey &key, const std::string &path) {
+        int32_t width = 0;
+        int32_t height = 0;
+        int32_t components = 0;
+
+        if (!stbi_info(path.c_str(), &width, &height, &components)) {
+            throw std::invalid_argument(string_format("Failed to read texture file info (%s)", path.c_str()));
+        }
+
+        TextureDescription description;
+        description.size = Size2D(width, height);
+        // Maps use generic compressed formats sized by the driver, which lands around a byte per texel
+        description.bytesPerTexel = 1;
+        return description;
+    }
+
+    TextureStreamingBackend::StagedMip GLTextureStreamingBackend::load(const TextureKey &key, const std::string &path, uint32_t mipLevel) {
+        EA_PROFILE_SCOPE("Load streamed image");
+
+        int32_t width = 0;
+        int32_t height = 0;
+        int32_t components = 0;
+
+        // Flipping on load is a global switch of stb_image, so rows are flipped here to stay thread safe
+        stbi_uc *pixelData = stbi_load(path.c_str(), &width, &height, &components, STBI_rgb_alpha);
+        if (!pixelData) {
+            throw std::invalid_argument(string_format("Failed to load texture file (%s)", path.c_str()));
+        }
+
+        size_t rowSize = size_t(width) * 4;
+        std::vector<uint8_t> pixels(rowSize * height);
+        for (int32_t y = 0; y < height; y++) {
+            std::copy(pixelData + rowSize * (height - 1 - y), pixelData + rowSize * (height - y), pixels.begin() + rowSize * y);
+        }
+        stbi_image_free(pixelData);
+
+        uint32_t mipWidth = uint32_t(width);
+        uint32_t mipHeight = uint32_t(height);
+        for (uint32_t mip = 0; mip < mipLevel && (mipWidth > 1 || mipHeight > 1); mip++) {
+            pixels = Downsample(pixels, mipWidth, mipHeight, mipWidth, mipHeight);
+        }
+
+        StagedMip stagedMip;
+        stagedMip.mipLevel = mipLevel;
+        stagedMip.size = Size2D(mipWidth, mipHeight);
+        stagedMip.pixels = std::move(pixels);
+        return stagedMip;
+    }
+
+    void GLTextureStreamingBackend::upload(const TextureKey &key, StagedMip &&mip) {
+        EA_PROFILE_SCOPE("Upload streamed mip");
+
+        auto &material = mResourceStorage->cookTorranceMaterial(key.materialID);
+        material.replaceMap(key.mapType, mip.size, mip.pixels.data());
+    }
+
+    void GLTextureStreamingBackend::drop(const TextureKey &key, uint32_t residentMipLevel, uint32_t mipLevel) {
+        EA_PROFILE_SCOPE("Drop streamed mips");
+
+        auto &material = mResourceStorage->cookTorranceMaterial(key.materialID);
+        const GLTexture *texture = material.map(key.mapType);
+
+        // The texture's level 0 is the resident mip level
+        GLint level = GLint(mipLevel - residentMipLevel);
+        if (level > GLint(texture->mipMapCount())) {
+            throw std::invalid_argument(string_format("Texture holds %d mip levels, level %d can't be kept", texture->mipMapCount() + 1, level));
+        }
+
+        GLTextureUnitManager::Shared().bindTextureToActiveUnit(*texture);
+        GLint width = 0;
+        GLint height = 0;
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_WIDTH, &width);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_HEIGHT, &height);
+
+        std::vector<uint8_t> pixels(size_t(width) * size_t(height) * 4);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glGetTexImage(GL_TEXTURE_2D, level, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+        material.replaceMap(key.mapType, Size2D(width, height), pixels.data());
+    }
+
+}
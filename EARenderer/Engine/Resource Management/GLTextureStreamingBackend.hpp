@@ -0,0 +1,40 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_GLTEXTURESTREAMINGBACKEND_HPP
+#define EARENDERER_GLTEXTURESTREAMINGBACKEND_HPP
+
+#include "TextureStreamingBackend.hpp"
+
+namespace EARenderer {
+
+    class SharedResourceStorage;
+
+    /**
+     Streams maps of Cook-Torrance materials living in a resource storage.
+
+     OpenGL 4.1 has no sparse textures, so a map is recreated at the size of its finest resident mip level on every
+     upload or drop, with coarser levels generated by the driver. Images are decoded and reduced to the requested
+     mip level on worker threads, dropped levels are read back from the GPU instead of being decoded again.
+     */
+    class GLTextureStreamingBackend : public TextureStreamingBackend {
+    private:
+        SharedResourceStorage *mResourceStorage;
+
+    public:
+        GLTextureStreamingBackend(SharedResourceStorage *resourceStorage);
+
+        TextureDescription describe(const TextureKey &key, const std::string &path) override;
+
+        StagedMip load(const TextureKey &key, const std::string &path, uint32_t mipLevel) override;
+
+        void upload(const TextureKey &key, StagedMip &&mip) override;
+
+        void drop(const TextureKey &key, uint32_t residentMipLevel, uint32_t mipLevel) override;
+    };
+
+}
+
+#endif //EARENDERER_GLTEXTURESTREAMINGBACKEND_HPP
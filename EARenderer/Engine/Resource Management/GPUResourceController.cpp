@@ -7,16 +7,49 @@
 #include "StringUtils.hpp"
 #include "CameraUBOContent.hpp"
 #include "PointLightUBOContent.hpp"
+#include "MemoryTracker.hpp"
 
 namespace EARenderer {
 
-    GPUResourceController::GPUResourceController()
-            : mMeshVAO(std::make_unique<GLVertexArray<Vertex1P1N2UV1T1BT>>(nullptr, 1, nullptr, 0)),
+    namespace {
+
+        // Computed from vertices rather than taken from the sub mesh,
+        // since vertices can be edited in place after the sub mesh has been built
+        AxisAlignedBox3D VertexBounds(const SubMesh::VertexVector &vertices) {
+            AxisAlignedBox3D bounds = AxisAlignedBox3D::MaximumReversed();
+            for (auto &vertex : vertices) {
+                bounds.min = glm::min(bounds.min, glm::vec3(vertex.position));
+                bounds.max = glm::max(bounds.max, glm::vec3(vertex.position));
+            }
+            return bounds;
+        }
+
+    }
+
+    GPUResourceController::GPUResourceController(MeshVertexLayout::Format meshVertexFormat)
+            : mMeshVertexFormat(meshVertexFormat),
               mUniformBuffer(std::make_unique<GLUniformBuffer>()) {
+
+        switch (mMeshVertexFormat) {
+            case MeshVertexLayout::Format::Float:
+                mMeshVAO = std::make_unique<GLVertexArray<Vertex1P1N2UV1T1BT>>(nullptr, 1, nullptr, 0);
+                break;
+            case MeshVertexLayout::Format::Quantized:
+                mQuantizedMeshVAO = std::make_unique<GLVertexArray<QuantizedVertex>>(nullptr, 1, nullptr, 0);
+                break;
+        }
+    }
+
+    MeshVertexLayout::Format GPUResourceController::meshVertexFormat() const {
+        return mMeshVertexFormat;
     }
 
-    const GLVertexArray<Vertex1P1N2UV1T1BT> *GPUResourceController::meshVAO() const {
-        return mMeshVAO.get();
+    void GPUResourceController::bindMeshVAO() const {
+        if (mQuantizedMeshVAO) {
+            mQuantizedMeshVAO->bind();
+        } else {
+            mMeshVAO->bind();
+        }
     }
 
     const GLUniformBuffer *GPUResourceController::uniformBuffer() const {
@@ -24,27 +57,45 @@ namespace EARenderer {
     }
 
     void GPUResourceController::updateMeshVAO(const SharedResourceStorage &resourceStorage) {
+        MemoryTracker::Scope memoryScope(MemoryTag::Meshes);
         std::vector<Vertex1P1N2UV1T1BT> vertices;
+        std::vector<QuantizedVertex> quantizedVertices;
+        bool isQuantized = mMeshVertexFormat == MeshVertexLayout::Format::Quantized;
 
         resourceStorage.iterateMeshes([&](ID meshID) {
             const Mesh &mesh = resourceStorage.mesh(meshID);
             for (ID subMeshID : mesh.subMeshes()) {
                 const SubMesh &subMesh = mesh.subMeshes()[subMeshID];
-                mSubMeshVBODataLocations[meshID][subMeshID] = {vertices.size(), subMesh.vertices().size()};
-                vertices.insert(vertices.end(), subMesh.vertices().begin(), subMesh.vertices().end());
+                auto &data = mSubMeshGPUData[meshID][subMeshID];
+
+                data.lodLocations.clear();
+
+                // LODs reference a subset of full resolution vertices and share their quantization bounds
+                AxisAlignedBox3D bounds = VertexBounds(subMesh.vertices());
+                data.positionDequantization = isQuantized ? QuantizedVertex::PositionDequantizationMatrix(bounds) : glm::mat4(1.0);
+
+                for (size_t lod = 0; lod < subMesh.lodCount(); lod++) {
+                    auto &lodVertices = subMesh.lodVertices(lod);
+                    if (isQuantized) {
+                        data.lodLocations.push_back({quantizedVertices.size(), lodVertices.size()});
+                        for (auto &vertex : lodVertices) {
+                            quantizedVertices.emplace_back(vertex, bounds);
+                        }
+                    } else {
+                        data.lodLocations.push_back({vertices.size(), lodVertices.size()});
+                        vertices.insert(vertices.end(), lodVertices.begin(), lodVertices.end());
+                    }
+                }
             }
         });
 
-        std::array<GLVertexAttribute, 6> attributes{
-                GLVertexAttribute::UniqueAttribute(sizeof(glm::vec4), glm::vec4::length()),
-                GLVertexAttribute::UniqueAttribute(sizeof(glm::vec3), glm::vec3::length()),
-                GLVertexAttribute::UniqueAttribute(sizeof(glm::vec2), glm::vec2::length()),
-                GLVertexAttribute::UniqueAttribute(sizeof(glm::vec3), glm::vec3::length()),
-                GLVertexAttribute::UniqueAttribute(sizeof(glm::vec3), glm::vec3::length()),
-                GLVertexAttribute::UniqueAttribute(sizeof(glm::vec3), glm::vec3::length())
-        };
+        auto attributes = MeshVertexLayout::Attributes(mMeshVertexFormat);
 
-        mMeshVAO = std::make_unique<GLVertexArray<Vertex1P1N2UV1T1BT>>(vertices.data(), vertices.size(), attributes.data(), attributes.size());
+        if (isQuantized) {
+            mQuantizedMeshVAO = std::make_unique<GLVertexArray<QuantizedVertex>>(quantizedVertices.data(), quantizedVertices.size(), attributes.data(), attributes.size());
+        } else {
+            mMeshVAO = std::make_unique<GLVertexArray<Vertex1P1N2UV1T1BT>>(vertices.data(), vertices.size(), attributes.data(), attributes.size());
+        }
     }
 
     void GPUResourceController::updateUniformBuffer(const SharedResourceStorage &resourceStorage, const Scene &scene) {
@@ -65,9 +116,9 @@ namespace EARenderer {
         session.flush();
     }
 
-    const GLVBODataLocation &GPUResourceController::subMeshVBODataLocation(ID meshID, ID subMeshID) const {
-        auto subMeshIt = mSubMeshVBODataLocations.find(meshID);
-        if (subMeshIt == mSubMeshVBODataLocations.end()) {
+    const GPUResourceController::SubMeshGPUData &GPUResourceController::subMeshGPUData(ID meshID, ID subMeshID) const {
+        auto subMeshIt = mSubMeshGPUData.find(meshID);
+        if (subMeshIt == mSubMeshGPUData.end()) {
             throw std::invalid_argument(string_format("VBO location not found for mesh with ID: %d", meshID));
         }
 
@@ -79,6 +130,19 @@ namespace EARenderer {
         return locationIt->second;
     }
 
+    const GLVBODataLocation &GPUResourceController::subMeshVBODataLocation(ID meshID, ID subMeshID, size_t lod) const {
+        auto &locations = subMeshGPUData(meshID, subMeshID).lodLocations;
+        return locations[std::min(lod, locations.size() - 1)];
+    }
+
+    size_t GPUResourceController::subMeshLODCount(ID meshID, ID subMeshID) const {
+        return subMeshGPUData(meshID, subMeshID).lodLocations.size();
+    }
+
+    const glm::mat4 &GPUResourceController::subMeshPositionDequantization(ID meshID, ID subMeshID) const {
+        return subMeshGPUData(meshID, subMeshID).positionDequantization;
+    }
+
     const GLUBODataLocation &GPUResourceController::cameraUBODataLocation() const {
         return GLUBODataLocation();
     }
@@ -7,6 +7,8 @@
 #define EARENDERER_GPURESOURCECONTROLLER_HPP
 
 #include "GLVertexArray.hpp"
+#include "MeshVertexLayout.hpp"
+#include "QuantizedVertex.hpp"
 #include "Scene.hpp"
 #include "SharedResourceStorage.hpp"
 #include "GLUniformBuffer.hpp"
@@ -17,10 +19,19 @@ namespace EARenderer {
 
     class GPUResourceController {
     private:
+        struct SubMeshGPUData {
+            // Indexed by LOD, full resolution first
+            std::vector<GLVBODataLocation> lodLocations;
+            glm::mat4 positionDequantization;
+        };
+
+        MeshVertexLayout::Format mMeshVertexFormat;
+        // Only the VAO of the chosen format exists
         std::unique_ptr<GLVertexArray<Vertex1P1N2UV1T1BT>> mMeshVAO;
+        std::unique_ptr<GLVertexArray<QuantizedVertex>> mQuantizedMeshVAO;
         std::unique_ptr<GLUniformBuffer> mUniformBuffer;
 
-        std::unordered_map<ID, std::unordered_map<ID, GLVBODataLocation>> mSubMeshVBODataLocations;
+        std::unordered_map<ID, std::unordered_map<ID, SubMeshGPUData>> mSubMeshGPUData;
         std::unordered_map<ID, GLUBODataLocation> mMaterialUBODataLocations;
         std::unordered_map<ID, GLUBODataLocation> mMaterialInstanceUBODataLocations;
         std::unordered_map<ID, GLUBODataLocation> mMeshInstanceUBODataLocations;
@@ -28,10 +39,18 @@ namespace EARenderer {
 
         GLUBODataLocation mCameraUBODataLocation;
 
+        const SubMeshGPUData &subMeshGPUData(ID meshID, ID subMeshID) const;
+
     public:
-        GPUResourceController();
+        /**
+         @param meshVertexFormat format mesh vertices are uploaded in. Programs drawing meshes have to be
+         built with MeshVertexLayout::ShaderDefines() of the same format
+         */
+        GPUResourceController(MeshVertexLayout::Format meshVertexFormat = MeshVertexLayout::Format::Quantized);
+
+        MeshVertexLayout::Format meshVertexFormat() const;
 
-        const GLVertexArray<Vertex1P1N2UV1T1BT> *meshVAO() const;
+        void bindMeshVAO() const;
 
         const GLUniformBuffer *uniformBuffer() const;
 
@@ -39,7 +58,18 @@ namespace EARenderer {
 
         void updateUniformBuffer(const SharedResourceStorage &resourceStorage, const Scene &scene);
 
-        const GLVBODataLocation &subMeshVBODataLocation(ID meshID, ID subMeshID) const;
+        /**
+         @param lod index of the sub mesh LOD, clamped to the coarsest one available
+         */
+        const GLVBODataLocation &subMeshVBODataLocation(ID meshID, ID subMeshID, size_t lod = 0) const;
+
+        size_t subMeshLODCount(ID meshID, ID subMeshID) const;
+
+        /**
+         @return matrix restoring positions of the sub mesh in mesh space, to be premultiplied by the model matrix.
+         Identity for the float vertex format
+         */
+        const glm::mat4 &subMeshPositionDequantization(ID meshID, ID subMeshID) const;
 
         const GLUBODataLocation &cameraUBODataLocation() const;
 
@@ -0,0 +1,227 @@
+//
+// Created by Pavlo Muratov on 2019-02-15.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "MeshLODGenerator.hpp"
+#include "ThreadPool.hpp"
+#include "Serializers.hpp"
+#include "Profiler.hpp"
+#include "FileManager.hpp"
+#include "StringUtils.hpp"
+#include "FNV1aHash.hpp"
+
+#include <bitsery/bitsery.h>
+#include <bitsery/adapter/stream.h>
+#include <cstdio>
+#include <fstream>
+
+namespace EARenderer {
+
+    template<typename S>
+    void serialize(S &s, Vertex1P1N2UV1T1BT &vertex) {
+        s.object(vertex.position);
+        s.object(vertex.textureCoords);
+        s.value4b(vertex.lightmapCoords.x);
+        s.value4b(vertex.lightmapCoords.y);
+        s.object(vertex.normal);
+        s.object(vertex.tangent);
+        s.object(vertex.bitangent);
+    }
+
+    namespace {
+
+        // Bumped whenever the layout of the cache file or the simplification algorithm changes
+        constexpr uint32_t CacheFileVersion = 1;
+
+        uint64_t VertexHash(const SubMesh &subMesh) {
+            auto &vertices = subMesh.vertices();
+            FNV1aHash hash;
+            hash.combine(vertices.data(), vertices.size() * sizeof(Vertex1P1N2UV1T1BT));
+            return hash.value();
+        }
+
+    }
+
+#pragma mark - Lifecycle
+
+    MeshLODGenerator::MeshLODGenerator()
+            :
+            MeshLODGenerator(Settings()) {
+    }
+
+    MeshLODGenerator::MeshLODGenerator(const Settings &settings)
+            :
+            mSettings(settings) {
+    }
+
+#pragma mark - Private helpers
+
+    uint64_t MeshLODGenerator::settingsHash() const {
+        FNV1aHash hash;
+        hash.combine(CacheFileVersion);
+        hash.combine(mSettings.maximumLODCount);
+        hash.combine(mSettings.triangleReduction);
+        hash.combine(mSettings.minimumTriangleCount);
+        hash.combine(mSettings.maximumRelativeError);
+        hash.combine(mSettings.simplifierSettings.attributeWeight);
+        hash.combine(mSettings.simplifierSettings.lockBorders);
+        return hash.value();
+    }
+
+#pragma mark - Generation
+
+    std::string MeshLODGenerator::CacheFilePath(const std::string &meshFilePath) {
+        const std::string &cacheRootPath = FileManager::shared().cacheRootPath();
+        if (cacheRootPath.empty()) {
+            return "";
+        }
+
+        std::string fileName = meshFilePath.substr(meshFilePath.find_last_of('/') + 1);
+        FNV1aHash pathHash;
+        pathHash.combine(meshFilePath.data(), meshFilePath.size());
+        return cacheRootPath + string_format("%s.%016llx.lods", fileName.c_str(), (unsigned long long) pathHash.value());
+    }
+
+    void MeshLODGenerator::generate(SubMesh &subMesh) const {
+        EA_PROFILE_SCOPE("Generate sub mesh LODs");
+
+        MeshSimplifier simplifier(subMesh.vertices(), subMesh.boundingBox(), mSettings.simplifierSettings);
+        float maximumError = mSettings.maximumRelativeError * subMesh.boundingBox().diagonal();
+
+        SubMesh::LevelOfDetailVector levelsOfDetail;
+        size_t previousTriangleCount = simplifier.triangleCount();
+
+        while (levelsOfDetail.size() < mSettings.maximumLODCount) {
+            auto targetTriangleCount = size_t(previousTriangleCount * mSettings.triangleReduction);
+            if (targetTriangleCount < mSettings.minimumTriangleCount) {
+                break;
+            }
+
+            simplifier.simplify(targetTriangleCount, maximumError);
+
+            // A level barely different from the previous one isn't worth the memory
+            size_t triangleCount = simplifier.triangleCount();
+            if (triangleCount > previousTriangleCount * (1.0 + mSettings.triangleReduction) / 2.0) {
+                break;
+            }
+
+            levelsOfDetail.push_back({simplifier.vertices(), simplifier.error()});
+            previousTriangleCount = triangleCount;
+        }
+
+        subMesh.setLevelsOfDetail(std::move(levelsOfDetail));
+    }
+
+    void MeshLODGenerator::generate(std::vector<SubMesh> &subMeshes) const {
+        EA_PROFILE_SCOPE("Generate mesh LODs");
+
+        ThreadPool::Default().parallelFor(subMeshes.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                generate(subMeshes[i]);
+            }
+        });
+    }
+
+#pragma mark - Serialization
+
+    bool MeshLODGenerator::serialize(const std::vector<SubMesh> &subMeshes, const std::string &filePath) const {
+        EA_PROFILE_SCOPE("Serialize mesh LODs");
+
+        std::string temporaryPath = filePath + ".tmp";
+        std::ofstream stream(temporaryPath, std::ios::trunc | std::ios::binary);
+        if (!stream.is_open()) {
+            return false;
+        }
+
+        bitsery::Serializer<bitsery::OutputBufferedStreamAdapter> serializer(stream);
+        serializer.value8b(settingsHash());
+        serializer.value4b(uint32_t(subMeshes.size()));
+
+        for (auto &subMesh : subMeshes) {
+            serializer.value8b(VertexHash(subMesh));
+            serializer.value4b(uint32_t(subMesh.levelsOfDetail().size()));
+
+            for (auto &lod : subMesh.levelsOfDetail()) {
+                serializer.value4b(lod.error);
+                serializer.value4b(uint32_t(lod.vertices.size()));
+                for (auto &vertex : lod.vertices) {
+                    serializer.object(vertex);
+                }
+            }
+        }
+
+        bitsery::AdapterAccess::getWriter(serializer).flush();
+        stream.close();
+
+        if (stream.fail() || std::rename(temporaryPath.c_str(), filePath.c_str()) != 0) {
+            std::remove(temporaryPath.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    bool MeshLODGenerator::deserialize(std::vector<SubMesh> &subMeshes, const std::string &filePath) const {
+        EA_PROFILE_SCOPE("Deserialize mesh LODs");
+
+        std::ifstream stream(filePath, std::ios::binary);
+        if (!stream.is_open()) {
+            return false;
+        }
+
+        bitsery::Deserializer<bitsery::InputStreamAdapter> deserializer(stream);
+        auto &reader = bitsery::AdapterAccess::getReader(deserializer);
+
+        uint64_t fileSettingsHash = 0;
+        uint32_t subMeshCount = 0;
+        deserializer.value8b(fileSettingsHash);
+        deserializer.value4b(subMeshCount);
+
+        if (reader.error() != bitsery::ReaderError::NoError || fileSettingsHash != settingsHash() || subMeshCount != subMeshes.size()) {
+            return false;
+        }
+
+        std::vector<SubMesh::LevelOfDetailVector> levelsOfDetail(subMeshCount);
+
+        for (size_t i = 0; i < subMeshCount; i++) {
+            uint64_t vertexHash = 0;
+            uint32_t lodCount = 0;
+            deserializer.value8b(vertexHash);
+            deserializer.value4b(lodCount);
+
+            if (reader.error() != bitsery::ReaderError::NoError || vertexHash != VertexHash(subMeshes[i]) || lodCount > mSettings.maximumLODCount) {
+                return false;
+            }
+
+            levelsOfDetail[i].resize(lodCount);
+            for (auto &lod : levelsOfDetail[i]) {
+                uint32_t vertexCount = 0;
+                deserializer.value4b(lod.error);
+                deserializer.value4b(vertexCount);
+
+                if (reader.error() != bitsery::ReaderError::NoError || vertexCount > subMeshes[i].vertices().size()) {
+                    return false;
+                }
+
+                // Vertices aren't default constructible, so the container can't be resized by bitsery
+                lod.vertices.reserve(vertexCount);
+                for (uint32_t v = 0; v < vertexCount; v++) {
+                    Vertex1P1N2UV1T1BT vertex(glm::vec4(0.0));
+                    deserializer.object(vertex);
+                    lod.vertices.push_back(vertex);
+                }
+            }
+        }
+
+        if (!reader.isCompletedSuccessfully()) {
+            return false;
+        }
+
+        for (size_t i = 0; i < subMeshCount; i++) {
+            subMeshes[i].setLevelsOfDetail(std::move(levelsOfDetail[i]));
+        }
+
+        return true;
+    }
+
+}
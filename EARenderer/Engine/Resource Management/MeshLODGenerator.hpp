@@ -0,0 +1,80 @@
+//
+// Created by Pavlo Muratov on 2019-02-15.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_MESHLODGENERATOR_HPP
+#define EARENDERER_MESHLODGENERATOR_HPP
+
+#include "SubMesh.hpp"
+#include "MeshSimplifier.hpp"
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+namespace EARenderer {
+
+    /**
+     Builds chains of simplified sub meshes and caches them in a file under the cache root of the file manager.
+     Every level aims at a fixed fraction of triangles of the previous one. The chain ends once
+     the error limit or the minimum triangle count is reached, or once simplification stalls.
+     */
+    class MeshLODGenerator {
+    public:
+        struct Settings {
+            uint32_t maximumLODCount = 4;
+            // Triangle count of each level relative to the previous one
+            float triangleReduction = 0.5;
+            // Levels having fewer triangles are not generated
+            uint32_t minimumTriangleCount = 32;
+            // Error limit relative to the sub mesh bounding box diagonal
+            float maximumRelativeError = 0.05;
+            MeshSimplifier::Settings simplifierSettings;
+        };
+
+    private:
+        Settings mSettings;
+
+        uint64_t settingsHash() const;
+
+    public:
+        MeshLODGenerator();
+
+        MeshLODGenerator(const Settings &settings);
+
+        /**
+         Cache files are named after the mesh file and a hash of its full path, so meshes sharing a file name don't collide
+
+         @return path of the file caching LODs of the mesh at meshFilePath, empty if the file manager has no cache root
+         */
+        static std::string CacheFilePath(const std::string &meshFilePath);
+
+        void generate(SubMesh &subMesh) const;
+
+        /**
+         Generates LODs of all sub meshes concurrently
+         */
+        void generate(std::vector<SubMesh> &subMeshes) const;
+
+        /**
+         Writes LODs of the sub meshes along with hashes of their vertices and of generator settings.
+         The file is written to a temporary path first and renamed over the destination afterwards,
+         so an interrupted write never leaves a truncated cache behind
+
+         @return false if the file couldn't be written
+         */
+        bool serialize(const std::vector<SubMesh> &subMeshes, const std::string &filePath) const;
+
+        /**
+         Reads LODs into the sub meshes. Nothing is assigned unless the file is intact and was generated
+         with the same settings from the same vertices
+
+         @return true if LODs have been assigned
+         */
+        bool deserialize(std::vector<SubMesh> &subMeshes, const std::string &filePath) const;
+    };
+
+}
+
+#endif //EARENDERER_MESHLODGENERATOR_HPP
@@ -0,0 +1,433 @@
+//
+// Created by Pavlo Muratov on 2019-02-14.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "MeshProcessor.hpp"
+#include "ThreadPool.hpp"
+#include "Triangle3D.hpp"
+#include "Profiler.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtx/norm.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+namespace EARenderer {
+
+    namespace {
+
+        // Size of vertex and triangle ranges processed by a single task. Fixed, so that range boundaries
+        // and therefore the order of floating point reductions don't depend on the amount of threads.
+        constexpr size_t GrainSize = 4096;
+
+        /**
+         Vertices sorted by their weld keys, vertices sharing a key being adjacent and ordered by index.
+         Group g spans members [offsets[g], offsets[g + 1]).
+         */
+        struct WeldGroups {
+            std::vector<uint32_t> members;
+            std::vector<uint32_t> offsets;
+
+            size_t count() const {
+                return offsets.size() - 1;
+            }
+        };
+
+        uint32_t FloatKey(float value) {
+            // Treat -0 and +0 as the same value
+            if (value == 0.0f) {
+                value = 0.0f;
+            }
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        }
+
+        uint32_t PositionKey(float value, float tolerance) {
+            if (tolerance > 0.0f) {
+                return uint32_t(int32_t(std::floor(value / tolerance)));
+            }
+            return FloatKey(value);
+        }
+
+        glm::vec3 NormalizedOrZero(const glm::vec3 &v) {
+            float length2 = glm::length2(v);
+            return length2 > 0.0f ? v / std::sqrt(length2) : glm::vec3(0.0);
+        }
+
+        /**
+         Sorts ranges of GrainSize elements concurrently and then merges them pairwise, level by level.
+         Elements are expected to be unique, which makes the result independent of scheduling.
+         */
+        template<typename T>
+        void ParallelSort(ThreadPool &threadPool, std::vector<T> &elements) {
+            size_t count = elements.size();
+
+            threadPool.parallelFor(count, GrainSize, [&](size_t begin, size_t end) {
+                std::sort(elements.begin() + begin, elements.begin() + end);
+            });
+
+            for (size_t width = GrainSize; width < count; width *= 2) {
+                size_t pairCount = (count + 2 * width - 1) / (2 * width);
+                threadPool.parallelFor(pairCount, 1, [&](size_t begin, size_t end) {
+                    for (size_t pair = begin; pair < end; pair++) {
+                        size_t first = pair * 2 * width;
+                        size_t middle = std::min(first + width, count);
+                        size_t last = std::min(first + 2 * width, count);
+                        std::inplace_merge(elements.begin() + first, elements.begin() + middle, elements.begin() + last);
+                    }
+                });
+            }
+        }
+
+        /**
+         Groups vertices having equal keys
+
+         @param keyOf callable producing std::array<uint32_t, N> for a vertex index
+         */
+        template<size_t N, typename KeyFunc>
+        WeldGroups Weld(ThreadPool &threadPool, size_t vertexCount, KeyFunc keyOf) {
+            using Entry = std::pair<std::array<uint32_t, N>, uint32_t>;
+            std::vector<Entry> entries(vertexCount);
+
+            threadPool.parallelFor(vertexCount, GrainSize, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    entries[i] = Entry(keyOf(i), uint32_t(i));
+                }
+            });
+
+            ParallelSort(threadPool, entries);
+
+            WeldGroups groups;
+            groups.members.resize(vertexCount);
+            groups.offsets.reserve(vertexCount + 1);
+
+            for (size_t i = 0; i < vertexCount; i++) {
+                if (i == 0 || entries[i].first != entries[i - 1].first) {
+                    groups.offsets.push_back(uint32_t(i));
+                }
+                groups.members[i] = entries[i].second;
+            }
+            groups.offsets.push_back(uint32_t(vertexCount));
+
+            return groups;
+        }
+
+        /**
+         @return unit vector orthogonal to the normal, used when texture coordinates don't define a tangent
+         */
+        glm::vec3 ArbitraryTangent(const glm::vec3 &normal) {
+            glm::vec3 axis = std::abs(normal.x) < 0.9f ? glm::vec3(1.0, 0.0, 0.0) : glm::vec3(0.0, 1.0, 0.0);
+            return glm::normalize(axis - normal * glm::dot(normal, axis));
+        }
+
+    }
+
+#pragma mark - Lifecycle
+
+    MeshProcessor::MeshProcessor()
+            :
+            MeshProcessor(Settings()) {
+    }
+
+    MeshProcessor::MeshProcessor(const Settings &settings)
+            :
+            MeshProcessor(settings, &ThreadPool::Default()) {
+    }
+
+    MeshProcessor::MeshProcessor(const Settings &settings, ThreadPool *threadPool)
+            :
+            mSettings(settings),
+            mThreadPool(threadPool) {
+    }
+
+#pragma mark - Stages
+
+    void MeshProcessor::generateNormals(SubMesh &subMesh) const {
+        auto &vertices = subMesh.vertices();
+        size_t triangleCount = vertices.size() / 3;
+        size_t vertexCount = triangleCount * 3;
+
+        bool isAnyNormalMissing = std::any_of(vertices.begin(), vertices.begin() + vertexCount, [](auto &vertex) {
+            return vertex.normal == glm::vec3(0.0);
+        });
+
+        if (!isAnyNormalMissing) {
+            return;
+        }
+
+        EA_PROFILE_SCOPE("Generate normals");
+
+        // Area weighted face normals
+        std::vector<glm::vec3> faceNormals(triangleCount);
+        mThreadPool->parallelFor(triangleCount, GrainSize, [&](size_t begin, size_t end) {
+            for (size_t t = begin; t < end; t++) {
+                glm::vec3 p0 = vertices[t * 3].position;
+                glm::vec3 edge1 = glm::vec3(vertices[t * 3 + 1].position) - p0;
+                glm::vec3 edge2 = glm::vec3(vertices[t * 3 + 2].position) - p0;
+                faceNormals[t] = glm::cross(edge1, edge2);
+            }
+        });
+
+        float tolerance = mSettings.weldTolerance;
+        auto groups = Weld<3>(*mThreadPool, vertexCount, [&](size_t i) {
+            auto &position = vertices[i].position;
+            return std::array<uint32_t, 3>{
+                    PositionKey(position.x, tolerance),
+                    PositionKey(position.y, tolerance),
+                    PositionKey(position.z, tolerance)
+            };
+        });
+
+        bool isSmoothingUnrestricted = mSettings.creaseAngle >= 180.0f;
+        float minimumCosine = std::cos(glm::radians(mSettings.creaseAngle));
+
+        mThreadPool->parallelFor(groups.count(), GrainSize, [&](size_t begin, size_t end) {
+            for (size_t g = begin; g < end; g++) {
+                uint32_t first = groups.offsets[g];
+                uint32_t last = groups.offsets[g + 1];
+
+                // Members are ordered by index, so the sums are accumulated in the same order every time
+                glm::vec3 groupNormal(0.0);
+                if (isSmoothingUnrestricted) {
+                    for (uint32_t m = first; m < last; m++) {
+                        groupNormal += faceNormals[groups.members[m] / 3];
+                    }
+                }
+
+                for (uint32_t m = first; m < last; m++) {
+                    auto &vertex = vertices[groups.members[m]];
+                    if (vertex.normal != glm::vec3(0.0)) {
+                        continue;
+                    }
+
+                    glm::vec3 ownFaceNormal = faceNormals[groups.members[m] / 3];
+                    glm::vec3 normal = groupNormal;
+
+                    if (!isSmoothingUnrestricted) {
+                        glm::vec3 ownDirection = NormalizedOrZero(ownFaceNormal);
+                        for (uint32_t n = first; n < last; n++) {
+                            glm::vec3 faceNormal = faceNormals[groups.members[n] / 3];
+                            if (glm::dot(NormalizedOrZero(faceNormal), ownDirection) >= minimumCosine) {
+                                normal += faceNormal;
+                            }
+                        }
+                    }
+
+                    // Opposite faces may cancel each other out
+                    if (glm::length2(normal) == 0.0f) {
+                        normal = ownFaceNormal;
+                    }
+
+                    vertex.normal = glm::length2(normal) > 0.0f ? glm::normalize(normal) : glm::vec3(0.0, 0.0, 1.0);
+                }
+            }
+        });
+    }
+
+    void MeshProcessor::generateTangents(SubMesh &subMesh) const {
+        auto &vertices = subMesh.vertices();
+        size_t triangleCount = vertices.size() / 3;
+        size_t vertexCount = triangleCount * 3;
+
+        bool isAnyTangentMissing = std::any_of(vertices.begin(), vertices.begin() + vertexCount, [](auto &vertex) {
+            return vertex.tangent == glm::vec3(0.0);
+        });
+
+        if (!isAnyTangentMissing) {
+            return;
+        }
+
+        EA_PROFILE_SCOPE("Generate tangents");
+
+        // Following MikkTSpace, every corner contributes a tangent projected onto the plane
+        // of its vertex normal and weighted by the corner angle. Corners of mirrored
+        // triangles are kept apart from non-mirrored ones, so that seams get distinct tangents.
+        std::vector<glm::vec3> cornerTangents(vertexCount);
+        std::vector<glm::vec3> cornerBitangents(vertexCount);
+        std::vector<uint8_t> mirroredTriangles(triangleCount);
+
+        mThreadPool->parallelFor(triangleCount, GrainSize, [&](size_t begin, size_t end) {
+            for (size_t t = begin; t < end; t++) {
+                std::array<glm::vec3, 3> positions;
+                std::array<glm::vec2, 3> uvs;
+                for (size_t c = 0; c < 3; c++) {
+                    positions[c] = vertices[t * 3 + c].position;
+                    uvs[c] = vertices[t * 3 + c].textureCoords;
+                }
+
+                glm::vec3 edge1 = positions[1] - positions[0];
+                glm::vec3 edge2 = positions[2] - positions[0];
+                glm::vec2 deltaUV1 = uvs[1] - uvs[0];
+                glm::vec2 deltaUV2 = uvs[2] - uvs[0];
+
+                float determinant = deltaUV1.x * deltaUV2.y - deltaUV2.x * deltaUV1.y;
+                mirroredTriangles[t] = determinant < 0.0f;
+
+                // Degenerate texture mapping doesn't define a tangent, neighbours or the fallback will
+                if (determinant == 0.0f) {
+                    for (size_t c = 0; c < 3; c++) {
+                        cornerTangents[t * 3 + c] = glm::vec3(0.0);
+                        cornerBitangents[t * 3 + c] = glm::vec3(0.0);
+                    }
+                    continue;
+                }
+
+                // Only the orientation matters, magnitude is normalized away per corner
+                float sign = determinant > 0.0f ? 1.0f : -1.0f;
+                glm::vec3 tangent = (edge1 * deltaUV2.y - edge2 * deltaUV1.y) * sign;
+                glm::vec3 bitangent = (edge2 * deltaUV1.x - edge1 * deltaUV2.x) * sign;
+
+                for (size_t c = 0; c < 3; c++) {
+                    glm::vec3 toNext = NormalizedOrZero(positions[(c + 1) % 3] - positions[c]);
+                    glm::vec3 toPrevious = NormalizedOrZero(positions[(c + 2) % 3] - positions[c]);
+                    float angle = std::acos(glm::clamp(glm::dot(toNext, toPrevious), -1.0f, 1.0f));
+
+                    glm::vec3 normal = vertices[t * 3 + c].normal;
+                    glm::vec3 projectedTangent = NormalizedOrZero(tangent - normal * glm::dot(normal, tangent));
+                    glm::vec3 projectedBitangent = NormalizedOrZero(bitangent - normal * glm::dot(normal, bitangent));
+
+                    cornerTangents[t * 3 + c] = projectedTangent * angle;
+                    cornerBitangents[t * 3 + c] = projectedBitangent * angle;
+                }
+            }
+        });
+
+        float tolerance = mSettings.weldTolerance;
+        auto groups = Weld<9>(*mThreadPool, vertexCount, [&](size_t i) {
+            auto &vertex = vertices[i];
+            return std::array<uint32_t, 9>{
+                    PositionKey(vertex.position.x, tolerance),
+                    PositionKey(vertex.position.y, tolerance),
+                    PositionKey(vertex.position.z, tolerance),
+                    FloatKey(vertex.normal.x),
+                    FloatKey(vertex.normal.y),
+                    FloatKey(vertex.normal.z),
+                    FloatKey(vertex.textureCoords.x),
+                    FloatKey(vertex.textureCoords.y),
+                    mirroredTriangles[i / 3]
+            };
+        });
+
+        mThreadPool->parallelFor(groups.count(), GrainSize, [&](size_t begin, size_t end) {
+            for (size_t g = begin; g < end; g++) {
+                uint32_t first = groups.offsets[g];
+                uint32_t last = groups.offsets[g + 1];
+
+                glm::vec3 tangentSum(0.0);
+                glm::vec3 bitangentSum(0.0);
+                for (uint32_t m = first; m < last; m++) {
+                    tangentSum += cornerTangents[groups.members[m]];
+                    bitangentSum += cornerBitangents[groups.members[m]];
+                }
+
+                for (uint32_t m = first; m < last; m++) {
+                    auto &vertex = vertices[groups.members[m]];
+                    if (vertex.tangent != glm::vec3(0.0)) {
+                        continue;
+                    }
+
+                    glm::vec3 normal = vertex.normal;
+                    glm::vec3 tangent = NormalizedOrZero(tangentSum - normal * glm::dot(normal, tangentSum));
+                    if (tangent == glm::vec3(0.0)) {
+                        tangent = ArbitraryTangent(normal);
+                    }
+
+                    // Bitangent is reconstructed from the cross product and handedness, like shaders do with MikkTSpace
+                    float handedness = glm::dot(glm::cross(normal, tangent), bitangentSum) < 0.0f ? -1.0f : 1.0f;
+
+                    vertex.tangent = tangent;
+                    vertex.bitangent = glm::cross(normal, tangent) * handedness;
+                }
+            }
+        });
+    }
+
+    void MeshProcessor::buildMeshlets(SubMesh &subMesh) const {
+        if (mSettings.buildMeshlets) {
+            MeshletBuilder(mSettings.meshletSettings).build(subMesh);
+        }
+    }
+
+    void MeshProcessor::calculateBoundsAndArea(SubMesh &subMesh) const {
+        auto &vertices = subMesh.vertices();
+        size_t triangleCount = vertices.size() / 3;
+        size_t rangeCount = (triangleCount + GrainSize - 1) / GrainSize;
+
+        SubMesh::AreaVector prefixSums(triangleCount);
+        std::vector<float> rangeAreas(rangeCount, 0.0);
+        std::vector<AxisAlignedBox3D> rangeBoxes(rangeCount, AxisAlignedBox3D::MaximumReversed());
+
+        // Areas and partial sums within ranges
+        mThreadPool->parallelFor(triangleCount, GrainSize, [&](size_t begin, size_t end) {
+            size_t range = begin / GrainSize;
+            float sum = 0.0;
+            AxisAlignedBox3D box = AxisAlignedBox3D::MaximumReversed();
+
+            for (size_t t = begin; t < end; t++) {
+                Triangle3D triangle(vertices[t * 3].position, vertices[t * 3 + 1].position, vertices[t * 3 + 2].position);
+                sum += triangle.area();
+                prefixSums[t] = sum;
+
+                for (auto &point : {triangle.p1, triangle.p2, triangle.p3}) {
+                    box.min = glm::min(box.min, point);
+                    box.max = glm::max(box.max, point);
+                }
+            }
+
+            rangeAreas[range] = sum;
+            rangeBoxes[range] = box;
+        });
+
+        // Offsets of ranges, accumulated in order
+        AxisAlignedBox3D boundingBox = AxisAlignedBox3D::MaximumReversed();
+        std::vector<float> rangeOffsets(rangeCount, 0.0);
+        for (size_t range = 0; range < rangeCount; range++) {
+            rangeOffsets[range] = range > 0 ? rangeOffsets[range - 1] + rangeAreas[range - 1] : 0.0f;
+            boundingBox.min = glm::min(boundingBox.min, rangeBoxes[range].min);
+            boundingBox.max = glm::max(boundingBox.max, rangeBoxes[range].max);
+        }
+
+        mThreadPool->parallelFor(triangleCount, GrainSize, [&](size_t begin, size_t end) {
+            float offset = rangeOffsets[begin / GrainSize];
+            for (size_t t = begin; t < end; t++) {
+                prefixSums[t] += offset;
+            }
+        });
+
+        subMesh.setBoundingBox(boundingBox);
+        subMesh.setTriangleAreaPrefixSums(std::move(prefixSums));
+    }
+
+#pragma mark - Public interface
+
+    void MeshProcessor::process(SubMesh &subMesh) const {
+        generateNormals(subMesh);
+        generateTangents(subMesh);
+        // Reorders triangles, so has to precede area prefix sums
+        buildMeshlets(subMesh);
+        calculateBoundsAndArea(subMesh);
+    }
+
+    AxisAlignedBox3D MeshProcessor::process(std::vector<SubMesh> &subMeshes) const {
+        EA_PROFILE_SCOPE("Process sub meshes");
+
+        mThreadPool->parallelFor(subMeshes.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                process(subMeshes[i]);
+            }
+        });
+
+        AxisAlignedBox3D boundingBox = AxisAlignedBox3D::MaximumReversed();
+        for (auto &subMesh : subMeshes) {
+            boundingBox.min = glm::min(boundingBox.min, subMesh.boundingBox().min);
+            boundingBox.max = glm::max(boundingBox.max, subMesh.boundingBox().max);
+        }
+        return boundingBox;
+    }
+
+}
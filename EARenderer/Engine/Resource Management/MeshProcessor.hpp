@@ -0,0 +1,78 @@
+//
+// Created by Pavlo Muratov on 2019-02-14.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_MESHPROCESSOR_HPP
+#define EARENDERER_MESHPROCESSOR_HPP
+
+#include "SubMesh.hpp"
+#include "AxisAlignedBox3D.hpp"
+#include "MeshletBuilder.hpp"
+
+#include <vector>
+
+namespace EARenderer {
+
+    class ThreadPool;
+
+    /**
+     Post-processes freshly loaded or generated sub meshes: welds coincident vertices,
+     fills in missing normals and tangents, clusters triangles into meshlets, computes bounding boxes,
+     surface areas and per-triangle area prefix sums used for area-weighted sampling.
+
+     Sub meshes are processed concurrently and so are triangle ranges inside of them.
+     Ranges are of a fixed size and reductions over them happen in order, hence the output
+     is bitwise identical regardless of the amount of threads doing the work.
+
+     Vertices are expected to form a triangle list. A zero normal or tangent marks
+     the attribute as missing, attributes provided by the source file are kept as is.
+     */
+    class MeshProcessor {
+    public:
+        struct Settings {
+            // Faces sharing a vertex are only averaged into its normal if the angle between them
+            // doesn't exceed this value (degrees). Stands in for smoothing groups, which loaders don't provide.
+            float creaseAngle = 180.0;
+            // Positions closer than this are treated as the same vertex when welding. Zero welds bitwise equal positions only.
+            float weldTolerance = 0.0;
+            // Reorders triangles into meshlets for fine grained culling
+            bool buildMeshlets = true;
+            MeshletBuilder::Settings meshletSettings;
+        };
+
+    private:
+        Settings mSettings;
+        ThreadPool *mThreadPool;
+
+        void generateNormals(SubMesh &subMesh) const;
+
+        void generateTangents(SubMesh &subMesh) const;
+
+        void buildMeshlets(SubMesh &subMesh) const;
+
+        void calculateBoundsAndArea(SubMesh &subMesh) const;
+
+    public:
+        MeshProcessor();
+
+        MeshProcessor(const Settings &settings);
+
+        MeshProcessor(const Settings &settings, ThreadPool *threadPool);
+
+        /**
+         Runs all stages on a single sub mesh
+         */
+        void process(SubMesh &subMesh) const;
+
+        /**
+         Runs all stages on every sub mesh
+
+         @return bounding box enclosing all sub meshes
+         */
+        AxisAlignedBox3D process(std::vector<SubMesh> &subMeshes) const;
+    };
+
+}
+
+#endif //EARENDERER_MESHPROCESSOR_HPP
@@ -0,0 +1,53 @@
+//
+// Created by Pavlo Muratov on 2019-02-14.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "MeshVertexLayout.hpp"
+#include "Vertex1P1N2UV1T1BT.hpp"
+#include "QuantizedVertex.hpp"
+
+namespace EARenderer {
+
+    std::vector<GLVertexAttribute> MeshVertexLayout::Attributes(Format format) {
+        switch (format) {
+            case Format::Float:
+                return {
+                        GLVertexAttribute::UniqueAttribute(sizeof(glm::vec4), glm::vec4::length()),
+                        GLVertexAttribute::UniqueAttribute(sizeof(glm::vec3), glm::vec3::length()),
+                        GLVertexAttribute::UniqueAttribute(sizeof(glm::vec2), glm::vec2::length()),
+                        GLVertexAttribute::UniqueAttribute(sizeof(glm::vec3), glm::vec3::length()),
+                        GLVertexAttribute::UniqueAttribute(sizeof(glm::vec3), glm::vec3::length()),
+                        GLVertexAttribute::UniqueAttribute(sizeof(glm::vec3), glm::vec3::length())
+                };
+
+            case Format::Quantized:
+                return {
+                        GLVertexAttribute::PackedAttribute(sizeof(glm::u16vec4), glm::u16vec4::length(), GL_UNSIGNED_SHORT, GL_TRUE),
+                        GLVertexAttribute::PackedAttribute(sizeof(glm::u16vec2), glm::u16vec2::length(), GL_HALF_FLOAT, GL_FALSE),
+                        GLVertexAttribute::PackedAttribute(sizeof(glm::u16vec2), glm::u16vec2::length(), GL_UNSIGNED_SHORT, GL_TRUE),
+                        GLVertexAttribute::PackedAttribute(sizeof(glm::i16vec2), glm::i16vec2::length(), GL_SHORT, GL_TRUE),
+                        GLVertexAttribute::PackedAttribute(sizeof(glm::i16vec2), glm::i16vec2::length(), GL_SHORT, GL_TRUE)
+                };
+        }
+    }
+
+    size_t MeshVertexLayout::Stride(Format format) {
+        switch (format) {
+            case Format::Float:
+                return sizeof(Vertex1P1N2UV1T1BT);
+            case Format::Quantized:
+                return sizeof(QuantizedVertex);
+        }
+    }
+
+    GLSLPreprocessor::Defines MeshVertexLayout::ShaderDefines(Format format) {
+        switch (format) {
+            case Format::Float:
+                return {};
+            case Format::Quantized:
+                return {{"QUANTIZED_VERTICES", "1"}};
+        }
+    }
+
+}
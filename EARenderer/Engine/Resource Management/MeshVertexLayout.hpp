@@ -0,0 +1,49 @@
+//
+// Created by Pavlo Muratov on 2019-02-14.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_MESHVERTEXLAYOUT_HPP
+#define EARENDERER_MESHVERTEXLAYOUT_HPP
+
+#include "GLVertexAttribute.hpp"
+#include "GLSLPreprocessor.hpp"
+
+#include <vector>
+
+namespace EARenderer {
+
+    /**
+     Describes how mesh vertices are laid out in the GPU buffer and how shaders have to read them.
+     Attribute locations are shared by both formats:
+     0 - position, 1 - texture coordinates, 2 - lightmap coordinates, 3 - normal, 4 - tangent, 5 - bitangent (float format only)
+     */
+    class MeshVertexLayout {
+    public:
+        enum class Format {
+            // Vertex1P1N2UV1T1BT as is, 72 bytes
+            Float,
+            // QuantizedVertex, 24 bytes. Positions are relative to the sub mesh bounding box
+            // and have to be dequantized through the model matrix
+            Quantized
+        };
+
+        /**
+         @return attribute descriptions in order of their locations
+         */
+        static std::vector<GLVertexAttribute> Attributes(Format format);
+
+        /**
+         @return size of a single vertex in bytes
+         */
+        static size_t Stride(Format format);
+
+        /**
+         @return definitions selecting the matching attribute declarations in mesh vertex shaders
+         */
+        static GLSLPreprocessor::Defines ShaderDefines(Format format);
+    };
+
+}
+
+#endif //EARENDERER_MESHVERTEXLAYOUT_HPP
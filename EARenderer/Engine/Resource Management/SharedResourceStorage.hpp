@@ -61,6 +61,16 @@ namespace EARenderer {
             std::for_each(std::begin(mMeshes), std::end(mMeshes), f);
         }
 
+        template <typename F>
+        void iterateCookTorranceMaterials(F f) const {
+            std::for_each(std::begin(mCookTorranceMaterials), std::end(mCookTorranceMaterials), f);
+        }
+
+        template <typename F>
+        void iterateEmissiveMaterials(F f) const {
+            std::for_each(std::begin(mEmissiveMaterials), std::end(mEmissiveMaterials), f);
+        }
+
         template <typename F>
         void iterateMaterials(F f) const {
 //            std::for_each(std::begin(mMeshes), std::end(mMeshes), f);
@@ -0,0 +1,98 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "SimulatedTextureStreamingBackend.hpp"
+#include "StringUtils.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+namespace EARenderer {
+
+#pragma mark - Lifecycle
+
+    SimulatedTextureStreamingBackend::SimulatedTextureStreamingBackend(const Size2D &defaultImageSize, std::chrono::microseconds loadLatency)
+            : mDefaultImageSize(defaultImageSize), mLoadLatency(loadLatency) {}
+
+#pragma mark - Setters
+
+    void SimulatedTextureStreamingBackend::setImageSize(const std::string &path, const Size2D &size) {
+        mImageSizes[path] = size;
+    }
+
+    void SimulatedTextureStreamingBackend::setLoadFailure(const std::string &path) {
+        mFailingPaths.insert(path);
+    }
+
+#pragma mark - Getters
+
+    std::optional<uint32_t> SimulatedTextureStreamingBackend::residentMipLevel(const TextureKey &key) const {
+        auto mipIt = mResidentMipLevels.find({key.materialID, key.mapType});
+        if (mipIt == mResidentMipLevels.end()) {
+            return std::nullopt;
+        }
+        return mipIt->second;
+    }
+
+    size_t SimulatedTextureStreamingBackend::uploadCount() const {
+        return mUploadCount;
+    }
+
+    size_t SimulatedTextureStreamingBackend::dropCount() const {
+        return mDropCount;
+    }
+
+#pragma mark - TextureStreamingBackend
+
+    TextureStreamingBackend::TextureDescription SimulatedTextureStreamingBackend::describe(const TextureKey &key, const std::string &path) {
+        auto sizeIt = mImageSizes.find(path);
+        TextureDescription description;
+        description.size = sizeIt != mImageSizes.end() ? sizeIt->second : mDefaultImageSize;
+        return description;
+    }
+
+    TextureStreamingBackend::StagedMip SimulatedTextureStreamingBackend::load(const TextureKey &key, const std::string &path, uint32_t mipLevel) {
+        // Settings aren't changed while loads are in flight, so workers read them unsynchronized
+        std::this_thread::sleep_for(mLoadLatency);
+
+        if (mFailingPaths.count(path)) {
+            throw std::runtime_error(string_format("Simulated failure loading %s", path.c_str()));
+        }
+
+        auto sizeIt = mImageSizes.find(path);
+        Size2D size = sizeIt != mImageSizes.end() ? sizeIt->second : mDefaultImageSize;
+
+        StagedMip mip;
+        mip.mipLevel = mipLevel;
+        mip.size = Size2D(std::max(1u, uint32_t(size.width) >> mipLevel), std::max(1u, uint32_t(size.height) >> mipLevel));
+        mip.pixels.resize(size_t(mip.size.width) * size_t(mip.size.height) * 4);
+        return mip;
+    }
+
+    void SimulatedTextureStreamingBackend::upload(const TextureKey &key, StagedMip &&mip) {
+        auto mipIt = mResidentMipLevels.find({key.materialID, key.mapType});
+        if (mipIt != mResidentMipLevels.end() && mip.mipLevel >= mipIt->second) {
+            throw std::logic_error(string_format("Mip level %u is uploaded over finer mip level %u", mip.mipLevel, mipIt->second));
+        }
+
+        mResidentMipLevels[{key.materialID, key.mapType}] = mip.mipLevel;
+        mUploadCount++;
+    }
+
+    void SimulatedTextureStreamingBackend::drop(const TextureKey &key, uint32_t residentMipLevel, uint32_t mipLevel) {
+        auto mipIt = mResidentMipLevels.find({key.materialID, key.mapType});
+        if (mipIt == mResidentMipLevels.end() || mipIt->second != residentMipLevel) {
+            throw std::logic_error(string_format("Dropping mip levels finer than %u from a texture not holding mip level %u", mipLevel, residentMipLevel));
+        }
+        if (mipLevel <= residentMipLevel) {
+            throw std::logic_error(string_format("Dropping mip levels finer than %u from a texture holding mip level %u", mipLevel, residentMipLevel));
+        }
+
+        mipIt->second = mipLevel;
+        mDropCount++;
+    }
+
+}
@@ -0,0 +1,69 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_SIMULATEDTEXTURESTREAMINGBACKEND_HPP
+#define EARENDERER_SIMULATEDTEXTURESTREAMINGBACKEND_HPP
+
+#include "TextureStreamingBackend.hpp"
+
+#include <chrono>
+#include <map>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace EARenderer {
+
+    /**
+     Texture streaming backend without images or a GPU, for exercising streaming decisions.
+     Images have predefined sizes, loads take a configurable time and produce blank texels,
+     and mip levels held by every texture are tracked to catch uploads and drops out of order.
+     */
+    class SimulatedTextureStreamingBackend : public TextureStreamingBackend {
+    private:
+        Size2D mDefaultImageSize;
+        std::unordered_map<std::string, Size2D> mImageSizes;
+        std::unordered_set<std::string> mFailingPaths;
+        std::chrono::microseconds mLoadLatency;
+        // Finest mip level held by textures that got any upload
+        std::map<std::pair<ID, CookTorranceMaterial::MapType>, uint32_t> mResidentMipLevels;
+        size_t mUploadCount = 0;
+        size_t mDropCount = 0;
+
+    public:
+        /**
+         @param defaultImageSize size of images with no size of their own
+         @param loadLatency time every load takes
+         */
+        SimulatedTextureStreamingBackend(const Size2D &defaultImageSize, std::chrono::microseconds loadLatency = std::chrono::microseconds(0));
+
+        void setImageSize(const std::string &path, const Size2D &size);
+
+        /**
+         Makes loads of the image throw, describing it still succeeds
+         */
+        void setLoadFailure(const std::string &path);
+
+        /**
+         @return finest mip level held by the texture, std::nullopt if nothing was uploaded to it
+         */
+        std::optional<uint32_t> residentMipLevel(const TextureKey &key) const;
+
+        size_t uploadCount() const;
+
+        size_t dropCount() const;
+
+        TextureDescription describe(const TextureKey &key, const std::string &path) override;
+
+        StagedMip load(const TextureKey &key, const std::string &path, uint32_t mipLevel) override;
+
+        void upload(const TextureKey &key, StagedMip &&mip) override;
+
+        void drop(const TextureKey &key, uint32_t residentMipLevel, uint32_t mipLevel) override;
+    };
+
+}
+
+#endif //EARENDERER_SIMULATEDTEXTURESTREAMINGBACKEND_HPP
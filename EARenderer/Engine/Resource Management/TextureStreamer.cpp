@@ -0,0 +1,496 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "TextureStreamer.hpp"
+#include "Scene.hpp"
+#include "SharedResourceStorage.hpp"
+#include "LODSelector.hpp"
+#include "Profiler.hpp"
+#include "StringUtils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <stdexcept>
+
+namespace EARenderer {
+
+#pragma mark - Lifecycle
+
+    TextureStreamer::TextureStreamer(std::unique_ptr<TextureStreamingBackend> backend)
+            :
+            TextureStreamer(std::move(backend), Settings()) {
+    }
+
+    TextureStreamer::TextureStreamer(std::unique_ptr<TextureStreamingBackend> backend, const Settings &settings)
+            :
+            TextureStreamer(std::move(backend), settings, &ThreadPool::Default()) {
+    }
+
+    TextureStreamer::TextureStreamer(std::unique_ptr<TextureStreamingBackend> backend, const Settings &settings, ThreadPool *threadPool)
+            :
+            mBackend(std::move(backend)),
+            mSettings(settings),
+            mThreadPool(threadPool) {
+        if (!mBackend) {
+            throw std::invalid_argument("Texture streamer requires a backend");
+        }
+    }
+
+    TextureStreamer::~TextureStreamer() {
+        // Futures block until their tasks are done
+        mLoadTasks.clear();
+    }
+
+#pragma mark - Private helpers
+
+    size_t TextureStreamer::chainSize(const StreamedTexture &texture, uint32_t mipLevel) const {
+        size_t width = size_t(texture.description.size.width);
+        size_t height = size_t(texture.description.size.height);
+        size_t size = 0;
+
+        // The placeholder isn't counted
+        for (uint32_t mip = mipLevel; mip < texture.mipCount; mip++) {
+            size += std::max<size_t>(1, width >> mip) * std::max<size_t>(1, height >> mip) * texture.description.bytesPerTexel;
+        }
+
+        return size;
+    }
+
+    uint32_t TextureStreamer::keptMipLevel(const StreamedTexture &texture) const {
+        // Textures used in the current update keep what they show, others fall back to their minimum
+        return texture.lastUseUpdate == mUpdateIndex ? texture.requiredMipLevel : texture.minimumMipLevel;
+    }
+
+    size_t TextureStreamer::evictableBytes(size_t protectedTextureIndex) const {
+        size_t bytes = 0;
+        for (size_t i = 0; i < mTextures.size(); i++) {
+            const StreamedTexture &texture = mTextures[i];
+            uint32_t keptMip = keptMipLevel(texture);
+            if (i != protectedTextureIndex && texture.residentMipLevel < keptMip) {
+                bytes += chainSize(texture, texture.residentMipLevel) - chainSize(texture, keptMip);
+            }
+        }
+        return bytes;
+    }
+
+    size_t TextureStreamer::evict(size_t bytes, size_t protectedTextureIndex) {
+        std::vector<size_t> candidates;
+        for (size_t i = 0; i < mTextures.size(); i++) {
+            if (i != protectedTextureIndex && mTextures[i].residentMipLevel < keptMipLevel(mTextures[i])) {
+                candidates.push_back(i);
+            }
+        }
+
+        // Least recently used first, ties are broken by index to keep eviction deterministic
+        std::sort(candidates.begin(), candidates.end(), [&](size_t lhs, size_t rhs) {
+            if (mTextures[lhs].lastUseUpdate != mTextures[rhs].lastUseUpdate) {
+                return mTextures[lhs].lastUseUpdate < mTextures[rhs].lastUseUpdate;
+            }
+            return lhs < rhs;
+        });
+
+        size_t freedBytes = 0;
+        for (size_t i : candidates) {
+            if (freedBytes >= bytes) {
+                break;
+            }
+
+            StreamedTexture &texture = mTextures[i];
+            uint32_t keptMip = keptMipLevel(texture);
+            size_t textureBytes = chainSize(texture, texture.residentMipLevel) - chainSize(texture, keptMip);
+
+            mBackend->drop(texture.key, texture.residentMipLevel, keptMip);
+            texture.residentMipLevel = keptMip;
+            mResidentBytes -= textureBytes;
+            freedBytes += textureBytes;
+            mStatistics.evictions++;
+        }
+
+        return freedBytes;
+    }
+
+    float TextureStreamer::uvDensity(ID meshID, ID subMeshID, const SubMesh &subMesh) {
+        auto &meshDensities = mUVDensities[meshID];
+        auto densityIt = meshDensities.find(subMeshID);
+        if (densityIt != meshDensities.end()) {
+            return densityIt->second;
+        }
+
+        auto &vertices = subMesh.vertices();
+        double uvArea = 0.0;
+
+        for (size_t i = 0; i + 2 < vertices.size(); i += 3) {
+            glm::vec2 uv0 = vertices[i].textureCoords;
+            glm::vec2 edge1 = glm::vec2(vertices[i + 1].textureCoords) - uv0;
+            glm::vec2 edge2 = glm::vec2(vertices[i + 2].textureCoords) - uv0;
+            uvArea += 0.5 * std::abs(edge1.x * edge2.y - edge1.y * edge2.x);
+        }
+
+        // Ratio of areas squared is the average ratio of lengths
+        float density = subMesh.surfaceArea() > 0.0 ? float(std::sqrt(uvArea / subMesh.surfaceArea())) : 0.0f;
+        meshDensities[subMeshID] = density;
+        return density;
+    }
+
+    void TextureStreamer::issueLoad(size_t textureIndex, uint32_t mipLevel) {
+        StreamedTexture &texture = mTextures[textureIndex];
+        texture.loadingMipLevel = mipLevel;
+        mStatistics.issuedLoads++;
+
+        // Workers get copies, the texture vector may grow while they run
+        auto key = texture.key;
+        auto path = texture.path;
+
+        mLoadTasks.emplace(textureIndex, mThreadPool->submit([this, textureIndex, key, path, mipLevel] {
+            CompletedLoad load;
+            load.textureIndex = textureIndex;
+
+            try {
+                load.mip = mBackend->load(key, path, mipLevel);
+                if (load.mip.mipLevel != mipLevel) {
+                    throw std::runtime_error(string_format("Loaded mip level %u of %s instead of %u", load.mip.mipLevel, path.c_str(), mipLevel));
+                }
+            } catch (...) {
+                load.exception = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(mCompletedLoadsMutex);
+            mCompletedLoads.emplace_back(std::move(load));
+        }));
+    }
+
+#pragma mark - Streaming stages
+
+    void TextureStreamer::processCompletedLoads(bool limitsUploads) {
+        std::vector<CompletedLoad> completedLoads;
+        {
+            std::lock_guard<std::mutex> lock(mCompletedLoadsMutex);
+            completedLoads.swap(mCompletedLoads);
+        }
+
+        // Loads complete in whatever order workers finish them. Minimum mip levels go first since they never wait.
+        std::sort(completedLoads.begin(), completedLoads.end(), [&](const CompletedLoad &lhs, const CompletedLoad &rhs) {
+            bool isLhsMinimum = mTextures[lhs.textureIndex].residentMipLevel > mTextures[lhs.textureIndex].minimumMipLevel;
+            bool isRhsMinimum = mTextures[rhs.textureIndex].residentMipLevel > mTextures[rhs.textureIndex].minimumMipLevel;
+            if (isLhsMinimum != isRhsMinimum) {
+                return isLhsMinimum;
+            }
+            return lhs.textureIndex < rhs.textureIndex;
+        });
+
+        size_t uploadedBytes = 0;
+        std::vector<CompletedLoad> deferredLoads;
+
+        for (auto &load : completedLoads) {
+            StreamedTexture &texture = mTextures[load.textureIndex];
+            bool isMandatory = texture.residentMipLevel > texture.minimumMipLevel;
+            size_t stagedBytes = load.mip.pixels.size();
+
+            if (limitsUploads && !isMandatory && uploadedBytes > 0 && uploadedBytes + stagedBytes > mSettings.maximumUploadBytesPerUpdate) {
+                deferredLoads.emplace_back(std::move(load));
+                continue;
+            }
+
+            mLoadTasks.erase(load.textureIndex);
+            mReservedBytes -= texture.reservedBytes;
+            texture.reservedBytes = 0;
+            texture.loadingMipLevel = texture.mipCount;
+
+            if (load.exception) {
+                texture.hasFailed = true;
+                mStatistics.failedLoads++;
+                continue;
+            }
+
+            // Finer levels may have arrived in the meantime
+            if (load.mip.mipLevel >= texture.residentMipLevel) {
+                mStatistics.discardedLoads++;
+                continue;
+            }
+
+            size_t addedBytes = chainSize(texture, load.mip.mipLevel) - chainSize(texture, texture.residentMipLevel);
+
+            if (mResidentBytes + addedBytes > mSettings.memoryBudget) {
+                size_t excess = mResidentBytes + addedBytes - mSettings.memoryBudget;
+                // Evicting for a load that gets discarded anyway would only lose resident mip levels
+                if (evictableBytes(load.textureIndex) < excess && !isMandatory) {
+                    mStatistics.discardedLoads++;
+                    continue;
+                }
+                evict(excess, load.textureIndex);
+            }
+
+            texture.residentMipLevel = load.mip.mipLevel;
+            mBackend->upload(texture.key, std::move(load.mip));
+            mResidentBytes += addedBytes;
+            uploadedBytes += stagedBytes;
+            mStatistics.uploads++;
+            mStatistics.uploadedBytes += stagedBytes;
+        }
+
+        if (!deferredLoads.empty()) {
+            std::lock_guard<std::mutex> lock(mCompletedLoadsMutex);
+            std::move(deferredLoads.begin(), deferredLoads.end(), std::back_inserter(mCompletedLoads));
+        }
+    }
+
+    void TextureStreamer::updateRequiredMipLevels(const Scene &scene, const SharedResourceStorage &resourceStorage, const Size2D &viewportSize) {
+        // Screen pixels covered by a texture coordinate unit, largest among sub meshes showing the material
+        std::unordered_map<ID, float> pixelsPerUVUnit;
+
+        // Only the projection of distances is used, the error limit doesn't matter
+        LODSelector projector(scene.camera()->viewProjectionMatrix(), viewportSize, 1.0);
+
+        for (ID instanceID : scene.meshInstances()) {
+            auto &instance = scene.meshInstances()[instanceID];
+            auto &subMeshes = resourceStorage.mesh(instance.meshID()).subMeshes();
+            glm::mat4 modelMatrix = instance.transformation().modelMatrix();
+
+            for (ID subMeshID : subMeshes) {
+                auto materialRef = instance.materialReference;
+
+                if (!materialRef) {
+                    materialRef = instance.materialReferenceForSubMeshID(subMeshID);
+                }
+
+                if (!materialRef || materialRef->first != MaterialType::CookTorrance || mMaterials.find(materialRef->second) == mMaterials.end()) {
+                    continue;
+                }
+
+                auto &subMesh = subMeshes[subMeshID];
+
+                if (!projector.isPotentiallyVisible(subMesh, modelMatrix)) {
+                    continue;
+                }
+
+                float density = uvDensity(instance.meshID(), subMeshID, subMesh);
+                float pixelsPerMeshUnit = projector.pixelsPerMeshUnit(subMesh, modelMatrix);
+                // Degenerate texture coordinates sample a single texel, which any mip level has
+                float pixels = density > 0.0 ? pixelsPerMeshUnit / density : 0.0f;
+
+                auto pixelsIt = pixelsPerUVUnit.find(materialRef->second);
+                if (pixelsIt == pixelsPerUVUnit.end()) {
+                    pixelsPerUVUnit[materialRef->second] = pixels;
+                } else {
+                    pixelsIt->second = std::max(pixelsIt->second, pixels);
+                }
+            }
+        }
+
+        for (auto &texture : mTextures) {
+            texture.requiredMipLevel = texture.minimumMipLevel;
+            texture.isVisible = false;
+        }
+
+        for (auto &materialPixels : pixelsPerUVUnit) {
+            float pixels = materialPixels.second;
+
+            for (size_t textureIndex : mMaterials[materialPixels.first].textureIndices) {
+                if (textureIndex == NoTexture) {
+                    continue;
+                }
+
+                StreamedTexture &texture = mTextures[textureIndex];
+                texture.isVisible = true;
+                texture.lastUseUpdate = mUpdateIndex;
+
+                if (pixels <= 0.0) {
+                    continue;
+                }
+
+                // A mip level holds half as many texels per texture coordinate unit as the previous one
+                float texels = std::max(texture.description.size.width, texture.description.size.height);
+                float mip = std::isinf(pixels) ? 0.0f : std::floor(std::log2(texels / pixels) + mSettings.mipBias);
+                texture.requiredMipLevel = uint32_t(std::clamp(mip, 0.0f, float(texture.minimumMipLevel)));
+            }
+        }
+    }
+
+    void TextureStreamer::issueLoads() {
+        std::vector<size_t> candidates;
+        for (size_t i = 0; i < mTextures.size(); i++) {
+            const StreamedTexture &texture = mTextures[i];
+            bool isIdle = texture.loadingMipLevel == texture.mipCount && !texture.hasFailed;
+            // Textures still waiting for their minimum mip level have a load in flight
+            if (isIdle && texture.requiredMipLevel < texture.residentMipLevel) {
+                candidates.push_back(i);
+            }
+        }
+
+        // Visible textures first, then the ones furthest from what they should show
+        std::sort(candidates.begin(), candidates.end(), [&](size_t lhs, size_t rhs) {
+            const StreamedTexture &l = mTextures[lhs];
+            const StreamedTexture &r = mTextures[rhs];
+            if (l.isVisible != r.isVisible) {
+                return l.isVisible;
+            }
+            uint32_t lhsGap = l.residentMipLevel - l.requiredMipLevel;
+            uint32_t rhsGap = r.residentMipLevel - r.requiredMipLevel;
+            if (lhsGap != rhsGap) {
+                return lhsGap > rhsGap;
+            }
+            return lhs < rhs;
+        });
+
+        size_t committedBytes = mResidentBytes + mReservedBytes;
+        size_t budget = mSettings.memoryBudget + evictableBytes(NoTexture);
+        size_t availableBytes = budget > committedBytes ? budget - committedBytes : 0;
+
+        for (size_t i : candidates) {
+            if (mLoadTasks.size() >= mSettings.maximumConcurrentLoads) {
+                break;
+            }
+
+            StreamedTexture &texture = mTextures[i];
+            size_t residentBytes = chainSize(texture, texture.residentMipLevel);
+
+            // Settle for a coarser level than required if that's all the budget fits
+            for (uint32_t mip = texture.requiredMipLevel; mip < texture.residentMipLevel; mip++) {
+                size_t addedBytes = chainSize(texture, mip) - residentBytes;
+                if (addedBytes <= availableBytes) {
+                    availableBytes -= addedBytes;
+                    texture.reservedBytes = addedBytes;
+                    mReservedBytes += addedBytes;
+                    issueLoad(i, mip);
+                    break;
+                }
+            }
+        }
+    }
+
+#pragma mark - Public interface
+
+    void TextureStreamer::addMaterial(ID materialID, const CookTorranceMaterial &material) {
+        if (mMaterials.find(materialID) != mMaterials.end()) {
+            throw std::invalid_argument(string_format("Material %llu is already streamed", (unsigned long long) materialID));
+        }
+        if (material.textureLoading() != CookTorranceMaterial::TextureLoading::Streamed) {
+            throw std::invalid_argument(string_format("Material %llu loads its images immediately", (unsigned long long) materialID));
+        }
+
+        StreamedMaterial streamedMaterial;
+        streamedMaterial.textureIndices.fill(NoTexture);
+
+        for (size_t i = 0; i < CookTorranceMaterial::MapTypeCount; i++) {
+            auto mapType = CookTorranceMaterial::MapType(i);
+            const std::string &path = material.mapPath(mapType);
+
+            if (path.empty()) {
+                continue;
+            }
+
+            StreamedTexture texture;
+            texture.key = {materialID, mapType};
+            texture.path = path;
+            texture.description = mBackend->describe(texture.key, path);
+
+            uint32_t largerSide = uint32_t(std::max(texture.description.size.width, texture.description.size.height));
+            if (largerSide == 0) {
+                throw std::invalid_argument(string_format("Image %s is empty", path.c_str()));
+            }
+
+            texture.mipCount = uint32_t(std::floor(std::log2(largerSide))) + 1;
+            while (texture.minimumMipLevel + 1 < texture.mipCount && (largerSide >> texture.minimumMipLevel) > mSettings.minimumResidentSize) {
+                texture.minimumMipLevel++;
+            }
+
+            texture.residentMipLevel = texture.mipCount;
+            texture.requiredMipLevel = texture.minimumMipLevel;
+            texture.lastUseUpdate = mUpdateIndex;
+
+            streamedMaterial.textureIndices[i] = mTextures.size();
+            mTextures.emplace_back(std::move(texture));
+
+            // Minimum mip levels are never held back by the budget or the concurrency limit
+            issueLoad(mTextures.size() - 1, mTextures.back().minimumMipLevel);
+        }
+
+        mMaterials[materialID] = streamedMaterial;
+    }
+
+    void TextureStreamer::update(const Scene &scene, const SharedResourceStorage &resourceStorage, const Size2D &viewportSize) {
+        EA_PROFILE_SCOPE("Texture streaming");
+
+        mUpdateIndex++;
+        updateRequiredMipLevels(scene, resourceStorage, viewportSize);
+        processCompletedLoads(true);
+        issueLoads();
+    }
+
+    void TextureStreamer::finishPendingLoads() {
+        EA_PROFILE_SCOPE("Finish texture streaming loads");
+
+        {
+            // Futures block until their tasks are done, but the tasks stay registered until they're processed
+            auto loadTasks = std::move(mLoadTasks);
+            mLoadTasks.clear();
+        }
+
+        processCompletedLoads(false);
+    }
+
+#pragma mark - Getters
+
+    const TextureStreamer::StreamedTexture &TextureStreamer::texture(ID materialID, CookTorranceMaterial::MapType mapType) const {
+        auto materialIt = mMaterials.find(materialID);
+        if (materialIt == mMaterials.end() || materialIt->second.textureIndices[size_t(mapType)] == NoTexture) {
+            throw std::invalid_argument(string_format("Map %d of material %llu isn't streamed", int(mapType), (unsigned long long) materialID));
+        }
+        return mTextures[materialIt->second.textureIndices[size_t(mapType)]];
+    }
+
+    size_t TextureStreamer::residentBytes() const {
+        return mResidentBytes;
+    }
+
+    size_t TextureStreamer::pendingLoadCount() const {
+        size_t count = 0;
+        for (auto &texture : mTextures) {
+            count += texture.loadingMipLevel != texture.mipCount;
+        }
+        return count;
+    }
+
+    const TextureStreamer::Statistics &TextureStreamer::statistics() const {
+        return mStatistics;
+    }
+
+    const TextureStreamer::Settings &TextureStreamer::settings() const {
+        return mSettings;
+    }
+
+    uint32_t TextureStreamer::mipLevelCount(ID materialID, CookTorranceMaterial::MapType mapType) const {
+        return texture(materialID, mapType).mipCount;
+    }
+
+    uint32_t TextureStreamer::minimumMipLevel(ID materialID, CookTorranceMaterial::MapType mapType) const {
+        return texture(materialID, mapType).minimumMipLevel;
+    }
+
+    uint32_t TextureStreamer::residentMipLevel(ID materialID, CookTorranceMaterial::MapType mapType) const {
+        return texture(materialID, mapType).residentMipLevel;
+    }
+
+    uint32_t TextureStreamer::requiredMipLevel(ID materialID, CookTorranceMaterial::MapType mapType) const {
+        return texture(materialID, mapType).requiredMipLevel;
+    }
+
+    bool TextureStreamer::isVisible(ID materialID) const {
+        auto materialIt = mMaterials.find(materialID);
+        if (materialIt == mMaterials.end()) {
+            return false;
+        }
+
+        for (size_t textureIndex : materialIt->second.textureIndices) {
+            if (textureIndex != NoTexture) {
+                return mTextures[textureIndex].isVisible;
+            }
+        }
+
+        return false;
+    }
+
+}
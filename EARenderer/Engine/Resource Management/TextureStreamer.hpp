@@ -0,0 +1,203 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_TEXTURESTREAMER_HPP
+#define EARENDERER_TEXTURESTREAMER_HPP
+
+#include "TextureStreamingBackend.hpp"
+#include "ThreadPool.hpp"
+#include "Size2D.hpp"
+
+#include <array>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace EARenderer {
+
+    class Scene;
+
+    class SharedResourceStorage;
+
+    class SubMesh;
+
+    /**
+     Keeps mip levels of streamed material maps resident according to their on-screen size, within a GPU memory budget.
+
+     Every map gets its minimum mip level loaded as soon as the material is added. Each update projects bounding boxes
+     of mesh instances onto the camera to find the finest mip level a material's maps can show, loads missing levels
+     on the thread pool and uploads them on the calling thread. When the budget runs out, mip levels of textures
+     that weren't used for the longest time are dropped first, but never below their minimum mip level.
+
+     Minimum mip levels are always uploaded, so the budget can only be exceeded if it doesn't fit them all.
+     */
+    class TextureStreamer {
+    public:
+        struct Settings {
+            // GPU memory available to streamed maps (bytes)
+            size_t memoryBudget = 512 * 1024 * 1024;
+            // Larger side of the minimum mip level, which is loaded first and never dropped
+            uint32_t minimumResidentSize = 64;
+            // Added to required mip levels, positive values trade sharpness for memory
+            float mipBias = 0.0;
+            // Loads of finer mip levels in flight at once
+            size_t maximumConcurrentLoads = 8;
+            // Uploads of a single update stop after this amount of bytes, at least one load is uploaded regardless
+            size_t maximumUploadBytesPerUpdate = 32 * 1024 * 1024;
+        };
+
+        struct Statistics {
+            uint64_t issuedLoads = 0;
+            uint64_t uploads = 0;
+            uint64_t uploadedBytes = 0;
+            uint64_t evictions = 0;
+            // Loads that no longer fit into the budget when they completed
+            uint64_t discardedLoads = 0;
+            uint64_t failedLoads = 0;
+        };
+
+    private:
+        struct StreamedTexture {
+            TextureStreamingBackend::TextureKey key;
+            std::string path;
+            TextureStreamingBackend::TextureDescription description;
+            uint32_t mipCount = 1;
+            uint32_t minimumMipLevel = 0;
+            // Equals mipCount while only the placeholder is resident
+            uint32_t residentMipLevel = 0;
+            uint32_t requiredMipLevel = 0;
+            // Equals mipCount if no load is in flight
+            uint32_t loadingMipLevel = 0;
+            // Bytes the load in flight is going to add to the resident ones
+            size_t reservedBytes = 0;
+            uint64_t lastUseUpdate = 0;
+            bool isVisible = false;
+            bool hasFailed = false;
+        };
+
+        struct StreamedMaterial {
+            // Indices of streamed textures by map type
+            std::array<size_t, CookTorranceMaterial::MapTypeCount> textureIndices;
+        };
+
+        struct CompletedLoad {
+            size_t textureIndex = 0;
+            TextureStreamingBackend::StagedMip mip;
+            std::exception_ptr exception;
+        };
+
+        static constexpr size_t NoTexture = std::numeric_limits<size_t>::max();
+
+        std::unique_ptr<TextureStreamingBackend> mBackend;
+        Settings mSettings;
+        ThreadPool *mThreadPool;
+        std::vector<StreamedTexture> mTextures;
+        std::unordered_map<ID, StreamedMaterial> mMaterials;
+        // Texture coordinate units per mesh space unit, by mesh and sub mesh
+        std::unordered_map<ID, std::unordered_map<ID, float>> mUVDensities;
+        size_t mResidentBytes = 0;
+        size_t mReservedBytes = 0;
+        uint64_t mUpdateIndex = 0;
+        Statistics mStatistics;
+
+        std::mutex mCompletedLoadsMutex;
+        std::vector<CompletedLoad> mCompletedLoads;
+        std::unordered_map<size_t, ThreadPool::TaskFuture<void>> mLoadTasks;
+
+        size_t chainSize(const StreamedTexture &texture, uint32_t mipLevel) const;
+
+        uint32_t keptMipLevel(const StreamedTexture &texture) const;
+
+        size_t evictableBytes(size_t protectedTextureIndex) const;
+
+        size_t evict(size_t bytes, size_t protectedTextureIndex);
+
+        float uvDensity(ID meshID, ID subMeshID, const SubMesh &subMesh);
+
+        void issueLoad(size_t textureIndex, uint32_t mipLevel);
+
+        void processCompletedLoads(bool limitsUploads);
+
+        void updateRequiredMipLevels(const Scene &scene, const SharedResourceStorage &resourceStorage, const Size2D &viewportSize);
+
+        void issueLoads();
+
+        const StreamedTexture &texture(ID materialID, CookTorranceMaterial::MapType mapType) const;
+
+    public:
+        TextureStreamer(std::unique_ptr<TextureStreamingBackend> backend);
+
+        TextureStreamer(std::unique_ptr<TextureStreamingBackend> backend, const Settings &settings);
+
+        TextureStreamer(std::unique_ptr<TextureStreamingBackend> backend, const Settings &settings, ThreadPool *threadPool);
+
+        TextureStreamer(const TextureStreamer &that) = delete;
+
+        TextureStreamer &operator=(const TextureStreamer &rhs) = delete;
+
+        /**
+         Waits for loads in flight, which refer to the streamer
+         */
+        ~TextureStreamer();
+
+        /**
+         Starts streaming maps of the material that have images. The material has to be
+         created with TextureLoading::Streamed and to outlive the streamer.
+
+         @param materialID identifier of the material in the resource storage
+         @param material material to stream maps of
+         */
+        void addMaterial(ID materialID, const CookTorranceMaterial &material);
+
+        /**
+         Uploads completed loads, recomputes required mip levels from the scene camera and issues new loads.
+         Meant to be called once a frame on the thread owning the backend.
+
+         @param scene scene whose mesh instances are visible
+         @param resourceStorage storage of meshes and materials the instances refer to
+         @param viewportSize size of the render target in pixels
+         */
+        void update(const Scene &scene, const SharedResourceStorage &resourceStorage, const Size2D &viewportSize);
+
+        /**
+         Blocks until every load in flight is uploaded or discarded, ignoring the upload limit
+         */
+        void finishPendingLoads();
+
+        size_t residentBytes() const;
+
+        size_t pendingLoadCount() const;
+
+        const Statistics &statistics() const;
+
+        const Settings &settings() const;
+
+        uint32_t mipLevelCount(ID materialID, CookTorranceMaterial::MapType mapType) const;
+
+        uint32_t minimumMipLevel(ID materialID, CookTorranceMaterial::MapType mapType) const;
+
+        /**
+         @return finest resident mip level of the map, mip level count if only the placeholder is resident
+         */
+        uint32_t residentMipLevel(ID materialID, CookTorranceMaterial::MapType mapType) const;
+
+        /**
+         @return finest mip level the map can show on screen as of the last update
+         */
+        uint32_t requiredMipLevel(ID materialID, CookTorranceMaterial::MapType mapType) const;
+
+        /**
+         @return true if the material was visible in the last update
+         */
+        bool isVisible(ID materialID) const;
+    };
+
+}
+
+#endif //EARENDERER_TEXTURESTREAMER_HPP
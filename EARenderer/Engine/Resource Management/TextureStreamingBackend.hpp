@@ -0,0 +1,83 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_TEXTURESTREAMINGBACKEND_HPP
+#define EARENDERER_TEXTURESTREAMINGBACKEND_HPP
+
+#include "CookTorranceMaterial.hpp"
+#include "PackedLookupTable.hpp"
+#include "Size2D.hpp"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace EARenderer {
+
+    /**
+     Loads images of streamed material maps and transfers their mip levels to and from the GPU.
+     Mip level 0 is the full resolution image. A texture holding mip level m also holds every coarser level.
+     */
+    class TextureStreamingBackend {
+    public:
+        struct TextureKey {
+            ID materialID;
+            CookTorranceMaterial::MapType mapType;
+        };
+
+        struct TextureDescription {
+            // Size of the full resolution image
+            Size2D size;
+            // Size of a texel in GPU memory, possibly an estimate for compressed formats
+            size_t bytesPerTexel = 4;
+        };
+
+        // Finest mip level of a load in CPU memory, coarser levels are derived from it on upload
+        struct StagedMip {
+            uint32_t mipLevel = 0;
+            Size2D size;
+            // Tightly packed RGBA8 texels
+            std::vector<uint8_t> pixels;
+        };
+
+        virtual ~TextureStreamingBackend() = default;
+
+        /**
+         Reads dimensions of the image without loading it
+
+         @param key texture the image belongs to
+         @param path path of the image
+         @return description of the full resolution texture
+         */
+        virtual TextureDescription describe(const TextureKey &key, const std::string &path) = 0;
+
+        /**
+         Loads the image and reduces it to the mip level. Called from worker threads, concurrently for different textures.
+
+         @param key texture the image belongs to
+         @param path path of the image
+         @param mipLevel finest mip level to load
+         @return texels of the mip level
+         */
+        virtual StagedMip load(const TextureKey &key, const std::string &path, uint32_t mipLevel) = 0;
+
+        /**
+         Replaces resident mip levels of the texture with the staged mip level and the coarser ones derived from it
+         */
+        virtual void upload(const TextureKey &key, StagedMip &&mip) = 0;
+
+        /**
+         Releases mip levels finer than the given one
+
+         @param key texture to shrink
+         @param residentMipLevel finest mip level the texture currently holds
+         @param mipLevel finest mip level to keep
+         */
+        virtual void drop(const TextureKey &key, uint32_t residentMipLevel, uint32_t mipLevel) = 0;
+    };
+
+}
+
+#endif //EARENDERER_TEXTURESTREAMINGBACKEND_HPP
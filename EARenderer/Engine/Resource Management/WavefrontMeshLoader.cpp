@@ -7,6 +7,8 @@
 //
 
 #include "WavefrontMeshLoader.hpp"
+#include "MeshProcessor.hpp"
+#include "Profiler.hpp"
 
 #include <fstream>
 
@@ -16,15 +18,6 @@ namespace EARenderer {
 
     void WavefrontMeshLoader::vertexCallback(void *userData, float x, float y, float z, float w) {
         WavefrontMeshLoader *thisPtr = reinterpret_cast<WavefrontMeshLoader *>(userData);
-
-        thisPtr->mBoundingBox->min.x = std::min(thisPtr->mBoundingBox->min.x, x);
-        thisPtr->mBoundingBox->min.y = std::min(thisPtr->mBoundingBox->min.y, y);
-        thisPtr->mBoundingBox->min.z = std::min(thisPtr->mBoundingBox->min.z, z);
-
-        thisPtr->mBoundingBox->max.x = std::max(thisPtr->mBoundingBox->max.x, x);
-        thisPtr->mBoundingBox->max.y = std::max(thisPtr->mBoundingBox->max.y, y);
-        thisPtr->mBoundingBox->max.z = std::max(thisPtr->mBoundingBox->max.z, z);
-
         thisPtr->mVertices.emplace_back(x, y, z, w);
     }
 
@@ -61,10 +54,6 @@ namespace EARenderer {
 
         if (thisPtr->wasEmptyGroupOrObjectDetected()) {return;};
 
-        if (!thisPtr->mSubMeshes->empty()) {
-            thisPtr->finalizeSubMesh(thisPtr->mSubMeshes->back());
-        }
-
         thisPtr->mSubMeshes->emplace_back();
         SubMesh *lastSubMesh = &thisPtr->mSubMeshes->back();
         if (numNames) {
@@ -77,10 +66,6 @@ namespace EARenderer {
 
         if (thisPtr->wasEmptyGroupOrObjectDetected()) {return;};
 
-        if (!thisPtr->mSubMeshes->empty()) {
-            thisPtr->finalizeSubMesh(thisPtr->mSubMeshes->back());
-        }
-
         thisPtr->mSubMeshes->emplace_back();
         SubMesh *lastSubMesh = &thisPtr->mSubMeshes->back();
         if (name) {
@@ -100,86 +85,21 @@ namespace EARenderer {
 #pragma mark - Private instance functions
 
     void WavefrontMeshLoader::processTriangle(const std::array<tinyobj::index_t, 3> &indices) {
-        std::array<int32_t, 3> positionIndices;
-        std::array<int32_t, 3> texCoordIndices;
-        bool shouldBuildTangent = false;
-        bool shouldCalculateNormal = false;
-
-        const int32_t faceVertexCount = 3;
-
         SubMesh &lastSubMesh = mSubMeshes->back();
 
-        for (int32_t i = 0; i < faceVertexCount; i++) {
-            int32_t fixedVIdx = fixIndex(indices[i].vertex_index, static_cast<int32_t>(mVertices.size()));
-            int32_t fixedNIdx = fixIndex(indices[i].normal_index, static_cast<int32_t>(mNormals.size()));
-            int32_t fixedTIdx = fixIndex(indices[i].texcoord_index, static_cast<int32_t>(mTexCoords.size()));
+        // Missing normals and tangents are left zeroed and get generated by MeshProcessor
+        for (auto &index : indices) {
+            int32_t fixedVIdx = fixIndex(index.vertex_index, static_cast<int32_t>(mVertices.size()));
+            int32_t fixedNIdx = fixIndex(index.normal_index, static_cast<int32_t>(mNormals.size()));
+            int32_t fixedTIdx = fixIndex(index.texcoord_index, static_cast<int32_t>(mTexCoords.size()));
 
-            bool isTexCoordPresent = indices[i].texcoord_index != 0;
-            bool isNormalPresent = indices[i].normal_index != 0;
+            bool isTexCoordPresent = index.texcoord_index != 0;
+            bool isNormalPresent = index.normal_index != 0;
 
             lastSubMesh.addVertex(Vertex1P1N2UV1T1BT(mVertices[fixedVIdx],
                     isTexCoordPresent ? mTexCoords[fixedTIdx] : glm::vec3(),
                     isTexCoordPresent ? mTexCoords[fixedTIdx] : glm::vec2(),
                     isNormalPresent ? mNormals[fixedNIdx] : glm::vec3()));
-
-            shouldCalculateNormal = !isNormalPresent;
-            shouldBuildTangent = isTexCoordPresent;
-
-            positionIndices[i] = fixedVIdx;
-            texCoordIndices[i] = fixedTIdx;
-        }
-
-        if (shouldCalculateNormal) {
-            calculateNormal(positionIndices);
-        }
-
-        if (shouldBuildTangent) {
-            buildTangentSpace(positionIndices, texCoordIndices);
-        }
-    }
-
-    void WavefrontMeshLoader::buildTangentSpace(const std::array<int32_t, 3> &positionIndices, const std::array<int32_t, 3> &texCoordIndices) {
-        glm::vec3 edge1 = mVertices[positionIndices[1]] - mVertices[positionIndices[0]];
-        glm::vec3 edge2 = mVertices[positionIndices[2]] - mVertices[positionIndices[0]];
-        glm::vec2 deltaUV1 = mTexCoords[texCoordIndices[1]] - mTexCoords[texCoordIndices[0]];
-        glm::vec2 deltaUV2 = mTexCoords[texCoordIndices[2]] - mTexCoords[texCoordIndices[0]];
-
-        float f = 1.f / (deltaUV1.x * deltaUV2.y - deltaUV2.x * deltaUV1.y);
-
-        glm::vec3 tangent;
-        tangent.x = f * (deltaUV2.y * edge1.x - deltaUV1.y * edge2.x);
-        tangent.y = f * (deltaUV2.y * edge1.y - deltaUV1.y * edge2.y);
-        tangent.z = f * (deltaUV2.y * edge1.z - deltaUV1.y * edge2.z);
-
-        glm::vec3 bitangent;
-        bitangent.x = f * (-deltaUV2.x * edge1.x + deltaUV1.x * edge2.x);
-        bitangent.y = f * (-deltaUV2.x * edge1.y + deltaUV1.x * edge2.y);
-        bitangent.z = f * (-deltaUV2.x * edge1.z + deltaUV1.x * edge2.z);
-
-        // Update tangent vectors for latest vertices
-        auto size = mSubMeshes->back().vertices().size();
-        for (int32_t i = 1; i <= 3; i++) {
-            auto &vertex = mSubMeshes->back().vertices()[size - i];
-            vertex.tangent = tangent;
-            vertex.bitangent = bitangent;
-        }
-    }
-
-    void WavefrontMeshLoader::calculateNormal(const std::array<int32_t, 3> &positionIndices) {
-        glm::vec3 edge1 = mVertices[positionIndices[1]] - mVertices[positionIndices[0]];
-        glm::vec3 edge2 = mVertices[positionIndices[2]] - mVertices[positionIndices[0]];
-        glm::vec3 surfaceNormal = glm::cross(edge1, edge2);
-
-        const int32_t faceVertexCount = 3;
-
-        SubMesh &lastSubMesh = mSubMeshes->back();
-
-        for (int32_t i = 0; i < faceVertexCount; i++) {
-            auto &normalData = mManualNormals[positionIndices[i]];
-            normalData.first += surfaceNormal;
-            // Indicate that [submeshVertexIndex] vertex should receive averaged normal afterwards (normalData.first)
-            int32_t submeshVertexIndex = static_cast<int32_t>(lastSubMesh.vertices().size()) - (faceVertexCount - i);
-            normalData.second.emplace_back(submeshVertexIndex);
         }
     }
 
@@ -195,20 +115,6 @@ namespace EARenderer {
         return mSubMeshes->at(lastSubmeshIdx).vertices().size() == 0;
     }
 
-    void WavefrontMeshLoader::finalizeSubMesh(SubMesh &subMesh) {
-        // Check if manual normal calculation took place in triangle callback
-        if (mManualNormals.size()) {
-            for (auto &keyObjectPair : mManualNormals) {
-                glm::vec3 normal = glm::normalize(keyObjectPair.second.first);
-                std::vector<int32_t> &vertexIndices = keyObjectPair.second.second;
-                for (auto submeshVertexIdx : vertexIndices) {
-                    subMesh.vertices()[submeshVertexIdx].normal = normal;
-                }
-            }
-            mManualNormals.clear();
-        }
-    }
-
 #pragma mark - Lifecycle
 
     WavefrontMeshLoader::WavefrontMeshLoader(const std::string &meshPath)
@@ -219,10 +125,11 @@ namespace EARenderer {
 #pragma mark - Public
 
     void WavefrontMeshLoader::load(std::vector<SubMesh> &subMeshes, std::string &meshName, AxisAlignedBox3D &boundingBox) {
+        EA_PROFILE_SCOPE("Load Wavefront mesh");
+
         mSubMeshes = &subMeshes;
         mBoundingBox = &boundingBox;
-        mBoundingBox->min = glm::vec3(std::numeric_limits<float>::max());
-        mBoundingBox->max = glm::vec3(-std::numeric_limits<float>::max());
+        *mBoundingBox = AxisAlignedBox3D::MaximumReversed();
 
         tinyobj::callback_t cb;
         cb.vertex_cb = vertexCallback;
@@ -244,8 +151,6 @@ namespace EARenderer {
         bool ret = tinyobj::LoadObjWithCallback(ifs, cb, this, nullptr, &err);
         meshName = mMeshName;
 
-        finalizeSubMesh(mSubMeshes->back());
-
         if (!err.empty()) {
             std::cerr << err << std::endl;
         }
@@ -254,5 +159,7 @@ namespace EARenderer {
             std::cerr << "Failed to parse .obj" << std::endl;
             return;
         }
+
+        *mBoundingBox = MeshProcessor().process(*mSubMeshes);
     }
 }
@@ -14,7 +14,6 @@
 #include <string>
 #include <vector>
 #include <array>
-#include <unordered_map>
 
 #include <glm/vec3.hpp>
 #include <glm/vec4.hpp>
@@ -27,15 +26,10 @@ namespace EARenderer {
 
     class WavefrontMeshLoader : public MeshLoader {
     private:
-        /// Objects of such type contain averaged normal for a vertex and indices of vertices
-        /// in current submesh which are sharing this normal
-        using SmoothNormalData = std::pair<glm::vec3, std::vector<int32_t>>;
-
         std::string mMeshPath;
         std::vector<glm::vec4> mVertices;
         std::vector<glm::vec3> mNormals;
         std::vector<glm::vec3> mTexCoords;
-        std::unordered_map<int32_t, SmoothNormalData> mManualNormals;
         std::vector<SubMesh> *mSubMeshes;
         AxisAlignedBox3D *mBoundingBox;
         std::string mMeshName;
@@ -56,16 +50,10 @@ namespace EARenderer {
 
         void processTriangle(const std::array<tinyobj::index_t, 3> &indices);
 
-        void buildTangentSpace(const std::array<int32_t, 3> &positionIndices, const std::array<int32_t, 3> &texCoordIndices);
-
-        void calculateNormal(const std::array<int32_t, 3> &positionIndices);
-
         int32_t fixIndex(int32_t idx, int32_t n);
 
         bool wasEmptyGroupOrObjectDetected();
 
-        void finalizeSubMesh(SubMesh &subMesh);
-
     public:
         WavefrontMeshLoader(const std::string &meshPath);
 
@@ -8,6 +8,10 @@
 
 #include "Mesh.hpp"
 #include "MeshLoader.hpp"
+#include "MeshProcessor.hpp"
+#include "MeshLODGenerator.hpp"
+
+#include <algorithm>
 
 namespace EARenderer {
 
@@ -20,7 +24,20 @@ namespace EARenderer {
         std::vector<SubMesh> subMeshes;
 
         meshLoader->load(subMeshes, mName, mBoundingBox);
+
+        // Simplification is slow enough to be worth caching between runs, unless there's no cache directory.
+        // Failing to write the cache only costs regeneration next time.
+        MeshLODGenerator lodGenerator;
+        std::string lodCachePath = MeshLODGenerator::CacheFilePath(filePath);
+        if (lodCachePath.empty() || !lodGenerator.deserialize(subMeshes, lodCachePath)) {
+            lodGenerator.generate(subMeshes);
+            if (!lodCachePath.empty()) {
+                lodGenerator.serialize(subMeshes, lodCachePath);
+            }
+        }
+
         for (auto &subMesh : subMeshes) {
+            mSurfaceArea += subMesh.surfaceArea();
             mSubMeshes.emplace(std::move(subMesh));
         }
 
@@ -28,12 +45,25 @@ namespace EARenderer {
         mBaseTransform.scale = glm::vec3(1.0 / scaleDown);
     }
 
+    Mesh::Mesh(const std::string &name, std::vector<SubMesh> &&subMeshes)
+            :
+            mName(name),
+            mBoundingBox(MeshProcessor().process(subMeshes)),
+            mSubMeshes(std::max(subMeshes.size(), size_t(1))) {
+        MeshLODGenerator().generate(subMeshes);
+        for (auto &subMesh : subMeshes) {
+            mSurfaceArea += subMesh.surfaceArea();
+            mSubMeshes.emplace(std::move(subMesh));
+        }
+    }
+
 #pragma mark - Swap
 
     void Mesh::swap(Mesh &that) {
         std::swap(mName, that.mName);
         std::swap(mSubMeshes, that.mSubMeshes);
         std::swap(mBoundingBox, that.mBoundingBox);
+        std::swap(mSurfaceArea, that.mSurfaceArea);
     }
 
     void swap(Mesh &lhs, Mesh &rhs) {
@@ -54,6 +84,10 @@ namespace EARenderer {
         return mBaseTransform;
     }
 
+    float Mesh::surfaceArea() const {
+        return mSurfaceArea;
+    }
+
     const PackedLookupTable<SubMesh> &Mesh::subMeshes() const {
         return mSubMeshes;
     }
@@ -23,11 +23,22 @@ namespace EARenderer {
         std::string mName;
         Transformation mBaseTransform;
         AxisAlignedBox3D mBoundingBox;
+        float mSurfaceArea = 0.0;
         PackedLookupTable<SubMesh> mSubMeshes;
 
     public:
         Mesh(const std::string &filePath);
 
+        /**
+         Creates a mesh from geometry built in code. Unlike meshes loaded from files,
+         such meshes are not rescaled, so their vertices are expected to be in world units.
+         Sub meshes are run through MeshProcessor, same as loaded ones.
+
+         @param name name of the mesh
+         @param subMeshes sub meshes making up the mesh
+         */
+        Mesh(const std::string &name, std::vector<SubMesh> &&subMeshes);
+
         void swap(Mesh &);
 
         const std::string &name() const;
@@ -36,6 +47,11 @@ namespace EARenderer {
 
         const Transformation &baseTransform() const;
 
+        /**
+         @return sum of sub mesh areas in mesh's own space
+         */
+        float surfaceArea() const;
+
         const PackedLookupTable<SubMesh> &subMeshes() const;
 
         PackedLookupTable<SubMesh> &subMeshes();
@@ -0,0 +1,37 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_MESHLET_HPP
+#define EARENDERER_MESHLET_HPP
+
+#include "AxisAlignedBox3D.hpp"
+
+#include <glm/vec3.hpp>
+#include <cstdint>
+
+namespace EARenderer {
+
+    /**
+     Cluster of spatially close triangles occupying a contiguous range of sub mesh vertices,
+     the unit of visibility rejection finer than a sub mesh
+     */
+    struct Meshlet {
+        uint32_t firstVertex = 0;
+        uint32_t vertexCount = 0;
+
+        AxisAlignedBox3D boundingBox;
+        glm::vec3 sphereCenter;
+        float sphereRadius = 0.0;
+
+        // Normals of all triangles lie within the cone around the axis. The whole meshlet faces away
+        // from a viewer at p if dot(center - p, axis) >= cutoff * length(center - p) + radius.
+        // Cutoff of 1 means the cone is too wide for the test to ever succeed.
+        glm::vec3 coneAxis;
+        float coneCutoff = 1.0;
+    };
+
+}
+
+#endif //EARENDERER_MESHLET_HPP
@@ -7,7 +7,8 @@
 //
 
 #include "SubMesh.hpp"
-#include "Triangle3D.hpp"
+
+#include <algorithm>
 
 namespace EARenderer {
 
@@ -21,7 +22,7 @@ namespace EARenderer {
         return mMaterialName;
     }
 
-    const std::vector<Vertex1P1N2UV1T1BT> &SubMesh::vertices() const {
+    const SubMesh::VertexVector &SubMesh::vertices() const {
         return mVertices;
     }
 
@@ -29,12 +30,44 @@ namespace EARenderer {
         return mBoundingBox;
     }
 
-    std::vector<Vertex1P1N2UV1T1BT> &SubMesh::vertices() {
+    SubMesh::VertexVector &SubMesh::vertices() {
         return mVertices;
     }
 
     float SubMesh::surfaceArea() const {
-        return mArea;
+        return mTriangleAreaPrefixSums.empty() ? 0.0 : mTriangleAreaPrefixSums.back();
+    }
+
+    const SubMesh::AreaVector &SubMesh::triangleAreaPrefixSums() const {
+        return mTriangleAreaPrefixSums;
+    }
+
+    size_t SubMesh::areaWeightedTriangleIndex(float u) const {
+        if (mTriangleAreaPrefixSums.empty()) {
+            return 0;
+        }
+        auto it = std::upper_bound(mTriangleAreaPrefixSums.begin(), mTriangleAreaPrefixSums.end(), u * surfaceArea());
+        return std::min(size_t(it - mTriangleAreaPrefixSums.begin()), mTriangleAreaPrefixSums.size() - 1);
+    }
+
+    const SubMesh::LevelOfDetailVector &SubMesh::levelsOfDetail() const {
+        return mLevelsOfDetail;
+    }
+
+    size_t SubMesh::lodCount() const {
+        return mLevelsOfDetail.size() + 1;
+    }
+
+    const SubMesh::VertexVector &SubMesh::lodVertices(size_t lod) const {
+        return lod == 0 ? mVertices : mLevelsOfDetail.at(lod - 1).vertices;
+    }
+
+    float SubMesh::lodError(size_t lod) const {
+        return lod == 0 ? 0.0 : mLevelsOfDetail.at(lod - 1).error;
+    }
+
+    const SubMesh::MeshletVector &SubMesh::meshlets() const {
+        return mMeshlets;
     }
 
 #pragma mark - Setters
@@ -47,22 +80,26 @@ namespace EARenderer {
         mMaterialName = name;
     }
 
+    void SubMesh::setBoundingBox(const AxisAlignedBox3D &boundingBox) {
+        mBoundingBox = boundingBox;
+    }
+
+    void SubMesh::setTriangleAreaPrefixSums(AreaVector &&prefixSums) {
+        mTriangleAreaPrefixSums = std::move(prefixSums);
+    }
+
+    void SubMesh::setLevelsOfDetail(LevelOfDetailVector &&levelsOfDetail) {
+        mLevelsOfDetail = std::move(levelsOfDetail);
+    }
+
+    void SubMesh::setMeshlets(MeshletVector &&meshlets) {
+        mMeshlets = std::move(meshlets);
+    }
+
 #pragma mark - Other methods
 
     void SubMesh::addVertex(const Vertex1P1N2UV1T1BT &vertex) {
-        mBoundingBox.min = glm::min(glm::vec3(vertex.position), mBoundingBox.min);
-        mBoundingBox.max = glm::max(glm::vec3(vertex.position), mBoundingBox.max);
         mVertices.push_back(vertex);
-
-        if ((mVertices.size() % 3) == 0) {
-            size_t count = mVertices.size();
-            auto &v0 = mVertices[count - 3];
-            auto &v1 = mVertices[count - 2];
-            auto &v2 = mVertices[count - 1];
-
-            Triangle3D triangle(v0.position, v1.position, v2.position);
-            mArea += triangle.area();
-        }
     }
 
 }
@@ -15,18 +15,38 @@
 #include "GLVertexArray.hpp"
 #include "PackedLookupTable.hpp"
 #include "AxisAlignedBox3D.hpp"
+#include "TaggedAllocator.hpp"
+#include "Meshlet.hpp"
 
 #include <vector>
 
 namespace EARenderer {
 
     class SubMesh {
+    public:
+        using VertexVector = TaggedVector<Vertex1P1N2UV1T1BT, MemoryTag::Meshes>;
+        using AreaVector = TaggedVector<float, MemoryTag::Meshes>;
+        using MeshletVector = TaggedVector<Meshlet, MemoryTag::Meshes>;
+
+        /**
+         Simplified version of the sub mesh
+         */
+        struct LevelOfDetail {
+            VertexVector vertices;
+            // Maximum deviation from the full resolution surface, in mesh space units
+            float error = 0.0;
+        };
+
+        using LevelOfDetailVector = std::vector<LevelOfDetail>;
+
     private:
         std::string mName;
         std::string mMaterialName;
-        std::vector<Vertex1P1N2UV1T1BT> mVertices;
+        VertexVector mVertices;
         AxisAlignedBox3D mBoundingBox = AxisAlignedBox3D::MaximumReversed();
-        float mArea = 0.0;
+        AreaVector mTriangleAreaPrefixSums;
+        LevelOfDetailVector mLevelsOfDetail;
+        MeshletVector mMeshlets;
 
     public:
         SubMesh() = default;
@@ -35,18 +55,70 @@ namespace EARenderer {
 
         const std::string &materialName() const;
 
-        const std::vector<Vertex1P1N2UV1T1BT> &vertices() const;
+        const VertexVector &vertices() const;
 
         const AxisAlignedBox3D &boundingBox() const;
 
-        std::vector<Vertex1P1N2UV1T1BT> &vertices();
+        VertexVector &vertices();
 
         float surfaceArea() const;
 
+        /**
+         @return running totals of triangle areas, i-th element being the area of triangles [0, i]
+         */
+        const AreaVector &triangleAreaPrefixSums() const;
+
+        /**
+         Picks a triangle with probability proportional to its area
+
+         @param u uniformly distributed number in [0, 1)
+         @return index of the triangle
+         */
+        size_t areaWeightedTriangleIndex(float u) const;
+
+        /**
+         @return simplified versions of the sub mesh ordered from finest to coarsest, full resolution excluded
+         */
+        const LevelOfDetailVector &levelsOfDetail() const;
+
+        /**
+         @return amount of LODs including the full resolution one, which has index 0
+         */
+        size_t lodCount() const;
+
+        /**
+         @param lod index of the LOD, 0 being the full resolution
+         @return triangle list of the LOD
+         */
+        const VertexVector &lodVertices(size_t lod) const;
+
+        /**
+         @param lod index of the LOD, 0 being the full resolution
+         @return deviation of the LOD from the full resolution surface in mesh space units
+         */
+        float lodError(size_t lod) const;
+
+        /**
+         @return clusters partitioning full resolution vertices, empty if none were built
+         */
+        const MeshletVector &meshlets() const;
+
         void setName(const std::string &name);
 
         void setMaterialName(const std::string &name);
 
+        void setBoundingBox(const AxisAlignedBox3D &boundingBox);
+
+        void setTriangleAreaPrefixSums(AreaVector &&prefixSums);
+
+        void setLevelsOfDetail(LevelOfDetailVector &&levelsOfDetail);
+
+        void setMeshlets(MeshletVector &&meshlets);
+
+        /**
+         Appends a vertex without updating bounding box and area,
+         which are computed for the whole sub mesh by MeshProcessor
+         */
         void addVertex(const Vertex1P1N2UV1T1BT &vertex);
     };
 
@@ -23,6 +23,8 @@ namespace EARenderer {
         uint32_t surfelClusterProjectionGroupOffset = 0;
         uint32_t surfelClusterProjectionGroupSize = 0;
         SphericalHarmonics skySphericalHarmonics;
+        // Probes embedded in solid geometry and unused slots of the probe atlas are excluded from interpolation
+        bool isValid = true;
 
         DiffuseLightProbe() = default;
 
@@ -35,6 +37,7 @@ namespace EARenderer {
         s.value4b(probe.surfelClusterProjectionGroupOffset);
         s.value4b(probe.surfelClusterProjectionGroupSize);
         s.object(probe.skySphericalHarmonics);
+        s.value1b(probe.isValid);
     }
 
 }
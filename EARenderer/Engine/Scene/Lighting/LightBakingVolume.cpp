@@ -0,0 +1,28 @@
+//
+// Created by Pavlo Muratov on 2019-02-05.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "LightBakingVolume.hpp"
+
+#include <glm/geometric.hpp>
+
+namespace EARenderer {
+
+#pragma mark - Lifecycle
+
+    LightBakingVolume::LightBakingVolume(const std::string &name, const AxisAlignedBox3D &bounds, float blendDistance)
+            :
+            name(name),
+            bounds(bounds),
+            blendDistance(blendDistance) {
+    }
+
+#pragma mark - Queries
+
+    float LightBakingVolume::distance(const glm::vec3 &point) const {
+        glm::vec3 outside = glm::max(glm::max(bounds.min - point, point - bounds.max), glm::vec3(0.0));
+        return glm::length(outside);
+    }
+
+}
@@ -0,0 +1,37 @@
+//
+// Created by Pavlo Muratov on 2019-02-05.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_LIGHTBAKINGVOLUME_HPP
+#define EARENDERER_LIGHTBAKINGVOLUME_HPP
+
+#include "AxisAlignedBox3D.hpp"
+
+#include <string>
+
+namespace EARenderer {
+
+    /**
+     A region of the scene whose surfels and probes are baked, cached and streamed independently of other regions.
+     Lighting of overlapping volumes is blended inside the blend distance from their boundaries.
+     */
+    struct LightBakingVolume {
+        std::string name;
+        AxisAlignedBox3D bounds;
+        float blendDistance = 1.0;
+
+        LightBakingVolume() = default;
+
+        LightBakingVolume(const std::string &name, const AxisAlignedBox3D &bounds, float blendDistance);
+
+        /**
+         @param point point in world space
+         @return distance from the point to the volume, 0 for points inside
+         */
+        float distance(const glm::vec3 &point) const;
+    };
+
+}
+
+#endif //EARENDERER_LIGHTBAKINGVOLUME_HPP
@@ -8,10 +8,49 @@
 
 #include "SurfelCluster.hpp"
 
+#include <glm/geometric.hpp>
+#include <glm/common.hpp>
+
 namespace EARenderer {
 
 #pragma mark - Lifecycle
 
     SurfelCluster::SurfelCluster(size_t offset, size_t count) : surfelOffset(offset), surfelCount(count) {}
 
+#pragma mark - Getters
+
+    bool SurfelCluster::isLeaf() const {
+        return level == 0;
+    }
+
+    float SurfelCluster::normalCoherence() const {
+        return glm::length(normal);
+    }
+
+#pragma mark - Aggregation
+
+    void SurfelCluster::aggregate(const Surfel &surfel) {
+        float totalArea = area + surfel.area;
+        if (totalArea > 0.0) {
+            float weight = surfel.area / totalArea;
+            albedo = glm::mix(albedo, surfel.albedo.rgb(), weight);
+            normal = glm::mix(normal, surfel.normal, weight);
+        }
+        area = totalArea;
+        bounds.min = glm::min(bounds.min, surfel.position);
+        bounds.max = glm::max(bounds.max, surfel.position);
+    }
+
+    void SurfelCluster::aggregate(const SurfelCluster &child) {
+        float totalArea = area + child.area;
+        if (totalArea > 0.0) {
+            float weight = child.area / totalArea;
+            albedo = glm::mix(albedo, child.albedo, weight);
+            normal = glm::mix(normal, child.normal, weight);
+        }
+        area = totalArea;
+        bounds.min = glm::min(bounds.min, child.bounds.min);
+        bounds.max = glm::max(bounds.max, child.bounds.max);
+    }
+
 }
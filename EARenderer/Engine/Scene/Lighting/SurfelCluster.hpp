@@ -13,17 +13,55 @@
 #include <glm/vec3.hpp>
 #include <bitsery/bitsery.h>
 #include "Serializers.hpp"
+#include "Surfel.hpp"
+#include "AxisAlignedBox3D.hpp"
 
 namespace EARenderer {
 
+    /**
+     A group of similar surfels occupying a contiguous range in the surfel list.
+
+     Clusters form a hierarchy: leaf clusters (level 0) contain surfels directly,
+     parent clusters contain a contiguous range of clusters from the previous level
+     and cover all surfels of their children, which are contiguous as well.
+     */
     struct SurfelCluster {
         uint32_t surfelOffset = 0;
         uint32_t surfelCount = 0;
         glm::vec3 center;
 
+        uint32_t level = 0;
+        uint32_t childOffset = 0;
+        uint32_t childCount = 0;
+
+        // Surface attributes aggregated over all surfels of the cluster
+        float area = 0.0;
+        glm::vec3 albedo = glm::vec3(0.0);
+        // Area-weighted average normal. Its length lies in [0, 1] range and describes
+        // how coherent the normals are: 1 for a flat surface, 0 for opposing normals
+        glm::vec3 normal = glm::vec3(0.0);
+        AxisAlignedBox3D bounds = AxisAlignedBox3D::MaximumReversed();
+
         SurfelCluster() = default;
 
         SurfelCluster(size_t offset, size_t count);
+
+        bool isLeaf() const;
+
+        /**
+         @return length of the average normal, 1 when all surfels are facing the same direction
+         */
+        float normalCoherence() const;
+
+        /**
+         Accumulates surfel's area, albedo, normal and position into cluster's aggregated attributes
+         */
+        void aggregate(const Surfel &surfel);
+
+        /**
+         Accumulates aggregated attributes of a child cluster
+         */
+        void aggregate(const SurfelCluster &child);
     };
 
     template<typename S>
@@ -31,6 +69,14 @@ namespace EARenderer {
         s.value4b(cluster.surfelOffset);
         s.value4b(cluster.surfelCount);
         s.object(cluster.center);
+        s.value4b(cluster.level);
+        s.value4b(cluster.childOffset);
+        s.value4b(cluster.childCount);
+        s.value4b(cluster.area);
+        s.object(cluster.albedo);
+        s.object(cluster.normal);
+        s.object(cluster.bounds.min);
+        s.object(cluster.bounds.max);
     }
 
 }
@@ -10,6 +10,7 @@
 #define SurfelClusterProjection_hpp
 
 #include "SphericalHarmonics.hpp"
+#include "QuantizedSphericalHarmonics.hpp"
 
 #include <bitsery/bitsery.h>
 
@@ -20,12 +21,23 @@ namespace EARenderer {
         SphericalHarmonics sphericalHarmonics;
     };
 
+    struct QuantizedSurfelClusterProjection {
+        uint32_t surfelClusterIndex = 0;
+        QuantizedSphericalHarmonics sphericalHarmonics;
+    };
+
     template<typename S>
     void serialize(S &s, SurfelClusterProjection &projection) {
         s.value4b(projection.surfelClusterIndex);
         s.object(projection.sphericalHarmonics);
     }
 
+    template<typename S>
+    void serialize(S &s, QuantizedSurfelClusterProjection &projection) {
+        s.value4b(projection.surfelClusterIndex);
+        s.object(projection.sphericalHarmonics);
+    }
+
 }
 
 #endif /* SurfelClusterProjection_hpp */
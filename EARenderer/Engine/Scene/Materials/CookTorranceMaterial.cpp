@@ -9,9 +9,39 @@
 #include "CookTorranceMaterial.hpp"
 #include "GLTextureFactory.hpp"
 #include "Visitor.hpp"
+#include "MemoryTracker.hpp"
 
 namespace EARenderer {
 
+    namespace {
+
+        // Neutral values shown until a streamed image arrives
+        std::array<uint8_t, 4> PlaceholderTexel(CookTorranceMaterial::MapType type) {
+            switch (type) {
+                case CookTorranceMaterial::MapType::Albedo:
+                    return {128, 128, 128, 255};
+                case CookTorranceMaterial::MapType::Normal:
+                    return {128, 128, 255, 255};
+                case CookTorranceMaterial::MapType::Metalness:
+                    return {0, 0, 0, 255};
+                case CookTorranceMaterial::MapType::Roughness:
+                    return {128, 128, 128, 255};
+                case CookTorranceMaterial::MapType::AmbientOcclusion:
+                    return {255, 255, 255, 255};
+                case CookTorranceMaterial::MapType::Displacement:
+                    return {0, 0, 0, 255};
+            }
+        }
+
+        template<GLTexture::Normalized Format>
+        std::unique_ptr<GLNormalizedTexture2D<Format>> StreamedImage(const Size2D &size, const void *pixels) {
+            auto texture = std::make_unique<GLNormalizedTexture2D<Format>>(size, pixels, Sampling::Filter::Anisotropic, Sampling::WrapMode::Repeat);
+            texture->generateMipMaps();
+            return texture;
+        }
+
+    }
+
 #pragma mark - Lifecycle
 
     CookTorranceMaterial::CookTorranceMaterial(
@@ -20,31 +50,73 @@ namespace EARenderer {
             std::variant<std::string, float> metalness,
             std::variant<std::string, float> roughness,
             std::variant<std::string, float> ambientOcclusion,
-            std::variant<std::string, float> displacement) {
+            std::variant<std::string, float> displacement,
+            TextureLoading textureLoading)
+            :
+            mTextureLoading(textureLoading) {
+
+        MemoryTracker::Scope memoryScope(MemoryTag::MaterialTextures);
+
+        bool isStreamed = textureLoading == TextureLoading::Streamed;
 
         // All std::variant functionality that might throw std::bad_variant_access is marked as available starting with macOS 10.14
         // and that means we can't use std::visit **angry face**
         // https://stackoverflow.com/questions/52310835/xcode-10-call-to-unavailable-function-stdvisit
         //
         if (std::holds_alternative<std::string>(albedo)) {
-            mAlbedoMap = GLTextureFactory::LoadLDRImage<GLTexture::Normalized::RGBACompressedRGBAInput>(*std::get_if<std::string>(&albedo));
-            mAlbedoMap->generateMipMaps();
+            mMapPaths[size_t(MapType::Albedo)] = *std::get_if<std::string>(&albedo);
+        }
+        if (std::holds_alternative<std::string>(normal)) {
+            mMapPaths[size_t(MapType::Normal)] = *std::get_if<std::string>(&normal);
+        }
+        if (std::holds_alternative<std::string>(metalness)) {
+            mMapPaths[size_t(MapType::Metalness)] = *std::get_if<std::string>(&metalness);
+        }
+        if (std::holds_alternative<std::string>(roughness)) {
+            mMapPaths[size_t(MapType::Roughness)] = *std::get_if<std::string>(&roughness);
+        }
+        if (std::holds_alternative<std::string>(ambientOcclusion)) {
+            mMapPaths[size_t(MapType::AmbientOcclusion)] = *std::get_if<std::string>(&ambientOcclusion);
+        }
+        if (std::holds_alternative<std::string>(displacement)) {
+            mMapPaths[size_t(MapType::Displacement)] = *std::get_if<std::string>(&displacement);
+        }
+
+        if (isStreamed) {
+            for (size_t i = 0; i < MapTypeCount; i++) {
+                if (!mMapPaths[i].empty()) {
+                    auto texel = PlaceholderTexel(MapType(i));
+                    replaceMap(MapType(i), Size2D(1), texel.data());
+                }
+            }
+        }
+
+        if (std::holds_alternative<std::string>(albedo)) {
+            if (!isStreamed) {
+                mAlbedoMap = GLTextureFactory::LoadLDRImage<GLTexture::Normalized::RGBACompressedRGBAInput>(*std::get_if<std::string>(&albedo));
+                mAlbedoMap->generateMipMaps();
+            }
         } else {
-            auto colorData = std::get_if<Color>(&albedo)->rgba();
+            mAlbedoColor = *std::get_if<Color>(&albedo);
+            auto colorData = mAlbedoColor.rgba();
             mAlbedoMap = std::make_unique<AlbedoMap>(Size2D(1), &colorData);
         }
 
         if (std::holds_alternative<std::string>(normal)) {
-            mNormalMap = GLTextureFactory::LoadLDRImage<GLTexture::Normalized::RGBCompressedRGBAInput>(*std::get_if<std::string>(&normal));
-            mNormalMap->generateMipMaps();
+            if (!isStreamed) {
+                mNormalMap = GLTextureFactory::LoadLDRImage<GLTexture::Normalized::RGBCompressedRGBAInput>(*std::get_if<std::string>(&normal));
+                mNormalMap->generateMipMaps();
+            }
         } else {
             auto normalData = *std::get_if<glm::vec3>(&normal);
             mNormalMap = std::make_unique<NormalMap>(Size2D(1), &normalData);
         }
 
         if (std::holds_alternative<std::string>(metalness)) {
-            mMetallicMap = GLTextureFactory::LoadLDRImage<GLTexture::Normalized::RCompressedRGBAInput>(*std::get_if<std::string>(&metalness));
-            mMetallicMap->generateMipMaps();
+            if (!isStreamed) {
+                mMetallicMap = GLTextureFactory::LoadLDRImage<GLTexture::Normalized::RCompressedRGBAInput>(*std::get_if<std::string>(&metalness));
+                mMetallicMap->generateMipMaps();
+            }
         } else {
             float value = *std::get_if<float>(&metalness);
             uint8_t unnormalizedValue = uint8_t(value * 255.0);
@@ -52,8 +124,10 @@ namespace EARenderer {
         }
 
         if (std::holds_alternative<std::string>(roughness)) {
-            mRoughnessMap = GLTextureFactory::LoadLDRImage<GLTexture::Normalized::RCompressedRGBAInput>(*std::get_if<std::string>(&roughness));
-            mRoughnessMap->generateMipMaps();
+            if (!isStreamed) {
+                mRoughnessMap = GLTextureFactory::LoadLDRImage<GLTexture::Normalized::RCompressedRGBAInput>(*std::get_if<std::string>(&roughness));
+                mRoughnessMap->generateMipMaps();
+            }
         } else {
             float value = *std::get_if<float>(&roughness);
             uint8_t unnormalizedValue = uint8_t(value * 255.0);
@@ -61,8 +135,10 @@ namespace EARenderer {
         }
 
         if (std::holds_alternative<std::string>(ambientOcclusion)) {
-            mAmbientOcclusionMap = GLTextureFactory::LoadLDRImage<GLTexture::Normalized::RCompressedRGBAInput>(*std::get_if<std::string>(&ambientOcclusion));
-            mAmbientOcclusionMap->generateMipMaps();
+            if (!isStreamed) {
+                mAmbientOcclusionMap = GLTextureFactory::LoadLDRImage<GLTexture::Normalized::RCompressedRGBAInput>(*std::get_if<std::string>(&ambientOcclusion));
+                mAmbientOcclusionMap->generateMipMaps();
+            }
         } else {
             float value = *std::get_if<float>(&ambientOcclusion);
             uint8_t unnormalizedValue = uint8_t(value * 255.0);
@@ -70,8 +146,10 @@ namespace EARenderer {
         }
 
         if (std::holds_alternative<std::string>(displacement)) {
-            mDisplacementMap = GLTextureFactory::LoadLDRImage<GLTexture::Normalized::RCompressedRGBAInput>(*std::get_if<std::string>(&displacement));
-            mDisplacementMap->generateMipMaps();
+            if (!isStreamed) {
+                mDisplacementMap = GLTextureFactory::LoadLDRImage<GLTexture::Normalized::RCompressedRGBAInput>(*std::get_if<std::string>(&displacement));
+                mDisplacementMap->generateMipMaps();
+            }
         } else {
             float value = *std::get_if<float>(&displacement);
             uint8_t unnormalizedValue = uint8_t(value * 255.0);
@@ -80,6 +158,33 @@ namespace EARenderer {
 
     }
 
+#pragma mark - Texture streaming
+
+    void CookTorranceMaterial::replaceMap(MapType type, const Size2D &size, const void *pixels) {
+        MemoryTracker::Scope memoryScope(MemoryTag::MaterialTextures);
+
+        switch (type) {
+            case MapType::Albedo:
+                mAlbedoMap = StreamedImage<GLTexture::Normalized::RGBACompressedRGBAInput>(size, pixels);
+                break;
+            case MapType::Normal:
+                mNormalMap = StreamedImage<GLTexture::Normalized::RGBCompressedRGBAInput>(size, pixels);
+                break;
+            case MapType::Metalness:
+                mMetallicMap = StreamedImage<GLTexture::Normalized::RCompressedRGBAInput>(size, pixels);
+                break;
+            case MapType::Roughness:
+                mRoughnessMap = StreamedImage<GLTexture::Normalized::RCompressedRGBAInput>(size, pixels);
+                break;
+            case MapType::AmbientOcclusion:
+                mAmbientOcclusionMap = StreamedImage<GLTexture::Normalized::RCompressedRGBAInput>(size, pixels);
+                break;
+            case MapType::Displacement:
+                mDisplacementMap = StreamedImage<GLTexture::Normalized::RCompressedRGBAInput>(size, pixels);
+                break;
+        }
+    }
+
 #pragma mark - Getters
 
     const CookTorranceMaterial::AlbedoMap *CookTorranceMaterial::albedoMap() const {
@@ -106,4 +211,33 @@ namespace EARenderer {
         return mDisplacementMap.get();
     }
 
+    const GLTexture *CookTorranceMaterial::map(MapType type) const {
+        switch (type) {
+            case MapType::Albedo:
+                return mAlbedoMap.get();
+            case MapType::Normal:
+                return mNormalMap.get();
+            case MapType::Metalness:
+                return mMetallicMap.get();
+            case MapType::Roughness:
+                return mRoughnessMap.get();
+            case MapType::AmbientOcclusion:
+                return mAmbientOcclusionMap.get();
+            case MapType::Displacement:
+                return mDisplacementMap.get();
+        }
+    }
+
+    const std::string &CookTorranceMaterial::mapPath(MapType type) const {
+        return mMapPaths[size_t(type)];
+    }
+
+    const Color &CookTorranceMaterial::albedoColor() const {
+        return mAlbedoColor;
+    }
+
+    CookTorranceMaterial::TextureLoading CookTorranceMaterial::textureLoading() const {
+        return mTextureLoading;
+    }
+
 }
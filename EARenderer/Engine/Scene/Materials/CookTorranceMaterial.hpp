@@ -9,6 +9,7 @@
 #ifndef PBRMaterial_hpp
 #define PBRMaterial_hpp
 
+#include <array>
 #include <string>
 #include <memory>
 #include <variant>
@@ -29,6 +30,19 @@ namespace EARenderer {
         using AmbientOcclusionMap   = GLNormalizedTexture2D<GLTexture::Normalized::RCompressedRGBAInput>;
         using DisplacementMap       = GLNormalizedTexture2D<GLTexture::Normalized::RCompressedRGBAInput>;
 
+        enum class MapType : uint8_t {
+            Albedo, Normal, Metalness, Roughness, AmbientOcclusion, Displacement
+        };
+
+        static constexpr size_t MapTypeCount = 6;
+
+        enum class TextureLoading {
+            // Images are loaded at full resolution by the constructor
+            Immediate,
+            // Images are replaced by single texel placeholders until a texture streamer loads them
+            Streamed
+        };
+
     private:
         std::unique_ptr<AlbedoMap> mAlbedoMap;
         std::unique_ptr<NormalMap> mNormalMap;
@@ -36,6 +50,11 @@ namespace EARenderer {
         std::unique_ptr<RoughnessMap> mRoughnessMap;
         std::unique_ptr<AmbientOcclusionMap> mAmbientOcclusionMap;
         std::unique_ptr<DisplacementMap> mDisplacementMap;
+        // Image paths of maps, empty for maps of constant values
+        std::array<std::string, MapTypeCount> mMapPaths;
+        // Constant albedo, used when the albedo map has no image
+        Color mAlbedoColor = Color::Black();
+        TextureLoading mTextureLoading;
 
     public:
         CookTorranceMaterial(
@@ -44,7 +63,8 @@ namespace EARenderer {
                 std::variant<std::string, float> metalness,
                 std::variant<std::string, float> roughness,
                 std::variant<std::string, float> ambientOcclusion,
-                std::variant<std::string, float> displacement
+                std::variant<std::string, float> displacement,
+                TextureLoading textureLoading = TextureLoading::Immediate
         );
 
         const AlbedoMap *albedoMap() const;
@@ -58,6 +78,30 @@ namespace EARenderer {
         const AmbientOcclusionMap *ambientOcclusionMap() const;
 
         const DisplacementMap *displacementMap() const;
+
+        const GLTexture *map(MapType type) const;
+
+        /**
+         @return path of the map's image, empty if the map holds a constant value
+         */
+        const std::string &mapPath(MapType type) const;
+
+        /**
+         @return constant albedo of the material, meaningful only if the albedo map has no image path
+         */
+        const Color &albedoColor() const;
+
+        TextureLoading textureLoading() const;
+
+        /**
+         Replaces the map with a new image, which is used by texture streaming to change resident mip levels.
+         Mip maps are generated for the image.
+
+         @param type map to replace
+         @param size size of the image
+         @param pixels tightly packed RGBA8 texels
+         */
+        void replaceMap(MapType type, const Size2D &size, const void *pixels);
     };
 
 }
@@ -14,6 +14,7 @@
 #include "Collision.hpp"
 #include "Measurement.hpp"
 #include "SharedResourceStorage.hpp"
+#include "StringUtils.hpp"
 
 namespace EARenderer {
 
@@ -86,6 +87,13 @@ namespace EARenderer {
         return mLightBakingVolume;
     }
 
+    std::vector<LightBakingVolume> Scene::lightBakingVolumes() const {
+        if (mLightBakingVolumes.empty()) {
+            return {LightBakingVolume("main", mLightBakingVolume, mDiffuseProbesSpacing)};
+        }
+        return mLightBakingVolumes;
+    }
+
     const std::list<ID> &Scene::staticMeshInstanceIDs() const {
         return mStaticMeshInstanceIDs;
     }
@@ -124,6 +132,15 @@ namespace EARenderer {
         mLightBakingVolume = volume;
     }
 
+    void Scene::addLightBakingVolume(const LightBakingVolume &volume) {
+        for (auto &existingVolume : mLightBakingVolumes) {
+            if (existingVolume.name == volume.name) {
+                throw std::invalid_argument(string_format("Light baking volume %s already exists", volume.name.c_str()));
+            }
+        }
+        mLightBakingVolumes.push_back(volume);
+    }
+
 #pragma mark -
 
     void Scene::calculateGeometricProperties(const SharedResourceStorage &resourceStorage) {
@@ -134,10 +151,8 @@ namespace EARenderer {
             auto &instance = mMeshInstances[meshInstanceID];
             auto &mesh = resourceStorage.mesh(instance.meshID());
 
-            for (ID subMeshID : mesh.subMeshes()) {
-                auto &subMesh = mesh.subMeshes()[subMeshID];
-                mStaticGeometryArea += subMesh.surfaceArea();
-            }
+            // Areas are cached per mesh by MeshProcessor at load time
+            mStaticGeometryArea += mesh.surfaceArea();
 
             auto boundingBox = instance.boundingBox(mesh);
             mBoundingBox.min = glm::min(mBoundingBox.min, boundingBox.min);
@@ -27,6 +27,7 @@
 #include "SurfelClusterProjection.hpp"
 #include "EmbreeRayTracer.hpp"
 #include "GLTexture2DArray.hpp"
+#include "LightBakingVolume.hpp"
 
 #include <vector>
 #include <list>
@@ -70,6 +71,7 @@ namespace EARenderer {
 
         AxisAlignedBox3D mBoundingBox;
         AxisAlignedBox3D mLightBakingVolume;
+        std::vector<LightBakingVolume> mLightBakingVolumes;
 
     public:
 
@@ -109,6 +111,11 @@ namespace EARenderer {
 
         const AxisAlignedBox3D &lightBakingVolume() const;
 
+        /**
+         @return named volumes added to the scene, or a single volume spanning lightBakingVolume() if there are none
+         */
+        std::vector<LightBakingVolume> lightBakingVolumes() const;
+
         float staticGeometryArea() const;
 
         Camera *camera() const;
@@ -125,6 +132,13 @@ namespace EARenderer {
 
         void setLightBakingVolume(const AxisAlignedBox3D &volume);
 
+        /**
+         Adds a volume that is baked and streamed independently of others
+
+         @param volume volume with a name unique within the scene
+         */
+        void addLightBakingVolume(const LightBakingVolume &volume);
+
         void setCamera(std::unique_ptr<Camera> camera);
 
         void setSkybox(std::unique_ptr<Skybox> skybox);
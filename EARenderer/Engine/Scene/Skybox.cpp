@@ -7,7 +7,9 @@
 //
 
 #include "Skybox.hpp"
+#include "GLStateCache.hpp"
 #include "GLTextureFactory.hpp"
+#include "MemoryTracker.hpp"
 #include "Drawable.hpp"
 
 #include <glm/vec3.hpp>
@@ -17,8 +19,10 @@ namespace EARenderer {
 #pragma mark - Lifeycle
 
     Skybox::Skybox(const std::string &equirectangularImage, float exposure)
-            : mEquirectangularMap(GLTextureFactory::LoadHDRImage(equirectangularImage)),
-              mExposure(std::max(exposure, 0.0f)) {}
+            : mExposure(std::max(exposure, 0.0f)) {
+        MemoryTracker::Scope memoryScope(MemoryTag::Environment);
+        mEquirectangularMap = GLTextureFactory::LoadHDRImage(equirectangularImage);
+    }
 
 #pragma mark - Getters
 
@@ -55,7 +59,7 @@ namespace EARenderer {
 #pragma mark - Drawable
 
     void Skybox::draw() const {
-        glDepthFunc(GL_LEQUAL);
+        GLStateCache::shared().depthFunc(GL_LEQUAL);
         Drawable::TriangleStripQuad::Draw();
     }
 
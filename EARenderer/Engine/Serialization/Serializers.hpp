@@ -37,6 +37,14 @@ namespace glm {
         s.value4b(v.z);
     }
 
+    template<typename S>
+    void serialize(S &s, glm::uvec4 &v) {
+        s.value4b(v.x);
+        s.value4b(v.y);
+        s.value4b(v.z);
+        s.value4b(v.w);
+    }
+
 }
 
 #endif /* Serializers_h */
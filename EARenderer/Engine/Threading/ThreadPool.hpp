@@ -10,13 +10,17 @@
 #define ThreadPool_hpp
 
 #include "ThreadSafeQueue.hpp"
+#include "Profiler.hpp"
 
 #include <algorithm>
 #include <atomic>
+#include <condition_variable>
 #include <cstdint>
+#include <exception>
 #include <functional>
 #include <future>
 #include <memory>
+#include <mutex>
 #include <thread>
 #include <type_traits>
 #include <utility>
@@ -174,6 +178,91 @@ namespace EARenderer {
             return result;
         }
 
+#pragma mark - Parallel Loops
+
+        /**
+         * Calls func(begin, end) for consecutive ranges of [0, count), each holding at most grainSize elements.
+         * Range boundaries depend on count and grainSize only, never on the amount of threads, so loops
+         * writing into per-element or per-range slots and reducing them afterwards are deterministic.
+         *
+         * The calling thread processes ranges too and returns once all of them are finished,
+         * which keeps nested loops started from inside of workers from deadlocking.
+         * The first exception thrown by func is rethrown on the calling thread.
+         */
+        template<typename Func>
+        void parallelFor(size_t count, size_t grainSize, Func &&func) {
+            grainSize = std::max(grainSize, size_t(1));
+            size_t rangeCount = (count + grainSize - 1) / grainSize;
+
+            if (rangeCount <= 1 || mThreads.empty()) {
+                for (size_t begin = 0; begin < count; begin += grainSize) {
+                    func(begin, std::min(begin + grainSize, count));
+                }
+                return;
+            }
+
+            auto loop = std::make_shared<ParallelLoop>();
+            loop->body = [&func](size_t begin, size_t end) { func(begin, end); };
+            loop->count = count;
+            loop->grainSize = grainSize;
+            loop->rangeCount = rangeCount;
+
+            // Helpers outliving the loop find no ranges left and never touch the body
+            size_t helperCount = std::min(mThreads.size(), rangeCount - 1);
+            for (size_t i = 0; i < helperCount; i++) {
+                auto helper = [loop]() { loop->run(); };
+                mTaskQueue.push(std::make_unique<ThreadTask<decltype(helper)>>(std::move(helper)));
+            }
+
+            loop->run();
+
+            std::unique_lock<std::mutex> lock(loop->mutex);
+            loop->completion.wait(lock, [&loop]() { return loop->completedRangeCount == loop->rangeCount; });
+
+            if (loop->exception) {
+                std::rethrow_exception(loop->exception);
+            }
+        }
+
+    private:
+
+#pragma mark - Parallel Loop State
+
+        struct ParallelLoop {
+            std::function<void(size_t, size_t)> body;
+            size_t count = 0;
+            size_t grainSize = 1;
+            size_t rangeCount = 0;
+            std::atomic<size_t> nextRange{0};
+            std::atomic<size_t> completedRangeCount{0};
+            std::mutex mutex;
+            std::condition_variable completion;
+            std::exception_ptr exception;
+
+            /**
+             * Claims and processes ranges until none are left.
+             */
+            void run() {
+                for (size_t range = nextRange++; range < rangeCount; range = nextRange++) {
+                    size_t begin = range * grainSize;
+                    try {
+                        body(begin, std::min(begin + grainSize, count));
+                    }
+                    catch (...) {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (!exception) {
+                            exception = std::current_exception();
+                        }
+                    }
+
+                    if (++completedRangeCount == rangeCount) {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        completion.notify_all();
+                    }
+                }
+            }
+        };
+
     private:
 
 #pragma mark - Thread Pool Private Heplers
@@ -182,6 +271,8 @@ namespace EARenderer {
          * Constantly running function each thread uses to acquire work items from the queue.
          */
         void worker() {
+            EA_PROFILE_THREAD_NAME("Thread pool worker");
+
             while (!mDone) {
                 std::unique_ptr<IThreadTask> pTask(nullptr);
                 if (mTaskQueue.waitPop(pTask)) {
@@ -0,0 +1,19 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "ScopedGLBackend.hpp"
+#include "GLStateCache.hpp"
+
+namespace EARenderer {
+
+    ScopedGLBackend::ScopedGLBackend(GLBackend *backend) {
+        GLStateCache::shared().setBackend(backend);
+    }
+
+    ScopedGLBackend::~ScopedGLBackend() {
+        GLStateCache::shared().setBackend(nullptr);
+    }
+
+}
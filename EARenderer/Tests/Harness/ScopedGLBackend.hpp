@@ -0,0 +1,30 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_SCOPEDGLBACKEND_HPP
+#define EARENDERER_SCOPEDGLBACKEND_HPP
+
+#include "GLBackend.hpp"
+
+namespace EARenderer {
+
+    /**
+     Redirects GL calls of the state cache to a backend for the lifetime of the object,
+     so that a failed expectation never leaves a recording backend installed for later tests
+     */
+    class ScopedGLBackend {
+    public:
+        ScopedGLBackend(GLBackend *backend);
+
+        ~ScopedGLBackend();
+
+        ScopedGLBackend(const ScopedGLBackend &that) = delete;
+
+        ScopedGLBackend &operator=(const ScopedGLBackend &rhs) = delete;
+    };
+
+}
+
+#endif //EARENDERER_SCOPEDGLBACKEND_HPP
@@ -0,0 +1,39 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "TestAssertions.hpp"
+#include "StringUtils.hpp"
+
+#include <cmath>
+#include <cstring>
+
+namespace EARenderer {
+
+#pragma mark - Helpers
+
+    static const char *FileName(const char *path) {
+        const char *slash = strrchr(path, '/');
+        return slash ? slash + 1 : path;
+    }
+
+#pragma mark - Expectations
+
+    void FailExpectation(const std::string &message, const char *file, int line) {
+        throw TestFailure(string_format("%s:%d: %s", FileName(file), line, message.c_str()));
+    }
+
+    void Expect(bool condition, const char *expression, const char *file, int line) {
+        if (!condition) {
+            FailExpectation(string_format("Expected %s", expression), file, line);
+        }
+    }
+
+    void ExpectNear(double value, double expected, double tolerance, const char *expression, const char *file, int line) {
+        if (!(std::abs(value - expected) <= tolerance)) {
+            FailExpectation(string_format("Expected %s = %g to be within %g of %g", expression, value, tolerance, expected), file, line);
+        }
+    }
+
+}
@@ -0,0 +1,43 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_TESTASSERTIONS_HPP
+#define EARENDERER_TESTASSERTIONS_HPP
+
+#include <stdexcept>
+#include <string>
+
+namespace EARenderer {
+
+    /**
+     Thrown by failed expectations, carries the expression and its location
+     */
+    class TestFailure : public std::runtime_error {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    void Expect(bool condition, const char *expression, const char *file, int line);
+
+    void ExpectNear(double value, double expected, double tolerance, const char *expression, const char *file, int line);
+
+    [[noreturn]] void FailExpectation(const std::string &message, const char *file, int line);
+
+}
+
+#define EA_EXPECT(condition) \
+    ::EARenderer::Expect(bool(condition), #condition, __FILE__, __LINE__)
+
+#define EA_EXPECT_NEAR(value, expected, tolerance) \
+    ::EARenderer::ExpectNear(double(value), double(expected), double(tolerance), #value, __FILE__, __LINE__)
+
+#define EA_EXPECT_THROWS(statement, Exception) \
+    do { \
+        bool hasThrown = false; \
+        try { statement; } catch (const Exception &) { hasThrown = true; } \
+        if (!hasThrown) { ::EARenderer::FailExpectation("Expected " #statement " to throw " #Exception, __FILE__, __LINE__); } \
+    } while (false)
+
+#endif //EARENDERER_TESTASSERTIONS_HPP
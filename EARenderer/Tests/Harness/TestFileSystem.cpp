@@ -0,0 +1,47 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "TestFileSystem.hpp"
+#include "StringUtils.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace EARenderer {
+
+    std::string MakeTemporaryDirectory() {
+        const char *temporaryDirectory = getenv("TMPDIR");
+        std::string pathTemplate = std::string(temporaryDirectory ? temporaryDirectory : "/tmp") + "/EARendererTestsXXXXXX";
+        std::vector<char> path(pathTemplate.begin(), pathTemplate.end());
+        path.push_back('\0');
+
+        if (!mkdtemp(path.data())) {
+            throw std::runtime_error(string_format("Unable to create a temporary directory from %s", pathTemplate.c_str()));
+        }
+        return std::string(path.data()) + "/";
+    }
+
+    void WriteFile(const std::string &path, const std::string &contents) {
+        std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+        stream << contents;
+    }
+
+    std::string ReadFile(const std::string &path) {
+        std::ifstream stream(path, std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+    }
+
+    bool FileExists(const std::string &path) {
+        struct stat attributes;
+        return stat(path.c_str(), &attributes) == 0;
+    }
+
+}
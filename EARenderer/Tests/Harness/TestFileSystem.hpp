@@ -0,0 +1,29 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_TESTFILESYSTEM_HPP
+#define EARENDERER_TESTFILESYSTEM_HPP
+
+#include <string>
+
+namespace EARenderer {
+
+    /**
+     @return path of a new empty directory under TMPDIR, ending with a slash
+     */
+    std::string MakeTemporaryDirectory();
+
+    void WriteFile(const std::string &path, const std::string &contents);
+
+    /**
+     @return contents of the file, empty if it can't be read
+     */
+    std::string ReadFile(const std::string &path);
+
+    bool FileExists(const std::string &path);
+
+}
+
+#endif //EARENDERER_TESTFILESYSTEM_HPP
@@ -0,0 +1,81 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "TestRunner.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+
+namespace EARenderer {
+
+#pragma mark - Lifecycle
+
+    TestRunner::TestRunner(const std::string &filter)
+            : mFilter(filter) {}
+
+#pragma mark - Public interface
+
+    void TestRunner::add(const std::string &name, const Function &function, Context context) {
+        mTests.push_back({name, function, context});
+    }
+
+    void TestRunner::setContextFactory(const Function &factory) {
+        mContextFactory = factory;
+    }
+
+    std::vector<std::string> TestRunner::testNames() const {
+        std::vector<std::string> names;
+        for (auto &test : mTests) {
+            if (test.name.find(mFilter) != std::string::npos) {
+                names.push_back(test.name);
+            }
+        }
+        return names;
+    }
+
+    std::vector<TestRunner::Result> TestRunner::run() const {
+        std::vector<Result> results;
+        bool hasContext = false;
+
+        for (auto &test : mTests) {
+            if (test.name.find(mFilter) == std::string::npos) {
+                continue;
+            }
+
+            printf("%-70s ", test.name.c_str());
+            fflush(stdout);
+
+            Result result;
+            result.name = test.name;
+            auto start = std::chrono::steady_clock::now();
+
+            try {
+                if (test.context == Context::OpenGL && !hasContext && mContextFactory) {
+                    mContextFactory();
+                    hasContext = true;
+                }
+                test.function();
+            } catch (const std::exception &exception) {
+                result.failure = exception.what();
+            } catch (...) {
+                result.failure = "Unknown exception";
+            }
+
+            result.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            if (result.failure.empty()) {
+                printf("passed (%.1f ms)\n", result.milliseconds);
+            } else {
+                printf("FAILED\n    %s\n", result.failure.c_str());
+            }
+
+            results.push_back(std::move(result));
+        }
+
+        return results;
+    }
+
+}
@@ -0,0 +1,77 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_TESTRUNNER_HPP
+#define EARENDERER_TESTRUNNER_HPP
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace EARenderer {
+
+    /**
+     Runs registered tests one after another. Tests are named hierarchically with slashes,
+     e.g. "ShaderPreprocessor/Include/Nested", so that a subset can be selected with a name filter.
+     A test fails by throwing, usually through one of the EA_EXPECT macros.
+     */
+    class TestRunner {
+    public:
+        using Function = std::function<void()>;
+
+        /**
+         Tests submitting their commands to the null backend run without an OpenGL context
+         */
+        enum class Context {
+            OpenGL, None
+        };
+
+        struct Result {
+            std::string name;
+            // Empty if the test passed
+            std::string failure;
+            double milliseconds = 0.0;
+        };
+
+    private:
+        struct Test {
+            std::string name;
+            Function function;
+            Context context;
+        };
+
+        std::string mFilter;
+        std::vector<Test> mTests;
+        Function mContextFactory;
+
+    public:
+        /**
+         @param filter only tests whose names contain the filter are run
+         */
+        TestRunner(const std::string &filter);
+
+        void add(const std::string &name, const Function &function, Context context = Context::OpenGL);
+
+        /**
+         @param factory makes an OpenGL context current, called once before the first test needing one is run
+         */
+        void setContextFactory(const Function &factory);
+
+        /**
+         @return names of tests passing the filter, in order of registration
+         */
+        std::vector<std::string> testNames() const;
+
+        /**
+         Runs tests passing the filter, printing progress to the standard output
+
+         @return results in order of registration
+         */
+        std::vector<Result> run() const;
+    };
+
+}
+
+#endif //EARENDERER_TESTRUNNER_HPP
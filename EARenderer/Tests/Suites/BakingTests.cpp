@@ -0,0 +1,118 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "BakingTests.hpp"
+#include "TestAssertions.hpp"
+#include "DiffuseLightProbeGenerator.hpp"
+#include "DiffuseLightProbeShard.hpp"
+#include "BakeCheckpoint.hpp"
+#include "TestFileSystem.hpp"
+#include "StringUtils.hpp"
+
+#include <bitsery/bitsery.h>
+#include <bitsery/adapter/buffer.h>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+
+namespace EARenderer {
+
+#pragma mark - Helpers
+
+    static std::vector<uint8_t> SerializedProbeData(DiffuseLightProbeData &probeData) {
+        std::vector<uint8_t> bytes;
+        using OutputAdapter = bitsery::OutputBufferAdapter<std::vector<uint8_t>>;
+        bitsery::Serializer<OutputAdapter> serializer(bytes);
+        serializer.object(probeData);
+
+        auto &writer = bitsery::AdapterAccess::getWriter(serializer);
+        writer.flush();
+        bytes.resize(writer.writtenBytesCount());
+        return bytes;
+    }
+
+    struct AbortedBake {
+    };
+
+#pragma mark - Registration
+
+    void BakingTests::Register(TestRunner &runner, BenchmarkSceneLibrary &scenes) {
+        for (auto &sceneName : BenchmarkSceneLibrary::SceneNames()) {
+            runner.add(string_format("DiffuseLightProbeShards/SharedProbesAreBakedOnce/%s", sceneName.c_str()), [=, &scenes] {
+                auto &entry = scenes.bakedEntry(sceneName);
+
+                DiffuseLightProbeGenerator probeGenerator;
+                auto shard = probeGenerator.generateProbeShard(*entry.scene, *entry.surfelData, 0, 1);
+                auto &probes = shard->probeData().probes();
+
+                // Every brick holds the probes of its faces, so bricks touching others repeat some of them
+                EA_EXPECT(shard->bakeOrder().size() + shard->sharedProbes().size() <= probes.size());
+
+                for (auto &sharedProbe : shard->sharedProbes()) {
+                    auto &probe = probes[sharedProbe.probeIndex];
+                    auto &source = probes[sharedProbe.sourceProbeIndex];
+                    EA_EXPECT(sharedProbe.probeIndex != sharedProbe.sourceProbeIndex);
+                    EA_EXPECT(probe.surfelClusterProjectionGroupOffset == source.surfelClusterProjectionGroupOffset);
+                    EA_EXPECT(probe.surfelClusterProjectionGroupSize == source.surfelClusterProjectionGroupSize);
+                    EA_EXPECT(probe.isValid == source.isValid);
+                }
+            });
+
+            // Shards are baked one after another here, the way separate processes would bake them
+            for (uint32_t shardCount : {1u, 3u, 4u}) {
+                runner.add(string_format("DiffuseLightProbeShards/MergeMatchesSingleBake/%s/%u", sceneName.c_str(), shardCount), [=, &scenes] {
+                    auto &entry = scenes.bakedEntry(sceneName);
+
+                    std::vector<DiffuseLightProbeShard> shards;
+                    for (uint32_t i = 0; i < shardCount; i++) {
+                        DiffuseLightProbeGenerator probeGenerator;
+                        shards.push_back(std::move(*probeGenerator.generateProbeShard(*entry.scene, *entry.surfelData, i, shardCount)));
+                    }
+                    auto probeData = DiffuseLightProbeShard::Merge(shards);
+
+                    EA_EXPECT(probeData->probes().size() == entry.probeData->probes().size());
+                    EA_EXPECT(SerializedProbeData(*probeData) == SerializedProbeData(*entry.probeData));
+                });
+            }
+
+            runner.add(string_format("BakeCheckpoint/ResumedBakeMatchesSingleBake/%s", sceneName.c_str()), [=, &scenes] {
+                auto &entry = scenes.bakedEntry(sceneName);
+                std::string pathPrefix = MakeTemporaryDirectory() + "checkpoint";
+                constexpr uint64_t InputHash = 1;
+                size_t abortedProbeCount = std::max<size_t>(entry.probeData->probes().size() / 4, 1);
+
+                // Progress is saved after every probe, and the bake is interrupted once enough of it is on disk
+                BakeCheckpoint::Settings settings;
+                settings.probeSaveInterval = std::chrono::seconds(0);
+                settings.probeProgressSaved = [=](size_t savedProbeCount) {
+                    if (savedProbeCount == abortedProbeCount) {
+                        throw AbortedBake();
+                    }
+                };
+
+                {
+                    BakeCheckpoint checkpoint(pathPrefix, InputHash, settings);
+                    checkpoint.saveSurfels(*entry.surfelData);
+
+                    DiffuseLightProbeGenerator probeGenerator;
+                    probeGenerator.setCheckpoint(&checkpoint);
+                    EA_EXPECT_THROWS(probeGenerator.generateProbes(*entry.scene, *entry.surfelData), AbortedBake);
+                }
+
+                BakeCheckpoint checkpoint(pathPrefix, InputHash);
+                DiffuseLightProbeGenerator probeGenerator;
+                probeGenerator.setCheckpoint(&checkpoint);
+                auto &progress = checkpoint.beginProbes(DiffuseLightProbeData::ProjectionEncoding::Quantized, DiffuseLightProbeData::Layout::SparseBricks);
+                EA_EXPECT(progress.probes.size() == abortedProbeCount);
+
+                auto probeData = probeGenerator.generateProbes(*entry.scene, *entry.surfelData);
+                checkpoint.clear();
+
+                EA_EXPECT(SerializedProbeData(*probeData) == SerializedProbeData(*entry.probeData));
+            });
+        }
+    }
+
+}
@@ -0,0 +1,24 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_BAKINGTESTS_HPP
+#define EARENDERER_BAKINGTESTS_HPP
+
+#include "TestRunner.hpp"
+#include "BenchmarkSceneLibrary.hpp"
+
+namespace EARenderer {
+
+    /**
+     Diffuse light probes baked in shards and merged are byte-identical to a single process bake
+     */
+    class BakingTests {
+    public:
+        static void Register(TestRunner &runner, BenchmarkSceneLibrary &scenes);
+    };
+
+}
+
+#endif //EARENDERER_BAKINGTESTS_HPP
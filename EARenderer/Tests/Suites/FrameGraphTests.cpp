@@ -0,0 +1,255 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "FrameGraphTests.hpp"
+#include "TestAssertions.hpp"
+#include "FrameGraph.hpp"
+
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+namespace EARenderer {
+
+    using Resource = FrameGraph::Resource;
+    using TextureDescriptor = FrameGraph::TextureDescriptor;
+
+#pragma mark - Helpers
+
+    static TextureDescriptor Descriptor(const Size2D &size, GLTexture::Float format = GLTexture::Float::RGBA16F) {
+        TextureDescriptor descriptor;
+        descriptor.size = size;
+        descriptor.format = format;
+        return descriptor;
+    }
+
+    static FrameGraph::Execute NoWork() {
+        return [](const FrameGraph::Resources &resources) {};
+    }
+
+    /**
+     Every transient texture has to be backed by a physical texture of the same descriptor
+     */
+    static void ExpectMatchingPhysicalTextures(const FrameGraph &graph, const std::vector<std::pair<Resource, TextureDescriptor>> &textures) {
+        for (auto &texture : textures) {
+            uint32_t physicalIndex = graph.physicalIndex(texture.first);
+            EA_EXPECT(physicalIndex < graph.physicalTextures().size());
+            EA_EXPECT(physicalIndex >= graph.physicalTextures().size() || graph.physicalTextures()[physicalIndex] == texture.second);
+        }
+    }
+
+#pragma mark - Registration
+
+    void FrameGraphTests::Register(TestRunner &runner, BenchmarkSceneLibrary &scenes) {
+        runner.add("FrameGraph/Culling/PassesWithoutSideEffectsOrConsumersAreCulled", [] {
+            FrameGraph graph;
+            Resource unused;
+            Resource consumed;
+
+            graph.addPass("Unused", [&](FrameGraph::Builder &builder) {
+                unused = builder.create("Unused", Descriptor(Size2D(64)));
+                return NoWork();
+            });
+            graph.addPass("Producer", [&](FrameGraph::Builder &builder) {
+                consumed = builder.create("Consumed", Descriptor(Size2D(64)));
+                return NoWork();
+            });
+            graph.addPass("Consumer", [&](FrameGraph::Builder &builder) {
+                builder.read(consumed);
+                builder.setSideEffect();
+                return NoWork();
+            });
+            graph.addPass("Idle", [&](FrameGraph::Builder &builder) {
+                return NoWork();
+            });
+
+            graph.compile();
+
+            EA_EXPECT(graph.isCompiled());
+            EA_EXPECT((graph.schedule() == std::vector<uint32_t>{1, 2}));
+            EA_EXPECT(!graph.isPassAlive(0));
+            EA_EXPECT(graph.isPassAlive(1));
+            EA_EXPECT(graph.isPassAlive(2));
+            EA_EXPECT(!graph.isPassAlive(3));
+
+            // Textures of culled passes are never allocated
+            EA_EXPECT(graph.physicalIndex(unused) == Resource::InvalidIndex);
+            EA_EXPECT(graph.physicalIndex(consumed) != Resource::InvalidIndex);
+
+            auto statistics = graph.statistics();
+            EA_EXPECT(statistics.passCount == 4);
+            EA_EXPECT(statistics.culledPassCount == 2);
+            EA_EXPECT(statistics.transientTextureCount == 1);
+            EA_EXPECT(statistics.physicalTextureCount == 1);
+        }, TestRunner::Context::None);
+
+        runner.add("FrameGraph/Culling/WritesKeepEarlierWritersAlive", [] {
+            FrameGraph graph;
+            Resource accumulated;
+            Resource presented;
+
+            graph.addPass("Clear", [&](FrameGraph::Builder &builder) {
+                accumulated = builder.create("Accumulated", Descriptor(Size2D(64)));
+                return NoWork();
+            });
+            graph.addPass("Accumulate 1", [&](FrameGraph::Builder &builder) {
+                builder.write(accumulated);
+                return NoWork();
+            });
+            graph.addPass("Accumulate 2", [&](FrameGraph::Builder &builder) {
+                builder.write(accumulated);
+                return NoWork();
+            });
+            graph.addPass("Resolve", [&](FrameGraph::Builder &builder) {
+                builder.read(accumulated);
+                builder.setSideEffect();
+                return NoWork();
+            });
+            // Nobody reads what's written after the resolve
+            graph.addPass("Accumulate 3", [&](FrameGraph::Builder &builder) {
+                builder.write(accumulated);
+                return NoWork();
+            });
+            // Writing into the default framebuffer keeps the whole chain producing the texture alive
+            graph.addPass("Create presented", [&](FrameGraph::Builder &builder) {
+                presented = builder.create("Presented", Descriptor(Size2D(64)));
+                return NoWork();
+            });
+            graph.addPass("Present", [&](FrameGraph::Builder &builder) {
+                builder.write(presented);
+                builder.setSideEffect();
+                return NoWork();
+            });
+
+            graph.compile();
+
+            EA_EXPECT((graph.schedule() == std::vector<uint32_t>{0, 1, 2, 3, 5, 6}));
+            EA_EXPECT(!graph.isPassAlive(4));
+            EA_EXPECT(graph.statistics().culledPassCount == 1);
+        }, TestRunner::Context::None);
+
+        runner.add("FrameGraph/Aliasing/EqualDescriptorsShareOnceLifetimesEnd", [] {
+            FrameGraph graph;
+            std::vector<std::pair<Resource, TextureDescriptor>> textures;
+            TextureDescriptor descriptor = Descriptor(Size2D(128, 64));
+
+            // A chain of passes, each reading the texture of the previous one
+            Resource previous;
+            for (uint32_t i = 0; i < 4; i++) {
+                graph.addPass("Pass", [&](FrameGraph::Builder &builder) {
+                    if (previous.isValid()) {
+                        builder.read(previous);
+                    }
+                    previous = builder.create("Texture", descriptor);
+                    textures.emplace_back(previous, descriptor);
+                    return NoWork();
+                });
+            }
+            graph.addPass("Present", [&](FrameGraph::Builder &builder) {
+                builder.read(previous);
+                builder.setSideEffect();
+                return NoWork();
+            });
+
+            graph.compile();
+            ExpectMatchingPhysicalTextures(graph, textures);
+
+            // A texture is alive while the next one is rendered, so two of them are enough
+            EA_EXPECT(graph.physicalIndex(textures[0].first) != graph.physicalIndex(textures[1].first));
+            EA_EXPECT(graph.physicalIndex(textures[0].first) == graph.physicalIndex(textures[2].first));
+            EA_EXPECT(graph.physicalIndex(textures[1].first) == graph.physicalIndex(textures[3].first));
+
+            auto statistics = graph.statistics();
+            EA_EXPECT(statistics.transientTextureCount == 4);
+            EA_EXPECT(statistics.physicalTextureCount == 2);
+        }, TestRunner::Context::None);
+
+        runner.add("FrameGraph/Aliasing/DifferentDescriptorsNeverShare", [] {
+            FrameGraph graph;
+            std::vector<std::pair<Resource, TextureDescriptor>> textures;
+
+            TextureDescriptor halfFloat = Descriptor(Size2D(64), GLTexture::Float::RGBA16F);
+            TextureDescriptor fullFloat = Descriptor(Size2D(64), GLTexture::Float::RGBA32F);
+            TextureDescriptor halfFloatSingleChannel = Descriptor(Size2D(64), GLTexture::Float::R16F);
+            TextureDescriptor halfFloatLarger = Descriptor(Size2D(128), GLTexture::Float::RGBA16F);
+            TextureDescriptor halfFloatMipMapped = halfFloat;
+            halfFloatMipMapped.mipMaps = true;
+
+            // Each texture is only used by the pass creating it, so lifetimes never overlap
+            for (auto &descriptor : {halfFloat, fullFloat, halfFloatSingleChannel, halfFloatLarger, halfFloatMipMapped}) {
+                graph.addPass("Pass", [&](FrameGraph::Builder &builder) {
+                    textures.emplace_back(builder.create("Texture", descriptor), descriptor);
+                    builder.setSideEffect();
+                    return NoWork();
+                });
+            }
+
+            graph.compile();
+            ExpectMatchingPhysicalTextures(graph, textures);
+
+            std::set<uint32_t> physicalIndices;
+            for (auto &texture : textures) {
+                physicalIndices.insert(graph.physicalIndex(texture.first));
+            }
+            EA_EXPECT(physicalIndices.size() == textures.size());
+            EA_EXPECT(graph.statistics().physicalTextureCount == textures.size());
+        }, TestRunner::Context::None);
+
+        runner.add("FrameGraph/Aliasing/ScratchTexturesOfAPassNeverShare", [] {
+            FrameGraph graph;
+            std::vector<Resource> firstPassTextures;
+            std::vector<Resource> secondPassTextures;
+            TextureDescriptor descriptor = Descriptor(Size2D(32));
+
+            graph.addPass("First", [&](FrameGraph::Builder &builder) {
+                for (int i = 0; i < 3; i++) {
+                    firstPassTextures.push_back(builder.create("Scratch", descriptor));
+                }
+                builder.setSideEffect();
+                return NoWork();
+            });
+            graph.addPass("Second", [&](FrameGraph::Builder &builder) {
+                for (int i = 0; i < 3; i++) {
+                    secondPassTextures.push_back(builder.create("Scratch", descriptor));
+                }
+                builder.setSideEffect();
+                return NoWork();
+            });
+
+            graph.compile();
+
+            std::set<uint32_t> firstPassIndices;
+            std::set<uint32_t> secondPassIndices;
+            for (auto &texture : firstPassTextures) { firstPassIndices.insert(graph.physicalIndex(texture)); }
+            for (auto &texture : secondPassTextures) { secondPassIndices.insert(graph.physicalIndex(texture)); }
+
+            EA_EXPECT(firstPassIndices.size() == 3);
+            EA_EXPECT(secondPassIndices.size() == 3);
+
+            // The second pass reuses all textures of the first one
+            EA_EXPECT(firstPassIndices == secondPassIndices);
+            EA_EXPECT(graph.statistics().transientTextureCount == 6);
+            EA_EXPECT(graph.statistics().physicalTextureCount == 3);
+        }, TestRunner::Context::None);
+
+        runner.add("FrameGraph/ResetDropsPassesAndTextures", [] {
+            FrameGraph graph;
+            graph.addPass("Present", [&](FrameGraph::Builder &builder) {
+                builder.create("Texture", Descriptor(Size2D(32)));
+                builder.setSideEffect();
+                return NoWork();
+            });
+            graph.compile();
+            graph.reset();
+
+            EA_EXPECT(!graph.isCompiled());
+            EA_EXPECT(graph.schedule().empty());
+            EA_EXPECT(graph.physicalTextures().empty());
+            EA_EXPECT(graph.statistics().passCount == 0);
+            EA_EXPECT_THROWS(graph.physicalIndex(Resource{0}), std::invalid_argument);
+        }, TestRunner::Context::None);
+    }
+
+}
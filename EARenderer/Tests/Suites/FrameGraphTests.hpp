@@ -0,0 +1,24 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_FRAMEGRAPHTESTS_HPP
+#define EARENDERER_FRAMEGRAPHTESTS_HPP
+
+#include "TestRunner.hpp"
+#include "BenchmarkSceneLibrary.hpp"
+
+namespace EARenderer {
+
+    /**
+     Culling of frame graph passes and aliasing of transient textures
+     */
+    class FrameGraphTests {
+    public:
+        static void Register(TestRunner &runner, BenchmarkSceneLibrary &scenes);
+    };
+
+}
+
+#endif //EARENDERER_FRAMEGRAPHTESTS_HPP
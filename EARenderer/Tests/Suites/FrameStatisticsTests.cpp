@@ -0,0 +1,155 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "FrameStatisticsTests.hpp"
+#include "TestAssertions.hpp"
+#include "FrameStatistics.hpp"
+#include "FrameMeter.hpp"
+#include "MockPassTimer.hpp"
+
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace EARenderer {
+
+#pragma mark - Helpers
+
+    static void TimeFrame(MockPassTimer &timer, std::initializer_list<const char *> passNames) {
+        for (const char *passName : passNames) {
+            timer.beginPass(passName);
+            timer.endPass();
+        }
+    }
+
+#pragma mark - Registration
+
+    void FrameStatisticsTests::Register(TestRunner &runner, BenchmarkSceneLibrary &scenes) {
+        runner.add("FrameStatistics/Summary/PercentilesUseNearestRank", [] {
+            FrameStatistics statistics;
+            for (int i = 100; i >= 1; i--) {
+                statistics.addFrame(i);
+            }
+
+            auto summary = statistics.frameSummary();
+            EA_EXPECT(summary.sampleCount == 100);
+            EA_EXPECT_NEAR(summary.average, 50.5, 1e-9);
+            EA_EXPECT_NEAR(summary.percentile50, 50.0, 1e-9);
+            EA_EXPECT_NEAR(summary.percentile95, 95.0, 1e-9);
+            EA_EXPECT_NEAR(summary.percentile99, 99.0, 1e-9);
+            EA_EXPECT_NEAR(summary.maximum, 100.0, 1e-9);
+        });
+
+        runner.add("FrameStatistics/Summary/WindowKeepsMostRecentFrames", [] {
+            FrameStatistics statistics(10);
+            for (int i = 1; i <= 25; i++) {
+                statistics.addFrame(i);
+            }
+
+            auto summary = statistics.frameSummary();
+            EA_EXPECT(statistics.frameCount() == 25);
+            EA_EXPECT(summary.sampleCount == 10);
+            EA_EXPECT_NEAR(summary.average, 20.5, 1e-9);
+            EA_EXPECT_NEAR(summary.maximum, 25.0, 1e-9);
+
+            statistics.reset();
+            EA_EXPECT(statistics.frameCount() == 0);
+            EA_EXPECT(statistics.frameSummary().sampleCount == 0);
+        });
+
+        runner.add("FrameStatistics/Histogram/LastBucketCountsOutliers", [] {
+            FrameStatistics statistics;
+            for (double milliseconds : {0.5, 1.5, 1.6, 3.2, 50.0}) {
+                statistics.addFrame(milliseconds);
+            }
+
+            auto histogram = statistics.frameHistogram(4.0, 4);
+            EA_EXPECT_NEAR(histogram.bucketWidth, 1.0, 1e-9);
+            EA_EXPECT(histogram.counts == std::vector<size_t>({1, 2, 0, 2}));
+
+            EA_EXPECT_THROWS(statistics.frameHistogram(0.0, 4), std::invalid_argument);
+        });
+
+        runner.add("FrameStatistics/Spikes/AreMeasuredAgainstMedian", [] {
+            FrameStatistics statistics(100, 2.0);
+
+            // Too few frames to tell a spike from loading hitches
+            statistics.addFrame(100.0);
+            EA_EXPECT(!statistics.isLastFrameSpike());
+            for (int i = 0; i < 29; i++) {
+                statistics.addFrame(10.0);
+            }
+            EA_EXPECT(statistics.spikeCount() == 0);
+
+            statistics.addFrame(19.0);
+            EA_EXPECT(!statistics.isLastFrameSpike());
+
+            statistics.addFrame(25.0);
+            EA_EXPECT(statistics.isLastFrameSpike());
+
+            statistics.addFrame(10.0);
+            EA_EXPECT(!statistics.isLastFrameSpike());
+            EA_EXPECT(statistics.spikeCount() == 1);
+        });
+
+        runner.add("FrameStatistics/Passes/TimingsAreGroupedByName", [] {
+            MockPassTimer timer;
+            timer.setPassDuration("Shadows", 2.0);
+            timer.setPassDuration("Lighting", 3.0);
+
+            FrameStatistics statistics;
+            for (int i = 0; i < 5; i++) {
+                TimeFrame(timer, {"Shadows", "Lighting", "Postprocessing"});
+                timer.finishFrame();
+                auto timings = timer.collectFrame();
+                EA_EXPECT(timings.has_value());
+                statistics.addPassTimings(*timings);
+            }
+
+            EA_EXPECT(statistics.passNames() == std::vector<std::string>({"Lighting", "Postprocessing", "Shadows"}));
+
+            auto shadows = statistics.passSummary("Shadows");
+            EA_EXPECT(shadows.sampleCount == 5);
+            EA_EXPECT_NEAR(shadows.average, 2.0, 1e-9);
+            EA_EXPECT_NEAR(statistics.passSummary("Lighting").maximum, 3.0, 1e-9);
+
+            // Passes without a configured duration take no time
+            EA_EXPECT_NEAR(statistics.passSummary("Postprocessing").maximum, 0.0, 1e-9);
+            EA_EXPECT(statistics.passSummary("Bloom").sampleCount == 0);
+        });
+
+        runner.add("FrameStatistics/Passes/NestedPassesAreRejected", [] {
+            MockPassTimer timer;
+            timer.beginPass("Shadows");
+            EA_EXPECT_THROWS(timer.beginPass("Lighting"), std::logic_error);
+            timer.endPass();
+            EA_EXPECT_THROWS(timer.endPass(), std::logic_error);
+        });
+
+        runner.add("FrameMeter/Passes/TimingsArriveAfterTimerLatency", [] {
+            MockPassTimer timer(2);
+            timer.setPassDuration("Lighting", 4.0);
+
+            FrameMeter meter;
+            meter.setPassTimer(&timer);
+
+            for (int frame = 1; frame <= 5; frame++) {
+                TimeFrame(timer, {"Lighting"});
+                meter.tick();
+
+                // Every tick finishes a frame, results lag two frames behind
+                size_t expectedSampleCount = frame > 2 ? frame - 2 : 0;
+                EA_EXPECT(meter.statistics().passSummary("Lighting").sampleCount == expectedSampleCount);
+            }
+
+            EA_EXPECT_NEAR(meter.statistics().passSummary("Lighting").average, 4.0, 1e-9);
+
+            // Frame times are measured between ticks
+            EA_EXPECT(meter.statistics().frameCount() == 4);
+        });
+    }
+
+}
@@ -0,0 +1,24 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_FRAMESTATISTICSTESTS_HPP
+#define EARENDERER_FRAMESTATISTICSTESTS_HPP
+
+#include "TestRunner.hpp"
+#include "BenchmarkSceneLibrary.hpp"
+
+namespace EARenderer {
+
+    /**
+     Frame time distributions, spike detection and pass timings delivered by a pass timer with latency
+     */
+    class FrameStatisticsTests {
+    public:
+        static void Register(TestRunner &runner, BenchmarkSceneLibrary &scenes);
+    };
+
+}
+
+#endif //EARENDERER_FRAMESTATISTICSTESTS_HPP
@@ -0,0 +1,223 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "GLProgramBinaryCacheTests.hpp"
+#include "TestAssertions.hpp"
+#include "TestFileSystem.hpp"
+#include "GLProgramBinaryCache.hpp"
+#include "GLProgramBinaryFileStorage.hpp"
+#include "StringUtils.hpp"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace EARenderer {
+
+#pragma mark - Helpers
+
+    /**
+     Keeps entries in memory and counts reads as uses, so eviction order is deterministic
+     */
+    class InMemoryProgramBinaryStorage : public GLProgramBinaryStorage {
+    private:
+        struct StoredEntry {
+            std::vector<uint8_t> bytes;
+            int64_t lastUseTime = 0;
+        };
+
+        int64_t mClock = 0;
+
+    public:
+        std::map<std::string, StoredEntry> storedEntries;
+
+        bool read(const std::string &name, std::vector<uint8_t> &bytes) override {
+            auto it = storedEntries.find(name);
+            if (it == storedEntries.end()) {
+                return false;
+            }
+            bytes = it->second.bytes;
+            it->second.lastUseTime = ++mClock;
+            return true;
+        }
+
+        void write(const std::string &name, const std::vector<uint8_t> &bytes) override {
+            storedEntries[name] = StoredEntry{bytes, ++mClock};
+        }
+
+        void remove(const std::string &name) override {
+            storedEntries.erase(name);
+        }
+
+        std::vector<Entry> entries() const override {
+            std::vector<Entry> entries;
+            for (auto &storedEntry : storedEntries) {
+                entries.push_back(Entry{storedEntry.first, storedEntry.second.bytes.size(), storedEntry.second.lastUseTime});
+            }
+            return entries;
+        }
+    };
+
+    struct CacheFixture {
+        GLProgramBinaryCache cache;
+        // Owned by the cache
+        InMemoryProgramBinaryStorage *storage;
+
+        CacheFixture() {
+            auto storage = std::make_unique<InMemoryProgramBinaryStorage>();
+            this->storage = storage.get();
+            cache.setStorage(std::move(storage));
+            cache.setDriverIdentity("Vendor", "Renderer", "4.1");
+        }
+    };
+
+    static GLProgramBinaryCache::Binary MakeBinary(uint32_t format, size_t size, uint8_t seed) {
+        GLProgramBinaryCache::Binary binary;
+        binary.format = format;
+        for (size_t i = 0; i < size; i++) {
+            binary.data.push_back(uint8_t(seed + i));
+        }
+        return binary;
+    }
+
+    static std::string EntryName(uint64_t key) {
+        return string_format("%016llx.bin", (unsigned long long) key);
+    }
+
+    static uint64_t SourceKey(const GLProgramBinaryCache &cache, const std::string &vertexSource, const std::string &fragmentSource,
+                              const GLSLPreprocessor::Defines &defines = {}) {
+        GLSLPreprocessor::Output vertex{vertexSource, {}};
+        GLSLPreprocessor::Output fragment{fragmentSource, {}};
+        return cache.key({&vertex, nullptr, &fragment}, defines);
+    }
+
+#pragma mark - Registration
+
+    void GLProgramBinaryCacheTests::Register(TestRunner &runner, BenchmarkSceneLibrary &scenes) {
+        runner.add("GLProgramBinaryCache/StoredBinaryIsLoaded", [] {
+            CacheFixture fixture;
+            uint64_t key = SourceKey(fixture.cache, "vertex", "fragment");
+            auto binary = MakeBinary(7, 256, 3);
+
+            GLProgramBinaryCache::Binary loaded;
+            EA_EXPECT(!fixture.cache.load(key, loaded));
+
+            fixture.cache.store(key, binary);
+            EA_EXPECT(fixture.cache.load(key, loaded));
+            EA_EXPECT(loaded.format == binary.format);
+            EA_EXPECT(loaded.data == binary.data);
+        });
+
+        runner.add("GLProgramBinaryCache/DisabledWithoutStorage", [] {
+            GLProgramBinaryCache cache;
+            EA_EXPECT(!cache.isEnabled());
+
+            cache.store(1, MakeBinary(1, 16, 0));
+            GLProgramBinaryCache::Binary loaded;
+            EA_EXPECT(!cache.load(1, loaded));
+        });
+
+        runner.add("GLProgramBinaryCache/KeyCoversSourcesDefinesAndDriver", [] {
+            CacheFixture fixture;
+            auto &cache = fixture.cache;
+            uint64_t key = SourceKey(cache, "vertex", "fragment");
+
+            EA_EXPECT(SourceKey(cache, "vertex", "fragment") == key);
+            EA_EXPECT(SourceKey(cache, "vertex", "fragment2") != key);
+            EA_EXPECT(SourceKey(cache, "vertexfragment", "") != key);
+            EA_EXPECT(SourceKey(cache, "vertex", "fragment", {{"SHADOWS", ""}}) != key);
+
+            // An absent stage differs from an empty one
+            GLSLPreprocessor::Output vertex{"vertex", {}};
+            GLSLPreprocessor::Output empty{"", {}};
+            EA_EXPECT(cache.key({&vertex, nullptr}, {}) != cache.key({&vertex, &empty}, {}));
+
+            cache.setDriverIdentity("Vendor", "Renderer", "4.2");
+            EA_EXPECT(SourceKey(cache, "vertex", "fragment") != key);
+        });
+
+        runner.add("GLProgramBinaryCache/CorruptEntriesAreRemoved", [] {
+            CacheFixture fixture;
+            fixture.cache.store(1, MakeBinary(1, 64, 0));
+            fixture.cache.store(2, MakeBinary(1, 64, 0));
+            EA_EXPECT(fixture.storage->storedEntries.size() == 2);
+
+            // Truncate the first entry and put a copy of it under the name of the second one
+            auto &entries = fixture.storage->storedEntries;
+            auto validBytes = entries[EntryName(1)].bytes;
+            entries[EntryName(1)].bytes.resize(validBytes.size() / 2);
+            entries[EntryName(2)].bytes = validBytes;
+
+            GLProgramBinaryCache::Binary loaded;
+            EA_EXPECT(!fixture.cache.load(1, loaded));
+            EA_EXPECT(loaded.data.empty());
+            EA_EXPECT(!fixture.cache.load(2, loaded));
+            EA_EXPECT(entries.empty());
+        });
+
+        runner.add("GLProgramBinaryCache/RejectedEntriesAreRemoved", [] {
+            CacheFixture fixture;
+            fixture.cache.store(1, MakeBinary(1, 64, 0));
+            fixture.cache.reject(1);
+
+            GLProgramBinaryCache::Binary loaded;
+            EA_EXPECT(!fixture.cache.load(1, loaded));
+            EA_EXPECT(fixture.storage->storedEntries.empty());
+            EA_EXPECT(fixture.cache.statistics().rejections == 1);
+        });
+
+        runner.add("GLProgramBinaryCache/LeastRecentlyUsedEntriesAreEvicted", [] {
+            CacheFixture fixture;
+            GLProgramBinaryCache::Binary loaded;
+
+            fixture.cache.store(1, MakeBinary(1, 100, 0));
+            fixture.cache.store(2, MakeBinary(1, 100, 0));
+            size_t entrySize = fixture.storage->storedEntries.begin()->second.bytes.size();
+            fixture.cache.setCapacity(entrySize * 2);
+
+            // Using the first entry makes the second one the least recently used
+            EA_EXPECT(fixture.cache.load(1, loaded));
+            fixture.cache.store(3, MakeBinary(1, 100, 0));
+
+            EA_EXPECT(fixture.storage->storedEntries.size() == 2);
+            EA_EXPECT(fixture.cache.load(1, loaded));
+            EA_EXPECT(!fixture.cache.load(2, loaded));
+            EA_EXPECT(fixture.cache.load(3, loaded));
+            EA_EXPECT(fixture.cache.statistics().evictions == 1);
+
+            // An entry larger than the capacity is still kept until something else is stored
+            fixture.cache.setCapacity(entrySize / 2);
+            fixture.cache.store(4, MakeBinary(1, 100, 0));
+            EA_EXPECT(fixture.storage->storedEntries.size() == 1);
+            EA_EXPECT(fixture.cache.load(4, loaded));
+        });
+
+        runner.add("GLProgramBinaryFileStorage/EntriesSkipTemporaryFiles", [] {
+            std::string directory = MakeTemporaryDirectory();
+            GLProgramBinaryFileStorage storage(directory + "ProgramBinaries");
+            std::vector<uint8_t> bytes{1, 2, 3, 4, 5};
+
+            storage.write("0123.bin", bytes);
+            EA_EXPECT(!FileExists(directory + "ProgramBinaries/0123.bin.tmp"));
+
+            // Left behind by an interrupted write
+            WriteFile(directory + "ProgramBinaries/4567.bin.tmp", "partial");
+
+            auto entries = storage.entries();
+            EA_EXPECT(entries.size() == 1);
+            EA_EXPECT(entries.size() == 1 && entries[0].name == "0123.bin" && entries[0].size == bytes.size());
+
+            std::vector<uint8_t> readBytes;
+            EA_EXPECT(storage.read("0123.bin", readBytes));
+            EA_EXPECT(readBytes == bytes);
+            EA_EXPECT(!storage.read("4567.bin", readBytes));
+
+            storage.remove("0123.bin");
+            EA_EXPECT(storage.entries().empty());
+        });
+    }
+
+}
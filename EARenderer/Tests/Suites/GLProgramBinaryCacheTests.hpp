@@ -0,0 +1,24 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_GLPROGRAMBINARYCACHETESTS_HPP
+#define EARENDERER_GLPROGRAMBINARYCACHETESTS_HPP
+
+#include "TestRunner.hpp"
+#include "BenchmarkSceneLibrary.hpp"
+
+namespace EARenderer {
+
+    /**
+     Program binary cache returns only entries stored under the same key and keeps its storage within capacity
+     */
+    class GLProgramBinaryCacheTests {
+    public:
+        static void Register(TestRunner &runner, BenchmarkSceneLibrary &scenes);
+    };
+
+}
+
+#endif //EARENDERER_GLPROGRAMBINARYCACHETESTS_HPP
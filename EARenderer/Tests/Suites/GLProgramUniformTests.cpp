@@ -0,0 +1,151 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "GLProgramUniformTests.hpp"
+#include "TestAssertions.hpp"
+#include "TestFileSystem.hpp"
+#include "ScopedGLBackend.hpp"
+#include "GLProgram.hpp"
+#include "GLRecordingBackend.hpp"
+#include "FileManager.hpp"
+#include "CRC32.hpp"
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/gtx/transform.hpp>
+
+#include <array>
+
+namespace EARenderer {
+
+#pragma mark - Helpers
+
+    static const char *VertexSource =
+            "#version 410 core\n"
+            "uniform mat4 uModelMatrix;\n"
+            "uniform mat4 uMatrices[2];\n"
+            "uniform float uScale;\n"
+            "void main() {\n"
+            "    gl_Position = uMatrices[0] * uMatrices[1] * uModelMatrix * vec4(uScale);\n"
+            "}\n";
+
+    static const char *FragmentSource =
+            "#version 410 core\n"
+            "uniform vec3 uColors[3];\n"
+            "out vec4 oFragColor;\n"
+            "void main() {\n"
+            "    oFragColor = vec4(uColors[0] + uColors[1] + uColors[2], 1.0);\n"
+            "}\n";
+
+    /**
+     Exposes uniform setters of a program built from the sources above
+     */
+    class UniformTestProgram : public GLProgram {
+    public:
+        UniformTestProgram()
+                : GLProgram("UniformTest.vert", "UniformTest.frag", "") {
+        }
+
+        using GLProgram::setUniform1f;
+        using GLProgram::setUniform3fv;
+        using GLProgram::setUniformMatrix4fv;
+    };
+
+    static std::unique_ptr<UniformTestProgram> MakeProgram() {
+        std::string directory = MakeTemporaryDirectory();
+        WriteFile(directory + "UniformTest.vert", VertexSource);
+        WriteFile(directory + "UniformTest.frag", FragmentSource);
+        FileManager::shared().setResourceRootPath(directory);
+
+        auto program = std::make_unique<UniformTestProgram>();
+        program->bind();
+        return program;
+    }
+
+    /**
+     @return matrix whose transpose differs from itself
+     */
+    static glm::mat4 AsymmetricMatrix() {
+        return glm::translate(glm::vec3(1.0, 2.0, 3.0)) * glm::scale(glm::vec3(4.0, 5.0, 6.0));
+    }
+
+#pragma mark - Registration
+
+    void GLProgramUniformTests::Register(TestRunner &runner, BenchmarkSceneLibrary &scenes) {
+        runner.add("GLProgram/Uniforms/RepeatedValuesAreSkipped", [] {
+            auto program = MakeProgram();
+            GLRecordingBackend backend;
+            ScopedGLBackend scopedBackend(&backend);
+
+            program->setUniform1f(ctcrc32("uScale"), 1.0);
+            program->setUniform1f(ctcrc32("uScale"), 1.0);
+            EA_EXPECT(backend.uniformUploadCount() == 1);
+
+            program->setUniform1f(ctcrc32("uScale"), 2.0);
+            program->setUniform1f(ctcrc32("uScale"), 2.0);
+            EA_EXPECT(backend.uniformUploadCount() == 2);
+
+            glm::mat4 model = AsymmetricMatrix();
+            for (int i = 0; i < 3; i++) {
+                program->setUniformMatrix4fv(ctcrc32("uModelMatrix"), 1, GL_FALSE, glm::value_ptr(model));
+            }
+            EA_EXPECT(backend.uniformUploadCount() == 3);
+
+            auto &statistics = program->uniformStatistics();
+            EA_EXPECT(statistics.uploads == 3);
+            EA_EXPECT(statistics.skippedUploads == 4);
+        });
+
+        runner.add("GLProgram/Uniforms/ArrayUploadsCompareWrittenElements", [] {
+            auto program = MakeProgram();
+            GLRecordingBackend backend;
+            ScopedGLBackend scopedBackend(&backend);
+
+            std::array<glm::vec3, 3> colors{glm::vec3(1.0, 0.0, 0.0), glm::vec3(0.0, 1.0, 0.0), glm::vec3(0.0, 0.0, 1.0)};
+            program->setUniform3fv(ctcrc32("uColors[0]"), 3, glm::value_ptr(colors[0]));
+            program->setUniform3fv(ctcrc32("uColors[0]"), 3, glm::value_ptr(colors[0]));
+            EA_EXPECT(backend.uniformUploadCount() == 1);
+
+            // A shorter upload matching the first elements leaves the uniform as it is
+            program->setUniform3fv(ctcrc32("uColors[0]"), 1, glm::value_ptr(colors[0]));
+            EA_EXPECT(backend.uniformUploadCount() == 1);
+
+            colors[0] = glm::vec3(0.5);
+            program->setUniform3fv(ctcrc32("uColors[0]"), 1, glm::value_ptr(colors[0]));
+            EA_EXPECT(backend.uniformUploadCount() == 2);
+
+            // The rest of the array still holds the values uploaded first
+            program->setUniform3fv(ctcrc32("uColors[0]"), 3, glm::value_ptr(colors[0]));
+            EA_EXPECT(backend.uniformUploadCount() == 2);
+        });
+
+        runner.add("GLProgram/Uniforms/TransposedMatricesAreShadowed", [] {
+            auto program = MakeProgram();
+            GLRecordingBackend backend;
+            ScopedGLBackend scopedBackend(&backend);
+
+            std::array<glm::mat4, 2> matrices{AsymmetricMatrix(), glm::rotate(0.5f, glm::vec3(0.0, 1.0, 0.0))};
+            std::array<glm::mat4, 2> transposedMatrices{glm::transpose(matrices[0]), glm::transpose(matrices[1])};
+
+            program->setUniformMatrix4fv(ctcrc32("uMatrices[0]"), 2, GL_TRUE, glm::value_ptr(transposedMatrices[0]));
+            EA_EXPECT(backend.uniformUploadCount() == 1);
+
+            // Both describe the value already held by the uniform
+            program->setUniformMatrix4fv(ctcrc32("uMatrices[0]"), 2, GL_TRUE, glm::value_ptr(transposedMatrices[0]));
+            program->setUniformMatrix4fv(ctcrc32("uMatrices[0]"), 2, GL_FALSE, glm::value_ptr(matrices[0]));
+            EA_EXPECT(backend.uniformUploadCount() == 1);
+
+            program->setUniformMatrix4fv(ctcrc32("uMatrices[0]"), 2, GL_FALSE, glm::value_ptr(transposedMatrices[0]));
+            EA_EXPECT(backend.uniformUploadCount() == 2);
+
+            // Uploads reach OpenGL in column-major order
+            for (auto &command : backend.commands()) {
+                EA_EXPECT(command.function != GLRecordingBackend::Function::UniformMatrix4fv || command.arguments[2] == GL_FALSE);
+            }
+        });
+    }
+
+}
@@ -0,0 +1,24 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_GLPROGRAMUNIFORMTESTS_HPP
+#define EARENDERER_GLPROGRAMUNIFORMTESTS_HPP
+
+#include "TestRunner.hpp"
+#include "BenchmarkSceneLibrary.hpp"
+
+namespace EARenderer {
+
+    /**
+     Programs upload a uniform only when its value differs from the one the program already holds
+     */
+    class GLProgramUniformTests {
+    public:
+        static void Register(TestRunner &runner, BenchmarkSceneLibrary &scenes);
+    };
+
+}
+
+#endif //EARENDERER_GLPROGRAMUNIFORMTESTS_HPP
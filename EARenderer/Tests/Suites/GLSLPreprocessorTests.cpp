@@ -0,0 +1,222 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "GLSLPreprocessorTests.hpp"
+#include "TestAssertions.hpp"
+#include "TestFileSystem.hpp"
+#include "GLSLPreprocessor.hpp"
+#include "StringUtils.hpp"
+
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+
+namespace EARenderer {
+
+#pragma mark - Helpers
+
+    static std::vector<std::string> Lines(const std::string &text) {
+        std::vector<std::string> lines;
+        std::istringstream stream(text);
+        std::string line;
+        while (std::getline(stream, line)) {
+            lines.push_back(line);
+        }
+        return lines;
+    }
+
+    static size_t OccurrenceCount(const std::string &text, const std::string &substring) {
+        size_t count = 0;
+        for (size_t position = text.find(substring); position != std::string::npos; position = text.find(substring, position + 1)) {
+            count++;
+        }
+        return count;
+    }
+
+    /**
+     Checks that every line following a #line directive is the line of the file the directive points to
+     */
+    static void ExpectLinesMapToFiles(const GLSLPreprocessor::Output &output) {
+        std::vector<std::vector<std::string>> fileLines;
+        for (auto &file : output.files) {
+            fileLines.push_back(Lines(ReadFile(file)));
+        }
+
+        size_t fileIndex = output.files.size();
+        size_t lineNumber = 0;
+
+        for (auto &line : Lines(output.source)) {
+            unsigned directiveLine = 0;
+            unsigned directiveFile = 0;
+            if (sscanf(line.c_str(), "#line %u %u", &directiveLine, &directiveFile) == 2) {
+                EA_EXPECT(directiveFile < output.files.size());
+                fileIndex = directiveFile;
+                lineNumber = directiveLine;
+                continue;
+            }
+
+            // #version and injected defines precede the first #line directive
+            if (fileIndex == output.files.size()) {
+                continue;
+            }
+
+            auto &lines = fileLines[fileIndex];
+            if (lineNumber == 0 || lineNumber > lines.size() || lines[lineNumber - 1] != line) {
+                FailExpectation(string_format("'%s' is not line %zu of %s", line.c_str(), lineNumber, output.files[fileIndex].c_str()),
+                        __FILE__, __LINE__);
+            }
+            lineNumber++;
+        }
+    }
+
+#pragma mark - Registration
+
+    void GLSLPreprocessorTests::Register(TestRunner &runner, BenchmarkSceneLibrary &scenes) {
+        runner.add("GLSLPreprocessor/Includes/ResolvedRelativeToIncludingFile", [] {
+            std::string directory = MakeTemporaryDirectory();
+            mkdir((directory + "Common").c_str(), 0700);
+            WriteFile(directory + "Common/Lighting.glsl", "#include \"Math.glsl\"\nfloat lighting;\n");
+            WriteFile(directory + "Common/Math.glsl", "float math;\n");
+            WriteFile(directory + "Main.frag", "#version 400 core\n#include \"Common/Lighting.glsl\"\nvoid main() {}\n");
+
+            GLSLPreprocessor preprocessor;
+            auto output = preprocessor.preprocess(directory + "Main.frag");
+
+            EA_EXPECT(output->files.size() == 3);
+            EA_EXPECT(output->files[1] == directory + "Common/Lighting.glsl");
+            EA_EXPECT(output->files[2] == directory + "Common/Math.glsl");
+            EA_EXPECT(output->source.find("#include") == std::string::npos);
+            EA_EXPECT(output->source.find("float math;") < output->source.find("float lighting;"));
+            EA_EXPECT(output->source.find("float lighting;") < output->source.find("void main() {}"));
+        });
+
+        runner.add("GLSLPreprocessor/Includes/IncludedOncePerSource", [] {
+            std::string directory = MakeTemporaryDirectory();
+            WriteFile(directory + "Shared.glsl", "float shared;\n");
+            WriteFile(directory + "A.glsl", "#include \"Shared.glsl\"\nfloat a;\n");
+            WriteFile(directory + "B.glsl", "#include \"Shared.glsl\"\n#include \"A.glsl\"\nfloat b;\n");
+            WriteFile(directory + "Main.vert", "#version 400 core\n#include \"A.glsl\"\n#include \"B.glsl\"\n#include \"Main.vert\"\nvoid main() {}\n");
+
+            GLSLPreprocessor preprocessor;
+            auto output = preprocessor.preprocess(directory + "Main.vert");
+
+            EA_EXPECT(OccurrenceCount(output->source, "float shared;") == 1);
+            EA_EXPECT(OccurrenceCount(output->source, "float a;") == 1);
+            EA_EXPECT(OccurrenceCount(output->source, "void main() {}") == 1);
+            EA_EXPECT(output->files.size() == 4);
+        });
+
+        runner.add("GLSLPreprocessor/Includes/CommentedOutIncludesAreKept", [] {
+            std::string directory = MakeTemporaryDirectory();
+            WriteFile(directory + "Main.frag", "#version 400 core\n/*\n#include \"Missing.glsl\"\n*/\n// #include \"Missing.glsl\"\nvoid main() {}\n");
+
+            GLSLPreprocessor preprocessor;
+            auto output = preprocessor.preprocess(directory + "Main.frag");
+
+            EA_EXPECT(output->files.size() == 1);
+            EA_EXPECT(OccurrenceCount(output->source, "#include \"Missing.glsl\"") == 2);
+        });
+
+        runner.add("GLSLPreprocessor/Includes/MissingFileThrows", [] {
+            std::string directory = MakeTemporaryDirectory();
+            WriteFile(directory + "Main.frag", "#version 400 core\n#include \"Missing.glsl\"\nvoid main() {}\n");
+
+            GLSLPreprocessor preprocessor;
+            EA_EXPECT_THROWS(preprocessor.preprocess(directory + "Main.frag"), std::runtime_error);
+            EA_EXPECT_THROWS(preprocessor.preprocess(directory + "Absent.frag"), std::invalid_argument);
+        });
+
+        runner.add("GLSLPreprocessor/Defines/InjectedAfterVersion", [] {
+            std::string directory = MakeTemporaryDirectory();
+            WriteFile(directory + "Main.frag", "// Header comment\n#version 400 core\nvoid main() {}\n");
+
+            GLSLPreprocessor preprocessor;
+            auto output = preprocessor.preprocess(directory + "Main.frag", {{"SHADOWS", ""}, {"CASCADES", "4"}});
+            auto lines = Lines(output->source);
+
+            EA_EXPECT(lines.size() >= 3);
+            EA_EXPECT(lines[0] == "#version 400 core");
+            // Definitions are ordered by name
+            EA_EXPECT(lines[1] == "#define CASCADES 4");
+            EA_EXPECT(lines[2] == "#define SHADOWS");
+            EA_EXPECT(OccurrenceCount(output->source, "#version") == 1);
+        });
+
+        runner.add("GLSLPreprocessor/Defines/OutputsCachedPerDefineSet", [] {
+            std::string directory = MakeTemporaryDirectory();
+            WriteFile(directory + "Main.frag", "#version 400 core\nvoid main() {}\n");
+
+            GLSLPreprocessor::Defines defines;
+            defines.set("B", "2");
+            defines.set("A", "1");
+            GLSLPreprocessor::Defines reordered{{"A", "1"}, {"B", "2"}};
+            GLSLPreprocessor::Defines other{{"A", "1"}, {"B", "3"}};
+
+            EA_EXPECT(defines.hash() == reordered.hash());
+            EA_EXPECT(defines.hash() != other.hash());
+            EA_EXPECT(GLSLPreprocessor::Defines({{"AB", ""}}).hash() != GLSLPreprocessor::Defines({{"A", "B"}}).hash());
+
+            GLSLPreprocessor preprocessor;
+            auto output = preprocessor.preprocess(directory + "Main.frag", defines);
+            EA_EXPECT(preprocessor.preprocess(directory + "Main.frag", reordered) == output);
+            EA_EXPECT(preprocessor.preprocess(directory + "Main.frag", other) != output);
+            EA_EXPECT(preprocessor.preprocess(directory + "Main.frag")->source.find("#define") == std::string::npos);
+        });
+
+        runner.add("GLSLPreprocessor/LineMapping/LinesMapToOriginalFiles", [] {
+            std::string directory = MakeTemporaryDirectory();
+            WriteFile(directory + "Lighting.glsl", "// Lighting\n\nfloat lighting() {\n    return 1.0;\n}\n");
+            WriteFile(directory + "Main.frag",
+                    "#version 400 core\n"
+                    "\n"
+                    "in vec2 vTexCoords;\n"
+                    "/* Block\n"
+                    "   comment */\n"
+                    "#include \"Lighting.glsl\"\n"
+                    "out vec4 oFragColor;\n"
+                    "#include \"Lighting.glsl\"\n"
+                    "void main() {\n"
+                    "    oFragColor = vec4(lighting());\n"
+                    "}\n");
+
+            GLSLPreprocessor preprocessor;
+            auto output = preprocessor.preprocess(directory + "Main.frag", {{"QUALITY", "2"}});
+
+            EA_EXPECT(output->files.size() == 2);
+            EA_EXPECT(output->source.find("#line 7 0\nout vec4 oFragColor;") != std::string::npos);
+            EA_EXPECT(output->source.find("#line 1 1\n// Lighting") != std::string::npos);
+            ExpectLinesMapToFiles(*output);
+        });
+
+        runner.add("GLSLPreprocessor/Cache/ChangedIncludeIsReparsed", [] {
+            std::string directory = MakeTemporaryDirectory();
+            WriteFile(directory + "Shared.glsl", "float shared;\n");
+            WriteFile(directory + "Other.glsl", "float other;\n");
+            WriteFile(directory + "Main.frag", "#version 400 core\n#include \"Shared.glsl\"\nvoid main() {}\n");
+
+            GLSLPreprocessor preprocessor;
+            auto output = preprocessor.preprocess(directory + "Main.frag");
+            EA_EXPECT(preprocessor.preprocess(directory + "Main.frag") == output);
+
+            auto includers = preprocessor.includers(directory + "Shared.glsl");
+            EA_EXPECT(includers.size() == 1 && includers.count(directory + "Main.frag") == 1);
+            EA_EXPECT(preprocessor.includers(directory + "Other.glsl").empty());
+
+            // Size changes even if the modification time stays within the same second
+            WriteFile(directory + "Shared.glsl", "float sharedAndChanged;\n");
+            auto changedOutput = preprocessor.preprocess(directory + "Main.frag");
+            EA_EXPECT(changedOutput != output);
+            EA_EXPECT(changedOutput->source.find("float sharedAndChanged;") != std::string::npos);
+
+            preprocessor.invalidate(directory + "Shared.glsl");
+            EA_EXPECT(preprocessor.preprocess(directory + "Main.frag") != changedOutput);
+        });
+    }
+
+}
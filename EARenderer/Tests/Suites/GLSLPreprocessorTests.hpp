@@ -0,0 +1,24 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_GLSLPREPROCESSORTESTS_HPP
+#define EARENDERER_GLSLPREPROCESSORTESTS_HPP
+
+#include "TestRunner.hpp"
+#include "BenchmarkSceneLibrary.hpp"
+
+namespace EARenderer {
+
+    /**
+     Assembled shader sources resolve includes, inject defines and map every line back to its file
+     */
+    class GLSLPreprocessorTests {
+    public:
+        static void Register(TestRunner &runner, BenchmarkSceneLibrary &scenes);
+    };
+
+}
+
+#endif //EARENDERER_GLSLPREPROCESSORTESTS_HPP
@@ -0,0 +1,290 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "IndirectLightUpdateSchedulerTests.hpp"
+#include "TestAssertions.hpp"
+#include "IndirectLightUpdateScheduler.hpp"
+#include "FrustumCascades.hpp"
+#include "StringUtils.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <set>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace EARenderer {
+
+#pragma mark - Helpers
+
+    using Plan = IndirectLightUpdateScheduler::Plan;
+    using RowRange = IndirectLightUpdateScheduler::RowRange;
+    using ProbeBrick = IndirectLightUpdateScheduler::ProbeBrick;
+
+    // Sweeps over all the data after a lighting change when light bounces between surfels and probes
+    static constexpr size_t MultibounceSweepCount = 3;
+
+    static IndirectLightUpdateScheduler::LightingState SunLightingState() {
+        IndirectLightUpdateScheduler::LightingState state;
+        state.sunDirection = glm::vec3(0.0, -1.0, 0.0);
+        state.sunColor = glm::vec3(1.0);
+        state.sunEnabled = true;
+        state.ambientColor = glm::vec3(0.1);
+        return state;
+    }
+
+    /**
+     Cascades split along the world Y axis, so that positions select cascades by their height
+     */
+    static FrustumCascades HeightCascades(const std::vector<float> &splits) {
+        FrustumCascades cascades;
+        cascades.splits = splits;
+        cascades.splitAxis = FrustumCascades::SplitAxis::Y;
+        cascades.splitSpaceMatrix = glm::mat4(1.0);
+        cascades.lightViewProjections = std::vector<glm::mat4>(splits.size(), glm::mat4(1.0));
+        cascades.amount = uint8_t(splits.size());
+        return cascades;
+    }
+
+    static IndirectLightUpdateScheduler::Budget UnlimitedBudget() {
+        IndirectLightUpdateScheduler::Budget budget;
+        budget.surfelsPerFrame = 1 << 16;
+        budget.probesPerFrame = 1 << 12;
+        return budget;
+    }
+
+    /**
+     A single slice and a single brick every frame
+     */
+    static IndirectLightUpdateScheduler::Budget MinimalBudget() {
+        IndirectLightUpdateScheduler::Budget budget;
+        budget.surfelsPerFrame = 1;
+        budget.probesPerFrame = 1;
+        return budget;
+    }
+
+    /**
+     Plans frames until nothing is scheduled
+
+     @return non-empty plans
+     */
+    static std::vector<Plan> PlansUntilConverged(IndirectLightUpdateScheduler &scheduler, const IndirectLightUpdateScheduler::LightingState &state,
+                                                 const IndirectLightUpdateScheduler::Budget &budget) {
+        std::vector<Plan> plans;
+        for (;;) {
+            Plan plan = scheduler.plan(state, glm::vec3(0.0), budget);
+            if (plan.empty()) {
+                return plans;
+            }
+            plans.push_back(plan);
+            if (plans.size() > 10000) {
+                FailExpectation("Scheduler doesn't converge", __FILE__, __LINE__);
+            }
+        }
+    }
+
+    static size_t PlanUntilConverged(IndirectLightUpdateScheduler &scheduler, const IndirectLightUpdateScheduler::LightingState &state) {
+        return PlansUntilConverged(scheduler, state, UnlimitedBudget()).size();
+    }
+
+    static std::set<uint32_t> Rows(const std::vector<RowRange> &ranges) {
+        std::set<uint32_t> rows;
+        for (auto &range : ranges) {
+            for (uint32_t row = range.firstRow; row < range.firstRow + range.rowCount; row++) {
+                rows.insert(row);
+            }
+        }
+        return rows;
+    }
+
+    static std::array<uint32_t, 3> BrickKey(const ProbeBrick &brick) {
+        return {brick.origin.x, brick.origin.y, brick.origin.z};
+    }
+
+    static bool Equal(const std::vector<RowRange> &lhs, const std::vector<RowRange> &rhs) {
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), [](const RowRange &l, const RowRange &r) {
+            return l.firstRow == r.firstRow && l.rowCount == r.rowCount;
+        });
+    }
+
+    static bool Equal(const Plan &lhs, const Plan &rhs) {
+        return lhs.isFullUpdate == rhs.isFullUpdate &&
+                Equal(lhs.surfelRows, rhs.surfelRows) &&
+                Equal(lhs.clusterRows, rhs.clusterRows) &&
+                std::equal(lhs.probeBricks.begin(), lhs.probeBricks.end(), rhs.probeBricks.begin(), rhs.probeBricks.end(), [](const ProbeBrick &l, const ProbeBrick &r) {
+                    return l.origin == r.origin && l.size == r.size;
+                });
+    }
+
+#pragma mark - Registration
+
+    void IndirectLightUpdateSchedulerTests::Register(TestRunner &runner, BenchmarkSceneLibrary &scenes) {
+        runner.add("IndirectLightUpdateScheduler/ConvergesUnderStaticLighting", [&scenes] {
+            auto &entry = scenes.bakedEntry(BenchmarkSceneLibrary::CornellRoom);
+            IndirectLightUpdateScheduler scheduler(*entry.surfelData, *entry.probeData);
+            auto state = SunLightingState();
+
+            EA_EXPECT(scheduler.planFullUpdate(state).isFullUpdate);
+            PlanUntilConverged(scheduler, state);
+            EA_EXPECT(scheduler.isConverged());
+            EA_EXPECT(PlanUntilConverged(scheduler, state) == 0);
+        });
+
+        runner.add("IndirectLightUpdateScheduler/TimeSlicedSweepsMatchFullUpdate", [&scenes] {
+            auto &entry = scenes.bakedEntry(BenchmarkSceneLibrary::CornellRoom);
+            IndirectLightUpdateScheduler scheduler(*entry.surfelData, *entry.probeData);
+            auto state = SunLightingState();
+            state.multibounceEnabled = true;
+
+            scheduler.planFullUpdate(state);
+            PlanUntilConverged(scheduler, state);
+
+            auto changedState = state;
+            changedState.sunColor = glm::vec3(0.5);
+            auto plans = PlansUntilConverged(scheduler, changedState, MinimalBudget());
+            EA_EXPECT(scheduler.isConverged());
+
+            IndirectLightUpdateScheduler referenceScheduler(*entry.surfelData, *entry.probeData);
+            Plan fullPlan = referenceScheduler.planFullUpdate(changedState);
+
+            std::map<uint32_t, size_t> surfelRowUpdateCounts;
+            std::set<uint32_t> clusterRows;
+            std::map<std::array<uint32_t, 3>, size_t> lastBrickUpdates;
+            size_t lastSurfelUpdate = 0;
+
+            for (size_t i = 0; i < plans.size(); i++) {
+                for (uint32_t row : Rows(plans[i].surfelRows)) {
+                    surfelRowUpdateCounts[row]++;
+                    lastSurfelUpdate = i;
+                }
+                for (uint32_t row : Rows(plans[i].clusterRows)) {
+                    clusterRows.insert(row);
+                }
+                for (auto &brick : plans[i].probeBricks) {
+                    lastBrickUpdates[BrickKey(brick)] = i;
+                }
+            }
+
+            // Every surfel is relit once per light bounce
+            auto fullSurfelRows = Rows(fullPlan.surfelRows);
+            EA_EXPECT(surfelRowUpdateCounts.size() == fullSurfelRows.size());
+            for (uint32_t row : fullSurfelRows) {
+                EA_EXPECT(surfelRowUpdateCounts[row] == MultibounceSweepCount);
+            }
+
+            EA_EXPECT(clusterRows == Rows(fullPlan.clusterRows));
+
+            // Probes end up gathering the final surfel luminance
+            EA_EXPECT(lastBrickUpdates.size() == fullPlan.probeBricks.size());
+            for (auto &brick : fullPlan.probeBricks) {
+                auto updateIt = lastBrickUpdates.find(BrickKey(brick));
+                EA_EXPECT(updateIt != lastBrickUpdates.end() && updateIt->second >= lastSurfelUpdate);
+            }
+        });
+
+        runner.add("IndirectLightUpdateScheduler/PlansAreDeterministic", [&scenes] {
+            auto &entry = scenes.bakedEntry(BenchmarkSceneLibrary::CornellRoom);
+            IndirectLightUpdateScheduler scheduler(*entry.surfelData, *entry.probeData);
+            IndirectLightUpdateScheduler otherScheduler(*entry.surfelData, *entry.probeData);
+
+            auto state = SunLightingState();
+            state.multibounceEnabled = true;
+
+            IndirectLightUpdateScheduler::PointLightState light;
+            light.lightID = 1;
+            light.position = glm::vec3(0.5, 1.0, 0.0);
+            light.color = glm::vec3(1.0);
+            light.radius = 1.5;
+            light.enabled = true;
+
+            IndirectLightUpdateScheduler::Budget budget;
+            budget.surfelsPerFrame = 8192;
+            budget.probesPerFrame = 128;
+
+            for (uint32_t frame = 0; frame < 200; frame++) {
+                if (frame == 20) {
+                    state.sunColor = glm::vec3(0.8, 0.7, 0.6);
+                }
+                if (frame == 60) {
+                    state.pointLights.push_back(light);
+                }
+
+                // Camera orbits the room, its cascades follow
+                float angle = frame * 0.05f;
+                glm::vec3 cameraPosition(2.0 * std::cos(angle), 1.0, 2.0 * std::sin(angle));
+                auto cascades = HeightCascades({0.5f + 0.5f * std::sin(angle), 100.0f});
+
+                scheduler.updateShadowCascades(cascades);
+                otherScheduler.updateShadowCascades(cascades);
+
+                Plan plan = scheduler.plan(state, cameraPosition, budget);
+                Plan otherPlan = otherScheduler.plan(state, cameraPosition, budget);
+
+                if (!Equal(plan, otherPlan)) {
+                    FailExpectation(string_format("Plans of frame %u differ", frame), __FILE__, __LINE__);
+                }
+            }
+        });
+
+        runner.add("IndirectLightUpdateScheduler/CascadeChangeRelightsAffectedSlicesOnce", [&scenes] {
+            auto &entry = scenes.bakedEntry(BenchmarkSceneLibrary::CornellRoom);
+            IndirectLightUpdateScheduler scheduler(*entry.surfelData, *entry.probeData);
+            auto state = SunLightingState();
+            state.multibounceEnabled = true;
+
+            auto cascades = HeightCascades({1000.0, 2000.0});
+            scheduler.updateShadowCascades(cascades);
+            scheduler.planFullUpdate(state);
+            PlanUntilConverged(scheduler, state);
+
+            // Camera moved, cascades followed it, but every surfel stays in the first cascade
+            cascades.lightViewProjections[0] = glm::translate(glm::mat4(1.0), glm::vec3(1.0, 0.0, 0.0));
+            scheduler.updateShadowCascades(cascades);
+            EA_EXPECT(PlanUntilConverged(scheduler, state) == 0);
+
+            // Surfels under the ceiling fall into the second cascade now
+            float highestSurfel = -std::numeric_limits<float>::max();
+            for (auto &surfel : entry.surfelData->surfels()) {
+                highestSurfel = std::max(highestSurfel, surfel.position.y);
+            }
+            cascades.splits[0] = highestSurfel - 0.01;
+            scheduler.updateShadowCascades(cascades);
+
+            auto plans = PlansUntilConverged(scheduler, state, UnlimitedBudget());
+            EA_EXPECT(!plans.empty());
+            EA_EXPECT(scheduler.isConverged());
+
+            // A single pass over the affected slices rather than a restart of all light bounces
+            std::map<uint32_t, size_t> surfelRowUpdateCounts;
+            for (auto &plan : plans) {
+                for (uint32_t row : Rows(plan.surfelRows)) {
+                    surfelRowUpdateCounts[row]++;
+                }
+            }
+            for (auto &rowUpdateCount : surfelRowUpdateCounts) {
+                EA_EXPECT(rowUpdateCount.second == 1);
+            }
+        });
+
+        runner.add("IndirectLightUpdateScheduler/InvalidateSchedulesUpdate", [&scenes] {
+            auto &entry = scenes.bakedEntry(BenchmarkSceneLibrary::CornellRoom);
+            IndirectLightUpdateScheduler scheduler(*entry.surfelData, *entry.probeData);
+            auto state = SunLightingState();
+
+            scheduler.planFullUpdate(state);
+            PlanUntilConverged(scheduler, state);
+
+            scheduler.invalidate();
+            EA_EXPECT(!scheduler.isConverged());
+            EA_EXPECT(PlanUntilConverged(scheduler, state) > 0);
+            EA_EXPECT(scheduler.isConverged());
+        });
+    }
+
+}
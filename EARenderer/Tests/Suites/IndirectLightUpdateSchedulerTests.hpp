@@ -0,0 +1,24 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_INDIRECTLIGHTUPDATESCHEDULERTESTS_HPP
+#define EARENDERER_INDIRECTLIGHTUPDATESCHEDULERTESTS_HPP
+
+#include "TestRunner.hpp"
+#include "BenchmarkSceneLibrary.hpp"
+
+namespace EARenderer {
+
+    /**
+     Convergence of the indirect light update scheduler and the changes that make it update again
+     */
+    class IndirectLightUpdateSchedulerTests {
+    public:
+        static void Register(TestRunner &runner, BenchmarkSceneLibrary &scenes);
+    };
+
+}
+
+#endif //EARENDERER_INDIRECTLIGHTUPDATESCHEDULERTESTS_HPP
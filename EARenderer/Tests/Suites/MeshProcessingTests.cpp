@@ -0,0 +1,141 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "MeshProcessingTests.hpp"
+#include "TestAssertions.hpp"
+#include "TestFileSystem.hpp"
+#include "ProceduralSceneGenerator.hpp"
+#include "MeshProcessor.hpp"
+#include "MeshLODGenerator.hpp"
+#include "ThreadPool.hpp"
+#include "FileManager.hpp"
+#include "StringUtils.hpp"
+
+#include <cstring>
+
+namespace EARenderer {
+
+#pragma mark - Helpers
+
+    /**
+     @return blobs lacking normals and tangents, as if they were loaded from files lacking them
+     */
+    static std::vector<SubMesh> UnprocessedBlobs(uint32_t seed, uint32_t triangleCount, size_t subMeshCount) {
+        // Blob generation doesn't touch the scene or the storage
+        ProceduralSceneGenerator generator(seed, nullptr, nullptr);
+        std::vector<SubMesh> subMeshes;
+
+        for (size_t i = 0; i < subMeshCount; i++) {
+            subMeshes.push_back(generator.blob(triangleCount / subMeshCount));
+        }
+
+        return subMeshes;
+    }
+
+    static bool BitwiseEqual(const std::vector<SubMesh> &lhs, const std::vector<SubMesh> &rhs) {
+        if (lhs.size() != rhs.size()) {
+            return false;
+        }
+
+        for (size_t i = 0; i < lhs.size(); i++) {
+            auto &lhsVertices = lhs[i].vertices();
+            auto &rhsVertices = rhs[i].vertices();
+            auto &lhsAreas = lhs[i].triangleAreaPrefixSums();
+            auto &rhsAreas = rhs[i].triangleAreaPrefixSums();
+
+            if (lhsVertices.size() != rhsVertices.size() || lhsAreas.size() != rhsAreas.size()) {
+                return false;
+            }
+            if (std::memcmp(lhsVertices.data(), rhsVertices.data(), lhsVertices.size() * sizeof(lhsVertices[0])) != 0) {
+                return false;
+            }
+            if (std::memcmp(lhsAreas.data(), rhsAreas.data(), lhsAreas.size() * sizeof(float)) != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+#pragma mark - Registration
+
+    void MeshProcessingTests::Register(TestRunner &runner, BenchmarkSceneLibrary &scenes) {
+        uint32_t seed = scenes.settings().seed;
+
+        // A single large sub mesh exercises triangle ranges, many small ones exercise sub mesh level parallelism
+        for (size_t subMeshCount : {size_t(1), size_t(16)}) {
+            runner.add(string_format("MeshProcessor/ParallelMatchesSerial/%zu", subMeshCount), [=] {
+                auto unprocessed = UnprocessedBlobs(seed, 20000, subMeshCount);
+
+                ThreadPool serialPool(0);
+                auto serial = unprocessed;
+                MeshProcessor(MeshProcessor::Settings(), &serialPool).process(serial);
+
+                auto parallel = unprocessed;
+                MeshProcessor().process(parallel);
+
+                EA_EXPECT(BitwiseEqual(parallel, serial));
+            });
+        }
+
+        runner.add("MeshLOD/Generate/TrianglesDecrease", [=] {
+            auto subMeshes = UnprocessedBlobs(seed, 10000, 1);
+            MeshProcessor().process(subMeshes);
+
+            SubMesh &subMesh = subMeshes.front();
+            MeshLODGenerator().generate(subMesh);
+
+            EA_EXPECT(subMesh.lodCount() > 1);
+            for (size_t lod = 1; lod < subMesh.lodCount(); lod++) {
+                EA_EXPECT(subMesh.lodVertices(lod).size() < subMesh.lodVertices(lod - 1).size());
+                EA_EXPECT(subMesh.lodVertices(lod).size() % 3 == 0);
+                EA_EXPECT(subMesh.lodError(lod) >= subMesh.lodError(lod - 1));
+            }
+        });
+
+        runner.add("MeshLOD/Cache/FilesLiveUnderCacheRoot", [] {
+            std::string previousCacheRootPath = FileManager::shared().cacheRootPath();
+            std::string directory = MakeTemporaryDirectory();
+            FileManager::shared().setCacheRootPath(directory);
+
+            std::string cachePath = MeshLODGenerator::CacheFilePath("/Models/Chair/mesh.obj");
+            EA_EXPECT(cachePath.compare(0, directory.size(), directory) == 0);
+            EA_EXPECT(cachePath.find('/', directory.size()) == std::string::npos);
+
+            // Same file names in different directories get their own caches
+            EA_EXPECT(cachePath != MeshLODGenerator::CacheFilePath("/Models/Table/mesh.obj"));
+
+            FileManager::shared().setCacheRootPath("");
+            EA_EXPECT(MeshLODGenerator::CacheFilePath("/Models/Chair/mesh.obj").empty());
+
+            FileManager::shared().setCacheRootPath(previousCacheRootPath);
+        });
+
+        runner.add("MeshLOD/Cache/RoundTripLeavesNoTemporaryFile", [=] {
+            auto subMeshes = UnprocessedBlobs(seed, 4000, 2);
+            MeshProcessor().process(subMeshes);
+            auto cachedSubMeshes = subMeshes;
+
+            MeshLODGenerator generator;
+            generator.generate(subMeshes);
+
+            std::string cachePath = MakeTemporaryDirectory() + "mesh.lods";
+            EA_EXPECT(generator.serialize(subMeshes, cachePath));
+            EA_EXPECT(FileExists(cachePath));
+            EA_EXPECT(!FileExists(cachePath + ".tmp"));
+
+            EA_EXPECT(generator.deserialize(cachedSubMeshes, cachePath));
+            for (size_t i = 0; i < subMeshes.size(); i++) {
+                EA_EXPECT(cachedSubMeshes[i].lodCount() == subMeshes[i].lodCount());
+            }
+
+            // A failed write leaves nothing behind
+            std::string unwritablePath = MakeTemporaryDirectory() + "Missing/mesh.lods";
+            EA_EXPECT(!generator.serialize(subMeshes, unwritablePath));
+            EA_EXPECT(!FileExists(unwritablePath));
+            EA_EXPECT(!FileExists(unwritablePath + ".tmp"));
+        });
+    }
+
+}
@@ -0,0 +1,146 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "PackingTests.hpp"
+#include "TestAssertions.hpp"
+#include "AtlasPacker.hpp"
+#include "ThreadPool.hpp"
+#include "StringUtils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace EARenderer {
+
+    static constexpr int BinResolution = 256;
+    static constexpr size_t SizeCount = 2000;
+
+#pragma mark - Helpers
+
+    /**
+     @return sizes with log-uniform sides, in random order
+     */
+    static std::vector<rbp::RectSize> RandomSizes(uint32_t seed, size_t count) {
+        std::mt19937 engine(seed);
+        std::uniform_real_distribution<float> exponent(0.0, 6.0);
+        std::uniform_real_distribution<float> aspect(-1.0, 1.0);
+
+        std::vector<rbp::RectSize> sizes(count);
+        for (auto &size : sizes) {
+            float side = std::exp2(exponent(engine));
+            float stretch = std::exp2(aspect(engine));
+            size.width = std::max(int(side * stretch), 1);
+            size.height = std::max(int(side / stretch), 1);
+        }
+        return sizes;
+    }
+
+    static bool Overlap(const rbp::Rect &lhs, const rbp::Rect &rhs) {
+        return lhs.x < rhs.x + rhs.width && rhs.x < lhs.x + lhs.width &&
+               lhs.y < rhs.y + rhs.height && rhs.y < lhs.y + lhs.height;
+    }
+
+    static void ExpectValidPlacements(const std::vector<rbp::RectSize> &sizes, const AtlasPacker::Result &result) {
+        EA_EXPECT(result.placements.size() == sizes.size());
+
+        std::vector<std::vector<rbp::Rect>> bins(result.report.binCount());
+        for (size_t i = 0; i < sizes.size(); i++) {
+            auto &placement = result.placements[i];
+            if (!placement.isPacked()) {
+                continue;
+            }
+
+            auto &rect = placement.rect;
+            EA_EXPECT(placement.binIndex < bins.size());
+            EA_EXPECT(rect.width == sizes[i].width && rect.height == sizes[i].height);
+            EA_EXPECT(rect.x >= 0 && rect.y >= 0);
+            EA_EXPECT(rect.x + rect.width <= BinResolution && rect.y + rect.height <= BinResolution);
+            bins[placement.binIndex].push_back(rect);
+        }
+
+        for (size_t binIndex = 0; binIndex < bins.size(); binIndex++) {
+            auto &rects = bins[binIndex];
+            for (size_t i = 0; i < rects.size(); i++) {
+                for (size_t j = i + 1; j < rects.size(); j++) {
+                    if (Overlap(rects[i], rects[j])) {
+                        FailExpectation(string_format("Rectangles %zu and %zu of bin %zu overlap", i, j, binIndex), __FILE__, __LINE__);
+                    }
+                }
+            }
+        }
+    }
+
+    static bool Equal(const AtlasPacker::Result &lhs, const AtlasPacker::Result &rhs) {
+        if (lhs.placements.size() != rhs.placements.size() || lhs.report.binCount() != rhs.report.binCount()) {
+            return false;
+        }
+        for (size_t i = 0; i < lhs.placements.size(); i++) {
+            auto &l = lhs.placements[i];
+            auto &r = rhs.placements[i];
+            if (l.binIndex != r.binIndex || l.rect.x != r.rect.x || l.rect.y != r.rect.y ||
+                l.rect.width != r.rect.width || l.rect.height != r.rect.height) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+#pragma mark - Registration
+
+    void PackingTests::Register(TestRunner &runner, BenchmarkSceneLibrary &scenes) {
+        uint32_t seed = scenes.settings().seed;
+
+        for (auto algorithm : {AtlasPacker::Algorithm::Skyline, AtlasPacker::Algorithm::MaxRects}) {
+            const char *algorithmName = algorithm == AtlasPacker::Algorithm::Skyline ? "Skyline" : "MaxRects";
+
+            AtlasPacker::Settings settings;
+            settings.binWidth = BinResolution;
+            settings.binHeight = BinResolution;
+            settings.algorithm = algorithm;
+
+            runner.add(string_format("Packing/AtlasPacker/%s/NoOverlaps", algorithmName), [=] {
+                auto sizes = RandomSizes(seed, SizeCount);
+                auto result = AtlasPacker(settings).pack(sizes);
+
+                ExpectValidPlacements(sizes, result);
+                EA_EXPECT(result.report.unpackedCount == 0);
+                EA_EXPECT(result.report.packedCount == sizes.size());
+            });
+
+            runner.add(string_format("Packing/AtlasPacker/%s/Deterministic", algorithmName), [=] {
+                auto sizes = RandomSizes(seed, SizeCount);
+
+                ThreadPool serialPool(0);
+                ThreadPool pool(4);
+                auto serial = AtlasPacker(settings, &serialPool).pack(sizes);
+                auto parallel = AtlasPacker(settings, &pool).pack(sizes);
+                auto parallelAgain = AtlasPacker(settings, &pool).pack(sizes);
+
+                EA_EXPECT(Equal(serial, parallel));
+                EA_EXPECT(Equal(parallel, parallelAgain));
+            });
+
+            runner.add(string_format("Packing/AtlasPacker/%s/Unpackable", algorithmName), [=] {
+                std::vector<rbp::RectSize> sizes = {
+                        {BinResolution + 1, 1},
+                        {0, 16},
+                        {BinResolution, BinResolution},
+                        {16, 16}
+                };
+                auto result = AtlasPacker(settings).pack(sizes);
+
+                ExpectValidPlacements(sizes, result);
+                EA_EXPECT(!result.placements[0].isPacked());
+                EA_EXPECT(!result.placements[1].isPacked());
+                EA_EXPECT(result.placements[2].isPacked());
+                EA_EXPECT(result.placements[3].isPacked());
+                EA_EXPECT(result.report.unpackedCount == 2);
+                EA_EXPECT(result.report.binCount() == 2);
+            });
+        }
+    }
+
+}
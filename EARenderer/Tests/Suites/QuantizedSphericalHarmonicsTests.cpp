@@ -0,0 +1,114 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "QuantizedSphericalHarmonicsTests.hpp"
+#include "TestAssertions.hpp"
+#include "QuantizedSphericalHarmonics.hpp"
+#include "StringUtils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace EARenderer {
+
+    static constexpr size_t RandomSampleCount = 1000;
+
+#pragma mark - Helpers
+
+    /**
+     @return coefficients whose luma and chroma magnitudes span several orders of magnitude
+     */
+    static SphericalHarmonics RandomSphericalHarmonics(std::mt19937 &engine) {
+        std::uniform_real_distribution<float> exponent(-6.0, 3.0);
+        std::uniform_real_distribution<float> unit(-1.0, 1.0);
+
+        float lumaMagnitude = std::exp2(exponent(engine));
+        float chromaMagnitude = std::exp2(exponent(engine));
+
+        std::array<glm::vec3, 9> coefficients;
+        for (auto &coefficient : coefficients) {
+            coefficient = glm::vec3(unit(engine) * lumaMagnitude, unit(engine) * chromaMagnitude, unit(engine) * chromaMagnitude);
+        }
+        return SphericalHarmonics(coefficients);
+    }
+
+    static void ExpectRoundTrip(const SphericalHarmonics &sphericalHarmonics) {
+        QuantizedSphericalHarmonics quantized(sphericalHarmonics);
+        auto original = sphericalHarmonics.coefficients();
+        auto restored = quantized.dequantized().coefficients();
+        float tolerance = quantized.maximumError();
+
+        for (size_t i = 0; i < original.size(); i++) {
+            for (int component = 0; component < 3; component++) {
+                float error = std::abs(restored[i][component] - original[i][component]);
+                if (!(error <= tolerance)) {
+                    FailExpectation(string_format("Component %d of coefficient %zu is %g instead of %g, exceeding the error bound of %g",
+                            component, i, restored[i][component], original[i][component], tolerance), __FILE__, __LINE__);
+                }
+            }
+        }
+    }
+
+#pragma mark - Registration
+
+    void QuantizedSphericalHarmonicsTests::Register(TestRunner &runner, BenchmarkSceneLibrary &scenes) {
+        uint32_t seed = scenes.settings().seed;
+
+        runner.add("QuantizedSphericalHarmonics/RoundTrip/Random", [=] {
+            std::mt19937 engine(seed);
+            for (size_t i = 0; i < RandomSampleCount; i++) {
+                ExpectRoundTrip(RandomSphericalHarmonics(engine));
+            }
+        });
+
+        runner.add("QuantizedSphericalHarmonics/RoundTrip/Zero", [] {
+            QuantizedSphericalHarmonics quantized{SphericalHarmonics()};
+            EA_EXPECT(quantized.lumaScale() == 0.0);
+            EA_EXPECT(quantized.chromaScale() == 0.0);
+            for (auto &coefficient : quantized.dequantized().coefficients()) {
+                EA_EXPECT(coefficient == glm::vec3(0.0));
+            }
+        });
+
+        // Coefficients equal to the scale are the largest representable ones and must not be clipped
+        runner.add("QuantizedSphericalHarmonics/RoundTrip/Extremes", [] {
+            std::array<glm::vec3, 9> coefficients;
+            for (size_t i = 0; i < coefficients.size(); i++) {
+                float sign = i % 2 ? -1.0 : 1.0;
+                coefficients[i] = glm::vec3(sign * 5.0, -sign * 0.25, sign * 0.25);
+            }
+            ExpectRoundTrip(SphericalHarmonics(coefficients));
+        });
+
+        runner.add("QuantizedSphericalHarmonics/Scales", [=] {
+            std::mt19937 engine(seed);
+            for (size_t i = 0; i < RandomSampleCount; i++) {
+                auto sphericalHarmonics = RandomSphericalHarmonics(engine);
+                QuantizedSphericalHarmonics quantized(sphericalHarmonics);
+
+                float lumaScale = 0.0;
+                float chromaScale = 0.0;
+                for (auto &coefficient : sphericalHarmonics.coefficients()) {
+                    lumaScale = std::max(lumaScale, std::abs(coefficient.x));
+                    chromaScale = std::max({chromaScale, std::abs(coefficient.y), std::abs(coefficient.z)});
+                }
+
+                EA_EXPECT(quantized.lumaScale() == lumaScale);
+                EA_EXPECT(quantized.chromaScale() == chromaScale);
+            }
+        });
+
+        runner.add("QuantizedSphericalHarmonics/ErrorBound", [] {
+            std::array<glm::vec3, 9> coefficients{};
+            coefficients[0] = glm::vec3(2.0, 1.0, -0.5);
+            QuantizedSphericalHarmonics quantized{SphericalHarmonics(coefficients)};
+
+            // Half of the chroma step dominates the half of the luma step
+            EA_EXPECT_NEAR(quantized.maximumError(), 1.0 / (2.0 * QuantizedSphericalHarmonics::ChromaQuantizationBase), 1e-3);
+        });
+    }
+
+}
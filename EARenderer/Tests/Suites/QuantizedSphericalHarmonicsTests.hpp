@@ -0,0 +1,24 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_QUANTIZEDSPHERICALHARMONICSTESTS_HPP
+#define EARENDERER_QUANTIZEDSPHERICALHARMONICSTESTS_HPP
+
+#include "TestRunner.hpp"
+#include "BenchmarkSceneLibrary.hpp"
+
+namespace EARenderer {
+
+    /**
+     Quantization of spherical harmonics restores every coefficient within the reported error bound
+     */
+    class QuantizedSphericalHarmonicsTests {
+    public:
+        static void Register(TestRunner &runner, BenchmarkSceneLibrary &scenes);
+    };
+
+}
+
+#endif //EARENDERER_QUANTIZEDSPHERICALHARMONICSTESTS_HPP
@@ -0,0 +1,222 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "RenderPassStreamTests.hpp"
+#include "TestAssertions.hpp"
+#include "ScopedGLBackend.hpp"
+#include "EngineShaderSources.hpp"
+#include "ProceduralSceneGenerator.hpp"
+#include "GPUResourceController.hpp"
+#include "SceneGBufferConstructor.hpp"
+#include "ShadowMapper.hpp"
+#include "RenderingSettings.hpp"
+#include "GLStateCache.hpp"
+#include "GLRecordingBackend.hpp"
+#include "StringUtils.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace EARenderer {
+
+    using Function = GLRecordingBackend::Function;
+    using Command = GLRecordingBackend::Command;
+
+    static constexpr uint8_t CascadeCount = 2;
+
+#pragma mark - Helpers
+
+    /**
+     A 3x3 box grid lit by the sun and a point light, with meshes and lights uploaded to the GPU
+     */
+    struct PassTestScene {
+        SharedResourceStorage resourceStorage;
+        Scene scene;
+        GPUResourceController gpuResourceController;
+        RenderingSettings settings;
+    };
+
+    static std::unique_ptr<PassTestScene> MakeScene() {
+        UseEngineShaderSources();
+
+        auto testScene = std::make_unique<PassTestScene>();
+        auto &scene = testScene->scene;
+
+        ProceduralSceneGenerator generator(1, &testScene->resourceStorage, &scene);
+        ProceduralSceneGenerator::BoxGridSettings boxGrid;
+        boxGrid.boxesPerSide = 3;
+        generator.addBoxGrid(boxGrid);
+        scene.calculateGeometricProperties(testScene->resourceStorage);
+
+        scene.setCamera(std::make_unique<Camera>(75.0, 0.1, 50.0));
+        scene.camera()->moveTo(glm::vec3(0.0, 6.0, 8.0));
+        scene.camera()->lookAt(glm::vec3(0.0));
+
+        // Radius of the light covers the whole grid, so that every sub mesh gets into its shadow map
+        scene.pointLights().insert(PointLight(glm::vec3(0.0, 4.0, 0.0), Color::White(), 50.0, 0.1, 0.1, 0.01, PointLight::Attenuation()));
+
+        testScene->gpuResourceController.updateMeshVAO(testScene->resourceStorage);
+        testScene->gpuResourceController.updateUniformBuffer(testScene->resourceStorage, scene);
+
+        // Meshlet culling splits draws of a sub mesh by visibility, whole sub meshes keep the stream predictable
+        testScene->settings.meshSettings.meshletCullingEnabled = false;
+        testScene->settings.displayedFrameResolution = Size2D(320, 180);
+
+        return testScene;
+    }
+
+    static size_t SubMeshCount(const PassTestScene &testScene) {
+        size_t count = 0;
+        for (ID instanceID : testScene.scene.meshInstances()) {
+            auto &instance = testScene.scene.meshInstances()[instanceID];
+            count += testScene.resourceStorage.mesh(instance.meshID()).subMeshes().size();
+        }
+        return count;
+    }
+
+    /**
+     Drops commands creating the scene and the pass, as well as the state they left behind,
+     the same way it happens at the beginning of a frame
+     */
+    static void StartRecording(GLRecordingBackend &backend) {
+        backend.clearCommands();
+        GLStateCache::shared().invalidate();
+    }
+
+    static std::vector<Command> Commands(const GLRecordingBackend &backend, Function function) {
+        std::vector<Command> commands;
+        for (auto &command : backend.commands()) {
+            if (command.function == function) {
+                commands.push_back(command);
+            }
+        }
+        return commands;
+    }
+
+    /**
+     The state cache is supposed to drop a binding matching the previous one of the same kind
+     */
+    static void ExpectNoRepeatedBindings(const GLRecordingBackend &backend) {
+        for (Function function : {Function::BindFramebuffer, Function::UseProgram, Function::BindVertexArray, Function::Viewport}) {
+            auto commands = Commands(backend, function);
+            for (size_t i = 1; i < commands.size(); i++) {
+                if (commands[i] == commands[i - 1]) {
+                    FailExpectation(string_format("Repeated %s", commands[i].description().c_str()), __FILE__, __LINE__);
+                }
+            }
+        }
+    }
+
+    static bool IsViewport(const Command &command, const Size2D &size) {
+        return command.function == Function::Viewport &&
+                command.arguments[2] == int64_t(size.width) &&
+                command.arguments[3] == int64_t(size.height);
+    }
+
+#pragma mark - Registration
+
+    void RenderPassStreamTests::Register(TestRunner &runner, BenchmarkSceneLibrary &scenes) {
+        runner.add("RenderPasses/ShadowMapper/EverySubMeshIsDrawnOncePerLight", [] {
+            GLRecordingBackend backend;
+            ScopedGLBackend scopedBackend(&backend);
+
+            auto testScene = MakeScene();
+            SceneGBufferConstructor gBufferConstructor(&testScene->scene, &testScene->resourceStorage, &testScene->gpuResourceController, testScene->settings);
+            ShadowMapper shadowMapper(&testScene->scene, &testScene->resourceStorage, &testScene->gpuResourceController, gBufferConstructor.GBuffer(), CascadeCount);
+            shadowMapper.setRenderingSettings(testScene->settings);
+
+            StartRecording(backend);
+            shadowMapper.render();
+
+            size_t subMeshCount = SubMeshCount(*testScene);
+            size_t cascadeCount = shadowMapper.cascades().amount;
+            EA_EXPECT(cascadeCount == CascadeCount);
+
+            // All views of a light are rendered by a single instanced draw of a sub mesh
+            auto draws = Commands(backend, Function::DrawArraysInstanced);
+            EA_EXPECT(draws.size() == 2 * subMeshCount);
+
+            size_t cubeFaceDraws = 0;
+            size_t cascadeDraws = 0;
+            for (auto &draw : draws) {
+                cubeFaceDraws += draw.arguments[3] == 6;
+                cascadeDraws += draw.arguments[3] == int64_t(cascadeCount);
+            }
+            EA_EXPECT(cubeFaceDraws == subMeshCount);
+            EA_EXPECT(cascadeDraws == subMeshCount);
+
+            // One depth clear per shadow map, one full screen quad per point light penumbra
+            auto clears = Commands(backend, Function::Clear);
+            EA_EXPECT(clears.size() == 2);
+            for (auto &clear : clears) {
+                EA_EXPECT(clear.arguments[0] == GL_DEPTH_BUFFER_BIT);
+            }
+            EA_EXPECT(Commands(backend, Function::DrawArrays).size() == 1);
+            EA_EXPECT(backend.drawCallCount() == 2 * subMeshCount + 1);
+        }, TestRunner::Context::None);
+
+        runner.add("RenderPasses/ShadowMapper/DrawsGoToViewportsOfTheirShadowMaps", [] {
+            GLRecordingBackend backend;
+            ScopedGLBackend scopedBackend(&backend);
+
+            auto testScene = MakeScene();
+            SceneGBufferConstructor gBufferConstructor(&testScene->scene, &testScene->resourceStorage, &testScene->gpuResourceController, testScene->settings);
+            ShadowMapper shadowMapper(&testScene->scene, &testScene->resourceStorage, &testScene->gpuResourceController, gBufferConstructor.GBuffer(), CascadeCount);
+            shadowMapper.setRenderingSettings(testScene->settings);
+
+            StartRecording(backend);
+            shadowMapper.render();
+
+            const Command *viewport = nullptr;
+            for (auto &command : backend.commands()) {
+                if (command.function == Function::Viewport) {
+                    viewport = &command;
+                } else if (command.function == Function::DrawArraysInstanced) {
+                    EA_EXPECT(viewport != nullptr);
+                    auto &resolution = command.arguments[3] == 6 ?
+                            testScene->settings.omnidirectionalShadowMapResolution :
+                            testScene->settings.directionalShadowMapResolution;
+                    EA_EXPECT(IsViewport(*viewport, resolution));
+                }
+            }
+
+            ExpectNoRepeatedBindings(backend);
+        }, TestRunner::Context::None);
+
+        runner.add("RenderPasses/GBuffer/EverySubMeshIsDrawnOnce", [] {
+            GLRecordingBackend backend;
+            ScopedGLBackend scopedBackend(&backend);
+
+            auto testScene = MakeScene();
+            SceneGBufferConstructor gBufferConstructor(&testScene->scene, &testScene->resourceStorage, &testScene->gpuResourceController, testScene->settings);
+            gBufferConstructor.setRenderingSettings(testScene->settings);
+
+            StartRecording(backend);
+            gBufferConstructor.render();
+
+            auto draws = Commands(backend, Function::DrawArrays);
+            EA_EXPECT(draws.size() == SubMeshCount(*testScene));
+            EA_EXPECT(backend.drawCallCount() == draws.size());
+            for (auto &draw : draws) {
+                EA_EXPECT(draw.arguments[0] == GL_TRIANGLES);
+            }
+
+            // The whole pass runs with a single program, vertex array and framebuffer
+            EA_EXPECT(Commands(backend, Function::UseProgram).size() == 1);
+            EA_EXPECT(Commands(backend, Function::BindVertexArray).size() == 1);
+            EA_EXPECT(Commands(backend, Function::BindFramebuffer).size() == 1);
+
+            auto clears = Commands(backend, Function::Clear);
+            EA_EXPECT(clears.size() == 1);
+            EA_EXPECT(clears.empty() || clears[0].arguments[0] == (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+
+            auto viewports = Commands(backend, Function::Viewport);
+            EA_EXPECT(!viewports.empty() && IsViewport(viewports.back(), testScene->settings.displayedFrameResolution));
+
+            ExpectNoRepeatedBindings(backend);
+        }, TestRunner::Context::None);
+    }
+
+}
@@ -0,0 +1,25 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_RENDERPASSSTREAMTESTS_HPP
+#define EARENDERER_RENDERPASSSTREAMTESTS_HPP
+
+#include "TestRunner.hpp"
+#include "BenchmarkSceneLibrary.hpp"
+
+namespace EARenderer {
+
+    /**
+     State and draw streams of the shadow and G-buffer passes over a small box grid, recorded while the commands
+     still reach the driver. Passes are expected to draw every sub mesh once per view group and never repeat a binding.
+     */
+    class RenderPassStreamTests {
+    public:
+        static void Register(TestRunner &runner, BenchmarkSceneLibrary &scenes);
+    };
+
+}
+
+#endif //EARENDERER_RENDERPASSSTREAMTESTS_HPP
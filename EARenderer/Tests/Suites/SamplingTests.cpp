@@ -0,0 +1,107 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "SamplingTests.hpp"
+#include "TestAssertions.hpp"
+#include "SobolSampler.hpp"
+#include "StringUtils.hpp"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+namespace EARenderer {
+
+    // Dimensions and the largest power of two prefix whose stratification is verified
+    static constexpr uint32_t VerifiedDimensionCount = 16;
+    static constexpr uint32_t VerifiedPrefixBits = 10;
+
+#pragma mark - Helpers
+
+    /**
+     @return whether every interval of [0, 1) of length 1 / count holds exactly one of the first count samples
+     */
+    static bool IsStratified1D(const SobolSampler &sampler, uint32_t dimension, uint32_t count) {
+        std::vector<uint8_t> hits(count, 0);
+        for (uint32_t i = 0; i < count; i++) {
+            auto &hit = hits[uint32_t(sampler.sample1D(i, dimension) * count)];
+            if (hit) {
+                return false;
+            }
+            hit = 1;
+        }
+        return true;
+    }
+
+    /**
+     @return whether the first count samples of dimensions 0 and 1 form a (0, m, 2)-net,
+     i.e. every elementary interval of area 1 / count holds exactly one of them
+     */
+    static bool IsStratified2D(const SobolSampler &sampler, uint32_t bits) {
+        uint32_t count = 1u << bits;
+        for (uint32_t xBits = 0; xBits <= bits; xBits++) {
+            uint32_t yBits = bits - xBits;
+            std::vector<uint8_t> hits(count, 0);
+            for (uint32_t i = 0; i < count; i++) {
+                glm::vec2 sample = sampler.sample2D(i, 0);
+                uint32_t x = uint32_t(sample.x * (1u << xBits));
+                uint32_t y = uint32_t(sample.y * (1u << yBits));
+                auto &hit = hits[(x << yBits) | y];
+                if (hit) {
+                    return false;
+                }
+                hit = 1;
+            }
+        }
+        return true;
+    }
+
+#pragma mark - Registration
+
+    void SamplingTests::Register(TestRunner &runner, BenchmarkSceneLibrary &scenes) {
+        uint32_t seed = scenes.settings().seed;
+
+        runner.add("Sampling/Sobol/Stratified1D", [=] {
+            SobolSampler sampler(seed);
+            for (uint32_t dimension = 0; dimension < VerifiedDimensionCount; dimension++) {
+                for (uint32_t bits = 0; bits <= VerifiedPrefixBits; bits++) {
+                    if (!IsStratified1D(sampler, dimension, 1u << bits)) {
+                        FailExpectation(string_format("First %u samples of dimension %u aren't stratified", 1u << bits, dimension), __FILE__, __LINE__);
+                    }
+                }
+            }
+        });
+
+        runner.add("Sampling/Sobol/Stratified2D", [=] {
+            SobolSampler sampler(seed);
+            for (uint32_t bits = 0; bits <= VerifiedPrefixBits; bits++) {
+                if (!IsStratified2D(sampler, bits)) {
+                    FailExpectation(string_format("First %u samples don't form a (0, m, 2)-net", 1u << bits), __FILE__, __LINE__);
+                }
+            }
+        });
+
+        runner.add("Sampling/Sobol/SeedsDiffer", [=] {
+            SobolSampler a(seed);
+            SobolSampler b(seed + 1);
+            bool differ = false;
+            for (uint32_t i = 0; i < 16 && !differ; i++) {
+                differ = a.sample2D(i, 0) != b.sample2D(i, 0);
+            }
+            EA_EXPECT(differ);
+        });
+
+        runner.add("Sampling/Sobol/UnitInterval", [=] {
+            SobolSampler sampler(seed);
+            for (uint32_t dimension = 0; dimension < VerifiedDimensionCount; dimension++) {
+                for (uint32_t i = 0; i < (1u << VerifiedPrefixBits); i++) {
+                    float sample = sampler.sample1D(i, dimension);
+                    EA_EXPECT(sample >= 0.0 && sample < 1.0);
+                }
+            }
+        });
+    }
+
+}
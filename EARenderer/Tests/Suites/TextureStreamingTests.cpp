@@ -0,0 +1,243 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "TextureStreamingTests.hpp"
+#include "TestAssertions.hpp"
+#include "TextureStreamer.hpp"
+#include "SimulatedTextureStreamingBackend.hpp"
+#include "ProceduralSceneGenerator.hpp"
+#include "StringUtils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+namespace EARenderer {
+
+    static constexpr uint32_t StreamedMaterialCount = 16;
+    static constexpr uint32_t ImageSize = 1024;
+    static constexpr uint32_t OrbitFrameCount = 200;
+    // Orbit angle the camera advances by every frame
+    static constexpr float OrbitStep = 0.02;
+
+#pragma mark - Helpers
+
+    static std::string MapPath(uint32_t materialIndex, const char *mapName) {
+        return string_format("Streamed/%u/%s.png", materialIndex, mapName);
+    }
+
+    /**
+     @return bytes of square image mip levels starting from the given one, as the streamer counts them
+     */
+    static size_t MipChainBytes(uint32_t imageSize, uint32_t mipLevel) {
+        size_t bytes = 0;
+        for (uint32_t size = imageSize >> mipLevel; size > 0; size >>= 1) {
+            bytes += size_t(size) * size * 4;
+        }
+        return bytes;
+    }
+
+    /**
+     Makes mesh instances of the scene refer to the materials in turns
+     */
+    static void AssignMaterials(Scene &scene, const std::vector<ID> &materialIDs) {
+        size_t instanceIndex = 0;
+        for (ID instanceID : scene.meshInstances()) {
+            scene.meshInstances()[instanceID].materialReference = std::make_pair(MaterialType::CookTorrance, materialIDs[instanceIndex++ % materialIDs.size()]);
+        }
+    }
+
+    /**
+     Scattered meshes whose instances refer to streamed materials in turns
+     */
+    class StreamedScene {
+    public:
+        ProceduralSceneGenerator::ScatteredMeshesSettings sceneSettings;
+        SharedResourceStorage resourceStorage;
+        Scene scene;
+        SimulatedTextureStreamingBackend *backend = nullptr;
+        std::unique_ptr<TextureStreamer> streamer;
+        std::vector<ID> materialIDs;
+
+        StreamedScene(uint32_t seed, const TextureStreamer::Settings &settings) {
+            sceneSettings.trianglesPerMesh = 500;
+
+            ProceduralSceneGenerator generator(seed, &resourceStorage, &scene);
+            generator.addScatteredMeshes(sceneSettings);
+            scene.setCamera(std::make_unique<Camera>(75.0, 0.1, sceneSettings.extent * 2.0));
+
+            auto simulatedBackend = std::make_unique<SimulatedTextureStreamingBackend>(Size2D(ImageSize));
+            backend = simulatedBackend.get();
+            streamer = std::make_unique<TextureStreamer>(std::move(simulatedBackend), settings);
+
+            for (uint32_t i = 0; i < StreamedMaterialCount; i++) {
+                auto materialRef = resourceStorage.addMaterial(CookTorranceMaterial(
+                        MapPath(i, "albedo"), MapPath(i, "normal"), MapPath(i, "metalness"), MapPath(i, "roughness"),
+                        MapPath(i, "ao"), MapPath(i, "displacement"), CookTorranceMaterial::TextureLoading::Streamed));
+                streamer->addMaterial(materialRef.second, resourceStorage.cookTorranceMaterial(materialRef.second));
+                materialIDs.push_back(materialRef.second);
+            }
+
+            size_t instanceIndex = 0;
+            for (ID instanceID : scene.meshInstances()) {
+                scene.meshInstances()[instanceID].materialReference = std::make_pair(MaterialType::CookTorrance, materialIDs[instanceIndex++ % materialIDs.size()]);
+            }
+        }
+
+        void update(const glm::vec3 &cameraPosition) {
+            scene.camera()->moveTo(cameraPosition);
+            scene.camera()->lookAt(glm::vec3(0.0, 0.5, 0.0));
+            streamer->update(scene, resourceStorage, Size2D(1920, 1080));
+        }
+
+        void expectConsistentResidency() const {
+            for (ID materialID : materialIDs) {
+                for (size_t i = 0; i < CookTorranceMaterial::MapTypeCount; i++) {
+                    auto mapType = CookTorranceMaterial::MapType(i);
+                    auto backendMip = backend->residentMipLevel({materialID, mapType});
+                    uint32_t streamerMip = streamer->residentMipLevel(materialID, mapType);
+
+                    if (!backendMip || *backendMip != streamerMip || streamerMip > streamer->minimumMipLevel(materialID, mapType)) {
+                        FailExpectation(string_format("Map %zu of material %llu holds mip level %u, which the backend doesn't agree with",
+                                i, (unsigned long long) materialID, streamerMip), __FILE__, __LINE__);
+                    }
+                }
+            }
+        }
+    };
+
+#pragma mark - Registration
+
+    void TextureStreamingTests::Register(TestRunner &runner, BenchmarkSceneLibrary &scenes) {
+        uint32_t seed = scenes.settings().seed;
+
+        runner.add("TextureStreaming/MinimumMipLevelsResident", [=] {
+            StreamedScene streamed(seed, TextureStreamer::Settings());
+            streamed.streamer->finishPendingLoads();
+
+            streamed.expectConsistentResidency();
+            for (ID materialID : streamed.materialIDs) {
+                for (size_t i = 0; i < CookTorranceMaterial::MapTypeCount; i++) {
+                    auto mapType = CookTorranceMaterial::MapType(i);
+                    EA_EXPECT(streamed.streamer->residentMipLevel(materialID, mapType) == streamed.streamer->minimumMipLevel(materialID, mapType));
+                }
+            }
+        });
+
+        for (size_t budgetMegabytes : {16, 256}) {
+            runner.add(string_format("TextureStreaming/Orbit/%zuMB", budgetMegabytes), [=] {
+                TextureStreamer::Settings settings;
+                settings.memoryBudget = budgetMegabytes * 1024 * 1024;
+                StreamedScene streamed(seed, settings);
+                streamed.streamer->finishPendingLoads();
+
+                // Minimum mip levels are kept regardless of the budget
+                size_t residencyLimit = std::max(settings.memoryBudget, streamed.streamer->residentBytes());
+                float radius = streamed.sceneSettings.extent * 0.6;
+
+                for (uint32_t frame = 0; frame < OrbitFrameCount; frame++) {
+                    float angle = frame * OrbitStep;
+                    streamed.update(glm::vec3(radius * std::cos(angle), 1.5, radius * std::sin(angle)));
+
+                    if (streamed.streamer->residentBytes() > residencyLimit) {
+                        FailExpectation(string_format("%zu bytes are resident with a budget of %zu in frame %u",
+                                streamed.streamer->residentBytes(), residencyLimit, frame), __FILE__, __LINE__);
+                    }
+                }
+
+                streamed.streamer->finishPendingLoads();
+                streamed.expectConsistentResidency();
+                EA_EXPECT(streamed.streamer->statistics().uploads > 0);
+                EA_EXPECT(streamed.streamer->statistics().failedLoads == 0);
+            });
+        }
+
+        runner.add("TextureStreaming/LoadsNotFittingBudgetAreDiscardedWithoutEvictions", [] {
+            constexpr uint32_t AlbedoSize = 256;
+            constexpr uint32_t MinimumResidentSize = 16;
+            constexpr uint32_t MinimumMipLevel = 4;
+
+            // Full chain of one albedo map fits next to the minimum mip level of the other, but not both full chains
+            TextureStreamer::Settings settings;
+            settings.minimumResidentSize = MinimumResidentSize;
+            settings.memoryBudget = MipChainBytes(AlbedoSize, 0) + 2 * MipChainBytes(AlbedoSize, MinimumMipLevel) + 1024;
+            // Every visible map requires its full chain
+            settings.mipBias = -100.0;
+
+            SharedResourceStorage resourceStorage;
+            Scene scene;
+            ProceduralSceneGenerator generator(1, &resourceStorage, &scene);
+            ProceduralSceneGenerator::BoxGridSettings boxGrid;
+            boxGrid.boxesPerSide = 3;
+            generator.addBoxGrid(boxGrid);
+            scene.setCamera(std::make_unique<Camera>(75.0, 0.1, 50.0));
+            scene.camera()->moveTo(glm::vec3(0.0, 6.0, 8.0));
+            scene.camera()->lookAt(glm::vec3(0.0));
+
+            auto simulatedBackend = std::make_unique<SimulatedTextureStreamingBackend>(Size2D(AlbedoSize));
+            auto backend = simulatedBackend.get();
+            TextureStreamer streamer(std::move(simulatedBackend), settings);
+
+            std::vector<ID> materialIDs;
+            for (uint32_t i = 0; i < 2; i++) {
+                auto materialRef = resourceStorage.addMaterial(CookTorranceMaterial(
+                        MapPath(i, "albedo"), glm::vec3(0.5, 0.5, 1.0), 0.0f, 0.5f, 1.0f, 0.0f, CookTorranceMaterial::TextureLoading::Streamed));
+                streamer.addMaterial(materialRef.second, resourceStorage.cookTorranceMaterial(materialRef.second));
+                materialIDs.push_back(materialRef.second);
+            }
+            ID first = materialIDs[0];
+            ID second = materialIDs[1];
+            auto albedo = CookTorranceMaterial::MapType::Albedo;
+            streamer.finishPendingLoads();
+            EA_EXPECT(streamer.minimumMipLevel(first, albedo) == MinimumMipLevel);
+
+            AssignMaterials(scene, {first});
+            streamer.update(scene, resourceStorage, Size2D(1920, 1080));
+            streamer.finishPendingLoads();
+            EA_EXPECT(streamer.residentMipLevel(first, albedo) == 0);
+
+            // The load of the second map is issued while the first one is unused and may be evicted
+            AssignMaterials(scene, {second});
+            streamer.update(scene, resourceStorage, Size2D(1920, 1080));
+            EA_EXPECT(streamer.pendingLoadCount() == 1);
+
+            // By the time it completes, the first map is in use again and keeps its mip levels
+            AssignMaterials(scene, materialIDs);
+            streamer.update(scene, resourceStorage, Size2D(1920, 1080));
+            streamer.finishPendingLoads();
+
+            EA_EXPECT(streamer.statistics().discardedLoads == 1);
+            EA_EXPECT(streamer.statistics().evictions == 0);
+            EA_EXPECT(backend->dropCount() == 0);
+            EA_EXPECT(streamer.residentMipLevel(first, albedo) == 0);
+            EA_EXPECT(streamer.residentMipLevel(second, albedo) == MinimumMipLevel);
+            EA_EXPECT(streamer.residentBytes() <= settings.memoryBudget);
+        });
+
+        runner.add("TextureStreaming/DistantCameraRequiresCoarserMips", [=] {
+            StreamedScene streamed(seed, TextureStreamer::Settings());
+            float extent = streamed.sceneSettings.extent;
+
+            streamed.update(glm::vec3(extent * 0.6, 1.5, 0.0));
+            // Maps of invisible materials require their minimum mip level, so only materials visible from both positions are compared
+            std::vector<uint32_t> nearMipLevels;
+            std::vector<bool> nearVisibility;
+            for (ID materialID : streamed.materialIDs) {
+                nearMipLevels.push_back(streamed.streamer->requiredMipLevel(materialID, CookTorranceMaterial::MapType::Albedo));
+                nearVisibility.push_back(streamed.streamer->isVisible(materialID));
+            }
+
+            streamed.update(glm::vec3(extent * 1.8, 1.5, 0.0));
+            for (size_t i = 0; i < streamed.materialIDs.size(); i++) {
+                ID materialID = streamed.materialIDs[i];
+                if (nearVisibility[i] && streamed.streamer->isVisible(materialID)) {
+                    EA_EXPECT(streamed.streamer->requiredMipLevel(materialID, CookTorranceMaterial::MapType::Albedo) >= nearMipLevels[i]);
+                }
+            }
+        });
+    }
+
+}
@@ -0,0 +1,25 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_TEXTURESTREAMINGTESTS_HPP
+#define EARENDERER_TEXTURESTREAMINGTESTS_HPP
+
+#include "TestRunner.hpp"
+#include "BenchmarkSceneLibrary.hpp"
+
+namespace EARenderer {
+
+    /**
+     Texture streaming decisions against a simulated backend: the memory budget holds, resident mip levels
+     agree with the backend and required mip levels follow the on-screen size
+     */
+    class TextureStreamingTests {
+    public:
+        static void Register(TestRunner &runner, BenchmarkSceneLibrary &scenes);
+    };
+
+}
+
+#endif //EARENDERER_TEXTURESTREAMINGTESTS_HPP
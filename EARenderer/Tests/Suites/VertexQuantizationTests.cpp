@@ -0,0 +1,63 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "VertexQuantizationTests.hpp"
+#include "TestAssertions.hpp"
+#include "QuantizedVertex.hpp"
+#include "StringUtils.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace EARenderer {
+
+    // Octahedral encoding with 16 bit components stays well below this angle
+    static constexpr float MaximumDirectionError = 0.05;
+
+#pragma mark - Helpers
+
+    static void ExpectError(const std::string &what, float error, float bound) {
+        if (error > bound) {
+            FailExpectation(string_format("Quantization error of %s is %g, exceeding %g", what.c_str(), error, bound), __FILE__, __LINE__);
+        }
+    }
+
+#pragma mark - Registration
+
+    void VertexQuantizationTests::Register(TestRunner &runner, BenchmarkSceneLibrary &scenes) {
+        for (auto &sceneName : BenchmarkSceneLibrary::SceneNames()) {
+            runner.add("VertexQuantization/ErrorBounds/" + sceneName, [=, &scenes] {
+                auto &entry = scenes.entry(sceneName);
+
+                entry.resourceStorage->iterateMeshes([&](ID meshID) {
+                    auto &mesh = entry.resourceStorage->mesh(meshID);
+                    for (ID subMeshID : mesh.subMeshes()) {
+                        auto &subMesh = mesh.subMeshes()[subMeshID];
+                        auto &vertices = subMesh.vertices();
+                        if (vertices.empty()) {
+                            continue;
+                        }
+
+                        auto error = QuantizedVertex::MeasureError(vertices.data(), vertices.size(), subMesh.boundingBox());
+
+                        float textureCoordsMagnitude = 1.0;
+                        for (auto &vertex : vertices) {
+                            textureCoordsMagnitude = std::max({textureCoordsMagnitude, std::abs(vertex.textureCoords.x), std::abs(vertex.textureCoords.y)});
+                        }
+
+                        // Rounding to the nearest of 65535 levels, 11 bit mantissa of half floats
+                        std::string subMeshName = mesh.name() + "/" + subMesh.name();
+                        ExpectError(subMeshName + " position", error.position, 1.0 / 65535.0);
+                        ExpectError(subMeshName + " normal", error.normal, MaximumDirectionError);
+                        ExpectError(subMeshName + " tangent", error.tangent, MaximumDirectionError);
+                        ExpectError(subMeshName + " texture coordinates", error.textureCoords, textureCoordsMagnitude * std::exp2(-11.0f));
+                        ExpectError(subMeshName + " lightmap coordinates", error.lightmapCoords, 1.0 / 65535.0);
+                    }
+                });
+            });
+        }
+    }
+
+}
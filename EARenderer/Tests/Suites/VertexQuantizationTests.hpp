@@ -0,0 +1,24 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#ifndef EARENDERER_VERTEXQUANTIZATIONTESTS_HPP
+#define EARENDERER_VERTEXQUANTIZATIONTESTS_HPP
+
+#include "TestRunner.hpp"
+#include "BenchmarkSceneLibrary.hpp"
+
+namespace EARenderer {
+
+    /**
+     Quantization error of vertices of every benchmark scene stays within the precision of the packed formats
+     */
+    class VertexQuantizationTests {
+    public:
+        static void Register(TestRunner &runner, BenchmarkSceneLibrary &scenes);
+    };
+
+}
+
+#endif //EARENDERER_VERTEXQUANTIZATIONTESTS_HPP
@@ -0,0 +1,106 @@
+//
+// Created by Pavlo Muratov on 2019-02-16.
+// Copyright (c) 2019 MPO. All rights reserved.
+//
+
+#include "OffscreenGLContext.hpp"
+#include "TestRunner.hpp"
+#include "BenchmarkSceneLibrary.hpp"
+#include "SamplingTests.hpp"
+#include "VertexQuantizationTests.hpp"
+#include "MeshProcessingTests.hpp"
+#include "PackingTests.hpp"
+#include "BakingTests.hpp"
+#include "TextureStreamingTests.hpp"
+#include "IndirectLightUpdateSchedulerTests.hpp"
+#include "QuantizedSphericalHarmonicsTests.hpp"
+#include "GLSLPreprocessorTests.hpp"
+#include "GLProgramBinaryCacheTests.hpp"
+#include "GLProgramUniformTests.hpp"
+#include "RenderPassStreamTests.hpp"
+#include "FrameStatisticsTests.hpp"
+#include "FrameGraphTests.hpp"
+#include "Profiler.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+
+using namespace EARenderer;
+
+static void PrintUsage(const char *executable) {
+    printf("Usage: %s [options]\n"
+           "  --filter <substring>     run only tests whose names contain the substring\n"
+           "  --seed <n>               seed of procedural scenes and random inputs\n"
+           "  --list                   print test names and exit\n", executable);
+}
+
+int main(int argc, const char *argv[]) {
+    BenchmarkSceneLibrary::Settings sceneSettings;
+    std::string filter;
+    bool listOnly = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char *argument = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (0 == strcmp(argument, "--list")) {
+            listOnly = true;
+        } else if (0 == strcmp(argument, "--filter") && hasValue) {
+            filter = argv[++i];
+        } else if (0 == strcmp(argument, "--seed") && hasValue) {
+            sceneSettings.seed = uint32_t(strtoul(argv[++i], nullptr, 10));
+        } else {
+            PrintUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Textures and buffers created by baked data need a current context,
+    // it's only created once a test needing it is run
+    std::unique_ptr<OffscreenGLContext> context;
+
+    // Baking stages record many zones
+    Profiler::shared().setThreadBufferCapacity(1 << 20);
+
+    // Tests share the scenes benchmarks run on
+    BenchmarkSceneLibrary scenes(sceneSettings);
+    TestRunner runner(filter);
+    runner.setContextFactory([&context] { context = std::make_unique<OffscreenGLContext>(); });
+
+    SamplingTests::Register(runner, scenes);
+    VertexQuantizationTests::Register(runner, scenes);
+    MeshProcessingTests::Register(runner, scenes);
+    PackingTests::Register(runner, scenes);
+    BakingTests::Register(runner, scenes);
+    TextureStreamingTests::Register(runner, scenes);
+    IndirectLightUpdateSchedulerTests::Register(runner, scenes);
+    QuantizedSphericalHarmonicsTests::Register(runner, scenes);
+    GLSLPreprocessorTests::Register(runner, scenes);
+    GLProgramBinaryCacheTests::Register(runner, scenes);
+    GLProgramUniformTests::Register(runner, scenes);
+    RenderPassStreamTests::Register(runner, scenes);
+    FrameStatisticsTests::Register(runner, scenes);
+    FrameGraphTests::Register(runner, scenes);
+
+    if (listOnly) {
+        for (auto &name : runner.testNames()) {
+            printf("%s\n", name.c_str());
+        }
+        return EXIT_SUCCESS;
+    }
+
+    auto results = runner.run();
+
+    size_t failureCount = 0;
+    for (auto &result : results) {
+        if (!result.failure.empty()) {
+            failureCount++;
+        }
+    }
+
+    printf("%zu of %zu tests passed\n", results.size() - failureCount, results.size());
+    return failureCount == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -7,6 +7,7 @@
 //
 
 #import "DefaultRenderComponentsProvider.h"
+#import "GLStateCache.hpp"
 #import <OpenGL/gl3.h>
 
 DefaultRenderComponentsProvider::DefaultRenderComponentsProvider(EARenderer::GLViewport *mainViewport)
@@ -15,7 +16,7 @@ DefaultRenderComponentsProvider::DefaultRenderComponentsProvider(EARenderer::GLV
 }
 
 void DefaultRenderComponentsProvider::bindSystemFramebuffer() const {
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    EARenderer::GLStateCache::shared().bindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 const EARenderer::GLViewport &DefaultRenderComponentsProvider::defaultViewport() const {
@@ -375,7 +375,8 @@
             metallicMapPath.UTF8String,
             roughnessMapPath.UTF8String,
             blankImagePath.UTF8String,
-            0.0f
+            0.0f,
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -392,7 +393,8 @@
             blankImagePath.UTF8String,
             roughnessMapPath.UTF8String,
             aoMapPath.UTF8String,
-            0.0f
+            0.0f,
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -409,7 +411,8 @@
             metallicMapPath.UTF8String,
             roughnessMapPath.UTF8String,
             blankImagePath.UTF8String,
-            0.0f
+            0.0f,
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -422,7 +425,8 @@
             [self pathForResource:@"Dielectric_metallic.tga"],
             [self pathForResource:@"Sponza_Thorn_roughness.tga"],
             [self pathForResource:@"blank_white.jpg"],
-            [self pathForResource:@"blank_white.jpg"]
+            [self pathForResource:@"blank_white.jpg"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -433,7 +437,8 @@
             [self pathForResource:@"Dielectric_metallic.tga"],
             [self pathForResource:@"VaseRound_roughness.tga"],
             [self pathForResource:@"blank_white.jpg"],
-            [self pathForResource:@"blank_white.jpg"]
+            [self pathForResource:@"blank_white.jpg"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -444,7 +449,8 @@
             [self pathForResource:@"Dielectric_metallic.tga"],
             [self pathForResource:@"VasePlant_roughness.tga"],
             [self pathForResource:@"blank_white.jpg"],
-            [self pathForResource:@"blank_white.jpg"]
+            [self pathForResource:@"blank_white.jpg"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -455,7 +461,8 @@
             [self pathForResource:@"Dielectric_metallic.tga"],
             [self pathForResource:@"Background_roughness.tga"],
             [self pathForResource:@"blank_white.jpg"],
-            [self pathForResource:@"blank_white.jpg"]
+            [self pathForResource:@"blank_white.jpg"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -467,7 +474,8 @@
 //        [self pathForResource:@"Sponza_Bricks_a_Roughness.tga"],
             [self pathForResource:@"blank_white.jpg"],
             [self pathForResource:@"blank_white.jpg"],
-            [self pathForResource:@"blank_white.jpg"]
+            [self pathForResource:@"blank_white.jpg"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -479,7 +487,8 @@
 //        [self pathForResource:@"Sponza_Arch_roughness.tga"],
             [self pathForResource:@"blank_white.jpg"],
             [self pathForResource:@"blank_white.jpg"],
-            [self pathForResource:@"blank_white.jpg"]
+            [self pathForResource:@"blank_white.jpg"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -491,7 +500,8 @@
 //            [self pathForResource:@"Sponza_Ceiling_roughness.tga"],
             1.0,
             [self pathForResource:@"blank_white.jpg"],
-            [self pathForResource:@"blank_white.jpg"]
+            [self pathForResource:@"blank_white.jpg"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -503,7 +513,8 @@
 //        [self pathForResource:@"Sponza_Column_a_roughness.tga"],
             [self pathForResource:@"blank_white.jpg"],
             [self pathForResource:@"blank_white.jpg"],
-            [self pathForResource:@"blank_white.jpg"]
+            [self pathForResource:@"blank_white.jpg"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -514,7 +525,8 @@
             [self pathForResource:@"Dielectric_metallic.tga"],
             [self pathForResource:@"Sponza_Floor_roughness.tga"],
             [self pathForResource:@"blank_white.jpg"],
-            [self pathForResource:@"blank_white.jpg"]
+            [self pathForResource:@"blank_white.jpg"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -526,7 +538,8 @@
 //        [self pathForResource:@"Sponza_Column_c_roughness.tga"],
             [self pathForResource:@"blank_white.jpg"],
             [self pathForResource:@"blank_white.jpg"],
-            [self pathForResource:@"blank_white.jpg"]
+            [self pathForResource:@"blank_white.jpg"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -538,7 +551,8 @@
 //            [self pathForResource:@"Sponza_Details_roughness.tga"],
             1.0,
             [self pathForResource:@"blank_white.jpg"],
-            [self pathForResource:@"blank_white.jpg"]
+            [self pathForResource:@"blank_white.jpg"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -550,7 +564,8 @@
 //        [self pathForResource:@"Sponza_Column_b_roughness.tga"],
             [self pathForResource:@"blank_white.jpg"],
             [self pathForResource:@"blank_white.jpg"],
-            [self pathForResource:@"blank_white.jpg"]
+            [self pathForResource:@"blank_white.jpg"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -561,7 +576,8 @@
             [self pathForResource:@"Metallic_metallic.tga"],
             [self pathForResource:@"Sponza_FlagPole_roughness.tga"],
             [self pathForResource:@"blank_white.jpg"],
-            [self pathForResource:@"blank_white.jpg"]
+            [self pathForResource:@"blank_white.jpg"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -572,7 +588,8 @@
             [self pathForResource:@"Sponza_Fabric_metallic.tga"],
             [self pathForResource:@"Sponza_Fabric_roughness.tga"],
             [self pathForResource:@"blank_white.jpg"],
-            [self pathForResource:@"blank_white.jpg"]
+            [self pathForResource:@"blank_white.jpg"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -583,7 +600,8 @@
             [self pathForResource:@"Sponza_Fabric_metallic.tga"],
             [self pathForResource:@"Sponza_Fabric_roughness.tga"],
             [self pathForResource:@"blank_white.jpg"],
-            [self pathForResource:@"blank_white.jpg"]
+            [self pathForResource:@"blank_white.jpg"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -594,7 +612,8 @@
             [self pathForResource:@"Sponza_Fabric_metallic.tga"],
             [self pathForResource:@"Sponza_Fabric_roughness.tga"],
             [self pathForResource:@"blank_white.jpg"],
-            [self pathForResource:@"blank_white.jpg"]
+            [self pathForResource:@"blank_white.jpg"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -605,7 +624,8 @@
             [self pathForResource:@"Sponza_Curtain_metallic.tga"],
             [self pathForResource:@"Sponza_Curtain_roughness.tga"],
             [self pathForResource:@"blank_white.jpg"],
-            [self pathForResource:@"blank_white.jpg"]
+            [self pathForResource:@"blank_white.jpg"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -616,7 +636,8 @@
             [self pathForResource:@"Sponza_Curtain_metallic.tga"],
             [self pathForResource:@"Sponza_Curtain_roughness.tga"],
             [self pathForResource:@"blank_white.jpg"],
-            [self pathForResource:@"blank_white.jpg"]
+            [self pathForResource:@"blank_white.jpg"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -627,7 +648,8 @@
             [self pathForResource:@"Sponza_Curtain_metallic.tga"],
             [self pathForResource:@"Sponza_Curtain_roughness.tga"],
             [self pathForResource:@"blank_white.jpg"],
-            [self pathForResource:@"blank_white.jpg"]
+            [self pathForResource:@"blank_white.jpg"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -638,7 +660,8 @@
             [self pathForResource:@"ChainTexture_Metallic.tga"],
             [self pathForResource:@"ChainTexture_Roughness.tga"],
             [self pathForResource:@"blank_white.jpg"],
-            [self pathForResource:@"blank_white.jpg"]
+            [self pathForResource:@"blank_white.jpg"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -649,7 +672,8 @@
             [self pathForResource:@"Metallic_metallic.tga"],
             [self pathForResource:@"VaseHanging_roughness.tga"],
             [self pathForResource:@"blank_white.jpg"],
-            [self pathForResource:@"blank_white.jpg"]
+            [self pathForResource:@"blank_white.jpg"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -660,7 +684,8 @@
             [self pathForResource:@"Dielectric_metallic.tga"],
             [self pathForResource:@"Vase_roughness.tga"],
             [self pathForResource:@"blank_white.jpg"],
-            [self pathForResource:@"blank_white.jpg"]
+            [self pathForResource:@"blank_white.jpg"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -671,7 +696,8 @@
             [self pathForResource:@"Dielectric_metallic.tga"],
             [self pathForResource:@"Lion_Roughness.tga"],
             [self pathForResource:@"blank_white.jpg"],
-            [self pathForResource:@"blank_white.jpg"]
+            [self pathForResource:@"blank_white.jpg"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -682,7 +708,8 @@
             [self pathForResource:@"Dielectric_metallic.tga"],
             [self pathForResource:@"Sponza_Roof_roughness.tga"],
             [self pathForResource:@"blank_white.jpg"],
-            [self pathForResource:@"blank_white.jpg"]
+            [self pathForResource:@"blank_white.jpg"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -124,7 +124,8 @@
             [self pathForResource:@"blank_black.png"],
             [self pathForResource:@"blank_white.jpg"],
             [self pathForResource:@"blank_white.jpg"],
-            0.0f
+            0.0f,
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -135,7 +136,8 @@
             [self pathForResource:@"blank_black.png"],
             [self pathForResource:@"Fabric03_rgh.jpg"],
             [self pathForResource:@"blank_white.jpg"],
-            [self pathForResource:@"Fabric03_disp.jpg"]
+            [self pathForResource:@"Fabric03_disp.jpg"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -146,7 +148,8 @@
             [self pathForResource:@"blank_black.png"],
             [self pathForResource:@"fabric02_rgh.jpg"],
             [self pathForResource:@"blank_white.jpg"],
-            [self pathForResource:@"fabric02_disp.jpg"]
+            [self pathForResource:@"fabric02_disp.jpg"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -203,7 +203,8 @@
                 [self pathForResource:@"Titanium-Scuffed_metallic.png"],
                 1.0f / (i + 1),
                 1.0f,
-                0.0f
+                0.0f,
+                EARenderer::CookTorranceMaterial::TextureLoading::Streamed
         });
         EARenderer::MeshInstance sphereInstance(sphereMeshID, resourcePool->mesh(sphereMeshID));
         sphereInstance.transformation().translation.x = x + (i * 0.5f);
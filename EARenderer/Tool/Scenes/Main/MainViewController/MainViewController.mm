@@ -25,15 +25,23 @@
 #import "SceneInteractor.hpp"
 #import "Cameraman.hpp"
 #import "FileManager.hpp"
-#import "SurfelGenerator.hpp"
 #import "TriangleRenderer.hpp"
 #import "BoxRenderer.hpp"
 #import "Measurement.hpp"
-#import "DiffuseLightProbeGenerator.hpp"
 #import "DiffuseLightProbeRenderer.hpp"
+#import "LightBakingVolumeCache.hpp"
+#import "GLProgramBinaryCache.hpp"
+#import "GLStateCache.hpp"
+#import "GLProgramBinaryFileStorage.hpp"
 #import "LogUtils.hpp"
+#import "Profiler.hpp"
+#import "GLPassTimer.hpp"
+#import "MemoryTracker.hpp"
+#import "TextureStreamer.hpp"
+#import "GLTextureStreamingBackend.hpp"
 
 static float const FrequentEventsThrottleCooldownMS = 100;
+static NSString *const ExportStartupTraceDefaultsKey = @"ExportStartupTrace";
 
 @interface MainViewController () <SceneGLViewDelegate, MeshListTabViewItemDelegate, SettingsTabViewItemDelegate>
 
@@ -58,6 +66,7 @@ static float const FrequentEventsThrottleCooldownMS = 100;
     std::unique_ptr<EARenderer::SceneInteractor> sceneInteractor;
     std::unique_ptr<EARenderer::Cameraman> cameraman;
     std::unique_ptr<EARenderer::FrameMeter> frameMeter;
+    std::unique_ptr<EARenderer::GLPassTimer> passTimer;
     std::unique_ptr<EARenderer::Throttle> frequentEventsThrottle;
     std::unique_ptr<EARenderer::SurfelRenderer> surfelRenderer;
     std::unique_ptr<EARenderer::DiffuseLightProbeRenderer> probeRenderer;
@@ -65,8 +74,11 @@ static float const FrequentEventsThrottleCooldownMS = 100;
     std::unique_ptr<EARenderer::BoxRenderer> boxRenderer;
     std::unique_ptr<EARenderer::SharedResourceStorage> sharedResourceStorage;
     std::unique_ptr<EARenderer::GPUResourceController> gpuResourceController;
-    std::unique_ptr<EARenderer::SurfelData> surfelData;
-    std::unique_ptr<EARenderer::DiffuseLightProbeData> diffuseProbeData;
+    std::unique_ptr<EARenderer::TextureStreamer> textureStreamer;
+    std::unique_ptr<EARenderer::LightBakingVolumeCache> lightBakingVolumeCache;
+    // Debug renderers visualize the resident volume closest to the camera
+    const EARenderer::IndirectLightAccumulator *debugRenderersAccumulator;
+    uint64_t debugRenderersResidencyVersion;
 }
 
 #pragma mark - Lifecycle
@@ -81,13 +93,21 @@ static float const FrequentEventsThrottleCooldownMS = 100;
 #pragma mark - SceneGLViewDelegate
 
 - (void)glViewIsReadyForInitialization:(SceneGLView *)view {
+    EA_PROFILE_THREAD_NAME("Main thread");
+
     EARenderer::FileManager::shared().setResourceRootPath([self resourceDirectory]);
+    EARenderer::FileManager::shared().setCacheRootPath([self cacheDirectory]);
+    EARenderer::GLProgramBinaryCache::shared().setStorage(std::make_unique<EARenderer::GLProgramBinaryFileStorage>(
+            EARenderer::FileManager::shared().cacheRootPath() + "ProgramBinaries"
+    ));
 
     self->scene = std::make_unique<EARenderer::Scene>();
     self->sharedResourceStorage = std::make_unique<EARenderer::SharedResourceStorage>();
     self->gpuResourceController = std::make_unique<EARenderer::GPUResourceController>();
     self->defaultRenderComponentsProvider = std::make_unique<DefaultRenderComponentsProvider>(&EARenderer::GLViewport::Main());
     self->frameMeter = std::make_unique<EARenderer::FrameMeter>();
+    self->passTimer = std::make_unique<EARenderer::GLPassTimer>();
+    self->frameMeter->setPassTimer(self->passTimer.get());
     self->frequentEventsThrottle = std::make_unique<EARenderer::Throttle>(FrequentEventsThrottleCooldownMS);
 
     auto camera = std::make_unique<EARenderer::Camera>(90.f, 0.05f, 25.f);
@@ -97,46 +117,43 @@ static float const FrequentEventsThrottleCooldownMS = 100;
     self.demoScene = [[DemoScene1 alloc] init];;
     [self.demoScene loadResourcesToPool:self->sharedResourceStorage.get() andComposeScene:self->scene.get()];
 
-    EARenderer::SurfelGenerator surfelGenerator(self->sharedResourceStorage.get(), self->scene.get());
-    self->surfelData = std::make_unique<EARenderer::SurfelData>();
-    std::string surfelStorageFileName = "surfels_" + self->scene->name();
-
-    if (!self->surfelData->deserialize(surfelStorageFileName)) {
-        self->surfelData = surfelGenerator.generateStaticGeometrySurfels();
-        self->surfelData->serialize(surfelStorageFileName);
-    }
-
-    EARenderer::DiffuseLightProbeGenerator lightProbeGenerator;
-    self->diffuseProbeData = std::make_unique<EARenderer::DiffuseLightProbeData>();
-    std::string probeStorageFileName = "diffuse_light_probes_" + self->scene->name();
+    self->textureStreamer = std::make_unique<EARenderer::TextureStreamer>(
+            std::make_unique<EARenderer::GLTextureStreamingBackend>(self->sharedResourceStorage.get())
+    );
+    self->sharedResourceStorage->iterateCookTorranceMaterials([&](EARenderer::ID materialID) {
+        auto &material = self->sharedResourceStorage->cookTorranceMaterial(materialID);
+        if (material.textureLoading() == EARenderer::CookTorranceMaterial::TextureLoading::Streamed) {
+            self->textureStreamer->addMaterial(materialID, material);
+        }
+    });
+    // Baking samples material maps, which should hold at least their minimum mip levels by then
+    self->textureStreamer->finishPendingLoads();
 
-    if (!self->diffuseProbeData->deserialize(probeStorageFileName)) {
-        self->diffuseProbeData = lightProbeGenerator.generateProbes(*self->scene, *self->surfelData);
-        self->diffuseProbeData->serialize(probeStorageFileName);
-    }
+    // Every volume is baked up front, since baking requires scene's auxiliary data destroyed below
+    self->lightBakingVolumeCache = std::make_unique<EARenderer::LightBakingVolumeCache>(self->scene.get(), self->sharedResourceStorage.get());
+    self->lightBakingVolumeCache->bakeOutdatedVolumes();
 
     self->triangleRenderer = std::make_unique<EARenderer::TriangleRenderer>(
             self->scene.get(), self->sharedResourceStorage.get(), self->gpuResourceController.get()
     );
 
-    self->sceneGBufferRenderer = std::make_unique<EARenderer::SceneGBufferConstructor>(
-            self->scene.get(), self->sharedResourceStorage.get(), self->gpuResourceController.get(), self.renderingSettings
-    );
-
-    self->deferredSceneRenderer = std::make_unique<EARenderer::DeferredSceneRenderer>(
-            self->scene.get(), self->sharedResourceStorage.get(),
-            self->gpuResourceController.get(), self->defaultRenderComponentsProvider.get(),
-            self->surfelData.get(), self->diffuseProbeData.get(),
-            self->sceneGBufferRenderer->GBuffer(), self.renderingSettings
-    );
-
-    self->surfelRenderer = std::make_unique<EARenderer::SurfelRenderer>(
-            self->scene.get(), self->surfelData.get(), self->diffuseProbeData.get(), &self->deferredSceneRenderer->surfelsLuminanceMap()
-    );
+    {
+        EARenderer::MemoryTracker::Scope memoryScope(EARenderer::MemoryTag::GBuffer);
+        self->sceneGBufferRenderer = std::make_unique<EARenderer::SceneGBufferConstructor>(
+                self->scene.get(), self->sharedResourceStorage.get(), self->gpuResourceController.get(), self.renderingSettings
+        );
+    }
 
-    self->probeRenderer = std::make_unique<EARenderer::DiffuseLightProbeRenderer>(
-            self->scene.get(), self->diffuseProbeData.get(), &self->deferredSceneRenderer->gridProbesSphericalHarmonics()
-    );
+    {
+        EARenderer::MemoryTracker::Scope memoryScope(EARenderer::MemoryTag::Renderer);
+        self->deferredSceneRenderer = std::make_unique<EARenderer::DeferredSceneRenderer>(
+                self->scene.get(), self->sharedResourceStorage.get(),
+                self->gpuResourceController.get(), self->defaultRenderComponentsProvider.get(),
+                self->lightBakingVolumeCache.get(),
+                self->sceneGBufferRenderer->GBuffer(), self.renderingSettings
+        );
+    }
+    self->deferredSceneRenderer->setPassTimer(self->passTimer.get());
 
     self->axesRenderer = std::make_unique<EARenderer::AxesRenderer>(self->scene.get());
 
@@ -148,6 +165,17 @@ static float const FrequentEventsThrottleCooldownMS = 100;
     self->gpuResourceController->updateMeshVAO(*self->sharedResourceStorage);
     self->scene->destroyAuxiliaryData();
 
+#if EARENDERER_PROFILING
+    // Loading and baking are captured before per-frame events start filling the ring buffers.
+    // Opt in by launching with -ExportStartupTrace YES
+    if ([[NSUserDefaults standardUserDefaults] boolForKey:ExportStartupTraceDefaultsKey]) {
+        std::string tracePath = EARenderer::FileManager::shared().cacheRootPath() + "startup_trace.json";
+        if (EARenderer::Profiler::shared().exportChromeTrace(tracePath)) {
+            NSLog(@"Startup trace written to %s", tracePath.c_str());
+        }
+    }
+#endif
+
     [self subscribeForEvents];
 
     dispatch_after(2.0f, dispatch_get_main_queue(), ^{
@@ -161,12 +189,23 @@ static float const FrequentEventsThrottleCooldownMS = 100;
 //    NSLog(@"Camera pos: %f %f %f", self->scene->camera()->position().x, self->scene->camera()->position().y, self->scene->camera()->position().z);
 //    NSLog(@"Camera dir: %f %f %f", self->scene->camera()->front().x, self->scene->camera()->front().y, self->scene->camera()->front().z);
 
+    EA_PROFILE_SCOPE("Frame");
+    EARenderer::GLStateCache::shared().beginFrame();
+
     self->cameraman->updateCamera();
+    self->textureStreamer->update(*self->scene, *self->sharedResourceStorage, EARenderer::GLViewport::Main().frame().size);
+
+    self->passTimer->beginPass("G-buffer");
     self->sceneGBufferRenderer->render();
+    self->passTimer->endPass();
+
     self->gpuResourceController->updateUniformBuffer(*self->sharedResourceStorage, *self->scene);
 
     self->deferredSceneRenderer->render([&]() {
-        if (self.renderingSettings.surfelSettings.renderingEnabled) {
+        // Volumes are streamed in and out during rendering, so debug renderers are refreshed right before use
+        [self updateDebugRenderers];
+
+        if (self.renderingSettings.surfelSettings.renderingEnabled && self->surfelRenderer) {
             self->surfelRenderer->render(
                     self.renderingSettings.surfelSettings.renderingMode,
                     self->scene->surfelSpacing() / 2.0f,
@@ -174,7 +213,7 @@ static float const FrequentEventsThrottleCooldownMS = 100;
             );
         }
 
-        if (self.renderingSettings.probeSettings.probeRenderingEnabled) {
+        if (self.renderingSettings.probeSettings.probeRenderingEnabled && self->probeRenderer) {
             self->probeRenderer->render();
         }
 
@@ -225,7 +264,9 @@ static float const FrequentEventsThrottleCooldownMS = 100;
     self.renderingSettings = settings;
     self->sceneGBufferRenderer->setRenderingSettings(settings);
     self->deferredSceneRenderer->setRenderingSettings(settings);
-    self->probeRenderer->setRenderingSettings(settings);
+    if (self->probeRenderer) {
+        self->probeRenderer->setRenderingSettings(settings);
+    }
 }
 
 - (void)settingsTabViewItem:(SettingsTabViewItem *)item didChangeSkyColor:(NSColor *)color {
@@ -264,12 +305,41 @@ static float const FrequentEventsThrottleCooldownMS = 100;
 
 #pragma mark - Helper methods
 
+- (void)updateDebugRenderers {
+    auto &streamer = self->deferredSceneRenderer->volumeStreamer();
+    auto accumulator = streamer.closestAccumulator(self->scene->camera()->position());
+
+    if (accumulator == self->debugRenderersAccumulator && streamer.residencyVersion() == self->debugRenderersResidencyVersion) {
+        return;
+    }
+
+    self->debugRenderersAccumulator = accumulator;
+    self->debugRenderersResidencyVersion = streamer.residencyVersion();
+
+    if (!accumulator) {
+        self->surfelRenderer = nullptr;
+        self->probeRenderer = nullptr;
+        return;
+    }
+
+    self->surfelRenderer = std::make_unique<EARenderer::SurfelRenderer>(
+            self->scene.get(), accumulator->surfelData(), accumulator->probeData(), &accumulator->surfelsLuminanceMap()
+    );
+
+    self->probeRenderer = std::make_unique<EARenderer::DiffuseLightProbeRenderer>(
+            self->scene.get(), accumulator->probeData(), &accumulator->gridProbesSphericalHarmonics()
+    );
+    self->probeRenderer->setRenderingSettings(self.renderingSettings);
+}
+
 - (void)subscribeForEvents {
     self->sceneInteractor->meshUpdateStartEvent() += {"Main.controller.mesh.update.start", [self](EARenderer::ID meshID) {
         self->cameraman->setIsEnabled(false);
     }};
 
     self->sceneInteractor->meshUpdateEvent() += {"Main.controller.mesh.update", [self](EARenderer::ID meshID) {
+        // Moved instances cast different shadows onto surfels
+        self->deferredSceneRenderer->invalidateIndirectLight();
         self->frequentEventsThrottle->attemptToPerformAction([=]() {
             [self.sceneEditorTabView showMeshWithID:meshID];
         });
@@ -297,5 +367,13 @@ static float const FrequentEventsThrottleCooldownMS = 100;
     return std::string([[NSBundle mainBundle] resourcePath].UTF8String);
 }
 
+- (std::string)cacheDirectory {
+    NSURL *cachesURL = [[NSFileManager defaultManager] URLsForDirectory:NSCachesDirectory inDomains:NSUserDomainMask].firstObject;
+    NSString *bundleIdentifier = [[NSBundle mainBundle] bundleIdentifier] ?: @"EARenderer";
+    NSURL *cacheURL = [cachesURL URLByAppendingPathComponent:bundleIdentifier isDirectory:YES];
+    [[NSFileManager defaultManager] createDirectoryAtURL:cacheURL withIntermediateDirectories:YES attributes:nil error:nil];
+    return std::string(cacheURL.path.UTF8String);
+}
+
 @end
 
@@ -34,7 +34,8 @@
             [self pathForBlankBlackImage],
             [self pathForResource:@"Ground05_rgh.jpg"],
             [self pathForResource:@"Ground05_AO.jpg"],
-            [self pathForResource:@"Ground05_disp.jpg"]
+            [self pathForResource:@"Ground05_disp.jpg"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -45,7 +46,8 @@
             [self pathForBlankBlackImage],
             [self pathForResource:@"Marble_tiles_02_4K_Roughness.png"],
             [self pathForBlankWhiteImage],
-            [self pathForResource:@"Marble_tiles_02_4K_Height.png"]
+            [self pathForResource:@"Marble_tiles_02_4K_Height.png"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -56,7 +58,8 @@
             [self pathForBlankBlackImage],
             [self pathForBlankWhiteImage],
             [self pathForBlankWhiteImage],
-            [self pathForResource:@"bricks2_disp.jpg"]
+            [self pathForResource:@"bricks2_disp.jpg"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -67,7 +70,8 @@
             [self pathForBlankBlackImage],
             [self pathForResource:@"Bricks08_rgh.jpg"],
             [self pathForResource:@"Bricks08_AO.jpg"],
-            [self pathForResource:@"Bricks08_disp.jpg"]
+            [self pathForResource:@"Bricks08_disp.jpg"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -78,7 +82,8 @@
             [self pathForBlankBlackImage],
             [self pathForResource:@"Fabric05_rgh.jpg"],
             [self pathForResource:@"Fabric05_mask.jpg"],
-            [self pathForResource:@"Fabric05_disp.jpg"]
+            [self pathForResource:@"Fabric05_disp.jpg"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -89,7 +94,8 @@
             [self pathForBlankBlackImage],
             [self pathForResource:@"Fabric06_rgh.jpg"],
             [self pathForResource:@"Fabric06_mask.jpg"],
-            [self pathForResource:@"Fabric06_disp.jpg"]
+            [self pathForResource:@"Fabric06_disp.jpg"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -101,6 +107,7 @@
             [self pathForResource:@"Rocks01_rgh.jpg"],
             [self pathForResource:@"Rocks01_AO.jpg"],
             [self pathForResource:@"Rocks01_disp.jpg"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -111,7 +118,8 @@
             [self pathForBlankBlackImage],
             [self pathForResource:@"PavingStones09_rgh.jpg"],
             [self pathForResource:@"PavingStones09_AO.jpg"],
-            [self pathForResource:@"PavingStones09_disp.jpg"]
+            [self pathForResource:@"PavingStones09_disp.jpg"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -122,7 +130,8 @@
             [self pathForBlankBlackImage],
             [self pathForResource:@"PavingStones10_rgh.jpg"],
             [self pathForResource:@"PavingStones10_AO.jpg"],
-            [self pathForResource:@"PavingStones10_disp.jpg"]
+            [self pathForResource:@"PavingStones10_disp.jpg"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -133,7 +142,8 @@
             [self pathForResource:@"blank_black.png"],
             [self pathForResource:@"Fabric03_rgh.jpg"],
             [self pathForResource:@"blank_white.jpg"],
-            [self pathForResource:@"Fabric03_disp.jpg"]
+            [self pathForResource:@"Fabric03_disp.jpg"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -144,7 +154,8 @@
             [self pathForResource:@"blank_black.png"],
             [self pathForResource:@"fabric02_rgh.jpg"],
             [self pathForResource:@"blank_white.jpg"],
-            [self pathForResource:@"fabric02_disp.jpg"]
+            [self pathForResource:@"fabric02_disp.jpg"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -155,7 +166,8 @@
             0.0f,
             [self pathForResource:@"T_stoneFloorA_wet_RF.tga"],
             [self pathForResource:@"T_stoneFloorA_wet_AO.tga"],
-            [self pathForResource:@"T_stoneFloorA_wet_DS.png"]
+            [self pathForResource:@"T_stoneFloorA_wet_DS.png"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -166,7 +178,8 @@
             [self pathForResource:@"rustediron2_metallic.png"],
             [self pathForResource:@"rustediron2_roughness.png"],
             1.0,
-            0.0f
+            0.0f,
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -178,6 +191,7 @@
             [self pathForResource:@"slatecliffrock_Roughness2.png"],
             [self pathForResource:@"slatecliffrock_Ambient_Occlusion.png"],
             [self pathForResource:@"slatecliffrock_Height.png"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -188,7 +202,8 @@
             0.0,
             [self pathForResource:@"mahogfloor_roughness.png"],
             [self pathForResource:@"mahogfloor_AO.png"],
-            0.0f
+            0.0f,
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -199,7 +214,8 @@
             [self pathForResource:@"Titanium-Scuffed_metallic.png"],
             [self pathForResource:@"Titanium-Scuffed_roughness.png"],
             1.0f,
-            0.0f
+            0.0f,
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -210,7 +226,8 @@
             [self pathForResource:@"bamboo-wood-semigloss-metal.png"],
             [self pathForResource:@"bamboo-wood-semigloss-roughness.png"],
             [self pathForResource:@"bamboo-wood-semigloss-ao.png"],
-            0.0f
+            0.0f,
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -222,6 +239,7 @@
             [self pathForResource:@"charcoal-roughness.png"],
             1.0f,
             [self pathForResource:@"charcoal-height.png"],
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -232,7 +250,8 @@
             [self pathForResource:@"grimy-metal-metalness.png"],
             [self pathForResource:@"grimy-metal-roughness.png"],
             1.0f,
-            0.0f
+            0.0f,
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -243,7 +262,8 @@
             [self pathForResource:@"patchy_cement1_Metallic.png"],
             [self pathForResource:@"patchy_cement1_Roughness.png"],
             [self pathForResource:@"patchy_cement1_Ambient_Occlusion.png"],
-            0.0f
+            0.0f,
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -254,7 +274,8 @@
             [self pathForResource:@"metal-splotchy-metal.png"],
             [self pathForResource:@"metal-splotchy-rough.png"],
             1.0f,
-            0.0f
+            0.0f,
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -265,7 +286,8 @@
             [self pathForResource:@"plasticpattern1-metalness.png"],
             [self pathForResource:@"plasticpattern1-roughness2.png"],
             1.0f,
-            0.0f
+            0.0f,
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -276,7 +298,8 @@
             [self pathForResource:@"synth-rubber-metalness.png"],
             [self pathForResource:@"synth-rubber-roughness.png"],
             1.0f,
-            0.0f
+            0.0f,
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -287,7 +310,8 @@
             0.0f,
             [self pathForResource:@"agedplanks1-roughness.png"],
             [self pathForResource:@"agedplanks1-ao.png"],
-            0.0f
+            0.0f,
+            EARenderer::CookTorranceMaterial::TextureLoading::Streamed
     });
 }
 
@@ -37,7 +37,8 @@
 
     NSString *fpsString = [[NSNumberFormatter fpsFormatter] stringFromNumber:@(frameCharacteristics.framesPerSecond)];
     NSString *timeString = [[NSNumberFormatter fpsFormatter] stringFromNumber:@(frameCharacteristics.frameTimeMillisecons)];
-    timeString = [timeString stringByAppendingString:@" ms"];
+    NSString *percentileString = [[NSNumberFormatter fpsFormatter] stringFromNumber:@(frameCharacteristics.frameTimePercentile99Milliseconds)];
+    timeString = [NSString stringWithFormat:@"%@ ms (p99 %@)", timeString, percentileString];
 
     self.framesTextField.stringValue = fpsString;
     self.timeTextField.stringValue = timeString;